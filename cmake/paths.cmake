@@ -30,6 +30,7 @@ set (NPAPICORETEST_SOURCE_DIR "${TEST_DIR}/NpapiCoreTest")
 
 set (SCRIPTINGCORE_SOURCE_DIR "${SOURCE_DIR}/ScriptingCore")
 set (SCRIPTINGCORETEST_SOURCE_DIR "${TEST_DIR}/ScriptingCoreTest")
+set (SCRIPTINGCOREBENCH_SOURCE_DIR "${TEST_DIR}/ScriptingCoreBench")
 
 set (PLUGINCORE_SOURCE_DIR "${SOURCE_DIR}/PluginCore")
 
@@ -23,6 +23,11 @@ std::string g_dllPath;
 // DLL Entry Point
 extern "C" BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD dwReason, LPVOID lpReserved)
 {
+    if (dwReason == DLL_PROCESS_ATTACH) {
+        // We don't use thread attach/detach notifications; turning them off
+        // keeps every thread the host process creates from calling into us
+        ::DisableThreadLibraryCalls(hInstance);
+    }
     if (!gInstance) {
         gInstance = hInstance;
         boost::scoped_array<TCHAR> strDLLPath1(new TCHAR[_MAX_PATH]);
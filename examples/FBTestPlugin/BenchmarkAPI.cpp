@@ -0,0 +1,146 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include "BrowserStream.h"
+#include "DefaultBrowserStreamHandler.h"
+#include "variant_list.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "BenchmarkAPI.h"
+
+namespace {
+    double elapsedMs(const boost::posix_time::ptime& start)
+    {
+        return boost::posix_time::time_duration(
+            boost::posix_time::microsec_clock::universal_time() - start
+            ).total_microseconds() / 1000.0;
+    }
+
+    // counts arriving bytes and reports the rate back through the API when
+    // the stream completes; holds the API weakly so a closed page doesn't
+    // keep the benchmark object alive just because a download is pending
+    class DownloadBenchHandler : public FB::DefaultBrowserStreamHandler
+    {
+    public:
+        DownloadBenchHandler(const boost::weak_ptr<BenchmarkAPI>& api, const std::string& url)
+            : m_api(api), m_url(url), m_bytes(0)
+        {}
+
+        virtual bool onStreamOpened(FB::StreamOpenedEvent *evt, FB::BrowserStream *s)
+        {
+            m_start = boost::posix_time::microsec_clock::universal_time();
+            return FB::DefaultBrowserStreamHandler::onStreamOpened(evt, s);
+        }
+
+        virtual bool onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *s)
+        {
+            m_bytes += evt->getLength();
+            return FB::DefaultBrowserStreamHandler::onStreamDataArrived(evt, s);
+        }
+
+        virtual bool onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *s)
+        {
+            boost::shared_ptr<BenchmarkAPI> api(m_api.lock());
+            if (api) {
+                const double ms = m_start.is_not_a_date_time() ? 0 : elapsedMs(m_start);
+                api->downloadFinished(m_url, static_cast<double>(m_bytes), ms, evt->success);
+            }
+            return FB::DefaultBrowserStreamHandler::onStreamCompleted(evt, s);
+        }
+
+    private:
+        boost::weak_ptr<BenchmarkAPI> m_api;
+        std::string m_url;
+        size_t m_bytes;
+        boost::posix_time::ptime m_start;
+    };
+}
+
+BenchmarkAPI::BenchmarkAPI(FB::BrowserHostPtr host) : m_host(host)
+{
+    registerMethod("ping", make_method(this, &BenchmarkAPI::ping));
+    registerMethod("makeArray", make_method(this, &BenchmarkAPI::makeArray));
+    registerMethod("consumeArray", make_method(this, &BenchmarkAPI::consumeArray));
+    registerMethod("makeString", make_method(this, &BenchmarkAPI::makeString));
+    registerMethod("consumeString", make_method(this, &BenchmarkAPI::consumeString));
+    registerMethod("fireStorm", make_method(this, &BenchmarkAPI::fireStorm));
+    registerMethod("startDownload", make_method(this, &BenchmarkAPI::startDownload));
+
+    registerEvent("onbenchevent");
+    registerEvent("ondownloadfinished");
+}
+
+BenchmarkAPI::~BenchmarkAPI()
+{
+}
+
+long BenchmarkAPI::ping(long v)
+{
+    return v;
+}
+
+FB::VariantList BenchmarkAPI::makeArray(long n)
+{
+    FB::VariantList arr;
+    arr.reserve(n > 0 ? n : 0);
+    for (long i = 0; i < n; ++i)
+        arr.push_back(static_cast<double>(i));
+    return arr;
+}
+
+long BenchmarkAPI::consumeArray(const std::vector<double>& arr)
+{
+    return static_cast<long>(arr.size());
+}
+
+std::string BenchmarkAPI::makeString(long bytes)
+{
+    return std::string(bytes > 0 ? static_cast<size_t>(bytes) : 0, 'x');
+}
+
+long BenchmarkAPI::consumeString(const std::string& str)
+{
+    return static_cast<long>(str.size());
+}
+
+double BenchmarkAPI::fireStorm(long count, long payloadBytes)
+{
+    const std::string payload(payloadBytes > 0 ? static_cast<size_t>(payloadBytes) : 0, 'x');
+    const boost::posix_time::ptime start(boost::posix_time::microsec_clock::universal_time());
+    for (long i = 0; i < count; ++i)
+        FireEvent("onbenchevent", FB::variant_list_of(i)(payload));
+    return elapsedMs(start);
+}
+
+bool BenchmarkAPI::startDownload(const std::string& url)
+{
+    boost::weak_ptr<BenchmarkAPI> weak(FB::ptr_cast<BenchmarkAPI>(shared_ptr()));
+    FB::PluginEventSinkPtr handler(boost::make_shared<DownloadBenchHandler>(weak, url));
+    // sequential and uncached: every byte flows through the plugin, which is
+    // the path being measured
+    return m_host->createStream(url, handler, false, false) ? true : false;
+}
+
+void BenchmarkAPI::downloadFinished(const std::string& url, double bytes, double ms, bool success)
+{
+    FB::VariantMap info;
+    info["url"] = url;
+    info["bytes"] = bytes;
+    info["ms"] = ms;
+    info["mbps"] = ms > 0 ? (bytes / (1024.0 * 1024.0)) / (ms / 1000.0) : 0.0;
+    info["success"] = success;
+    FireEvent("ondownloadfinished", FB::variant_list_of(info));
+}
@@ -0,0 +1,59 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <string>
+#include <vector>
+#include "JSAPIAuto.h"
+#include "BrowserHost.h"
+
+#pragma once
+#ifndef H_BENCHMARKAPI
+#define H_BENCHMARKAPI
+
+// Throughput benchmark surface for benchmark.html: scripted echo storms,
+// large-array marshaling, FireEvent fan-out, and BrowserStream download
+// throughput.  The page drives the loops and reports rates into its DOM;
+// this API supplies the cheapest possible counterpart for each path so
+// what gets measured is the framework, not the workload.
+class BenchmarkAPI : public FB::JSAPIAuto
+{
+public:
+    BenchmarkAPI(FB::BrowserHostPtr host);
+    virtual ~BenchmarkAPI();
+
+    // minimal round trip; the page loops this to measure calls/sec
+    long ping(long v);
+
+    // marshal-out / marshal-in payloads for MB/sec numbers
+    FB::VariantList makeArray(long n);
+    long consumeArray(const std::vector<double>& arr);
+    std::string makeString(long bytes);
+    long consumeString(const std::string& str);
+
+    // fires "onbenchevent" count times with a payload of payloadBytes;
+    // returns the elapsed milliseconds so the page can compute events/sec
+    double fireStorm(long count, long payloadBytes);
+
+    // downloads url through a BrowserStream and fires "ondownloadfinished"
+    // with { url, bytes, ms, mbps } when the stream completes
+    bool startDownload(const std::string& url);
+
+    // called by the stream handler when a download finishes or fails
+    void downloadFinished(const std::string& url, double bytes, double ms, bool success);
+
+private:
+    FB::BrowserHostPtr m_host;
+};
+
+#endif
@@ -20,6 +20,7 @@ Copyright 2009 PacketPass Inc, Georg Fritzsche,
 #include "FBTestPlugin.h"
 #include "SimpleMathAPI.h"
 #include "ThreadRunnerAPI.h"
+#include "BenchmarkAPI.h"
 #include "SimpleStreams.h"
 
 #include "FBTestPluginAPI.h"
@@ -46,6 +47,7 @@ FBTestPluginAPI::FBTestPluginAPI(boost::shared_ptr<FBTestPlugin> plugin, FB::Bro
     registerMethod("getTagAttribute", make_method(this, &FBTestPluginAPI::getTagAttribute));
     registerMethod("getPageLocation", make_method(this, &FBTestPluginAPI::getPageLocation));
     registerMethod("createThreadRunner", make_method(this, &FBTestPluginAPI::createThreadRunner));
+    registerMethod("createBenchmark", make_method(this, &FBTestPluginAPI::createBenchmark));
     registerMethod("optionalTest", make_method(this, &FBTestPluginAPI::optionalTest));
      
     registerMethod(L"скажи",  make_method(this, &FBTestPluginAPI::say));
@@ -304,6 +306,11 @@ ThreadRunnerAPIPtr FBTestPluginAPI::createThreadRunner()
     return boost::make_shared<ThreadRunnerAPI>(m_host);
 }
 
+BenchmarkAPIPtr FBTestPluginAPI::createBenchmark()
+{
+    return boost::make_shared<BenchmarkAPI>(m_host);
+}
+
 const boost::optional<std::string> FBTestPluginAPI::optionalTest( const boost::optional<std::string>& str )
 {
     if (str)
@@ -23,6 +23,7 @@ Copyright 2009 PacketPass Inc, Georg Fritzsche,
 
 FB_FORWARD_PTR(ThreadRunnerAPI);
 FB_FORWARD_PTR(SimpleMathAPI);
+FB_FORWARD_PTR(BenchmarkAPI);
 FB_FORWARD_PTR(FBTestPlugin);
 
 class FBTestPluginAPI : public FB::JSAPIAuto
@@ -34,6 +35,7 @@ public:
     FBTestPluginPtr getPlugin();
     
     ThreadRunnerAPIPtr createThreadRunner();
+    BenchmarkAPIPtr createBenchmark();
 
     std::wstring say(const std::wstring& val);
     // Read/Write property testString
@@ -67,6 +67,8 @@ def Main():
         help = "3 or more alphanumeric characters (underscores allowed after first position)")
     parser.add_option("-c", "--company-name", dest = "companyName")
     parser.add_option("-d", "--company-domain", dest = "companyDomain")
+    parser.add_option("-s", "--static-members", action = "store_true", dest = "staticMembers", default = False,
+        help = "emit the generated API with a compile-time FB::StaticMemberTable instead of per-instance registerMethod/registerProperty calls")
     options, args = parser.parse_args()
 
 
@@ -150,7 +152,15 @@ def Main():
     for tpl in templateFiles:
         try:
             tplPath, tplFilename = os.path.split(tpl)
-            if tplFilename.startswith("Template"):
+            # TemplateAPI and TemplateAPIStatic are two flavors of the same
+            # generated file; --static-members picks which one is emitted
+            isStaticApi = tplFilename.startswith("TemplateAPIStatic")
+            isDynamicApi = tplFilename.startswith("TemplateAPI") and not isStaticApi
+            if (isStaticApi and not options.staticMembers) or (isDynamicApi and options.staticMembers):
+                continue
+            if isStaticApi:
+                tplFilename = tplFilename.replace("TemplateAPIStatic", "%sAPI" % plugin.ident, 1)
+            elif tplFilename.startswith("Template"):
                 tplFilename = tplFilename.replace("Template", plugin.ident, 1)
             if tplPath:
                 filename = os.path.join(projPath, tplPath, tplFilename)
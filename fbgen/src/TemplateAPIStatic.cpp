@@ -0,0 +1,114 @@
+/**********************************************************\
+
+  Auto-generated @{PLUGIN_ident}API.cpp
+
+\**********************************************************/
+
+#include "JSObject.h"
+#include "variant_list.h"
+#include "DOM/Document.h"
+
+#include "@{PLUGIN_ident}API.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// @@fn const FB::StaticMemberTable& @{PLUGIN_ident}API::getMemberTable()
+///
+/// @@brief  Declares the methods and properties accessible to Javascript as
+///         static data built on first use and shared by every instance, so
+///         constructing an API object costs nothing per member.  Add your
+///         members here; per-instance registerMethod/registerProperty calls
+///         still work and shadow table entries of the same name.
+///
+/// @@see FB::StaticMemberTable
+/// @@see FB::make_unbound_method
+/// @@see FB::make_unbound_property
+///////////////////////////////////////////////////////////////////////////////
+const FB::StaticMemberTable& @{PLUGIN_ident}API::getMemberTable()
+{
+    static FB::StaticMemberTable table = FB::StaticMemberTable()
+        .method("echo",      FB::make_unbound_method(&@{PLUGIN_ident}API::echo))
+        .method("testEvent", FB::make_unbound_method(&@{PLUGIN_ident}API::testEvent))
+
+        // Read-write property
+        .property("testString",
+                  FB::make_unbound_property(&@{PLUGIN_ident}API::get_testString,
+                                            &@{PLUGIN_ident}API::set_testString))
+
+        // Read-only property
+        .property("version",
+                  FB::make_unbound_property(&@{PLUGIN_ident}API::get_version));
+    return table;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @@fn @{PLUGIN_ident}API::@{PLUGIN_ident}API(@{PLUGIN_ident}Ptr plugin, FB::BrowserHostPtr host)
+///
+/// @@brief  Constructor for your JSAPI object.  Methods and properties live in
+///         the static member table (see getMemberTable above); only things
+///         that really are per-instance -- like events -- belong here.
+///
+/// @@see FB::JSAPIAuto::registerEvent
+///////////////////////////////////////////////////////////////////////////////
+@{PLUGIN_ident}API::@{PLUGIN_ident}API(@{PLUGIN_ident}Ptr plugin, FB::BrowserHostPtr host) : m_plugin(plugin), m_host(host)
+{
+    setMemberTable(getMemberTable());
+
+    registerEvent("onfired");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @@fn @{PLUGIN_ident}API::~@{PLUGIN_ident}API()
+///
+/// @@brief  Destructor.  Remember that this object will not be released until
+///         the browser is done with it; this will almost definitely be after
+///         the plugin is released.
+///////////////////////////////////////////////////////////////////////////////
+@{PLUGIN_ident}API::~@{PLUGIN_ident}API()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @@fn @{PLUGIN_ident}Ptr @{PLUGIN_ident}API::getPlugin()
+///
+/// @@brief  Gets a reference to the plugin that was passed in when the object
+///         was created.  If the plugin has already been released then this
+///         will throw a FB::script_error that will be translated into a
+///         javascript exception in the page.
+///////////////////////////////////////////////////////////////////////////////
+@{PLUGIN_ident}Ptr @{PLUGIN_ident}API::getPlugin()
+{
+    @{PLUGIN_ident}Ptr plugin(m_plugin.lock());
+    if (!plugin) {
+        throw FB::script_error("The plugin is invalid");
+    }
+    return plugin;
+}
+
+
+
+// Read/Write property testString
+std::string @{PLUGIN_ident}API::get_testString()
+{
+    return m_testString;
+}
+void @{PLUGIN_ident}API::set_testString(const std::string& val)
+{
+    m_testString = val;
+}
+
+// Read-only property version
+std::string @{PLUGIN_ident}API::get_version()
+{
+    return "CURRENT_VERSION";
+}
+
+// Method echo
+FB::variant @{PLUGIN_ident}API::echo(const FB::variant& msg)
+{
+    return msg;
+}
+
+void @{PLUGIN_ident}API::testEvent(const FB::variant& var)
+{
+    FireEvent("onfired", FB::variant_list_of(var)(true)(1));
+}
@@ -12,7 +12,8 @@ License:    Dual license model; choose one of two:
 Copyright 2010 Facebook, Inc and the Firebreath development team
 \**********************************************************/
 
-#include "IDispatchAPI.h"
+#include "IDispatchAPI.h"
+#include "axutil.h"
 #include "DOM/Window.h"
 #include "DOM/Element.h"
 
@@ -45,7 +46,8 @@ std::vector<FB::DOM::ElementPtr> Document::getElementsByTagName(const std::strin
     CComQIPtr<IHTMLDocument3> doc(m_htmlDoc);
     CComPtr<IHTMLElementCollection> list;
     std::vector<FB::DOM::ElementPtr> tagList;
-    CComBSTR tName(FB::utf8_to_wstring(tagName).c_str());
+    CComBSTR tName;
+    FB::ActiveX::utf8ToBSTR(tagName, tName);
     if (doc) {
         doc->getElementsByTagName(tName, &list);
     } else {
@@ -72,7 +74,9 @@ FB::DOM::ElementPtr Document::getElementById(const std::string& elem_id) const
         throw std::exception("Document does not support getElementById");
     }
     CComPtr<IHTMLElement> el(NULL);
-    doc3->getElementById(CComBSTR(FB::utf8_to_wstring(elem_id).c_str()), &el);
+    CComBSTR elemId;
+    FB::ActiveX::utf8ToBSTR(elem_id, elemId);
+    doc3->getElementById(elemId, &el);
     CComQIPtr<IDispatch> disp(el);
 	FB::JSObjectPtr ptr(IDispatchAPI::create(disp, FB::ptr_cast<ActiveXBrowserHost>(getJSObject()->host)));
     return FB::DOM::Element::create(ptr);
@@ -12,7 +12,8 @@ License:    Dual license model; choose one of two:
 Copyright 2010 Facebook, Inc and the Firebreath development team
 \**********************************************************/
 
-#include "Element.h"
+#include "Element.h"
+#include "axutil.h"
 
 using namespace FB::ActiveX::AXDOM;
 
@@ -34,7 +35,8 @@ std::vector<FB::DOM::ElementPtr> Element::getElementsByTagName(const std::string
     CComQIPtr<IHTMLDocument3> doc(m_axDisp);
     CComPtr<IHTMLElementCollection> list;
     std::vector<FB::DOM::ElementPtr> tagList;
-    CComBSTR tName(FB::utf8_to_wstring(tagName).c_str());
+    CComBSTR tName;
+    FB::ActiveX::utf8ToBSTR(tagName, tName);
     if (elem) {
         elem->getElementsByTagName(tName, &list);
     } else if (doc) {
@@ -62,7 +64,9 @@ std::string FB::ActiveX::AXDOM::Element::getStringAttribute( const std::string&
     CComVariant var;
     HRESULT hr = S_OK;
     if (elem) {
-        hr = elem->getAttribute(CComBSTR(FB::utf8_to_wstring(attr).c_str()), 0, &var);
+        CComBSTR attrName;
+        FB::ActiveX::utf8ToBSTR(attr, attrName);
+        hr = elem->getAttribute(attrName, 0, &var);
         return FB::ptr_cast<ActiveXBrowserHost>(getJSObject()->host)->getVariant(&var).convert_cast<std::string>();
     } else {
         return getProperty<std::string>(attr);
@@ -13,7 +13,8 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 \**********************************************************/
 
 #include "Document.h"
-#include "IDispatchAPI.h"
+#include "IDispatchAPI.h"
+#include "axutil.h"
 
 #include "Window.h"
 
@@ -43,7 +44,9 @@ FB::DOM::DocumentPtr Window::getDocument() const
 
 void Window::alert(const std::string& str) const
 {
-    m_htmlWin->alert(CComBSTR(FB::utf8_to_wstring(str).c_str()));
+    CComBSTR msg;
+    FB::ActiveX::utf8ToBSTR(str, msg);
+    m_htmlWin->alert(msg);
 }
 
 std::string Window::getLocation() const
@@ -53,5 +56,5 @@ std::string Window::getLocation() const
     CComPtr<IHTMLLocation> location;
     m_htmlWin->get_location(&location);
     location->get_href(&bstr);
-    return FB::wstring_to_utf8(std::wstring(bstr.m_str));
+    return FB::ActiveX::bstrToUTF8(bstr.m_str);
 }
\ No newline at end of file
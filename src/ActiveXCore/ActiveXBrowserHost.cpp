@@ -18,6 +18,8 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include "DOM/Document.h"
 #include "DOM/Window.h"
 #include "AsyncFunctionCall.h"
+#include "ConversionStats.h"
+#include "Win/WinMessageWindow.h"
 #include "AXDOM/Window.h"
 #include "AXDOM/Document.h"
 #include "AXDOM/Element.h"
@@ -80,8 +82,118 @@ namespace
     }
 }
 
+// One of these lives per precise timer; the timer-queue thread and the message
+// loop both touch it, so it is freed only when the last in-flight reference
+// (owner, queued delivery) drops
+struct ActiveXBrowserHost::PreciseTimer
+{
+    HWND hWnd;
+    TimerCallback callback;
+    unsigned int toleranceMs;
+    volatile LONG refs;       // 1 for the owner + 1 per queued delivery
+    volatile LONG pending;    // nonzero while a delivery sits in the message queue
+    volatile LONG stopped;
+    DWORD pendingSince;       // tick of the fire that posted the pending delivery
+    LONG coalesced;           // fires folded into a pending delivery
+
+    PreciseTimer(HWND wnd, const TimerCallback& cb, unsigned int tolerance)
+        : hWnd(wnd), callback(cb), toleranceMs(tolerance)
+        , refs(1), pending(0), stopped(0), pendingSince(0), coalesced(0)
+    { }
+
+    void release()
+    {
+        if (::InterlockedDecrement(&refs) == 0)
+            delete this;
+    }
+};
+
+// runs on the timer-queue thread at the kernel's timer fidelity
+void CALLBACK ActiveXBrowserHost::_preciseTimerProc(void* param, BOOLEAN)
+{
+    PreciseTimer* timer = static_cast<PreciseTimer*>(param);
+    if (timer->stopped)
+        return;
+    if (timer->toleranceMs && ::InterlockedCompareExchange(&timer->pending, 1, 0) != 0) {
+        // the previous delivery hasn't run yet; fold this fire into it rather
+        // than queueing a backlog behind a lagging main thread
+        ::InterlockedIncrement(&timer->coalesced);
+        return;
+    }
+    if (!timer->toleranceMs)
+        ::InterlockedExchange(&timer->pending, 1);
+    timer->pendingSince = ::GetTickCount();
+    ::InterlockedIncrement(&timer->refs);
+    if (!FB::WinMessageWindow::postFunctionCall(timer->hWnd, &_deliverPreciseTimer, timer)) {
+        ::InterlockedExchange(&timer->pending, 0);
+        timer->release();
+    }
+}
+
+void ActiveXBrowserHost::_deliverPreciseTimer(void* param)
+{
+    PreciseTimer* timer = static_cast<PreciseTimer*>(param);
+    ::InterlockedExchange(&timer->pending, 0);
+    if (!timer->stopped)
+        timer->callback();
+    timer->release();
+}
+
+unsigned int ActiveXBrowserHost::startPreciseTimer(unsigned int periodMs, unsigned int toleranceMs,
+                                                   const TimerCallback& callback)
+{
+    if (isShutDown() || !m_hWnd)
+        return 0;
+    boost::mutex::scoped_lock lock(m_preciseTimerMutex);
+    if (!m_timerQueue) {
+        m_timerQueue = ::CreateTimerQueue();
+        if (!m_timerQueue)
+            return 0;
+    }
+    PreciseTimer* timer = new PreciseTimer(m_hWnd, callback, toleranceMs);
+    HANDLE handle(NULL);
+    if (!::CreateTimerQueueTimer(&handle, m_timerQueue, &_preciseTimerProc, timer,
+                                 periodMs, periodMs, WT_EXECUTEINTIMERTHREAD)) {
+        timer->release();
+        return 0;
+    }
+    const unsigned int id = ++m_lastPreciseTimerId;
+    m_preciseTimers[id] = timer;
+    m_preciseTimerHandles[id] = handle;
+    return id;
+}
+
+void ActiveXBrowserHost::stopPreciseTimer(unsigned int timerId)
+{
+    PreciseTimer* timer(NULL);
+    HANDLE handle(NULL);
+    HANDLE queue(NULL);
+    {
+        boost::mutex::scoped_lock lock(m_preciseTimerMutex);
+        std::map<unsigned int, PreciseTimer*>::iterator it = m_preciseTimers.find(timerId);
+        if (it == m_preciseTimers.end())
+            return;
+        timer = it->second;
+        handle = m_preciseTimerHandles[timerId];
+        queue = m_timerQueue;
+        m_preciseTimers.erase(it);
+        m_preciseTimerHandles.erase(timerId);
+    }
+    ::InterlockedExchange(&timer->stopped, 1);
+    // waits for an in-flight timer-thread fire; cheap, since the fires only post
+    ::DeleteTimerQueueTimer(queue, handle, INVALID_HANDLE_VALUE);
+    if (timer->coalesced) {
+        FBLOG_TRACE("ActiveXHost", "Precise timer " << timerId << " coalesced "
+                    << timer->coalesced << " fires");
+    }
+    // a delivery still queued behind us holds its own reference and will see
+    // the stopped flag; the record goes away with the last reference
+    timer->release();
+}
+
 ActiveXBrowserHost::ActiveXBrowserHost(IWebBrowser2 *doc, IOleClientSite* site)
-    : m_spClientSite(site), m_webBrowser(doc)
+    : m_hWnd(NULL), m_spClientSite(site), m_webBrowser(doc)
+    , m_lastPreciseTimerId(0), m_timerQueue(NULL)
 {
     if (m_webBrowser) {
         m_webBrowser->get_Document(&m_htmlDocDisp);
@@ -99,8 +211,9 @@ bool ActiveXBrowserHost::_scheduleAsyncCall(void (*func)(void *), void *userData
 {
     if (!isShutDown() && m_hWnd != NULL) {
         FBLOG_TRACE("ActiveXHost", "Scheduling async call for main thread");
-        return ::PostMessage(m_hWnd, WM_ASYNCTHREADINVOKE, NULL, 
-            (LPARAM)new FB::AsyncFunctionCall(func, userData)) ? true : false;
+        // Goes through the message window's batched queue; one posted wakeup
+        // services a whole burst of calls
+        return FB::WinMessageWindow::postFunctionCall(m_hWnd, func, userData);
     } else {
         return false;
     }
@@ -118,22 +231,22 @@ void ActiveXBrowserHost::setWindow(HWND wnd)
 
 FB::DOM::WindowPtr ActiveXBrowserHost::_createWindow(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::WindowPtr(new AXDOM::Window(ptr_cast<IDispatchAPI>(obj), m_webBrowser));
+    return boost::make_shared<AXDOM::Window>(ptr_cast<IDispatchAPI>(obj), m_webBrowser);
 }
 
 FB::DOM::DocumentPtr ActiveXBrowserHost::_createDocument(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::DocumentPtr(new AXDOM::Document(ptr_cast<IDispatchAPI>(obj), m_webBrowser));
+    return boost::make_shared<AXDOM::Document>(ptr_cast<IDispatchAPI>(obj), m_webBrowser);
 }
 
 FB::DOM::ElementPtr ActiveXBrowserHost::_createElement(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::ElementPtr(new AXDOM::Element(ptr_cast<IDispatchAPI>(obj), m_webBrowser));
+    return boost::make_shared<AXDOM::Element>(ptr_cast<IDispatchAPI>(obj), m_webBrowser);
 }
 
 FB::DOM::NodePtr ActiveXBrowserHost::_createNode(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::NodePtr(new AXDOM::Node(ptr_cast<IDispatchAPI>(obj), m_webBrowser));
+    return boost::make_shared<AXDOM::Node>(ptr_cast<IDispatchAPI>(obj), m_webBrowser);
 }
 
 void ActiveXBrowserHost::initDOMObjects()
@@ -185,6 +298,25 @@ void ActiveXBrowserHost::evaluateJavaScript(const std::string &script)
 
 void ActiveXBrowserHost::shutdown()
 {
+    // stop any precise timers still running before the window goes away; the
+    // queue delete waits out in-flight fires and takes its thread with it
+    std::vector<unsigned int> timerIds;
+    {
+        boost::mutex::scoped_lock lock(m_preciseTimerMutex);
+        for (std::map<unsigned int, PreciseTimer*>::const_iterator it = m_preciseTimers.begin();
+             it != m_preciseTimers.end(); ++it)
+            timerIds.push_back(it->first);
+    }
+    for (size_t i = 0; i < timerIds.size(); ++i)
+        stopPreciseTimer(timerIds[i]);
+    {
+        boost::mutex::scoped_lock lock(m_preciseTimerMutex);
+        if (m_timerQueue) {
+            ::DeleteTimerQueueEx(m_timerQueue, INVALID_HANDLE_VALUE);
+            m_timerQueue = NULL;
+        }
+    }
+
 	BrowserHost::shutdown();
 	m_spClientSite.Release();
 	m_htmlDoc.Release();
@@ -263,13 +395,16 @@ FB::variant ActiveXBrowserHost::getVariant(const VARIANT *cVar)
         break;
     }
 
+    FB::ConversionStats::getInstance().recordConversion(
+        FB::ConversionStats::Direction_FromBrowser, retVal);
     return retVal;
 }
 
 void ActiveXBrowserHost::getComVariant(VARIANT *dest, const FB::variant &var)
 {
-    CComVariant outVar;
     ::VariantInit(dest);
+    FB::ConversionStats::getInstance().recordConversion(
+        FB::ConversionStats::Direction_ToBrowser, var);
 
     const ComVariantBuilderMap& builderMap = getComVariantBuilderMap();
     const std::type_info& type = var.get_type();
@@ -280,9 +415,10 @@ void ActiveXBrowserHost::getComVariant(VARIANT *dest, const FB::variant &var)
         return;
     }
     
-    outVar = (it->second)(FB::ptr_cast<ActiveXBrowserHost>(shared_ptr()), var);
-
-    outVar.Detach(dest);
+    // Detach from the builder's temporary directly; assigning to a local CComVariant
+    // first VariantCopy's the payload (another BSTR allocation for every string) just
+    // to throw the source away
+    (it->second)(FB::ptr_cast<ActiveXBrowserHost>(shared_ptr()), var).Detach(dest);
 }
 
 FB::BrowserStreamPtr ActiveXBrowserHost::createStream(const std::string& url, const FB::PluginEventSinkPtr& callback, 
@@ -19,9 +19,12 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include "win_common.h"
 //#include "global/COM_config.h"
 #include <atlctl.h>
+#include <map>
+#include <boost/thread/mutex.hpp>
 #include "BrowserHost.h"
 #include "APITypes.h"
 #include "FBPointers.h"
+#include "TimerService.h"
 
 namespace FB {
     namespace ActiveX {
@@ -49,6 +52,34 @@ namespace FB {
 
             void setWindow(HWND wnd);
 
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            /// @fn unsigned int ActiveXBrowserHost::startPreciseTimer(unsigned int periodMs, unsigned int toleranceMs, const TimerCallback& callback)
+            ///
+            /// @brief  Periodic main-thread callback driven by an OS timer queue
+            ///
+            /// startTimer() ticks on the shared TimerService thread, which re-arms with a timed
+            /// condition wait and then crosses into the message loop -- two scheduling hops whose
+            /// jitter shows up in tight progress pumps under load.  This variant arms a
+            /// CreateTimerQueueTimer for the period, so the kernel wakes a timer thread right on
+            /// the deadline and the only remaining hop is the post to the message window.
+            ///
+            /// toleranceMs configures coalescing for a lagging main thread: a fire that lands
+            /// while the previous delivery is still sitting in the message queue is folded into
+            /// it (the callback runs once, on time, with no backlog forming).  Pass 0 to disable
+            /// folding and queue every fire.
+            ///
+            /// @return the timer id to pass to stopPreciseTimer, or 0 after shutdown
+            /// @since 1.5
+            /// @see BrowserHost::startTimer
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            unsigned int startPreciseTimer(unsigned int periodMs, unsigned int toleranceMs,
+                                           const TimerCallback& callback);
+
+            /// Stops a startPreciseTimer() timer; call from the main thread.  Blocks until any
+            /// in-flight timer-thread fire has finished, so the callback never runs afterwards
+            /// @since 1.5
+            void stopPreciseTimer(unsigned int timerId);
+
         public:
             FB::DOM::DocumentPtr getDOMDocument();
             FB::DOM::WindowPtr getDOMWindow();
@@ -74,6 +105,17 @@ namespace FB {
             mutable FB::DOM::WindowPtr m_window;
             mutable FB::DOM::DocumentPtr m_document;
 
+        protected:
+            struct PreciseTimer;
+            static void CALLBACK _preciseTimerProc(void* param, BOOLEAN);
+            static void _deliverPreciseTimer(void* param);
+
+            mutable boost::mutex m_preciseTimerMutex;
+            std::map<unsigned int, PreciseTimer*> m_preciseTimers;
+            std::map<unsigned int, HANDLE> m_preciseTimerHandles;
+            unsigned int m_lastPreciseTimerId;
+            HANDLE m_timerQueue;  // lazily created; owns the timer-queue thread
+
         public:
             FB::variant getVariant(const VARIANT *cVar);
             void getComVariant(VARIANT *dest, const FB::variant &var);
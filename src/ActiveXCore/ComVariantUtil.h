@@ -94,17 +94,23 @@ namespace FB { namespace ActiveX
     template<> inline
     CComVariant makeComVariant<std::string>(const ActiveXBrowserHostPtr& host, const FB::variant& var)
     {
-        std::wstring wstr = var.convert_cast<std::wstring>();
-        CComBSTR bStr(wstr.c_str());
-        return bStr;
+        const std::wstring wstr = var.convert_cast<std::wstring>();
+        // Allocate the BSTR once, sized up front, and hand ownership straight to the
+        // variant; routing through CComBSTR pays a second SysAllocString for the copy
+        CComVariant out;
+        out.vt = VT_BSTR;
+        out.bstrVal = ::SysAllocStringLen(wstr.data(), static_cast<UINT>(wstr.size()));
+        return out;
     }
 
     template<> inline
     CComVariant makeComVariant<std::wstring>(const ActiveXBrowserHostPtr& host, const FB::variant& var)
     {
-        std::wstring wstr = var.convert_cast<std::wstring>();
-        CComBSTR bStr(wstr.c_str());
-        return bStr;
+        const std::wstring& wstr = var.cast<std::wstring>();
+        CComVariant out;
+        out.vt = VT_BSTR;
+        out.bstrVal = ::SysAllocStringLen(wstr.data(), static_cast<UINT>(wstr.size()));
+        return out;
     }
     
     template<> inline
@@ -75,6 +75,11 @@ namespace FB {
 
         protected:
             FB::PluginWindowWin *pluginWin;
+            // Cached copy of the clip rect the container last pushed through
+            // SetObjectRects (the position lives in CComControlBase::m_rcPos);
+            // paired with a generation so draw code can validate cheaply
+            RECT m_rcClip;
+            unsigned int m_geometryGeneration;
             CComQIPtr<IServiceProvider> m_serviceProvider;
             CComQIPtr<IWebBrowser2> m_webBrowser;
             const std::string m_mimetype;
@@ -90,8 +95,9 @@ namespace FB {
             // The methods in this class are positioned in this file in the
             // rough order that they will be called in.
             CFBControl() : JSAPI_IDispatchEx<CFBControlX, ICurObjInterface, piid>(pMT), FB::BrowserPlugin(pMT),
-                pluginWin(NULL), m_mimetype(pMT)
+                pluginWin(NULL), m_geometryGeneration(0), m_mimetype(pMT)
             {
+                SetRectEmpty(&m_rcClip);
                 FB::PluginCore::setPlatform("Windows", "IE");
                 setFSPath(g_dllPath);
                 if (FB::pluginGuiEnabled())
@@ -124,6 +130,18 @@ namespace FB {
             // Called when the control is deactivated when it's time to shut down
             STDMETHOD(InPlaceDeactivate)(void);
 
+            // Geometry notifications from the container.  Identical rects are
+            // short-circuited (IE re-sends them freely) and real changes bump the
+            // geometry generation, so per-paint code can use the cached copies
+            // below instead of round-tripping to the site each frame
+            STDMETHOD(SetObjectRects)(LPCRECT prcPos, LPCRECT prcClip);
+
+            // Cached site geometry; refreshed only by SetObjectRects
+            const RECT& getPosRect() const { return this->m_rcPos; }
+            const RECT& getClipRect() const { return m_rcClip; }
+            // bumped whenever the container actually moves or re-clips the control
+            unsigned int getGeometryGeneration() const { return m_geometryGeneration; }
+
             /* IPersistPropertyBag calls */
             // This will be called once when the browser initializes the property bag (PARAM tags) 
             // Often (always?) this is only called if there are no items in the property bag
@@ -251,6 +269,23 @@ namespace FB {
             return hr;
         }
 
+        template <const GUID* pFbCLSID, const char* pMT, class ICurObjInterface, const IID* piid, const GUID* plibid>
+        STDMETHODIMP CFBControl<pFbCLSID, pMT,ICurObjInterface,piid,plibid>::SetObjectRects( LPCRECT prcPos, LPCRECT prcClip )
+        {
+            // The container calls this with unchanged geometry far more often than
+            // the control actually moves; skip the full reposition in that case.
+            // The generation guard keeps the very first notification from being
+            // mistaken for a no-op against the zero-initialized cache
+            if (m_geometryGeneration && prcPos && prcClip
+                && EqualRect(prcPos, &this->m_rcPos) && EqualRect(prcClip, &m_rcClip)) {
+                return S_OK;
+            }
+            if (prcClip)
+                m_rcClip = *prcClip;
+            ++m_geometryGeneration;
+            return IOleInPlaceObjectWindowlessImpl<CFBControlX>::SetObjectRects(prcPos, prcClip);
+        }
+
         template <const GUID* pFbCLSID, const char* pMT, class ICurObjInterface, const IID* piid, const GUID* plibid>
         STDMETHODIMP CFBControl<pFbCLSID, pMT,ICurObjInterface,piid,plibid>::InitNew()
         {
@@ -23,6 +23,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include <atlctl.h>
 #include <vector>
 #include <string>
+#include <boost/unordered_map.hpp>
 
 namespace FB { namespace ActiveX {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -56,9 +57,16 @@ namespace FB { namespace ActiveX {
         CComQIPtr<IDispatch> m_obj;
         bool is_JSAPI;
         FB::JSAPIWeakPtr inner;
+        // name -> DISPID cache; DISPIDs are stable for the lifetime of the object, so each
+        // name is resolved (and converted to a wide string) at most once.  Only touched on
+        // the main thread, so no lock is needed
+        typedef boost::unordered_map<std::string, DISPID> DispIdCache;
+        mutable DispIdCache m_dispIdCache;
 
     protected:
         DISPID getIDForName(const std::wstring& name) const;
+        // Caching overload; all of the utf8 entry points resolve through this
+        DISPID getIDForName(const std::string& name) const;
 
     public:
         bool HasMethod(const std::string& methodName) const;
@@ -73,6 +81,10 @@ namespace FB { namespace ActiveX {
         void SetProperty(const std::string& propertyName, const FB::variant& value);
         FB::variant GetProperty(int idx);
         void SetProperty(int idx, const FB::variant& value);
+        // Batched overrides; one main-thread marshal for the whole set, DISPIDs
+        // resolved through the cache and the invokes issued back-to-back
+        FB::VariantMap GetProperties(const std::vector<std::string>& propertyNames);
+        void SetProperties(const FB::VariantMap& properties);
 
         FB::variant Invoke(const std::string& methodName, const FB::VariantList& args);
         FB::JSObjectPtr Construct(const std::string& memberName, const FB::VariantList& args);
@@ -27,6 +27,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include "IDispatchAPI.h"
 #include "dispex.h"
 #include <map>
+#include <boost/unordered_map.hpp>
 #include "logging.h"
 #include <mshtmdid.h>
 
@@ -152,6 +153,16 @@ namespace FB { namespace ActiveX {
         
         bool m_valid;
         std::vector<std::wstring> m_memberList;
+        // Lazily-built index over m_memberList: name -> interned DISPID for GetDispID
+        // and DISPID -> list position for GetNextDispID.  Members are never
+        // unregistered, so entries stay valid once made; the member-count check in
+        // refreshMemberList picks up late registrations
+        typedef boost::unordered_map<std::wstring, DISPID> MemberIdMap;
+        typedef boost::unordered_map<DISPID, size_t> MemberPosMap;
+        MemberIdMap m_memberIds;
+        MemberPosMap m_memberPos;
+
+        void refreshMemberList(const FB::JSAPIPtr& api);
 
         virtual bool callSetEventListener(const std::vector<FB::variant> &args, bool add);
 
@@ -334,6 +345,22 @@ namespace FB { namespace ActiveX {
 
 
     /* IDispatchEx members */
+    template <class T, class IDISP, const IID* piid>
+    void JSAPI_IDispatchEx<T,IDISP,piid>::refreshMemberList(const FB::JSAPIPtr& api)
+    {
+        if (m_memberList.size() == api->getMemberCount())
+            return;
+        m_memberList.clear();
+        api->getMemberNames(m_memberList);
+        m_memberIds.clear();
+        m_memberPos.clear();
+        for (size_t i = 0; i < m_memberList.size(); ++i) {
+            DISPID curId = AxIdMap.getIdForValue(m_memberList[i]);
+            m_memberIds[m_memberList[i]] = curId;
+            m_memberPos[curId] = i;
+        }
+    }
+
     template <class T, class IDISP, const IID* piid>
     HRESULT JSAPI_IDispatchEx<T,IDISP,piid>::GetDispID(BSTR bstrName, DWORD grfdex, DISPID *pid)
     {
@@ -341,6 +368,14 @@ namespace FB { namespace ActiveX {
 
         try {
             FB::JSAPIPtr api(getAPI());
+            // Fast path: members seen by the last enumeration resolve with one hash
+            // probe instead of three JSAPI lookups.  Only positives live in the map,
+            // so members registered since then still resolve through the slow path
+            MemberIdMap::const_iterator fnd = m_memberIds.find(wsName);
+            if (fnd != m_memberIds.end()) {
+                *pid = fnd->second;
+                return S_OK;
+            }
             if ((wsName == L"attachEvent") || (wsName == L"detachEvent")) {
                 *pid = AxIdMap.getIdForValue(wsName);
             } else if (api->HasProperty(wsName) || api->HasMethod(wsName) || api->HasEvent(wsName)) {
@@ -561,31 +596,20 @@ namespace FB { namespace ActiveX {
             return S_FALSE;
         }
 
-        if (m_memberList.size() != api->getMemberCount()) {
-            m_memberList.clear();
-            api->getMemberNames(m_memberList);
-        }
+        refreshMemberList(api);
         if (m_memberList.size() == 0)
             return S_FALSE;
 
         if (id == DISPID_STARTENUM) {
-            *pid = AxIdMap.getIdForValue(m_memberList[0]);
+            *pid = m_memberIds[m_memberList[0]];
             return S_OK;
-        } 
-        std::wstring wStr = AxIdMap.getValueForId<std::wstring>(id);
-
-        std::vector<std::wstring>::iterator it;
-        for (it = m_memberList.begin(); it != m_memberList.end(); it++) {
-            if (wStr == *it) {
-                it++;
-                break;
-            }
         }
-        if (it != m_memberList.end()) {
-            *pid = AxIdMap.getIdForValue(*it);
-        } else {
+        // One hash probe to find where we are instead of a name scan of the whole
+        // member list on every step of the enumeration
+        MemberPosMap::const_iterator fnd = m_memberPos.find(id);
+        if (fnd == m_memberPos.end() || fnd->second + 1 >= m_memberList.size())
             return S_FALSE;
-        }
+        *pid = m_memberIds[m_memberList[fnd->second + 1]];
         return S_OK;
     }
 
@@ -28,7 +28,7 @@ ActiveXStream::~ActiveXStream()
     close();
 }
 
-bool ActiveXStream::readRanges( const std::vector<Range>& ranges )
+bool ActiveXStream::doReadRanges( const std::vector<Range>& ranges )
 {
     if ( !isSeekable() || !isOpen() ) return false;
     if ( !ranges.size() ) return true;
@@ -91,10 +91,12 @@ size_t ActiveXStream::signalDataArrived(void* buffer, size_t len, size_t offset)
         {
             progress = float( offset + len ) / float( getLength() ) * 100.f;
         }
-        if ( isOpen() || (getCacheFilename() != L"") ) 
+        if ( isOpen() || (getCacheFilename() != L"") )
         {
+            cacheArrivedData( buffer, effectiveLen, offset );
             StreamDataArrivedEvent ev(this, buffer, effectiveLen, offset, progress);
             SendEvent( &ev );
+            reportProgress( offset + len );
         }
     }
     return effectiveLen;
@@ -31,7 +31,7 @@ namespace FB { namespace ActiveX {
         ActiveXStream(const std::string& url, bool cache, bool seekable, size_t internalBufferSize );
         virtual ~ActiveXStream();
         
-        virtual bool readRanges( const std::vector<Range>& ranges );
+        virtual bool doReadRanges( const std::vector<Range>& ranges );
         virtual bool write(const char* data, size_t dataLength, size_t& written);
         virtual bool close();
 
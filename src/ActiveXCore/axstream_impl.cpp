@@ -20,6 +20,7 @@ Copyright 2010 Richard Bateman, Firebreath development team
 #include "axstream.h"
 #include <tchar.h>
 #include <sstream>
+#include <algorithm>
 #include "wininet.h"
 #include "utf8_tools.h"
 
@@ -309,20 +310,26 @@ ActiveXBindStatusCallback::OnDataAvailable(DWORD grfBSCF, DWORD dwSize, FORMATET
         }
 
         if (dwRead > 0)
-        do
         {
-            std::vector<char> data( dwRead );
-
-            hr = m_pstm->Read( &data[0], dwRead, &dwActuallyRead);
-
-            // If we really read something then lets add it to the Edit box
-            if (dwActuallyRead > 0)
+            // Drain in bounded chunks through a buffer reused across notifications;
+            // allocating (and zero-filling) the whole outstanding range on every
+            // notification stalled the STA thread on large responses
+            const DWORD chunkSize = (std::min)( dwRead, static_cast<DWORD>(64 * 1024) );
+            if ( m_readBuffer.size() < chunkSize )
+                m_readBuffer.resize( chunkSize );
+
+            do
             {
-                if ( m_request->stream ) m_request->stream->signalDataArrived( &data[0], dwActuallyRead, offset + m_cbOld );
-                m_cbOld += dwActuallyRead;
-            }
+                hr = m_pstm->Read( &m_readBuffer[0], chunkSize, &dwActuallyRead);
 
-        } while (!(hr == E_PENDING || hr == S_FALSE) && SUCCEEDED(hr));
+                if (dwActuallyRead > 0)
+                {
+                    if ( m_request->stream ) m_request->stream->signalDataArrived( &m_readBuffer[0], dwActuallyRead, offset + m_cbOld );
+                    m_cbOld += dwActuallyRead;
+                }
+
+            } while (!(hr == E_PENDING || hr == S_FALSE) && SUCCEEDED(hr));
+        }
     }
 
     // Clean up
@@ -103,6 +103,9 @@ namespace FB { namespace ActiveX {
         BINDVERB        m_dwAction;
         ActiveXStreamRequestPtr m_request;
         bool            m_transactionStarted;
+        // Scratch buffer reused by OnDataAvailable's drain loop; grown to the chunk
+        // size once and kept for the life of the binding
+        std::vector<char> m_readBuffer;
     };
 } }
 
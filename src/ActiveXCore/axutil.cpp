@@ -14,10 +14,44 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 #include "axutil.h"
 #include "atlstr.h"
+#include "utf8_tools.h"
+#include <boost/thread/tss.hpp>
 
 using namespace FB;
 using namespace FB::ActiveX;
 
+namespace {
+    // per-thread scratch for the narrow<->wide conversions below; reused so
+    // steady-state marshalling doesn't allocate an intermediate per call
+    boost::thread_specific_ptr<std::wstring> conv_scratch;
+
+    std::wstring& getConvScratch() {
+        std::wstring* ws = conv_scratch.get();
+        if (!ws) {
+            ws = new std::wstring;
+            conv_scratch.reset(ws);
+        }
+        return *ws;
+    }
+}
+
+void FB::ActiveX::utf8ToBSTR(const std::string& src, CComBSTR& dest)
+{
+    std::wstring& ws = getConvScratch();
+    FB::utf8_to_wstring(src, ws);
+    dest.Empty();
+    dest.Attach(::SysAllocStringLen(ws.data(), static_cast<UINT>(ws.size())));
+}
+
+std::string FB::ActiveX::bstrToUTF8(BSTR bstr)
+{
+    if (!bstr)
+        return std::string();
+    std::wstring& ws = getConvScratch();
+    ws.assign(bstr, ::SysStringLen(bstr));
+    return FB::wstring_to_utf8(ws);
+}
+
 FbPerUserRegistration::FbPerUserRegistration(bool perUser) 
 #if _ATL_VER < 0x0900
   : m_mapping(false)
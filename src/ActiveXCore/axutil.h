@@ -19,10 +19,19 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include "win_common.h"
 #include "TypeIDMap.h"
 
-namespace FB { 
+namespace FB {
     namespace ActiveX {
         extern FB::TypeIDMap<DISPID> AxIdMap;
 
+        // Fills dest with the UTF-16 form of src.  The wide intermediate
+        // lives in a thread-local scratch buffer, so the IE->JSAPI string
+        // path pays exactly one conversion and no transient allocations
+        // once the scratch has grown to the working size.
+        void utf8ToBSTR(const std::string& src, CComBSTR& dest);
+        // Converts a BSTR (may be NULL) to UTF-8 through the same
+        // thread-local scratch buffer
+        std::string bstrToUTF8(BSTR bstr);
+
         class FbPerUserRegistration
         {
         public:
@@ -11,9 +11,13 @@
 
 #include <atlbase.h>
 
+// Tag type: the data pointer is a string literal (or other static storage)
+// and should be referenced in place rather than copied to the heap
+struct _regmap_static_data {};
+
 struct _ATL_REGMAP_ENTRYKeeper : public _ATL_REGMAP_ENTRY
 {
-	_ATL_REGMAP_ENTRYKeeper(){ szKey=NULL; szData=NULL;}
+	_ATL_REGMAP_ENTRYKeeper(){ szKey=NULL; szData=NULL; m_owned=false;}
     _ATL_REGMAP_ENTRYKeeper(LPCOLESTR key, LPCSTR cstrData)
     {
         USES_CONVERSION;
@@ -22,13 +26,22 @@ struct _ATL_REGMAP_ENTRYKeeper : public _ATL_REGMAP_ENTRY
 		LPOLESTR newData;
 		szData = LPCOLESTR(newData =  new wchar_t[wcslen(data)+1]);
 		wcscpy_s(newData,wcslen(data) + 1,data);
+		m_owned=true;
     }
-	_ATL_REGMAP_ENTRYKeeper(LPCOLESTR key, LPCOLESTR data) 
+	_ATL_REGMAP_ENTRYKeeper(LPCOLESTR key, LPCOLESTR data)
 	{
 		szKey=key;
 		LPOLESTR newData;
 		szData = LPCOLESTR(newData =  new wchar_t[wcslen(data)+1]);
 		wcscpy_s(newData,wcslen(data)+1,data);
+		m_owned=true;
+	}
+	// Both key and data are compile-time constants; no allocation, no copy
+	_ATL_REGMAP_ENTRYKeeper(LPCOLESTR key, LPCOLESTR data, _regmap_static_data)
+	{
+		szKey=key;
+		szData=data;
+		m_owned=false;
 	}
 	_ATL_REGMAP_ENTRYKeeper(LPCOLESTR key, UINT resid)
 	{
@@ -45,13 +58,15 @@ struct _ATL_REGMAP_ENTRYKeeper : public _ATL_REGMAP_ENTRY
 
 		szData = new wchar_t[length];
 		wcscpy_s(const_cast<wchar_t *>(szData), length, Data);
+		m_owned=true;
 	}
 
-	_ATL_REGMAP_ENTRYKeeper(LPCOLESTR key, REFGUID guid) 
+	_ATL_REGMAP_ENTRYKeeper(LPCOLESTR key, REFGUID guid)
 	{
 		szKey=key;
 		LPOLESTR newData;
 		szData = LPCOLESTR(newData =  new wchar_t[40]);
+		m_owned=true;
 		if(szData!=NULL)
 		{
 			if(0==StringFromGUID2(guid, newData,40))
@@ -62,13 +77,18 @@ struct _ATL_REGMAP_ENTRYKeeper : public _ATL_REGMAP_ENTRY
 	}
 	~_ATL_REGMAP_ENTRYKeeper()
 	{
-		delete [] (LPOLESTR)szData;
+		if (m_owned)
+			delete [] (LPOLESTR)szData;
 	}
+
+	bool m_owned;
 };
 
 #define BEGIN_REGMAP(x) static struct _ATL_REGMAP_ENTRY *_GetRegistryMap() { static const _ATL_REGMAP_ENTRYKeeper map[] = {
 
-#define REGMAP_ENTRY(x,y) _ATL_REGMAP_ENTRYKeeper(OLESTR(##x),y),
+// x and y are string literals, so the entry is pure static data; the
+// allocating LPCSTR constructor is kept for callers with runtime strings
+#define REGMAP_ENTRY(x,y) _ATL_REGMAP_ENTRYKeeper(OLESTR(##x),OLESTR(##y),_regmap_static_data()),
 
 #define REGMAP_UUID(x,clsid) _ATL_REGMAP_ENTRYKeeper(OLESTR(##x),clsid),
 
@@ -134,6 +134,11 @@ void NP_LOADDS NpapiHost::NH_PopPopupsEnabledState(NPP npp)
 /* NPN_PluginThreadAsyncCall */
 void NP_LOADDS NpapiHost::NH_PluginThreadAsyncCall(NPP instance, void (*func)(void *), void *userData)
 {
+    // queued when the host asked for it (see setQueueAsyncCalls), inline otherwise
+    NpapiHost* host = instance ? static_cast<NpapiHost*>(instance->ndata) : NULL;
+    if (host && host->queueAsyncCall(func, userData)) {
+        return;
+    }
     func(userData);
 }
 
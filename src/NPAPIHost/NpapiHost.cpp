@@ -20,7 +20,7 @@ using namespace FB::Npapi;
 FB::TypeIDMap<NPIdentifier> NpapiHost::m_idMapper((NPIdentifier)100);
 
 NpapiHost::NpapiHost(NPInitFuncPtr initPtr, NPShutdownFuncPtr shutdownPtr, NPGetEntryPointsFuncPtr getepPtr)
-    : init(initPtr), shutdown(shutdownPtr), getEntryPoints(getepPtr)
+    : init(initPtr), shutdown(shutdownPtr), getEntryPoints(getepPtr), m_queueAsyncCalls(false)
 {
     memset(&m_funcs, 0, sizeof(NPNetscapeFuncs));
     memset(&m_instance, 0, sizeof(NPP_t));
@@ -89,3 +89,59 @@ NPP NpapiHost::getPluginInstance()
 {
     return &m_instance;
 }
+
+NPError NpapiHost::initializePlugin(NPPluginFuncs* pluginFuncs)
+{
+    if (!init) {
+        return NPERR_INVALID_FUNCTABLE_ERROR;
+    }
+    pluginFuncs->size = sizeof(NPPluginFuncs);
+#ifdef LINUX
+    return init(&m_funcs, pluginFuncs);
+#else
+    NPError err = init(&m_funcs);
+    if (err == NPERR_NO_ERROR && getEntryPoints) {
+        err = getEntryPoints(pluginFuncs);
+    }
+    return err;
+#endif
+}
+
+void NpapiHost::shutdownPlugin()
+{
+    if (shutdown) {
+        shutdown();
+    }
+}
+
+void NpapiHost::setQueueAsyncCalls(bool queue)
+{
+    boost::mutex::scoped_lock lock(m_asyncMutex);
+    m_queueAsyncCalls = queue;
+}
+
+bool NpapiHost::queueAsyncCall(void (*func)(void *), void *userData)
+{
+    boost::mutex::scoped_lock lock(m_asyncMutex);
+    if (!m_queueAsyncCalls) {
+        return false;
+    }
+    m_asyncQueue.push_back(std::make_pair(func, userData));
+    return true;
+}
+
+size_t NpapiHost::drainAsyncCalls()
+{
+    // swap the queue out so calls scheduled while draining wait for the next drain,
+    // the same way a real browser won't starve its event loop on one burst
+    std::deque<std::pair<void (*)(void *), void *> > batch;
+    {
+        boost::mutex::scoped_lock lock(m_asyncMutex);
+        batch.swap(m_asyncQueue);
+    }
+    for (std::deque<std::pair<void (*)(void *), void *> >::const_iterator it = batch.begin();
+            it != batch.end(); ++it) {
+        it->first(it->second);
+    }
+    return batch.size();
+}
@@ -26,6 +26,9 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #ifndef H_NPAPIHOST
 #define H_NPAPIHOST
 
+#include <deque>
+#include <utility>
+#include <boost/thread/mutex.hpp>
 #include "NpapiTypes.h"
 #include "npruntime.h"
 #include "NpapiTypes.h"
@@ -43,7 +46,40 @@ namespace FB { namespace Npapi {
         NPNetscapeFuncs *getBrowserFuncs();
         NPP getPluginInstance();
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn NPError initializePlugin(NPPluginFuncs* pluginFuncs)
+        ///
+        /// @brief  Runs the plugin's NP_Initialize/NP_GetEntryPoints sequence
+        ///
+        /// Hides the platform difference (unix hands both function tables to NP_Initialize, windows
+        /// fetches the plugin table through NP_GetEntryPoints) so drivers like NpapiHostBench can
+        /// load a plugin with one call.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        NPError initializePlugin(NPPluginFuncs* pluginFuncs);
+
+        /// Runs the plugin's NP_Shutdown, if one was supplied
+        void shutdownPlugin();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setQueueAsyncCalls(bool queue)
+        ///
+        /// @brief  Switches NPN_PluginThreadAsyncCall between inline and queued delivery
+        ///
+        /// By default async calls run inline, which keeps the existing unit tests simple.  When
+        /// queued, calls pile up (as they do in a real browser whose main thread is busy) until
+        /// drainAsyncCalls() runs them, which lets the benchmark driver measure drain rates.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setQueueAsyncCalls(bool queue);
+
+        /// Runs every queued async call on the calling thread and returns how many ran
+        size_t drainAsyncCalls();
+
     protected:
+        // Accepts the call into the queue; false when queuing is disabled (caller runs inline)
+        bool queueAsyncCall(void (*func)(void *), void *userData);
+
         NPP_t m_instance;
         NPNetscapeFuncs m_funcs;
         static FB::TypeIDMap<NPIdentifier> m_idMapper;
@@ -53,6 +89,12 @@ namespace FB { namespace Npapi {
         NPShutdownFuncPtr shutdown;
         NPGetEntryPointsFuncPtr getEntryPoints;
 
+        // Queued NPN_PluginThreadAsyncCall requests; the plugin schedules from worker
+        // threads, so the queue takes a lock
+        bool m_queueAsyncCalls;
+        boost::mutex m_asyncMutex;
+        std::deque<std::pair<void (*)(void *), void *> > m_asyncQueue;
+
     public:
         /* NpruntimeHostFuncs */
         static bool NP_LOADDS NH_Invoke(NPP npp, NPObject* obj, NPIdentifier methodName, const NPVariant *args, uint32_t argCount, NPVariant *result);
@@ -0,0 +1,176 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "NpapiHostBench.h"
+
+using namespace FB::Npapi;
+
+namespace {
+    inline double elapsedUs(const boost::posix_time::ptime& since)
+    {
+        return static_cast<double>(
+            (boost::posix_time::microsec_clock::universal_time() - since).total_microseconds());
+    }
+
+    void noopAsyncCall(void *)
+    {
+    }
+}
+
+NpapiHostBench::NpapiHostBench(NpapiHost& host)
+    : m_host(host), m_scriptable(NULL), m_loaded(false)
+{
+    memset(&m_pluginFuncs, 0, sizeof(NPPluginFuncs));
+}
+
+NpapiHostBench::~NpapiHostBench()
+{
+    unloadPlugin();
+}
+
+bool NpapiHostBench::loadPlugin(const std::string& mimeType)
+{
+    if (m_loaded)
+        return true;
+
+    if (m_host.initializePlugin(&m_pluginFuncs) != NPERR_NO_ERROR || !m_pluginFuncs.newp)
+        return false;
+
+    NPP instance = m_host.getPluginInstance();
+    if (m_pluginFuncs.newp(const_cast<char*>(mimeType.c_str()), instance,
+            NP_EMBED, 0, NULL, NULL, NULL) != NPERR_NO_ERROR)
+        return false;
+    m_loaded = true;
+
+    if (m_pluginFuncs.getvalue)
+        m_pluginFuncs.getvalue(instance, NPPVpluginScriptableNPObject, &m_scriptable);
+    if (!m_scriptable) {
+        unloadPlugin();
+        return false;
+    }
+    return true;
+}
+
+void NpapiHostBench::unloadPlugin()
+{
+    if (m_scriptable) {
+        NpapiHost::NH_ReleaseObject(m_scriptable);
+        m_scriptable = NULL;
+    }
+    if (m_loaded) {
+        if (m_pluginFuncs.destroy)
+            m_pluginFuncs.destroy(m_host.getPluginInstance(), NULL);
+        m_host.shutdownPlugin();
+        m_loaded = false;
+    }
+}
+
+FB::Npapi::BenchStats NpapiHostBench::benchInvoke(const std::string& method, const NPVariant* args,
+                                                  uint32_t argCount, size_t calls)
+{
+    NPP instance = m_host.getPluginInstance();
+    NPIdentifier id = NpapiHost::NH_GetStringIdentifier(method.c_str());
+    std::vector<double> samples;
+    samples.reserve(calls);
+    size_t failures = 0;
+    for (size_t i = 0; i < calls; ++i) {
+        NPVariant result;
+        VOID_TO_NPVARIANT(result);
+        boost::posix_time::ptime start(boost::posix_time::microsec_clock::universal_time());
+        bool ok = NpapiHost::NH_Invoke(instance, m_scriptable, id, args, argCount, &result);
+        samples.push_back(elapsedUs(start));
+        if (!ok)
+            ++failures;
+        NpapiHost::NH_ReleaseVariantValue(&result);
+    }
+    return summarize(samples, failures);
+}
+
+FB::Npapi::BenchStats NpapiHostBench::benchGetProperty(const std::string& name, size_t calls)
+{
+    NPP instance = m_host.getPluginInstance();
+    NPIdentifier id = NpapiHost::NH_GetStringIdentifier(name.c_str());
+    std::vector<double> samples;
+    samples.reserve(calls);
+    size_t failures = 0;
+    for (size_t i = 0; i < calls; ++i) {
+        NPVariant result;
+        VOID_TO_NPVARIANT(result);
+        boost::posix_time::ptime start(boost::posix_time::microsec_clock::universal_time());
+        bool ok = NpapiHost::NH_GetProperty(instance, m_scriptable, id, &result);
+        samples.push_back(elapsedUs(start));
+        if (!ok)
+            ++failures;
+        NpapiHost::NH_ReleaseVariantValue(&result);
+    }
+    return summarize(samples, failures);
+}
+
+double NpapiHostBench::measureDrainRate(size_t count)
+{
+    NPP instance = m_host.getPluginInstance();
+    m_host.setQueueAsyncCalls(true);
+    for (size_t i = 0; i < count; ++i)
+        NpapiHost::NH_PluginThreadAsyncCall(instance, &noopAsyncCall, NULL);
+
+    boost::posix_time::ptime start(boost::posix_time::microsec_clock::universal_time());
+    size_t drained = m_host.drainAsyncCalls();
+    double us = elapsedUs(start);
+    m_host.setQueueAsyncCalls(false);
+
+    if (us <= 0.0)
+        us = 1.0;
+    double rate = drained * 1e6 / us;
+    std::printf("BENCH name=async_drain calls=%lu rate_s=%.0f us_total=%.1f\n",
+                static_cast<unsigned long>(drained), rate, us);
+    std::fflush(stdout);
+    return rate;
+}
+
+FB::Npapi::BenchStats NpapiHostBench::summarize(std::vector<double>& samplesUs, size_t failures)
+{
+    BenchStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.calls = samplesUs.size();
+    stats.failures = failures;
+    if (samplesUs.empty())
+        return stats;
+    std::sort(samplesUs.begin(), samplesUs.end());
+    double sum = 0;
+    for (size_t i = 0; i < samplesUs.size(); ++i)
+        sum += samplesUs[i];
+    const size_t last = samplesUs.size() - 1;
+    stats.minUs = samplesUs.front();
+    stats.meanUs = sum / samplesUs.size();
+    stats.p50Us = samplesUs[last * 50 / 100];
+    stats.p95Us = samplesUs[last * 95 / 100];
+    stats.p99Us = samplesUs[last * 99 / 100];
+    return stats;
+}
+
+void NpapiHostBench::report(const std::string& name, const BenchStats& stats)
+{
+    // one record per line, key=value fields: trivially greppable and parseable
+    std::printf("BENCH name=%s calls=%lu failures=%lu us_min=%.2f us_mean=%.2f"
+                " us_p50=%.2f us_p95=%.2f us_p99=%.2f\n",
+                name.c_str(), static_cast<unsigned long>(stats.calls),
+                static_cast<unsigned long>(stats.failures),
+                stats.minUs, stats.meanUs, stats.p50Us, stats.p95Us, stats.p99Us);
+    std::fflush(stdout);
+}
@@ -0,0 +1,105 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_NPAPIHOSTBENCH
+#define H_NPAPIHOSTBENCH
+
+#include <string>
+#include <vector>
+#include "NpapiHost.h"
+
+namespace FB { namespace Npapi {
+
+    /// Latency distribution of one benchmark run, all times in microseconds
+    struct BenchStats {
+        size_t calls;
+        size_t failures;
+        double minUs;
+        double meanUs;
+        double p50Us;
+        double p95Us;
+        double p99Us;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  NpapiHostBench
+    ///
+    /// @brief  Headless round-trip benchmark driver built on NpapiHost
+    ///
+    /// Loads a plugin through the emulated browser, pulls its scriptable NPObject, and times N
+    /// scripted Invoke/GetProperty round trips through the NPRuntime shim -- the same boundary a
+    /// real browser crosses, minus the browser.  Results come back as latency distributions
+    /// (min/mean/p50/p95/p99) and a queued-async-call drain rate, printed as one machine-readable
+    /// BENCH line per run so dispatch-path changes can be quantified without hand-testing in four
+    /// browsers.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class NpapiHostBench
+    {
+    public:
+        NpapiHostBench(NpapiHost& host);
+        ~NpapiHostBench();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool loadPlugin(const std::string& mimeType = "application/x-firebreath")
+        ///
+        /// @brief  Initializes the plugin, creates one instance and fetches its scriptable object
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool loadPlugin(const std::string& mimeType = "application/x-firebreath");
+
+        /// Destroys the instance and shuts the plugin down; the destructor calls this too
+        void unloadPlugin();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn BenchStats benchInvoke(const std::string& method, const NPVariant* args,
+        ///         uint32_t argCount, size_t calls)
+        ///
+        /// @brief  Times `calls` NPN_Invoke round trips of the named method
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        BenchStats benchInvoke(const std::string& method, const NPVariant* args,
+                               uint32_t argCount, size_t calls);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn BenchStats benchGetProperty(const std::string& name, size_t calls)
+        ///
+        /// @brief  Times `calls` NPN_GetProperty round trips of the named property
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        BenchStats benchGetProperty(const std::string& name, size_t calls);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn double measureDrainRate(size_t count)
+        ///
+        /// @brief  Queues `count` no-op async calls and times one drain; returns calls per second
+        ///
+        /// Exercises the NPN_PluginThreadAsyncCall path in queued mode, which is what the plugin's
+        /// worker threads see when a busy browser batches their main-thread work.
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        double measureDrainRate(size_t count);
+
+        /// Prints one machine-readable BENCH line for the run
+        static void report(const std::string& name, const BenchStats& stats);
+
+    private:
+        static BenchStats summarize(std::vector<double>& samplesUs, size_t failures);
+
+        NpapiHost& m_host;
+        NPPluginFuncs m_pluginFuncs;
+        NPObject* m_scriptable;
+        bool m_loaded;
+    };
+
+}; };
+
+#endif
@@ -12,13 +12,46 @@ License:    Dual license model; choose one of two:
 Copyright 2009 Richard Bateman, Firebreath development team
 \**********************************************************/
 
+#include <new>
 #include <typeinfo>
+#include <boost/pool/singleton_pool.hpp>
 #include "JSObject.h"
+#include "Util/CallArena.h"
 
 #include "NPJavascriptObject.h"
 
 using namespace FB::Npapi;
 
+namespace {
+    // One free-list pool per wrapper class; every instance is the same size, so
+    // a freed slot is immediately reusable by the next bind
+    typedef boost::singleton_pool<NPJavascriptObject, sizeof(NPJavascriptObject)> NPJavascriptObjectPool;
+}
+
+void* NPJavascriptObject::operator new(std::size_t size)
+{
+    if (size != sizeof(NPJavascriptObject)) {
+        return ::operator new(size);
+    }
+    void* ptr = NPJavascriptObjectPool::malloc();
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void NPJavascriptObject::operator delete(void* ptr, std::size_t size)
+{
+    if (!ptr) {
+        return;
+    }
+    if (size != sizeof(NPJavascriptObject)) {
+        ::operator delete(ptr);
+        return;
+    }
+    NPJavascriptObjectPool::free(ptr);
+}
+
 NPJavascriptObject *NPJavascriptObject::NewObject(NpapiBrowserHostPtr host, FB::JSAPIWeakPtr api)
 {
     NPJavascriptObject *obj = static_cast<NPJavascriptObject *>(host->CreateObject(&NPJavascriptObjectClass));
@@ -33,7 +66,8 @@ bool NPJavascriptObject::isNPJavaScriptObject(const NPObject* const npo)
 }
 
 NPJavascriptObject::NPJavascriptObject(NPP npp)
-    : m_valid(true), m_addEventFunc(boost::make_shared<NPO_addEventListener>(this)),
+    : m_valid(true), m_lastIdent(NULL), m_lastInfo(NULL),
+    m_addEventFunc(boost::make_shared<NPO_addEventListener>(this)),
     m_removeEventFunc(boost::make_shared<NPO_removeEventListener>(this))
 {
 }
@@ -56,6 +90,36 @@ FB::JSAPIPtr NPJavascriptObject::getAPI() const
     return ptr;
 }
 
+NPJavascriptObject::MemberInfo* NPJavascriptObject::findMemberInfo(NPIdentifier name)
+{
+    // monomorphic fast path: two compares, no hashing
+    if (name == m_lastIdent && m_lastInfo)
+        return m_lastInfo;
+    MemberIdCache::iterator fnd = m_memberIdCache.find(name);
+    if (fnd == m_memberIdCache.end())
+        return NULL;
+    m_lastIdent = name;
+    m_lastInfo = &fnd->second;
+    return m_lastInfo;
+}
+
+FB::MemberId NPJavascriptObject::getMemberId(NPIdentifier name, const FB::JSAPIPtr& api)
+{
+    MemberInfo* info = findMemberInfo(name);
+    if (info)
+        return info->id;
+    FB::MemberId id = api->getMemberId(m_browser->StringFromIdentifier(name));
+    // unresolved names are not cached, since the member could still be registered later
+    if (id != FB::InvalidMemberId) {
+        MemberInfo& newInfo = m_memberIdCache[name];
+        newInfo.id = id;
+        newInfo.flags = 0;
+        m_lastIdent = name;
+        m_lastInfo = &newInfo;
+    }
+    return id;
+}
+
 void NPJavascriptObject::Invalidate()
 {
     m_valid = false;
@@ -68,9 +132,25 @@ void NPJavascriptObject::Invalidate()
 bool NPJavascriptObject::HasMethod(NPIdentifier name)
 {
     try {
-        std::string mName = m_browser->StringFromIdentifier(name);
+        MemberInfo* cached = findMemberInfo(name);
+        if (cached && (cached->flags & Member_KindKnown))
+            return (cached->flags & Member_Method) != 0;
 
-        return !getAPI()->HasMethodObject(mName) && getAPI()->HasMethod(mName);
+        // promote the weak reference once for the whole dispatch
+        FB::JSAPIPtr api(getAPI());
+        std::string mName = m_browser->StringFromIdentifier(name);
+        const bool methodObj = api->HasMethodObject(mName);
+        const bool method = !methodObj && api->HasMethod(mName);
+        if (method || methodObj) {
+            // remember the classification and warm the member id in the same entry, so
+            // the Invoke or GetProperty that follows resolves in a single hash probe
+            MemberInfo& info = m_memberIdCache[name];
+            info.id = api->getMemberId(mName);
+            info.flags = Member_KindKnown | (method ? Member_Method : Member_MethodObject);
+            m_lastIdent = name;
+            m_lastInfo = &info;
+        }
+        return method;
     } catch (const std::bad_cast&) {
         return false; // invalid object
     } catch (const script_error& e) {
@@ -113,17 +193,25 @@ bool NPJavascriptObject::Invoke(NPIdentifier name, const NPVariant *args, uint32
 {
     VOID_TO_NPVARIANT(*result);
     try {
-        std::string mName;
-        if (name != NULL) {
-            mName = m_browser->StringFromIdentifier(name);
-        }
-        std::vector<FB::variant> vArgs;
-        for (unsigned int i = 0; i < argCount; i++) {
-            vArgs.push_back(m_browser->getVariant(&args[i]));
+        // promote the weak reference once for the whole dispatch
+        FB::JSAPIPtr api(getAPI());
+        // scratch argument list recycled between invocations, filled in one pass
+        FB::ScopedVariantArgs vArgs;
+        m_browser->getVariantList(vArgs.list(), args, argCount);
+
+        FB::variant ret;
+        FB::MemberId id = (name != NULL) ? getMemberId(name, api) : FB::InvalidMemberId;
+        if (id != FB::InvalidMemberId) {
+            // name-free dispatch straight to the member slot
+            ret = api->InvokeById(id, vArgs.list());
+        } else {
+            std::string mName;
+            if (name != NULL) {
+                mName = m_browser->StringFromIdentifier(name);
+            }
+            // Default method call
+            ret = api->Invoke(mName, vArgs.list());
         }
-
-        // Default method call
-        FB::variant ret = getAPI()->Invoke(mName, vArgs);
         m_browser->getNPVariant(result, ret);
         return true;
     } catch (const std::bad_cast&) {
@@ -142,10 +230,12 @@ bool NPJavascriptObject::InvokeDefault(const NPVariant *args, uint32_t argCount,
 bool NPJavascriptObject::HasProperty(NPIdentifier name)
 {
     try {
+        // promote the weak reference once for the whole dispatch
+        FB::JSAPIPtr api(getAPI());
         // Handle numeric identifiers
         if(!m_browser->IdentifierIsString(name)) {
             int32_t sIdx = m_browser->IntFromIdentifier(name);
-            return getAPI()->HasProperty(sIdx);
+            return api->HasProperty(sIdx);
         }
 
         std::string sName(m_browser->StringFromIdentifier(name));
@@ -154,10 +244,10 @@ bool NPJavascriptObject::HasProperty(NPIdentifier name)
 
         if (sName == "addEventListener" || sName == "removeEventListener") {
             return true;
-        } else if (sName != "toString" && getAPI()->HasMethodObject(sName))
+        } else if (sName != "toString" && api->HasMethodObject(sName))
             return true;
         else
-            return !HasMethod(name) && (getAPI()->HasEvent(sName) || getAPI()->HasProperty(sName));
+            return !HasMethod(name) && (api->HasEvent(sName) || api->HasProperty(sName));
     } catch (const std::bad_cast&) {
         return false; // invalid object
     } catch (const script_error& e) {
@@ -169,6 +259,8 @@ bool NPJavascriptObject::HasProperty(NPIdentifier name)
 bool NPJavascriptObject::GetProperty(NPIdentifier name, NPVariant *result)
 {
     try {
+        // promote the weak reference once for the whole dispatch
+        FB::JSAPIPtr api(getAPI());
         FB::variant res;
         if (m_browser->IdentifierIsString(name)) {
             std::string sName(m_browser->StringFromIdentifier(name));
@@ -176,17 +268,44 @@ bool NPJavascriptObject::GetProperty(NPIdentifier name, NPVariant *result)
                 res = m_addEventFunc;
             } else if (sName == "removeEventListener") {
                 res = m_removeEventFunc;
-            } else if (getAPI()->HasEvent(sName)) {
-                FB::JSObjectPtr tmp(getAPI()->getDefaultEventMethod(sName));
+            } else if (api->HasEvent(sName)) {
+                FB::JSObjectPtr tmp(api->getDefaultEventMethod(sName));
                 if (tmp != NULL)
                     res = tmp;
-            } else if (getAPI()->HasMethodObject(sName)) {
-                res = getAPI()->GetMethodObject(sName);
+            } else if (api->HasMethodObject(sName)) {
+                res = api->GetMethodObject(sName);
             } else {
-                res = getAPI()->GetProperty(sName);
+                FB::MemberId id = getMemberId(name, api);
+                // getMemberId just primed the inline cache on success
+                MemberInfo* info = findMemberInfo(name);
+                if (info && !(info->flags & Member_CacheChecked)) {
+                    if (api->isPropertyCacheable(sName))
+                        info->flags |= Member_Cacheable;
+                    info->flags |= Member_CacheChecked;
+                }
+                if (info && (info->flags & Member_Cacheable)) {
+                    // cacheable property: serve repeat reads from the retained value
+                    // as long as the API's cache generation hasn't moved; polling
+                    // scripts hit this path for nearly every read
+                    const unsigned int gen = api->getPropertyCacheGeneration();
+                    if ((info->flags & Member_HasCachedValue) && info->cacheGen == gen) {
+                        m_browser->getNPVariant(result, info->cachedValue);
+                        return true;
+                    }
+                    if (id != FB::InvalidMemberId)
+                        res = api->GetPropertyById(id);
+                    else
+                        res = api->GetProperty(sName);
+                    info->cachedValue = res;
+                    info->cacheGen = gen;
+                    info->flags |= Member_HasCachedValue;
+                } else if (id != FB::InvalidMemberId)
+                    res = api->GetPropertyById(id);
+                else
+                    res = api->GetProperty(sName);
             }
         } else {
-            res = getAPI()->GetProperty(m_browser->IntFromIdentifier(name));
+            res = api->GetProperty(m_browser->IntFromIdentifier(name));
         }
 
         m_browser->getNPVariant(result, res);
@@ -202,24 +321,30 @@ bool NPJavascriptObject::GetProperty(NPIdentifier name, NPVariant *result)
 bool NPJavascriptObject::SetProperty(NPIdentifier name, const NPVariant *value)
 {
     try {
+        // promote the weak reference once for the whole dispatch
+        FB::JSAPIPtr api(getAPI());
         FB::variant arg = m_browser->getVariant(value);
         if (m_browser->IdentifierIsString(name)) {
             std::string sName(m_browser->StringFromIdentifier(name));
-            if (getAPI()->HasEvent(sName)) {
+            if (api->HasEvent(sName)) {
                 if(value->type == NPVariantType_Null) {
                     FB::JSObjectPtr nullEvent;
-                    getAPI()->setDefaultEventMethod(sName, nullEvent);
+                    api->setDefaultEventMethod(sName, nullEvent);
                 } else if(value->type == NPVariantType_Object) {
                     FB::JSObjectPtr tmp(arg.cast<FB::JSObjectPtr>());
-                    getAPI()->setDefaultEventMethod(sName, tmp);
+                    api->setDefaultEventMethod(sName, tmp);
                 }
-            } else if (getAPI()->HasMethodObject(sName)) {
+            } else if (api->HasMethodObject(sName)) {
                 throw FB::script_error("This property cannot be changed");
             } else {
-                getAPI()->SetProperty(sName, arg);
+                FB::MemberId id = getMemberId(name, api);
+                if (id != FB::InvalidMemberId)
+                    api->SetPropertyById(id, arg);
+                else
+                    api->SetProperty(sName, arg);
             }
         } else {
-            getAPI()->SetProperty(m_browser->IntFromIdentifier(name), arg);
+            api->SetProperty(m_browser->IntFromIdentifier(name), arg);
         }
         return true;
     } catch (const std::bad_cast&) {
@@ -234,10 +359,12 @@ bool NPJavascriptObject::RemoveProperty(NPIdentifier name)
 {
     try {
         if (m_browser->IdentifierIsString(name)) {
+            // promote the weak reference once for the whole dispatch
+            FB::JSAPIPtr api(getAPI());
             std::string sName(m_browser->StringFromIdentifier(name));
-            if (getAPI()->HasEvent(sName)) {
+            if (api->HasEvent(sName)) {
                 FB::JSObjectPtr nullEvent;
-                getAPI()->setDefaultEventMethod(sName, nullEvent);
+                api->setDefaultEventMethod(sName, nullEvent);
             }
         }
         return false;
@@ -252,15 +379,14 @@ bool NPJavascriptObject::RemoveProperty(NPIdentifier name)
 bool NPJavascriptObject::Enumeration(NPIdentifier **value, uint32_t *count)
 {
     try {
-        typedef std::vector<std::string> StringArray;
-        StringArray memberList;
-        getAPI()->getMemberNames(memberList);
-        *count = memberList.size();
+        // Shared snapshot; repeat enumerations don't re-walk the member maps
+        FB::MemberNameListPtr memberList(getAPI()->getMemberNamesSnapshot());
+        *count = memberList->size();
         NPIdentifier *outList(NULL);
         outList = (NPIdentifier*)m_browser->MemAlloc((uint32_t)(sizeof(NPIdentifier) * *count));
-        
-        for (uint32_t i = 0; i < memberList.size(); i++) {
-            outList[i] = m_browser->GetStringIdentifier(memberList.at(i).c_str());
+
+        for (uint32_t i = 0; i < memberList->size(); i++) {
+            outList[i] = m_browser->GetStringIdentifier((*memberList)[i]);
         }
         *value = outList;
         return true;
@@ -35,8 +35,48 @@ namespace FB { namespace Npapi {
         NpapiBrowserHostPtr m_browser;
         bool m_valid;
 
+        // Caches what we know per NPIdentifier the browser has used on this object: the
+        // FB::MemberId for name-free dispatch, plus the HasMethod classification once it
+        // has come back positive (members are never unregistered, so a positive answer
+        // is stable).  NPAPI only calls into the object on the main thread, so no lock
+        // is needed
+        enum MemberFlags {
+            Member_KindKnown      = 0x01,
+            Member_Method         = 0x02,
+            Member_MethodObject   = 0x04,
+            Member_CacheChecked   = 0x08,   // isPropertyCacheable has been asked
+            Member_Cacheable      = 0x10,   // property was registered cacheable
+            Member_HasCachedValue = 0x20    // cachedValue holds a value from cacheGen
+        };
+        struct MemberInfo {
+            FB::MemberId id;
+            unsigned char flags;
+            // last value of a cacheable property; valid while cacheGen matches
+            // the API's property cache generation
+            FB::variant cachedValue;
+            unsigned int cacheGen;
+        };
+        typedef boost::unordered_map<NPIdentifier, MemberInfo> MemberIdCache;
+        mutable MemberIdCache m_memberIdCache;
+        // One-entry inline cache in front of the map: real call sites are
+        // monomorphic (a render loop invokes the same member thousands of
+        // times), so the steady-state lookup is one pointer compare.  Entry
+        // pointers are stable -- the unordered_map is node-based and entries
+        // are never erased -- and NPAPI only calls in on the main thread.
+        NPIdentifier m_lastIdent;
+        MemberInfo* m_lastInfo;
+        MemberInfo* findMemberInfo(NPIdentifier name);
+        // api is the dispatch entry's promoted reference, passed down so the
+        // slow path doesn't promote the weak_ptr a second time
+        FB::MemberId getMemberId(NPIdentifier name, const FB::JSAPIPtr& api);
+
     public:
         static NPJavascriptObject *NewObject(NpapiBrowserHostPtr host, FB::JSAPIWeakPtr api);
+        // Wrapper objects are small, identically sized, and churned in bursts
+        // during enumeration and GC, so they come off a per-class free list
+        // instead of the general heap
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
         void setAPI(FB::JSAPIWeakPtr api, NpapiBrowserHostPtr host);
         FB::JSAPIPtr getAPI() const;
         virtual ~NPJavascriptObject(void);
@@ -12,9 +12,13 @@ License:    Dual license model; choose one of two:
 Copyright 2009 Richard Bateman, Firebreath development team
 \**********************************************************/
 
+#include <new>
 #include <boost/lexical_cast.hpp>
 #include <boost/bind.hpp>
 #include <boost/scoped_array.hpp>
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/make_shared.hpp>
+#include "SmallArgArray.h"
 #include "NPObjectAPI.h"
 #include "NpapiBrowserHost.h"
 #include "NPJavascriptObject.h"
@@ -23,6 +27,14 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 using namespace FB::Npapi;
 
+boost::shared_ptr<NPObjectAPI> NPObjectAPI::create(NPObject *obj, const NpapiBrowserHostPtr& host)
+{
+    // allocate_shared puts the wrapper and its refcount in one block (the
+    // make_shared layout) but draws that block from a size-keyed free list,
+    // so enumeration and GC bursts recycle slots instead of hitting malloc
+    return boost::allocate_shared<NPObjectAPI>(boost::fast_pool_allocator<NPObjectAPI>(), obj, host);
+}
+
 NPObjectAPI::NPObjectAPI(NPObject *o, NpapiBrowserHostPtr h)
     : JSObject(h), browser(h), obj(o), is_JSAPI(false)
 {
@@ -107,7 +119,7 @@ bool NPObjectAPI::HasMethod(const std::string& methodName) const
         else 
             return false;
     }
-    return browser->HasMethod(obj, browser->GetStringIdentifier(methodName.c_str()));
+    return browser->HasMethod(obj, browser->GetStringIdentifier(methodName));
 }
 
 bool NPObjectAPI::HasProperty(const std::string& propertyName) const
@@ -123,7 +135,7 @@ bool NPObjectAPI::HasProperty(const std::string& propertyName) const
         else 
             return false;
     }
-    return browser->HasProperty(obj, browser->GetStringIdentifier(propertyName.c_str()));
+    return browser->HasProperty(obj, browser->GetStringIdentifier(propertyName));
 }
 
 bool NPObjectAPI::HasProperty(int idx) const
@@ -165,7 +177,7 @@ FB::variant NPObjectAPI::GetProperty(const std::string& propertyName)
             return false;
     }
     NPVariant retVal;
-    if (!browser->GetProperty(obj, browser->GetStringIdentifier(propertyName.c_str()), &retVal)) {
+    if (!browser->GetProperty(obj, browser->GetStringIdentifier(propertyName), &retVal)) {
         throw script_error(propertyName.c_str());
     } else {
         FB::variant ret = browser->getVariant(&retVal);
@@ -188,7 +200,7 @@ void NPObjectAPI::SetProperty(const std::string& propertyName, const FB::variant
     }
     NPVariant val;
     browser->getNPVariant(&val, value);
-    if (!browser->SetProperty(obj, browser->GetStringIdentifier(propertyName.c_str()), &val)) {
+    if (!browser->SetProperty(obj, browser->GetStringIdentifier(propertyName), &val)) {
         throw script_error(propertyName.c_str());
     }
 }
@@ -218,6 +230,10 @@ void NPObjectAPI::SetProperty(int idx, const FB::variant& value)
 // Methods to manage methods on the API
 FB::variant NPObjectAPI::Invoke(const std::string& methodName, const std::vector<FB::variant>& args)
 {
+    // "" means invoke default method; route it through the specialized path
+    if (methodName.empty()) {
+        return InvokeDefault(args);
+    }
     if (!host->isMainThread()) {
         return host->CallOnMainThread(boost::bind((FB::InvokeType)&NPObjectAPI::Invoke, this, methodName, args));
     }
@@ -225,24 +241,18 @@ FB::variant NPObjectAPI::Invoke(const std::string& methodName, const std::vector
         FB::JSAPIPtr tmp = inner.lock();
         if (tmp)
             return tmp->Invoke(methodName, args);
-        else 
+        else
             return false;
     }
     NPVariant retVal;
 
-    // Convert the arguments to NPVariants
-    boost::scoped_array<NPVariant> npargs(new NPVariant[args.size()]);
+    // Convert the arguments to NPVariants; small arities stay on the stack
+    FB::SmallArgArray<NPVariant, FB::DefaultArgArraySize> npargs(args.size());
     for (unsigned int i = 0; i < args.size(); i++) {
         browser->getNPVariant(&npargs[i], args[i]);
     }
 
-    bool res = false;
-    // Invoke the method ("" means invoke default method)
-    if (methodName.size() > 0) {
-        res = browser->Invoke(obj, browser->GetStringIdentifier(methodName.c_str()), npargs.get(), args.size(), &retVal);
-    } else {
-        res = browser->InvokeDefault(obj, npargs.get(), args.size(), &retVal);
-    }
+    bool res = browser->Invoke(obj, browser->GetStringIdentifier(methodName), npargs.get(), args.size(), &retVal);
 
     // Free the NPVariants that we earlier allocated
     for (unsigned int i = 0; i < args.size(); i++) {
@@ -258,6 +268,42 @@ FB::variant NPObjectAPI::Invoke(const std::string& methodName, const std::vector
     }
 }
 
+FB::variant NPObjectAPI::InvokeDefault(const std::vector<FB::variant>& args)
+{
+    if (!host->isMainThread()) {
+        return host->CallOnMainThread(boost::bind(&NPObjectAPI::InvokeDefault, this, args));
+    }
+    if (is_JSAPI) {
+        FB::JSAPIPtr tmp = inner.lock();
+        if (tmp)
+            return tmp->Invoke("", args);
+        else
+            return false;
+    }
+    // This is the per-frame path for progress and event callbacks, so small
+    // arities convert into a stack array instead of paying a heap allocation
+    // on every call; anything larger falls back to the heap
+    FB::SmallArgArray<NPVariant, FB::DefaultArgArraySize> npargs(args.size());
+    for (unsigned int i = 0; i < args.size(); i++) {
+        browser->getNPVariant(&npargs[i], args[i]);
+    }
+
+    NPVariant retVal;
+    bool res = browser->InvokeDefault(obj, npargs.get(), args.size(), &retVal);
+
+    for (unsigned int i = 0; i < args.size(); i++) {
+        browser->ReleaseVariantValue(&npargs[i]);
+    }
+
+    if (!res) { // If the call failed, throw an exception
+        throw script_error("");
+    } else {
+        FB::variant ret = browser->getVariant(&retVal);
+        browser->ReleaseVariantValue(&retVal);  // Always release the return value!
+        return ret;
+    }
+}
+
 //FB::JSObjectPtr NPObjectAPI::Construct( const std::string& memberName, const FB::VariantList& args )
 //{
 //    // NOTE: This doesn't work.  Sorry :-/
@@ -36,6 +36,12 @@ namespace FB { namespace Npapi {
         NPObjectAPI(NPObject *, NpapiBrowserHostPtr);
         virtual ~NPObjectAPI(void);
 
+        // Wrappers around browser NPObjects churn in the same bursts the
+        // NPJavascriptObject side does.  create() allocates the wrapper and
+        // its refcount as one block (like make_shared) but from a per-class
+        // free list, so bind/unbind storms never touch the general heap
+        static boost::shared_ptr<NPObjectAPI> create(NPObject *obj, const NpapiBrowserHostPtr& host);
+
         void *getEventId() const { return (void*)obj; }
         void *getEventContext() const { return browser->getContextID(); };
         NPObject *getNPObject() const { return obj; }
@@ -64,6 +70,7 @@ namespace FB { namespace Npapi {
         void SetProperty(int idx, const variant& value);
 
         variant Invoke(const std::string& methodName, const std::vector<variant>& args);
+        variant InvokeDefault(const std::vector<variant>& args);
 
         //FB::JSObjectPtr Construct(const std::string& memberName, const std::vector<variant>& args);
     };
@@ -21,6 +21,7 @@
 #include <string>
 #include <typeinfo>
 
+#include <boost/lexical_cast.hpp>
 #include <boost/type_traits/is_arithmetic.hpp>
 #include <boost/type_traits/is_integral.hpp>
 #include <boost/type_traits/is_same.hpp>
@@ -35,22 +36,14 @@
 #include "DOM/Document.h"
 #include "DOM/Window.h"
 #include "variant_list.h"
+#include "BinaryData.h"
 #include "NpapiBrowserHost.h"
 
 
 namespace FB { namespace Npapi
 {    
-    struct type_info_less
-    {
-        bool operator() (const std::type_info* const lhs, const std::type_info* const rhs) const
-        {
-            return lhs->before(*rhs) ? true : false;
-        }
-    };
-    
-    typedef NPVariant (*NPVariantBuilder)(const NpapiBrowserHostPtr&, const FB::variant&);    
-    typedef std::map<std::type_info const*, NPVariantBuilder, type_info_less> NPVariantBuilderMap;
-    
+    typedef NPVariant (*NPVariantBuilder)(const NpapiBrowserHostPtr&, const FB::variant&);
+
     template<class T> 
     NPVariant makeNPVariant(const NpapiBrowserHostPtr& host, const FB::variant& var)
     {
@@ -177,6 +170,45 @@ namespace FB { namespace Npapi
         return npv;
     }
     
+    template<> inline
+    NPVariant makeNPVariant<FB::BinaryData>(const NpapiBrowserHostPtr& host, const FB::variant& var)
+    {
+        NPVariant npv;
+        npv.type = NPVariantType_Null;
+
+        FB::BinaryData data = var.cast<FB::BinaryData>();
+        FB::DOM::WindowPtr window = host->getDOMWindow();
+
+        // a typed array is the efficient representation where the page has
+        // them; constructing one needs `new`, which NPAPI can't express, so it
+        // goes through eval.  Pages without typed arrays get a plain Array.
+        FB::JSObjectPtr out;
+        try {
+            std::string script = "new Uint8Array(" +
+                boost::lexical_cast<std::string>(data.size()) + ")";
+            out = window->getJSObject()->Invoke("eval",
+                FB::variant_list_of(script)).convert_cast<FB::JSObjectPtr>();
+        } catch (const std::exception&) {
+            out.reset();
+        }
+        if (!out)
+            out = window->createArray();
+
+        // indexed NPObject stores: no base64, no utf8 conversion, no size
+        // blowup -- just one put per byte
+        const unsigned char* bytes = data.data();
+        for (size_t i = 0; i < data.size(); ++i)
+            out->SetProperty(static_cast<int>(i), static_cast<int>(bytes[i]));
+
+        if (NPObjectAPIPtr api = FB::ptr_cast<NPObjectAPI>(out)) {
+            npv.type = NPVariantType_Object;
+            npv.value.objectValue = api->getNPObject();
+            host->RetainObject(npv.value.objectValue);
+        }
+
+        return npv;
+    }
+
 //    template<> inline
 //    NPVariant makeNPVariant<FB::FBDateString>(const NpapiBrowserHostPtr& host, const FB::variant& var)
 //    {
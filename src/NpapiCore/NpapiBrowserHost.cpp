@@ -13,6 +13,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 \**********************************************************/
 
 #include <memory>
+#include <map>
 #include <boost/config.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -27,69 +28,41 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 #include "NpapiStream.h"
 #include "NpapiBrowserHost.h"
+#include "StringIntern.h"
+#include "ConversionStats.h"
 
 #include "NPVariantUtil.h"
 
 using namespace FB::Npapi;
 
-namespace 
+namespace
 {
     struct MethodCallReq
     {
         //FB::variant
     };
-    
-    template<class T>
-    NPVariantBuilderMap::value_type makeBuilderEntry()
-    {
-        return NPVariantBuilderMap::value_type(&typeid(T), select_npvariant_builder::select<T>());
-    }
-    
-    NPVariantBuilderMap makeNPVariantBuilderMap()
+
+    // Process-wide cache of immutable browser facts, keyed by the
+    // NPNetscapeFuncs table the browser handed us -- one table per browser,
+    // shared by every instance it hosts.  Like the identifier cache this is
+    // only touched on the main thread, so no lock is needed
+    struct BrowserCaps
     {
-        NPVariantBuilderMap tdm;
-        tdm.insert(makeBuilderEntry<bool>());
-        tdm.insert(makeBuilderEntry<char>());
-        tdm.insert(makeBuilderEntry<unsigned char>());
-        tdm.insert(makeBuilderEntry<short>());
-        tdm.insert(makeBuilderEntry<unsigned short>());
-        tdm.insert(makeBuilderEntry<int>());
-        tdm.insert(makeBuilderEntry<unsigned int>());
-        tdm.insert(makeBuilderEntry<long>());
-        tdm.insert(makeBuilderEntry<unsigned long>());
-        
-#ifndef BOOST_NO_LONG_LONG
-        tdm.insert(makeBuilderEntry<long long>());
-        tdm.insert(makeBuilderEntry<unsigned long long>());
-#endif
-        
-        tdm.insert(makeBuilderEntry<float>());
-        tdm.insert(makeBuilderEntry<double>());
-        
-        tdm.insert(makeBuilderEntry<std::string>());
-        tdm.insert(makeBuilderEntry<std::wstring>());
-        
-        tdm.insert(makeBuilderEntry<FB::FBNull>());
-        tdm.insert(makeBuilderEntry<FB::FBVoid>());
-        //tdm.insert(makeBuilderEntry<FB::FBDateString>());
-        tdm.insert(makeBuilderEntry<FB::VariantList>());
-        tdm.insert(makeBuilderEntry<FB::VariantMap>());
-        tdm.insert(makeBuilderEntry<FB::JSAPIPtr>());
-        tdm.insert(makeBuilderEntry<FB::JSAPIWeakPtr>());
-        tdm.insert(makeBuilderEntry<FB::JSObjectPtr>());
-        
-        return tdm;
-    }
-    
-    const NPVariantBuilderMap& getNPVariantBuilderMap()
+        BrowserCaps() : userAgentKnown(false) {}
+        bool userAgentKnown;
+        std::string userAgent;
+        std::map<int, int> values;
+    };
+    typedef std::map<const void*, BrowserCaps> BrowserCapsMap;
+    BrowserCapsMap& getBrowserCaps()
     {
-        static const NPVariantBuilderMap tdm = makeNPVariantBuilderMap();
-        return tdm;
+        static BrowserCapsMap caps;
+        return caps;
     }
 }
 
 NpapiBrowserHost::NpapiBrowserHost(NpapiPluginModule *module, NPP npp)
-    : module(module), m_npp(npp)
+    : module(module), m_npp(npp), m_capsKey(NULL)
 {
     assert(module != NULL);
     // Initialize NPNFuncs to NULL values
@@ -111,6 +84,7 @@ bool NpapiBrowserHost::_scheduleAsyncCall(void (*func)(void *), void *userData)
 void NpapiBrowserHost::setBrowserFuncs(NPNetscapeFuncs *pFuncs)
 {
     copyNPBrowserFuncs(&NPNFuncs, pFuncs, m_npp);
+    m_capsKey = pFuncs;
 
     NPObject *window(NULL);
     NPObject *element(NULL);
@@ -118,8 +92,8 @@ void NpapiBrowserHost::setBrowserFuncs(NPNetscapeFuncs *pFuncs)
         GetValue(NPNVWindowNPObject, (void**)&window);
         GetValue(NPNVPluginElementNPObject, (void**)&element);
 
-        m_htmlWin = NPObjectAPIPtr(new FB::Npapi::NPObjectAPI(window, ptr_cast<NpapiBrowserHost>(shared_ptr())));
-        m_htmlElement = NPObjectAPIPtr(new FB::Npapi::NPObjectAPI(element, ptr_cast<NpapiBrowserHost>(shared_ptr())));
+        m_htmlWin = NPObjectAPI::create(window, ptr_cast<NpapiBrowserHost>(shared_ptr()));
+        m_htmlElement = NPObjectAPI::create(element, ptr_cast<NpapiBrowserHost>(shared_ptr()));
     } catch (...) {
         if (window)
             ReleaseObject(window);
@@ -177,63 +151,146 @@ void NpapiBrowserHost::evaluateJavaScript(const std::string &script)
     }
 }
 
+FB::variant NpapiBrowserHost::evaluateJavaScriptWithResult(const std::string &script)
+{
+    assertMainThread();
+    NPVariant retVal;
+    NPVariant tmp;
+
+    this->getNPVariant(&tmp, FB::variant(script));
+
+    if (!m_htmlWin)
+        throw std::runtime_error("Cannot find HTML window");
+
+    if (this->Evaluate(m_htmlWin->getNPObject(),
+                       &tmp.value.stringValue, &retVal)) {
+        // Unlike evaluateJavaScript this keeps the returned variant; the async
+        // evaluate path hands it to the completion callback
+        FB::variant result;
+        getVariant(&retVal, result);
+        this->ReleaseVariantValue(&retVal);
+        return result;
+    } else {
+        throw script_error("Error executing JavaScript code");
+    }
+}
+
 FB::variant NpapiBrowserHost::getVariant(const NPVariant *npVar)
 {
     FB::variant retVal;
+    getVariant(npVar, retVal);
+    return retVal;
+}
+
+void NpapiBrowserHost::getVariant(const NPVariant *npVar, FB::variant& dst)
+{
     switch(npVar->type) {
         case NPVariantType_Null:
-            retVal = FB::variant_detail::null();
+            dst = FB::variant_detail::null();
             break;
 
         case NPVariantType_Bool:
-            retVal = npVar->value.boolValue;
+            dst = npVar->value.boolValue;
             break;
 
         case NPVariantType_Int32:
-            retVal = npVar->value.intValue;
+            dst = npVar->value.intValue;
             break;
 
         case NPVariantType_Double:
-            retVal = npVar->value.doubleValue;
+            dst = npVar->value.doubleValue;
             break;
 
         case NPVariantType_String:
-            retVal = std::string(npVar->value.stringValue.UTF8Characters, npVar->value.stringValue.UTF8Length);
+            // copies the browser-owned buffer exactly once, straight into the variant
+            dst.assign(npVar->value.stringValue.UTF8Characters, npVar->value.stringValue.UTF8Length);
             break;
 
         case NPVariantType_Object:
-            retVal = JSObjectPtr(new NPObjectAPI(npVar->value.objectValue, ptr_cast<NpapiBrowserHost>(shared_ptr())));
+            // Hot path: every object crossing from the browser lands here; create()
+            // keeps the refcount on the same cache line as the wrapper and recycles
+            // the block through the wrapper free list
+            dst = FB::JSObjectPtr(NPObjectAPI::create(npVar->value.objectValue, ptr_cast<NpapiBrowserHost>(shared_ptr())));
             break;
 
         case NPVariantType_Void:
         default:
-            // Do nothing; it's already void =]
+            dst = FB::variant();
             break;
     }
+    FB::ConversionStats::getInstance().recordConversion(
+        FB::ConversionStats::Direction_FromBrowser, dst);
+}
 
-    return retVal;
+void NpapiBrowserHost::getVariantList(FB::VariantList& dst, const NPVariant *npVars, uint32_t count)
+{
+    dst.clear();
+    dst.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        dst.push_back(FB::variant());
+        getVariant(&npVars[i], dst.back());
+    }
 }
 
 bool NpapiBrowserHost::isSafari() const
 {
-    std::string agent(UserAgent());
-    return boost::algorithm::contains(agent, "Safari");
+    return boost::algorithm::contains(UserAgentCached(), "Safari");
 }
 
 void NpapiBrowserHost::getNPVariant(NPVariant *dst, const FB::variant &var)
 {
     assertMainThread();
-    
-    const NPVariantBuilderMap& builderMap = getNPVariantBuilderMap();
-    const std::type_info& type = var.get_type();
-    NPVariantBuilderMap::const_iterator it = builderMap.find(&type);
-    
-    if (it == builderMap.end()) {
-        // unhandled type :(
-        return;
+    NpapiBrowserHostPtr self(FB::ptr_cast<NpapiBrowserHost>(shared_ptr()));
+    FB::ConversionStats::getInstance().recordConversion(
+        FB::ConversionStats::Direction_ToBrowser, var);
+
+    // The tag switch replaces the old type_info-keyed builder map; each case picks
+    // the same builder the map held for that type, but the selection now resolves
+    // at compile time and the dispatch is one predictable jump
+    using namespace FB::variant_detail;
+    using select_npvariant_builder::select;
+    switch (var.get_tag()) {
+        case tag_empty:     *dst = makeNPVariant<FB::FBVoid>(self, var);        return;
+        case tag_null:      *dst = makeNPVariant<FB::FBNull>(self, var);        return;
+        case tag_bool:      *dst = makeNPVariant<bool>(self, var);              return;
+        case tag_char:      *dst = select<char>()(self, var);                   return;
+        case tag_uchar:     *dst = select<unsigned char>()(self, var);          return;
+        case tag_short:     *dst = select<short>()(self, var);                  return;
+        case tag_ushort:    *dst = select<unsigned short>()(self, var);         return;
+        case tag_int:       *dst = select<int>()(self, var);                    return;
+        case tag_uint:      *dst = select<unsigned int>()(self, var);           return;
+        case tag_long:      *dst = select<long>()(self, var);                   return;
+        case tag_ulong:     *dst = select<unsigned long>()(self, var);          return;
+#ifndef BOOST_NO_LONG_LONG
+        case tag_longlong:  *dst = select<long long>()(self, var);              return;
+        case tag_ulonglong: *dst = select<unsigned long long>()(self, var);     return;
+#endif
+        case tag_float:     *dst = select<float>()(self, var);                  return;
+        case tag_double:    *dst = makeNPVariant<double>(self, var);            return;
+        case tag_string:    *dst = makeNPVariant<std::string>(self, var);       return;
+        case tag_wstring:   *dst = makeNPVariant<std::wstring>(self, var);      return;
+        case tag_generic:
+        default:
+            break;
     }
-    
-    *dst = (it->second)(FB::ptr_cast<NpapiBrowserHost>(shared_ptr()), var);
+
+    // Object and container types are not tagged; a short chain of type checks
+    // covers what is left
+    const std::type_info& type = var.get_type();
+    if (type == typeid(FB::JSObjectPtr)) {
+        *dst = makeNPVariant<FB::JSObjectPtr>(self, var);
+    } else if (type == typeid(FB::JSAPIPtr)) {
+        *dst = makeNPVariant<FB::JSAPIPtr>(self, var);
+    } else if (type == typeid(FB::JSAPIWeakPtr)) {
+        *dst = makeNPVariant<FB::JSAPIWeakPtr>(self, var);
+    } else if (type == typeid(FB::VariantList)) {
+        *dst = makeNPVariant<FB::VariantList>(self, var);
+    } else if (type == typeid(FB::VariantMap)) {
+        *dst = makeNPVariant<FB::VariantMap>(self, var);
+    } else if (type == typeid(FB::BinaryData)) {
+        *dst = makeNPVariant<FB::BinaryData>(self, var);
+    }
+    // unhandled types leave *dst untouched, as the map miss path did
 }
 
 NPError NpapiBrowserHost::GetURLNotify(const char* url, const char* target, void* notifyData) const
@@ -358,6 +415,19 @@ NPIdentifier NpapiBrowserHost::GetStringIdentifier(const NPUTF8 *name) const
     assertMainThread();
     return module->GetStringIdentifier(name);
 }
+NPIdentifier NpapiBrowserHost::GetStringIdentifier(const std::string& name) const
+{
+    assertMainThread();
+    IdentifierCache::const_iterator fnd = m_identifierCache.find(name);
+    if (fnd != m_identifierCache.end())
+        return fnd->second;
+    NPIdentifier id = module->GetStringIdentifier(name.c_str());
+    m_identifierCache[name] = id;
+    // remember the reverse mapping too, so a name we interned on the way in
+    // never needs a browser round trip on the way back out
+    m_identifierNameCache[id] = &FB::internString(name);
+    return id;
+}
 void NpapiBrowserHost::GetStringIdentifiers(const NPUTF8 **names, int32_t nameCount, NPIdentifier *identifiers) const
 {
     assertMainThread();
@@ -381,7 +451,15 @@ NPUTF8 *NpapiBrowserHost::UTF8FromIdentifier(NPIdentifier identifier) const
 std::string NpapiBrowserHost::StringFromIdentifier(NPIdentifier identifier) const
 {
     assertMainThread();
-    return module->StringFromIdentifier(identifier);
+    // Identifiers are stable for the life of the page; after the first
+    // conversion the name comes from the process-wide intern table instead of
+    // a browser allocation
+    IdentifierNameCache::const_iterator fnd = m_identifierNameCache.find(identifier);
+    if (fnd != m_identifierNameCache.end())
+        return *fnd->second;
+    const std::string& interned(FB::internString(module->StringFromIdentifier(identifier)));
+    m_identifierNameCache[identifier] = &interned;
+    return interned;
 }
 int32_t NpapiBrowserHost::IntFromIdentifier(NPIdentifier identifier) const
 {
@@ -418,6 +496,36 @@ NPError NpapiBrowserHost::GetValue(NPNVariable variable, void *value) const
     }
 }
 
+const std::string& NpapiBrowserHost::UserAgentCached() const
+{
+    assertMainThread();
+    BrowserCaps& caps = getBrowserCaps()[m_capsKey];
+    if (!caps.userAgentKnown) {
+        const char* agent = UserAgent();
+        caps.userAgent = agent ? agent : "";
+        caps.userAgentKnown = true;
+    }
+    return caps.userAgent;
+}
+
+NPError NpapiBrowserHost::GetValueCached(NPNVariable variable, int *value) const
+{
+    assertMainThread();
+    BrowserCaps& caps = getBrowserCaps()[m_capsKey];
+    std::map<int, int>::const_iterator it = caps.values.find(static_cast<int>(variable));
+    if (it != caps.values.end()) {
+        *value = it->second;
+        return NPERR_NO_ERROR;
+    }
+    int result(0);
+    NPError err = GetValue(variable, static_cast<void*>(&result));
+    if (err == NPERR_NO_ERROR) {
+        caps.values[static_cast<int>(variable)] = result;
+    }
+    *value = result;
+    return err;
+}
+
 NPError NpapiBrowserHost::SetValue(NPPVariable variable, void *value) const
 {
     assertMainThread();
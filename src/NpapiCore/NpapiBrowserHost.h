@@ -19,6 +19,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include "NpapiTypes.h"
 #include "BrowserHost.h"
 #include <boost/thread.hpp>
+#include <boost/unordered_map.hpp>
 
 namespace FB { namespace Npapi {
 
@@ -56,8 +57,21 @@ namespace FB { namespace Npapi {
         void evaluateJavaScript(const std::string &script);
         bool isSafari() const;
 
+    protected:
+        // Async evaluate path; NPN_Evaluate does return a value, so unlike the
+        // base default this hands the real result back
+        FB::variant evaluateJavaScriptWithResult(const std::string &script);
+
+    public:
+
     public:
         FB::variant getVariant(const NPVariant *npVar);
+        // In-place form; converts into dst, avoiding the extra payload copy the
+        // by-value form pays when the result is pushed into a list
+        void getVariant(const NPVariant *npVar, FB::variant& dst);
+        // Bulk form for the browser-to-plugin call path: pre-sizes dst and converts
+        // the whole argument array in one pass, each element straight into its slot
+        void getVariantList(FB::VariantList& dst, const NPVariant *npVars, uint32_t count);
         void getNPVariant(NPVariant *dst, const FB::variant &var);
 
     // NPN_ functions -- for scope reasons, we no longer access these using the global functions
@@ -68,6 +82,17 @@ namespace FB { namespace Npapi {
         NPObjectAPIPtr m_htmlDoc;
         NPObjectAPIPtr m_htmlWin;
         NPObjectAPIPtr m_htmlElement;
+        // string -> NPIdentifier intern cache shared by all NPObjectAPI instances on
+        // this host; only touched on the main thread so no lock is needed
+        typedef boost::unordered_map<std::string, NPIdentifier> IdentifierCache;
+        mutable IdentifierCache m_identifierCache;
+        // Reverse direction: NPIdentifier -> canonical name in the process-wide
+        // intern table (see StringIntern.h); same main-thread-only discipline
+        typedef boost::unordered_map<NPIdentifier, const std::string*> IdentifierNameCache;
+        mutable IdentifierNameCache m_identifierNameCache;
+        // Identity of the browser function table we were handed; keys the
+        // process-wide capability cache shared by all hosts on that table
+        const void* m_capsKey;
 
     public:
         void* MemAlloc(uint32_t size) const;
@@ -79,6 +104,9 @@ namespace FB { namespace Npapi {
         void ReleaseVariantValue(NPVariant *variant) const;
 
         NPIdentifier GetStringIdentifier(const NPUTF8 *name) const;
+        // Caching overload; identifiers are stable for the life of the page, so each
+        // name is only interned with the browser once per host.  Main thread only
+        NPIdentifier GetStringIdentifier(const std::string& name) const;
         void GetStringIdentifiers(const NPUTF8 **names, int32_t nameCount, NPIdentifier *identifiers) const;
         NPIdentifier GetIntIdentifier(int32_t intid) const;
         bool IdentifierIsString(NPIdentifier identifier) const;
@@ -98,6 +126,12 @@ namespace FB { namespace Npapi {
         void SetStatus(const char* message) const;
         const char* UserAgent() const;
         NPError GetValue(NPNVariable variable, void *value) const;
+        // Cached forms for immutable browser facts (user agent string, boolean
+        // capability probes).  Results are shared process-wide by every host
+        // created against the same NPNetscapeFuncs table, so only the first
+        // instance on a page pays for each round trip.  Main thread only
+        const std::string& UserAgentCached() const;
+        NPError GetValueCached(NPNVariable variable, int *value) const;
         NPError SetValue(NPPVariable variable, void *value) const;
         void InvalidateRect(NPRect *invalidRect) const;
         void InvalidateRegion(NPRegion invalidRegion) const;
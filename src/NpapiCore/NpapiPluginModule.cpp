@@ -18,13 +18,21 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include <cassert>
 #include <boost/thread.hpp>
 #include "logging.h"
+#include "StartupTimeline.h"
+#include "PluginInfo.h"
 
 using namespace FB::Npapi;
 
 NpapiPluginModule::NpapiPluginModule(void) : m_threadId(boost::this_thread::get_id())
 {
     FB::Log::initLogging();
+    FB::StartupTimeline::getInstance().mark("moduleLoaded");
     getFactoryInstance()->globalPluginInitialize();
+    // parse the MIME table now so metadata queries and instance creation
+    // never pay for it; browsers with aggressive plugin scanning hit the
+    // metadata paths often
+    FB::preparePluginMetadata();
+    FB::StartupTimeline::getInstance().mark("factoryInitialized");
     memset(&NPNFuncs, 0, sizeof(NPNetscapeFuncs));
 }
 
@@ -18,6 +18,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include "FactoryBase.h"
 #include "NpapiBrowserHost.h"
 #include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 #include "AsyncFunctionCall.h"
 #include "SafeQueue.h"
 #include "PluginInfo.h"
@@ -112,12 +113,32 @@ namespace
     
     void asyncCallbackFunction(void* npp, uint32_t timerID)
     {
-        boost::shared_ptr<FB::AsyncFunctionCall> evt;
+        // Drain a bounded batch per callback rather than the whole queue.  The
+        // dispatch sinks are FIFO across every instance on the page, so a full
+        // drain lets one flooding instance hold the main thread while its
+        // siblings' callbacks wait behind it; a bounded batch plus a re-push at
+        // the tail rotates the turns round-robin across instances
+        const size_t maxPerPass = 64;
         NpapiPDataHolder *holder = getHolder(static_cast<NPP>(npp));
-        while (holder->asyncFunctionQueue.try_pop(evt)) {
-            evt->func(evt->userData);
+        FB::AsyncFunctionCallPtr call;
+        for (size_t i = 0; i < maxPerPass && holder->asyncFunctionQueue.try_pop(call); ++i) {
+            call->func(call->userData);
         }
-    }    
+#ifdef FB_MACOSX
+        if (!holder->asyncFunctionQueue.empty()) {
+            OneShotManager::getInstance().push(npp, &asyncCallbackFunction);
+        }
+#else
+        // No re-dispatch hook on this platform; finish whatever is left
+        std::queue<FB::AsyncFunctionCallPtr> calls;
+        if (holder->asyncFunctionQueue.try_pop_all(calls)) {
+            while (!calls.empty()) {
+                calls.front()->func(calls.front()->userData);
+                calls.pop();
+            }
+        }
+#endif
+    }
 }
 
 NpapiPluginPtr FB::Npapi::getPlugin(NPP instance)
@@ -129,7 +150,7 @@ NpapiPluginPtr FB::Npapi::getPlugin(NPP instance)
 // This is used on mac snow leopard safari
 void NpapiPluginModule::scheduleAsyncCallback(NPP npp, void (*func)(void *), void *userData)
 {
-    getHolder(npp)->asyncFunctionQueue.push(FB::AsyncFunctionCallPtr(new FB::AsyncFunctionCall(func, userData)));
+    getHolder(npp)->asyncFunctionQueue.push(boost::make_shared<FB::AsyncFunctionCall>(func, userData));
     //getHost(npp)->ScheduleTimer(0, false, &asyncCallbackFunction);
 #ifdef FB_MACOSX
     OneShotManager::getInstance().push(npp, &asyncCallbackFunction);
@@ -30,17 +30,17 @@ NpapiStream::~NpapiStream()
     close();
 }
 
-bool NpapiStream::readRanges( const std::vector<Range>& ranges )
+bool NpapiStream::doReadRanges( const std::vector<Range>& ranges )
 {
     if ( !getStream() || !isSeekable() || !isOpen() ) return false;
     if ( !ranges.size() ) return true;
-    
+
     std::vector<NPByteRange> vecranges( ranges.size() );
     for ( size_t i = 0; i < ranges.size(); i++ )
     {
         NPByteRange& range = vecranges[i];
-        range.offset = ranges[0].start;
-        range.length = ranges[0].end - ranges[0].start;
+        range.offset = ranges[i].start;
+        range.length = ranges[i].end - ranges[i].start;
         range.next = ( ( i + 1 ) < ranges.size() ) ? &vecranges[i+1] : 0;
     }
 
@@ -70,20 +70,23 @@ bool NpapiStream::close()
 
 int32_t NpapiStream::signalDataArrived(void* buffer, int32_t len, int32_t offset)
 {
-    size_t effectiveLen = std::min( getInternalBufferSize(), static_cast<size_t>(len) );
-    if ( effectiveLen ) 
+    // The chunk is dispatched synchronously straight out of the browser's buffer, so there is
+    // nothing to cap it to; consuming it whole avoids a redelivery round-trip for the tail.
+    // The internal buffer size still bounds chunks via NPP_WriteReady
+    size_t effectiveLen = static_cast<size_t>(len);
+    if ( effectiveLen )
     {
-        //memcpy( &internalBuffer[0], buffer, effectiveLen );
-        
         float progress = 0;
         if ( getLength() )
         {
             progress = float( offset + len ) / float( getLength() ) * 100.f;
         }
-        if ( isOpen() ) 
+        if ( isOpen() )
         {
+            cacheArrivedData( buffer, effectiveLen, offset );
             StreamDataArrivedEvent ev(this, buffer, effectiveLen, offset, progress);
             SendEvent( &ev );
+            reportProgress( offset + len );
         }
     }
     return effectiveLen;
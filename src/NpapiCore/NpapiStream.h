@@ -32,7 +32,7 @@ namespace FB { namespace Npapi {
         virtual ~NpapiStream();
         
         //virtual bool is_open();
-        virtual bool    readRanges( const std::vector<Range>& ranges );
+        virtual bool    doReadRanges( const std::vector<Range>& ranges );
         virtual bool    write(const char* data, size_t dataLength, size_t& written);
         virtual bool    close();
         virtual void    setCreated();
@@ -33,6 +33,5 @@ NpapiBrowserHostAsyncWin::~NpapiBrowserHostAsyncWin()
 
 bool NpapiBrowserHostAsyncWin::_scheduleAsyncCall(void (*func)(void*), void* userData) const
 {
-    return ::PostMessage(m_messageWin->getHWND(), WM_ASYNCTHREADINVOKE, NULL, 
-                  (LPARAM)new FB::AsyncFunctionCall(func, userData)) ? true : false;
+    return m_messageWin->scheduleAsyncCall(func, userData);
 }
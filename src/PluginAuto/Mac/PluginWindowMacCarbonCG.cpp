@@ -135,8 +135,7 @@ int16_t PluginWindowMacCarbonCG::HandleEvent(EventRecord* evt) {
                         this->m_old_x = px;
                         this->m_old_y = py;
                         // Mouse event happened inside the plugin's window
-                        MouseMoveEvent mmEvt(px, py);
-                        if(SendEvent(&mmEvt)) {
+                        if(SendMouseMoveEvent(px, py)) {
                             // Event was handled
                             CFRelease(nullEvent);
                             return true;
@@ -84,8 +84,7 @@ int16_t PluginWindowMacCocoa::HandleEvent(NPCocoaEvent* evt) {
             double x = evt->data.mouse.pluginX;
             double y = evt->data.mouse.pluginY;
             y = m_height - y; // Reposition origin to bottom left
-            MouseMoveEvent ev(x, y);
-            return SendEvent(&ev);
+            return SendMouseMoveEvent(x, y);
             break;
         }
 
@@ -31,7 +31,11 @@ int16_t PluginWindowMacCocoa::HandleEvent(NPCocoaEvent* evt) {
     // Otherwise process the event into FB platform agnostic events
     switch(evt->type) {
         case NPCocoaEventDrawRect: {
-            RefreshEvent ev;
+            // the draw event names the damaged rect; pass it through so
+            // handlers can clip to it instead of repainting everything
+            FB::Rect r((int)evt->data.draw.x, (int)evt->data.draw.y,
+                       (int)(evt->data.draw.width + 0.5), (int)(evt->data.draw.height + 0.5));
+            RefreshEvent ev(r);
             return SendEvent(&ev);
             break;
         }
@@ -21,6 +21,7 @@ Copyright 2010 Anson MacKeracher, Firebreath development team
 #include "PluginEvents/MacEventCocoa.h"
 #include "NpapiTypes.h"
 #include <map>
+#include <boost/function.hpp>
 
 namespace FB {
     class PluginWindowMacCocoaCA: public PluginWindowMacCocoa
@@ -35,6 +36,50 @@ namespace FB {
         void setLayer(void* layer);
         void* getLayer() const;
 
+        /// draw callback for asynchronous rendering; receives a CGContextRef
+        /// (passed as void* to keep CoreGraphics out of cross-platform code)
+        /// and the frame's pixel size
+        typedef boost::function<void (void* ctx, int width, int height)> AsyncDrawFn;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindowMacCocoaCA::setAsyncRenderCallback(const AsyncDrawFn& cb)
+        ///
+        /// @brief  Switches the layer to asynchronous rendering
+        ///
+        /// Frames requested with renderAsync() run cb on a background queue against a
+        /// triple-buffered bitmap pool; the main thread only swaps the finished frame into the
+        /// layer inside a transaction, so heavy draws no longer stall browser scrolling.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setAsyncRenderCallback(const AsyncDrawFn& cb);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindowMacCocoaCA::renderAsync()
+        ///
+        /// @brief  Schedules one frame through the async pipeline; bursts coalesce to a single
+        ///         queued frame (the latest request wins).  Falls back to InvalidateWindow()
+        ///         when no async callback is set.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void renderAsync();
+
+        /// CoreAnimation layers composite an IOSurface directly
+        /// @since 1.5
+        virtual AcceleratedSurfaceType getAcceleratedSurfaceType() const
+            { return AcceleratedSurface_IOSurface; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool PluginWindowMacCocoaCA::presentAcceleratedSurface(void* surface, int w, int h)
+        ///
+        /// @brief  Swaps an IOSurfaceRef into the layer's contents; the pixels never leave the GPU
+        ///
+        /// The swap happens on the main queue inside a transaction, like renderAsync()'s frame
+        /// flip; the surface is retained until the layer is done with it, so the renderer only
+        /// needs to double-buffer.  Callable from the GL thread.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool presentAcceleratedSurface(void* surface, int w, int h);
+
     private:
         struct Impl;
         std::auto_ptr<Impl> m_impl;
@@ -20,6 +20,11 @@ Copyright 2010 Georg Fritzsche, Firebreath development team
 #include "ConstructDefaultPluginWindows.h"
 
 #import <QuartzCore/CALayer.h>
+#include <IOSurface/IOSurface.h>
+#include <dispatch/dispatch.h>
+#include <libkern/OSAtomic.h>
+#include <cstdlib>
+#include <cstring>
 
 using namespace FB;
 
@@ -31,7 +36,63 @@ FB::PluginWindowMacCocoaCA* FB::createPluginWindowCocoaCA()
 struct FB::PluginWindowMacCocoaCA::Impl
 {
     CALayer *layer;
-    Impl(CALayer *layer) : layer(layer) {}
+
+    // asynchronous rendering: draws run serially on drawQueue into a small
+    // round-robin bitmap pool; the compositor may still read the frame most
+    // recently swapped into the layer, so three buffers keep the draw thread
+    // off pixels that are in flight
+    dispatch_queue_t drawQueue;
+    AsyncDrawFn drawFn;
+    struct Buffer {
+        void* data;
+        CGContextRef ctx;
+        int width, height;
+    };
+    Buffer buffers[3];
+    int nextBuffer;
+    volatile int32_t frameQueued;
+
+    Impl(CALayer *layer)
+      : layer(layer), drawQueue(NULL), nextBuffer(0), frameQueued(0)
+    {
+        std::memset(buffers, 0, sizeof(buffers));
+    }
+
+    // only call on drawQueue (or with it drained)
+    Buffer& prepareBuffer(int w, int h) {
+        Buffer& b = buffers[nextBuffer];
+        nextBuffer = (nextBuffer + 1) % 3;
+        if (!b.ctx || b.width != w || b.height != h) {
+            releaseBuffer(b);
+            b.width = w;
+            b.height = h;
+            b.data = std::calloc(h, static_cast<size_t>(w) * 4);
+            CGColorSpaceRef cs = CGColorSpaceCreateDeviceRGB();
+            b.ctx = CGBitmapContextCreate(b.data, w, h, 8, static_cast<size_t>(w) * 4,
+                cs, kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Host);
+            CGColorSpaceRelease(cs);
+        }
+        return b;
+    }
+
+    void releaseBuffer(Buffer& b) {
+        if (b.ctx) {
+            CGContextRelease(b.ctx);
+            b.ctx = NULL;
+        }
+        std::free(b.data);
+        b.data = NULL;
+    }
+
+    ~Impl() {
+        if (drawQueue) {
+            // drain any in-flight draw before the buffers go away
+            dispatch_sync(drawQueue, ^{});
+            dispatch_release(drawQueue);
+        }
+        for (int i = 0; i < 3; ++i)
+            releaseBuffer(buffers[i]);
+    }
 };
 
 PluginWindowMacCocoaCA::PluginWindowMacCocoaCA()
@@ -64,3 +125,65 @@ void PluginWindowMacCocoaCA::InvalidateWindow() {
     // Force a drawInContext message to be passed to the window's CALayer
     [m_impl->layer setNeedsDisplay];
 }
+
+void PluginWindowMacCocoaCA::setAsyncRenderCallback(const AsyncDrawFn& cb) {
+    if (!m_impl->drawQueue)
+        m_impl->drawQueue = dispatch_queue_create("org.firebreath.calayer.render", NULL);
+    m_impl->drawFn = cb;
+}
+
+bool PluginWindowMacCocoaCA::presentAcceleratedSurface(void* surface, int, int) {
+    Impl* impl = m_impl.get();
+    if (!impl->layer || !surface)
+        return false;
+    IOSurfaceRef ioSurface = static_cast<IOSurfaceRef>(surface);
+    // retained across the hop to the main queue; the layer retains it again
+    // while compositing, so the renderer may reuse its other buffer at once
+    CFRetain(ioSurface);
+    CALayer* layer = [impl->layer retain];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        // same shape as renderAsync()'s frame flip: the main thread only
+        // swaps contents, no drawing and no pixel copy anywhere
+        [CATransaction begin];
+        [CATransaction setDisableActions:YES];
+        layer.contents = (id)ioSurface;
+        [CATransaction commit];
+        CFRelease(ioSurface);
+        [layer release];
+    });
+    return true;
+}
+
+void PluginWindowMacCocoaCA::renderAsync() {
+    Impl* impl = m_impl.get();
+    if (impl->drawFn.empty() || !impl->layer) {
+        InvalidateWindow();
+        return;
+    }
+    // coalesce: a queued-but-unstarted frame draws the latest state anyway,
+    // so bursts of requests cost one frame
+    if (!OSAtomicCompareAndSwap32(0, 1, &impl->frameQueued))
+        return;
+
+    const int w = m_width > 0 ? m_width : 1;
+    const int h = m_height > 0 ? m_height : 1;
+    dispatch_async(impl->drawQueue, ^{
+        // from here on a new request schedules the next frame
+        impl->frameQueued = 0;
+        Impl::Buffer& buf = impl->prepareBuffer(w, h);
+        impl->drawFn(buf.ctx, w, h);
+        // copy-on-write snapshot of the buffer; the draw thread moves on to
+        // the next pool entry while the compositor reads this one
+        CGImageRef image = CGBitmapContextCreateImage(buf.ctx);
+        CALayer* layer = [impl->layer retain];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // the main thread only swaps contents; no drawing happens here
+            [CATransaction begin];
+            [CATransaction setDisableActions:YES];
+            layer.contents = (id)image;
+            [CATransaction commit];
+            CGImageRelease(image);
+            [layer release];
+        });
+    });
+}
@@ -16,9 +16,10 @@ Copyright 2010 Anson MacKeracher, Firebreath development team
 #define H_PLUGINWINDOWMAC_COCOAINVALIDATINGCA_H__
 
 #include "PluginWindowMacCocoaCA.h"
+#include <boost/shared_ptr.hpp>
 
 // This class implements the modifications to the CoreAnimation
-// drawing model in order to implement the InvalidatingCoreAnimation 
+// drawing model in order to implement the InvalidatingCoreAnimation
 // model.
 //
 // MDC: https://wiki.mozilla.org/NPAPI:InvalidatingCoreAnimation
@@ -30,6 +31,38 @@ namespace FB {
             ~PluginWindowMacCocoaICA();
 
             void InvalidateWindow();
+
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            /// @fn void PluginWindowMacCocoaICA::contentChanged()
+            ///
+            /// @brief  Draw-on-demand signal for the frame governor
+            ///
+            /// Instead of invalidating on a fixed cadence, call this whenever the plugin's
+            /// content actually changed.  Signals are coalesced and capped at the configured
+            /// frame rate, so the redraw rate tracks the content change rate: bursts flatten to
+            /// the cap, slow content redraws slowly, and a paused video redraws not at all.
+            /// Main thread only.
+            /// @since 1.5
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            void contentChanged();
+
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            /// @fn void PluginWindowMacCocoaICA::setMaxFrameRate(unsigned int fps)
+            ///
+            /// @brief  Caps governed redraws per second (default 60; 0 restores uncapped)
+            /// @since 1.5
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            void setMaxFrameRate(unsigned int fps);
+
+        protected:
+            void fireInvalidate();
+
+            double m_minInterval;               // seconds between governed invalidations
+            double m_lastInvalidate;            // CFAbsoluteTime of the last governed redraw
+            volatile int32_t m_invalidatePending;
+            // cleared in the destructor so a queued governor block can tell the
+            // window is gone instead of touching freed memory
+            boost::shared_ptr<PluginWindowMacCocoaICA*> m_self;
     };
 };
 
@@ -15,6 +15,10 @@ Copyright 2010 Anson MacKeracher, Firebreath development team
 #include "PluginWindowMacCocoaICA.h"
 #include "ConstructDefaultPluginWindows.h"
 
+#include <dispatch/dispatch.h>
+#include <libkern/OSAtomic.h>
+#include <CoreFoundation/CoreFoundation.h>
+
 using namespace FB;
 
 FB::PluginWindowMacCocoaICA* FB::createPluginWindowCocoaICA()
@@ -22,12 +26,50 @@ FB::PluginWindowMacCocoaICA* FB::createPluginWindowCocoaICA()
     return new PluginWindowMacCocoaICA();
 }
 
-PluginWindowMacCocoaICA::PluginWindowMacCocoaICA() {}
+PluginWindowMacCocoaICA::PluginWindowMacCocoaICA()
+  : m_minInterval(1.0 / 60.0), m_lastInvalidate(0), m_invalidatePending(0),
+    m_self(new PluginWindowMacCocoaICA*(this))
+{}
 
-PluginWindowMacCocoaICA::~PluginWindowMacCocoaICA() {}
+PluginWindowMacCocoaICA::~PluginWindowMacCocoaICA() {
+    *m_self = NULL;
+}
 
 void PluginWindowMacCocoaICA::InvalidateWindow() {
     // In plugin coordinates, invalidates entire window
     NPRect rect = { 0, 0, m_height, m_width};
-    m_npHost->InvalidateRect(&rect); 
+    m_npHost->InvalidateRect(&rect);
+}
+
+void PluginWindowMacCocoaICA::setMaxFrameRate(unsigned int fps) {
+    m_minInterval = fps ? 1.0 / fps : 0;
+}
+
+void PluginWindowMacCocoaICA::contentChanged() {
+    // coalesce: a pending governed invalidate covers this change too; while
+    // nothing changes, nothing is pending and nothing redraws
+    if (!OSAtomicCompareAndSwap32(0, 1, &m_invalidatePending))
+        return;
+
+    const double now = CFAbsoluteTimeGetCurrent();
+    const double due = m_lastInvalidate + m_minInterval;
+    if (due <= now) {
+        fireInvalidate();
+        return;
+    }
+    // cap reached: defer until the interval elapses; further signals until
+    // then fold into this one
+    boost::shared_ptr<PluginWindowMacCocoaICA*> self(m_self);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((due - now) * NSEC_PER_SEC)),
+                   dispatch_get_main_queue(), ^{
+        if (*self)
+            (*self)->fireInvalidate();
+    });
+}
+
+void PluginWindowMacCocoaICA::fireInvalidate() {
+    m_invalidatePending = 0;
+    m_lastInvalidate = CFAbsoluteTimeGetCurrent();
+    if (m_npHost)
+        InvalidateWindow();
 }
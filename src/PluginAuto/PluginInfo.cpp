@@ -13,50 +13,73 @@ Copyright 2010 Georg Fritzsche, Firebreath development team
 \**********************************************************/
 
 #include "global/config.h"
-#include <map>
 #include <string>
 #include <vector>
 #include <boost/algorithm/string.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "PluginInfo.h"
 
 namespace {
+    // Built once and never modified afterwards; the accessors hand out
+    // references into this data so that repeated metadata queries (browser
+    // plugin enumeration hits these for every mimetype) don't construct and
+    // destroy strings on every call.  The table is hashed because instance
+    // creation looks up the incoming mimetype on every NPP_New.
     bool nameParsed = false;
-    std::map<std::string, std::string> descMap;
+    std::string pluginName;
+    boost::unordered_map<std::string, std::string> descMap;
+    const std::string unknownDescription("Unknown Description");
 
     void initPluginMetadata()
     {
         if (nameParsed)
             return;
+        pluginName = FBSTRING_PluginName;
         std::vector<std::string> versions;
         boost::algorithm::split(versions, FBSTRING_X11MIMEType, boost::is_any_of(";"));
         for (std::vector<std::string>::const_iterator it = versions.begin();
             it != versions.end(); ++it)
         {
+            // each record is mimetype:extension:description; a type with no
+            // description still registers as supported
             std::vector<std::string> parts;
             boost::algorithm::split(parts, *it, boost::is_any_of(":"));
-            if (parts.size() > 2) {
-                descMap[parts[0]] = parts[2];
+            if (!parts.empty() && !parts[0].empty()) {
+                descMap[parts[0]] = (parts.size() > 2) ? parts[2] : unknownDescription;
             }
         }
         nameParsed = true;
     }
 };
 
-std::string FB::getPluginName(const std::string& mimetype)
+const std::string& FB::getPluginName(const std::string& mimetype)
 {
-    return FBSTRING_PluginName; // NPAPI only really allows one name per mimetype
+    initPluginMetadata();
+    return pluginName; // NPAPI only really allows one name per mimetype
 }
 
-std::string FB::getPluginDescription(const std::string& mimetype)
+const std::string& FB::getPluginDescription(const std::string& mimetype)
 {
     initPluginMetadata();
 
-    try {
-        return descMap[mimetype];
-    } catch (...) {
-        return "Unknown Description";
-    }
+    // find() instead of operator[] so a query for an unknown mimetype
+    // doesn't grow the table
+    boost::unordered_map<std::string, std::string>::const_iterator it = descMap.find(mimetype);
+    if (it != descMap.end())
+        return it->second;
+    return unknownDescription;
+}
+
+bool FB::isMimeTypeSupported(const std::string& mimetype)
+{
+    initPluginMetadata();
+    return descMap.find(mimetype) != descMap.end();
+}
+
+void FB::preparePluginMetadata()
+{
+    initPluginMetadata();
 }
 
 bool FB::pluginGuiEnabled() {
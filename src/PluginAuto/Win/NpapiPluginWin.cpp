@@ -100,15 +100,26 @@ NPError NpapiPluginWin::SetWindow(NPWindow* window)
         }
     
         if(pluginWin == NULL) {
+            // Deferred materialization: an instance that is below the fold has
+            // an empty clip rect, and subclassing its HWND now buys nothing.
+            // Skip window creation until the browser reports it visible; the
+            // JSAPI is live and onload fires in the meantime.  setReady() is
+            // idempotent, so the later real creation is unaffected.
+            bool clipEmpty = window->clipRect.top >= window->clipRect.bottom
+                          || window->clipRect.left >= window->clipRect.right;
+            if(clipEmpty && pluginMain->isDeferredWindow()) {
+                setReady();
+                return NPERR_NO_ERROR;
+            }
             // Create new window
             HWND browserHWND;
-            m_npHost->GetValue(NPNVnetscapeWindow, (void*)&browserHWND); 
+            m_npHost->GetValue(NPNVnetscapeWindow, (void*)&browserHWND);
             win = getFactoryInstance()->createPluginWindowWin(FB::WindowContextWin((HWND)window->window));
             win->setBrowserHWND(browserHWND);
             pluginMain->SetWindow(win);
             setReady();
             pluginWin = win;
-        }    
+        }
     }
 
     return NPERR_NO_ERROR;
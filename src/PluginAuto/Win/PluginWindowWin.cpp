@@ -31,6 +31,26 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 using namespace FB;
 
+namespace {
+    // blits the damaged part of the offscreen surface (top-down BGRA rows)
+    void blitSurface(HDC hdc, const FB::PluginSurfacePtr& surface, const RECT& rc)
+    {
+        if (rc.right <= rc.left || rc.bottom <= rc.top)
+            return;
+        BITMAPINFO bmi;
+        ZeroMemory(&bmi, sizeof(bmi));
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = surface->getWidth();
+        bmi.bmiHeader.biHeight = -surface->getHeight();     // negative = top-down
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        StretchDIBits(hdc, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top,
+                      rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top,
+                      surface->getPixels(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+    }
+}
+
 extern HINSTANCE gInstance;
 
 PluginWindowWin::PluginWindowMap FB::PluginWindowWin::m_windowMap;
@@ -115,12 +135,40 @@ bool PluginWindowWin::WinProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam
         case WM_MOUSEMOVE:
         {
             SetFocus( m_hWnd ); //get key focus, as the mouse is over our region
-            MouseMoveEvent ev(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
-            return SendEvent(&ev);
+            return SendMouseMoveEvent(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
         }
         case WM_PAINT:
         {
+            // a plugin painting through the offscreen surface already drew its
+            // pixels; the framework just blits the damaged part of them
+            if (FB::PluginSurfacePtr surface = getDrawingSurface()) {
+                PAINTSTRUCT ps;
+                HDC hdc = BeginPaint(m_hWnd, &ps);
+                blitSurface(hdc, surface, ps.rcPaint);
+                EndPaint(m_hWnd, &ps);
+                return true;
+            }
+            // pass the damaged region along so handlers can repaint just those
+            // pixels; the update region often covers a fraction of the window
             RefreshEvent ev;
+            HRGN updateRgn = ::CreateRectRgn(0, 0, 0, 0);
+            if (::GetUpdateRgn(m_hWnd, updateRgn, FALSE) > NULLREGION) {
+                std::vector<FB::Rect> damage;
+                DWORD size = ::GetRegionData(updateRgn, 0, NULL);
+                if (size) {
+                    std::vector<char> buf(size);
+                    RGNDATA* data = reinterpret_cast<RGNDATA*>(&buf[0]);
+                    if (::GetRegionData(updateRgn, size, data)) {
+                        const RECT* rc = reinterpret_cast<const RECT*>(data->Buffer);
+                        for (DWORD i = 0; i < data->rdh.nCount; ++i)
+                            damage.push_back(FB::Rect(rc[i].left, rc[i].top,
+                                rc[i].right - rc[i].left, rc[i].bottom - rc[i].top));
+                    }
+                }
+                if (!damage.empty())
+                    ev = RefreshEvent(damage);
+            }
+            ::DeleteObject(updateRgn);
             if (!SendEvent(&ev)) {
                 HDC hdc;
                 PAINTSTRUCT ps;
@@ -185,3 +233,13 @@ void PluginWindowWin::InvalidateWindow()
 {
     InvalidateRect(m_hWnd, NULL, true);
 }
+
+void PluginWindowWin::InvalidateRegion(const std::vector<FB::Rect>& rects)
+{
+    // each call only extends the window's update region; Windows coalesces
+    // them into the single WM_PAINT that follows
+    for (std::vector<FB::Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it) {
+        RECT wr = { it->x, it->y, it->x + it->w, it->y + it->h };
+        InvalidateRect(m_hWnd, &wr, true);
+    }
+}
@@ -74,6 +74,13 @@ namespace FB {
         boost::int16_t HandleEvent(NPEvent* evt) { return 0; }
         virtual void InvalidateWindow();
 
+    protected:
+        // batched damage from invalidateRect/endFrame; invalidates each merged
+        // rect so WM_PAINT arrives once with the combined update region
+        virtual void InvalidateRegion(const std::vector<FB::Rect>& rects);
+
+    public:
+
     protected:
         static PluginWindowMap m_windowMap;
 
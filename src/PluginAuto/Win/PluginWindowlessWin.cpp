@@ -9,14 +9,92 @@
 
 using namespace std; using namespace FB;
 
+namespace {
+    // blits the damaged part of the offscreen surface; dst is in window
+    // coordinates, the surface origin sits at (xOrigin, yOrigin)
+    void blitSurface(HDC hdc, const FB::PluginSurfacePtr& surface, const RECT& dst,
+                     int xOrigin, int yOrigin)
+    {
+        if (dst.right <= dst.left || dst.bottom <= dst.top)
+            return;
+        BITMAPINFO bmi;
+        ZeroMemory(&bmi, sizeof(bmi));
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = surface->getWidth();
+        bmi.bmiHeader.biHeight = -surface->getHeight();     // negative = top-down
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        StretchDIBits(hdc, dst.left, dst.top, dst.right - dst.left, dst.bottom - dst.top,
+                      dst.left - xOrigin, dst.top - yOrigin,
+                      dst.right - dst.left, dst.bottom - dst.top,
+                      surface->getPixels(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+    }
+}
+
 FB::PluginWindowlessWin* FB::createPluginWindowless(const FB::WindowContextWindowless& ctx)
 {
     return new PluginWindowlessWin(ctx);
 }
 
-PluginWindowlessWin::PluginWindowlessWin(const FB::WindowContextWindowless& ctx) : m_hdc(ctx.drawable) {}
+PluginWindowlessWin::PluginWindowlessWin(const FB::WindowContextWindowless& ctx)
+    : m_hdc(ctx.drawable), m_asyncInvalidatePending(0),
+      m_ctxX(0), m_ctxY(0), m_ctxWidth(-1), m_ctxHeight(-1),
+      m_ctxClipTop(0), m_ctxClipLeft(0), m_ctxClipBottom(0), m_ctxClipRight(0)
+{
+    m_renderContext.hdc = NULL;
+    m_renderContext.clipRegion = NULL;
+    m_renderContext.generation = 0;
+    m_renderContext.revalidated = false;
+}
 
-PluginWindowlessWin::~PluginWindowlessWin() {}
+PluginWindowlessWin::~PluginWindowlessWin() {
+    if (m_renderContext.clipRegion)
+        DeleteObject(m_renderContext.clipRegion);
+    for (std::map<std::string, HGDIOBJ>::iterator it = m_gdiCache.begin(); it != m_gdiCache.end(); ++it)
+        DeleteObject(it->second);
+}
+
+PluginWindowlessWin::RenderContext& PluginWindowlessWin::getRenderContext() {
+    const bool geometryChanged = m_ctxWidth != m_width || m_ctxHeight != m_height
+        || m_ctxX != m_x || m_ctxY != m_y
+        || m_ctxClipTop != m_clipTop || m_ctxClipLeft != m_clipLeft
+        || m_ctxClipBottom != m_clipBottom || m_ctxClipRight != m_clipRight;
+    if (m_renderContext.hdc != m_hdc || geometryChanged) {
+        m_ctxX = m_x; m_ctxY = m_y;
+        m_ctxWidth = m_width; m_ctxHeight = m_height;
+        m_ctxClipTop = m_clipTop; m_ctxClipLeft = m_clipLeft;
+        m_ctxClipBottom = m_clipBottom; m_ctxClipRight = m_clipRight;
+        if (m_renderContext.clipRegion)
+            DeleteObject(m_renderContext.clipRegion);
+        m_renderContext.clipRegion = CreateRectRgn(m_clipLeft, m_clipTop, m_clipRight, m_clipBottom);
+        m_renderContext.hdc = m_hdc;
+        ++m_renderContext.generation;
+        m_renderContext.revalidated = true;
+        if (m_renderContext.hdc)
+            SelectClipRgn(m_renderContext.hdc, m_renderContext.clipRegion);
+    } else {
+        m_renderContext.revalidated = false;
+    }
+    return m_renderContext;
+}
+
+HGDIOBJ PluginWindowlessWin::getCachedGDIObject(const std::string& key) {
+    std::map<std::string, HGDIOBJ>::const_iterator it = m_gdiCache.find(key);
+    return it != m_gdiCache.end() ? it->second : NULL;
+}
+
+void PluginWindowlessWin::setCachedGDIObject(const std::string& key, HGDIOBJ obj) {
+    std::map<std::string, HGDIOBJ>::iterator it = m_gdiCache.find(key);
+    if (it != m_gdiCache.end()) {
+        if (it->second == obj)
+            return;
+        DeleteObject(it->second);
+        it->second = obj;
+    } else {
+        m_gdiCache.insert(std::make_pair(key, obj));
+    }
+}
 
 void PluginWindowlessWin::translateWindowToPlugin(int &x, int &y) {
     int tempX, tempY;
@@ -82,8 +160,7 @@ int16_t PluginWindowlessWin::HandleEvent(NPEvent* evt)
             int x = GET_X_LPARAM(evt->lParam);
             int y = GET_Y_LPARAM(evt->lParam);
             translateWindowToPlugin(x, y);
-            MouseMoveEvent ev(x, y);
-            return SendEvent(&ev);
+            return SendMouseMoveEvent(x, y);
         }
         case WM_PAINT:
         {
@@ -91,7 +168,33 @@ int16_t PluginWindowlessWin::HandleEvent(NPEvent* evt)
             if(dc != m_hdc) {
                 setHDC(dc);
             }
+            // a plugin painting through the offscreen surface already drew its
+            // pixels; clip the blit to the browser's paint rect and we're done
+            if (FB::PluginSurfacePtr surface = getDrawingSurface()) {
+                RECT dst = { m_x, m_y,
+                             m_x + surface->getWidth(), m_y + surface->getHeight() };
+                if (const RECT* paint = reinterpret_cast<const RECT*>(evt->lParam)) {
+                    if (paint->left   > dst.left)   dst.left   = paint->left;
+                    if (paint->top    > dst.top)    dst.top    = paint->top;
+                    if (paint->right  < dst.right)  dst.right  = paint->right;
+                    if (paint->bottom < dst.bottom) dst.bottom = paint->bottom;
+                }
+                blitSurface(dc, surface, dst, m_x, m_y);
+                return 0;
+            }
+            // the browser's paint rect, translated into plugin coordinates so
+            // handlers can clip instead of repainting the full surface
             RefreshEvent ev;
+            if (const RECT* paint = reinterpret_cast<const RECT*>(evt->lParam)) {
+                FB::Rect r(paint->left - m_x, paint->top - m_y,
+                           paint->right - paint->left, paint->bottom - paint->top);
+                if (r.x < 0) { r.w += r.x; r.x = 0; }
+                if (r.y < 0) { r.h += r.y; r.y = 0; }
+                if (r.x + r.w > m_width)  r.w = m_width - r.x;
+                if (r.y + r.h > m_height) r.h = m_height - r.y;
+                if (!r.empty())
+                    ev = RefreshEvent(r);
+            }
             SendEvent(&ev);
             return 0;
         }
@@ -114,7 +217,7 @@ int16_t PluginWindowlessWin::HandleEvent(NPEvent* evt)
 void invalidateFunc(void* userData) {
     PluginWindowlessWin* window = reinterpret_cast<PluginWindowlessWin*>(userData);
     if(window != NULL) {
-        window->InvalidateWindow();
+        window->flushAsyncInvalidate();
     }
 }
 
@@ -126,9 +229,31 @@ void PluginWindowlessWin::InvalidateWindow() {
     }
 }
 
+void PluginWindowlessWin::InvalidateRegion(const std::vector<FB::Rect>& rects) {
+    if(m_npHost == NULL) {
+        return;
+    }
+    for (std::vector<FB::Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it) {
+        NPRect r = { static_cast<uint16_t>(it->y), static_cast<uint16_t>(it->x),
+                     static_cast<uint16_t>(it->y + it->h), static_cast<uint16_t>(it->x + it->w) };
+        m_npHost->InvalidateRect(&r);
+    }
+}
+
+void PluginWindowlessWin::flushAsyncInvalidate() {
+    // Clear the flag before invalidating so a request arriving while we paint can
+    // queue the next pass instead of being lost
+    ::InterlockedExchange(&m_asyncInvalidatePending, 0);
+    InvalidateWindow();
+}
+
 void PluginWindowlessWin::AsyncInvalidateWindow() {
     if(m_npHost != NULL) {
-        m_npHost->ScheduleAsyncCall(invalidateFunc, this);
+        // Coalesce: if an invalidate is already queued it will cover this request
+        // too, so bursts of updates cost one browser crossing per message-loop pass
+        if (::InterlockedExchange(&m_asyncInvalidatePending, 1) == 0) {
+            m_npHost->ScheduleAsyncCall(invalidateFunc, this);
+        }
     }
 }
 
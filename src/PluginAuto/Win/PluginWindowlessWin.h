@@ -17,6 +17,8 @@ Copyright 2010 Anson MacKeracher, Firebreath development team
 
 #include "win_common.h"
 #include "PluginWindow.h"
+#include <map>
+#include <string>
 
 #include "NpapiBrowserHost.h"
 #include "NpapiPlugin.h"
@@ -54,7 +56,36 @@ namespace FB {
             ////////////////////////////////////////////////////////////////////////////////////////////////////
             HDC getHDC() { return m_hdc; }
             void setHDC(HDC hdc) { m_hdc = hdc; }
-            HWND getHWND(); 
+            HWND getHWND();
+
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            /// @struct RenderContext
+            ///
+            /// @brief  Per-window draw state that survives across windowless paints
+            ///
+            /// The browser hands out an HDC per paint; rebuilding clipping and GDI objects for
+            /// each one is what most handlers spend their draw time on.  getRenderContext()
+            /// re-validates only when the HDC, position, or clip actually changed: the clip
+            /// region is rebuilt and selected then, and revalidated tells the handler to refresh
+            /// anything of its own that depends on geometry.  DC-independent objects (pens,
+            /// brushes, fonts, bitmaps) parked with setCachedGDIObject() survive every paint and
+            /// are deleted when the window goes away.
+            /// @since 1.5
+            ////////////////////////////////////////////////////////////////////////////////////////////////////
+            struct RenderContext {
+                HDC hdc;                    // the DC this state was validated against
+                HRGN clipRegion;            // window clip in window coordinates; already selected
+                unsigned int generation;    // bumped on every revalidation
+                bool revalidated;           // true when this paint saw a new HDC or geometry
+            };
+
+            /// validates the context against the current HDC/position/clip and returns it
+            RenderContext& getRenderContext();
+
+            /// returns a previously parked GDI object, or NULL
+            HGDIOBJ getCachedGDIObject(const std::string& key);
+            /// parks a GDI object under key; the window owns (and deletes) it from here on
+            void setCachedGDIObject(const std::string& key, HGDIOBJ obj);
 
             // NpapiBrowserHost is used to send calls to NPAPI
             Npapi::NpapiBrowserHostPtr getNpHost() { return m_npHost; }
@@ -108,15 +139,28 @@ namespace FB {
 
             // Invalidate the window from *the plugin's* thread
             void InvalidateWindow();
-            // Invalidate the window from any thread (useful for drawing)
+            // Invalidate the window from any thread (useful for drawing).  Bursts of
+            // calls are coalesced into a single queued invalidate per message-loop pass
             void AsyncInvalidateWindow();
+            // Runs the queued async invalidate; only called by the async dispatcher
+            void flushAsyncInvalidate();
 
         protected:
+            // batched damage from invalidateRect/endFrame; forwards each merged
+            // rect to the browser instead of invalidating the whole plugin area
+            virtual void InvalidateRegion(const std::vector<FB::Rect>& rects);
+
             HDC m_hdc;
+            RenderContext m_renderContext;
+            int m_ctxX, m_ctxY, m_ctxWidth, m_ctxHeight;        // geometry the context was built for
+            int m_ctxClipTop, m_ctxClipLeft, m_ctxClipBottom, m_ctxClipRight;
+            std::map<std::string, HGDIOBJ> m_gdiCache;          // handler-parked objects, owned here
             HWND m_browserHwnd;
             Npapi::NpapiBrowserHostPtr m_npHost;
-            int m_x, m_y, m_width, m_height; 
+            int m_x, m_y, m_width, m_height;
             int m_clipTop, m_clipLeft, m_clipBottom, m_clipRight;
+            // Non-zero while an async invalidate is queued but not yet delivered
+            volatile LONG m_asyncInvalidatePending;
     };    
 };
 
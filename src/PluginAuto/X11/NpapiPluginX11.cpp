@@ -86,7 +86,9 @@ NPError NpapiPluginX11::SetWindow(NPWindow* window)
          */
         int xembedSupported = 0;
 
-        m_npHost->GetValue(NPNVSupportsXEmbedBool, &xembedSupported);
+        // XEmbed support can't change while the browser is running; the cached
+        // probe only asks once per process no matter how many instances load
+        m_npHost->GetValueCached(NPNVSupportsXEmbedBool, &xembedSupported);
         if (!xembedSupported)
         {
             printf("XEmbed not supported\n");
@@ -24,6 +24,20 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #if FB_GUI_DISABLED != 1
 
 #include <gdk/gdkx.h>
+#include <X11/Xutil.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <cstring>
+
+namespace {
+    // XShmAttach failures (remote displays) arrive as protocol errors
+    bool g_shmAttachError = false;
+    int shmErrorHandler(Display*, XErrorEvent*)
+    {
+        g_shmAttachError = true;
+        return 0;
+    }
+}
 
 #endif
 
@@ -43,6 +57,16 @@ PluginWindowX11::PluginWindowX11(const WindowContextX11& ctx)
     m_x(0), m_y(0), m_width(0), m_height(0), m_clipLeft(0), m_clipRight(0),
     m_clipTop(0), m_clipBottom(0)
 {
+#if FB_GUI_DISABLED != 1
+    m_ximage = NULL;
+    m_gc = NULL;
+    m_usingShm = false;
+    m_shmUnavailable = false;
+    m_shmPutPending = false;
+    m_shmFilterInstalled = false;
+    m_shmCompletionType = 0;
+    std::memset(&m_shmInfo, 0, sizeof(m_shmInfo));
+#endif
 #if FB_GUI_DISABLED != 1
     m_container = gtk_plug_new((GdkNativeWindow)ctx.window);
     m_canvas = gtk_drawing_area_new();
@@ -77,6 +101,19 @@ PluginWindowX11::PluginWindowX11(const WindowContextX11& ctx)
 
 PluginWindowX11::~PluginWindowX11()
 {
+#if FB_GUI_DISABLED != 1
+    if (m_ximage && m_canvas) {
+        GdkWindow* gdkwin = gtk_widget_get_window(m_canvas);
+        if (gdkwin) {
+            Display* display = GDK_WINDOW_XDISPLAY(gdkwin);
+            if (m_gc) {
+                XFreeGC(display, m_gc);
+                m_gc = NULL;
+            }
+            destroyImage(display);
+        }
+    }
+#endif
 }
 
 void PluginWindowX11::getWindowPosition(int &x, int &y, int &w, int &h)
@@ -194,8 +231,7 @@ gboolean PluginWindowX11::EventCallback(GtkWidget *widget, GdkEvent *event)
 
         case GDK_MOTION_NOTIFY: {
             motion = (GdkEventMotion *)event;
-            MouseMoveEvent evt(motion->x, motion->y);
-            return SendEvent(&evt) ? 1 : 0;
+            return SendMouseMoveEvent(motion->x, motion->y) ? 1 : 0;
         } break;
 
         case GDK_FOCUS_CHANGE: {
@@ -203,6 +239,41 @@ gboolean PluginWindowX11::EventCallback(GtkWidget *widget, GdkEvent *event)
             FocusChangedEvent evt(focus->in ? true : false);
             return SendEvent(&evt) ? 1 : 0;
         }
+
+        case GDK_EXPOSE: {
+            GdkEventExpose* expose = (GdkEventExpose*)event;
+            // compact exposure series the way native X apps do: a window
+            // reveal arrives as dozens of small rects with count > 0, and
+            // only the last one (count == 0) triggers the repaint
+            if (m_exposeRects.size() >= 16) {
+                // pathological fragmentation; collapse to the union
+                FB::Rect all;
+                for (std::vector<FB::Rect>::iterator it = m_exposeRects.begin();
+                        it != m_exposeRects.end(); ++it)
+                    all = all.unionWith(*it);
+                m_exposeRects.clear();
+                m_exposeRects.push_back(all);
+            }
+            m_exposeRects.push_back(
+                FB::Rect(expose->area.x, expose->area.y,
+                         expose->area.width, expose->area.height));
+            if (expose->count > 0)
+                return true;
+            std::vector<FB::Rect> damage;
+            damage.swap(m_exposeRects);
+
+            // a plugin painting through the offscreen surface already drew its
+            // pixels; the framework pushes the damaged parts of them
+            if (FB::PluginSurfacePtr surface = getDrawingSurface()) {
+                for (std::vector<FB::Rect>::iterator it = damage.begin();
+                        it != damage.end(); ++it)
+                    blitSurface(surface, it->x, it->y, it->w, it->h);
+                return true;
+            }
+            RefreshEvent evt(damage);
+            return SendEvent(&evt) ? 1 : 0;
+        }
+
         default:
             return false;
     }
@@ -210,6 +281,146 @@ gboolean PluginWindowX11::EventCallback(GtkWidget *widget, GdkEvent *event)
     return false;
 }
 
+void PluginWindowX11::InvalidateRegion(const std::vector<FB::Rect>& rects)
+{
+    for (std::vector<FB::Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it)
+        gtk_widget_queue_draw_area(m_canvas, it->x, it->y, it->w, it->h);
+}
+
+GdkFilterReturn PluginWindowX11::_ShmCompletionFilter(GdkXEvent* xevent, GdkEvent*, gpointer user_data)
+{
+    PluginWindowX11* win = reinterpret_cast<PluginWindowX11*>(user_data);
+    const XEvent* xev = reinterpret_cast<const XEvent*>(xevent);
+    if (win->m_usingShm && xev->type == win->m_shmCompletionType) {
+        win->m_shmPutPending = false;
+        return GDK_FILTER_REMOVE;
+    }
+    return GDK_FILTER_CONTINUE;
+}
+
+bool PluginWindowX11::ensureImage(Display* display, int w, int h)
+{
+    if (m_ximage && m_ximage->width == w && m_ximage->height == h)
+        return true;
+    destroyImage(display);
+
+    Visual* visual = DefaultVisual(display, DefaultScreen(display));
+    const int depth = DefaultDepth(display, DefaultScreen(display));
+
+    if (!m_shmUnavailable && XShmQueryExtension(display)) {
+        m_ximage = XShmCreateImage(display, visual, depth, ZPixmap, NULL, &m_shmInfo, w, h);
+        if (m_ximage) {
+            m_shmInfo.shmid = shmget(IPC_PRIVATE,
+                m_ximage->bytes_per_line * m_ximage->height, IPC_CREAT | 0600);
+            if (m_shmInfo.shmid >= 0) {
+                m_shmInfo.shmaddr = m_ximage->data =
+                    reinterpret_cast<char*>(shmat(m_shmInfo.shmid, NULL, 0));
+                if (m_shmInfo.shmaddr != reinterpret_cast<char*>(-1)) {
+                    m_shmInfo.readOnly = False;
+                    g_shmAttachError = false;
+                    XErrorHandler old = XSetErrorHandler(shmErrorHandler);
+                    const Bool attached = XShmAttach(display, &m_shmInfo);
+                    XSync(display, False);
+                    XSetErrorHandler(old);
+                    // mark for deletion now; the segment lives until both sides detach
+                    shmctl(m_shmInfo.shmid, IPC_RMID, NULL);
+                    if (attached && !g_shmAttachError) {
+                        m_usingShm = true;
+                        m_shmCompletionType = XShmGetEventBase(display) + ShmCompletion;
+                        return true;
+                    }
+                    shmdt(m_shmInfo.shmaddr);
+                } else {
+                    // shmget can succeed and the mapping still fail (EMFILE,
+                    // ENOMEM); release the segment and take the socket path
+                    shmctl(m_shmInfo.shmid, IPC_RMID, NULL);
+                }
+            }
+            m_ximage->data = NULL;
+            XDestroyImage(m_ximage);
+            m_ximage = NULL;
+        }
+        // remote display or no segments; fall back to socket transport for good
+        m_shmUnavailable = true;
+    }
+
+    char* buffer = reinterpret_cast<char*>(std::malloc(static_cast<size_t>(w) * 4 * h));
+    m_ximage = XCreateImage(display, visual, depth, ZPixmap, 0, buffer, w, h, 32, 0);
+    if (!m_ximage) {
+        std::free(buffer);
+        return false;
+    }
+    return true;
+}
+
+void PluginWindowX11::destroyImage(Display* display)
+{
+    if (!m_ximage)
+        return;
+    if (m_usingShm) {
+        if (m_shmPutPending) {
+            XSync(display, False);
+            m_shmPutPending = false;
+        }
+        XShmDetach(display, &m_shmInfo);
+        shmdt(m_shmInfo.shmaddr);
+        m_ximage->data = NULL;      // XDestroyImage must not free the segment
+        m_usingShm = false;
+    }
+    XDestroyImage(m_ximage);        // frees the malloc'd buffer in the fallback case
+    m_ximage = NULL;
+}
+
+void PluginWindowX11::blitSurface(const PluginSurfacePtr& surface, int x, int y, int w, int h)
+{
+    GdkWindow* gdkwin = gtk_widget_get_window(m_canvas);
+    if (!gdkwin)
+        return;
+    Display* display = GDK_WINDOW_XDISPLAY(gdkwin);
+    ::Window drawable = GDK_WINDOW_XID(gdkwin);
+
+    if (!ensureImage(display, surface->getWidth(), surface->getHeight()))
+        return;
+
+    // clip the expose area to the surface
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > surface->getWidth())  w = surface->getWidth() - x;
+    if (y + h > surface->getHeight()) h = surface->getHeight() - y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    // completion pacing: never scribble over pixels the server may still be
+    // reading from the shared segment
+    if (m_usingShm && m_shmPutPending) {
+        XSync(display, False);
+        m_shmPutPending = false;
+    }
+
+    const unsigned char* src = surface->getPixels();
+    const size_t srcStride = surface->getStride();
+    for (int row = y; row < y + h; ++row) {
+        std::memcpy(m_ximage->data + row * m_ximage->bytes_per_line + x * 4,
+                    src + row * srcStride + x * 4,
+                    static_cast<size_t>(w) * 4);
+    }
+
+    if (!m_gc)
+        m_gc = XCreateGC(display, drawable, 0, NULL);
+
+    if (m_usingShm) {
+        if (!m_shmFilterInstalled) {
+            gdk_window_add_filter(gdkwin, &PluginWindowX11::_ShmCompletionFilter, this);
+            m_shmFilterInstalled = true;
+        }
+        XShmPutImage(display, drawable, m_gc, m_ximage, x, y, x, y, w, h, True);
+        m_shmPutPending = true;
+        XFlush(display);
+    } else {
+        XPutImage(display, drawable, m_gc, m_ximage, x, y, x, y, w, h);
+    }
+}
+
 //
 // int16_t PluginWindowX11::HandleEvent(EventRecord* evt)
 // {
@@ -20,6 +20,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #if FB_GUI_DISABLED != 1
 
 #include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
 #include <gtk/gtk.h>
 
 #endif
@@ -53,11 +54,38 @@ namespace FB {
     protected:
         gboolean EventCallback(GtkWidget *widget, GdkEvent *event);
 
+        // batched damage from invalidateRect/endFrame; queues a redraw for
+        // each merged rect so the expose arrives with the combined region
+        virtual void InvalidateRegion(const std::vector<Rect>& rects);
+
+        // offscreen-surface blit path: damaged rows go into an XImage that is
+        // pushed with MIT-SHM when the display is local (pointer handoff paced
+        // by ShmCompletion events) and over the socket otherwise
+        void blitSurface(const PluginSurfacePtr& surface, int x, int y, int w, int h);
+        bool ensureImage(Display* display, int w, int h);
+        void destroyImage(Display* display);
+        static GdkFilterReturn _ShmCompletionFilter(GdkXEvent* xevent, GdkEvent* event, gpointer user_data);
+
         GdkNativeWindow m_window;
         GdkNativeWindow m_browserWindow;
         GtkWidget *m_container;
         GtkWidget *m_canvas;
 
+        // exposures with count > 0 accumulate here and repaint once when the
+        // final event of the series (count == 0) arrives; the list is kept so
+        // RefreshEvent can carry the individual damage rects, collapsing to
+        // the union if a series gets absurdly fragmented
+        std::vector<Rect> m_exposeRects;
+
+        XImage* m_ximage;
+        XShmSegmentInfo m_shmInfo;
+        GC m_gc;
+        bool m_usingShm;
+        bool m_shmUnavailable;      // extension missing or attach failed (remote display); don't retry
+        bool m_shmPutPending;       // a shared-memory put the server hasn't acknowledged yet
+        bool m_shmFilterInstalled;
+        int m_shmCompletionType;
+
 #endif
 
     protected:
@@ -1,122 +1,291 @@
-/**********************************************************\ 
-Original Author: Richard Bateman (taxilian)
-
-Created:    Sep 30, 2010
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-            
-Copyright 2010 Facebook, Inc
-\**********************************************************/
-
-#include <string>
-#include <boost/scoped_ptr.hpp>
-
-#include "log4cplus/config/defines.hxx"
-#include "log4cplus/logger.h"
-#include "log4cplus/loglevel.h"
-#include "log4cplus/layout.h"
-#include "log4cplus/ndc.h"
-#include "log4cplus/fileappender.h"
-#include "log4cplus/win32debugappender.h"
-#include "log4cplus/consoleappender.h"
-#include "log4cplus/nullappender.h"
-
-#include "FactoryBase.h"
-#include "logging.h"
-#include "utf8_tools.h"
-
-namespace 
-{
-    bool logging_started = false;
-}
-
-void FB::Log::initLogging()
-{
-    if (logging_started)
-        return;
-
-    bool addedAppender = false;
-
-    log4cplus::Logger logger = log4cplus::Logger::getInstance(L"FireBreath");
-    FB::Log::LogMethodList mlist;
-    getFactoryInstance()->getLoggingMethods(mlist);
-
-    for (FB::Log::LogMethodList::const_iterator it = mlist.begin(); it != mlist.end(); ++it) {
-        switch( it->first ) {
-        case FB::Log::LogMethod_Console: {
-#ifdef FB_WIN
-            log4cplus::SharedAppenderPtr debugAppender(new log4cplus::Win32DebugAppender());
-            std::auto_ptr<log4cplus::Layout> layout2(new log4cplus::TTCCLayout());
-            debugAppender->setLayout(layout2);
-            logger.addAppender(debugAppender);
-            addedAppender = true;
-#else
-            log4cplus::SharedAppenderPtr debugAppender(new log4cplus::ConsoleAppender());
-            std::auto_ptr<log4cplus::Layout> layout2(new log4cplus::TTCCLayout());
-            debugAppender->setLayout(layout2);
-            logger.addAppender(debugAppender);
-            addedAppender = true;
-#endif
-            }
-        case FB::Log::LogMethod_File: {
-            log4cplus::SharedAppenderPtr fileAppender(new log4cplus::FileAppender(FB::utf8_to_wstring(it->second)));
-            std::auto_ptr<log4cplus::Layout> layout(new log4cplus::TTCCLayout());
-            fileAppender->setLayout(layout);
-            logger.addAppender(fileAppender);
-            addedAppender = true;
-          }
-        }
-    }
-
-    // If there are no other appenders, add a NULL appender
-    if (!addedAppender) {
-        log4cplus::SharedAppenderPtr nullAppender(new log4cplus::NullAppender());
-        std::auto_ptr<log4cplus::Layout> layout3(new log4cplus::TTCCLayout());
-        nullAppender->setLayout(layout3);
-        logger.addAppender(nullAppender);
-    }
-    
-    logging_started = true;
-}
-
-void FB::Log::stopLogging()
-{
-    log4cplus::Logger logger = log4cplus::Logger::getInstance(L"FireBreath");
-    logger.shutdown();
-    logging_started = false;
-}
-
-void FB::Log::trace(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
-{
-    LOG4CPLUS_TRACE(log4cplus::Logger::getInstance(L"FireBreath"), 
-                    file << ":" << line << " - " << fn << " - " << FB::utf8_to_wstring(msg));
-}
-void FB::Log::debug(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
-{
-    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance(L"FireBreath"), 
-                    file << ":" << line << " - " << fn << " - " << FB::utf8_to_wstring(msg));
-}
-void FB::Log::info(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
-{
-    LOG4CPLUS_INFO(log4cplus::Logger::getInstance(L"FireBreath"), 
-                   file << ":" << line << " - " << fn << " - " << FB::utf8_to_wstring(msg));
-}
-void FB::Log::warn(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
-{
-    LOG4CPLUS_WARN(log4cplus::Logger::getInstance(L"FireBreath"), 
-                   file << ":" << line << " - " << fn << " - " << FB::utf8_to_wstring(msg));
-}
-void FB::Log::error(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
-{
-    LOG4CPLUS_ERROR(log4cplus::Logger::getInstance(L"FireBreath"), 
-                    file << ":" << line << " - " << fn << " - " << FB::utf8_to_wstring(msg));
-}
-void FB::Log::fatal(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
-{
-    LOG4CPLUS_ERROR(log4cplus::Logger::getInstance(L"FireBreath"), 
-                    file << ":" << line << " - " << fn << " - " << FB::utf8_to_wstring(msg));
-}
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Sep 30, 2010
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 Facebook, Inc
+\**********************************************************/
+
+#include <string>
+#include <sstream>
+#include <deque>
+#include <boost/scoped_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "log4cplus/config/defines.hxx"
+#include "log4cplus/logger.h"
+#include "log4cplus/loglevel.h"
+#include "log4cplus/layout.h"
+#include "log4cplus/ndc.h"
+#include "log4cplus/fileappender.h"
+#include "log4cplus/win32debugappender.h"
+#include "log4cplus/consoleappender.h"
+#include "log4cplus/nullappender.h"
+
+#include "FactoryBase.h"
+#include "logging.h"
+#include "utf8_tools.h"
+
+namespace
+{
+    bool logging_started = false;
+
+    // Appender setup touches the filesystem (FileAppender open, and on
+    // networked profiles even the console appender can stall), so it no
+    // longer runs during module load.  configureAppenders() is called from
+    // the writer thread just before the first batch is delivered -- and from
+    // the synchronous fallback below -- so page load never waits on it.
+    bool appenders_configured = false;
+    boost::mutex configure_mutex;
+
+    void configureAppenders()
+    {
+        boost::lock_guard<boost::mutex> lock(configure_mutex);
+        if (appenders_configured)
+            return;
+
+        bool addedAppender = false;
+
+        log4cplus::Logger logger = log4cplus::Logger::getInstance(L"FireBreath");
+        FB::Log::LogMethodList mlist;
+        getFactoryInstance()->getLoggingMethods(mlist);
+
+        for (FB::Log::LogMethodList::const_iterator it = mlist.begin(); it != mlist.end(); ++it) {
+            switch( it->first ) {
+            case FB::Log::LogMethod_Console: {
+#ifdef FB_WIN
+                log4cplus::SharedAppenderPtr debugAppender(new log4cplus::Win32DebugAppender());
+                std::auto_ptr<log4cplus::Layout> layout2(new log4cplus::TTCCLayout());
+                debugAppender->setLayout(layout2);
+                logger.addAppender(debugAppender);
+                addedAppender = true;
+#else
+                log4cplus::SharedAppenderPtr debugAppender(new log4cplus::ConsoleAppender());
+                std::auto_ptr<log4cplus::Layout> layout2(new log4cplus::TTCCLayout());
+                debugAppender->setLayout(layout2);
+                logger.addAppender(debugAppender);
+                addedAppender = true;
+#endif
+                }
+            case FB::Log::LogMethod_File: {
+                log4cplus::SharedAppenderPtr fileAppender(new log4cplus::FileAppender(FB::utf8_to_wstring(it->second)));
+                std::auto_ptr<log4cplus::Layout> layout(new log4cplus::TTCCLayout());
+                fileAppender->setLayout(layout);
+                logger.addAppender(fileAppender);
+                addedAppender = true;
+              }
+            }
+        }
+
+        // If there are no other appenders, add a NULL appender
+        if (!addedAppender) {
+            log4cplus::SharedAppenderPtr nullAppender(new log4cplus::NullAppender());
+            std::auto_ptr<log4cplus::Layout> layout3(new log4cplus::TTCCLayout());
+            nullAppender->setLayout(layout3);
+            logger.addAppender(nullAppender);
+        }
+
+        appenders_configured = true;
+    }
+
+    // Asynchronous backend: callers enqueue a compact record and return
+    // immediately; this writer thread does the formatting, the utf8->wide
+    // conversion and the appender I/O.  The hot path is one bounded queue
+    // push, so an appender stall can never block JSAPI dispatch.
+    struct LogRecord
+    {
+        log4cplus::LogLevel level;
+        std::string msg;
+        // __FILE__ / function-name literals have static storage, so the
+        // record can keep the pointers instead of copying the strings
+        const char* file;
+        const char* fn;
+        int line;
+    };
+
+    class AsyncLogWriter
+    {
+    public:
+        AsyncLogWriter()
+            : m_stop(false), m_dropped(0),
+              m_thread(boost::bind(&AsyncLogWriter::run, this))
+        { }
+
+        ~AsyncLogWriter()
+        {
+            {
+                boost::lock_guard<boost::mutex> lock(m_mutex);
+                m_stop = true;
+                m_cond.notify_all();
+            }
+            // drains whatever is queued before returning
+            m_thread.join();
+        }
+
+        void post(log4cplus::LogLevel level, const std::string& msg,
+                  const char* file, int line, const char* fn)
+        {
+            boost::lock_guard<boost::mutex> lock(m_mutex);
+            if (m_queue.size() >= MaxQueue) {
+                // drop-oldest: logging must never stall the caller
+                m_queue.pop_front();
+                ++m_dropped;
+            }
+            m_queue.push_back(LogRecord());
+            LogRecord& r = m_queue.back();
+            r.level = level;
+            r.msg = msg;
+            r.file = file;
+            r.fn = fn;
+            r.line = line;
+            m_cond.notify_one();
+        }
+
+    private:
+        void run()
+        {
+            log4cplus::Logger logger = log4cplus::Logger::getInstance(L"FireBreath");
+            std::deque<LogRecord> batch;
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            for (;;) {
+                if (m_queue.empty()) {
+                    if (m_stop)
+                        return;
+                    m_cond.wait(lock);
+                    continue;
+                }
+                batch.swap(m_queue);
+                const size_t dropped = m_dropped;
+                m_dropped = 0;
+                lock.unlock();
+
+                // no-op after the first batch; early messages sat in the
+                // queue until now, so nothing logged before this is lost
+                configureAppenders();
+
+                for (std::deque<LogRecord>::const_iterator it = batch.begin();
+                        it != batch.end(); ++it) {
+                    std::ostringstream os;
+                    os << it->file << ":" << it->line << " - " << it->fn
+                       << " - " << it->msg;
+                    logger.forcedLog(it->level, FB::utf8_to_wstring(os.str()),
+                                     it->file, it->line);
+                }
+                if (dropped) {
+                    std::ostringstream os;
+                    os << "log queue overflowed; dropped " << dropped << " messages";
+                    logger.forcedLog(log4cplus::WARN_LOG_LEVEL,
+                                     FB::utf8_to_wstring(os.str()));
+                }
+                batch.clear();
+
+                lock.lock();
+            }
+        }
+
+        static const size_t MaxQueue = 4096;
+        boost::mutex m_mutex;
+        boost::condition_variable m_cond;
+        std::deque<LogRecord> m_queue;
+        bool m_stop;
+        size_t m_dropped;
+        boost::thread m_thread;
+    };
+
+    boost::scoped_ptr<AsyncLogWriter> log_writer;
+
+    void postLog(log4cplus::LogLevel level, const std::string& msg,
+                 const char* file, int line, const char* fn)
+    {
+        log4cplus::Logger logger = log4cplus::Logger::getInstance(L"FireBreath");
+        // level filtering happens here on the calling thread, so disabled
+        // levels cost just this check
+        if (!logger.isEnabledFor(level))
+            return;
+        if (log_writer) {
+            log_writer->post(level, msg, file, line, fn);
+        } else {
+            // logging before initLogging (or after stopLogging) stays
+            // synchronous rather than silently vanishing
+            configureAppenders();
+            std::ostringstream os;
+            os << file << ":" << line << " - " << fn << " - " << msg;
+            logger.forcedLog(level, FB::utf8_to_wstring(os.str()), file, line);
+        }
+    }
+}
+
+void FB::Log::initLogging()
+{
+    if (logging_started)
+        return;
+
+    // Deliberately cheap: just start the writer thread.  Appenders (and the
+    // factory callback behind them) are configured lazily on that thread by
+    // configureAppenders() when the first record arrives, so module load and
+    // first-instance creation never block on log configuration I/O.
+    log_writer.reset(new AsyncLogWriter());
+
+    logging_started = true;
+}
+
+void FB::Log::stopLogging()
+{
+    // joins the writer thread, draining anything still queued; a module
+    // that never logged never configures appenders at all
+    log_writer.reset();
+    log4cplus::Logger logger = log4cplus::Logger::getInstance(L"FireBreath");
+    logger.shutdown();
+    {
+        boost::lock_guard<boost::mutex> lock(configure_mutex);
+        appenders_configured = false;
+    }
+    logging_started = false;
+}
+
+bool FB::Log::isLogLevelEnabled(FB::Log::LogLevel level)
+{
+    log4cplus::LogLevel ll;
+    switch (level) {
+        case FB::Log::LogLevel_Trace: ll = log4cplus::TRACE_LOG_LEVEL; break;
+        case FB::Log::LogLevel_Debug: ll = log4cplus::DEBUG_LOG_LEVEL; break;
+        case FB::Log::LogLevel_Info:  ll = log4cplus::INFO_LOG_LEVEL;  break;
+        case FB::Log::LogLevel_Warn:  ll = log4cplus::WARN_LOG_LEVEL;  break;
+        case FB::Log::LogLevel_Error:
+        default:                      ll = log4cplus::ERROR_LOG_LEVEL; break;
+    }
+    return log4cplus::Logger::getInstance(L"FireBreath").isEnabledFor(ll);
+}
+
+void FB::Log::trace(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
+{
+    postLog(log4cplus::TRACE_LOG_LEVEL, msg, file, line, fn);
+}
+void FB::Log::debug(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
+{
+    postLog(log4cplus::DEBUG_LOG_LEVEL, msg, file, line, fn);
+}
+void FB::Log::info(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
+{
+    postLog(log4cplus::INFO_LOG_LEVEL, msg, file, line, fn);
+}
+void FB::Log::warn(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
+{
+    postLog(log4cplus::WARN_LOG_LEVEL, msg, file, line, fn);
+}
+void FB::Log::error(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
+{
+    postLog(log4cplus::ERROR_LOG_LEVEL, msg, file, line, fn);
+}
+void FB::Log::fatal(const std::string& src, const std::string& msg, const char *file, int line, const char *fn)
+{
+    postLog(log4cplus::FATAL_LOG_LEVEL, msg, file, line, fn);
+}
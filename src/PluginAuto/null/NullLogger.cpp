@@ -18,6 +18,8 @@ Copyright 2010 Facebook, Inc
 void FB::Log::initLogging() {};
 void FB::Log::stopLogging() {};
 
+bool FB::Log::isLogLevelEnabled(FB::Log::LogLevel) { return false; }
+
 void FB::Log::trace(const std::string&, const std::string&, const char *file, int line, const char*) {}
 void FB::Log::debug(const std::string&, const std::string&, const char *file, int line, const char*) {}
 void FB::Log::info(const std::string&, const std::string&, const char *file, int line, const char*) {}
@@ -12,10 +12,32 @@ License:    Dual license model; choose one of two:
 Copyright 2010 PacketPass, Inc and the Firebreath development team
 \**********************************************************/
 
+#include <algorithm>
+#include <limits>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#ifdef FB_WIN
+#include "win_targetver.h"
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "utf8_tools.h"
 #include "BrowserStream.h"
 
 using namespace FB;
 
+namespace {
+    bool rangeStartLess( const BrowserStream::Range& lhs, const BrowserStream::Range& rhs )
+    {
+        return lhs.start < rhs.start;
+    }
+}
+
 // browser stream
 BrowserStream::BrowserStream(const std::string& Url, bool Cache, bool SeekableRequested, size_t InternalBufferSize) 
   : url(Url)
@@ -26,6 +48,13 @@ BrowserStream::BrowserStream(const std::string& Url, bool Cache, bool SeekableRe
   , length(0)
   , completed(false)
   , opened(false)
+  , rangeCoalesceGap(4096)
+  , maxRangeRequestSize(0)
+  , progressIntervalMs(100)
+  , progressMinDelta(1.0f)
+  , lastProgressPct(-1.0f)
+  , blockCacheHits(0)
+  , blockCacheMisses(0)
 {
 }
 
@@ -40,6 +69,258 @@ bool BrowserStream::readRange( size_t start, size_t end )
     return readRanges( std::vector<Range>( 1, Range(start, end) ) );
 }
 
+bool BrowserStream::readRanges( const std::vector<Range>& ranges )
+{
+    if ( ranges.empty() )
+        return true;
+
+    std::vector<Range> prepared( prepareRanges( ranges ) );
+    if ( !blockCache )
+        return doReadRanges( prepared );
+
+    // serve what the block cache covers synchronously; only misses hit the host
+    std::vector<Range> misses;
+    std::vector<char> cachedData;
+    for ( std::vector<Range>::const_iterator it = prepared.begin(); it != prepared.end(); ++it )
+    {
+        if ( blockCache->lookup( it->start, it->end, cachedData ) )
+        {
+            ++blockCacheHits;
+            float progress = 0;
+            if ( length )
+                progress = float( it->end ) / float( length ) * 100.f;
+            StreamDataArrivedEvent ev( this, &cachedData[0], cachedData.size(), it->start, progress );
+            SendEvent( &ev );
+        }
+        else
+        {
+            ++blockCacheMisses;
+            misses.push_back( *it );
+        }
+    }
+    if ( misses.empty() )
+        return true;
+    return doReadRanges( misses );
+}
+
+std::vector<BrowserStream::Range> BrowserStream::prepareRanges( const std::vector<Range>& ranges ) const
+{
+    std::vector<Range> sorted( ranges );
+    std::sort( sorted.begin(), sorted.end(), rangeStartLess );
+
+    // Merge ranges whose gap to the previous one is within the coalesce
+    // threshold; the few extra bytes fetched are far cheaper than another
+    // HTTP range request on a high-RTT link
+    std::vector<Range> merged;
+    for ( std::vector<Range>::const_iterator it = sorted.begin(); it != sorted.end(); ++it )
+    {
+        if ( it->end <= it->start )
+            continue;
+        if ( !merged.empty() && it->start <= merged.back().end + rangeCoalesceGap )
+            merged.back().end = (std::max)( merged.back().end, it->end );
+        else
+            merged.push_back( *it );
+    }
+
+    if ( !maxRangeRequestSize )
+        return merged;
+
+    // Split anything larger than the per-request cap so a huge merged range
+    // doesn't monopolize the connection
+    std::vector<Range> out;
+    for ( std::vector<Range>::const_iterator it = merged.begin(); it != merged.end(); ++it )
+    {
+        size_t start = it->start;
+        while ( it->end - start > maxRangeRequestSize )
+        {
+            out.push_back( Range( start, start + maxRangeRequestSize ) );
+            start += maxRangeRequestSize;
+        }
+        out.push_back( Range( start, it->end ) );
+    }
+    return out;
+}
+
+void BrowserStream::setRangeCoalesceGap( size_t gap )
+{
+    rangeCoalesceGap = gap;
+}
+
+size_t BrowserStream::getRangeCoalesceGap() const
+{
+    return rangeCoalesceGap;
+}
+
+void BrowserStream::setMaxRangeRequestSize( size_t maxSize )
+{
+    maxRangeRequestSize = maxSize;
+}
+
+size_t BrowserStream::getMaxRangeRequestSize() const
+{
+    return maxRangeRequestSize;
+}
+
+void BrowserStream::setProgressInterval( unsigned int intervalMs )
+{
+    progressIntervalMs = intervalMs;
+}
+
+unsigned int BrowserStream::getProgressInterval() const
+{
+    return progressIntervalMs;
+}
+
+void BrowserStream::setProgressMinDelta( float percent )
+{
+    progressMinDelta = percent;
+}
+
+float BrowserStream::getProgressMinDelta() const
+{
+    return progressMinDelta;
+}
+
+void BrowserStream::setBlockCacheSize( size_t maxBytes )
+{
+    if ( !maxBytes )
+        blockCache.reset();
+    else
+        blockCache.reset( new StreamBlockCache( maxBytes ) );
+}
+
+size_t BrowserStream::getBlockCacheHits() const
+{
+    return blockCacheHits;
+}
+
+size_t BrowserStream::getBlockCacheMisses() const
+{
+    return blockCacheMisses;
+}
+
+void BrowserStream::cacheArrivedData( const void* data, size_t len, size_t offset )
+{
+    if ( blockCache )
+        blockCache->insert( data, len, offset );
+}
+
+void BrowserStream::reportProgress( size_t bytesReceived )
+{
+    float pct = 0;
+    if ( length )
+        pct = float( bytesReceived ) / float( length ) * 100.f;
+
+    const bool final = length && bytesReceived >= length;
+    const boost::posix_time::ptime now( boost::posix_time::microsec_clock::universal_time() );
+
+    // throttle everything between the first and the final notification
+    if ( !final && lastProgressPct >= 0 )
+    {
+        if ( progressIntervalMs
+             && (now - lastProgressTime).total_milliseconds() < progressIntervalMs )
+            return;
+        if ( length && pct - lastProgressPct < progressMinDelta )
+            return;
+    }
+
+    lastProgressPct = pct;
+    lastProgressTime = now;
+
+    StreamProgressEvent ev( this, pct, bytesReceived );
+    SendEvent( &ev );
+}
+
+MappedCacheViewPtr BrowserStream::mapCache() const
+{
+    if ( !isCached() || !isCompleted() )
+        return MappedCacheViewPtr();
+    const std::wstring filename( getCacheFilename() );
+    if ( filename.empty() )
+        return MappedCacheViewPtr();
+    return MappedCacheView::map( filename );
+}
+
+MappedCacheView::MappedCacheView( const char* data, size_t size, void* fileHandle, void* mapHandle )
+  : m_data(data)
+  , m_size(size)
+  , m_fileHandle(fileHandle)
+  , m_mapHandle(mapHandle)
+{
+}
+
+#ifdef FB_WIN
+
+MappedCacheViewPtr MappedCacheView::map( const std::wstring& filename )
+{
+    HANDLE file = ::CreateFileW( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if ( file == INVALID_HANDLE_VALUE )
+        return MappedCacheViewPtr();
+
+    LARGE_INTEGER fileSize;
+    if ( !::GetFileSizeEx( file, &fileSize ) || !fileSize.QuadPart
+         || static_cast<ULONGLONG>(fileSize.QuadPart) > (std::numeric_limits<size_t>::max)() ) {
+        ::CloseHandle( file );
+        return MappedCacheViewPtr();
+    }
+
+    HANDLE mapping = ::CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    if ( !mapping ) {
+        ::CloseHandle( file );
+        return MappedCacheViewPtr();
+    }
+
+    const void* view = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    if ( !view ) {
+        ::CloseHandle( mapping );
+        ::CloseHandle( file );
+        return MappedCacheViewPtr();
+    }
+
+    return MappedCacheViewPtr( new MappedCacheView( static_cast<const char*>(view),
+        static_cast<size_t>(fileSize.QuadPart), file, mapping ) );
+}
+
+MappedCacheView::~MappedCacheView()
+{
+    ::UnmapViewOfFile( m_data );
+    ::CloseHandle( m_mapHandle );
+    ::CloseHandle( m_fileHandle );
+}
+
+#else
+
+MappedCacheViewPtr MappedCacheView::map( const std::wstring& filename )
+{
+    const std::string narrow( FB::wstring_to_utf8( filename ) );
+    int fd = ::open( narrow.c_str(), O_RDONLY );
+    if ( fd < 0 )
+        return MappedCacheViewPtr();
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) || !st.st_size ) {
+        ::close( fd );
+        return MappedCacheViewPtr();
+    }
+
+    void* view = ::mmap( NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0 );
+    // The mapping keeps its own reference to the file; the descriptor can go
+    ::close( fd );
+    if ( view == MAP_FAILED )
+        return MappedCacheViewPtr();
+
+    return MappedCacheViewPtr( new MappedCacheView( static_cast<const char*>(view),
+        static_cast<size_t>(st.st_size), NULL, NULL ) );
+}
+
+MappedCacheView::~MappedCacheView()
+{
+    ::munmap( const_cast<char*>(m_data), m_size );
+}
+
+#endif
+
 std::string BrowserStream::getUrl() const
 {
     return url;
@@ -100,6 +381,13 @@ size_t BrowserStream::getInternalBufferSize() const
     return internalBufferSize;
 }
 
+StreamRingBuffer& BrowserStream::getInternalBuffer()
+{
+    if ( !internalBuffer )
+        internalBuffer.reset( new StreamRingBuffer( internalBufferSize ) );
+    return *internalBuffer;
+}
+
 
 
 void BrowserStream::setSeekableByServer(bool SeekableByServer)
@@ -17,13 +17,53 @@ Copyright 2010 PacketPass, Inc and the Firebreath development team
 #define H_FB_BROWSERSTREAM
 
 #include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include "APITypes.h"
+#include "StreamRingBuffer.h"
+#include "StreamBlockCache.h"
 #include "PluginEventSource.h"
 #include "PluginEventSink.h"
 #include "PluginEvents/StreamEvents.h"
 
 namespace FB {
     FB_FORWARD_PTR(BrowserStream);
+    FB_FORWARD_PTR(MappedCacheView);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  MappedCacheView
+    ///
+    /// @brief  Read-only memory-mapped view of a cached stream's file
+    ///
+    /// Returned by BrowserStream::mapCache; the mapping stays valid for the lifetime of this
+    /// object and reads go straight through the OS page cache, so demuxing a large cached file
+    /// never makes a second in-memory copy of data already on disk.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class MappedCacheView : boost::noncopyable
+    {
+    public:
+        ~MappedCacheView();
+
+        /// First byte of the read-only view
+        const char* data() const { return m_data; }
+        /// Size of the view in bytes
+        size_t size() const { return m_size; }
+
+        /// Maps the given file read-only; returns an empty pointer on failure
+        /// (missing file, zero length, out of address space)
+        static MappedCacheViewPtr map( const std::wstring& filename );
+
+    private:
+        MappedCacheView( const char* data, size_t size, void* fileHandle, void* mapHandle );
+
+        const char* m_data;
+        size_t      m_size;
+        // Opaque platform handles; Win32 file/mapping handles, unused on POSIX
+        void*       m_fileHandle;
+        void*       m_mapHandle;
+    };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @class  BrowserStream
@@ -91,16 +131,82 @@ namespace FB {
         virtual bool    readRange( size_t start, size_t end );
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn virtual bool BrowserStream::readRanges( const std::vector<Range>& ranges ) = 0;
+        /// @fn virtual bool BrowserStream::readRanges( const std::vector<Range>& ranges );
         ///
-        /// @brief  Same functionality as BrowserStream::readRange( size_t start, size_t end ), except 
+        /// @brief  Same functionality as BrowserStream::readRange( size_t start, size_t end ), except
         ///         multiple ranges can be requested at once.
         ///
+        /// The ranges are ordered by offset and near-adjacent ones are merged before being handed to
+        /// the host, so a demuxer issuing dozens of small neighbouring reads costs a handful of HTTP
+        /// range requests instead of one apiece.  See setRangeCoalesceGap and setMaxRangeRequestSize
+        /// to tune (or disable) the merging.
+        ///
         /// @author Matthias
         ///
         /// @return false on error, else true
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        virtual bool    readRanges( const std::vector<Range>& ranges ) = 0;
+        virtual bool    readRanges( const std::vector<Range>& ranges );
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setRangeCoalesceGap( size_t gap )
+        ///
+        /// @brief  Sets the byte gap within which neighbouring ranges passed to readRanges are merged
+        ///         into one request; 0 merges only overlapping/adjacent ranges
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setRangeCoalesceGap( size_t gap );
+        size_t getRangeCoalesceGap() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setMaxRangeRequestSize( size_t maxSize )
+        ///
+        /// @brief  Sets the size above which a (possibly merged) range is split into multiple
+        ///         requests; 0 (the default) never splits
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setMaxRangeRequestSize( size_t maxSize );
+        size_t getMaxRangeRequestSize() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setProgressInterval( unsigned int intervalMs )
+        ///
+        /// @brief  Sets the minimum time between StreamProgressEvent notifications in milliseconds
+        ///         (default 100, i.e. at most ~10Hz); 0 fires on every chunk
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setProgressInterval( unsigned int intervalMs );
+        unsigned int getProgressInterval() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setProgressMinDelta( float percent )
+        ///
+        /// @brief  Sets the minimum progress change in percent between StreamProgressEvent
+        ///         notifications (default 1.0); 0 disables the delta check
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setProgressMinDelta( float percent );
+        float getProgressMinDelta() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setBlockCacheSize( size_t maxBytes )
+        ///
+        /// @brief  Enables a per-stream LRU block cache of the given byte budget (0, the default,
+        ///         disables it)
+        ///
+        /// With the cache enabled, data arriving from the host is retained in aligned blocks and a
+        /// readRange / readRanges request that falls entirely within cached bytes is answered
+        /// synchronously from memory -- the StreamDataArrivedEvent fires from inside the call --
+        /// instead of going back to the network.  Demuxers that re-read the same index and header
+        /// ranges repeatedly turn those repeats into memory reads.  See getBlockCacheHits /
+        /// getBlockCacheMisses for effectiveness counters.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setBlockCacheSize( size_t maxBytes );
+
+        /// Ranges served from the block cache without a host request
+        size_t getBlockCacheHits() const;
+        /// Ranges that missed the block cache and went to the host
+        size_t getBlockCacheMisses() const;
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual bool BrowserStream::write(const char* data, size_t dataLength, size_t& written) = 0;
@@ -234,6 +340,20 @@ namespace FB {
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual size_t getInternalBufferSize() const;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual StreamRingBuffer& BrowserStream::getInternalBuffer();
+        ///
+        /// @brief  Returns the stream's internal ring buffer, creating it on first use
+        ///
+        /// The buffer holds at least getInternalBufferSize() bytes (rounded up to a power of two).
+        /// Hosts write arriving data into it and consumers read it back in place through
+        /// StreamRingBuffer::peek / consume, so no compaction copies happen between the two.
+        /// Changing the buffer size via setInternalBufferSize only affects a buffer that has not
+        /// been created yet.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual StreamRingBuffer& getInternalBuffer();
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual size_t BrowserStream::getLength() const;
         ///
@@ -243,7 +363,55 @@ namespace FB {
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual size_t getLength() const;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual MappedCacheViewPtr BrowserStream::mapCache() const;
+        ///
+        /// @brief  Returns a read-only memory-mapped view of the stream's cache file
+        ///
+        /// Only meaningful for cached streams once StreamCompletedEvent has fired; before that (or
+        /// for non-cached streams) an empty pointer is returned.  The view reads the file through
+        /// the OS page cache with no copy, so it is the cheapest way to demux a large download.
+        ///
+        /// @return shared_ptr to the view, or an empty pointer if the stream has no complete cache file
+        /// @see getCacheFilename
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual MappedCacheViewPtr mapCache() const;
+
     protected:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool BrowserStream::doReadRanges( const std::vector<Range>& ranges ) = 0;
+        ///
+        /// @brief  Host-specific backend for readRanges; receives the ranges already ordered by
+        ///         offset, coalesced and split per the stream's settings
+        ///
+        /// @return false on error, else true
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool    doReadRanges( const std::vector<Range>& ranges ) = 0;
+
+        /// Orders ranges by offset, merges those within the coalesce gap and splits
+        /// any merged range larger than the max request size
+        std::vector<Range> prepareRanges( const std::vector<Range>& ranges ) const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void BrowserStream::reportProgress( size_t bytesReceived )
+        ///
+        /// @brief  Called by host streams as data arrives; sends a StreamProgressEvent when the
+        ///         min-interval/min-delta throttle allows it (always for the first and the final
+        ///         notification)
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void reportProgress( size_t bytesReceived );
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void BrowserStream::cacheArrivedData( const void* data, size_t len, size_t offset )
+        ///
+        /// @brief  Called by host streams as data arrives to populate the block cache; a no-op
+        ///         unless setBlockCacheSize has enabled it
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void cacheArrivedData( const void* data, size_t len, size_t offset );
+
         // property setters
         virtual void setUrl(const std::string& url);
         virtual void setSeekableByServer(bool seekable);
@@ -269,6 +437,16 @@ namespace FB {
         bool            completed;
         bool            opened;
         std::string     headers;
+        size_t          rangeCoalesceGap;
+        size_t          maxRangeRequestSize;
+        boost::scoped_ptr<StreamRingBuffer> internalBuffer;
+        unsigned int    progressIntervalMs;
+        float           progressMinDelta;
+        float           lastProgressPct;        // -1 until the first notification fires
+        boost::posix_time::ptime lastProgressTime;
+        boost::scoped_ptr<StreamBlockCache> blockCache;
+        size_t          blockCacheHits;
+        size_t          blockCacheMisses;
     };
 };
 
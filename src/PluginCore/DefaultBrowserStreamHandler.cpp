@@ -18,6 +18,7 @@ using namespace FB;
 
 // default stream handler
 DefaultBrowserStreamHandler::DefaultBrowserStreamHandler()
+  : batchThreshold(0), batchStartPos(0)
 {
 }
 
@@ -34,13 +35,95 @@ bool DefaultBrowserStreamHandler::onStreamCreated(FB::StreamCreatedEvent *evt, F
 
 bool DefaultBrowserStreamHandler::onStreamDestroyed(FB::StreamDestroyedEvent *evt, FB::BrowserStream *)
 {
+    flushBatchedData();
     clearStream();
     return false;
 }
 
 bool DefaultBrowserStreamHandler::onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *)
 {
-    // process data
+    if ( !batchThreshold || !stream )
+    {
+        // process data
+        return false;
+    }
+
+    StreamRingBuffer& buffer = stream->getInternalBuffer();
+
+    // a non-contiguous chunk (seekable range read) can't join the staged run
+    if ( !buffer.empty() && evt->getDataPosition() != batchStartPos + buffer.size() )
+        flushBatchedData();
+
+    if ( buffer.empty() )
+        batchStartPos = evt->getDataPosition();
+
+    if ( evt->getLength() > buffer.freeSpace() )
+        flushBatchedData();
+
+    if ( evt->getLength() > buffer.capacity() )
+    {
+        // chunk is bigger than the ring; hand it through as its own batch, no staging copy
+        std::vector<DataSpan> spans(1);
+        spans[0].data = evt->getData();
+        spans[0].length = evt->getLength();
+        spans[0].position = evt->getDataPosition();
+        onStreamDataBatch(spans);
+        batchStartPos = evt->getDataPosition() + evt->getLength();
+        return true;
+    }
+
+    if ( buffer.empty() )
+        batchStartPos = evt->getDataPosition();
+    buffer.write(evt->getData(), evt->getLength());
+
+    if ( buffer.size() >= batchThreshold )
+        flushBatchedData();
+    return true;
+}
+
+void DefaultBrowserStreamHandler::flushBatchedData()
+{
+    if ( !stream )
+        return;
+    StreamRingBuffer& buffer = stream->getInternalBuffer();
+    if ( buffer.empty() )
+        return;
+
+    // Consuming only advances the read counter; nothing writes into the ring
+    // during the callback, so the span pointers stay valid for its duration
+    std::vector<DataSpan> spans;
+    size_t position = batchStartPos;
+    while ( !buffer.empty() )
+    {
+        DataSpan span;
+        span.data = buffer.peek(span.length);
+        span.position = position;
+        spans.push_back(span);
+        position += span.length;
+        buffer.consume(span.length);
+    }
+    batchStartPos = position;
+    onStreamDataBatch(spans);
+}
+
+bool DefaultBrowserStreamHandler::onStreamDataBatch(const std::vector<DataSpan>& spans)
+{
+    // process batched data
+    return false;
+}
+
+void DefaultBrowserStreamHandler::setBatchingThreshold(size_t bytes)
+{
+    batchThreshold = bytes;
+}
+
+size_t DefaultBrowserStreamHandler::getBatchingThreshold() const
+{
+    return batchThreshold;
+}
+
+bool DefaultBrowserStreamHandler::onStreamProgress(FB::StreamProgressEvent *evt, FB::BrowserStream *)
+{
     return false;
 }
 
@@ -56,6 +139,7 @@ bool DefaultBrowserStreamHandler::onStreamOpened(FB::StreamOpenedEvent *evt, FB:
 
 bool DefaultBrowserStreamHandler::onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *)
 {
+     flushBatchedData();
      return false;
 }
 
@@ -41,6 +41,7 @@ namespace FB {
             EVENTTYPE_CASE(FB::StreamFailedOpenEvent, onStreamFailedOpen, FB::BrowserStream)
             EVENTTYPE_CASE(FB::StreamOpenedEvent, onStreamOpened, FB::BrowserStream)
             EVENTTYPE_CASE(FB::StreamDataArrivedEvent, onStreamDataArrived, FB::BrowserStream)
+            EVENTTYPE_CASE(FB::StreamProgressEvent, onStreamProgress, FB::BrowserStream)
             EVENTTYPE_CASE(FB::StreamCompletedEvent, onStreamCompleted, FB::BrowserStream)
         END_PLUGIN_EVENT_MAP()
 
@@ -86,10 +87,22 @@ namespace FB {
         ///
         /// @brief  Called when data arrives.
         ///
+        /// When batching is enabled (see setBatchingThreshold) the default implementation stages
+        /// the chunk in the stream's internal ring buffer and fires onStreamDataBatch once enough
+        /// bytes have accumulated, instead of handing every browser chunk through individually.
+        ///
         /// @author Matthias
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual bool onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool DefaultBrowserStreamHandler::onStreamProgress(FB::StreamProgressEvent *evt, FB::BrowserStream * Stream);
+        ///
+        /// @brief  Called with throttled download progress; see BrowserStream::setProgressInterval
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool onStreamProgress(FB::StreamProgressEvent *evt, FB::BrowserStream *);
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual bool DefaultBrowserStreamHandler::onStreamFailedOpen(FB::StreamFailedOpenEvent *evt, FB::BrowserStream * Stream);
         ///
@@ -126,7 +139,58 @@ namespace FB {
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual FB::BrowserStreamPtr getStream() const;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @struct DataSpan
+        ///
+        /// @brief  One contiguous run of stream bytes inside a batched delivery
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        struct DataSpan
+        {
+            const void* data;       ///< first byte of the span; valid only during onStreamDataBatch
+            size_t      length;     ///< span length in bytes
+            size_t      position;   ///< offset of the span within the stream
+        };
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void DefaultBrowserStreamHandler::setBatchingThreshold(size_t bytes)
+        ///
+        /// @brief  Enables batched delivery: chunks accumulate in the stream's internal ring buffer
+        ///         until at least this many bytes are staged, then arrive together through
+        ///         onStreamDataBatch
+        ///
+        /// 0 (the default) disables batching and keeps the per-chunk onStreamDataArrived behavior.
+        /// Staged data is flushed when the threshold is reached, when a non-contiguous chunk
+        /// arrives, and when the stream completes or is destroyed, so nothing is held back
+        /// indefinitely.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setBatchingThreshold(size_t bytes);
+        size_t getBatchingThreshold() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool DefaultBrowserStreamHandler::onStreamDataBatch(const std::vector<DataSpan>& spans)
+        ///
+        /// @brief  Called with the staged data when a batch flushes; override this instead of
+        ///         onStreamDataArrived when batching is enabled
+        ///
+        /// The spans are in stream order and usually one or two entries (two when the staged data
+        /// wraps around the ring buffer).  The pointers reference the ring buffer directly -- no
+        /// copy is made -- and are only valid for the duration of the call.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool onStreamDataBatch(const std::vector<DataSpan>& spans);
+
     protected:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void DefaultBrowserStreamHandler::flushBatchedData()
+        ///
+        /// @brief  Delivers any staged data immediately; subclasses that override
+        ///         onStreamCompleted without calling the base implementation should call this first
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void flushBatchedData();
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void DefaultBrowserStreamHandler::setStream(FB::BrowserStream* stream);
         ///
@@ -146,6 +210,10 @@ namespace FB {
         virtual void clearStream();
 
         BrowserStreamPtr stream;  ///< stream instance, don't use yourself
+
+    private:
+        size_t batchThreshold;    ///< 0 = per-chunk delivery, else flush size in bytes
+        size_t batchStartPos;     ///< stream offset of the first staged byte
     };
 }
 #endif // DefaultBrowserStreamHandler_h__
\ No newline at end of file
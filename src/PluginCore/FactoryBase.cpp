@@ -12,7 +12,10 @@
  Copyright 2010 Georg Fritzsche, Firebreath development team
  \**********************************************************/
 
+#include <boost/make_shared.hpp>
 #include "FactoryBase.h"
+#include "ThreadPool.h"
+#include "ProcessChannel.h"
 #include "ConstructDefaultPluginWindows.h"
 #include "NpapiPluginFactory.h"
 #ifdef FB_WIN
@@ -40,22 +43,22 @@ void FB::FactoryBase::globalPluginDeinitialize()
     
 }
 
-std::string FB::FactoryBase::getPluginName()
+const std::string& FB::FactoryBase::getPluginName()
 {
     return FB::getPluginName("");
 }
 
-std::string FB::FactoryBase::getPluginName( const std::string& mimetype )
+const std::string& FB::FactoryBase::getPluginName( const std::string& mimetype )
 {
     return FB::getPluginName(mimetype);
 }
 
-std::string FB::FactoryBase::getPluginDescription()
+const std::string& FB::FactoryBase::getPluginDescription()
 {
     return FB::getPluginDescription("");
 }
 
-std::string FB::FactoryBase::getPluginDescription( const std::string& mimetype )
+const std::string& FB::FactoryBase::getPluginDescription( const std::string& mimetype )
 {
     return FB::getPluginDescription(mimetype);
 }
@@ -77,6 +80,42 @@ FB::Log::LogLevel FB::FactoryBase::getLogLevel()
     return FB::Log::LogLevel_Info;
 }
 
+FB::ThreadPoolPtr FB::FactoryBase::getThreadPool()
+{
+    boost::mutex::scoped_lock lock(m_threadPoolMutex);
+    if (!m_threadPool) {
+        m_threadPool = boost::make_shared<ThreadPool>(getWorkerPoolSize());
+    }
+    return m_threadPool;
+}
+
+size_t FB::FactoryBase::getWorkerPoolSize()
+{
+    return 0;   // 0 = size the pool to the machine's core count
+}
+
+FB::ProcessChannelPtr FB::FactoryBase::getProcessChannel()
+{
+    boost::mutex::scoped_lock lock(m_processChannelMutex);
+    if (!m_processChannel) {
+        try {
+            m_processChannel = boost::make_shared<ProcessChannel>(getProcessChannelName());
+            m_processChannel->start();
+        } catch (const std::exception& e) {
+            // no shared memory (or a full channel) just means no fast path;
+            // callers fall back to whatever transport they used before
+            FBLOG_WARN("FactoryBase", "Could not open process channel: " << e.what());
+            m_processChannel.reset();
+        }
+    }
+    return m_processChannel;
+}
+
+std::string FB::FactoryBase::getProcessChannelName()
+{
+    return getPluginName();
+}
+
 
 #ifdef FB_WIN
 FB::PluginWindowWin* FB::FactoryBase::createPluginWindowWin(const WindowContextWin& ctx)
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/utility.hpp>
 #include "APITypes.h"
 #include "FBPointers.h"
@@ -31,6 +32,8 @@ namespace FB
     FB_FORWARD_PTR(PluginCore);
     FB_FORWARD_PTR(BrowserHost);
     FB_FORWARD_PTR(JSAPI);
+    FB_FORWARD_PTR(ThreadPool);
+    FB_FORWARD_PTR(ProcessChannel);
     /// @brief  Defines an alias representing a boost::shared_ptr<FactoryBase>
     typedef boost::shared_ptr<FactoryBase> FactoryBasePtr;
 
@@ -151,27 +154,27 @@ namespace FB
         virtual void                        globalPluginDeinitialize();
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn std::string FactoryBase::getPluginName()
+        /// @fn const std::string& FactoryBase::getPluginName()
         ///
         /// @brief  Returns the name of the plugin.  To change the name of your plugin edit
         ///         PluginConfig.cmake
         ///
-        /// @return The plugin name. 
+        /// @return Reference to the plugin name; valid for the lifetime of the module
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        std::string                         getPluginName();
+        const std::string&                  getPluginName();
         /// @overload
-        std::string                         getPluginName(const std::string& mimetype);
+        const std::string&                  getPluginName(const std::string& mimetype);
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn std::string FactoryBase::getPluginDescription()
+        /// @fn const std::string& FactoryBase::getPluginDescription()
         ///
         /// @brief  Returns the description of the plugin.  To change the description of your plugin edit
         ///         PluginConfig.cmake
         ///
-        /// @return The plugin description 
+        /// @return Reference to the plugin description; valid for the lifetime of the module
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        std::string                         getPluginDescription();
+        const std::string&                  getPluginDescription();
         /// @overload
-        std::string                         getPluginDescription(const std::string& mimetype);
+        const std::string&                  getPluginDescription(const std::string& mimetype);
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual FB::Npapi::NpapiPluginPtr createNpapiPlugin(const FB::Npapi::NpapiBrowserHostPtr& host, const std::string& mimetype)
@@ -205,6 +208,62 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual FB::Log::LogLevel getLogLevel();
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn ThreadPoolPtr getThreadPool()
+        ///
+        /// @brief  Returns the framework's shared worker thread pool, creating it on first use
+        ///
+        /// Every plugin instance in the process gets the same pool, sized by getWorkerPoolSize(),
+        /// so background work (image decodes, file scans, etc.) shares one correctly-sized set of
+        /// workers instead of each plugin spinning up its own threads.
+        ///
+        /// @return shared_ptr to the ThreadPool
+        /// @see ThreadPool
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        ThreadPoolPtr getThreadPool();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual size_t getWorkerPoolSize()
+        ///
+        /// @brief  Called when the shared thread pool is created to decide how many workers to start
+        ///
+        /// Override to pin the pool size; the default of 0 sizes it to the machine's core count.
+        ///
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual size_t getWorkerPoolSize();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn ProcessChannelPtr getProcessChannel()
+        ///
+        /// @brief  Returns the shared-memory channel to this plugin's instances in other
+        ///         processes, creating and starting it on first use
+        ///
+        /// Every instance in the process shares one channel, named by getProcessChannelName(),
+        /// so instances split across browser processes can coordinate in microseconds instead
+        /// of going through a loopback service.  Returns an empty pointer if the channel cannot
+        /// be opened (shared memory unavailable, all peer slots taken); callers must treat that
+        /// as "no peers".
+        ///
+        /// @return shared_ptr to the ProcessChannel, or empty on failure
+        /// @see ProcessChannel
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        ProcessChannelPtr getProcessChannel();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual std::string getProcessChannelName()
+        ///
+        /// @brief  Called when the process channel is created to name the shared segment
+        ///
+        /// Defaults to the plugin name, which joins every process hosting this plugin into one
+        /// channel; override to partition instances into separate channels.
+        ///
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual std::string getProcessChannelName();
+
 #ifdef FB_WIN
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual PluginWindowWin* FactoryBase::createPluginWindowWin(const WindowContextWin&)
@@ -291,8 +350,16 @@ namespace FB
         ///
         /// @return A pointer to the object that should handle the plugin window
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        virtual PluginWindowX11* createPluginWindowX11(const WindowContextX11&); 
+        virtual PluginWindowX11* createPluginWindowX11(const WindowContextX11&);
 #endif
+
+    protected:
+        boost::mutex m_threadPoolMutex;
+        // The process-wide worker pool; created lazily by getThreadPool()
+        ThreadPoolPtr m_threadPool;
+        boost::mutex m_processChannelMutex;
+        // The process-wide interprocess channel; created lazily by getProcessChannel()
+        ProcessChannelPtr m_processChannel;
     };
 }
 
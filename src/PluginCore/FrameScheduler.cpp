@@ -0,0 +1,169 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <boost/bind.hpp>
+
+#include "FrameScheduler.h"
+
+using namespace FB;
+using boost::posix_time::ptime;
+using boost::posix_time::time_duration;
+using boost::posix_time::microseconds;
+using boost::posix_time::microsec_clock;
+
+FrameScheduler& FrameScheduler::getInstance()
+{
+    static FrameScheduler scheduler;
+    return scheduler;
+}
+
+FrameScheduler::FrameScheduler()
+    : m_nextId(1), m_firingId(0), m_threadStarted(false), m_stop(false)
+{
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_stop = true;
+        m_wake.notify_all();
+    }
+    if (m_threadStarted)
+        m_thread.join();
+}
+
+void FrameScheduler::ensureThread()
+{
+    // caller holds m_mutex
+    if (!m_threadStarted) {
+        m_epoch = microsec_clock::universal_time();
+        m_thread = boost::thread(boost::bind(&FrameScheduler::run, this));
+        m_threadStarted = true;
+    }
+}
+
+unsigned int FrameScheduler::add(const FrameCallback& cb, unsigned int fps, bool paused)
+{
+    if (!fps)
+        fps = 60;
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    ensureThread();
+    unsigned int id = m_nextId++;
+    Client& c = m_clients[id];
+    c.cb = cb;
+    c.interval = microseconds(1000000 / fps);
+    c.paused = paused;
+    m_wake.notify_all();
+    return id;
+}
+
+void FrameScheduler::remove(unsigned int id)
+{
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    m_clients.erase(id);
+    // don't return while the scheduler thread is still inside this client's
+    // callback; after this the caller may safely tear down whatever it targets
+    while (m_firingId == id)
+        m_wake.wait(lock);
+    m_wake.notify_all();
+}
+
+void FrameScheduler::setPaused(unsigned int id, bool paused)
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    ClientMap::iterator it = m_clients.find(id);
+    if (it == m_clients.end() || it->second.paused == paused)
+        return;
+    it->second.paused = paused;
+    // realign on resume rather than firing a burst of "missed" frames
+    it->second.next = ptime();
+    m_wake.notify_all();
+}
+
+void FrameScheduler::setRate(unsigned int id, unsigned int fps)
+{
+    if (!fps)
+        fps = 60;
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    ClientMap::iterator it = m_clients.find(id);
+    if (it == m_clients.end())
+        return;
+    it->second.interval = microseconds(1000000 / fps);
+    it->second.next = ptime();
+    m_wake.notify_all();
+}
+
+void FrameScheduler::run()
+{
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while (!m_stop) {
+        ptime now = microsec_clock::universal_time();
+
+        // fire everything that is due; deadlines are aligned to the shared
+        // epoch, so clients at the same rate come due together and one pass
+        // through here serves all of them from a single wakeup
+        bool fired = true;
+        while (fired && !m_stop) {
+            fired = false;
+            for (ClientMap::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+                Client& c = it->second;
+                if (c.paused)
+                    continue;
+                if (c.next.is_not_a_date_time()) {
+                    // align to the epoch grid for this client's rate
+                    long long behind = (now - m_epoch).total_microseconds();
+                    long long step = c.interval.total_microseconds();
+                    c.next = m_epoch + microseconds(((behind / step) + 1) * step);
+                    continue;
+                }
+                if (c.next > now)
+                    continue;
+                while (c.next <= now)
+                    c.next += c.interval;
+                FrameCallback cb = c.cb;
+                m_firingId = it->first;
+                lock.unlock();
+                try {
+                    cb();
+                } catch (...) {
+                    // a throwing frame callback must not take the thread down
+                }
+                lock.lock();
+                m_firingId = 0;
+                m_wake.notify_all();
+                // the map may have changed while unlocked; rescan
+                fired = true;
+                break;
+            }
+        }
+        if (m_stop)
+            break;
+
+        // sleep until the earliest unpaused deadline, or indefinitely when
+        // nothing is runnable -- an idle process generates no wakeups
+        ptime soonest;
+        for (ClientMap::iterator it = m_clients.begin(); it != m_clients.end(); ++it) {
+            Client& c = it->second;
+            if (c.paused || c.next.is_not_a_date_time())
+                continue;
+            if (soonest.is_not_a_date_time() || c.next < soonest)
+                soonest = c.next;
+        }
+        if (soonest.is_not_a_date_time())
+            m_wake.wait(lock);
+        else
+            m_wake.timed_wait(lock, soonest);
+    }
+}
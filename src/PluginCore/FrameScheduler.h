@@ -0,0 +1,95 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_FRAMESCHEDULER
+#define H_FB_FRAMESCHEDULER
+
+#include <map>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  FrameScheduler
+    ///
+    /// @brief  Process-wide driver for periodic plugin redraw callbacks
+    ///
+    /// Plugins that animate have historically each created their own OS timer, so N instances
+    /// mean N wakeups that drift apart over time.  This class runs one timer thread for the
+    /// whole process: each client registers an onFrame callback with a target rate, deadlines
+    /// are aligned to a common epoch so clients at the same rate fire from the same wakeup,
+    /// and paused clients cost nothing.  PluginCore pauses and resumes its client
+    /// automatically as the browser attaches and detaches the PluginWindow.
+    ///
+    /// Callbacks run on the scheduler thread; use BrowserHost::ScheduleAsyncCall (or just
+    /// invalidate the window) if the work must reach the main thread.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class FrameScheduler : boost::noncopyable
+    {
+    public:
+        typedef boost::function<void ()> FrameCallback;
+
+        static FrameScheduler& getInstance();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn unsigned int FrameScheduler::add(const FrameCallback& cb, unsigned int fps, bool paused)
+        ///
+        /// @brief  Registers a callback to be driven at up to fps frames per second
+        ///
+        /// @return an id used with remove / setPaused / setRate
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int add(const FrameCallback& cb, unsigned int fps, bool paused = false);
+
+        /// Unregisters a client; blocks until any in-flight callback for it has returned
+        void remove(unsigned int id);
+
+        /// A paused client keeps its registration but generates no wakeups
+        void setPaused(unsigned int id, bool paused);
+
+        void setRate(unsigned int id, unsigned int fps);
+
+    private:
+        FrameScheduler();
+        ~FrameScheduler();
+        void run();
+        void ensureThread();
+
+        struct Client {
+            FrameCallback cb;
+            boost::posix_time::time_duration interval;
+            boost::posix_time::ptime next;
+            bool paused;
+        };
+        typedef std::map<unsigned int, Client> ClientMap;
+
+        boost::mutex m_mutex;
+        boost::condition_variable m_wake;
+        ClientMap m_clients;
+        unsigned int m_nextId;
+        unsigned int m_firingId;    // client whose callback is currently running (0 = none)
+        boost::posix_time::ptime m_epoch;
+        boost::thread m_thread;
+        bool m_threadStarted;
+        bool m_stop;
+    };
+};
+
+#endif
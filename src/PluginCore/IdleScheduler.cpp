@@ -0,0 +1,121 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "IdleScheduler.h"
+
+using namespace FB;
+
+IdleScheduler& IdleScheduler::getInstance()
+{
+    static IdleScheduler scheduler;
+    return scheduler;
+}
+
+IdleScheduler::IdleScheduler()
+    : m_nextId(0), m_cursor(0),
+      m_lastActivity(boost::posix_time::microsec_clock::universal_time()),
+      m_lastRun(boost::posix_time::min_date_time),
+      m_quietThresholdMs(100), m_sliceBudgetUs(2000)
+{
+}
+
+unsigned int IdleScheduler::add(const IdleTask& task)
+{
+    boost::mutex::scoped_lock _l(m_mutex);
+    unsigned int id = ++m_nextId;
+    m_tasks[id] = task;
+    return id;
+}
+
+void IdleScheduler::remove(unsigned int id)
+{
+    boost::mutex::scoped_lock _l(m_mutex);
+    m_tasks.erase(id);
+}
+
+void IdleScheduler::noteActivity()
+{
+    boost::mutex::scoped_lock _l(m_mutex);
+    m_lastActivity = boost::posix_time::microsec_clock::universal_time();
+}
+
+void IdleScheduler::setQuietThreshold(unsigned int ms)
+{
+    boost::mutex::scoped_lock _l(m_mutex);
+    m_quietThresholdMs = ms;
+}
+
+void IdleScheduler::setSliceBudget(unsigned int us)
+{
+    boost::mutex::scoped_lock _l(m_mutex);
+    m_sliceBudgetUs = us;
+}
+
+void IdleScheduler::tick()
+{
+    using namespace boost::posix_time;
+    const ptime start(microsec_clock::universal_time());
+    time_duration budget;
+    {
+        boost::mutex::scoped_lock _l(m_mutex);
+        if (m_tasks.empty())
+            return;
+        // Quiet check: recent activity means the user is (or just was) waiting
+        // on this thread; maintenance keeps out of the way
+        if (start - m_lastActivity < milliseconds(m_quietThresholdMs))
+            return;
+        // Several plugin instances may each drive a tick timer; collapse
+        // near-simultaneous ticks into one slice
+        if (start - m_lastRun < milliseconds(10))
+            return;
+        m_lastRun = start;
+        budget = microseconds(m_sliceBudgetUs);
+    }
+
+    // Round-robin through the tasks, one increment each, until the budget is
+    // spent or a full lap reports no work.  Tasks run unlocked so they can
+    // add/remove freely
+    size_t consecutiveIdle = 0;
+    for (;;) {
+        IdleTask task;
+        size_t taskCount;
+        {
+            boost::mutex::scoped_lock _l(m_mutex);
+            if (m_tasks.empty())
+                return;
+            // Preemption: activity that arrived while a task ran ends the slice
+            if (m_lastActivity > start)
+                return;
+            TaskMap::const_iterator it = m_tasks.upper_bound(m_cursor);
+            if (it == m_tasks.end())
+                it = m_tasks.begin();
+            m_cursor = it->first;
+            task = it->second;
+            taskCount = m_tasks.size();
+        }
+        bool moreWork(false);
+        try {
+            moreWork = task();
+        } catch (const std::exception&) {
+            // a misbehaving task must not take the slice down with it
+        }
+        consecutiveIdle = moreWork ? 0 : consecutiveIdle + 1;
+        if (microsec_clock::universal_time() - start >= budget)
+            return;
+        if (consecutiveIdle >= taskCount)
+            return;
+    }
+}
@@ -0,0 +1,96 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_IDLESCHEDULER
+#define H_FB_IDLESCHEDULER
+
+#include <map>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  IdleScheduler
+    ///
+    /// @brief  Runs registered maintenance work in bounded slices when the main thread is quiet
+    ///
+    /// Cleanup that happens inline on whatever path triggers it -- retained-object sweeps, cache
+    /// trimming, deferred frees -- shows up as latency spikes in user-facing calls.  Components
+    /// register incremental tasks here instead; PluginCore ticks the scheduler from a recurring
+    /// main-thread timer, and a tick only runs tasks once no activity has been noted for the
+    /// quiet threshold.  Each tick is budget-bounded and re-checks for new activity between
+    /// tasks, so real work preempts maintenance rather than queueing behind it.
+    ///
+    /// A task does one small increment of its work per call and returns true if it has more to
+    /// do right now -- it stays registered either way, and is simply asked again on a later idle
+    /// tick.  Call noteActivity() from latency-sensitive entry points; plugin window events note
+    /// activity automatically.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class IdleScheduler : boost::noncopyable
+    {
+    public:
+        /// Does one increment of maintenance; returns true if more remains right now
+        typedef boost::function<bool ()> IdleTask;
+
+        static IdleScheduler& getInstance();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn unsigned int IdleScheduler::add(const IdleTask& task)
+        ///
+        /// @brief  Registers an incremental maintenance task
+        ///
+        /// @return an id used with remove
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int add(const IdleTask& task);
+
+        /// Unregisters a task; safe to call from inside the task itself
+        void remove(unsigned int id);
+
+        /// Marks the main thread busy; maintenance stays off it for the quiet threshold
+        void noteActivity();
+
+        /// Main-thread driver; runs a budgeted slice of tasks if the thread has been quiet.
+        /// PluginCore calls this from a recurring timer -- most code never needs to
+        void tick();
+
+        /// How long the main thread must be quiet before maintenance runs (default 100)
+        void setQuietThreshold(unsigned int ms);
+
+        /// Per-tick time budget for maintenance work in microseconds (default 2000)
+        void setSliceBudget(unsigned int us);
+
+    private:
+        IdleScheduler();
+
+        typedef std::map<unsigned int, IdleTask> TaskMap;
+
+        boost::mutex m_mutex;
+        TaskMap m_tasks;
+        unsigned int m_nextId;
+        // round-robin position so no task starves behind an ever-hungry one
+        unsigned int m_cursor;
+        boost::posix_time::ptime m_lastActivity;
+        boost::posix_time::ptime m_lastRun;
+        unsigned int m_quietThresholdMs;
+        unsigned int m_sliceBudgetUs;
+    };
+};
+
+#endif
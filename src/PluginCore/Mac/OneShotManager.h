@@ -47,6 +47,9 @@ namespace FB
         typedef FB::SafeQueue<SinkPair> SinkQueue;
         SinkQueue m_sinks;
         mutable boost::mutex m_mutex;
+        // True while a main-thread dispatch is queued; one dispatch per
+        // run-loop pass drains every pending sink
+        bool m_dispatchPending;
     };
 }
 
@@ -71,9 +71,9 @@ namespace
     }
 }
 
-FB::OneShotManager::OneShotManager()
+FB::OneShotManager::OneShotManager() : m_dispatchPending(false)
 {
-    
+
 }
 
 FB::OneShotManager::~OneShotManager()
@@ -85,7 +85,12 @@ void FB::OneShotManager::push(void* npp, OneShotCallback sink)
 {
 	boost::mutex::scoped_lock lock(m_mutex);
     m_sinks.push(std::make_pair(npp, sink));
-    [getHelper(this) performSelectorOnMainThread:@selector(doStuff:) withObject:nil waitUntilDone:NO];
+    // Coalesce: only the first push of a burst queues a main-thread dispatch;
+    // shoot() drains every sink queued before the run loop gets to it
+    if (!m_dispatchPending) {
+        m_dispatchPending = true;
+        [getHelper(this) performSelectorOnMainThread:@selector(doStuff:) withObject:nil waitUntilDone:NO];
+    }
 }
 
 void FB::OneShotManager::clear(void* npp)
@@ -116,9 +121,20 @@ FB::OneShotManager& FB::OneShotManager::getInstance()
 
 void FB::OneShotManager::shoot()
 {
-	SinkPair val;
-    while (m_sinks.try_pop(val))
     {
-        val.second(val.first, 0);
+        // Clear the flag before draining so a sink pushed while we run still
+        // gets its own dispatch
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_dispatchPending = false;
+    }
+	// Drain everything queued with one lock acquisition instead of one per sink
+	std::queue<SinkPair> vals;
+    if (m_sinks.try_pop_all(vals))
+    {
+        while (!vals.empty())
+        {
+            vals.front().second(vals.front().first, 0);
+            vals.pop();
+        }
     }
 }
@@ -19,6 +19,9 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 #include "BrowserHost.h"
 #include "DOM/Window.h"
 #include "logging.h"
+#include "IdleScheduler.h"
+#include "StartupTimeline.h"
+#include <boost/bind.hpp>
 
 #include "PluginCore.h"
 
@@ -43,9 +46,11 @@ void PluginCore::setPlatform(const std::string& os, const std::string& browser)
      Regular Class Stuff
 \***************************/
 
-PluginCore::PluginCore() : m_paramsSet(false), m_Window(NULL)
+PluginCore::PluginCore() : m_paramsSet(false), m_Window(NULL), m_frameClient(0), m_idleTimer(0)
 {
     FB::Log::initLogging();
+    // only the cold-start instance is recorded; mark() ignores re-marks
+    StartupTimeline::getInstance().mark("instanceCreated");
     // This class is only created on the main UI thread,
     // so there is no need for mutexes here
     ++PluginCore::ActivePluginCount;
@@ -53,6 +58,11 @@ PluginCore::PluginCore() : m_paramsSet(false), m_Window(NULL)
 
 PluginCore::~PluginCore()
 {
+    stopFrameUpdates();
+    if (m_idleTimer) {
+        m_host->stopTimer(m_idleTimer);
+        m_idleTimer = 0;
+    }
     // Tell the host that the plugin is shutting down
     m_host->shutdown();
     // This class is only destroyed on the main UI thread,
@@ -107,29 +117,51 @@ PluginWindow* PluginCore::GetWindow() const
 void PluginCore::SetWindow(PluginWindow *win)
 {
     FBLOG_TRACE("PluginCore", "Window Set");
+    StartupTimeline::getInstance().mark("windowAttached");
     if (m_Window && m_Window != win) {
         ClearWindow();
     }
     m_Window = win;
     win->AttachObserver(this);
+    if (m_frameClient)
+        FrameScheduler::getInstance().setPaused(m_frameClient, false);
 }
 
 void PluginCore::ClearWindow()
 {
     FBLOG_TRACE("PluginCore", "Window Cleared");
     if (m_Window) {
+        if (m_frameClient)
+            FrameScheduler::getInstance().setPaused(m_frameClient, true);
         m_Window->DetachObserver(this);
         m_Window = NULL;
     }
 }
 
+void PluginCore::startFrameUpdates(const FrameScheduler::FrameCallback& onFrame, unsigned int fps)
+{
+    stopFrameUpdates();
+    // a hidden plugin shouldn't burn frames; the callback starts paused until
+    // the browser hands us a window
+    m_frameClient = FrameScheduler::getInstance().add(onFrame, fps, m_Window == NULL);
+}
+
+void PluginCore::stopFrameUpdates()
+{
+    if (m_frameClient) {
+        FrameScheduler::getInstance().remove(m_frameClient);
+        m_frameClient = 0;
+    }
+}
+
 // If you override this, you probably want to call it again, since this is what calls back into the page
 // to indicate that we're done.
 void PluginCore::setReady()
 {
     FBLOG_INFO("PluginCore", "Plugin Ready");
+    StartupTimeline::getInstance().mark("pluginReady");
     // Ensure that the JSAPI object has been created, in case the browser hasn't requested it yet.
-    getRootJSAPI(); 
+    getRootJSAPI();
     try {
         FB::VariantMap::iterator fnd = m_params.find("onload");
         if (fnd != m_params.end()) {
@@ -142,6 +174,14 @@ void PluginCore::setReady()
         // Usually this would be if it isn't a JSObjectPtr or the object can't be called
     }
     onPluginReady();
+
+    // Drive the idle maintenance scheduler from a recurring main-thread tick.
+    // Ticks are cheap no-ops unless the thread has been quiet long enough and
+    // some component actually registered maintenance work
+    if (!m_idleTimer && m_host) {
+        m_idleTimer = m_host->startTimer(50,
+            boost::bind(&IdleScheduler::tick, &IdleScheduler::getInstance()), true);
+    }
 }
 
 bool PluginCore::isWindowless()
@@ -156,3 +196,16 @@ bool PluginCore::isWindowless()
     }
     return false;
 }
+
+bool PluginCore::isDeferredWindow()
+{
+    FB::VariantMap::iterator itr = m_params.find("deferwindow");
+    if (itr != m_params.end()) {
+        try {
+            return itr->second.convert_cast<bool>();
+        } catch (const FB::bad_variant_cast& ex) {
+            FB_UNUSED_VARIABLE(ex);
+        }
+    }
+    return false;
+}
@@ -18,6 +18,7 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 
 #include "PluginEventSink.h"
 #include "APITypes.h"
+#include "FrameScheduler.h"
 #include <string>
 #include <set>
 #include "boost/assign.hpp"
@@ -158,6 +159,20 @@ namespace FB {
         virtual void setReady();
         virtual bool isWindowless();
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool PluginCore::isDeferredWindow()
+        ///
+        /// @brief  Returns true if platform window creation should wait until the plugin is visible
+        ///
+        /// Pages embedding many instances pay full window materialization (HWND subclassing and
+        /// the like) for instances that are never scrolled into view.  With a
+        /// &lt;param name="deferwindow" value="true" /&gt; tag the platform window is only created
+        /// once the browser reports a non-empty clip rectangle; until then the instance has its
+        /// JSAPI and fires onload as usual, but costs nothing window-wise.  Defaults to false.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool isDeferredWindow();
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void PluginCore::onPluginReady()
         ///
@@ -267,6 +282,28 @@ namespace FB {
 
         virtual void setParams(const FB::VariantMap& inParams);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginCore::startFrameUpdates(const FrameScheduler::FrameCallback& onFrame, unsigned int fps)
+        ///
+        /// @brief  Registers onFrame to be driven at up to fps frames per second
+        ///
+        /// Use this instead of creating your own timer for animation; all plugin instances in
+        /// the process share one scheduler wakeup.  The callback pauses automatically while no
+        /// PluginWindow is attached and resumes when the browser provides one again.  It runs
+        /// on the scheduler thread, so typically it should render offscreen and invalidate the
+        /// window rather than touch the browser directly.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void startFrameUpdates(const FrameScheduler::FrameCallback& onFrame, unsigned int fps);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginCore::stopFrameUpdates()
+        ///
+        /// @brief  Unregisters the frame callback; safe to call when none is registered
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void stopFrameUpdates();
+
     protected:
         /// The BrowserHost object for the current session
         BrowserHostPtr m_host;          
@@ -277,8 +314,12 @@ namespace FB {
         /// Stores the list of params provided by the browser to setParams()
         FB::VariantMap m_params;        
     private:
-        /// Don't use directly; use GetWindow() 
-        PluginWindow *m_Window;         
+        /// Don't use directly; use GetWindow()
+        PluginWindow *m_Window;
+        /// FrameScheduler client id from startFrameUpdates(); 0 when none registered
+        unsigned int m_frameClient;
+        /// Recurring timer driving IdleScheduler ticks; 0 until setReady
+        unsigned int m_idleTimer;
         /// Don't use directly; use getRootJSAPI()
         JSAPIPtr m_api;
     };
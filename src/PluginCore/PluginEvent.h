@@ -40,24 +40,95 @@ namespace FB {
 
     public:
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @typedef    const void* EventType
+        ///
+        /// @brief  Opaque per-class event type id; compare ids from eventId<T>()
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        typedef const void* EventType;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @enum   EventClass
+        ///
+        /// @brief  Coarse event categories used by PluginEventSink::getEventInterest; a sink that
+        ///         only cares about some categories can have high-frequency events of the others
+        ///         (mouse motion, drawing) filtered out before its HandleEvent is even called
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        enum EventClass {
+            EventClass_Mouse    = 0x01,     ///< mouse motion and button events
+            EventClass_Keyboard = 0x02,     ///< key up/down events
+            EventClass_Drawing  = 0x04,     ///< refresh, resize, clip and focus events
+            EventClass_Stream   = 0x08,     ///< BrowserStream events
+            EventClass_Platform = 0x10,     ///< raw platform events (WindowsEvent, X11Event, Mac events)
+            EventClass_Other    = 0x20,     ///< everything that doesn't declare a class
+            EventClass_All      = 0xffffffff
+        };
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn template<class T> static EventType PluginEvent::eventId()
+        ///
+        /// @brief  Returns the type id for event class T; each instantiation yields a distinct id
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        template<class T>
+        static EventType eventId()
+        {
+            static const char _id = 0;
+            return &_id;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual EventType PluginEvent::getEventType() const
+        ///
+        /// @brief  The exact type id of this event, or NULL for event classes that predate
+        ///         FB_PLUGIN_EVENT_TYPE (those fall back to dynamic_cast in validType/get)
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual EventType getEventType() const { return NULL; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual unsigned int PluginEvent::getEventClass() const
+        ///
+        /// @brief  The EventClass bit this event belongs to; category base classes override this
+        ///         with FB_PLUGIN_EVENT_CLASS
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual unsigned int getEventClass() const { return EventClass_Other; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool PluginEvent::isEventType(EventType t) const
+        ///
+        /// @brief  True if t names this event's class or any of its bases; each class's
+        ///         FB_PLUGIN_EVENT_TYPE override compares its own id and chains to its base
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool isEventType(EventType t) const { return t == eventId<PluginEvent>(); }
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn template<class T> T* PluginEvent::get()
         ///
         /// @brief  Dynamic cast the pluginEvent to the specified type and throw an exception if it is not
         ///         a subtype of the specified type
-        ///         
+        ///
         /// @code
         ///      AttachedEvent *atevt = evt->get<AttachedEvent>();
         /// @endcode
         ///
-        /// @exception  std::bad_cast   Thrown when invalid argument. 
+        /// @exception  std::bad_cast   Thrown when invalid argument.
         ///
-        /// @return T* 
+        /// @return T*
         /// @since 1.4
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         template<class T>
         T* get()
         {
+            if (getEventType()) {
+                if (!isEventType(eventId<T>()))
+                    throw std::bad_cast();
+                return static_cast<T*>(this);
+            }
             return boost::polymorphic_cast<T*>(this);
         }
 
@@ -66,15 +137,44 @@ namespace FB {
         ///
         /// @brief  Returns true if the object can be cast to the specified type
         ///
-        /// @return true if the type is valid, false if not 
+        /// Events declared with FB_PLUGIN_EVENT_TYPE answer with id compares (no RTTI);
+        /// anything else keeps the dynamic_cast behavior
+        ///
+        /// @return true if the type is valid, false if not
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         template<class T>
         bool validType()
         {
+            if (getEventType())
+                return isEventType(eventId<T>());
             T* out(dynamic_cast<T*>(this));
             return out != NULL;
         }
     };
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @def    FB_PLUGIN_EVENT_TYPE(type, base)
+///
+/// @brief  Declares the static type id chain for an event class; place it at the top of the
+///         class body, naming the class and its immediate base.  Lets validType/get resolve
+///         with a couple of pointer compares instead of a dynamic_cast per probe.
+/// @since 1.5
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#define FB_PLUGIN_EVENT_TYPE(type, base) \
+    public: \
+        virtual FB::PluginEvent::EventType getEventType() const { return FB::PluginEvent::eventId<type>(); } \
+        virtual bool isEventType(FB::PluginEvent::EventType _t) const { return _t == FB::PluginEvent::eventId<type>() || base::isEventType(_t); }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @def    FB_PLUGIN_EVENT_CLASS(cls)
+///
+/// @brief  Declares the EventClass an event belongs to; needed only on category base classes
+///         (MouseButtonEvent, KeyEvent, StreamEvent, ...), subclasses inherit it
+/// @since 1.5
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#define FB_PLUGIN_EVENT_CLASS(cls) \
+    public: \
+        virtual unsigned int getEventClass() const { return (cls); }
+
 #endif
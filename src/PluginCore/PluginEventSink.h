@@ -17,6 +17,7 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 #define H_FB_PLUGINEVENTSINK
 
 #include "PluginEventSource.h"
+#include "PluginEvent.h"
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
@@ -24,8 +25,7 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 
 namespace FB {
 
-    class PluginEvent;
-    
+
     class PluginEventSink;
     typedef boost::shared_ptr<PluginEventSink> PluginEventSinkPtr;
     ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,19 @@ namespace FB {
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         PluginEventSinkPtr shared_ptr() { return shared_from_this(); }
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual unsigned int PluginEventSink::getEventInterest() const
+        ///
+        /// @brief  Mask of PluginEvent::EventClass bits this sink wants delivered; sampled by
+        ///         PluginEventSource when the sink is attached.  The default accepts everything;
+        ///         a sink with no mouse handlers can return ~EventClass_Mouse and never pay the
+        ///         HandleEvent call for motion events.
+        ///
+        /// @return Bitwise-or of the EventClass values the sink handles
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual unsigned int getEventInterest() const { return PluginEvent::EventClass_All; }
+
     public:
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,10 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 #include "PluginEventSink.h"
 #include "PluginEventSource.h"
 #include "PluginEvents/AttachedEvent.h"
+#include "PluginEvents/MouseEvents.h"
+#include "PluginEvents/KeyboardEvents.h"
+#include "JSObject.h"
+#include "IdleScheduler.h"
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/if.hpp>
 #include <boost/lambda/bind.hpp>
@@ -24,7 +28,67 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 using namespace FB;
 
 PluginEventSource::PluginEventSource()
+    : m_nextJSSubToken(1)
 {
+    // virtually all windows have 1-3 sinks; pre-size so steady-state
+    // attach/detach never touches the allocator
+    m_observers.reserve(4);
+}
+
+namespace {
+    // Refills a subscription's preallocated argument record for the event
+    // shapes that never change; anything unrecognized fires with no args
+    void fillJSEventArgs(PluginEvent* evt, VariantList& args)
+    {
+        if (evt->validType<MouseMoveEvent>()) {
+            MouseMoveEvent* e = static_cast<MouseMoveEvent*>(evt);
+            args.resize(2);
+            args[0] = e->m_x;
+            args[1] = e->m_y;
+        } else if (evt->validType<MouseButtonEvent>()) {
+            MouseButtonEvent* e = static_cast<MouseButtonEvent*>(evt);
+            args.resize(3);
+            args[0] = static_cast<int>(e->m_Btn);
+            args[1] = e->m_x;
+            args[2] = e->m_y;
+        } else if (evt->validType<KeyEvent>()) {
+            KeyEvent* e = static_cast<KeyEvent*>(evt);
+            args.resize(2);
+            args[0] = static_cast<int>(e->m_key_code);
+            args[1] = static_cast<int>(e->m_os_key_code);
+        } else {
+            args.clear();
+        }
+    }
+}
+
+unsigned int PluginEventSource::subscribeJSCallback(PluginEvent::EventType type, const JSObjectPtr& callback)
+{
+    boost::recursive_mutex::scoped_lock _l(m_observerLock);
+    boost::shared_ptr<JSSubscription> sub(new JSSubscription);
+    sub->type = type;
+    sub->callback = callback;
+    sub->token = m_nextJSSubToken++;
+    // preallocate the widest record any known shape needs
+    sub->args.reserve(3);
+    m_jsSubscriptions.push_back(sub);
+    m_jsSubSnapshot.reset(new JSSubscriptionList(m_jsSubscriptions));
+    return sub->token;
+}
+
+void PluginEventSource::unsubscribeJSCallback(unsigned int token)
+{
+    boost::recursive_mutex::scoped_lock _l(m_observerLock);
+    for (JSSubscriptionList::iterator it = m_jsSubscriptions.begin(); it != m_jsSubscriptions.end(); ++it) {
+        if ((*it)->token == token) {
+            m_jsSubscriptions.erase(it);
+            break;
+        }
+    }
+    if (m_jsSubscriptions.empty())
+        m_jsSubSnapshot.reset();
+    else
+        m_jsSubSnapshot.reset(new JSSubscriptionList(m_jsSubscriptions));
 }
 
 PluginEventSource::~PluginEventSource()
@@ -40,7 +104,10 @@ void PluginEventSource::AttachObserver( PluginEventSinkPtr sink )
 {
     using namespace boost::lambda;
     boost::recursive_mutex::scoped_lock _l(m_observerLock);
-    m_observers.push_back(sink);
+    // the interest mask is sampled once here; SendEvent filters against it
+    // without another virtual call per event
+    m_observers.push_back(std::make_pair(PluginEventSinkWeakPtr(sink), sink->getEventInterest()));
+    _rebuildSnapshot();
     AttachedEvent newEvent;
     sink->HandleEvent(&newEvent, this);
 }
@@ -50,41 +117,103 @@ void PluginEventSource::DetachObserver(FB::PluginEventSink *sink)
     DetachObserver(sink->shared_ptr());
 }
 
-bool PluginEventSource::_deleteObserver( PluginEventSinkPtr sink, PluginEventSinkWeakPtr wptr )
-{
-    PluginEventSinkPtr ptr(wptr.lock());
-    if (!ptr) {
-        return true;
-    } else if (sink == ptr) {
-        DetachedEvent evt;
-        sink->HandleEvent(&evt, this);
-        return true;
-    } else {
-        return false;
-    }
+bool PluginEventSource::_deleteObserver( PluginEventSinkPtr sink, const std::pair<PluginEventSinkWeakPtr, unsigned int>& entry )
+{
+    PluginEventSinkPtr ptr(entry.first.lock());
+    if (!ptr) {
+        return true;
+    } else if (sink == ptr) {
+        DetachedEvent evt;
+        sink->HandleEvent(&evt, this);
+        return true;
+    } else {
+        return false;
+    }
 }
 
 void PluginEventSource::DetachObserver( PluginEventSinkPtr sink )
 {
     using namespace boost::lambda;
     boost::recursive_mutex::scoped_lock _l(m_observerLock);
-    m_observers.remove_if(bind<bool>(&PluginEventSource::_deleteObserver, this, var(sink), _1));
+    // qualified: boost::bind is also in scope here and can't unwrap var()
+    m_observers.erase(std::remove_if(m_observers.begin(), m_observers.end(),
+        boost::lambda::bind<bool>(&PluginEventSource::_deleteObserver, this, var(sink), boost::lambda::_1)), m_observers.end());
+    _rebuildSnapshot();
+}
+
+void PluginEventSource::_rebuildSnapshot()
+{
+    m_snapshot.reset(new ObserverSnapshot(m_observers.begin(), m_observers.end()));
 }
 
 bool PluginEventSource::SendEvent(PluginEvent* evt)
 {
-    boost::recursive_mutex::scoped_lock _l(m_observerLock);
-    ObserverMap::iterator it = m_observers.begin();
-    while (it != m_observers.end()) {
-        PluginEventSinkPtr tmp = it->lock();
+    // Window/plugin events are the latency-sensitive traffic on this thread;
+    // seeing one keeps idle maintenance off it for the quiet threshold
+    IdleScheduler::getInstance().noteActivity();
+
+    // Dispatch from the immutable snapshot so the lock is held only long
+    // enough to copy a shared_ptr; attach/detach during a (possibly slow)
+    // HandleEvent call just swap in a new snapshot and never invalidate
+    // the one we're walking
+    boost::shared_ptr<const ObserverSnapshot> snap;
+    {
+        boost::recursive_mutex::scoped_lock _l(m_observerLock);
+        snap = m_snapshot;
+    }
+    if (!snap)
+        return false;
+
+    // Sinks that declared no interest in this event's class are skipped
+    // before their HandleEvent is ever called; on a typical three-sink
+    // window most motion events only ever reach the one mouse consumer
+    const unsigned int evtClass = evt->getEventClass();
+
+    bool handled(false), sawDead(false);
+    for (ObserverSnapshot::const_iterator it = snap->begin(); it != snap->end(); ++it) {
+        if (!(it->second & evtClass))
+            continue;
+        PluginEventSinkPtr tmp = it->first.lock();
         if (!tmp) {
-            it = m_observers.erase(it); // Clear out weak_ptrs that don't point to anything alive
+            sawDead = true;
+        } else if (tmp->HandleEvent(evt, this)) {
+            handled = true;     // Tell the caller that the event was handled
+            break;
         }
-        else if (tmp && tmp->HandleEvent(evt, this)) {
-            return true;    // Tell the caller that the event was handled
-        } else {
-            it++;
+    }
+    if (sawDead) {
+        // Prune weak_ptrs that don't point to anything alive
+        boost::recursive_mutex::scoped_lock _l(m_observerLock);
+        for (ObserverMap::iterator it = m_observers.begin(); it != m_observers.end(); ) {
+            if (it->first.expired())
+                it = m_observers.erase(it);
+            else
+                ++it;
+        }
+        _rebuildSnapshot();
+    }
+
+    // Direct javascript subscriptions fire independently of the sinks: the
+    // preallocated argument record is refilled in place and handed to the
+    // async invoke, so a bound callback costs no member resolution and no
+    // allocation per event
+    boost::shared_ptr<const JSSubscriptionList> subs;
+    {
+        boost::recursive_mutex::scoped_lock _l(m_observerLock);
+        subs = m_jsSubSnapshot;
+    }
+    if (subs) {
+        for (JSSubscriptionList::const_iterator it = subs->begin(); it != subs->end(); ++it) {
+            JSSubscription& sub = **it;
+            if (!evt->isEventType(sub.type))
+                continue;
+            fillJSEventArgs(evt, sub.args);
+            try {
+                sub.callback->InvokeAsync("", sub.args);
+            } catch (const std::exception&) {
+                // a dead callback must never take the event thread down
+            }
         }
     }
-    return false;
+    return handled;
 }
@@ -17,8 +17,11 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 #define H_FB_PLUGINEVENTSOURCE
 
 #include <list>
+#include <vector>
+#include <utility>
 #include <typeinfo>
 #include "APITypes.h"
+#include "PluginEvent.h"
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/noncopyable.hpp>
@@ -27,7 +30,6 @@ namespace FB {
 
     FB_FORWARD_PTR(PluginEventSink);
     FB_FORWARD_PTR(PluginEventSource);
-    class PluginEvent;
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @class  PluginEventSource
@@ -86,6 +88,46 @@ namespace FB {
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual bool SendEvent(PluginEvent* evt);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn unsigned int PluginEventSource::subscribeJSCallback(PluginEvent::EventType type, const JSObjectPtr& callback)
+        ///
+        /// @brief  Binds a javascript callback directly to a window event type
+        ///
+        /// High-frequency window events (mouse, keyboard) normally travel source -> sink -> plugin
+        /// and only reach javascript if the plugin re-fires them through the full FireEvent
+        /// machinery.  A direct subscription invokes the callback straight from SendEvent with a
+        /// per-subscription preallocated argument record refilled in place -- no JSAPI member
+        /// resolution and no argument-list allocation per event.  The callback is invoked
+        /// asynchronously, so firing never blocks the event thread.
+        ///
+        /// Usually called through the templated overload: subscribeJSCallback&lt;MouseMoveEvent&gt;(cb).
+        /// Arguments by event type: MouseMoveEvent (x, y); MouseDownEvent / MouseUpEvent
+        /// (button, x, y); KeyDownEvent / KeyUpEvent (key code, OS key code).  Other event
+        /// types fire the callback with no arguments.
+        ///
+        /// @param  type     event type id from PluginEvent::eventId&lt;T&gt;()
+        /// @param  callback javascript function to invoke per matching event
+        ///
+        /// @return subscription token for unsubscribeJSCallback
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int subscribeJSCallback(PluginEvent::EventType type, const JSObjectPtr& callback);
+
+        /// @overload
+        template<class T>
+        unsigned int subscribeJSCallback(const JSObjectPtr& callback)
+        {
+            return subscribeJSCallback(PluginEvent::eventId<T>(), callback);
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginEventSource::unsubscribeJSCallback(unsigned int token)
+        ///
+        /// @brief  Removes a direct javascript subscription by its token; unknown tokens are ignored
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void unsubscribeJSCallback(unsigned int token);
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn template <class T> T* PluginEventSource::get_as()
         ///
@@ -124,7 +166,9 @@ namespace FB {
 
     private:
         // Helper function used by DetachObserver
-        bool _deleteObserver( PluginEventSinkPtr sink, PluginEventSinkWeakPtr wptr );
+        bool _deleteObserver( PluginEventSinkPtr sink, const std::pair<PluginEventSinkWeakPtr, unsigned int>& entry );
+        // Rebuilds the dispatch snapshot from m_observers; call with the lock held
+        void _rebuildSnapshot();
 
     protected:
 
@@ -133,8 +177,35 @@ namespace FB {
         ///
         /// @brief  Defines an alias representing the observer .
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        typedef std::list<boost::weak_ptr<PluginEventSink> > ObserverMap; 
+        // vector rather than list: a window rarely has more than a few sinks,
+        // and the ctor reserves enough that attach/detach during window setup
+        // does no per-node allocation.  Each entry carries the sink's event
+        // interest mask, sampled once at attach time.
+        typedef std::pair<boost::weak_ptr<PluginEventSink>, unsigned int> ObserverEntry;
+        typedef std::vector<ObserverEntry> ObserverMap;
+        typedef std::vector<ObserverEntry> ObserverSnapshot;
         ObserverMap m_observers; /// List of attached observers
+        // Immutable copy of m_observers swapped in by Attach/Detach; SendEvent
+        // dispatches from it without holding m_observerLock, so a slow event
+        // handler never blocks attach/detach (or vice versa)
+        boost::shared_ptr<const ObserverSnapshot> m_snapshot;
+
+        // Direct javascript subscription: the argument record is owned by the
+        // subscription and refilled in place per event.  Window events are
+        // delivered by one thread, so the record is never filled concurrently;
+        // the subscription list itself follows the same snapshot discipline
+        // as the observers.
+        struct JSSubscription {
+            PluginEvent::EventType type;
+            JSObjectPtr callback;
+            VariantList args;
+            unsigned int token;
+        };
+        typedef std::vector<boost::shared_ptr<JSSubscription> > JSSubscriptionList;
+        JSSubscriptionList m_jsSubscriptions;
+        boost::shared_ptr<const JSSubscriptionList> m_jsSubSnapshot;
+        unsigned int m_nextJSSubToken;
+
         boost::recursive_mutex m_observerLock;
     };
 };
@@ -28,6 +28,7 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     class AttachedEvent : public PluginEvent
     {
+        FB_PLUGIN_EVENT_TYPE(AttachedEvent, PluginEvent)
     };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -38,6 +39,7 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     class DetachedEvent : public PluginEvent
     {
+        FB_PLUGIN_EVENT_TYPE(DetachedEvent, PluginEvent)
     };
 };
 
@@ -1,69 +1,129 @@
-/**********************************************************\
-Original Author: Richard Bateman (taxilian)
-
-Created:    Dec 7, 2009
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-
-Copyright 2009 Richard Bateman, Firebreath development team
-\**********************************************************/
-
-#pragma once
-#ifndef H_FB_PLUGINEVENTS_DRAWINGEVENTS
-#define H_FB_PLUGINEVENTS_DRAWINGEVENTS
-
-#include "PluginEvent.h"
-
-namespace FB {
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  ResizedEvent
-    ///
-    /// @brief  Fired when the plugin window is resized
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class ResizedEvent : public PluginEvent
-    {
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  ClipChangedEvent
-    ///
-    /// @brief  Fired when the clipping of the plugin drawing area changes
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class ClipChangedEvent : public PluginEvent
-    {
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  RefreshEvent
-    ///
-    /// @brief  Fired when the plugin should repaint itself (such as on windows when WM_PAINT is
-    ///         received)
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class RefreshEvent : public PluginEvent
-    {
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  FocusChangedEvent
-    ///
-    /// @brief  Fired when the focus changes
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class FocusChangedEvent : public PluginEvent
-    {
-        public:
-            FocusChangedEvent(bool hasFocus) : m_hasFocus(hasFocus) { }
-            virtual ~FocusChangedEvent() { }
-
-            bool hasFocus() { return m_hasFocus; }
-        protected:
-            bool m_hasFocus;
-    };
-
-};
-
-#endif // H_FB_PLUGINEVENTS_DRAWINGEVENTS
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Dec 7, 2009
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_PLUGINEVENTS_DRAWINGEVENTS
+#define H_FB_PLUGINEVENTS_DRAWINGEVENTS
+
+#include "PluginEvent.h"
+#include <vector>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @struct Rect
+    ///
+    /// @brief  Axis-aligned rectangle in plugin coordinates, used for damage tracking
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    struct Rect
+    {
+        Rect() : x(0), y(0), w(0), h(0) { }
+        Rect(int X, int Y, int W, int H) : x(X), y(Y), w(W), h(H) { }
+
+        bool empty() const { return w <= 0 || h <= 0; }
+        long area() const { return static_cast<long>(w) * h; }
+        Rect unionWith(const Rect& o) const
+        {
+            if (empty()) return o;
+            if (o.empty()) return *this;
+            const int x1 = x < o.x ? x : o.x;
+            const int y1 = y < o.y ? y : o.y;
+            const int x2 = (x + w) > (o.x + o.w) ? (x + w) : (o.x + o.w);
+            const int y2 = (y + h) > (o.y + o.h) ? (y + h) : (o.y + o.h);
+            return Rect(x1, y1, x2 - x1, y2 - y1);
+        }
+
+        int x, y, w, h;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  ResizedEvent
+    ///
+    /// @brief  Fired when the plugin window is resized
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ResizedEvent : public PluginEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(ResizedEvent, PluginEvent)
+        FB_PLUGIN_EVENT_CLASS(FB::PluginEvent::EventClass_Drawing)
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  ClipChangedEvent
+    ///
+    /// @brief  Fired when the clipping of the plugin drawing area changes
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ClipChangedEvent : public PluginEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(ClipChangedEvent, PluginEvent)
+        FB_PLUGIN_EVENT_CLASS(FB::PluginEvent::EventClass_Drawing)
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  RefreshEvent
+    ///
+    /// @brief  Fired when the plugin should repaint itself (such as on windows when WM_PAINT is
+    ///         received)
+    ///
+    /// Contract: when hasBounds is true, every pixel outside the rects list is guaranteed
+    /// unchanged on screen, so handlers may clip their drawing to those rects (bounds is their
+    /// union, for handlers that only want one clip).  When hasBounds is false the damage is
+    /// unknown and the whole window must be repainted.  Coordinates are plugin-relative.
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class RefreshEvent : public PluginEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(RefreshEvent, PluginEvent)
+        FB_PLUGIN_EVENT_CLASS(FB::PluginEvent::EventClass_Drawing)
+    public:
+        RefreshEvent() : hasBounds(false) { }
+        /// carries a single damaged rect; handlers may repaint just those pixels
+        RefreshEvent(const Rect& r) : bounds(r), hasBounds(!r.empty())
+        {
+            if (hasBounds)
+                rects.push_back(r);
+        }
+        /// carries a damage list; bounds is computed as the union
+        RefreshEvent(const std::vector<Rect>& damage) : rects(damage), hasBounds(false)
+        {
+            for (std::vector<Rect>::const_iterator it = rects.begin(); it != rects.end(); ++it)
+                bounds = bounds.unionWith(*it);
+            hasBounds = !bounds.empty();
+        }
+
+        std::vector<Rect> rects;    ///< damaged rects; empty when hasBounds is false
+        Rect bounds;                ///< union of rects; meaningful only when hasBounds
+        bool hasBounds;             ///< false means repaint the whole window
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  FocusChangedEvent
+    ///
+    /// @brief  Fired when the focus changes
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class FocusChangedEvent : public PluginEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(FocusChangedEvent, PluginEvent)
+        FB_PLUGIN_EVENT_CLASS(FB::PluginEvent::EventClass_Drawing)
+        public:
+            FocusChangedEvent(bool hasFocus) : m_hasFocus(hasFocus) { }
+            virtual ~FocusChangedEvent() { }
+
+            bool hasFocus() { return m_hasFocus; }
+        protected:
+            bool m_hasFocus;
+    };
+
+};
+
+#endif // H_FB_PLUGINEVENTS_DRAWINGEVENTS
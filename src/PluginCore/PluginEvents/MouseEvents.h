@@ -27,12 +27,22 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     class MouseMoveEvent : public PluginEvent
     {
+        FB_PLUGIN_EVENT_TYPE(MouseMoveEvent, PluginEvent)
+        FB_PLUGIN_EVENT_CLASS(FB::PluginEvent::EventClass_Mouse)
     public:
-        MouseMoveEvent(int x, int y) : m_x(x), m_y(y) { }
+        MouseMoveEvent(int x, int y)
+            : m_x(x), m_y(y), m_firstx(x), m_firsty(y), m_coalesced(1) { }
+        // used by PluginWindow mouse-move coalescing; carries the start of the
+        // collapsed run and how many OS motion events it stands for
+        MouseMoveEvent(int x, int y, int firstx, int firsty, unsigned int coalesced)
+            : m_x(x), m_y(y), m_firstx(firstx), m_firsty(firsty), m_coalesced(coalesced) { }
 
     public:
         int m_x;
         int m_y;
+        int m_firstx;               ///< position of the first motion folded into this event
+        int m_firsty;
+        unsigned int m_coalesced;   ///< OS motion events this event stands for (1 when not coalescing)
     };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -42,6 +52,8 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     class MouseButtonEvent : public PluginEvent
     {
+        FB_PLUGIN_EVENT_TYPE(MouseButtonEvent, PluginEvent)
+        FB_PLUGIN_EVENT_CLASS(FB::PluginEvent::EventClass_Mouse)
     public:
         enum MouseButton {
             MouseButton_Left,
@@ -63,6 +75,7 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     class MouseDownEvent : public MouseButtonEvent
     {
+        FB_PLUGIN_EVENT_TYPE(MouseDownEvent, MouseButtonEvent)
     public:
         MouseDownEvent(MouseButton btn, int x, int y) : MouseButtonEvent(btn, x, y) { }
     };
@@ -74,6 +87,7 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     class MouseUpEvent : public MouseButtonEvent
     {
+        FB_PLUGIN_EVENT_TYPE(MouseUpEvent, MouseButtonEvent)
     public:
         MouseUpEvent(MouseButton btn, int x, int y) : MouseButtonEvent(btn, x, y) { }
     };
@@ -1,159 +1,220 @@
-/**********************************************************\ 
-Original Author: Matthias (nitrogenycs)
-
-Created:    Feb 28, 2010
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-
-Copyright 2010 Richard Bateman, Firebreath development team
-\**********************************************************/
-
-#pragma once
-#ifndef H_FB_PLUGINEVENTS_STREAMEVENTS
-#define H_FB_PLUGINEVENTS_STREAMEVENTS
-
-#include "PluginEvent.h"
-
-namespace FB {
-    class BrowserStream;
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  StreamEvent
-    ///
-    /// @brief  Base class for all stream events.
-    ///
-    /// @author Matthias
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class StreamEvent : public PluginEvent
-    {
-    public:
-        StreamEvent(BrowserStream* Stream) : stream(Stream)
-        {}
-
-    public:
-        BrowserStream* stream;
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  StreamCreatedEvent
-    ///
-    /// @brief  This event is fired when the given stream was created
-    ///
-    /// @author Matthias
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class StreamCreatedEvent : public StreamEvent
-    {
-    public:
-        StreamCreatedEvent(BrowserStream* stream) : StreamEvent(stream)
-        {}
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  StreamCreatedEvent
-    ///
-    /// @brief  This event is fired when the given stream is destroyed.
-    ///
-    /// @author Matthias
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class StreamDestroyedEvent : public StreamEvent
-    {
-    public:
-        StreamDestroyedEvent(BrowserStream* stream) : StreamEvent(stream)
-        {}
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  StreamCreatedEvent
-    ///
-    /// @brief  This event is fired when data on the given stream has arrived.
-    ///
-    /// @author Matthias
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class StreamDataArrivedEvent : public StreamEvent
-    {
-    public:
-        StreamDataArrivedEvent( BrowserStream* stream, const void* Data, const size_t Length, const size_t DataPosition, const float Progress ) : StreamEvent(stream), data(Data), length(Length), dataPosition(DataPosition), progress(Progress)
-        {}
-
-        /// read-only pointer to the data
-        const void* getData() const
-        {
-            return data;
-        }
-    
-        /// returns the length of the data in bytes
-        const size_t getLength() const
-        {
-            return length;
-        }
-
-        /// the position in the stream where the data starts (e.g. 0 if the data starts at the beginning)
-        const size_t getDataPosition() const
-        {
-            return dataPosition;
-        }
-
-        /// gets the download progress in percent (0-100). 0 if progress is unknown (stream length not known in advance).
-        const float getProgress() const
-        {
-            return progress;
-        }
-    protected:
-        const void*     data;           // the data
-        const size_t    length;         // length of the data in bytes
-        const size_t    dataPosition;   // the position in the stream where the data starts (e.g. 0 if the data starts at the beginning)
-        const float     progress;       // the current progress in percent (0-100). 0 if progress is unknown (stream length not known in advance).
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  StreamFailedOpenEvent
-    ///
-    /// @brief  This event is fired when a stream failed to open, e.g. the url was invalid or a seekable
-    ///         stream was requested while the server provided only a non-seekable stream.
-    ///
-    /// @author Matthias
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class StreamFailedOpenEvent : public StreamEvent
-    {
-    public:
-        StreamFailedOpenEvent(BrowserStream* stream) : StreamEvent(stream)
-        {}
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  StreamFailedOpenEvent
-    ///
-    /// @brief  This event is fired when a stream was opened successfully.
-    ///
-    /// @author Matthias
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class StreamOpenedEvent : public StreamEvent
-    {
-    public:
-        StreamOpenedEvent(BrowserStream* stream) : StreamEvent(stream)
-        {}
-    };
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  StreamCompletedEvent
-    ///
-    /// @brief  This event is fired when a stream has completed downloading.
-    ///
-    /// @author Matthias
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    class StreamCompletedEvent : public StreamEvent
-    {
-    public:
-        StreamCompletedEvent(BrowserStream* stream, bool Success) : StreamEvent(stream), success(Success)
-        {}
-
-    public:
-        bool success;
-    };
-};
-
-#endif // H_FB_PLUGINEVENTS_STREAMEVENTS
+/**********************************************************\ 
+Original Author: Matthias (nitrogenycs)
+
+Created:    Feb 28, 2010
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_PLUGINEVENTS_STREAMEVENTS
+#define H_FB_PLUGINEVENTS_STREAMEVENTS
+
+#include "PluginEvent.h"
+#include "StreamBufferPool.h"
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace FB {
+    class BrowserStream;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamEvent
+    ///
+    /// @brief  Base class for all stream events.
+    ///
+    /// @author Matthias
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamEvent : public PluginEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamEvent, PluginEvent)
+        FB_PLUGIN_EVENT_CLASS(FB::PluginEvent::EventClass_Stream)
+    public:
+        StreamEvent(BrowserStream* Stream) : stream(Stream)
+        {}
+
+    public:
+        BrowserStream* stream;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamCreatedEvent
+    ///
+    /// @brief  This event is fired when the given stream was created
+    ///
+    /// @author Matthias
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamCreatedEvent : public StreamEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamCreatedEvent, StreamEvent)
+    public:
+        StreamCreatedEvent(BrowserStream* stream) : StreamEvent(stream)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamCreatedEvent
+    ///
+    /// @brief  This event is fired when the given stream is destroyed.
+    ///
+    /// @author Matthias
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamDestroyedEvent : public StreamEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamDestroyedEvent, StreamEvent)
+    public:
+        StreamDestroyedEvent(BrowserStream* stream) : StreamEvent(stream)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamCreatedEvent
+    ///
+    /// @brief  This event is fired when data on the given stream has arrived.
+    ///
+    /// The data pointer references the browser's own delivery buffer and is only valid for the
+    /// duration of the (synchronous) event dispatch; nothing is buffered by the stream itself.
+    /// Handlers that process the chunk immediately can read it in place with no copies at all;
+    /// handlers that need the data after returning must take a copy before the dispatch ends,
+    /// either themselves or via copyData(), which copies once and shares the result between all
+    /// handlers of this dispatch.
+    ///
+    /// @author Matthias
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamDataArrivedEvent : public StreamEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamDataArrivedEvent, StreamEvent)
+    public:
+        typedef boost::shared_ptr<const std::vector<char> > DataCopyPtr;
+
+        StreamDataArrivedEvent( BrowserStream* stream, const void* Data, const size_t Length, const size_t DataPosition, const float Progress ) : StreamEvent(stream), data(Data), length(Length), dataPosition(DataPosition), progress(Progress)
+        {}
+
+        /// read-only pointer to the data; valid only until the event dispatch returns
+        const void* getData() const
+        {
+            return data;
+        }
+
+        /// returns an owned copy of the data that may be kept past the dispatch; the copy is
+        /// made lazily on the first call and shared by all handlers of this event.  The backing
+        /// buffer is recycled through the process-wide StreamBufferPool, so retaining at
+        /// download rates reuses hot blocks instead of allocating per chunk
+        DataCopyPtr copyData() const
+        {
+            if ( !dataCopy && length )
+            {
+                const char* begin = static_cast<const char*>(data);
+                StreamBufferPool::BufferPtr buf = StreamBufferPool::getInstance().acquire( length );
+                buf->assign( begin, begin + length );
+                dataCopy = buf;
+            }
+            return dataCopy;
+        }
+
+        /// returns the length of the data in bytes
+        const size_t getLength() const
+        {
+            return length;
+        }
+
+        /// the position in the stream where the data starts (e.g. 0 if the data starts at the beginning)
+        const size_t getDataPosition() const
+        {
+            return dataPosition;
+        }
+
+        /// gets the download progress in percent (0-100). 0 if progress is unknown (stream length not known in advance).
+        const float getProgress() const
+        {
+            return progress;
+        }
+    protected:
+        const void*     data;           // the data
+        const size_t    length;         // length of the data in bytes
+        const size_t    dataPosition;   // the position in the stream where the data starts (e.g. 0 if the data starts at the beginning)
+        const float     progress;       // the current progress in percent (0-100). 0 if progress is unknown (stream length not known in advance).
+        mutable DataCopyPtr dataCopy;   // lazily-made owned copy, shared by every handler that retains
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamProgressEvent
+    ///
+    /// @brief  Rate-limited download progress notification
+    ///
+    /// Unlike the per-chunk progress field on StreamDataArrivedEvent, this event is throttled by
+    /// the stream's min-interval/min-delta policy (see BrowserStream::setProgressInterval), so a
+    /// progress bar can listen to it without paying a JS callback for every 64KB chunk on a fast
+    /// link.  The first and the final (100%) notifications always fire.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamProgressEvent : public StreamEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamProgressEvent, StreamEvent)
+    public:
+        StreamProgressEvent(BrowserStream* stream, float Progress, size_t BytesReceived)
+          : StreamEvent(stream), progress(Progress), bytesReceived(BytesReceived)
+        {}
+
+    public:
+        float   progress;       ///< download progress in percent (0-100); 0 if the length is unknown
+        size_t  bytesReceived;  ///< bytes received so far
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamFailedOpenEvent
+    ///
+    /// @brief  This event is fired when a stream failed to open, e.g. the url was invalid or a seekable
+    ///         stream was requested while the server provided only a non-seekable stream.
+    ///
+    /// @author Matthias
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamFailedOpenEvent : public StreamEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamFailedOpenEvent, StreamEvent)
+    public:
+        StreamFailedOpenEvent(BrowserStream* stream) : StreamEvent(stream)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamFailedOpenEvent
+    ///
+    /// @brief  This event is fired when a stream was opened successfully.
+    ///
+    /// @author Matthias
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamOpenedEvent : public StreamEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamOpenedEvent, StreamEvent)
+    public:
+        StreamOpenedEvent(BrowserStream* stream) : StreamEvent(stream)
+        {}
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamCompletedEvent
+    ///
+    /// @brief  This event is fired when a stream has completed downloading.
+    ///
+    /// @author Matthias
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamCompletedEvent : public StreamEvent
+    {
+        FB_PLUGIN_EVENT_TYPE(StreamCompletedEvent, StreamEvent)
+    public:
+        StreamCompletedEvent(BrowserStream* stream, bool Success) : StreamEvent(stream), success(Success)
+        {}
+
+    public:
+        bool success;
+    };
+};
+
+#endif // H_FB_PLUGINEVENTS_STREAMEVENTS
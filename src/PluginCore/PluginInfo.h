@@ -19,9 +19,18 @@
 #include <string>
 
 namespace FB
-{   
-    std::string getPluginName(const std::string& mimetype);
-    std::string getPluginDescription(const std::string& mimetype);
+{
+    // Both return references to metadata parsed once from the PluginConfig
+    // strings; safe to hold as long as the module is loaded
+    const std::string& getPluginName(const std::string& mimetype);
+    const std::string& getPluginDescription(const std::string& mimetype);
+    // True if the mimetype appears in the PluginConfig MIME table; a hash
+    // lookup against the same parsed-once data the accessors above use
+    bool isMimeTypeSupported(const std::string& mimetype);
+    // Forces the MIME table parse now instead of on the first metadata query;
+    // call it from module initialization so instance creation never pays for
+    // the parse
+    void preparePluginMetadata();
     bool pluginGuiEnabled();
 }
 
@@ -0,0 +1,64 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cstring>
+#include "PluginSurface.h"
+
+using namespace FB;
+
+PluginSurface::PluginSurface(int w, int h)
+  : m_width(0), m_height(0), m_pixels(NULL)
+{
+    resize(w, h);
+}
+
+PluginSurface::~PluginSurface()
+{
+    delete[] m_pixels;
+}
+
+void PluginSurface::resize(int w, int h)
+{
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+    if (w != m_width || h != m_height) {
+        delete[] m_pixels;
+        m_pixels = NULL;
+        m_width = w;
+        m_height = h;
+        m_pixels = new unsigned char[getStride() * m_height];
+        std::memset(m_pixels, 0, getStride() * m_height);
+    }
+    m_damage.clear();
+    m_damage.push_back(Rect(0, 0, m_width, m_height));
+}
+
+void PluginSurface::markDirty(const Rect& r)
+{
+    // clip to the surface; callers often mark conservative rects
+    int x1 = r.x > 0 ? r.x : 0;
+    int y1 = r.y > 0 ? r.y : 0;
+    int x2 = (r.x + r.w) < m_width ? (r.x + r.w) : m_width;
+    int y2 = (r.y + r.h) < m_height ? (r.y + r.h) : m_height;
+    if (x2 <= x1 || y2 <= y1)
+        return;
+    m_damage.push_back(Rect(x1, y1, x2 - x1, y2 - y1));
+}
+
+std::vector<Rect> PluginSurface::takeDamage()
+{
+    std::vector<Rect> out;
+    out.swap(m_damage);
+    return out;
+}
@@ -0,0 +1,74 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_PLUGINSURFACE
+#define H_FB_PLUGINSURFACE
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include "FBPointers.h"
+#include "PluginEvents/DrawingEvents.h"
+
+namespace FB {
+
+    FB_FORWARD_PTR(PluginSurface);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  PluginSurface
+    ///
+    /// @brief  Offscreen 32bpp drawing surface owned by a PluginWindow
+    ///
+    /// Plugins paint into getPixels() (top-down BGRA rows, getStride() bytes apart), record what
+    /// they touched with markDirty(), and call PluginWindow::presentSurface() to push the damage
+    /// to the screen; the platform window blits only the damaged region when the OS asks for a
+    /// repaint.  A frame that marks nothing dirty costs nothing — no invalidation, no paint, no
+    /// blit.  This replaces the compatible-DC back buffer every plugin used to hand-roll.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class PluginSurface : boost::noncopyable
+    {
+    public:
+        PluginSurface(int w, int h);
+        ~PluginSurface();
+
+        int getWidth() const { return m_width; }
+        int getHeight() const { return m_height; }
+        /// bytes between the starts of consecutive rows
+        size_t getStride() const { return static_cast<size_t>(m_width) * 4; }
+        /// top-down BGRA pixel rows; valid until the next resize
+        unsigned char* getPixels() { return m_pixels; }
+        const unsigned char* getPixels() const { return m_pixels; }
+
+        /// reallocates the buffer (contents undefined) and damages everything
+        void resize(int w, int h);
+
+        /// records a painted region; clipped to the surface bounds
+        void markDirty(const Rect& r);
+        void markDirty(int x, int y, int w, int h) { markDirty(Rect(x, y, w, h)); }
+
+        bool hasDamage() const { return !m_damage.empty(); }
+        /// returns the accumulated damage and clears it
+        std::vector<Rect> takeDamage();
+
+    protected:
+        int m_width;
+        int m_height;
+        unsigned char* m_pixels;
+        std::vector<Rect> m_damage;
+    };
+};
+
+#endif // H_FB_PLUGINSURFACE
@@ -12,8 +12,253 @@ License:    Dual license model; choose one of two:
 Copyright 2009 PacketPass, Inc and the Firebreath development team
 \**********************************************************/
 
+#include <algorithm>
+#include <cstring>
 #include "PluginWindow.h"
 #include "PluginEventSink.h"
+#include "PluginEvents/MouseEvents.h"
+#include "StartupTimeline.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 using namespace FB;
 
+PluginWindow::PluginWindow()
+  : m_coalesceMouseMoves(false), m_coalesceIntervalMs(15), m_haveQueuedMove(false),
+    m_queuedX(0), m_queuedY(0), m_queuedFirstX(0), m_queuedFirstY(0),
+    m_queuedCount(0), m_lastMoveHandled(false),
+    m_frameWidth(0), m_frameHeight(0), m_framesDropped(0),
+    m_paintFrames(0), m_paintTotalUs(0), m_paintMaxUs(0), m_paintOverBudget(0),
+    m_frameBudgetUs(17 * 1000)
+{
+    std::fill(m_paintBuckets, m_paintBuckets + paint_bucket_count, 0);
+}
+
+void PluginWindow::setMouseMoveCoalescing(bool enabled, unsigned int intervalMs)
+{
+    m_coalesceMouseMoves = enabled;
+    m_coalesceIntervalMs = intervalMs;
+    if (!enabled)
+        flushPendingMouseMove();
+}
+
+bool PluginWindow::SendMouseMoveEvent(int x, int y)
+{
+    if (!m_coalesceMouseMoves) {
+        MouseMoveEvent ev(x, y);
+        return SendEvent(&ev);
+    }
+
+    if (!m_haveQueuedMove) {
+        m_haveQueuedMove = true;
+        m_queuedFirstX = x;
+        m_queuedFirstY = y;
+        m_queuedCount = 0;
+    }
+    m_queuedX = x;
+    m_queuedY = y;
+    ++m_queuedCount;
+
+    boost::posix_time::ptime now(boost::posix_time::microsec_clock::universal_time());
+    if (m_lastMoveFlush.is_not_a_date_time()
+        || now - m_lastMoveFlush >= boost::posix_time::milliseconds(m_coalesceIntervalMs)) {
+        return flushPendingMouseMove();
+    }
+    // swallowed into the buffer; report what the last delivered move reported
+    return m_lastMoveHandled;
+}
+
+bool PluginWindow::flushPendingMouseMove()
+{
+    if (!m_haveQueuedMove)
+        return false;
+    m_haveQueuedMove = false;
+    m_lastMoveFlush = boost::posix_time::microsec_clock::universal_time();
+    MouseMoveEvent ev(m_queuedX, m_queuedY, m_queuedFirstX, m_queuedFirstY, m_queuedCount);
+    m_lastMoveHandled = PluginEventSource::SendEvent(&ev);
+    return m_lastMoveHandled;
+}
+
+void PluginWindow::invalidateRect(const Rect& r)
+{
+    if (r.empty())
+        return;
+
+    // merge into the rect whose union wastes the least area; only take the
+    // merge when most of the union is real damage, so two far-apart updates
+    // don't collapse into one window-sized rect
+    size_t best = m_dirtyRects.size();
+    long bestWaste = 0;
+    Rect bestUnion;
+    for (size_t i = 0; i < m_dirtyRects.size(); ++i) {
+        const Rect u = m_dirtyRects[i].unionWith(r);
+        // covered area over-counts any overlap, which only makes merging
+        // easier for rects that genuinely intersect
+        const long waste = u.area() - m_dirtyRects[i].area() - r.area();
+        if (best == m_dirtyRects.size() || waste < bestWaste) {
+            best = i;
+            bestWaste = waste;
+            bestUnion = u;
+        }
+    }
+    if (best < m_dirtyRects.size()
+        && (bestWaste * 2 <= bestUnion.area() || m_dirtyRects.size() >= max_dirty_rects)) {
+        m_dirtyRects[best] = bestUnion;
+    } else {
+        m_dirtyRects.push_back(r);
+    }
+}
+
+void PluginWindow::endFrame()
+{
+    if (m_dirtyRects.empty())
+        return;
+    std::vector<Rect> rects;
+    rects.swap(m_dirtyRects);
+    InvalidateRegion(rects);
+}
+
+void PluginWindow::InvalidateRegion(const std::vector<Rect>&)
+{
+    InvalidateWindow();
+}
+
+PluginSurfacePtr PluginWindow::getDrawingSurface(int w, int h)
+{
+    if (!m_surface)
+        m_surface = PluginSurfacePtr(new PluginSurface(w, h));
+    else if (m_surface->getWidth() != w || m_surface->getHeight() != h)
+        m_surface->resize(w, h);
+    return m_surface;
+}
+
+void PluginWindow::presentSurface()
+{
+    if (!m_surface || !m_surface->hasDamage())
+        return;
+    const std::vector<Rect> damage(m_surface->takeDamage());
+    for (std::vector<Rect>::const_iterator it = damage.begin(); it != damage.end(); ++it)
+        invalidateRect(*it);
+    endFrame();
+}
+
+void PluginWindow::submitFrame(const StreamBufferPool::BufferPtr& pixels, int w, int h)
+{
+    boost::mutex::scoped_lock lock(m_frameMutex);
+    // overwriting an unconsumed frame is the drop; releasing the old shared_ptr
+    // sends its buffer back to the pool for the worker's next frame
+    if (m_framePixels)
+        ++m_framesDropped;
+    m_framePixels = pixels;
+    m_frameWidth = w;
+    m_frameHeight = h;
+}
+
+bool PluginWindow::hasSubmittedFrame() const
+{
+    boost::mutex::scoped_lock lock(m_frameMutex);
+    return static_cast<bool>(m_framePixels);
+}
+
+bool PluginWindow::consumeSubmittedFrame()
+{
+    StreamBufferPool::BufferPtr pixels;
+    int w, h;
+    {
+        boost::mutex::scoped_lock lock(m_frameMutex);
+        if (!m_framePixels)
+            return false;
+        pixels.swap(m_framePixels);
+        w = m_frameWidth;
+        h = m_frameHeight;
+    }
+    PluginSurfacePtr surface(getDrawingSurface(w, h));
+    const size_t frameBytes = static_cast<size_t>(surface->getStride()) * h;
+    std::memcpy(surface->getPixels(), &(*pixels)[0],
+                pixels->size() < frameBytes ? pixels->size() : frameBytes);
+    surface->markDirty(Rect(0, 0, w, h));
+    presentSurface();
+    return true;
+}
+
+boost::uint64_t PluginWindow::getDroppedFrameCount() const
+{
+    boost::mutex::scoped_lock lock(m_frameMutex);
+    return m_framesDropped;
+}
+
+bool PluginWindow::presentAcceleratedSurface(void*, int, int)
+{
+    // no accelerated compositor path; the renderer must read back and use the
+    // submitFrame() mailbox
+    return false;
+}
+
+bool PluginWindow::SendEvent(PluginEvent* evt)
+{
+    // deliver any buffered motion first so handlers see positions in order
+    // (a click or redraw must not observe a stale cursor position)
+    if (m_haveQueuedMove && !evt->validType<MouseMoveEvent>())
+        flushPendingMouseMove();
+
+    if (evt->validType<RefreshEvent>()) {
+        const bool firstPaint = (m_paintFrames == 0);
+        const boost::posix_time::ptime start(boost::posix_time::microsec_clock::universal_time());
+        const bool handled = PluginEventSource::SendEvent(evt);
+        const boost::posix_time::time_duration took =
+            boost::posix_time::microsec_clock::universal_time() - start;
+        recordPaint(static_cast<long>(took.total_microseconds()));
+        if (firstPaint) {
+            // first paint closes out the startup timeline
+            StartupTimeline::getInstance().mark("firstPaint");
+            StartupTimeline::getInstance().logSummary();
+        }
+        return handled;
+    }
+    return PluginEventSource::SendEvent(evt);
+}
+
+void PluginWindow::recordPaint(long usec)
+{
+    if (usec < 0)
+        usec = 0;
+    ++m_paintFrames;
+    m_paintTotalUs += usec;
+    if (usec > m_paintMaxUs)
+        m_paintMaxUs = usec;
+    if (usec > m_frameBudgetUs)
+        ++m_paintOverBudget;
+
+    size_t bucket = 0;
+    unsigned long v = static_cast<unsigned long>(usec);
+    while (v >>= 1)
+        ++bucket;
+    if (bucket >= paint_bucket_count)
+        bucket = paint_bucket_count - 1;
+    ++m_paintBuckets[bucket];
+}
+
+FB::VariantMap PluginWindow::getPaintStats() const
+{
+    FB::VariantMap stats;
+    stats["frames"] = static_cast<double>(m_paintFrames);
+    stats["totalUs"] = static_cast<double>(m_paintTotalUs);
+    stats["avgUs"] = m_paintFrames
+        ? static_cast<double>(m_paintTotalUs) / static_cast<double>(m_paintFrames) : 0.0;
+    stats["maxUs"] = static_cast<double>(m_paintMaxUs);
+    stats["overBudget"] = static_cast<double>(m_paintOverBudget);
+    stats["budgetUs"] = static_cast<double>(m_frameBudgetUs);
+    FB::VariantList histogram;
+    for (size_t i = 0; i < paint_bucket_count; ++i)
+        histogram.push_back(static_cast<int>(m_paintBuckets[i]));
+    stats["histogram"] = histogram;
+    return stats;
+}
+
+void PluginWindow::resetPaintStats()
+{
+    m_paintFrames = 0;
+    m_paintTotalUs = 0;
+    m_paintMaxUs = 0;
+    m_paintOverBudget = 0;
+    std::fill(m_paintBuckets, m_paintBuckets + paint_bucket_count, 0);
+}
@@ -17,7 +17,15 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 #define H_FB_PLUGINWINDOW
 
 #include <string>
+#include <vector>
+#include "APITypes.h"
 #include "PluginEventSource.h"
+#include "PluginEvents/DrawingEvents.h"
+#include "PluginSurface.h"
+#include "StreamBufferPool.h"
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 namespace FB {
 
@@ -33,7 +41,7 @@ namespace FB {
     class PluginWindow : public PluginEventSource
     {
     public:
-        PluginWindow() { };
+        PluginWindow();
         virtual ~PluginWindow() { };
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -42,6 +50,233 @@ namespace FB {
         /// @brief  Invalidate window.  This should tell the OS to send a REFRESH event.
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual void InvalidateWindow() = 0;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindow::setMouseMoveCoalescing(bool enabled, unsigned int intervalMs)
+        ///
+        /// @brief  Opt in to collapsing bursts of mouse-move events
+        ///
+        /// When enabled, consecutive OS motion events within intervalMs of the last delivered move
+        /// are folded into a single MouseMoveEvent carrying the latest coordinates, the position
+        /// the run started at, and how many motions it stands for.  A buffered move is flushed as
+        /// soon as the interval elapses or any other event needs to be dispatched, so ordering
+        /// relative to clicks and redraws is preserved.  Off by default.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setMouseMoveCoalescing(bool enabled, unsigned int intervalMs = 15);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool PluginWindow::SendMouseMoveEvent(int x, int y)
+        ///
+        /// @brief  Dispatches a mouse move through the coalescing filter; platform windows route
+        ///         their OS motion events here instead of calling SendEvent directly
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool SendMouseMoveEvent(int x, int y);
+
+        /// Flushes any buffered mouse move before dispatching evt
+        virtual bool SendEvent(PluginEvent* evt);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindow::invalidateRect(const Rect& r)
+        ///
+        /// @brief  Accumulates a damaged rectangle instead of invalidating immediately
+        ///
+        /// Rects are merged when the union doesn't grow much beyond the pieces, so dozens of
+        /// small updates per frame stay a handful of regions.  Nothing reaches the OS until
+        /// endFrame() flushes the batch; RefreshEvent then carries the damage so handlers can
+        /// repaint only those pixels.  InvalidateWindow() remains the whole-window path.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void invalidateRect(const Rect& r);
+        void invalidateRect(int x, int y, int w, int h) { invalidateRect(Rect(x, y, w, h)); }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindow::endFrame()
+        ///
+        /// @brief  Flushes rects accumulated by invalidateRect() as one OS invalidation pass;
+        ///         call once per frame after all drawing-state changes are in
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void endFrame();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn PluginSurfacePtr PluginWindow::getDrawingSurface(int w, int h)
+        ///
+        /// @brief  Returns the offscreen surface, creating or resizing it to w x h
+        ///
+        /// Once a surface exists the platform window blits it to the screen itself on repaint
+        /// requests, so RefreshEvent handling (and the hand-rolled back buffer it usually hides)
+        /// is no longer needed; paint into the surface, markDirty(), then presentSurface().
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        PluginSurfacePtr getDrawingSurface(int w, int h);
+        /// the current surface, if any
+        PluginSurfacePtr getDrawingSurface() const { return m_surface; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindow::presentSurface()
+        ///
+        /// @brief  Pushes the surface's accumulated damage through invalidateRect/endFrame; a
+        ///         frame with no damage is free (no invalidation, no paint, no blit)
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void presentSurface();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindow::setFrameBudget(unsigned int ms)
+        ///
+        /// @brief  Sets the per-frame paint budget used by the over-budget counter in
+        ///         getPaintStats(); default is 17ms (roughly one 60Hz frame)
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setFrameBudget(unsigned int ms) { m_frameBudgetUs = static_cast<long>(ms) * 1000; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap PluginWindow::getPaintStats() const
+        ///
+        /// @brief  Returns timing statistics for RefreshEvent dispatches through this window
+        ///
+        /// Every paint dispatched via SendEvent is timed.  The map holds "frames", "totalUs",
+        /// "avgUs", "maxUs", "overBudget" (paints that exceeded the setFrameBudget() budget),
+        /// "budgetUs", and "histogram" -- a list of 20 counts where bucket n covers paints of
+        /// [2^n, 2^(n+1)) microseconds.  Values fit a VariantMap so a plugin's JSAPI can expose
+        /// them with a single registerMethod; correlate with media telemetry host-side.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap getPaintStats() const;
+
+        /// Zeroes the counters and histogram behind getPaintStats()
+        /// @since 1.5
+        void resetPaintStats();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void PluginWindow::submitFrame(const StreamBufferPool::BufferPtr& pixels, int w, int h)
+        ///
+        /// @brief  Hands a completed frame to the window from any thread
+        ///
+        /// The window keeps a single-slot mailbox of the latest submitted frame: a worker renders
+        /// into a pooled buffer (StreamBufferPool, top-down BGRA rows, w*4 bytes apart), submits
+        /// it, and goes straight back to rendering -- no blocking handoff.  If the main thread
+        /// hasn't consumed the previous frame yet it is dropped (its buffer returns to the pool)
+        /// and the drop counter bumped, so a lagging main thread sees the newest frame instead of
+        /// a growing backlog.  Together with the surface this is the triple-buffer pattern
+        /// (worker buffer, mailbox, surface) without the ad hoc plumbing.
+        ///
+        /// @param  pixels  Pooled buffer holding the frame
+        /// @param  w,h     Frame dimensions in pixels
+        /// @since 1.5
+        /// @see consumeSubmittedFrame
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void submitFrame(const StreamBufferPool::BufferPtr& pixels, int w, int h);
+
+        /// True if a submitted frame is waiting to be consumed
+        /// @since 1.5
+        bool hasSubmittedFrame() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool PluginWindow::consumeSubmittedFrame()
+        ///
+        /// @brief  Copies the latest submitted frame into the drawing surface and presents it
+        ///
+        /// Call from the main thread (typically the RefreshEvent handler or a timer).  Takes the
+        /// mailbox frame if there is one, sizes the surface to it, copies the pixels, damages the
+        /// whole frame and pushes it through presentSurface(); the frame's buffer goes back to
+        /// the pool.  Returns false (and does nothing) when no frame is waiting.
+        ///
+        /// @return true if a frame was consumed
+        /// @since 1.5
+        /// @see submitFrame
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool consumeSubmittedFrame();
+
+        /// Frames overwritten in the mailbox before the main thread got to them
+        /// @since 1.5
+        boost::uint64_t getDroppedFrameCount() const;
+
+        /// Kinds of GPU surface a window can composite without a CPU readback;
+        /// the value names the native type behind the void* handed to
+        /// presentAcceleratedSurface()
+        /// @since 1.5
+        enum AcceleratedSurfaceType {
+            AcceleratedSurface_None = 0,
+            AcceleratedSurface_IOSurface,       ///< IOSurfaceRef (Mac, CoreAnimation model)
+            AcceleratedSurface_DXGISharedHandle,///< DXGI shared-resource HANDLE (Windows)
+            AcceleratedSurface_GLXPixmap        ///< GLXPixmap (X11)
+        };
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual AcceleratedSurfaceType PluginWindow::getAcceleratedSurfaceType() const
+        ///
+        /// @brief  The GPU surface type this window can present directly, or
+        ///         AcceleratedSurface_None when only the CPU paths are available
+        ///
+        /// A GPU renderer should query this at attach time: when a type is reported it can keep
+        /// its frames on the GPU and hand them over with presentAcceleratedSurface(), skipping
+        /// the glReadPixels/submitFrame readback entirely.  When None is reported, fall back to
+        /// the submitFrame() mailbox.
+        /// @since 1.5
+        /// @see presentAcceleratedSurface
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual AcceleratedSurfaceType getAcceleratedSurfaceType() const { return AcceleratedSurface_None; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool PluginWindow::presentAcceleratedSurface(void* surface, int w, int h)
+        ///
+        /// @brief  Hands a native GPU surface to the compositor without touching the pixels
+        ///
+        /// surface must be of the type reported by getAcceleratedSurfaceType() and stay valid
+        /// (and unwritten) until the next present returns; double-buffer on the renderer side.
+        /// Safe to call from any thread.  Returns false when this window has no accelerated
+        /// path -- callers must then route the frame through submitFrame() instead.
+        /// @since 1.5
+        /// @see getAcceleratedSurfaceType
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool presentAcceleratedSurface(void* surface, int w, int h);
+
+    protected:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual void PluginWindow::InvalidateRegion(const std::vector<Rect>& rects)
+        ///
+        /// @brief  Hands the merged damage to the OS; platform windows that can invalidate
+        ///         sub-rects override this, the default falls back to InvalidateWindow()
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual void InvalidateRegion(const std::vector<Rect>& rects);
+
+        // sends the buffered move (if any) and stamps the flush time
+        bool flushPendingMouseMove();
+
+        bool m_coalesceMouseMoves;
+        unsigned int m_coalesceIntervalMs;
+        bool m_haveQueuedMove;
+        int m_queuedX, m_queuedY;           // latest buffered position
+        int m_queuedFirstX, m_queuedFirstY; // where the buffered run started
+        unsigned int m_queuedCount;         // motions folded into the buffer
+        bool m_lastMoveHandled;             // result reported for swallowed motions
+        boost::posix_time::ptime m_lastMoveFlush;
+
+        std::vector<Rect> m_dirtyRects;     // damage accumulated since the last endFrame
+        static const size_t max_dirty_rects = 8;
+
+        PluginSurfacePtr m_surface;         // offscreen back buffer, if the plugin asked for one
+
+        // single-slot mailbox for worker-rendered frames; see submitFrame()
+        mutable boost::mutex m_frameMutex;
+        StreamBufferPool::BufferPtr m_framePixels;  // latest complete frame, NULL when consumed
+        int m_frameWidth, m_frameHeight;
+        boost::uint64_t m_framesDropped;
+
+        // paint telemetry; see getPaintStats()
+        void recordPaint(long usec);
+
+        static const size_t paint_bucket_count = 20;
+        boost::uint64_t m_paintFrames;
+        boost::uint64_t m_paintTotalUs;
+        long m_paintMaxUs;
+        boost::uint64_t m_paintOverBudget;  // paints that ran past m_frameBudgetUs
+        long m_frameBudgetUs;
+        boost::uint32_t m_paintBuckets[paint_bucket_count];  // log2-microsecond histogram
     };
 };
 
@@ -0,0 +1,252 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include "BrowserHost.h"
+#include "logging.h"
+
+#include "ProcessChannel.h"
+
+using namespace FB;
+using boost::interprocess::ipcdetail::atomic_read32;
+using boost::interprocess::ipcdetail::atomic_write32;
+using boost::interprocess::ipcdetail::atomic_cas32;
+
+namespace {
+    // ring sizing: coordination messages are short and frequent, so small
+    // fixed slots keep the whole hub (~270k for 8 peers) mappable everywhere
+    const boost::uint32_t ring_capacity = 16;       // must be a power of two
+    const boost::uint32_t max_message_bytes = 256;
+
+    struct ShmMessage {
+        boost::uint32_t length;
+        char data[max_message_bytes];
+    };
+
+    // single-producer/single-consumer: only the owner of the `from` slot
+    // writes tail, only the owner of the `to` slot writes head.  Indexes run
+    // free and are masked, so empty is head == tail and full is a distance
+    // of ring_capacity
+    struct ShmRing {
+        volatile boost::uint32_t head;
+        volatile boost::uint32_t tail;
+        ShmMessage slots[ring_capacity];
+    };
+
+    struct ShmPeer {
+        volatile boost::uint32_t inUse;
+    };
+}
+
+// The whole hub is valid when zero-filled (all rings empty, all slots free),
+// which is exactly what a fresh shared memory segment contains; that is what
+// lets concurrent open_or_create from several processes skip any
+// construction handshake
+struct ProcessChannel::Hub {
+    ShmPeer peers[ProcessChannel::MaxPeers];
+    ShmRing rings[ProcessChannel::MaxPeers][ProcessChannel::MaxPeers];
+};
+
+ProcessChannel::ProcessChannel(const std::string& name)
+    : m_hub(NULL), m_self(MaxPeers), m_stop(false), m_started(false)
+{
+    // the plugin name goes into a kernel object name; keep only the safe part
+    m_shmName = "fb-chan-";
+    for (std::string::const_iterator it = name.begin(); it != name.end(); ++it) {
+        if (std::isalnum(static_cast<unsigned char>(*it)))
+            m_shmName += static_cast<char>(std::tolower(static_cast<unsigned char>(*it)));
+    }
+
+    using namespace boost::interprocess;
+    shared_memory_object shm(open_or_create, m_shmName.c_str(), read_write);
+    shm.truncate(sizeof(Hub));
+    mapped_region region(shm, read_write);
+    m_shm.swap(shm);
+    m_region.swap(region);
+    m_hub = static_cast<Hub*>(m_region.get_address());
+
+    for (unsigned int i = 0; i < MaxPeers; ++i) {
+        if (atomic_cas32(&m_hub->peers[i].inUse, 1, 0) == 0) {
+            m_self = i;
+            break;
+        }
+    }
+    if (m_self == MaxPeers)
+        throw std::runtime_error("ProcessChannel: no free peer slots");
+
+    // a crashed previous owner of this slot may have left its rings mid-way;
+    // resetting them to empty can at worst skip a message that was in flight
+    // while the slot was unowned
+    for (unsigned int i = 0; i < MaxPeers; ++i) {
+        ShmRing& in = m_hub->rings[i][m_self];
+        atomic_write32(&in.head, atomic_read32(&in.tail));
+        ShmRing& out = m_hub->rings[m_self][i];
+        atomic_write32(&out.tail, atomic_read32(&out.head));
+    }
+    FBLOG_INFO("ProcessChannel", "Joined channel " << m_shmName << " as peer " << m_self);
+}
+
+ProcessChannel::~ProcessChannel()
+{
+    m_stop = true;
+    if (m_started)
+        m_thread.join();
+    if (m_hub) {
+        atomic_write32(&m_hub->peers[m_self].inUse, 0);
+        bool anyLeft = false;
+        for (unsigned int i = 0; i < MaxPeers; ++i) {
+            if (atomic_read32(&m_hub->peers[i].inUse))
+                anyLeft = true;
+        }
+        // unlink the name once the channel looks empty so the segment doesn't
+        // outlive the plugin; a peer joining in this window re-creates it and
+        // simply starts a fresh channel
+        if (!anyLeft)
+            boost::interprocess::shared_memory_object::remove(m_shmName.c_str());
+    }
+}
+
+void ProcessChannel::start()
+{
+    if (m_started)
+        return;
+    m_started = true;
+    m_thread = boost::thread(boost::bind(&ProcessChannel::run, this));
+}
+
+void ProcessChannel::setMessageHandler(const MessageHandler& handler)
+{
+    boost::mutex::scoped_lock lock(m_handlerMutex);
+    m_handler = handler;
+}
+
+void ProcessChannel::attachHost(const BrowserHostPtr& host)
+{
+    boost::mutex::scoped_lock lock(m_handlerMutex);
+    m_host = host;
+}
+
+size_t ProcessChannel::maxMessageSize()
+{
+    return max_message_bytes;
+}
+
+bool ProcessChannel::send(unsigned int peer, const std::string& message)
+{
+    if (peer >= MaxPeers || peer == m_self || message.size() > max_message_bytes)
+        return false;
+    if (!atomic_read32(&m_hub->peers[peer].inUse))
+        return false;
+
+    ShmRing& ring = m_hub->rings[m_self][peer];
+    // we are the only producer on this ring, so tail is ours to read plainly
+    const boost::uint32_t head = atomic_read32(&ring.head);
+    const boost::uint32_t tail = ring.tail;
+    if (tail - head >= ring_capacity)
+        return false;       // receiver is behind; coordination traffic is droppable
+
+    ShmMessage& slot = ring.slots[tail & (ring_capacity - 1)];
+    slot.length = static_cast<boost::uint32_t>(message.size());
+    if (!message.empty())
+        std::memcpy(slot.data, message.data(), message.size());
+    // publishing store; the consumer never looks at a slot until tail covers it
+    atomic_write32(&ring.tail, tail + 1);
+    return true;
+}
+
+unsigned int ProcessChannel::broadcast(const std::string& message)
+{
+    unsigned int delivered = 0;
+    for (unsigned int i = 0; i < MaxPeers; ++i) {
+        if (i != m_self && send(i, message))
+            ++delivered;
+    }
+    return delivered;
+}
+
+bool ProcessChannel::drainOne()
+{
+    bool got = false;
+    for (unsigned int from = 0; from < MaxPeers; ++from) {
+        if (from == m_self)
+            continue;
+        ShmRing& ring = m_hub->rings[from][m_self];
+        const boost::uint32_t tail = atomic_read32(&ring.tail);
+        const boost::uint32_t head = ring.head;     // we are the only consumer
+        if (head == tail)
+            continue;
+        const ShmMessage& slot = ring.slots[head & (ring_capacity - 1)];
+        boost::uint32_t len = slot.length;
+        if (len > max_message_bytes)
+            len = max_message_bytes;
+        std::string message(slot.data, len);
+        atomic_write32(&ring.head, head + 1);
+        got = true;
+
+        boost::shared_ptr<BrowserHost> host;
+        {
+            boost::mutex::scoped_lock lock(m_handlerMutex);
+            host = m_host.lock();
+        }
+        if (host) {
+            // cross-process ScheduleOnMainThread: the handler runs on the
+            // attached host's main thread, like any other async call
+            host->ScheduleOnMainThread(shared_from_this(),
+                boost::bind(&ProcessChannel::deliver, this, from, message));
+        } else {
+            deliver(from, message);
+        }
+    }
+    return got;
+}
+
+void ProcessChannel::deliver(unsigned int from, const std::string& message)
+{
+    MessageHandler handler;
+    {
+        boost::mutex::scoped_lock lock(m_handlerMutex);
+        handler = m_handler;
+    }
+    if (!handler)
+        return;
+    try {
+        handler(from, message);
+    } catch (const std::exception& e) {
+        FBLOG_ERROR("ProcessChannel", "Message handler threw: " << e.what());
+    }
+}
+
+void ProcessChannel::run()
+{
+    // yield-poll briefly after traffic so a burst of coordination messages
+    // round-trips in microseconds, then back off to a millisecond sleep so an
+    // idle channel costs nothing measurable
+    const unsigned int hot_polls = 256;
+    unsigned int quiet = hot_polls;
+    while (!m_stop) {
+        if (drainOne()) {
+            quiet = 0;
+        } else if (++quiet < hot_polls) {
+            boost::this_thread::yield();
+        } else {
+            quiet = hot_polls;      // keep the counter from wrapping
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_PROCESSCHANNEL
+#define H_FB_PROCESSCHANNEL
+
+#include <string>
+#include <boost/noncopyable.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "APITypes.h"
+#include "FBPointers.h"
+
+namespace FB {
+    FB_FORWARD_PTR(BrowserHost);
+    FB_FORWARD_PTR(ProcessChannel);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  ProcessChannel
+    ///
+    /// @brief  Shared-memory message channel between plugin instances in different processes
+    ///
+    /// Multi-process browsers put instances from different tabs in different processes, which
+    /// turns instance coordination through a loopback service into milliseconds per message.
+    /// A ProcessChannel is a named shared-memory segment holding a fixed set of peer slots and
+    /// a lock-free single-producer/single-consumer ring per ordered peer pair; a send is a copy
+    /// into the ring plus one atomic store, and the receiving side's reader thread hands the
+    /// message to the registered handler, on the browser main thread when a host is attached --
+    /// the cross-process equivalent of ScheduleOnMainThread.
+    ///
+    /// Channels are process-wide and owned by the factory; get one with
+    /// FactoryBase::getProcessChannel() rather than constructing it directly:
+    /// @code
+    ///      FB::ProcessChannelPtr chan(getFactoryInstance()->getProcessChannel());
+    ///      if (chan) {
+    ///          chan->attachHost(m_host);
+    ///          chan->setMessageHandler(boost::bind(&MyPlugin::onPeerMessage, this, _1, _2));
+    ///          chan->broadcast("sync:play:1234");
+    ///      }
+    /// @endcode
+    ///
+    /// Messages are limited to maxMessageSize() bytes and a full ring drops the send (send()
+    /// returns false); this is a low-latency coordination path, not a bulk transport.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ProcessChannel
+        : public boost::enable_shared_from_this<ProcessChannel>
+        , boost::noncopyable
+    {
+    public:
+        /// Handler for inbound messages; fromPeer is the sender's peerId()
+        typedef boost::function<void (unsigned int fromPeer, const std::string& message)> MessageHandler;
+
+        /// Maximum peers a channel can hold; peer ids are 0..MaxPeers-1
+        static const unsigned int MaxPeers = 8;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn ProcessChannel::ProcessChannel(const std::string& name)
+        ///
+        /// @brief  Opens (creating if needed) the named segment and claims a peer slot
+        ///
+        /// Throws std::runtime_error if all MaxPeers slots are taken and lets
+        /// boost::interprocess errors propagate; prefer FactoryBase::getProcessChannel(),
+        /// which handles both.
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        ProcessChannel(const std::string& name);
+        ~ProcessChannel();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void ProcessChannel::start()
+        ///
+        /// @brief  Starts the reader thread; called by the factory after construction, idempotent
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void start();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void ProcessChannel::setMessageHandler(const MessageHandler& handler)
+        ///
+        /// @brief  Registers the handler inbound messages are delivered to
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setMessageHandler(const MessageHandler& handler);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void ProcessChannel::attachHost(const BrowserHostPtr& host)
+        ///
+        /// @brief  Delivers subsequent messages on that host's main thread instead of the
+        ///         reader thread
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void attachHost(const BrowserHostPtr& host);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool ProcessChannel::send(unsigned int peer, const std::string& message)
+        ///
+        /// @brief  Posts a message to one peer; false if the peer is absent, the message is
+        ///         over maxMessageSize(), or the ring is full
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool send(unsigned int peer, const std::string& message);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn unsigned int ProcessChannel::broadcast(const std::string& message)
+        ///
+        /// @brief  Posts a message to every live peer; returns how many accepted it
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int broadcast(const std::string& message);
+
+        /// This process's slot in the channel
+        unsigned int peerId() const { return m_self; }
+
+        /// Largest message send() accepts, in bytes
+        static size_t maxMessageSize();
+
+    private:
+        struct Hub;
+
+        void run();
+        void deliver(unsigned int from, const std::string& message);
+        bool drainOne();
+
+        std::string m_shmName;
+        boost::interprocess::shared_memory_object m_shm;
+        boost::interprocess::mapped_region m_region;
+        Hub* m_hub;
+        unsigned int m_self;
+
+        mutable boost::mutex m_handlerMutex;
+        MessageHandler m_handler;
+        BrowserHostWeakPtr m_host;
+
+        volatile bool m_stop;
+        bool m_started;
+        boost::thread m_thread;
+    };
+};
+
+#endif // H_FB_PROCESSCHANNEL
@@ -0,0 +1,277 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "BrowserHost.h"
+#include "SegmentedDownloader.h"
+
+using namespace FB;
+
+namespace {
+    // aim each segment at roughly this many seconds of transfer so the
+    // scheduler gets frequent enough feedback without per-chunk overhead
+    const double targetSegmentSeconds = 2.0;
+    // weight of the newest sample in the throughput estimate
+    const double throughputAlpha = 0.3;
+}
+
+SegmentedDownloader::SegmentedDownloader(const BrowserHostPtr& host, const std::string& url, size_t connections)
+  : m_host(host)
+  , m_url(url)
+  , m_connectionCount((std::max)(connections, static_cast<size_t>(1)))
+  , m_length(0)
+  , m_nextOffset(0)
+  , m_deliverPos(0)
+  , m_started(false)
+  , m_finished(false)
+  , m_sequentialFallback(false)
+  , m_initialSegmentSize(256 * 1024)
+  , m_minSegmentSize(64 * 1024)
+  , m_maxSegmentSize(8 * 1024 * 1024)
+{
+}
+
+SegmentedDownloader::~SegmentedDownloader()
+{
+    // close quietly; no user callbacks from a destructor
+    for (std::vector<Connection>::iterator it = m_connections.begin(); it != m_connections.end(); ++it) {
+        if (it->stream)
+            it->stream->close();
+    }
+}
+
+void SegmentedDownloader::setSegmentSizeBounds(size_t initial, size_t minSize, size_t maxSize)
+{
+    m_minSegmentSize = (std::max)(minSize, static_cast<size_t>(1));
+    m_maxSegmentSize = (std::max)(maxSize, m_minSegmentSize);
+    m_initialSegmentSize = (std::min)((std::max)(initial, m_minSegmentSize), m_maxSegmentSize);
+}
+
+bool SegmentedDownloader::start(const DataCallback& onData, const CompletedCallback& onCompleted)
+{
+    if (m_started)
+        return false;
+    BrowserHostPtr host(m_host.lock());
+    if (!host)
+        return false;
+
+    m_onData = onData;
+    m_onCompleted = onCompleted;
+    m_started = true;
+
+    m_connections.resize(m_connectionCount);
+    for (size_t i = 0; i < m_connectionCount; ++i) {
+        // no browser cache: each connection carries a distinct byte range
+        BrowserStreamPtr stream(host->createStream(m_url, shared_ptr(), false, true));
+        if (!stream) {
+            finish(false);
+            return false;
+        }
+        m_connections[i].stream = stream;
+    }
+    return true;
+}
+
+void SegmentedDownloader::cancel()
+{
+    finish(false);
+}
+
+SegmentedDownloader::Connection* SegmentedDownloader::findConnection(FB::BrowserStream* stream)
+{
+    for (std::vector<Connection>::iterator it = m_connections.begin(); it != m_connections.end(); ++it) {
+        if (it->stream.get() == stream)
+            return &*it;
+    }
+    return NULL;
+}
+
+bool SegmentedDownloader::onStreamOpened(FB::StreamOpenedEvent *evt, FB::BrowserStream *stream)
+{
+    if (m_finished)
+        return false;
+    Connection* conn = findConnection(stream);
+    if (!conn)
+        return false;
+
+    if (!m_length)
+        m_length = stream->getLength();
+
+    if (!stream->isSeekable() || !m_length) {
+        // The server can't do range requests (or won't say how long the
+        // resource is); fall back to one sequential stream and close the rest
+        if (!m_sequentialFallback) {
+            m_sequentialFallback = true;
+            for (std::vector<Connection>::iterator it = m_connections.begin(); it != m_connections.end(); ++it) {
+                if (it->stream && it->stream.get() != stream)
+                    it->stream->close();
+            }
+        }
+        return false;
+    }
+
+    assignNextSegment(*conn);
+    return false;
+}
+
+void SegmentedDownloader::assignNextSegment(Connection& conn)
+{
+    if (m_nextOffset >= m_length) {
+        conn.busy = false;
+        return;
+    }
+
+    size_t segSize = m_initialSegmentSize;
+    if (conn.throughput > 0.0) {
+        double ideal = conn.throughput * targetSegmentSeconds;
+        segSize = static_cast<size_t>((std::min)(ideal, static_cast<double>(m_maxSegmentSize)));
+        segSize = (std::min)((std::max)(segSize, m_minSegmentSize), m_maxSegmentSize);
+    }
+
+    conn.segStart = m_nextOffset;
+    conn.segEnd = (std::min)(m_nextOffset + segSize, m_length);
+    conn.received = 0;
+    conn.busy = true;
+    conn.segIssued = boost::posix_time::microsec_clock::universal_time();
+    m_nextOffset = conn.segEnd;
+
+    if (!conn.stream->readRange(conn.segStart, conn.segEnd))
+        finish(false);
+}
+
+bool SegmentedDownloader::onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *stream)
+{
+    if (m_finished)
+        return false;
+
+    if (m_sequentialFallback) {
+        deliverInOrder(evt->getData(), evt->getLength(), evt->getDataPosition(), evt);
+        if (m_length && m_deliverPos >= m_length)
+            finish(true);
+        return true;
+    }
+
+    Connection* conn = findConnection(stream);
+    if (!conn || !conn->busy)
+        return false;
+
+    conn->received += evt->getLength();
+    deliverInOrder(evt->getData(), evt->getLength(), evt->getDataPosition(), evt);
+    if (m_finished)
+        return true;
+
+    if (conn->received >= conn->segEnd - conn->segStart) {
+        // segment done; fold its rate into the estimate and hand out the next one
+        boost::posix_time::time_duration elapsed =
+            boost::posix_time::microsec_clock::universal_time() - conn->segIssued;
+        double seconds = elapsed.total_milliseconds() / 1000.0;
+        if (seconds > 0.0) {
+            double sample = (conn->segEnd - conn->segStart) / seconds;
+            conn->throughput = conn->throughput > 0.0
+                ? conn->throughput * (1.0 - throughputAlpha) + sample * throughputAlpha
+                : sample;
+        }
+        assignNextSegment(*conn);
+    }
+
+    if (m_deliverPos >= m_length && m_pending.empty())
+        finish(true);
+    return true;
+}
+
+void SegmentedDownloader::deliverInOrder(const void* data, size_t len, size_t position, FB::StreamDataArrivedEvent *evt)
+{
+    if (!len)
+        return;
+
+    // drop any bytes we've already delivered (overlapping retransmits)
+    if (position < m_deliverPos) {
+        size_t skip = m_deliverPos - position;
+        if (skip >= len)
+            return;
+        data = static_cast<const char*>(data) + skip;
+        position += skip;
+        len -= skip;
+    }
+
+    if (position > m_deliverPos) {
+        // ahead of the gap; this is the only path that has to copy
+        m_pending[position] = evt->copyData();
+        return;
+    }
+
+    // contiguous: hand the browser's buffer straight to the sink
+    if (m_onData)
+        m_onData(data, len, position);
+    m_deliverPos = position + len;
+
+    // flush any queued chunks the gap closure has made contiguous
+    while (!m_pending.empty()) {
+        std::map<size_t, StreamDataArrivedEvent::DataCopyPtr>::iterator it = m_pending.begin();
+        if (it->first > m_deliverPos)
+            break;
+        const std::vector<char>& buf = *it->second;
+        size_t skip = m_deliverPos - it->first;
+        if (skip < buf.size()) {
+            if (m_onData)
+                m_onData(&buf[skip], buf.size() - skip, m_deliverPos);
+            m_deliverPos += buf.size() - skip;
+        }
+        m_pending.erase(it);
+    }
+}
+
+bool SegmentedDownloader::onStreamFailedOpen(FB::StreamFailedOpenEvent *evt, FB::BrowserStream *stream)
+{
+    finish(false);
+    return false;
+}
+
+bool SegmentedDownloader::onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *stream)
+{
+    if (m_finished)
+        return false;
+    if (!evt->success) {
+        finish(false);
+        return false;
+    }
+    if (m_sequentialFallback) {
+        finish(true);
+        return false;
+    }
+    if (m_length && m_deliverPos >= m_length && m_pending.empty())
+        finish(true);
+    return false;
+}
+
+void SegmentedDownloader::finish(bool success)
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    for (std::vector<Connection>::iterator it = m_connections.begin(); it != m_connections.end(); ++it) {
+        if (it->stream)
+            it->stream->close();
+    }
+    m_pending.clear();
+
+    CompletedCallback cb;
+    cb.swap(m_onCompleted);
+    m_onData.clear();
+    if (cb)
+        cb(success);
+}
@@ -0,0 +1,157 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_SEGMENTEDDOWNLOADER
+#define H_FB_SEGMENTEDDOWNLOADER
+
+#include <map>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "BrowserStream.h"
+
+namespace FB {
+    FB_FORWARD_PTR(SegmentedDownloader);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  SegmentedDownloader
+    ///
+    /// @brief  Downloads one URL over several parallel seekable BrowserStreams and delivers the
+    ///         bytes to a single sink, in order
+    ///
+    /// A single BrowserStream gives one connection per URL, which leaves most of the bandwidth on
+    /// a high-bandwidth-delay path unused.  This class opens a configurable number of seekable
+    /// streams over the same URL, hands each connection a byte range at a time, and sizes the next
+    /// range from that connection's observed throughput so fast connections pull ahead instead of
+    /// idling at segment boundaries.  Chunks that arrive at the current delivery position are
+    /// passed to the sink straight from the browser's buffer (no copy); out-of-order chunks are
+    /// held via StreamDataArrivedEvent::copyData until the gap before them closes.
+    ///
+    /// If the server turns out not to support range requests, or does not report a content length,
+    /// the downloader degrades to a single sequential stream and still delivers through the same
+    /// sink.  All callbacks fire on the main thread.
+    ///
+    /// @code
+    ///      FB::SegmentedDownloaderPtr dl(new FB::SegmentedDownloader(host, url, 4));
+    ///      dl->start(boost::bind(&MyClass::onData, this, _1, _2, _3),
+    ///                boost::bind(&MyClass::onDone, this, _1));
+    /// @endcode
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class SegmentedDownloader : public PluginEventSink
+    {
+    public:
+        /// Sink for in-order data: (data, length, position).  The pointer is only valid for the
+        /// duration of the call
+        typedef boost::function<void (const void*, size_t, size_t)> DataCallback;
+        /// Called once when the download finishes; true on success
+        typedef boost::function<void (bool)> CompletedCallback;
+
+        BEGIN_PLUGIN_EVENT_MAP()
+            EVENTTYPE_CASE(FB::StreamOpenedEvent, onStreamOpened, FB::BrowserStream)
+            EVENTTYPE_CASE(FB::StreamDataArrivedEvent, onStreamDataArrived, FB::BrowserStream)
+            EVENTTYPE_CASE(FB::StreamFailedOpenEvent, onStreamFailedOpen, FB::BrowserStream)
+            EVENTTYPE_CASE(FB::StreamCompletedEvent, onStreamCompleted, FB::BrowserStream)
+        END_PLUGIN_EVENT_MAP()
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn SegmentedDownloader::SegmentedDownloader(const BrowserHostPtr& host, const std::string& url, size_t connections = 4)
+        ///
+        /// @brief  Prepares a downloader for the given URL; nothing happens until start() is called
+        ///
+        /// @param  host        the BrowserHost to create streams on
+        /// @param  url         URL to download
+        /// @param  connections number of parallel connections to open (clamped to at least 1)
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        SegmentedDownloader(const BrowserHostPtr& host, const std::string& url, size_t connections = 4);
+        virtual ~SegmentedDownloader();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool SegmentedDownloader::start(const DataCallback& onData, const CompletedCallback& onCompleted)
+        ///
+        /// @brief  Opens the streams and begins downloading
+        ///
+        /// @return false if the streams could not be created (e.g. the host is shutting down)
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool start(const DataCallback& onData, const CompletedCallback& onCompleted);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void SegmentedDownloader::cancel()
+        ///
+        /// @brief  Closes all streams; the completed callback fires with false if it hasn't already
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void cancel();
+
+        /// Total bytes delivered to the sink so far
+        size_t getBytesDelivered() const { return m_deliverPos; }
+        /// Content length as reported by the server; 0 until known
+        size_t getLength() const { return m_length; }
+
+        /// Sets the initial per-connection segment size (default 256 KiB); later segments are
+        /// sized from observed throughput between these bounds
+        void setSegmentSizeBounds(size_t initial, size_t minSize, size_t maxSize);
+
+        virtual bool onStreamOpened(FB::StreamOpenedEvent *evt, FB::BrowserStream *stream);
+        virtual bool onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *stream);
+        virtual bool onStreamFailedOpen(FB::StreamFailedOpenEvent *evt, FB::BrowserStream *stream);
+        virtual bool onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *stream);
+
+    protected:
+        // Per-connection bookkeeping: the segment currently assigned and the
+        // throughput estimate used to size the next one
+        struct Connection
+        {
+            Connection() : segStart(0), segEnd(0), received(0), busy(false), throughput(0.0) {}
+
+            BrowserStreamPtr        stream;
+            size_t                  segStart;
+            size_t                  segEnd;
+            size_t                  received;
+            bool                    busy;
+            double                  throughput;     // bytes/sec, exponentially smoothed
+            boost::posix_time::ptime segIssued;
+        };
+
+        Connection* findConnection(FB::BrowserStream* stream);
+        void assignNextSegment(Connection& conn);
+        void deliverInOrder(const void* data, size_t len, size_t position, FB::StreamDataArrivedEvent *evt);
+        void finish(bool success);
+
+    private:
+        BrowserHostWeakPtr      m_host;
+        std::string             m_url;
+        size_t                  m_connectionCount;
+        std::vector<Connection> m_connections;
+
+        DataCallback            m_onData;
+        CompletedCallback       m_onCompleted;
+
+        size_t                  m_length;           // content length; 0 = unknown
+        size_t                  m_nextOffset;       // first byte not yet assigned to a segment
+        size_t                  m_deliverPos;       // first byte not yet delivered to the sink
+        bool                    m_started;
+        bool                    m_finished;
+        bool                    m_sequentialFallback;   // server can't do ranges; single stream
+
+        size_t                  m_initialSegmentSize;
+        size_t                  m_minSegmentSize;
+        size_t                  m_maxSegmentSize;
+
+        // chunks that arrived ahead of the delivery position, keyed by stream offset
+        std::map<size_t, StreamDataArrivedEvent::DataCopyPtr> m_pending;
+    };
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cstring>
+#include <sstream>
+#include "logging.h"
+
+#include "StartupTimeline.h"
+
+using namespace FB;
+
+StartupTimeline& StartupTimeline::getInstance()
+{
+    static StartupTimeline instance;
+    return instance;
+}
+
+StartupTimeline::StartupTimeline() : m_count(0), m_logged(false)
+{
+}
+
+void StartupTimeline::mark(const char* phase)
+{
+    // clock read outside the lock; under it this is a scan of a handful of
+    // entries and one store
+    const boost::posix_time::ptime now(boost::posix_time::microsec_clock::universal_time());
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (m_count >= MaxPhases)
+        return;
+    for (size_t i = 0; i < m_count; ++i) {
+        if (! std::strcmp(m_phases[i].name, phase))
+            return;     // re-marks (second instance, later repaints) are ignored
+    }
+    m_phases[m_count].name = phase;
+    m_phases[m_count].when = now;
+    ++m_count;
+}
+
+FB::VariantMap StartupTimeline::report() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    FB::VariantMap d;
+    FB::VariantList phases;
+    for (size_t i = 0; i < m_count; ++i) {
+        FB::VariantMap p;
+        p["phase"] = std::string(m_phases[i].name);
+        p["atMs"] = (m_phases[i].when - m_phases[0].when).total_microseconds() / 1000.0;
+        p["deltaMs"] = (i ? (m_phases[i].when - m_phases[i-1].when).total_microseconds() : 0) / 1000.0;
+        phases.push_back(p);
+    }
+    d["phases"] = phases;
+    d["totalMs"] = m_count
+        ? (m_phases[m_count-1].when - m_phases[0].when).total_microseconds() / 1000.0 : 0.0;
+    return d;
+}
+
+void StartupTimeline::logSummary()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (m_logged || ! m_count)
+        return;
+    m_logged = true;
+    std::ostringstream os;
+    for (size_t i = 0; i < m_count; ++i) {
+        if (i) os << " | ";
+        os << m_phases[i].name << " +"
+           << ((m_phases[i].when - m_phases[0].when).total_microseconds() / 1000.0) << "ms";
+    }
+    FBLOG_INFO("StartupTimeline", "Startup phases: " << os.str());
+}
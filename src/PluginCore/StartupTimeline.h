@@ -0,0 +1,92 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STARTUPTIMELINE
+#define H_FB_STARTUPTIMELINE
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "APITypes.h"
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StartupTimeline
+    ///
+    /// @brief  Records timestamps for the plugin initialization phases
+    ///
+    /// Cold start is opaque without this: the framework marks module load, factory
+    /// initialization, first instance creation, window attach, plugin ready and first paint as
+    /// they happen, and the phase breakdown tells you which stage is eating the time.  mark()
+    /// is one clock read and an array store into fixed storage, so the instrumentation stays on
+    /// in release builds.
+    ///
+    /// A one-line summary is logged automatically after first paint; plugins that want the
+    /// breakdown scriptable can register a property returning report():
+    /// @code
+    ///      registerProperty("startupReport",
+    ///          make_property(this, &MyPluginAPI::get_startupReport));
+    ///      // ...
+    ///      FB::VariantMap get_startupReport() { return FB::StartupTimeline::getInstance().report(); }
+    /// @endcode
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StartupTimeline : boost::noncopyable
+    {
+    public:
+        static StartupTimeline& getInstance();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StartupTimeline::mark(const char* phase)
+        ///
+        /// @brief  Timestamps a phase; only the first occurrence of a name is kept, so marks in
+        ///         per-instance code paths record the cold-start instance and ignore the rest.
+        ///         The name must be a string literal (it is stored, not copied).
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void mark(const char* phase);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap StartupTimeline::report() const
+        ///
+        /// @brief  Phase breakdown: a "phases" list of {phase, atMs, deltaMs} in mark order
+        ///         (offsets from the first mark) plus "totalMs"
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap report() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StartupTimeline::logSummary()
+        ///
+        /// @brief  Logs the one-line phase summary; only the first call does anything
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void logSummary();
+
+    private:
+        StartupTimeline();
+
+        static const size_t MaxPhases = 16;
+        struct Phase {
+            const char* name;
+            boost::posix_time::ptime when;
+        };
+
+        mutable boost::mutex m_mutex;
+        Phase m_phases[MaxPhases];
+        size_t m_count;
+        bool m_logged;
+    };
+};
+
+#endif // H_FB_STARTUPTIMELINE
@@ -0,0 +1,144 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+#include "MemoryAccounting.h"
+#include "StreamBufferPool.h"
+#include "StreamBlockCache.h"
+
+using namespace FB;
+
+namespace {
+    size_t roundUpToPowerOfTwo( size_t n )
+    {
+        size_t p = 4096;
+        while ( p < n )
+            p <<= 1;
+        return p;
+    }
+}
+
+StreamBlockCache::StreamBlockCache( size_t maxBytes, size_t blockSize )
+  : m_blockSize( roundUpToPowerOfTwo( blockSize ) )
+  , m_maxBlocks( (std::max)( maxBytes / m_blockSize, static_cast<size_t>(1) ) )
+{
+}
+
+StreamBlockCache::~StreamBlockCache()
+{
+    clear();
+}
+
+StreamBlockCache::Block& StreamBlockCache::getOrCreateBlock( size_t base )
+{
+    BlockMap::iterator found = m_blocks.find( base );
+    if ( found != m_blocks.end() )
+        return found->second;
+
+    while ( m_blocks.size() >= m_maxBlocks )
+    {
+        BlockMap::iterator victim = m_blocks.find( m_lru.back() );
+        StreamBufferPool::getInstance().release( victim->second.data );
+        m_blocks.erase( victim );
+        m_lru.pop_back();
+        FB::Memory::accountFree( FB::Memory::Category_StreamBuffer, m_blockSize );
+    }
+
+    Block& block = m_blocks[base];
+    StreamBufferPool::getInstance().acquireInto( block.data, m_blockSize );
+    block.data.resize( m_blockSize );
+    block.validEnd = 0;
+    m_lru.push_front( base );
+    block.lruIt = m_lru.begin();
+    FB::Memory::accountAlloc( FB::Memory::Category_StreamBuffer, m_blockSize );
+    return block;
+}
+
+void StreamBlockCache::touch( Block& block, size_t base )
+{
+    m_lru.erase( block.lruIt );
+    m_lru.push_front( base );
+    block.lruIt = m_lru.begin();
+}
+
+void StreamBlockCache::insert( const void* data, size_t len, size_t offset )
+{
+    const char* src = static_cast<const char*>( data );
+    while ( len )
+    {
+        const size_t base = offset & ~( m_blockSize - 1 );
+        const size_t inBlock = offset - base;
+        const size_t chunk = (std::min)( len, m_blockSize - inBlock );
+
+        Block& block = getOrCreateBlock( base );
+        // blocks fill contiguously from their start; a chunk landing past the
+        // valid prefix (mid-block range read) can't be folded in
+        if ( inBlock <= block.validEnd )
+        {
+            std::memcpy( &block.data[inBlock], src, chunk );
+            block.validEnd = (std::max)( block.validEnd, inBlock + chunk );
+            touch( block, base );
+        }
+
+        src += chunk;
+        offset += chunk;
+        len -= chunk;
+    }
+}
+
+bool StreamBlockCache::lookup( size_t start, size_t end, std::vector<char>& out )
+{
+    if ( end <= start )
+        return false;
+
+    // verify full coverage before copying or touching anything
+    for ( size_t pos = start; pos < end; )
+    {
+        const size_t base = pos & ~( m_blockSize - 1 );
+        BlockMap::const_iterator found = m_blocks.find( base );
+        if ( found == m_blocks.end() )
+            return false;
+        const size_t needEnd = (std::min)( end - base, m_blockSize );
+        if ( needEnd > found->second.validEnd )
+            return false;
+        pos = base + m_blockSize;
+    }
+
+    out.clear();
+    out.reserve( end - start );
+    for ( size_t pos = start; pos < end; )
+    {
+        const size_t base = pos & ~( m_blockSize - 1 );
+        const size_t inBlock = pos - base;
+        const size_t chunk = (std::min)( end - pos, m_blockSize - inBlock );
+        Block& block = m_blocks[base];
+        out.insert( out.end(), block.data.begin() + inBlock, block.data.begin() + inBlock + chunk );
+        touch( block, base );
+        pos += chunk;
+    }
+    return true;
+}
+
+void StreamBlockCache::clear()
+{
+    for ( BlockMap::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it )
+    {
+        StreamBufferPool::getInstance().release( it->second.data );
+        FB::Memory::accountFree( FB::Memory::Category_StreamBuffer, m_blockSize );
+    }
+    m_blocks.clear();
+    m_lru.clear();
+}
@@ -0,0 +1,100 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STREAMBLOCKCACHE
+#define H_FB_STREAMBLOCKCACHE
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamBlockCache
+    ///
+    /// @brief  Fixed-size LRU cache of aligned blocks of a stream's content
+    ///
+    /// Backs BrowserStream's optional block cache (see BrowserStream::setBlockCacheSize): data
+    /// arriving from the host is folded into power-of-two-aligned blocks, and a later range
+    /// request that falls entirely within cached bytes is satisfied from memory instead of going
+    /// back to the network.  Blocks fill contiguously from their start (stream delivery within a
+    /// request is sequential), so a partially filled block can serve its valid prefix.  Least
+    /// recently used blocks are evicted when the byte budget is exceeded.
+    ///
+    /// Not thread-safe; stream data arrives and range requests are issued on the main thread.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamBlockCache : boost::noncopyable
+    {
+    public:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn StreamBlockCache::StreamBlockCache(size_t maxBytes, size_t blockSize = 64 * 1024)
+        ///
+        /// @brief  Creates a cache holding at most maxBytes (rounded down to whole blocks, at
+        ///         least one); blockSize is rounded up to a power of two
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        explicit StreamBlockCache( size_t maxBytes, size_t blockSize = 64 * 1024 );
+
+        /// Releases the blocks (and their accounting; see FB::Memory)
+        ~StreamBlockCache();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StreamBlockCache::insert(const void* data, size_t len, size_t offset)
+        ///
+        /// @brief  Folds arriving stream data at the given offset into the cache, evicting the
+        ///         least recently used blocks as needed
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void insert( const void* data, size_t len, size_t offset );
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool StreamBlockCache::lookup(size_t start, size_t end, std::vector<char>& out)
+        ///
+        /// @brief  Copies [start, end) into out if every byte of it is cached, marking the
+        ///         touched blocks most recently used
+        ///
+        /// @return true on a full hit; false (out untouched) if any byte is missing
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool lookup( size_t start, size_t end, std::vector<char>& out );
+
+        /// Drops all cached blocks
+        void clear();
+
+        size_t getBlockSize() const { return m_blockSize; }
+        /// Bytes currently held (whole blocks)
+        size_t getCachedBytes() const { return m_blocks.size() * m_blockSize; }
+
+    private:
+        struct Block
+        {
+            std::vector<char>           data;
+            size_t                      validEnd;   // bytes valid from the block start
+            std::list<size_t>::iterator lruIt;
+        };
+        typedef std::map<size_t, Block> BlockMap;
+
+        Block& getOrCreateBlock( size_t base );
+        void touch( Block& block, size_t base );
+
+        size_t              m_blockSize;    // power of two
+        size_t              m_maxBlocks;
+        BlockMap            m_blocks;       // keyed by block-aligned stream offset
+        std::list<size_t>   m_lru;          // front = most recently used
+    };
+};
+
+#endif
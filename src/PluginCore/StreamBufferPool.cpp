@@ -0,0 +1,119 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include "StreamBufferPool.h"
+
+using namespace FB;
+
+StreamBufferPool& StreamBufferPool::getInstance()
+{
+    static StreamBufferPool pool;
+    return pool;
+}
+
+StreamBufferPool::StreamBufferPool()
+    : m_pooledBytes(0), m_maxPooledBytes(2 * 1024 * 1024)
+{
+}
+
+StreamBufferPool::~StreamBufferPool()
+{
+    for ( size_t i = 0; i < m_free.size(); ++i )
+        delete m_free[i];
+}
+
+void StreamBufferPool::Recycler::operator()( std::vector<char>* buf ) const
+{
+    if ( !buf )
+        return;
+    StreamBufferPool& pool( getInstance() );
+    boost::mutex::scoped_lock _l( pool.m_mutex );
+    pool.m_free.push_back( buf );
+    pool.m_pooledBytes += buf->capacity();
+    pool.trimLocked();
+}
+
+StreamBufferPool::BufferPtr StreamBufferPool::acquire( size_t sizeHint )
+{
+    std::vector<char>* buf = 0;
+    {
+        boost::mutex::scoped_lock _l( m_mutex );
+        if ( !m_free.empty() )
+        {
+            buf = m_free.back();
+            m_free.pop_back();
+            m_pooledBytes -= buf->capacity();
+        }
+    }
+    if ( !buf )
+    {
+        buf = new std::vector<char>();
+        buf->reserve( sizeHint );
+    }
+    else
+    {
+        // clear keeps the recycled capacity; grow only if the chunk is bigger
+        buf->clear();
+        if ( buf->capacity() < sizeHint )
+            buf->reserve( sizeHint );
+    }
+    return BufferPtr( buf, Recycler() );
+}
+
+void StreamBufferPool::acquireInto( std::vector<char>& buf, size_t sizeHint )
+{
+    boost::mutex::scoped_lock _l( m_mutex );
+    if ( !m_free.empty() )
+    {
+        std::vector<char>* pooled = m_free.back();
+        m_free.pop_back();
+        m_pooledBytes -= pooled->capacity();
+        pooled->clear();
+        buf.swap( *pooled );
+        delete pooled;
+    }
+    if ( buf.capacity() < sizeHint )
+        buf.reserve( sizeHint );
+}
+
+void StreamBufferPool::release( std::vector<char>& buf )
+{
+    if ( !buf.capacity() )
+        return;
+    std::vector<char>* pooled = new std::vector<char>();
+    pooled->swap( buf );
+    boost::mutex::scoped_lock _l( m_mutex );
+    m_free.push_back( pooled );
+    m_pooledBytes += pooled->capacity();
+    trimLocked();
+}
+
+void StreamBufferPool::setMaxPooledBytes( size_t maxBytes )
+{
+    boost::mutex::scoped_lock _l( m_mutex );
+    m_maxPooledBytes = maxBytes;
+    trimLocked();
+}
+
+void StreamBufferPool::trimLocked()
+{
+    // oldest entries go first; the back of the list holds the hot buffers
+    while ( m_pooledBytes > m_maxPooledBytes && !m_free.empty() )
+    {
+        std::vector<char>* victim = m_free.front();
+        m_free.erase( m_free.begin() );
+        m_pooledBytes -= victim->capacity();
+        delete victim;
+    }
+}
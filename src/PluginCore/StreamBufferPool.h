@@ -0,0 +1,99 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STREAMBUFFERPOOL
+#define H_FB_STREAMBUFFERPOOL
+
+#include <cstddef>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamBufferPool
+    ///
+    /// @brief  Recycles the 16-64KB buffers stream delivery churns through
+    ///
+    /// Stream chunks retained past a dispatch (StreamDataArrivedEvent::copyData) and block-cache
+    /// blocks are allocated and freed at download rates -- a constant stream of identically-sized
+    /// heap blocks.  This pool keeps released buffer storage (capacity intact) on a bounded free
+    /// list shared across all streams and hosts in the process, so steady-state delivery reuses
+    /// the same hot, cache-resident blocks instead of hitting the allocator per chunk.
+    ///
+    /// Thread-safe: buffers are acquired on the main thread but a retaining handler may drop its
+    /// reference from any thread.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamBufferPool : boost::noncopyable
+    {
+    public:
+        typedef boost::shared_ptr<std::vector<char> > BufferPtr;
+
+        static StreamBufferPool& getInstance();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn BufferPtr StreamBufferPool::acquire(size_t sizeHint)
+        ///
+        /// @brief  Returns an empty buffer (capacity at least sizeHint when recycled storage
+        ///         allows) whose storage goes back to the pool when the last reference drops
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        BufferPtr acquire( size_t sizeHint );
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StreamBufferPool::acquireInto(std::vector<char>& buf, size_t sizeHint)
+        ///
+        /// @brief  Swaps recycled storage into buf for callers that hold their buffer by value;
+        ///         hand the storage back with release() when done
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void acquireInto( std::vector<char>& buf, size_t sizeHint );
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StreamBufferPool::release(std::vector<char>& buf)
+        ///
+        /// @brief  Steals buf's storage back into the pool (leaving buf empty); storage beyond
+        ///         the pooled-byte budget is simply freed
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void release( std::vector<char>& buf );
+
+        /// Caps the bytes of idle storage the pool holds (default 2MB); shrinks immediately
+        void setMaxPooledBytes( size_t maxBytes );
+
+    private:
+        StreamBufferPool();
+        ~StreamBufferPool();
+
+        // returns a pooled buffer's storage when the last BufferPtr reference drops
+        struct Recycler
+        {
+            void operator()( std::vector<char>* buf ) const;
+        };
+
+        // must be called with m_mutex held
+        void trimLocked();
+
+        boost::mutex m_mutex;
+        std::vector<std::vector<char>*> m_free;
+        size_t m_pooledBytes;       // sum of capacity() over m_free
+        size_t m_maxPooledBytes;
+    };
+};
+
+#endif
@@ -0,0 +1,162 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "StreamReadahead.h"
+
+using namespace FB;
+
+namespace {
+    // size each request at roughly this many seconds of transfer at the
+    // measured rate; small enough to react to seeks, big enough to amortize
+    // the per-request round trip
+    const double targetRequestSeconds = 1.0;
+    const double throughputAlpha = 0.3;
+}
+
+StreamReadahead::StreamReadahead(const BrowserStreamPtr& stream, size_t depth)
+  : m_stream(stream)
+  , m_depth((std::max)(depth, static_cast<size_t>(1)))
+  , m_nextOffset(0)
+  , m_stopped(false)
+  , m_sequential(false)
+  , m_lastConsumeEnd(0)
+  , m_throughput(0.0)
+  , m_minRequestSize(64 * 1024)
+  , m_maxRequestSize(4 * 1024 * 1024)
+{
+}
+
+StreamReadahead::~StreamReadahead()
+{
+}
+
+void StreamReadahead::setRequestSizeBounds(size_t minSize, size_t maxSize)
+{
+    m_minRequestSize = (std::max)(minSize, static_cast<size_t>(1));
+    m_maxRequestSize = (std::max)(maxSize, m_minRequestSize);
+}
+
+void StreamReadahead::notifyConsumed(size_t position, size_t length)
+{
+    if (m_stopped)
+        return;
+
+    // two back-to-back reads establish a sequential pattern; readahead only
+    // pays off when the consumer keeps moving forward
+    m_sequential = (position == m_lastConsumeEnd);
+    m_lastConsumeEnd = position + length;
+
+    if (m_nextOffset < m_lastConsumeEnd)
+        m_nextOffset = m_lastConsumeEnd;
+
+    if (m_sequential)
+        fillWindow();
+}
+
+void StreamReadahead::notifySeek(size_t position)
+{
+    if (m_stopped)
+        return;
+
+    // The browser APIs can't recall requests already on the wire; dropping
+    // them from the plan means their late data is ignored and no new
+    // requests are issued from the stale position
+    m_inflight.clear();
+    m_sequential = false;
+    m_lastConsumeEnd = position;
+    m_nextOffset = position;
+}
+
+void StreamReadahead::stop()
+{
+    m_stopped = true;
+    m_inflight.clear();
+}
+
+size_t StreamReadahead::nextRequestSize() const
+{
+    size_t size = m_minRequestSize;
+    if (m_throughput > 0.0) {
+        double ideal = m_throughput * targetRequestSeconds;
+        size = static_cast<size_t>((std::min)(ideal, static_cast<double>(m_maxRequestSize)));
+        size = (std::min)((std::max)(size, m_minRequestSize), m_maxRequestSize);
+    }
+    return size;
+}
+
+void StreamReadahead::fillWindow()
+{
+    BrowserStreamPtr stream(m_stream.lock());
+    if (!stream || !stream->isSeekable())
+        return;
+
+    const size_t length = stream->getLength();
+    while (m_inflight.size() < m_depth) {
+        if (length && m_nextOffset >= length)
+            return;
+        size_t end = m_nextOffset + nextRequestSize();
+        if (length)
+            end = (std::min)(end, length);
+
+        Inflight req(m_nextOffset, end);
+        req.issued = boost::posix_time::microsec_clock::universal_time();
+        if (!stream->readRange(req.start, req.end))
+            return;
+        m_inflight.push_back(req);
+        m_nextOffset = end;
+    }
+}
+
+bool StreamReadahead::onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *stream)
+{
+    if (m_stopped)
+        return false;
+
+    // match the chunk to the in-flight request it belongs to; stale data from
+    // before a seek matches nothing and is ignored
+    const size_t pos = evt->getDataPosition();
+    for (std::deque<Inflight>::iterator it = m_inflight.begin(); it != m_inflight.end(); ++it) {
+        if (pos < it->start || pos >= it->end)
+            continue;
+
+        it->received += evt->getLength();
+        if (it->received >= it->end - it->start) {
+            // request complete; fold its rate into the estimate
+            boost::posix_time::time_duration elapsed =
+                boost::posix_time::microsec_clock::universal_time() - it->issued;
+            double seconds = elapsed.total_milliseconds() / 1000.0;
+            if (seconds > 0.0) {
+                double sample = (it->end - it->start) / seconds;
+                m_throughput = m_throughput > 0.0
+                    ? m_throughput * (1.0 - throughputAlpha) + sample * throughputAlpha
+                    : sample;
+            }
+            m_inflight.erase(it);
+            if (m_sequential)
+                fillWindow();
+        }
+        break;
+    }
+    // never claim the event; the actual consumer handles the data
+    return false;
+}
+
+bool StreamReadahead::onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *stream)
+{
+    stop();
+    return false;
+}
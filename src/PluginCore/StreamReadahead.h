@@ -0,0 +1,128 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STREAMREADAHEAD
+#define H_FB_STREAMREADAHEAD
+
+#include <deque>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "BrowserStream.h"
+
+namespace FB {
+    FB_FORWARD_PTR(StreamReadahead);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamReadahead
+    ///
+    /// @brief  Predictive readahead controller for a seekable BrowserStream
+    ///
+    /// A consumer that issues readRange reactively stalls for a round trip every time it crosses
+    /// the end of its last request.  This controller watches the consumer's read position (fed in
+    /// through notifyConsumed) and keeps a configurable number of range requests in flight ahead
+    /// of it, sized from the stream's measured throughput, so sequential consumption never waits
+    /// on a cold request.  A call to notifySeek discards the readahead plan and starts a fresh
+    /// window at the new position; range requests already on the wire can't be recalled by the
+    /// browser APIs, but their late data is simply ignored by the plan and no further requests
+    /// are issued from the stale position.
+    ///
+    /// Attach it to the stream like any other event sink so it can observe data arrival:
+    /// @code
+    ///      FB::StreamReadaheadPtr ra(new FB::StreamReadahead(stream, 3));
+    ///      stream->AttachObserver(ra);
+    ///      ...
+    ///      ra->notifyConsumed(pos, len);   // as the player consumes bytes
+    ///      ra->notifySeek(newPos);         // on seek
+    /// @endcode
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamReadahead : public PluginEventSink
+    {
+    public:
+        BEGIN_PLUGIN_EVENT_MAP()
+            EVENTTYPE_CASE(FB::StreamDataArrivedEvent, onStreamDataArrived, FB::BrowserStream)
+            EVENTTYPE_CASE(FB::StreamCompletedEvent, onStreamCompleted, FB::BrowserStream)
+        END_PLUGIN_EVENT_MAP()
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn StreamReadahead::StreamReadahead(const BrowserStreamPtr& stream, size_t depth = 3)
+        ///
+        /// @brief  Creates a controller keeping up to depth range requests in flight ahead of the
+        ///         consumer (clamped to at least 1)
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        StreamReadahead(const BrowserStreamPtr& stream, size_t depth = 3);
+        virtual ~StreamReadahead();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StreamReadahead::notifyConsumed(size_t position, size_t length)
+        ///
+        /// @brief  Tells the controller the consumer has just read [position, position+length);
+        ///         sequential reads advance the readahead window and trigger new requests
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void notifyConsumed(size_t position, size_t length);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StreamReadahead::notifySeek(size_t position)
+        ///
+        /// @brief  Discards the current readahead plan and restarts the window at position; data
+        ///         from stale in-flight requests is ignored
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void notifySeek(size_t position);
+
+        /// Stops issuing requests; in-flight data is ignored from here on
+        void stop();
+
+        /// Sets the per-request size bounds; requests are sized to roughly targetSeconds of
+        /// transfer at the measured throughput, clamped to [minSize, maxSize]
+        void setRequestSizeBounds(size_t minSize, size_t maxSize);
+
+        /// Number of range requests currently in flight
+        size_t getInflightCount() const { return m_inflight.size(); }
+
+        virtual bool onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *stream);
+        virtual bool onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *stream);
+
+    protected:
+        // one in-flight readahead request
+        struct Inflight
+        {
+            Inflight() : start(0), end(0), received(0) {}
+            Inflight(size_t Start, size_t End) : start(Start), end(End), received(0) {}
+
+            size_t start;
+            size_t end;
+            size_t received;
+            boost::posix_time::ptime issued;
+        };
+
+        void fillWindow();
+        size_t nextRequestSize() const;
+
+    private:
+        BrowserStreamWeakPtr    m_stream;
+        size_t                  m_depth;
+        size_t                  m_nextOffset;       // first byte not yet requested
+        bool                    m_stopped;
+        bool                    m_sequential;       // consumer pattern looks sequential
+        size_t                  m_lastConsumeEnd;   // end of the consumer's last read
+
+        double                  m_throughput;       // bytes/sec, exponentially smoothed
+        size_t                  m_minRequestSize;
+        size_t                  m_maxRequestSize;
+
+        std::deque<Inflight>    m_inflight;
+    };
+};
+
+#endif
@@ -0,0 +1,74 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "StreamRingBuffer.h"
+
+using namespace FB;
+
+namespace {
+    size_t nextPowerOfTwo( size_t n )
+    {
+        size_t p = 16;      // don't bother with tiny rings
+        while ( p < n )
+            p <<= 1;
+        return p;
+    }
+}
+
+StreamRingBuffer::StreamRingBuffer( size_t capacity )
+  : m_buffer( nextPowerOfTwo( capacity ) )
+  , m_mask( m_buffer.size() - 1 )
+  , m_readPos( 0 )
+  , m_writePos( 0 )
+{
+}
+
+size_t StreamRingBuffer::write( const void* data, size_t len )
+{
+    const char* src = static_cast<const char*>( data );
+    size_t toWrite = (std::min)( len, freeSpace() );
+    size_t written = 0;
+    while ( written < toWrite )
+    {
+        size_t pos = m_writePos & m_mask;
+        // largest chunk that fits before the storage wraps
+        size_t chunk = (std::min)( toWrite - written, m_buffer.size() - pos );
+        std::memcpy( &m_buffer[pos], src + written, chunk );
+        m_writePos += chunk;
+        written += chunk;
+    }
+    return written;
+}
+
+const char* StreamRingBuffer::peek( size_t& len ) const
+{
+    if ( empty() )
+    {
+        len = 0;
+        return NULL;
+    }
+    size_t pos = m_readPos & m_mask;
+    len = (std::min)( size(), m_buffer.size() - pos );
+    return &m_buffer[pos];
+}
+
+void StreamRingBuffer::consume( size_t len )
+{
+    assert( len <= size() );
+    m_readPos += (std::min)( len, size() );
+}
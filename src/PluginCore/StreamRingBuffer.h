@@ -0,0 +1,106 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STREAMRINGBUFFER
+#define H_FB_STREAMRINGBUFFER
+
+#include <cstddef>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StreamRingBuffer
+    ///
+    /// @brief  Power-of-two ring buffer used as the internal buffer of a BrowserStream
+    ///
+    /// Unlike a plain byte container that compacts by copying the unread tail forward after every
+    /// read, this buffer never moves data once written; read and write positions are free-running
+    /// counters masked into the storage, so sustained high-bandwidth ingest costs one memcpy in and
+    /// zero copies out.  peek() exposes the first unread bytes as a contiguous span that consumers
+    /// (e.g. a demuxer in a DefaultBrowserStreamHandler subclass) can parse in place, then release
+    /// with consume() -- no draining into a staging buffer required.  Because the data wraps, one
+    /// logical run of unread bytes can surface as up to two spans; call peek() again after
+    /// consuming the first.
+    ///
+    /// The buffer does not grow and is not thread-safe; stream data arrives and is consumed on the
+    /// main thread.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StreamRingBuffer : boost::noncopyable
+    {
+    public:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn StreamRingBuffer::StreamRingBuffer(size_t capacity)
+        ///
+        /// @brief  Creates a ring buffer holding at least capacity bytes
+        ///
+        /// The actual capacity is capacity rounded up to the next power of two so that index
+        /// wrapping is a mask instead of a division.
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        explicit StreamRingBuffer( size_t capacity );
+
+        /// Number of unread bytes in the buffer
+        size_t size() const { return m_writePos - m_readPos; }
+        /// Total capacity in bytes (a power of two, >= the requested capacity)
+        size_t capacity() const { return m_buffer.size(); }
+        /// Bytes that can still be written before the buffer is full
+        size_t freeSpace() const { return capacity() - size(); }
+        bool empty() const { return m_readPos == m_writePos; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn size_t StreamRingBuffer::write(const void* data, size_t len)
+        ///
+        /// @brief  Copies up to len bytes into the buffer
+        ///
+        /// @return the number of bytes actually written; less than len when the buffer fills up
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        size_t write( const void* data, size_t len );
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn const char* StreamRingBuffer::peek(size_t& len) const
+        ///
+        /// @brief  Returns the first unread bytes as a contiguous span without copying them
+        ///
+        /// @param[out] len number of contiguous bytes valid at the returned pointer; may be less
+        ///                 than size() when the unread data wraps around the end of the storage
+        ///
+        /// @return pointer to the span, or NULL when the buffer is empty.  The pointer stays valid
+        ///         until the bytes are released with consume()
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        const char* peek( size_t& len ) const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void StreamRingBuffer::consume(size_t len)
+        ///
+        /// @brief  Releases len unread bytes (at most size()), making their space writable again
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void consume( size_t len );
+
+        /// Discards all unread data
+        void clear() { m_readPos = m_writePos = 0; }
+
+    private:
+        std::vector<char>   m_buffer;
+        size_t              m_mask;
+        // Free-running byte counters; masked with m_mask to index into storage.
+        // In C++03 size_t overflow is defined (modular), so the difference stays correct.
+        size_t              m_readPos;
+        size_t              m_writePos;
+    };
+};
+
+#endif
@@ -1,104 +1,118 @@
-/**********************************************************\ 
-Original Author: Dan Groom
-
-Created:    April 2, 2010
-License:    Dual license model; choose one of two:
-New BSD License
-http://www.opensource.org/licenses/bsd-license.php
-- or -
-GNU Lesser General Public License, version 2.1
-http://www.gnu.org/licenses/lgpl-2.1.html
-
-Copyright 2010 Dan Groom and the Firebreath development team
-\**********************************************************/
-
-#include "KeyCodesWin.h"
-#include <Windows.h>
-
-namespace FB {
-
-    FBKeyCode WinKeyCodeToFBKeyCode( unsigned int wparam )
-    {
-        FBKeyCode retVal = FBKEY_UNKNOWN;
-        
-        switch( wparam )
-        {
-            case VK_ADD         : retVal = FBKEY_ADD;           break;
-            case VK_MENU        : retVal = FBKEY_ALT;           break;
-            case VK_CANCEL      : retVal = FBKEY_CANCEL;        break;
-            case VK_CAPITAL     : retVal = FBKEY_CAPSLOCK;      break;
-            case VK_CLEAR       : retVal = FBKEY_CLEAR;         break;
-            case VK_CONTROL     : retVal = FBKEY_CONTROL;       break;
-            case VK_DECIMAL     : retVal = FBKEY_DECIMAL;       break;
-            case VK_DELETE      : retVal = FBKEY_DELETE;        break;
-            case VK_DIVIDE      : retVal = FBKEY_DIVIDE;        break;
-            case VK_ESCAPE      : retVal = FBKEY_ESCAPE;        break;
-            case VK_EXECUTE     : retVal = FBKEY_EXECUTE;       break;
-            case VK_F1          : retVal = FBKEY_F1;            break;
-            case VK_F10         : retVal = FBKEY_F10;           break;
-            case VK_F11         : retVal = FBKEY_F11;           break;
-            case VK_F12         : retVal = FBKEY_F12;           break;
-            case VK_F13         : retVal = FBKEY_F13;           break;
-            case VK_F14         : retVal = FBKEY_F14;           break;
-            case VK_F15         : retVal = FBKEY_F15;           break;
-            case VK_F16         : retVal = FBKEY_F16;           break;
-            case VK_F17         : retVal = FBKEY_F17;           break;
-            case VK_F18         : retVal = FBKEY_F18;           break;
-            case VK_F19         : retVal = FBKEY_F19;           break;
-            case VK_F2          : retVal = FBKEY_F2;            break;
-            case VK_F20         : retVal = FBKEY_F20;           break;
-            case VK_F21         : retVal = FBKEY_F21;           break;
-            case VK_F22         : retVal = FBKEY_F22;           break;
-            case VK_F3          : retVal = FBKEY_F3;            break;
-            case VK_F4          : retVal = FBKEY_F4;            break;
-            case VK_F5          : retVal = FBKEY_F5;            break;
-            case VK_F6          : retVal = FBKEY_F6;            break;
-            case VK_F7          : retVal = FBKEY_F7;            break;
-            case VK_F8          : retVal = FBKEY_F8;            break;
-            case VK_F9          : retVal = FBKEY_F9;            break;
-            case VK_HELP        : retVal = FBKEY_HELP;          break;
-            case VK_INSERT      : retVal = FBKEY_INSERT;        break;
-            case VK_LBUTTON     : retVal = FBKEY_LBUTTON;       break;
-            case VK_MBUTTON     : retVal = FBKEY_MBUTTON;       break;
-            case VK_MULTIPLY    : retVal = FBKEY_MULTIPLY;      break;
-            case VK_NUMLOCK     : retVal = FBKEY_NUMLOCK;       break;
-            case VK_NUMPAD0     : retVal = FBKEY_NUMPAD0;       break;
-            case VK_NUMPAD1     : retVal = FBKEY_NUMPAD1;       break;
-            case VK_NUMPAD2     : retVal = FBKEY_NUMPAD2;       break;
-            case VK_NUMPAD3     : retVal = FBKEY_NUMPAD3;       break;
-            case VK_NUMPAD4     : retVal = FBKEY_NUMPAD4;       break;
-            case VK_NUMPAD5     : retVal = FBKEY_NUMPAD5;       break;
-            case VK_NUMPAD6     : retVal = FBKEY_NUMPAD6;       break;
-            case VK_NUMPAD7     : retVal = FBKEY_NUMPAD7;       break;
-            case VK_NUMPAD8     : retVal = FBKEY_NUMPAD8;       break;
-            case VK_NUMPAD9     : retVal = FBKEY_NUMPAD9;       break;          
-            case VK_NEXT        : retVal = FBKEY_PAGEDOWN;      break;
-            case VK_PRIOR       : retVal = FBKEY_PAGEUP;        break;
-            case VK_RBUTTON     : retVal = FBKEY_RBUTTON;       break;
-            case VK_RETURN      : retVal = FBKEY_RETURN;        break;
-            case VK_SCROLL      : retVal = FBKEY_SCROLL ;       break;
-            case VK_SELECT      : retVal = FBKEY_SELECT;        break;
-            case VK_SEPARATOR   : retVal = FBKEY_SEPARATOR;     break;
-            case VK_SHIFT       : retVal = FBKEY_SHIFT;         break;
-            case VK_SNAPSHOT    : retVal = FBKEY_PRINTSCREEN;   break;
-            case VK_SPACE       : retVal = FBKEY_SPACE;         break;          
-            case VK_SUBTRACT    : retVal = FBKEY_SUBTRACT;      break;
-            case VK_TAB         : retVal = FBKEY_TAB;           break;
-            case VK_UP          : retVal = FBKEY_UP;            break;
-            case VK_DOWN        : retVal = FBKEY_DOWN;          break;
-            case VK_LEFT        : retVal = FBKEY_LEFT;          break;
-            case VK_RIGHT       : retVal = FBKEY_RIGHT;         break;
-            case VK_LWIN        : retVal = FBKEY_WINDOWS_LEFT;  break;
-            case VK_APPS        : retVal = FBKEY_WINDOWS_MENU;  break;
-            case VK_RWIN        : retVal = FBKEY_WINDOWS_RIGHT; break;
-            case VK_BACK        : retVal = FBKEY_BACKSPACE;     break;
-            case VK_END         : retVal = FBKEY_END;           break;
-            case VK_HOME        : retVal = FBKEY_HOME;          break;
-            case VK_PAUSE       : retVal = FBKEY_PAUSE;         break;
-            case VK_PRINT       : retVal = FBKEY_PRINT;         break;
-        }
-
-        return retVal;
-    }
-
-}
+/**********************************************************\
+Original Author: Dan Groom
+
+Created:    April 2, 2010
+License:    Dual license model; choose one of two:
+New BSD License
+http://www.opensource.org/licenses/bsd-license.php
+- or -
+GNU Lesser General Public License, version 2.1
+http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 Dan Groom and the Firebreath development team
+\**********************************************************/
+
+#include "KeyCodesWin.h"
+#include <Windows.h>
+
+namespace FB {
+
+    namespace {
+        // Dense VK -> FBKeyCode table built once at module load; per-keystroke
+        // translation is then a single bounds check and load.  (The VK_*
+        // values can't be used as aggregate-initializer positions at this
+        // language level, so the table is filled during static initialization
+        // rather than literally at compile time.)
+        FBKeyCode g_vkToFBKey[256];
+
+        bool buildKeyTable()
+        {
+            for (int i = 0; i < 256; ++i)
+                g_vkToFBKey[i] = FBKEY_UNKNOWN;
+
+            g_vkToFBKey[VK_ADD]         = FBKEY_ADD;
+            g_vkToFBKey[VK_MENU]        = FBKEY_ALT;
+            g_vkToFBKey[VK_CANCEL]      = FBKEY_CANCEL;
+            g_vkToFBKey[VK_CAPITAL]     = FBKEY_CAPSLOCK;
+            g_vkToFBKey[VK_CLEAR]       = FBKEY_CLEAR;
+            g_vkToFBKey[VK_CONTROL]     = FBKEY_CONTROL;
+            g_vkToFBKey[VK_DECIMAL]     = FBKEY_DECIMAL;
+            g_vkToFBKey[VK_DELETE]      = FBKEY_DELETE;
+            g_vkToFBKey[VK_DIVIDE]      = FBKEY_DIVIDE;
+            g_vkToFBKey[VK_ESCAPE]      = FBKEY_ESCAPE;
+            g_vkToFBKey[VK_EXECUTE]     = FBKEY_EXECUTE;
+            g_vkToFBKey[VK_F1]          = FBKEY_F1;
+            g_vkToFBKey[VK_F2]          = FBKEY_F2;
+            g_vkToFBKey[VK_F3]          = FBKEY_F3;
+            g_vkToFBKey[VK_F4]          = FBKEY_F4;
+            g_vkToFBKey[VK_F5]          = FBKEY_F5;
+            g_vkToFBKey[VK_F6]          = FBKEY_F6;
+            g_vkToFBKey[VK_F7]          = FBKEY_F7;
+            g_vkToFBKey[VK_F8]          = FBKEY_F8;
+            g_vkToFBKey[VK_F9]          = FBKEY_F9;
+            g_vkToFBKey[VK_F10]         = FBKEY_F10;
+            g_vkToFBKey[VK_F11]         = FBKEY_F11;
+            g_vkToFBKey[VK_F12]         = FBKEY_F12;
+            g_vkToFBKey[VK_F13]         = FBKEY_F13;
+            g_vkToFBKey[VK_F14]         = FBKEY_F14;
+            g_vkToFBKey[VK_F15]         = FBKEY_F15;
+            g_vkToFBKey[VK_F16]         = FBKEY_F16;
+            g_vkToFBKey[VK_F17]         = FBKEY_F17;
+            g_vkToFBKey[VK_F18]         = FBKEY_F18;
+            g_vkToFBKey[VK_F19]         = FBKEY_F19;
+            g_vkToFBKey[VK_F20]         = FBKEY_F20;
+            g_vkToFBKey[VK_F21]         = FBKEY_F21;
+            g_vkToFBKey[VK_F22]         = FBKEY_F22;
+            g_vkToFBKey[VK_HELP]        = FBKEY_HELP;
+            g_vkToFBKey[VK_INSERT]      = FBKEY_INSERT;
+            g_vkToFBKey[VK_LBUTTON]     = FBKEY_LBUTTON;
+            g_vkToFBKey[VK_MBUTTON]     = FBKEY_MBUTTON;
+            g_vkToFBKey[VK_MULTIPLY]    = FBKEY_MULTIPLY;
+            g_vkToFBKey[VK_NUMLOCK]     = FBKEY_NUMLOCK;
+            g_vkToFBKey[VK_NUMPAD0]     = FBKEY_NUMPAD0;
+            g_vkToFBKey[VK_NUMPAD1]     = FBKEY_NUMPAD1;
+            g_vkToFBKey[VK_NUMPAD2]     = FBKEY_NUMPAD2;
+            g_vkToFBKey[VK_NUMPAD3]     = FBKEY_NUMPAD3;
+            g_vkToFBKey[VK_NUMPAD4]     = FBKEY_NUMPAD4;
+            g_vkToFBKey[VK_NUMPAD5]     = FBKEY_NUMPAD5;
+            g_vkToFBKey[VK_NUMPAD6]     = FBKEY_NUMPAD6;
+            g_vkToFBKey[VK_NUMPAD7]     = FBKEY_NUMPAD7;
+            g_vkToFBKey[VK_NUMPAD8]     = FBKEY_NUMPAD8;
+            g_vkToFBKey[VK_NUMPAD9]     = FBKEY_NUMPAD9;
+            g_vkToFBKey[VK_NEXT]        = FBKEY_PAGEDOWN;
+            g_vkToFBKey[VK_PRIOR]       = FBKEY_PAGEUP;
+            g_vkToFBKey[VK_RBUTTON]     = FBKEY_RBUTTON;
+            g_vkToFBKey[VK_RETURN]      = FBKEY_RETURN;
+            g_vkToFBKey[VK_SCROLL]      = FBKEY_SCROLL;
+            g_vkToFBKey[VK_SELECT]      = FBKEY_SELECT;
+            g_vkToFBKey[VK_SEPARATOR]   = FBKEY_SEPARATOR;
+            g_vkToFBKey[VK_SHIFT]       = FBKEY_SHIFT;
+            g_vkToFBKey[VK_SNAPSHOT]    = FBKEY_PRINTSCREEN;
+            g_vkToFBKey[VK_SPACE]       = FBKEY_SPACE;
+            g_vkToFBKey[VK_SUBTRACT]    = FBKEY_SUBTRACT;
+            g_vkToFBKey[VK_TAB]         = FBKEY_TAB;
+            g_vkToFBKey[VK_UP]          = FBKEY_UP;
+            g_vkToFBKey[VK_DOWN]        = FBKEY_DOWN;
+            g_vkToFBKey[VK_LEFT]        = FBKEY_LEFT;
+            g_vkToFBKey[VK_RIGHT]       = FBKEY_RIGHT;
+            g_vkToFBKey[VK_LWIN]        = FBKEY_WINDOWS_LEFT;
+            g_vkToFBKey[VK_APPS]        = FBKEY_WINDOWS_MENU;
+            g_vkToFBKey[VK_RWIN]        = FBKEY_WINDOWS_RIGHT;
+            g_vkToFBKey[VK_BACK]        = FBKEY_BACKSPACE;
+            g_vkToFBKey[VK_END]         = FBKEY_END;
+            g_vkToFBKey[VK_HOME]        = FBKEY_HOME;
+            g_vkToFBKey[VK_PAUSE]       = FBKEY_PAUSE;
+            g_vkToFBKey[VK_PRINT]       = FBKEY_PRINT;
+            return true;
+        }
+
+        const bool g_keyTableBuilt = buildKeyTable();
+    }
+
+    FBKeyCode WinKeyCodeToFBKeyCode( unsigned int wparam )
+    {
+        (void)g_keyTableBuilt;
+        return wparam < 256 ? g_vkToFBKey[wparam] : FBKEY_UNKNOWN;
+    }
+
+}
@@ -9,7 +9,7 @@
 
 extern HINSTANCE gInstance;
 
-FB::WinMessageWindow::WinMessageWindow() {
+FB::WinMessageWindow::WinMessageWindow() : m_asyncPending(0) {
     WNDCLASSEX wc;
     DWORD err(0);
     static ATOM clsAtom(NULL);
@@ -49,6 +49,8 @@ FB::WinMessageWindow::WinMessageWindow() {
         throw std::runtime_error("Could not create Message Window");
     }
     m_hWnd = messageWin;
+    // Let _WinProc (and postFunctionCall) find us from the bare HWND
+    ::SetWindowLongPtr(m_hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
 }
 
 LRESULT CALLBACK FB::WinMessageWindow::_WinProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam )
@@ -59,10 +61,62 @@ LRESULT CALLBACK FB::WinMessageWindow::_WinProc( HWND hWnd, UINT uMsg, WPARAM wP
         evt->func(evt->userData);
         delete evt;
         return S_OK;
+    } else if (uMsg == WM_ASYNCTHREADDRAIN) {
+        WinMessageWindow* win =
+            reinterpret_cast<WinMessageWindow*>(::GetWindowLongPtr(hWnd, GWLP_USERDATA));
+        if (win) {
+            win->drainAsyncQueue();
+        }
+        return S_OK;
     }
     return DefWindowProc(hWnd, uMsg, wParam, lParam);
 }
 
+bool FB::WinMessageWindow::scheduleAsyncCall( void (*func)(void*), void* userData )
+{
+    m_asyncQueue.push(std::make_pair(func, userData));
+    // Only the first call of a burst posts the wakeup; the drain picks up
+    // everything queued behind it
+    if (::InterlockedExchange(&m_asyncPending, 1) == 0) {
+        if (!::PostMessage(m_hWnd, WM_ASYNCTHREADDRAIN, NULL, NULL)) {
+            ::InterlockedExchange(&m_asyncPending, 0);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FB::WinMessageWindow::postFunctionCall( HWND hWnd, void (*func)(void*), void* userData )
+{
+    WinMessageWindow* win =
+        reinterpret_cast<WinMessageWindow*>(::GetWindowLongPtr(hWnd, GWLP_USERDATA));
+    if (win) {
+        return win->scheduleAsyncCall(func, userData);
+    }
+    // Not a WinMessageWindow; fall back to one message per call
+    return ::PostMessage(hWnd, WM_ASYNCTHREADINVOKE, NULL,
+        (LPARAM)new FB::AsyncFunctionCall(func, userData)) ? true : false;
+}
+
+void FB::WinMessageWindow::drainAsyncQueue()
+{
+    ::InterlockedExchange(&m_asyncPending, 0);
+    // Cap the work done per message so input and painting stay interleaved
+    // when the queue is deep; the remainder gets a fresh wakeup
+    const size_t maxPerMessage = 64;
+    size_t processed = 0;
+    QueuedCall call;
+    while (processed < maxPerMessage && m_asyncQueue.try_pop(call)) {
+        FBLOG_TRACE("PluginWindow", "Running async function call");
+        call.first(call.second);
+        ++processed;
+    }
+    if (!m_asyncQueue.empty()
+        && ::InterlockedExchange(&m_asyncPending, 1) == 0) {
+        ::PostMessage(m_hWnd, WM_ASYNCTHREADDRAIN, NULL, NULL);
+    }
+}
+
 HWND FB::WinMessageWindow::getHWND()
 {
     return m_hWnd;
@@ -70,5 +124,6 @@ HWND FB::WinMessageWindow::getHWND()
 
 FB::WinMessageWindow::~WinMessageWindow()
 {
+    ::SetWindowLongPtr(m_hWnd, GWLP_USERDATA, 0);
     ::DestroyWindow(m_hWnd);
 }
@@ -2,7 +2,9 @@
 #ifndef WinMessageWindow_h__
 #define WinMessageWindow_h__
 
+#include <utility>
 #include <boost/noncopyable.hpp>
+#include "SafeQueue.h"
 
 namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -10,7 +12,12 @@ namespace FB {
     ///
     /// @brief  Creates a message window. Don't touch this if you don't understand what you are doing
     ///
-    /// @return The handle of the window. 
+    /// Async function calls routed through scheduleAsyncCall are queued and drained in batches:
+    /// one posted "work available" message services up to a whole burst of queued functors, so a
+    /// storm of cross-thread events costs one PostMessage/GetMessage kernel transition per batch
+    /// rather than one per event (and can't overflow the Windows message queue).
+    ///
+    /// @return The handle of the window.
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     class WinMessageWindow : boost::noncopyable
     {
@@ -20,9 +27,23 @@ namespace FB {
 
         HWND getHWND();
 
+        /// Queues func to run on the window's thread; returns false if the
+        /// wakeup message could not be posted
+        bool scheduleAsyncCall(void (*func)(void*), void* userData);
+
+        /// Routes a call through the owning WinMessageWindow's batched queue when
+        /// hWnd is one, else falls back to posting one WM_ASYNCTHREADINVOKE message
+        static bool postFunctionCall(HWND hWnd, void (*func)(void*), void* userData);
+
         static LRESULT CALLBACK _WinProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
     private:
+        void drainAsyncQueue();
+
+        typedef std::pair<void (*)(void*), void*> QueuedCall;
         HWND m_hWnd;
+        FB::SafeQueue<QueuedCall> m_asyncQueue;
+        // Nonzero while a drain message is posted and not yet processed
+        volatile LONG m_asyncPending;
     };
 }
-#endif // WinMessageWindow_h__
\ No newline at end of file
+#endif // WinMessageWindow_h__
@@ -20,8 +20,10 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include <vector>
 #include <map>
 #include <set>
+#include <boost/container/flat_map.hpp>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/variant/variant_fwd.hpp>
 #include "FBPointers.h"
 
@@ -66,9 +68,16 @@ namespace FB
     /// @typedef    FB::VariantMap
     ///
     /// @brief  Defines an alias representing a string -> variant map.
+    ///
+    /// Backed by a sorted flat vector rather than a node-based tree; the maps
+    /// that cross the scripting API hold a handful of keys, where contiguous
+    /// storage wins on construction, lookup and copy and does one allocation
+    /// instead of one per entry.  The interface matches std::map with the
+    /// usual flat-container caveats: insert and erase invalidate iterators,
+    /// and value_type's key is not const.
     /// @see FB::variant_map_of()
     ////////////////////////////////////////////////////////////////////////////////////////////////////
-    typedef std::map<std::string, variant> VariantMap;
+    typedef boost::container::flat_map<std::string, variant> VariantMap;
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @typedef    FB::StringSet
@@ -76,6 +85,15 @@ namespace FB
     /// @brief  Defines an alias representing a set of std::strings
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     typedef std::set<std::string> StringSet;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @typedef    FB::MemberNameListPtr
+    ///
+    /// @brief  Shared, immutable list of member names
+    /// @see FB::JSAPI::getMemberNamesSnapshot()
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    typedef boost::shared_ptr<const std::vector<std::string> > MemberNameListPtr;
     
     // FB pointer types
 
@@ -269,6 +287,12 @@ namespace FB
     /// @brief  Used to set a SecurityZone for a method or property -- used by JSAPIAuto
     typedef int SecurityZone;
 
+    /// @brief  Stable integer handle for a member of a JSAPI object, resolved once with
+    ///         FB::JSAPI::getMemberId and then used for name-free dispatch
+    typedef size_t MemberId;
+    /// @brief  Returned by FB::JSAPI::getMemberId for names it cannot resolve to a member
+    const MemberId InvalidMemberId = static_cast<MemberId>(-1);
+
     /// @brief  Default SecurityZone values; you can use these or provide your own
     enum SecurityLevel {
         SecurityScope_Public = 0,
@@ -283,17 +307,19 @@ namespace FB
     {
         CallMethodFunctor call;
         SecurityZone zone;
-        MethodFunctors() : call() {}
-        MethodFunctors(const CallMethodFunctor& call) : call(call) {}
-        MethodFunctors(const SecurityZone& zone, const CallMethodFunctor& call) : call(call) {}
-        MethodFunctors(const MethodFunctors& m) : call(m.call) {}
+        MethodFunctors() : call(), zone(SecurityScope_Public) {}
+        MethodFunctors(const CallMethodFunctor& call) : call(call), zone(SecurityScope_Public) {}
+        MethodFunctors(const SecurityZone& zone, const CallMethodFunctor& call) : call(call), zone(zone) {}
+        MethodFunctors(const MethodFunctors& m) : call(m.call), zone(m.zone) {}
         MethodFunctors& operator=(const MethodFunctors& rhs) {
             call = rhs.call;
+            zone = rhs.zone;
             return *this;
         }
     };
-    /// @brief  Defines an alias representing a map of method functors used by FB::JSAPIAuto
-    typedef std::map<std::string, MethodFunctors> MethodFunctorMap;
+    /// @brief  Defines an alias representing a map of method functors used by FB::JSAPIAuto;
+    ///         hashed since method dispatch looks the name up on every scripted call
+    typedef boost::unordered_map<std::string, MethodFunctors> MethodFunctorMap;
 
     // new style JSAPI properties
 
@@ -306,19 +332,22 @@ namespace FB
     {
         GetPropFunctor get;
         SetPropFunctor set;
-        PropertyFunctors() : get(), set() {}
+        SecurityZone zone;
+        PropertyFunctors() : get(), set(), zone(SecurityScope_Public) {}
         PropertyFunctors(const GetPropFunctor& get, const SetPropFunctor& set)
-          : get(get), set(set) {}
+          : get(get), set(set), zone(SecurityScope_Public) {}
         PropertyFunctors(const PropertyFunctors& p)
-          : get(p.get), set(p.set) {}
+          : get(p.get), set(p.set), zone(p.zone) {}
         PropertyFunctors& operator=(const PropertyFunctors& rhs) {
             get = rhs.get;
             set = rhs.set;
+            zone = rhs.zone;
             return *this;
         }
     };
-    /// @brief  Defines an alias representing a map of property functors used by FB::JSAPIAuto
-    typedef std::map<std::string, PropertyFunctors> PropertyFunctorsMap;
+    /// @brief  Defines an alias representing a map of property functors used by FB::JSAPIAuto;
+    ///         hashed since property access looks the name up on every scripted get/set
+    typedef boost::unordered_map<std::string, PropertyFunctors> PropertyFunctorsMap;
 
     // JSAPI event handlers
 
@@ -18,6 +18,8 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 #ifdef FB_WIN
 #define WM_ASYNCTHREADINVOKE    WM_USER + 1
+// "Work available" wakeup for WinMessageWindow's batched async call queue
+#define WM_ASYNCTHREADDRAIN     (WM_USER + 2)
 #endif
 
 #include <boost/shared_ptr.hpp>
@@ -0,0 +1,44 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <boost/lexical_cast.hpp>
+#include "JSObject.h"
+
+#include "BinaryData.h"
+
+FB::BinaryData FB::BinaryData::fromJSObject(const FB::JSObjectPtr& obj)
+{
+    if (!obj)
+        return BinaryData();
+    const size_t len = obj->GetProperty("length").convert_cast<size_t>();
+    boost::shared_ptr<Buffer> out(new Buffer());
+    out->reserve(len);
+
+    const size_t blockSize = 256;
+    std::vector<std::string> names;
+    for (size_t start = 0; start < len; start += blockSize) {
+        size_t end = start + blockSize;
+        if (end > len)
+            end = len;
+        names.clear();
+        names.reserve(end - start);
+        for (size_t i = start; i < end; ++i)
+            names.push_back(boost::lexical_cast<std::string>(i));
+        FB::VariantMap values = obj->GetProperties(names);
+        for (size_t i = start; i < end; ++i)
+            out->push_back(static_cast<unsigned char>(
+                values[names[i - start]].convert_cast<int>()));
+    }
+    return BinaryData(BufferPtr(out));
+}
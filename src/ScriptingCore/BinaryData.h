@@ -0,0 +1,90 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_BINARYDATA
+#define H_FB_BINARYDATA
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "APITypes.h"
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  BinaryData
+    ///
+    /// @brief  Binary buffer payload for exchanging raw bytes with Javascript
+    ///
+    /// Put one of these in a variant you return (or pass to InvokeAsync) and the browser glue
+    /// turns it into a JS Uint8Array where the page supports typed arrays, falling back to a
+    /// plain Array of numbers otherwise -- no base64 round trip, no utf8 conversion, no 3x
+    /// size blowup.  The bytes are held by shared_ptr, so copying a BinaryData (including the
+    /// copies the variant machinery makes) never copies the payload; adopt() takes a buffer
+    /// off your hands without copying it even once.
+    ///
+    /// @code
+    ///     std::vector<unsigned char> frame = captureFrame();
+    ///     return FB::BinaryData::adopt(frame);    // frame is empty afterwards
+    /// @endcode
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class BinaryData
+    {
+    public:
+        typedef std::vector<unsigned char> Buffer;
+        typedef boost::shared_ptr<const Buffer> BufferPtr;
+
+        BinaryData() { }
+        /// shares ownership of an existing buffer; no copy
+        explicit BinaryData(const BufferPtr& buffer) : m_buffer(buffer) { }
+        /// copies size bytes starting at data
+        BinaryData(const unsigned char* data, size_t size)
+            : m_buffer(new Buffer(data, data + size)) { }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn static BinaryData adopt(Buffer& buffer)
+        ///
+        /// @brief  Takes the contents of buffer without copying; buffer is left empty
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        static BinaryData adopt(Buffer& buffer)
+        {
+            boost::shared_ptr<Buffer> owned(new Buffer());
+            owned->swap(buffer);
+            return BinaryData(BufferPtr(owned));
+        }
+
+        const unsigned char* data() const { return m_buffer && !m_buffer->empty() ? &(*m_buffer)[0] : NULL; }
+        size_t size() const { return m_buffer ? m_buffer->size() : 0; }
+        bool empty() const { return !size(); }
+        const BufferPtr& buffer() const { return m_buffer; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn static BinaryData fromJSObject(const JSObjectPtr& obj)
+        ///
+        /// @brief  Copies the bytes out of a JS typed array (or any array-like of numbers)
+        ///
+        /// Elements are pulled in blocks through the batched property API, so a typed array
+        /// handed to the plugin costs length/256 crossings rather than one per byte.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        static BinaryData fromJSObject(const JSObjectPtr& obj);
+
+    private:
+        BufferPtr m_buffer;
+    };
+};
+
+#endif
@@ -15,6 +15,14 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include <cstdio>
 #include <cassert>
 #include <algorithm>
+#include <deque>
+#include <new>
+#include <sstream>
+#include <boost/pool/singleton_pool.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
 #include <boost/lambda/construct.hpp>
@@ -24,33 +32,160 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #include "logging.h"
 
 #include "BrowserHost.h"
+#include "CrossThreadCall.h"
+#include "PreparedScript.h"
+#include "MemoryAccounting.h"
+#include "ConversionStats.h"
+#include "TimerService.h"
+#include "MainThreadWatchdog.h"
 #include <boost/smart_ptr/enable_shared_from_this.hpp>
 
+namespace {
+    // Upper bound on buffered html log lines; beyond this the oldest are dropped
+    static const size_t HtmlLogMaxLines = 256;
+
+    // Teardown reaper: shutdown() hands the heavy containers (retained
+    // objects, managed callbacks, pending invokes) here and returns, so the
+    // browser isn't kept waiting in NPP_Destroy while thousands of wrappers
+    // are destroyed.  One process-wide thread drains the handed-off work in
+    // bounded slices, yielding between them.
+    class TeardownReaper {
+    public:
+        static TeardownReaper& getInstance() {
+            static TeardownReaper instance;
+            return instance;
+        }
+
+        void defer(const boost::function<void ()>& task) {
+            {
+                boost::mutex::scoped_lock _l(m_mutex);
+                m_tasks.push_back(task);
+                if (!m_thread)
+                    m_thread.reset(new boost::thread(boost::bind(&TeardownReaper::run, this)));
+            }
+            m_cond.notify_one();
+        }
+
+    private:
+        TeardownReaper() : m_stop(false) { }
+        ~TeardownReaper() {
+            {
+                boost::mutex::scoped_lock _l(m_mutex);
+                m_stop = true;
+            }
+            m_cond.notify_all();
+            if (m_thread)
+                m_thread->join();
+        }
+
+        void run() {
+            for (;;) {
+                boost::function<void ()> task;
+                {
+                    boost::unique_lock<boost::mutex> _l(m_mutex);
+                    while (m_tasks.empty() && !m_stop)
+                        m_cond.wait(_l);
+                    if (m_tasks.empty())
+                        return;     // stopping and nothing left to release
+                    task = m_tasks.front();
+                    m_tasks.pop_front();
+                }
+                try {
+                    task();
+                } catch (...) { }
+                boost::this_thread::yield();
+            }
+        }
+
+        boost::mutex m_mutex;
+        boost::condition_variable m_cond;
+        std::list<boost::function<void ()> > m_tasks;
+        boost::scoped_ptr<boost::thread> m_thread;
+        bool m_stop;
+    };
+
+    // Destroys a handed-off container a bounded slice at a time so one huge
+    // teardown can't monopolize the reaper
+    template <class C>
+    void destroyContainerSliced(boost::shared_ptr<C> container) {
+        while (!container->empty()) {
+            typename C::iterator it = container->begin();
+            for (size_t n = 0; n < 64 && it != container->end(); ++n)
+                container->erase(it++);
+            boost::this_thread::yield();
+        }
+    }
+}
+
 void FB::BrowserHost::htmlLog(const std::string& str)
 {
     FBLOG_INFO("BrowserHost", "Logging to HTML: " << str);
-    this->ScheduleAsyncCall(&FB::BrowserHost::AsyncHtmlLog,
-        new FB::AsyncLogRequest(shared_from_this(), str));
+    bool needFlush(false);
+    {
+        boost::mutex::scoped_lock _l(m_htmlLogMutex);
+        if (m_htmlLogLines.size() >= HtmlLogMaxLines) {
+            // Drop-oldest overflow; logging must never stall the data path
+            m_htmlLogLines.pop_front();
+            ++m_htmlLogDropped;
+        }
+        m_htmlLogLines.push_back(str);
+        if (!m_htmlLogFlushPending) {
+            m_htmlLogFlushPending = true;
+            needFlush = true;
+        }
+    }
+    // One flush call per burst; everything logged before it runs goes out in
+    // a single batched console.log round trip
+    if (needFlush
+        && !ScheduleAsyncCall(&FB::BrowserHost::AsyncHtmlLog,
+               new FB::AsyncLogRequest(shared_from_this(), std::string()))) {
+        boost::mutex::scoped_lock _l(m_htmlLogMutex);
+        m_htmlLogFlushPending = false;
+    }
 }
 
 void FB::BrowserHost::AsyncHtmlLog(void *logReq)
 {
-    FB::AsyncLogRequest *req = (FB::AsyncLogRequest*)logReq;
+    boost::scoped_ptr<FB::AsyncLogRequest> req(static_cast<FB::AsyncLogRequest*>(logReq));
+    req->m_host->flushHtmlLog();
+}
+
+void FB::BrowserHost::flushHtmlLog()
+{
+    std::deque<std::string> lines;
+    size_t dropped(0);
+    {
+        boost::mutex::scoped_lock _l(m_htmlLogMutex);
+        lines.swap(m_htmlLogLines);
+        dropped = m_htmlLogDropped;
+        m_htmlLogDropped = 0;
+        m_htmlLogFlushPending = false;
+    }
+    if (lines.empty()) {
+        return;
+    }
+    std::string msg;
+    if (dropped) {
+        std::ostringstream note;
+        note << "(html log overflow: " << dropped << " lines dropped)";
+        msg = note.str();
+    }
+    for (std::deque<std::string>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+        if (!msg.empty())
+            msg += '\n';
+        msg += *it;
+    }
     try {
-        FB::DOM::WindowPtr window = req->m_host->getDOMWindow();
+        FB::DOM::WindowPtr window = getDOMWindow();
 
         if (window->getJSObject()->HasProperty("console")) {
             FB::JSObjectPtr obj = window->getProperty<FB::JSObjectPtr>("console");
-            printf("Logging: %s\n", req->m_msg.c_str());
-            obj->Invoke("log", FB::variant_list_of(req->m_msg));
+            obj->Invoke("log", FB::variant_list_of(msg));
         }
     } catch (const std::exception &) {
-        // printf("Exception: %s\n", e.what());
         // Fail silently; logging should not require success.
         FBLOG_TRACE("BrowserHost", "Logging to browser console failed");
-        return;
     }
-    delete req;
 }
 
 void FB::BrowserHost::evaluateJavaScript(const std::wstring &script)
@@ -58,24 +193,129 @@ void FB::BrowserHost::evaluateJavaScript(const std::wstring &script)
     evaluateJavaScript(FB::wstring_to_utf8(script));
 }
 
+FB::PreparedScriptPtr FB::BrowserHost::prepareScript(const std::string &functionDef)
+{
+    assertMainThread();
+    // Unique temporary name per prepared script; main-thread only, so a plain
+    // counter is fine
+    static unsigned int preparedCount(0);
+    std::ostringstream nameStream;
+    nameStream << "__fbPreparedScript" << ++preparedCount;
+    const std::string name(nameStream.str());
+
+    // Define it, pull the compiled function off the window, then clean the
+    // temporary up again.  execScript can't return a value, so routing through
+    // a window property is what works on every browser
+    evaluateJavaScript("window." + name + " = (" + functionDef + ");");
+    FB::JSObjectPtr window(getDOMWindow()->getJSObject());
+    FB::JSObjectPtr func;
+    try {
+        func = window->GetProperty(name).convert_cast<FB::JSObjectPtr>();
+    } catch (const FB::bad_variant_cast&) {
+        // fall through to the error below with the temporary cleaned up
+    }
+    evaluateJavaScript("try { delete window." + name + "; } catch (e) { window." + name + " = null; }");
+    if (!func)
+        throw FB::script_error("Prepared script did not evaluate to a function");
+    return boost::make_shared<FB::PreparedScript>(func);
+}
+
+FB::variant FB::BrowserHost::evaluateJavaScriptWithResult(const std::string &script)
+{
+    // Default for hosts whose browser can't hand a result back (ActiveX)
+    evaluateJavaScript(script);
+    return FB::variant();
+}
+
+namespace {
+    // Heap-allocated token for a scheduled flush or scan; holds the host alive
+    // until the callback runs, just like AsyncLogRequest does for the html log
+    struct _asyncHostRequest {
+        _asyncHostRequest(const FB::BrowserHostPtr& host) : m_host(host) { }
+        const FB::BrowserHostPtr m_host;
+    };
+}
+
+void FB::BrowserHost::evaluateJavaScriptAsync(const std::string &script, const FB::JSEvalCallback& callback)
+{
+    bool needFlush(false);
+    {
+        boost::mutex::scoped_lock _l(m_evalMutex);
+        m_pendingEvals.push_back(PendingEval(script, callback));
+        if (!m_evalFlushPending) {
+            m_evalFlushPending = true;
+            needFlush = true;
+        }
+    }
+    // One flush call per burst; every script queued before it runs is
+    // evaluated in a single main-thread batch
+    if (needFlush
+        && !ScheduleAsyncCall(&FB::BrowserHost::AsyncEvalFlush,
+               new _asyncHostRequest(shared_from_this()))) {
+        // Never going to run (host is shutting down); fail the queued
+        // callbacks rather than leaving them waiting forever
+        std::deque<PendingEval> abandoned;
+        {
+            boost::mutex::scoped_lock _l(m_evalMutex);
+            abandoned.swap(m_pendingEvals);
+            m_evalFlushPending = false;
+        }
+        for (std::deque<PendingEval>::const_iterator it = abandoned.begin(); it != abandoned.end(); ++it) {
+            if (it->callback)
+                it->callback(false, FB::variant(std::string("Browser host is shut down")));
+        }
+    }
+}
+
+void FB::BrowserHost::AsyncEvalFlush(void *evalReq)
+{
+    boost::scoped_ptr<_asyncHostRequest> req(static_cast<_asyncHostRequest*>(evalReq));
+    req->m_host->flushPendingEvals();
+}
+
+void FB::BrowserHost::flushPendingEvals()
+{
+    std::deque<PendingEval> batch;
+    {
+        boost::mutex::scoped_lock _l(m_evalMutex);
+        batch.swap(m_pendingEvals);
+        m_evalFlushPending = false;
+    }
+    for (std::deque<PendingEval>::const_iterator it = batch.begin(); it != batch.end(); ++it) {
+        try {
+            FB::variant result(evaluateJavaScriptWithResult(it->script));
+            if (it->callback)
+                it->callback(true, result);
+        } catch (const std::exception &e) {
+            if (it->callback)
+                it->callback(false, FB::variant(std::string(e.what())));
+            else
+                FBLOG_WARN("BrowserHost", "Async javascript evaluation failed: " << e.what());
+        }
+    }
+}
+
+// The DOM wrappers are created on per-call paths; make_shared puts the
+// refcount in the same allocation as the object, saving an allocation and a
+// cache line per wrapper
 FB::DOM::WindowPtr FB::BrowserHost::_createWindow(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::WindowPtr(new FB::DOM::Window(obj));
+    return boost::make_shared<FB::DOM::Window>(obj);
 }
 
 FB::DOM::DocumentPtr FB::BrowserHost::_createDocument(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::DocumentPtr(new FB::DOM::Document(obj));
+    return boost::make_shared<FB::DOM::Document>(obj);
 }
 
 FB::DOM::ElementPtr FB::BrowserHost::_createElement(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::ElementPtr(new FB::DOM::Element(obj));
+    return boost::make_shared<FB::DOM::Element>(obj);
 }
 
 FB::DOM::NodePtr FB::BrowserHost::_createNode(const FB::JSObjectPtr& obj) const
 {
-    return FB::DOM::NodePtr(new FB::DOM::Node(obj));
+    return boost::make_shared<FB::DOM::Node>(obj);
 }
 
 //////////////////////////////////////////
@@ -89,6 +329,9 @@ namespace FB {
             : func(func), userData(userData), uniqId(id), called(false), mgr(mgr)
         {}
         void call();
+        // Pooled; one of these is made for every scheduled async call
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
         void (*func)(void *);
         void *userData;
         int uniqId;
@@ -99,7 +342,7 @@ namespace FB {
     class AsyncCallManager : public boost::enable_shared_from_this<AsyncCallManager>, boost::noncopyable {
     public:
         int lastId;
-        AsyncCallManager() : lastId(1) {}
+        AsyncCallManager() : lastId(1), m_drainPending(false), m_sinceLastBulk(0) {}
         ~AsyncCallManager();
 
         boost::recursive_mutex m_mutex;
@@ -108,58 +351,626 @@ namespace FB {
         _asyncCallData* makeCallback(void (*func)(void *), void * userData );
         void call( _asyncCallData* data );
 
+        // Queues data for the next drain pass; returns true if the caller needs to
+        // schedule a drain callback (i.e. none is currently scheduled)
+        bool enqueueForDrain( _asyncCallData* data, AsyncCallPriority priority );
+        // Runs queued calls up to the flush-depth limit; returns true if more remain
+        bool drain();
+        // Called when scheduling the drain callback with the browser failed; if data
+        // is given it is unqueued and freed so a false return means "will never run"
+        void drainScheduleFailed( _asyncCallData* data = NULL );
+
         std::list<_asyncCallData*> DataList;
         std::list<_asyncCallData*> canceledDataList;
+        // Per-lane queues of calls not yet run, each in arrival order; the
+        // interactive lane is serviced first
+        std::deque<_asyncCallData*> m_pendingInteractive;
+        std::deque<_asyncCallData*> m_pending;
+        // True while a drain callback is scheduled (or running with work left)
+        bool m_drainPending;
+        // Interactive calls run since the last bulk one; the starvation guard
+        // forces a bulk call through when this gets too high
+        size_t m_sinceLastBulk;
+    };
+
+    // Heap-allocated token handed to the browser for a scheduled drain callback;
+    // weak pointers only, since the browser may deliver it after shutdown
+    struct _asyncDrainRequest : boost::noncopyable {
+        _asyncDrainRequest(const AsyncCallManagerWeakPtr& mgr, const boost::weak_ptr<const BrowserHost>& host)
+            : mgr(mgr), host(host) {}
+        AsyncCallManagerWeakPtr mgr;
+        boost::weak_ptr<const BrowserHost> host;
     };
 }
 
 FB::BrowserHost::BrowserHost()
     : _asyncManager(boost::make_shared<AsyncCallManager>()), m_threadId(boost::this_thread::get_id()),
-      m_isShutDown(false)
+      m_isShutDown(false), m_domCacheGeneration(1), m_htmlLogDropped(0), m_htmlLogFlushPending(false),
+      m_evalFlushPending(false), m_callbackScanPending(false), m_invokeFlushPending(false),
+      m_invokeQueueLimit(0), m_invokePolicy(AsyncInvokeOverflow_DropOldest),
+      m_structuredClone(false), m_nextInvalidationId(0), m_nextGroupId(0)
+{
+
+}
+
+void FB::BrowserHost::invalidateDOMCaches()
+{
+    const unsigned int gen = ++m_domCacheGeneration;
+    scheduleCallbackScan();
+    // Broadcast from a snapshot with the lock dropped, so a callback can
+    // register or remove entries without deadlocking
+    std::vector<InvalidationCallback> listeners;
+    {
+        boost::mutex::scoped_lock _l(m_invalidationMutex);
+        listeners.reserve(m_invalidationCallbacks.size());
+        for (InvalidationCallbackMap::const_iterator it = m_invalidationCallbacks.begin();
+                it != m_invalidationCallbacks.end(); ++it) {
+            listeners.push_back(it->second);
+        }
+    }
+    for (std::vector<InvalidationCallback>::const_iterator it = listeners.begin(); it != listeners.end(); ++it) {
+        try {
+            (*it)(gen);
+        } catch (const std::exception& e) {
+            FBLOG_WARN("BrowserHost", "Invalidation callback threw: " << e.what());
+        }
+    }
+}
+
+unsigned int FB::BrowserHost::addInvalidationCallback(const InvalidationCallback& callback)
 {
+    boost::mutex::scoped_lock _l(m_invalidationMutex);
+    const unsigned int id = ++m_nextInvalidationId;
+    m_invalidationCallbacks[id] = callback;
+    return id;
+}
 
+void FB::BrowserHost::removeInvalidationCallback(unsigned int id)
+{
+    boost::mutex::scoped_lock _l(m_invalidationMutex);
+    m_invalidationCallbacks.erase(id);
 }
 
 void FB::BrowserHost::shutdown()
 {
-    freeRetainedObjects();
+    // cached DOM child handles must not outlive the page
+    invalidateDOMCaches();
+    {
+        // Detach the retained objects now (accounting included) but destroy
+        // them on the reaper; a heavy page can hold thousands and the browser
+        // is waiting in NPP_Destroy while this runs
+        for (size_t i = 0; i < RetainedObjectShardCount; ++i) {
+            boost::shared_ptr<std::set<FB::JSAPIPtr> > batch(new std::set<FB::JSAPIPtr>);
+            {
+                boost::mutex::scoped_lock _l(m_retainedObjects[i].mutex);
+                batch->swap(m_retainedObjects[i].objects);
+            }
+            for (size_t n = batch->size(); n; --n)
+                FB::Memory::accountFree(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+            if (!batch->empty())
+                TeardownReaper::getInstance().defer(
+                    boost::bind(&destroyContainerSliced<std::set<FB::JSAPIPtr> >, batch));
+        }
+        // group-retained graphs go the same way: unhook the records now,
+        // destroy the nodes on the reaper
+        RetainedGroupMap groups;
+        {
+            boost::mutex::scoped_lock _l(m_groupMutex);
+            groups.swap(m_retainedGroups);
+        }
+        for (RetainedGroupMap::iterator it = groups.begin(); it != groups.end(); ++it) {
+            for (size_t n = it->second->size(); n; --n)
+                FB::Memory::accountFree(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+            TeardownReaper::getInstance().defer(
+                boost::bind(&destroyContainerSliced<std::list<FB::JSAPIPtr> >, it->second));
+        }
+    }
+    {
+        // No more ticks are coming, so the managed callbacks go now.  With
+        // navigation expiring stale generations as the session runs, this is
+        // only the live page's handlers -- not a whole session's worth
+        boost::shared_ptr<std::list<ManagedCallback> > callbacks(new std::list<ManagedCallback>);
+        {
+            boost::mutex::scoped_lock _l(m_callbackMutex);
+            callbacks->swap(m_managedCallbacks);
+            m_callbackScanPending = false;
+        }
+        if (!callbacks->empty())
+            TeardownReaper::getInstance().defer(
+                boost::bind(&destroyContainerSliced<std::list<ManagedCallback> >, callbacks));
+    }
+    {
+        // Pending async invokes can never run now; drop them and wake any
+        // block-producer waiters so workers don't hang on a dead host
+        boost::shared_ptr<PendingInvokeList> pending(new PendingInvokeList);
+        {
+            boost::mutex::scoped_lock _l(m_invokeMutex);
+            pending->swap(m_pendingInvokes);
+            m_invokeKeys.clear();
+            m_invokeFlushPending = false;
+        }
+        m_invokeSpace.notify_all();
+        if (!pending->empty())
+            TeardownReaper::getInstance().defer(
+                boost::bind(&destroyContainerSliced<PendingInvokeList>, pending));
+    }
     boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
     m_isShutDown = true;
+    if (_watchdog) {
+        // No more heartbeats can be delivered; stop probing before the queues drain
+        _watchdog->shutdown();
+    }
+    if (_timerService) {
+        // Stop the timers before the async manager flushes so a late tick can't fire
+        _timerService->shutdown();
+        _timerService.reset();
+    }
     _asyncManager->shutdown();
 }
 
+unsigned int FB::BrowserHost::startTimer(unsigned int intervalMs, const FB::TimerCallback& callback, bool recurring)
+{
+    if (isShutDown()) {
+        return 0;
+    }
+    TimerServicePtr service;
+    {
+        boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
+        if (!_timerService) {
+            _timerService = boost::make_shared<TimerService>(shared_from_this());
+        }
+        service = _timerService;
+    }
+    return service->addTimer(intervalMs, recurring, callback);
+}
+
+void FB::BrowserHost::stopTimer(unsigned int timerId)
+{
+    TimerServicePtr service;
+    {
+        boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
+        service = _timerService;
+    }
+    if (service) {
+        service->cancelTimer(timerId);
+    }
+}
+
+void FB::BrowserHost::startMainThreadWatchdog(unsigned int periodMs, unsigned int thresholdMs)
+{
+    if (isShutDown()) {
+        return;
+    }
+    MainThreadWatchdogPtr previous;
+    MainThreadWatchdogPtr watchdog(boost::make_shared<MainThreadWatchdog>(
+        BrowserHostWeakPtr(shared_from_this()), periodMs, thresholdMs));
+    {
+        boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
+        previous = _watchdog;
+        _watchdog = watchdog;
+    }
+    if (previous) {
+        previous->shutdown();
+    }
+    watchdog->start();
+}
+
+void FB::BrowserHost::stopMainThreadWatchdog()
+{
+    MainThreadWatchdogPtr watchdog;
+    {
+        boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
+        watchdog = _watchdog;
+    }
+    if (watchdog) {
+        // Keep the pointer so getWatchdogReport still serves the captured records
+        watchdog->shutdown();
+    }
+}
+
+FB::VariantMap FB::BrowserHost::getWatchdogReport() const
+{
+    MainThreadWatchdogPtr watchdog;
+    {
+        boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
+        watchdog = _watchdog;
+    }
+    if (watchdog) {
+        return watchdog->report();
+    }
+    FB::VariantMap out;
+    out["enabled"] = false;
+    return out;
+}
+
+#if defined(_DEBUG) || defined(FB_THREAD_DIAGNOSTICS)
 void FB::BrowserHost::assertMainThread() const
 {
-#ifdef _DEBUG
     if (!isMainThread()) {
         FBLOG_FATAL("BrowserHost", "Trying to call something from the wrong thread!");
     }
     assert(isMainThread());
+}
 #endif
+
+FB::VariantMap FB::BrowserHost::getCrossThreadCallStats() const
+{
+    return FB::CrossThreadCallStats::getInstance().snapshot();
+}
+
+FB::VariantMap FB::BrowserHost::getConversionStats() const
+{
+    return FB::ConversionStats::getInstance().snapshot();
 }
 
-bool FB::BrowserHost::isMainThread() const
+void FB::BrowserHost::resetConversionStats()
 {
-    return m_threadId == boost::this_thread::get_id();
+    FB::ConversionStats::getInstance().reset();
+}
+
+FB::VariantMap FB::BrowserHost::getMemoryStats() const
+{
+    FB::Memory::CategoryStats stats[FB::Memory::CategoryCount];
+    FB::Memory::getStats(stats);
+    FB::VariantMap out;
+#ifdef FB_MEMORY_ACCOUNTING
+    out["enabled"] = true;
+#else
+    out["enabled"] = false;
+#endif
+    for (int i = 0; i < FB::Memory::CategoryCount; ++i) {
+        FB::VariantMap entry;
+        // counters go out as doubles; that's what they become in JS anyway
+        entry["liveBytes"] = static_cast<double>(stats[i].liveBytes);
+        entry["peakBytes"] = static_cast<double>(stats[i].peakBytes);
+        entry["liveCount"] = static_cast<double>(stats[i].liveCount);
+        entry["totalAllocs"] = static_cast<double>(stats[i].totalAllocs);
+        out[FB::Memory::categoryName(static_cast<FB::Memory::Category>(i))] = entry;
+    }
+    return out;
+}
+
+void FB::BrowserHost::dumpMemoryStats()
+{
+    FB::Memory::CategoryStats stats[FB::Memory::CategoryCount];
+    FB::Memory::getStats(stats);
+    for (int i = 0; i < FB::Memory::CategoryCount; ++i) {
+        std::ostringstream os;
+        os << "memory: " << FB::Memory::categoryName(static_cast<FB::Memory::Category>(i))
+           << " live=" << stats[i].liveBytes
+           << " peak=" << stats[i].peakBytes
+           << " count=" << stats[i].liveCount
+           << " allocs=" << stats[i].totalAllocs;
+        htmlLog(os.str());
+    }
+}
+
+FB::BrowserHost::RetainedObjectShard& FB::BrowserHost::getRetainedShard( const FB::JSAPIPtr& obj ) const
+{
+    // Shard by object address; every shared_ptr to an object lands in the same
+    // shard.  The low bits are dropped since allocators align them away
+    const size_t h = reinterpret_cast<size_t>(obj.get()) >> 4;
+    return m_retainedObjects[h % RetainedObjectShardCount];
 }
 
 void FB::BrowserHost::freeRetainedObjects() const
 {
-    boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
-    // This releases all stored shared_ptr objects that the browser is holding
-    m_retainedObjects.clear();
+    // This releases all stored shared_ptr objects that the browser is holding.
+    // Each shard's set is swapped out under its lock and destroyed unlocked, one
+    // batch at a time, so a teardown of thousands of retained objects never
+    // blocks retain/release callers for the full walk
+    for (size_t i = 0; i < RetainedObjectShardCount; ++i) {
+        std::set<FB::JSAPIPtr> batch;
+        {
+            boost::mutex::scoped_lock _l(m_retainedObjects[i].mutex);
+            batch.swap(m_retainedObjects[i].objects);
+        }
+        for (size_t n = batch.size(); n; --n)
+            FB::Memory::accountFree(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+    }
+    RetainedGroupMap groups;
+    {
+        boost::mutex::scoped_lock _l(m_groupMutex);
+        groups.swap(m_retainedGroups);
+    }
+    for (RetainedGroupMap::iterator it = groups.begin(); it != groups.end(); ++it) {
+        for (size_t n = it->second->size(); n; --n)
+            FB::Memory::accountFree(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+    }
 }
 
 void FB::BrowserHost::retainJSAPIPtr( const FB::JSAPIPtr& obj ) const
 {
-    boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
-    m_retainedObjects.insert(obj);
+    RetainedObjectShard& shard = getRetainedShard(obj);
+    boost::mutex::scoped_lock _l(shard.mutex);
+    if (shard.objects.insert(obj).second)
+        FB::Memory::accountAlloc(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
 }
 
 void FB::BrowserHost::releaseJSAPIPtr( const FB::JSAPIPtr& obj ) const
 {
-    boost::upgrade_lock<boost::shared_mutex> _l(m_xtmutex);
-    m_retainedObjects.erase(m_retainedObjects.find(obj));
+    RetainedObjectShard& shard = getRetainedShard(obj);
+    boost::mutex::scoped_lock _l(shard.mutex);
+    std::set<FB::JSAPIPtr>::iterator fnd = shard.objects.find(obj);
+    if (fnd != shard.objects.end()) {
+        shard.objects.erase(fnd);
+        FB::Memory::accountFree(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+    }
+}
+
+void FB::BrowserHost::retainJSAPIPtrs( const std::vector<FB::JSAPIPtr>& objs ) const
+{
+    // walk the list once per shard instead of bucketing: each shard lock is
+    // still taken at most once, and the scans are over an in-cache vector
+    for (size_t i = 0; i < RetainedObjectShardCount; ++i) {
+        RetainedObjectShard& shard = m_retainedObjects[i];
+        boost::mutex::scoped_lock _l(shard.mutex);
+        for (std::vector<FB::JSAPIPtr>::const_iterator it = objs.begin(); it != objs.end(); ++it) {
+            if (*it && &getRetainedShard(*it) == &shard
+                && shard.objects.insert(*it).second) {
+                FB::Memory::accountAlloc(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+            }
+        }
+    }
+}
+
+void FB::BrowserHost::releaseJSAPIPtrs( const std::vector<FB::JSAPIPtr>& objs ) const
+{
+    for (size_t i = 0; i < RetainedObjectShardCount; ++i) {
+        RetainedObjectShard& shard = m_retainedObjects[i];
+        boost::mutex::scoped_lock _l(shard.mutex);
+        for (std::vector<FB::JSAPIPtr>::const_iterator it = objs.begin(); it != objs.end(); ++it) {
+            if (*it && &getRetainedShard(*it) == &shard
+                && shard.objects.erase(*it)) {
+                FB::Memory::accountFree(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+            }
+        }
+    }
+}
+
+unsigned int FB::BrowserHost::retainJSAPIGroup( const std::vector<FB::JSAPIPtr>& objs ) const
+{
+    RetainedGroupPtr group(new std::list<FB::JSAPIPtr>(objs.begin(), objs.end()));
+    group->remove(FB::JSAPIPtr());
+    if (group->empty())
+        return 0;
+    for (size_t n = group->size(); n; --n)
+        FB::Memory::accountAlloc(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+    boost::mutex::scoped_lock _l(m_groupMutex);
+    const unsigned int id = ++m_nextGroupId;
+    m_retainedGroups[id] = group;
+    return id;
+}
+
+void FB::BrowserHost::releaseJSAPIGroup( unsigned int group ) const
+{
+    if (!group)
+        return;
+    RetainedGroupPtr batch;
+    {
+        boost::mutex::scoped_lock _l(m_groupMutex);
+        RetainedGroupMap::iterator fnd = m_retainedGroups.find(group);
+        if (fnd == m_retainedGroups.end())
+            return;
+        batch.swap(fnd->second);
+        m_retainedGroups.erase(fnd);
+    }
+    // the caller is done once the record is unhooked; destroying a graph of
+    // hundreds of nodes happens on the reaper like teardown batches do
+    for (size_t n = batch->size(); n; --n)
+        FB::Memory::accountFree(FB::Memory::Category_RetainedJSAPI, sizeof(FB::JSAPIPtr));
+    TeardownReaper::getInstance().defer(
+        boost::bind(&destroyContainerSliced<std::list<FB::JSAPIPtr> >, batch));
+}
+
+void FB::BrowserHost::setAsyncInvokeQueueLimit(size_t maxPending, FB::AsyncInvokeOverflowPolicy policy)
+{
+    boost::mutex::scoped_lock _l(m_invokeMutex);
+    m_invokeQueueLimit = maxPending;
+    m_invokePolicy = policy;
+    if (maxPending) {
+        while (m_pendingInvokes.size() > maxPending)
+            dropOldestInvoke();
+    }
+}
+
+void FB::BrowserHost::dropOldestInvoke()
+{
+    if (m_pendingInvokes.empty())
+        return;
+    if (!m_pendingInvokes.front().key.empty())
+        m_invokeKeys.erase(m_pendingInvokes.front().key);
+    m_pendingInvokes.pop_front();
+}
+
+void FB::BrowserHost::scheduleInvoke(const FB::JSObjectPtr& obj, const std::string& methodName,
+    const FB::VariantList& args, const std::string& coalesceKey)
+{
+    if (!obj || isShutDown())
+        return;
+    bool needFlush(false);
+    {
+        boost::unique_lock<boost::mutex> lock(m_invokeMutex);
+        if (m_invokePolicy == AsyncInvokeOverflow_CoalesceByKey && !coalesceKey.empty()) {
+            InvokeKeyMap::iterator fnd = m_invokeKeys.find(coalesceKey);
+            if (fnd != m_invokeKeys.end()) {
+                // Latest wins: replace the queued call's payload in place.  A
+                // flush is already on its way for the existing entry
+                fnd->second->object = obj;
+                fnd->second->methodName = methodName;
+                fnd->second->args = args;
+                return;
+            }
+        }
+        if (m_invokeQueueLimit && m_pendingInvokes.size() >= m_invokeQueueLimit) {
+            if (m_invokePolicy == AsyncInvokeOverflow_BlockProducer && !isMainThread()) {
+                while (m_pendingInvokes.size() >= m_invokeQueueLimit && !isShutDown())
+                    m_invokeSpace.wait(lock);
+                if (isShutDown())
+                    return;
+            } else {
+                // drop-oldest; also the fallback for keyed misses and for
+                // block-producer on the main thread, where waiting on our own
+                // drain would deadlock
+                dropOldestInvoke();
+            }
+        }
+        m_pendingInvokes.push_back(PendingInvoke(obj, methodName, args, coalesceKey));
+        if (m_invokePolicy == AsyncInvokeOverflow_CoalesceByKey && !coalesceKey.empty()) {
+            PendingInvokeList::iterator last = m_pendingInvokes.end();
+            m_invokeKeys[coalesceKey] = --last;
+        }
+        if (!m_invokeFlushPending) {
+            m_invokeFlushPending = true;
+            needFlush = true;
+        }
+    }
+    if (needFlush
+        && !ScheduleAsyncCall(&FB::BrowserHost::AsyncInvokeFlush,
+               new _asyncHostRequest(shared_from_this()))) {
+        boost::mutex::scoped_lock _l(m_invokeMutex);
+        m_pendingInvokes.clear();
+        m_invokeKeys.clear();
+        m_invokeFlushPending = false;
+    }
+}
+
+void FB::BrowserHost::AsyncInvokeFlush(void *invokeReq)
+{
+    boost::scoped_ptr<_asyncHostRequest> req(static_cast<_asyncHostRequest*>(invokeReq));
+    req->m_host->flushPendingInvokes();
+}
+
+void FB::BrowserHost::flushPendingInvokes()
+{
+    PendingInvokeList batch;
+    {
+        boost::mutex::scoped_lock _l(m_invokeMutex);
+        batch.swap(m_pendingInvokes);
+        m_invokeKeys.clear();
+        m_invokeFlushPending = false;
+    }
+    m_invokeSpace.notify_all();
+    for (PendingInvokeList::const_iterator it = batch.begin(); it != batch.end(); ++it) {
+        FB::JSObjectPtr obj(it->object.lock());
+        if (!obj)
+            continue;           // released while queued; nothing to call
+        try {
+            obj->Invoke(it->methodName, it->args);
+        } catch (const std::exception&) {
+            // a failing handler must not stop the rest of the batch
+        }
+    }
+}
+
+void FB::BrowserHost::retainCallback( const FB::JSObjectPtr& callback ) const
+{
+    if (!callback)
+        return;
+    boost::mutex::scoped_lock _l(m_callbackMutex);
+    m_managedCallbacks.push_back(ManagedCallback(m_domCacheGeneration, callback));
+}
+
+void FB::BrowserHost::releaseCallback( const FB::JSObjectPtr& callback ) const
+{
+    FB::JSObjectPtr released;
+    boost::mutex::scoped_lock _l(m_callbackMutex);
+    for (std::list<ManagedCallback>::iterator it = m_managedCallbacks.begin();
+         it != m_managedCallbacks.end(); ++it) {
+        if (it->callback == callback) {
+            // keep the handle until the lock is gone; dropping the last
+            // reference can call back into the browser
+            released.swap(it->callback);
+            m_managedCallbacks.erase(it);
+            break;
+        }
+    }
+}
+
+void FB::BrowserHost::scheduleCallbackScan() const
+{
+    {
+        boost::mutex::scoped_lock _l(m_callbackMutex);
+        if (m_callbackScanPending || m_managedCallbacks.empty())
+            return;
+        m_callbackScanPending = true;
+    }
+    if (!ScheduleAsyncCall(&FB::BrowserHost::AsyncCallbackScan,
+            new _asyncHostRequest(boost::const_pointer_cast<BrowserHost>(shared_from_this())))) {
+        boost::mutex::scoped_lock _l(m_callbackMutex);
+        m_callbackScanPending = false;
+    }
+}
+
+void FB::BrowserHost::AsyncCallbackScan(void *scanReq)
+{
+    boost::scoped_ptr<_asyncHostRequest> req(static_cast<_asyncHostRequest*>(scanReq));
+    req->m_host->scanStaleCallbacks();
+}
+
+void FB::BrowserHost::scanStaleCallbacks() const
+{
+    // Expire a bounded batch per tick; a long session's worth of dead handlers
+    // is released across several main-thread entries instead of one freeze
+    static const size_t maxPerScan = 32;
+    std::vector<FB::JSObjectPtr> expired;
+    expired.reserve(maxPerScan);
+    bool more(false);
+    {
+        boost::mutex::scoped_lock _l(m_callbackMutex);
+        const unsigned int gen = m_domCacheGeneration;
+        std::list<ManagedCallback>::iterator it = m_managedCallbacks.begin();
+        while (it != m_managedCallbacks.end()) {
+            if (it->generation == gen) {
+                ++it;
+                continue;
+            }
+            if (expired.size() >= maxPerScan) {
+                more = true;
+                break;
+            }
+            expired.push_back(it->callback);
+            it = m_managedCallbacks.erase(it);
+        }
+        m_callbackScanPending = more;
+    }
+    // The handles die here, on the main thread and outside the lock
+    expired.clear();
+    if (more && !ScheduleAsyncCall(&FB::BrowserHost::AsyncCallbackScan,
+            new _asyncHostRequest(boost::const_pointer_cast<BrowserHost>(shared_from_this())))) {
+        boost::mutex::scoped_lock _l(m_callbackMutex);
+        m_callbackScanPending = false;
+    }
+}
+
+namespace {
+    // Free-list pool for _asyncCallData records; all identically sized, made and
+    // freed at the full rate of cross-thread traffic
+    typedef boost::singleton_pool<FB::_asyncCallData, sizeof(FB::_asyncCallData)> AsyncCallDataPool;
+}
+
+void* FB::_asyncCallData::operator new(std::size_t size)
+{
+    if (size != sizeof(FB::_asyncCallData)) {
+        return ::operator new(size);
+    }
+    void* ptr = AsyncCallDataPool::malloc();
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void FB::_asyncCallData::operator delete(void* ptr, std::size_t size)
+{
+    if (!ptr) {
+        return;
+    }
+    if (size != sizeof(FB::_asyncCallData)) {
+        ::operator delete(ptr);
+        return;
+    }
+    AsyncCallDataPool::free(ptr);
 }
 
 void FB::_asyncCallData::call()
@@ -193,6 +1004,78 @@ void FB::AsyncCallManager::shutdown()
     // point it's no longer possible for the browser to finish the async calls
     canceledDataList.insert(canceledDataList.end(), DataList.begin(), DataList.end());
     DataList.clear();
+    // Everything pending now lives in canceledDataList; a drain callback delivered
+    // after this point must not touch (or free) those entries
+    m_pendingInteractive.clear();
+    m_pending.clear();
+    m_drainPending = false;
+}
+
+bool FB::AsyncCallManager::enqueueForDrain( _asyncCallData* data, AsyncCallPriority priority )
+{
+    boost::recursive_mutex::scoped_lock _l(m_mutex);
+    if (priority == AsyncCallPriority_Interactive)
+        m_pendingInteractive.push_back(data);
+    else
+        m_pending.push_back(data);
+    if (m_drainPending)
+        return false;
+    m_drainPending = true;
+    return true;
+}
+
+bool FB::AsyncCallManager::drain()
+{
+    // Flush-depth limit: a storm of queued calls yields back to the browser's
+    // message loop between batches so input and painting stay responsive
+    static const size_t maxPerPass = 64;
+    // Starvation guard: at most this many interactive calls run back-to-back
+    // while bulk calls are waiting
+    static const size_t maxInteractiveRun = 8;
+    size_t processed = 0;
+    for (;;) {
+        _asyncCallData* data;
+        {
+            boost::recursive_mutex::scoped_lock _l(m_mutex);
+            if (m_pendingInteractive.empty() && m_pending.empty()) {
+                m_drainPending = false;
+                return false;
+            }
+            if (processed >= maxPerPass) {
+                // Leave m_drainPending set; the caller reschedules the drain
+                return true;
+            }
+            if (!m_pendingInteractive.empty()
+                && (m_pending.empty() || m_sinceLastBulk < maxInteractiveRun)) {
+                data = m_pendingInteractive.front();
+                m_pendingInteractive.pop_front();
+                ++m_sinceLastBulk;
+            } else {
+                data = m_pending.front();
+                m_pending.pop_front();
+                m_sinceLastBulk = 0;
+            }
+        }
+        call(data);
+        delete data;
+        ++processed;
+    }
+}
+
+void FB::AsyncCallManager::drainScheduleFailed( _asyncCallData* data )
+{
+    boost::recursive_mutex::scoped_lock _l(m_mutex);
+    m_drainPending = false;
+    if (data) {
+        std::deque<_asyncCallData*>::iterator fnd = std::find(m_pending.begin(), m_pending.end(), data);
+        if (fnd != m_pending.end())
+            m_pending.erase(fnd);
+        fnd = std::find(m_pendingInteractive.begin(), m_pendingInteractive.end(), data);
+        if (fnd != m_pendingInteractive.end())
+            m_pendingInteractive.erase(fnd);
+        DataList.remove(data);
+        delete data;
+    }
 }
 
 FB::AsyncCallManager::~AsyncCallManager()
@@ -201,21 +1084,39 @@ FB::AsyncCallManager::~AsyncCallManager()
 }
 
 
-void asyncCallWrapper(void *userData)
+void FB::BrowserHost::AsyncCallDrain(void *drainReq)
 {
-    boost::scoped_ptr<FB::_asyncCallData> data(static_cast<FB::_asyncCallData*>(userData));
-    FB::AsyncCallManagerPtr ptr(data->mgr.lock());
-    if (ptr) {
-        ptr->call(data.get());
+    FB::_asyncDrainRequest* req = static_cast<FB::_asyncDrainRequest*>(drainReq);
+    FB::AsyncCallManagerPtr ptr(req->mgr.lock());
+    if (ptr && ptr->drain()) {
+        // Hit the flush-depth limit with work still queued; hand the remainder to
+        // the next main-thread entry so the message loop gets a turn in between
+        boost::shared_ptr<const BrowserHost> host(req->host.lock());
+        if (host && !host->isShutDown()
+            && host->_scheduleAsyncCall(&FB::BrowserHost::AsyncCallDrain, req)) {
+            return;             // ownership passed to the rescheduled callback
+        }
+        ptr->drainScheduleFailed();
     }
+    delete req;
 }
 
-bool FB::BrowserHost::ScheduleAsyncCall( void (*func)(void *), void *userData ) const
+bool FB::BrowserHost::ScheduleAsyncCall( void (*func)(void *), void *userData,
+    FB::AsyncCallPriority priority ) const
 {
     if (isShutDown()) {
         return false;
-    } else {
-        _asyncCallData* data = _asyncManager->makeCallback(func, userData);
-        return _scheduleAsyncCall(&asyncCallWrapper, data);
     }
+    _asyncCallData* data = _asyncManager->makeCallback(func, userData);
+    if (!_asyncManager->enqueueForDrain(data, priority)) {
+        // A drain callback is already scheduled and will pick this call up; no
+        // browser crossing needed
+        return true;
+    }
+    if (_scheduleAsyncCall(&FB::BrowserHost::AsyncCallDrain,
+            new _asyncDrainRequest(_asyncManager, shared_from_this()))) {
+        return true;
+    }
+    _asyncManager->drainScheduleFailed(data);
+    return false;
 }
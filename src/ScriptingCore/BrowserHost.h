@@ -16,6 +16,8 @@ Copyright 2009 Richard Bateman, Firebreath development team
 #ifndef H_FB_BROWSERHOSTWRAPPER
 #define H_FB_BROWSERHOSTWRAPPER
 
+#include <deque>
+#include <list>
 #include "APITypes.h"
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/noncopyable.hpp>
@@ -27,6 +29,7 @@ namespace FB
     FB_FORWARD_PTR(BrowserStream);
     FB_FORWARD_PTR(PluginEventSink);
     FB_FORWARD_PTR(JSObject);
+    FB_FORWARD_PTR(PreparedScript);
 
     namespace DOM {
         FB_FORWARD_PTR(Window);
@@ -49,6 +52,52 @@ namespace FB
     };
 
     FB_FORWARD_PTR(AsyncCallManager);
+    FB_FORWARD_PTR(TimerService);
+    FB_FORWARD_PTR(MainThreadWatchdog);
+    FB_FORWARD_PTR(AsyncCallToken);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @enum   AsyncCallPriority
+    ///
+    /// @brief  Priority lane for calls scheduled onto the main thread
+    ///
+    /// Interactive calls overtake bulk calls queued ahead of them, so input-latency-critical work
+    /// (mouse responses and the like) is not stuck behind a burst of stream notifications.  A
+    /// starvation guard in the drain loop keeps bulk calls progressing regardless.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    enum AsyncCallPriority {
+        AsyncCallPriority_Interactive,  ///< Latency-sensitive; serviced first
+        AsyncCallPriority_Bulk          ///< Default lane for everything else
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @enum   AsyncInvokeOverflowPolicy
+    ///
+    /// @brief  What scheduleInvoke does with new calls once the async invoke queue is full
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    enum AsyncInvokeOverflowPolicy {
+        AsyncInvokeOverflow_DropOldest,     ///< Discard the oldest queued call to make room
+        AsyncInvokeOverflow_CoalesceByKey,  ///< Keyed calls replace their queued predecessor;
+                                            ///< unkeyed overflow falls back to drop-oldest
+        AsyncInvokeOverflow_BlockProducer   ///< The calling worker waits for room (never on the
+                                            ///< main thread, where it degrades to drop-oldest)
+    };
+
+    template<class RT> class AsyncCallResult;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @typedef JSEvalCallback
+    ///
+    /// @brief  Completion callback for evaluateJavaScriptAsync
+    ///
+    /// Called on the main thread with success=true and the script's result, or success=false and an
+    /// error message in result if the evaluation threw.  Note that on ActiveX the browser cannot
+    /// return a value from a script, so success there pairs with an empty variant.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    typedef boost::function<void (bool success, const FB::variant& result)> JSEvalCallback;
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @class  BrowserHost
@@ -95,15 +144,18 @@ namespace FB
         /// 
         /// NOTE: This is a low level call; it is almost always better to use ScheduleOnMainThread
         /// 
-        /// @param  func     The function to call. 
+        /// @param  func     The function to call.
         /// @param  userData The userData to pass to the function.
+        /// @param  priority Lane the call is queued in; interactive calls are serviced
+        ///                  ahead of bulk ones
         ///
         /// @returns bool true if the call was scheduled
-        ///                  
+        ///
         /// @see ScheduleOnMainThread
         /// @see CallOnMainThread
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        bool ScheduleAsyncCall(void (*func)(void *), void *userData) const;
+        bool ScheduleAsyncCall(void (*func)(void *), void *userData,
+            AsyncCallPriority priority = AsyncCallPriority_Bulk) const;
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn template<class Functor> typename Functor::result_type CallOnMainThread(Functor func)
@@ -126,6 +178,33 @@ namespace FB
         template<class Functor>
         typename Functor::result_type CallOnMainThread(Functor func);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn template<class Functor> boost::shared_ptr<AsyncCallResult<typename Functor::result_type> > CallOnMainThreadAsync(Functor func)
+        ///
+        /// @brief  Execute a call on the main thread without blocking; returns a handle the result can
+        ///         be collected from later.
+        ///
+        /// Unlike CallOnMainThread the calling thread keeps running while the main thread gets around
+        /// to the functor; the handle's get() blocks (and rethrows any FB::script_error) only when the
+        /// result is actually needed, ready() polls, and then() attaches a continuation that runs on
+        /// the main thread as soon as the value is produced:
+        /// @code
+        ///      boost::shared_ptr<FB::AsyncCallResult<int> > handle =
+        ///          host->CallOnMainThreadAsync(boost::bind(&ObjectType::method, obj, arg1));
+        ///      doOtherExpensiveWork();
+        ///      int result = handle->get();
+        /// @endcode
+        ///
+        /// @param  func    The functor to execute on the main thread created with boost::bind
+        ///
+        /// @return shared_ptr to the AsyncCallResult handle for the call
+        /// @see CallOnMainThread
+        /// @see ScheduleOnMainThread
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        template<class Functor>
+        boost::shared_ptr<AsyncCallResult<typename Functor::result_type> > CallOnMainThreadAsync(Functor func);
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn template<class C, class Functor> void ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func)
         ///
@@ -151,6 +230,71 @@ namespace FB
         template<class C, class Functor>
         void ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @overload
+        ///
+        /// @brief  Schedules func on the main thread in the given priority lane
+        ///
+        /// Use AsyncCallPriority_Interactive for latency-sensitive work so it overtakes any bulk
+        /// calls (stream notifications, etc.) already queued.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        template<class C, class Functor>
+        void ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func, AsyncCallPriority priority);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @overload
+        ///
+        /// @brief  Schedules func against a cancellation token
+        ///
+        /// Cancelling the token (AsyncCallToken::cancel) drops every call still queued against it
+        /// at drain time without executing it -- use it to cut off a dead stream's or widget's
+        /// already-queued callbacks instead of letting them run against the dead target.
+        /// @since 1.5
+        /// @see AsyncCallToken
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        template<class C, class Functor>
+        void ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func, const AsyncCallTokenPtr& token,
+            AsyncCallPriority priority = AsyncCallPriority_Bulk);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn unsigned int startTimer(unsigned int intervalMs, const boost::function<void ()>& callback, bool recurring = false)
+        ///
+        /// @brief  Registers a timer whose callback fires on the main thread
+        ///
+        /// One-shot timers (the default) fire once, intervalMs milliseconds from now; recurring
+        /// timers keep firing every intervalMs until stopped.  All timers on the host share a
+        /// single service thread and a single main-thread callback per tick, so this scales to
+        /// many concurrent timers far better than rescheduling through ScheduleOnMainThread or
+        /// the DOM window's setTimeout, which pay a browser round trip per tick each.
+        /// @code
+        ///      m_timerId = host->startTimer(16, boost::bind(&MyPluginAPI::onFrame, this), true);
+        /// @endcode
+        ///
+        /// @param  intervalMs  Delay (and for recurring timers, period) in milliseconds
+        /// @param  callback    Functor to invoke on the main thread when the timer fires
+        /// @param  recurring   true to fire every intervalMs until stopped, false to fire once
+        ///
+        /// @return the timer id to pass to stopTimer, or 0 if the host is shut down
+        /// @see stopTimer
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int startTimer(unsigned int intervalMs, const boost::function<void ()>& callback, bool recurring = false);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void stopTimer(unsigned int timerId)
+        ///
+        /// @brief  Stops a timer started with startTimer
+        ///
+        /// Safe to call from any thread, including from the timer's own callback.  Stopping a
+        /// timer that has already fired (or was never started) is a no-op.
+        ///
+        /// @param  timerId The id returned by startTimer
+        /// @see startTimer
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void stopTimer(unsigned int timerId);
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn static void AsyncHtmlLog(void *)
         ///
@@ -202,20 +346,34 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn void assertMainThread() const
         ///
-        /// @brief  When running in debug mode, asserts that the call is made on the main thread. 
+        /// @brief  When running in debug mode, asserts that the call is made on the main thread.
+        ///
+        /// This sits on literally every dispatch path, so release builds compile it away to
+        /// nothing; define FB_THREAD_DIAGNOSTICS to keep the checks in an optimized build when
+        /// chasing a threading bug.
         /// @since 1.2.0
         ////////////////////////////////////////////////////////////////////////////////////////////////////
+#if defined(_DEBUG) || defined(FB_THREAD_DIAGNOSTICS)
         void assertMainThread() const;
+#else
+        inline void assertMainThread() const { }
+#endif
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn bool isMainThread() const
+        /// @fn inline bool isMainThread() const
         ///
-        /// @brief  Query if this object is on the main thread. 
+        /// @brief  Query if this object is on the main thread.
         ///
-        /// @return true if called on main thread, false if not. 
+        /// The main-thread id is captured once at host creation and never written again, so this
+        /// is one read and compare against the calling thread's id.
+        ///
+        /// @return true if called on main thread, false if not.
         /// @since 1.3.0
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        bool isMainThread() const;
+        inline bool isMainThread() const
+        {
+            return m_threadId == boost::this_thread::get_id();
+        }
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual DOM::DocumentPtr getDOMDocument() = 0
@@ -260,6 +418,117 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual void evaluateJavaScript(const std::wstring &script);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void evaluateJavaScriptAsync(const std::string &script, const JSEvalCallback& callback = JSEvalCallback())
+        ///
+        /// @brief  Evaluates javascript without blocking the calling thread; the result is delivered
+        ///         to the callback
+        ///
+        /// Safe to call from any thread.  Scripts are queued and every script queued before the main
+        /// thread gets around to them is evaluated in one batch, so a worker firing many small
+        /// snippets pays for one thread hop per burst rather than one per snippet.  Scripts run in
+        /// submission order.  The callback (if given) runs on the main thread with the evaluation
+        /// result; on browsers that cannot return a value from a script (ActiveX) it receives an
+        /// empty variant.  If the evaluation throws, the callback gets success=false and the error
+        /// message instead.
+        ///
+        /// @param  script      The script to evaluate
+        /// @param  callback    Optional functor to receive the result
+        /// @see evaluateJavaScript
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void evaluateJavaScriptAsync(const std::string &script, const JSEvalCallback& callback = JSEvalCallback());
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn PreparedScriptPtr prepareScript(const std::string &functionDef)
+        ///
+        /// @brief  Compiles a javascript function expression once and returns a reusable handle
+        ///
+        /// For snippets evaluated over and over with varying arguments, evaluateJavaScript pays a
+        /// source re-send and re-parse per call.  prepareScript evaluates the given function
+        /// expression exactly once, keeps a reference to the browser-side compiled function, and
+        /// returns a handle whose invoke(args) goes through the ordinary object-call path:
+        /// @code
+        ///      FB::PreparedScriptPtr fn = host->prepareScript(
+        ///          "function (x, y) { return someOverlay.moveTo(x, y); }");
+        ///      fn->invoke(FB::variant_list_of(10)(20));  // no parsing; plain function call
+        /// @endcode
+        ///
+        /// Must be called on the main thread (the returned handle's invoke marshals itself).  The
+        /// function is defined through a uniquely-named temporary on the DOM window, which is
+        /// removed again before this returns, so nothing page-visible is left behind.
+        ///
+        /// @param  functionDef A javascript function expression, e.g. "function (a) { ... }"
+        /// @return handle to the compiled function
+        /// @throws FB::script_error if the expression does not evaluate to a function
+        /// @see PreparedScript
+        /// @see evaluateJavaScript
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        PreparedScriptPtr prepareScript(const std::string &functionDef);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setAsyncInvokeQueueLimit(size_t maxPending, AsyncInvokeOverflowPolicy policy = AsyncInvokeOverflow_DropOldest)
+        ///
+        /// @brief  Bounds the async javascript-invoke queue and picks the overflow policy
+        ///
+        /// By default InvokeAsync and async event dispatch queue without limit; if the main thread
+        /// stalls (modal dialog, GC pause) workers can pile up tens of thousands of pending calls
+        /// whose drain burst then freezes the browser.  With a limit set, scheduleInvoke applies
+        /// the chosen policy once maxPending calls are queued.  Coalesce-by-key is the one to
+        /// reach for with progress events: give each stream's event the same key and only the
+        /// latest survives the stall.
+        ///
+        /// @param  maxPending  Queue bound; 0 restores unbounded queueing
+        /// @param  policy      What to do with new calls when the queue is full
+        /// @see scheduleInvoke
+        /// @see FB::JSObject::InvokeAsync
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setAsyncInvokeQueueLimit(size_t maxPending, AsyncInvokeOverflowPolicy policy = AsyncInvokeOverflow_DropOldest);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setStructuredCloneEnabled(bool enable)
+        ///
+        /// @brief  Opts this host in to structured-clone conversion of plain javascript objects
+        ///
+        /// When enabled, converting a JSObject parameter to VariantMap (or a VariantList/STL
+        /// container) serializes the object browser-side with JSON.stringify in one crossing and
+        /// parses it straight into variants, instead of reading every field with its own
+        /// GetProperty round trip.  Off by default because the clone has JSON semantics: fields
+        /// holding functions or host objects are dropped rather than wrapped, so only enable it
+        /// for plugins whose object parameters are plain data.  Conversion quietly falls back to
+        /// the per-property walk when the clone isn't possible.
+        /// @since 1.5
+        /// @see FB::JSObject::DeepClone
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setStructuredCloneEnabled(bool enable) { m_structuredClone = enable; }
+
+        /// True if setStructuredCloneEnabled(true) has been called on this host
+        /// @since 1.5
+        bool isStructuredCloneEnabled() const { return m_structuredClone; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void scheduleInvoke(const FB::JSObjectPtr& obj, const std::string& methodName, const FB::VariantList& args, const std::string& coalesceKey = std::string())
+        ///
+        /// @brief  Queues an async javascript call through the bounded invoke queue
+        ///
+        /// This is the funnel JSObject::InvokeAsync uses; call it directly when you want to pass a
+        /// coalesce key.  All calls queued before the main thread gets around to them run in one
+        /// batch (a single thread hop per burst), each against a weak handle so a released object
+        /// just skips its call.  Under the coalesce-by-key policy a keyed call replaces any queued
+        /// call with the same key instead of growing the queue.
+        ///
+        /// @param  obj         The javascript object to invoke on
+        /// @param  methodName  Method name ("" for default-invoke)
+        /// @param  args        The arguments
+        /// @param  coalesceKey Optional key for latest-wins coalescing ("" = never coalesced)
+        /// @see setAsyncInvokeQueueLimit
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void scheduleInvoke(const FB::JSObjectPtr& obj, const std::string& methodName,
+            const FB::VariantList& args, const std::string& coalesceKey = std::string());
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void htmlLog(const std::string& str)
         ///
@@ -272,11 +541,13 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void shutdown()
         ///
-        /// @brief  Notifies the browserhost object that the associated plugin object is shutting down
-        ///         
-        /// This triggers events such as releasing all JSAPI objects that have been passed to the browser
-        /// and disables cross-thread calls (since our context is going away if the plugin is shutting
-        /// down)
+        /// @brief  Notifies the browserhost object that the associated plugin object is shutting down
+        ///         
+        /// This triggers events such as releasing all JSAPI objects that have been passed to the browser
+        /// and disables cross-thread calls (since our context is going away if the plugin is shutting
+        /// down).  The browser-facing detach is synchronous, but the actual destruction of retained
+        /// objects and queued work is handed to a background reaper in bounded slices so a heavy page
+        /// doesn't stall NPP_Destroy
         /// @since 1.4a3
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual void shutdown();
@@ -284,13 +555,207 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn inline bool isShutDown() const
         ///
-        /// @brief  returns true if the FB::BrowserHost::shutdown() method has been called on this object
-        /// 
+        /// @brief  returns true if the FB::BrowserHost::shutdown() method has been called on this object
+        /// 
         /// @return bool true if shutdown() has been called
         /// @since 1.4a3
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         inline bool isShutDown() const { return m_isShutDown; }
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn inline unsigned int getDOMCacheGeneration() const
+        ///
+        /// @brief  Generation counter the DOM wrappers key their cached child handles against
+        ///
+        /// @see FB::DOM::Node::getChildObject
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        inline unsigned int getDOMCacheGeneration() const { return m_domCacheGeneration; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void invalidateDOMCaches()
+        ///
+        /// @brief  Makes every cached DOM child handle stale at once
+        ///
+        /// Call this when the page navigates or script rebuilds the part of the DOM your plugin
+        /// walks; shutdown() calls it automatically.  Cached handles are re-resolved on next use,
+        /// callbacks registered with retainCallback from earlier generations start being released
+        /// incrementally, and every callback registered with addInvalidationCallback is told the
+        /// new generation.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void invalidateDOMCaches();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @typedef    boost::function<void (unsigned int generation)> InvalidationCallback
+        ///
+        /// @brief  Called with the new generation when the host's caches are invalidated
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        typedef boost::function<void (unsigned int generation)> InvalidationCallback;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn unsigned int addInvalidationCallback(const InvalidationCallback& callback)
+        ///
+        /// @brief  Registers a callback fired from invalidateDOMCaches
+        ///
+        /// Most caches don't need this: they stamp entries with getDOMCacheGeneration() and
+        /// validate with one integer compare on lookup.  Register a callback only when stale
+        /// entries pin resources that must be dropped eagerly on navigation rather than lazily
+        /// on next use.  Callbacks run on whichever thread invalidates, may not re-enter the
+        /// host, and should do no more than mark or clear.
+        ///
+        /// @return an id used with removeInvalidationCallback
+        /// @see getDOMCacheGeneration
+        /// @see invalidateDOMCaches
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int addInvalidationCallback(const InvalidationCallback& callback);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void removeInvalidationCallback(unsigned int id)
+        ///
+        /// @brief  Unregisters an invalidation callback; unknown ids are ignored
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void removeInvalidationCallback(unsigned int id);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void retainCallback(const FB::JSObjectPtr& callback) const
+        ///
+        /// @brief  Registers a javascript callback handle in the host's managed registry
+        ///
+        /// A retained JSObject keeps its browser-side object alive until it is released; pages
+        /// that rebind handlers leak dead objects for the whole session if the plugin forgets the
+        /// old handle.  Callbacks registered here are tagged with the current DOM cache
+        /// generation: when the page navigates (invalidateDOMCaches) every callback from an older
+        /// generation is expired automatically, released a batch at a time from scheduled
+        /// main-thread ticks rather than in one teardown storm.  releaseCallback still works for
+        /// handlers you rebind yourself before any navigation.
+        ///
+        /// @param  callback    The callback handle to manage
+        /// @see releaseCallback
+        /// @see invalidateDOMCaches
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void retainCallback(const FB::JSObjectPtr& callback) const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void releaseCallback(const FB::JSObjectPtr& callback) const
+        ///
+        /// @brief  Removes a callback from the managed registry, dropping the registry's reference
+        ///
+        /// Releasing a callback that is not registered (or has already been expired by a
+        /// navigation) is a no-op.
+        ///
+        /// @param  callback    The callback handle to release
+        /// @see retainCallback
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void releaseCallback(const FB::JSObjectPtr& callback) const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap getCrossThreadCallStats() const
+        ///
+        /// @brief  Queue telemetry for calls marshaled to the main thread
+        ///
+        /// Returns current queue depth, scheduled/completed/abandoned totals and p50/p95/p99 of
+        /// recent queue-wait and run times in microseconds.  The counters are process-wide (all
+        /// hosts share one cross-thread queue clock), collected continuously at negligible cost,
+        /// and are the first place to look when the UI feels janky: a deep queue or a high wait
+        /// p99 means the main thread is not keeping up with the worker threads.
+        /// @since 1.5
+        /// @see FB::CrossThreadCallStats
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap getCrossThreadCallStats() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void startMainThreadWatchdog(unsigned int periodMs = 1000, unsigned int thresholdMs = 250)
+        ///
+        /// @brief  Starts the main-thread stall watchdog
+        ///
+        /// A service thread pings the main thread every periodMs; a ping that takes longer than
+        /// thresholdMs to run is recorded as a stall along with the cross-thread functor the main
+        /// thread was executing at that moment (if any) and the queue depth.  Read the captured
+        /// records with getWatchdogReport.  The watchdog costs one trivial main-thread call per
+        /// period, so it is cheap enough to leave on in the field.  Calling this while a watchdog
+        /// is already running restarts it with the new settings.
+        ///
+        /// @param  periodMs    Heartbeat interval in milliseconds
+        /// @param  thresholdMs Latency above which a heartbeat counts as a stall
+        /// @since 1.5
+        /// @see getWatchdogReport
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void startMainThreadWatchdog(unsigned int periodMs = 1000, unsigned int thresholdMs = 250);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void stopMainThreadWatchdog()
+        ///
+        /// @brief  Stops the watchdog; getWatchdogReport keeps returning the records captured so far
+        /// @since 1.5
+        /// @see startMainThreadWatchdog
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void stopMainThreadWatchdog();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap getWatchdogReport() const
+        ///
+        /// @brief  Diagnostics from the main-thread stall watchdog
+        ///
+        /// Returns configuration, heartbeat/stall totals, latest and worst heartbeat latency, and
+        /// the ring of recent stall records (each with age, duration, queue depth, and the
+        /// identity and running time of the cross-thread functor caught executing).  With the
+        /// watchdog never started it returns just enabled=false.  Expose this through a plugin
+        /// property and a jank report turns into data instead of guesswork.
+        /// @since 1.5
+        /// @see startMainThreadWatchdog
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap getWatchdogReport() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap getMemoryStats() const
+        ///
+        /// @brief  Per-category allocation accounting for the framework's long-lived memory
+        ///
+        /// One entry per FB::Memory category (heap-boxed variant payloads, retained-object list
+        /// entries, stream block-cache buffers) with liveBytes/peakBytes/liveCount/totalAllocs,
+        /// plus an "enabled" flag.  The counters only move in builds compiled with
+        /// FB_MEMORY_ACCOUNTING; elsewhere they read zero.
+        /// @since 1.5
+        /// @see FB::Memory
+        /// @see dumpMemoryStats
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap getMemoryStats() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap getConversionStats() const
+        ///
+        /// @brief  Type-frequency and size telemetry for values marshaled across the boundary
+        ///
+        /// Two sections, "toBrowser" and "fromBrowser", each holding one entry per type class the
+        /// conversion layers have seen (count, totalSize, log2 size histogram; sizes are bytes
+        /// for strings and element counts for lists/maps).  Process-wide and always on -- this is
+        /// the field data that decides which marshaling fast path to build next and confirms the
+        /// win after it ships.
+        /// @since 1.5
+        /// @see FB::ConversionStats
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap getConversionStats() const;
+
+        /// Zeroes the conversion telemetry; bracket an experiment with this and
+        /// getConversionStats() to isolate its traffic
+        /// @since 1.5
+        void resetConversionStats();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void dumpMemoryStats()
+        ///
+        /// @brief  Writes one htmlLog line per accounting category; handy from a debug console
+        /// @since 1.5
+        /// @see getMemoryStats
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void dumpMemoryStats();
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void freeRetainedObjects() const
         ///
@@ -302,29 +767,81 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void retainJSAPIPtr(const FB::JSAPIPtr& obj) const
         ///
-        /// @brief  retains an instance of the JSAPI object until the plugin shuts down
-        ///         
-        /// @param obj  JSAPIPtr object to retain
+        /// @brief  retains an instance of the JSAPI object until the plugin shuts down
+        ///         
+        /// @param obj  JSAPIPtr object to retain
         /// @since 1.4a3
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         void retainJSAPIPtr(const FB::JSAPIPtr& obj) const;
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void releaseJSAPIPtr(const FB::JSAPIPtr& obj) const
         ///
-        /// @brief  releases the specified JSAPI object to allow it to be invalidated and freed. This is
+        /// @brief  releases the specified JSAPI object to allow it to be invalidated and freed. This is
         ///         done automatically for all retained objects on shutdown
         /// @since 1.4a3
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         void releaseJSAPIPtr(const FB::JSAPIPtr& obj) const;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void retainJSAPIPtrs(const std::vector<FB::JSAPIPtr>& objs) const
+        ///
+        /// @brief  Retains a whole list of JSAPI objects, taking each shard lock at most once
+        ///
+        /// Returning a large object graph to javascript retains every node; doing that one
+        /// object at a time pays a lock acquisition per node.  Empty entries are skipped.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void retainJSAPIPtrs(const std::vector<FB::JSAPIPtr>& objs) const;
+        /// Releases a whole list of JSAPI objects, taking each shard lock at most once
+        /// @since 1.5
+        void releaseJSAPIPtrs(const std::vector<FB::JSAPIPtr>& objs) const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn unsigned int retainJSAPIGroup(const std::vector<FB::JSAPIPtr>& objs) const
+        ///
+        /// @brief  Retains an object graph as one group record and returns its id
+        ///
+        /// The graph is held by a single record instead of per-object entries, so
+        /// releaseJSAPIGroup() drops the whole batch in constant time and hands the actual
+        /// destruction to the background reaper.  Returns 0 for an empty list, which
+        /// releaseJSAPIGroup() ignores.  Prefer the scoped wrapper FB::ScopedJSAPIGroup.
+        /// @since 1.5
+        /// @see ScopedJSAPIGroup
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        unsigned int retainJSAPIGroup(const std::vector<FB::JSAPIPtr>& objs) const;
+        /// Drops the group record; the objects it held are destroyed off-thread
+        /// @since 1.5
+        void releaseJSAPIGroup(unsigned int group) const;
+
     public:
         virtual FB::DOM::WindowPtr _createWindow(const FB::JSObjectPtr& obj) const;
         virtual FB::DOM::DocumentPtr _createDocument(const FB::JSObjectPtr& obj) const;
         virtual FB::DOM::ElementPtr _createElement(const FB::JSObjectPtr& obj) const;
         virtual FB::DOM::NodePtr _createNode(const FB::JSObjectPtr& obj) const;
 
+    protected:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual FB::variant evaluateJavaScriptWithResult(const std::string &script)
+        ///
+        /// @brief  Evaluates javascript and returns the result; used by the async evaluate path
+        ///
+        /// The default forwards to evaluateJavaScript and returns an empty variant, which is all
+        /// ActiveX can do (IHTMLWindow2::execScript discards the result).  NPAPI overrides this to
+        /// hand back the value NPN_Evaluate produced.  Main thread only; throws FB::script_error
+        /// on failure like evaluateJavaScript does.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual FB::variant evaluateJavaScriptWithResult(const std::string &script);
+
     private:
         mutable AsyncCallManagerPtr _asyncManager;
+        // Created lazily by the first startTimer call
+        TimerServicePtr _timerService;
+        // NULL until startMainThreadWatchdog; kept after stop so the report survives
+        MainThreadWatchdogPtr _watchdog;
+        // Runs queued async calls on the main thread.  Scheduled once per burst by
+        // ScheduleAsyncCall and reschedules itself when it hits the flush-depth limit
+        static void AsyncCallDrain(void *drainReq);
         // Yes, this is supposed to be both private and pure virtual.
         virtual bool _scheduleAsyncCall(void (*func)(void *), void *userData) const = 0;
 
@@ -349,13 +866,133 @@ namespace FB
         boost::thread::id m_threadId;
         // if true then the plugin this belongs to has shut down (or is shutting down)
         bool m_isShutDown;
+        // bumped by invalidateDOMCaches(); DOM::Node drops cached child handles
+        // when this moves past the generation they were resolved under
+        unsigned int m_domCacheGeneration;
+        // Invalidation broadcast registry for caches that must drop eagerly on
+        // navigation instead of validating lazily against the generation
+        typedef std::map<unsigned int, InvalidationCallback> InvalidationCallbackMap;
+        mutable boost::mutex m_invalidationMutex;
+        InvalidationCallbackMap m_invalidationCallbacks;
+        unsigned int m_nextInvalidationId;
         // Used to prevent race conditions with scheduling cross-thread calls during shutdown
         mutable boost::shared_mutex m_xtmutex;
 
-        mutable std::set<FB::JSAPIPtr> m_retainedObjects;
+        // htmlLog output is buffered here and flushed batched by one scheduled
+        // call; bounded with drop-oldest overflow so logging can't stall callers
+        mutable boost::mutex m_htmlLogMutex;
+        std::deque<std::string> m_htmlLogLines;
+        size_t m_htmlLogDropped;
+        bool m_htmlLogFlushPending;
+        void flushHtmlLog();
+
+        // Pending async evaluations; batched the same way the html log is, with
+        // one scheduled flush call servicing everything queued before it runs
+        struct PendingEval {
+            PendingEval(const std::string& script, const JSEvalCallback& callback)
+                : script(script), callback(callback) { }
+            std::string script;
+            JSEvalCallback callback;
+        };
+        mutable boost::mutex m_evalMutex;
+        std::deque<PendingEval> m_pendingEvals;
+        bool m_evalFlushPending;
+        static void AsyncEvalFlush(void *evalReq);
+        void flushPendingEvals();
+
+        // Retained objects are sharded by pointer hash with a lock per shard, so
+        // worker-thread retain/release traffic doesn't all contend on one mutex
+        static const size_t RetainedObjectShardCount = 8;
+        struct RetainedObjectShard {
+            boost::mutex mutex;
+            std::set<FB::JSAPIPtr> objects;
+        };
+        mutable RetainedObjectShard m_retainedObjects[RetainedObjectShardCount];
+        RetainedObjectShard& getRetainedShard(const FB::JSAPIPtr& obj) const;
+
+        // Group-retained object graphs: one record per retainJSAPIGroup call,
+        // dropped whole by releaseJSAPIGroup without touching the shards
+        typedef boost::shared_ptr<std::list<FB::JSAPIPtr> > RetainedGroupPtr;
+        typedef std::map<unsigned int, RetainedGroupPtr> RetainedGroupMap;
+        mutable boost::mutex m_groupMutex;
+        mutable RetainedGroupMap m_retainedGroups;
+        mutable unsigned int m_nextGroupId;
+
+        // Managed callback registry; entries are tagged with the DOM cache
+        // generation they were registered under and expired incrementally (a
+        // batch per scheduled tick) once the generation moves on
+        struct ManagedCallback {
+            ManagedCallback(unsigned int generation, const FB::JSObjectPtr& callback)
+                : generation(generation), callback(callback) { }
+            unsigned int generation;
+            FB::JSObjectPtr callback;
+        };
+        mutable boost::mutex m_callbackMutex;
+        mutable std::list<ManagedCallback> m_managedCallbacks;
+        // true while an expiry tick is scheduled (or running with work left)
+        mutable bool m_callbackScanPending;
+        static void AsyncCallbackScan(void *scanReq);
+        void scheduleCallbackScan() const;
+        void scanStaleCallbacks() const;
+
+        // Bounded async invoke queue (see scheduleInvoke); one scheduled flush
+        // call drains everything queued before it runs
+        struct PendingInvoke {
+            PendingInvoke(const FB::JSObjectWeakPtr& object, const std::string& methodName,
+                const FB::VariantList& args, const std::string& key)
+                : object(object), methodName(methodName), args(args), key(key) { }
+            FB::JSObjectWeakPtr object;
+            std::string methodName;
+            FB::VariantList args;
+            std::string key;
+        };
+        typedef std::list<PendingInvoke> PendingInvokeList;
+        typedef std::map<std::string, PendingInvokeList::iterator> InvokeKeyMap;
+        mutable boost::mutex m_invokeMutex;
+        PendingInvokeList m_pendingInvokes;
+        InvokeKeyMap m_invokeKeys;
+        bool m_invokeFlushPending;
+        size_t m_invokeQueueLimit;          // 0 = unbounded
+        AsyncInvokeOverflowPolicy m_invokePolicy;
+        bool m_structuredClone;             // see setStructuredCloneEnabled
+        // signalled when the queue drains; block-producer waiters sleep here
+        boost::condition_variable m_invokeSpace;
+        static void AsyncInvokeFlush(void *invokeReq);
+        void flushPendingInvokes();
+        // must be called with m_invokeMutex held
+        void dropOldestInvoke();
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  ScopedJSAPIGroup
+    ///
+    /// @brief  RAII handle for a group-retained object graph
+    ///
+    /// Construct it with the host and the graph's nodes; the destructor drops the whole group
+    /// in constant time.  Safe to destroy after the host has gone away.
+    /// @code
+    ///      FB::ScopedJSAPIGroup playlist(m_host, nodes);
+    /// @endcode
+    /// @since 1.5
+    /// @see BrowserHost::retainJSAPIGroup
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ScopedJSAPIGroup : boost::noncopyable
+    {
+    public:
+        ScopedJSAPIGroup(const BrowserHostPtr& host, const std::vector<FB::JSAPIPtr>& objs)
+            : m_host(host), m_group(host->retainJSAPIGroup(objs)) { }
+        ~ScopedJSAPIGroup()
+        {
+            BrowserHostPtr host(m_host.lock());
+            if (host && m_group)
+                host->releaseJSAPIGroup(m_group);
+        }
+
+    private:
+        BrowserHostWeakPtr m_host;
+        unsigned int m_group;
     };
 
-    
     // Due to interdependency issues, the implementation for ScheduleAsyncCall and CallOnMainThread are found in
     // CrossThreadCall.h
 };
@@ -0,0 +1,152 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cstring>
+#include <typeinfo>
+#include "variant.h"
+#include "variant_list.h"
+#include "variant_map.h"
+#include "ConversionStats.h"
+
+using namespace FB;
+
+namespace {
+    const char* slotName(ConversionStats::Slot slot)
+    {
+        switch (slot) {
+            case ConversionStats::Slot_Empty:         return "empty";
+            case ConversionStats::Slot_Null:          return "null";
+            case ConversionStats::Slot_Bool:          return "bool";
+            case ConversionStats::Slot_Integer:       return "integer";
+            case ConversionStats::Slot_FloatingPoint: return "double";
+            case ConversionStats::Slot_String:        return "string";
+            case ConversionStats::Slot_WString:       return "wstring";
+            case ConversionStats::Slot_JSObject:      return "jsobject";
+            case ConversionStats::Slot_JSAPI:         return "jsapi";
+            case ConversionStats::Slot_List:          return "list";
+            case ConversionStats::Slot_Map:           return "map";
+            default:                                  return "other";
+        }
+    }
+
+    // classifies a variant and, for the sized slots, measures it
+    ConversionStats::Slot classify(const variant& var, size_t& size)
+    {
+        size = 0;
+        if (var.empty())
+            return ConversionStats::Slot_Empty;
+        if (var.is_null())
+            return ConversionStats::Slot_Null;
+        const std::type_info& type = var.get_type();
+        if (type == typeid(bool))
+            return ConversionStats::Slot_Bool;
+        if (type == typeid(char) || type == typeid(unsigned char)
+            || type == typeid(short) || type == typeid(unsigned short)
+            || type == typeid(int) || type == typeid(unsigned int)
+            || type == typeid(long) || type == typeid(unsigned long)
+#ifndef BOOST_NO_LONG_LONG
+            || type == typeid(long long) || type == typeid(unsigned long long)
+#endif
+            )
+            return ConversionStats::Slot_Integer;
+        if (type == typeid(double) || type == typeid(float))
+            return ConversionStats::Slot_FloatingPoint;
+        if (type == typeid(std::string)) {
+            size = var.cast<std::string>().size();
+            return ConversionStats::Slot_String;
+        }
+        if (type == typeid(std::wstring)) {
+            size = var.cast<std::wstring>().size() * sizeof(wchar_t);
+            return ConversionStats::Slot_WString;
+        }
+        if (type == typeid(FB::JSObjectPtr))
+            return ConversionStats::Slot_JSObject;
+        if (type == typeid(FB::JSAPIPtr) || type == typeid(FB::JSAPIWeakPtr))
+            return ConversionStats::Slot_JSAPI;
+        if (type == typeid(FB::VariantList)) {
+            size = var.cast<FB::VariantList>().size();
+            return ConversionStats::Slot_List;
+        }
+        if (type == typeid(FB::VariantMap)) {
+            size = var.cast<FB::VariantMap>().size();
+            return ConversionStats::Slot_Map;
+        }
+        return ConversionStats::Slot_Other;
+    }
+}
+
+ConversionStats& ConversionStats::getInstance()
+{
+    static ConversionStats instance;
+    return instance;
+}
+
+ConversionStats::ConversionStats()
+{
+    std::memset(m_counters, 0, sizeof(m_counters));
+}
+
+void ConversionStats::recordConversion(Direction dir, const variant& var)
+{
+    size_t size(0);
+    const Slot slot = classify(var, size);
+
+    size_t bucket = 0;
+    size_t v = size;
+    while (v >>= 1)
+        ++bucket;
+    if (bucket >= bucket_count)
+        bucket = bucket_count - 1;
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    Counter& c = m_counters[dir][slot];
+    ++c.count;
+    c.totalSize += size;
+    ++c.buckets[bucket];
+}
+
+FB::VariantMap ConversionStats::snapshot() const
+{
+    Counter copy[DirectionCount][SlotCount];
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        std::memcpy(copy, m_counters, sizeof(copy));
+    }
+    FB::VariantMap out;
+    for (int dir = 0; dir < DirectionCount; ++dir) {
+        FB::VariantMap dirMap;
+        for (int slot = 0; slot < SlotCount; ++slot) {
+            const Counter& c = copy[dir][slot];
+            if (!c.count)
+                continue;   // only seen types; keeps the output readable
+            FB::VariantMap entry;
+            // counters go out as doubles; that's what they become in JS anyway
+            entry["count"] = static_cast<double>(c.count);
+            entry["totalSize"] = static_cast<double>(c.totalSize);
+            FB::VariantList histogram;
+            for (size_t b = 0; b < bucket_count; ++b)
+                histogram.push_back(static_cast<int>(c.buckets[b]));
+            entry["histogram"] = histogram;
+            dirMap[slotName(static_cast<Slot>(slot))] = entry;
+        }
+        out[dir == Direction_ToBrowser ? "toBrowser" : "fromBrowser"] = dirMap;
+    }
+    return out;
+}
+
+void ConversionStats::reset()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    std::memset(m_counters, 0, sizeof(m_counters));
+}
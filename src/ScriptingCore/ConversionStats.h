@@ -0,0 +1,96 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_CONVERSIONSTATS
+#define H_FB_CONVERSIONSTATS
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include "APITypes.h"
+
+namespace FB {
+
+    class variant;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  ConversionStats
+    ///
+    /// @brief  Type-frequency and size telemetry for values crossing the browser boundary
+    ///
+    /// The NPAPI and ActiveX hosts record every variant they marshal in either direction here:
+    /// which type class it was, and for strings and containers how big.  The counters answer
+    /// "what actually flows across our API in the field" -- which marshaling fast path is worth
+    /// building next, and whether a shipped one moved the numbers.  Process-wide, always on,
+    /// and cheap: one short critical section bumping fixed-size counters per conversion, noise
+    /// against the browser call it accompanies.  Read through BrowserHost::getConversionStats().
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ConversionStats : boost::noncopyable
+    {
+    public:
+        enum Direction {
+            Direction_ToBrowser = 0,    ///< FB::variant handed to the browser
+            Direction_FromBrowser,      ///< browser value converted to FB::variant
+            DirectionCount
+        };
+
+        /// Type classes tracked per direction; integer widths are collapsed into
+        /// one slot since the marshaling path is the same for all of them
+        enum Slot {
+            Slot_Empty = 0,
+            Slot_Null,
+            Slot_Bool,
+            Slot_Integer,
+            Slot_FloatingPoint,
+            Slot_String,        ///< size sample: UTF-8 bytes
+            Slot_WString,       ///< size sample: bytes
+            Slot_JSObject,
+            Slot_JSAPI,
+            Slot_List,          ///< size sample: element count
+            Slot_Map,           ///< size sample: entry count
+            Slot_Other,
+            SlotCount
+        };
+
+        static ConversionStats& getInstance();
+
+        /// Classifies var and bumps its counters; the size sample feeds a log2
+        /// histogram so "mostly tiny strings" and "few huge lists" both show up
+        void recordConversion(Direction dir, const variant& var);
+
+        /// Counters as a VariantMap: "toBrowser"/"fromBrowser", each holding one
+        /// entry per seen type class with count, totalSize and a log2 histogram
+        FB::VariantMap snapshot() const;
+
+        /// Zeroes all counters; use around an experiment to isolate its traffic
+        void reset();
+
+    protected:
+        ConversionStats();
+
+        static const size_t bucket_count = 12;
+        struct Counter {
+            boost::uint64_t count;
+            boost::uint64_t totalSize;
+            boost::uint32_t buckets[bucket_count];
+        };
+
+        mutable boost::mutex m_mutex;
+        Counter m_counters[DirectionCount][SlotCount];
+    };
+};
+
+#endif // H_FB_CONVERSIONSTATS
@@ -1,51 +1,260 @@
-/**********************************************************\ 
-Original Author: Richard Bateman (taxilian)
-
-Created:    Oct 2, 2010
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-
-Copyright 2010 Richard Bateman, Firebreath development team
-\**********************************************************/
-
-#include "CrossThreadCall.h"
-
-using namespace FB;
-
-void CrossThreadCall::syncCallbackFunctor(void *userData)
-{
-    CrossThreadCall *call = static_cast<CrossThreadCall *>(userData);
-    {
-        // Make sure the lock goes out of scope before we finish
-        boost::lock_guard<boost::mutex> lock(call->m_mutex);
-        try 
-        {
-            call->funct->call();
-        }
-        catch(const FB::script_error& e)
-        {
-            call->m_result = variant(new FB::script_error(e.what()), true);
-        }
-        call->m_returned = true;
-        call->m_cond.notify_one();
-    }
-}
-
-void CrossThreadCall::asyncCallbackFunctor(void *userData)
-{
-    std::auto_ptr<CrossThreadCall> call(static_cast<CrossThreadCall *>(userData));
-
-    try {        
-        call->funct->call();
-    } catch (const FB::script_error& ex) {
-        // we can't sensibly handle it here
-        FB_UNUSED_VARIABLE(ex);
-    } catch (const FB::bad_variant_cast& ex) {
-        // we can't sensibly handle it here
-        FB_UNUSED_VARIABLE(ex);
-    }
-}
+/**********************************************************\ 
+Original Author: Richard Bateman (taxilian)
+
+Created:    Oct 2, 2010
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include <new>
+#include <algorithm>
+#include <boost/pool/singleton_pool.hpp>
+#include <boost/thread/thread.hpp>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "CrossThreadCall.h"
+
+using namespace FB;
+
+namespace {
+    // One free-list pool for all CrossThreadCall records; they are identical in
+    // size so every freed record is immediately reusable by the next call
+    typedef boost::singleton_pool<FB::CrossThreadCall, sizeof(FB::CrossThreadCall)> CrossThreadCallPool;
+
+    // pushes into a fixed-size ring, overwriting the oldest sample once full
+    void pushSample(std::vector<long>& samples, size_t& pos, size_t window, long value)
+    {
+        if (samples.size() < window) {
+            samples.push_back(value);
+        } else {
+            samples[pos] = value;
+            pos = (pos + 1) % window;
+        }
+    }
+
+    // the window is small, so a partial sort per percentile is cheap enough for a
+    // snapshot path that runs at telemetry frequency, not per call
+    long samplePercentile(std::vector<long> samples, double p)
+    {
+        if (samples.empty())
+            return 0;
+        size_t idx = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+        std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+        return samples[idx];
+    }
+}
+
+CrossThreadCallStats& CrossThreadCallStats::getInstance()
+{
+    static CrossThreadCallStats instance;
+    return instance;
+}
+
+void CrossThreadCallStats::recordScheduled()
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    ++m_depth;
+    ++m_scheduled;
+}
+
+void CrossThreadCallStats::recordAbandoned()
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (m_depth)
+        --m_depth;
+    ++m_abandoned;
+}
+
+void CrossThreadCallStats::recordStarted(long waitUs, const char* label)
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (m_depth)
+        --m_depth;
+    pushSample(m_waitUs, m_waitPos, SampleWindow, waitUs < 0 ? 0 : waitUs);
+    m_currentLabel = label;
+    m_currentStarted = boost::posix_time::microsec_clock::universal_time();
+}
+
+void CrossThreadCallStats::recordCompleted(long runUs)
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    ++m_completed;
+    pushSample(m_runUs, m_runPos, SampleWindow, runUs < 0 ? 0 : runUs);
+    m_currentLabel = NULL;
+}
+
+bool CrossThreadCallStats::currentCall(std::string& label, long& runningUs) const
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (!m_currentLabel)
+        return false;
+    label = m_currentLabel;
+    runningUs = static_cast<long>(
+        (boost::posix_time::microsec_clock::universal_time() - m_currentStarted).total_microseconds());
+    return true;
+}
+
+size_t CrossThreadCallStats::depth() const
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    return m_depth;
+}
+
+FB::VariantMap CrossThreadCallStats::snapshot() const
+{
+    std::vector<long> waits, runs;
+    FB::VariantMap out;
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        out["depth"] = static_cast<int>(m_depth);
+        // counters go out as doubles; that's what they become in JS anyway
+        out["scheduled"] = static_cast<double>(m_scheduled);
+        out["completed"] = static_cast<double>(m_completed);
+        out["abandoned"] = static_cast<double>(m_abandoned);
+        waits = m_waitUs;
+        runs = m_runUs;
+    }
+    // percentiles computed outside the lock so a snapshot never delays dispatch
+    out["waitP50Us"] = samplePercentile(waits, 0.50);
+    out["waitP95Us"] = samplePercentile(waits, 0.95);
+    out["waitP99Us"] = samplePercentile(waits, 0.99);
+    out["runP50Us"] = samplePercentile(runs, 0.50);
+    out["runP95Us"] = samplePercentile(runs, 0.95);
+    out["runP99Us"] = samplePercentile(runs, 0.99);
+    return out;
+}
+
+void* CrossThreadCall::operator new(std::size_t size)
+{
+    if (size != sizeof(CrossThreadCall)) {
+        return ::operator new(size);
+    }
+    void* ptr = CrossThreadCallPool::malloc();
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void CrossThreadCall::operator delete(void* ptr, std::size_t size)
+{
+    if (!ptr) {
+        return;
+    }
+    if (size != sizeof(CrossThreadCall)) {
+        ::operator delete(ptr);
+        return;
+    }
+    CrossThreadCallPool::free(ptr);
+}
+
+namespace {
+    // x86 pause keeps the spin from starving a hyperthread sibling and speeds
+    // up the exit of the loop; elsewhere the loop is just volatile reads
+    inline void pause_hint()
+    {
+#if defined(_MSC_VER)
+        _mm_pause();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+        __asm__ __volatile__ ("pause");
+#endif
+    }
+
+    const boost::uint32_t spin_limit_unset = 0xffffffffu;
+    volatile boost::uint32_t g_syncSpinLimit = spin_limit_unset;
+}
+
+unsigned int CrossThreadCall::getSyncSpinLimit()
+{
+    boost::uint32_t limit = g_syncSpinLimit;
+    if (limit == spin_limit_unset) {
+        // on a single core spinning only delays the main thread we are
+        // waiting for, so the spin phase turns itself off
+        limit = (boost::thread::hardware_concurrency() > 1) ? 4000 : 0;
+        g_syncSpinLimit = limit;
+    }
+    return limit;
+}
+
+void CrossThreadCall::setSyncSpinLimit(unsigned int iterations)
+{
+    g_syncSpinLimit = iterations;
+}
+
+void CrossThreadCall::waitForReturn(boost::unique_lock<boost::mutex>& lock)
+{
+    const unsigned int spinLimit = getSyncSpinLimit();
+    if (!m_returned && spinLimit) {
+        // the spin watches the volatile flag without the mutex (the main
+        // thread sets it under the lock); if the budget runs out mid-
+        // completion the locked recheck below catches the handoff
+        lock.unlock();
+        for (unsigned int i = 0; i < spinLimit && !m_returned; ++i)
+            pause_hint();
+        lock.lock();
+    }
+    while (!m_returned) {
+        m_cond.wait(lock);
+    }
+}
+
+void CrossThreadCall::syncCallbackFunctor(void *userData)
+{
+    CrossThreadCall *call = static_cast<CrossThreadCall *>(userData);
+    CrossThreadCallStats& stats(CrossThreadCallStats::getInstance());
+    boost::posix_time::ptime started(boost::posix_time::microsec_clock::universal_time());
+    stats.recordStarted(static_cast<long>((started - call->m_enqueued).total_microseconds()),
+        typeid(*call->funct).name());
+    {
+        // Make sure the lock goes out of scope before we finish
+        boost::lock_guard<boost::mutex> lock(call->m_mutex);
+        try 
+        {
+            call->funct->call();
+        }
+        catch(const FB::script_error& e)
+        {
+            call->m_result = variant(new FB::script_error(e.what()), true);
+        }
+        call->m_returned = true;
+        call->m_cond.notify_one();
+    }
+    // the waiting thread owns the record and may destroy it as soon as the lock above
+    // is released, so the completion sample must not touch call
+    stats.recordCompleted(static_cast<long>(
+        (boost::posix_time::microsec_clock::universal_time() - started).total_microseconds()));
+}
+
+void CrossThreadCall::asyncCallbackFunctor(void *userData)
+{
+    std::auto_ptr<CrossThreadCall> call(static_cast<CrossThreadCall *>(userData));
+    CrossThreadCallStats& stats(CrossThreadCallStats::getInstance());
+    // Calls scheduled against a since-cancelled token are dropped here without
+    // executing; destroying the record releases the target reference
+    if (call->m_token && call->m_token->isCancelled()) {
+        stats.recordAbandoned();
+        return;
+    }
+    boost::posix_time::ptime started(boost::posix_time::microsec_clock::universal_time());
+    stats.recordStarted(static_cast<long>((started - call->m_enqueued).total_microseconds()),
+        typeid(*call->funct).name());
+
+    try {
+        call->funct->call();
+    } catch (const FB::script_error& ex) {
+        // we can't sensibly handle it here
+        FB_UNUSED_VARIABLE(ex);
+    } catch (const FB::bad_variant_cast& ex) {
+        // we can't sensibly handle it here
+        FB_UNUSED_VARIABLE(ex);
+    }
+    stats.recordCompleted(static_cast<long>(
+        (boost::posix_time::microsec_clock::universal_time() - started).total_microseconds()));
+}
@@ -1,218 +1,650 @@
-/**********************************************************\
-Original Author: Richard Bateman (taxilian)
-
-Created:    Sep 14, 2010
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-
-Copyright 2009 Richard Bateman, Firebreath development team
-\**********************************************************/
-
-#ifndef H_FB_CROSSTHREADCALL
-#define H_FB_CROSSTHREADCALL
-
-#include <vector>
-#include <string>
-#include <boost/thread/condition_variable.hpp>
-#include <boost/thread/mutex.hpp>
-#include "APITypes.h"
-#include "JSObject.h"
-#include "BrowserHost.h"
-#include <boost/weak_ptr.hpp>
-#include <boost/make_shared.hpp>
-#include <boost/scoped_ptr.hpp>
-#include "logging.h"
-
-namespace FB {
-
-    class FunctorCall
-    {
-    public:
-        virtual ~FunctorCall() {}
-        virtual void call() = 0;
-        friend class CrossThreadCall;
-    };
-
-    template<class Functor, class C, class RT = typename Functor::result_type>
-    class FunctorCallImpl : public FunctorCall
-    {
-    public:
-        FunctorCallImpl(const boost::shared_ptr<C> &cls, const Functor &func) : ref(true), reference(cls), func(func) { }
-        FunctorCallImpl(const Functor &func) : ref(false), func(func) {}
-        ~FunctorCallImpl() {
-            FBLOG_TRACE("FunctorCall", "Destroying FunctorCall object (non-void)");
-        }
-        void call() {
-            retVal = func();
-        }
-        RT getResult() { return retVal; }
-
-    protected:
-        bool ref;
-        boost::shared_ptr<C> reference;
-        Functor func;
-        RT retVal;
-    };
-
-    template<class Functor, class C>
-    class FunctorCallImpl<Functor, C, void> : public FunctorCall
-    {
-    public:
-        FunctorCallImpl(const boost::shared_ptr<C> &cls, const Functor &func) : func(func), ref(true), reference(cls) { }
-        FunctorCallImpl(const Functor &func) : func(func), ref(false) {}
-        ~FunctorCallImpl() {
-            FBLOG_TRACE("FunctorCall", "Destroying FunctorCall object (void)");
-        }
-        void call() {
-            func();
-        }
-
-    protected:
-        Functor func;
-        bool ref;
-        boost::shared_ptr<C> reference;
-    };
-
-    class CrossThreadCall
-    {
-    public:
-        virtual ~CrossThreadCall() { }
-        template<class Functor>
-        static typename Functor::result_type syncCall(const FB::BrowserHostPtr &host, Functor func);
-
-        template<class Functor>
-        static typename Functor::result_type syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::true_type /* is void */);
-        template<class Functor>
-        static typename Functor::result_type syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::false_type /* is void */);
-
-        template<class C, class Functor>
-        static void asyncCall(const FB::BrowserHostPtr &host, boost::shared_ptr<C> obj, Functor func);
-
-    protected:
-        CrossThreadCall(boost::shared_ptr<FunctorCall> funct) : funct(funct), m_returned(false) { }
-
-        static void asyncCallbackFunctor(void *userData);
-        static void syncCallbackFunctor(void *userData);
-
-        boost::shared_ptr<FunctorCall> funct;
-        variant m_result;
-        bool m_returned;
-
-        boost::condition_variable m_cond;
-        boost::mutex m_mutex;
-    };
-
-    template<class C, class Functor>
-    void CrossThreadCall::asyncCall(const FB::BrowserHostPtr &host, boost::shared_ptr<C> obj, Functor func)
-    {
-        boost::shared_ptr<FunctorCall> funct = boost::make_shared<FunctorCallImpl<Functor, C> >(obj, func);
-        CrossThreadCall *call = new CrossThreadCall(funct);
-        if (!host->ScheduleAsyncCall(&CrossThreadCall::asyncCallbackFunctor, call)) {
-            // Host is likely shut down; at any rate, this didn't work. Since it's asynchronous, fail silently
-            delete call;
-            return;
-        }
-    }
-
-    template<class Functor>
-    typename Functor::result_type CrossThreadCall::syncCall(const FB::BrowserHostPtr &host, Functor func)
-    {
-        typedef boost::is_same<void, typename Functor::result_type> is_void;
-        return syncCallHelper(host, func, is_void());
-    }
-
-    template <class Functor>
-    typename Functor::result_type CrossThreadCall::syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::true_type /* return void */)
-    {
-        FB::variant varResult;
-
-        // We make this shared so that if this is something that needs to be passed into the other thread,
-        // it still goes away when everything is done with it
-        boost::shared_ptr<FunctorCallImpl<Functor, bool> > funct = boost::make_shared<FunctorCallImpl<Functor, bool> >(func);
-        if (!host->isMainThread())
-        {
-            // Synchronous call means that we want call to go away when this scope ends
-            boost::scoped_ptr<CrossThreadCall> call(new CrossThreadCall(funct));
-            {
-                boost::unique_lock<boost::mutex> lock(call->m_mutex);
-                if (!host->ScheduleAsyncCall(&CrossThreadCall::syncCallbackFunctor, call.get())) {
-                    // Browser probably shutting down, but cross thread call failed.
-                    throw FB::script_error("Could not marshal to main thread");
-                }
-
-                while (!call->m_returned) {
-                    call->m_cond.wait(lock);
-                }
-                varResult = call->m_result;
-            }
-        } else {
-            funct->call();
-        }
-        
-        if (varResult.get_type() == typeid(FB::script_error*)) {
-            FB::script_error* tmp(varResult.cast<FB::script_error*>());
-            std::string msg = tmp->what();
-            delete tmp;
-            throw FB::script_error(varResult.cast<const FB::script_error>().what());
-        }
-    }
-
-    template <class Functor>
-    typename Functor::result_type CrossThreadCall::syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::false_type /* return not void */)
-    {
-        typename Functor::result_type result;
-        FB::variant varResult;
-
-        // We make this shared so that if this is something that needs to be passed into the other thread,
-        // it still goes away when everything is done with it
-        boost::shared_ptr<FunctorCallImpl<Functor, bool> > funct = boost::make_shared<FunctorCallImpl<Functor, bool> >(func);
-        if (!host->isMainThread())
-        {
-            boost::scoped_ptr<CrossThreadCall> call(new CrossThreadCall(funct));
-            {
-                boost::unique_lock<boost::mutex> lock(call->m_mutex);
-                if (!host->ScheduleAsyncCall(&CrossThreadCall::syncCallbackFunctor, call.get())) {
-                    // Browser probably shutting down, but cross thread call failed.
-                    throw FB::script_error("Could not marshal to main thread");
-                }
-
-                while (!call->m_returned) {
-                    call->m_cond.wait(lock);
-                }
-                result = funct->getResult();
-                varResult = call->m_result;
-            }
-        } else {
-            funct->call();
-            result = funct->getResult();
-        }
-        if (varResult.get_type() == typeid(FB::script_error*)) {
-            FB::script_error* tmp(varResult.cast<FB::script_error*>());
-            std::string msg = tmp->what();
-            delete tmp;
-            throw FB::script_error(msg);
-        }
-        return result;
-    }
-
-    
-    template <class Functor>
-    typename Functor::result_type BrowserHost::CallOnMainThread(Functor func)
-    {
-        boost::shared_lock<boost::shared_mutex> _l(m_xtmutex);
-        return CrossThreadCall::syncCall(shared_ptr(), func);
-    }
-    
-    template <class C, class Functor>
-    void BrowserHost::ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func)
-    {
-        boost::shared_lock<boost::shared_mutex> _l(m_xtmutex);
-        CrossThreadCall::asyncCall(shared_ptr(), obj, func);
-    }    
-};
-
-#endif // H_FB_CROSSTHREADCALL
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Sep 14, 2010
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#ifndef H_FB_CROSSTHREADCALL
+#define H_FB_CROSSTHREADCALL
+
+#include <vector>
+#include <string>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/cstdint.hpp>
+#include "APITypes.h"
+#include "JSObject.h"
+#include "BrowserHost.h"
+#include <boost/weak_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include "logging.h"
+
+namespace FB {
+
+    FB_FORWARD_PTR(AsyncCallToken);
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  AsyncCallToken
+    ///
+    /// @brief  Cancellation token for work queued with ScheduleOnMainThread
+    ///
+    /// Create one token per logical owner (a stream, a widget), pass it when scheduling, and call
+    /// cancel() when the owner dies: every call still queued against the token is then dropped at
+    /// drain time without executing and without promoting the target pointer.  After a seek this
+    /// keeps hundreds of stale progress callbacks from burning main-thread time.  cancel() is
+    /// cheap, thread-safe and idempotent; a token can't be un-cancelled, so make a fresh one when
+    /// the owner starts new work.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class AsyncCallToken : boost::noncopyable
+    {
+    public:
+        static AsyncCallTokenPtr create() { return AsyncCallTokenPtr(new AsyncCallToken); }
+
+        /// Drops all pending calls scheduled against this token; already-running calls finish
+        void cancel() { m_cancelled = true; }
+        bool isCancelled() const { return m_cancelled; }
+
+    private:
+        AsyncCallToken() : m_cancelled(false) { }
+        // write-once flag; a stale read just means one more call executes, which
+        // is the same race the caller already has with an in-flight call
+        volatile bool m_cancelled;
+    };
+
+    class FunctorCall
+    {
+    public:
+        virtual ~FunctorCall() {}
+        virtual void call() = 0;
+        friend class CrossThreadCall;
+    };
+
+    template<class Functor, class C, class RT = typename Functor::result_type>
+    class FunctorCallImpl : public FunctorCall
+    {
+    public:
+        FunctorCallImpl(const boost::shared_ptr<C> &cls, const Functor &func) : ref(true), reference(cls), func(func) { }
+        FunctorCallImpl(const Functor &func) : ref(false), func(func) {}
+        ~FunctorCallImpl() {
+            FBLOG_TRACE("FunctorCall", "Destroying FunctorCall object (non-void)");
+        }
+        void call() {
+            retVal = func();
+        }
+        RT getResult() { return retVal; }
+
+    protected:
+        bool ref;
+        boost::shared_ptr<C> reference;
+        Functor func;
+        RT retVal;
+    };
+
+    template<class Functor, class C>
+    class FunctorCallImpl<Functor, C, void> : public FunctorCall
+    {
+    public:
+        FunctorCallImpl(const boost::shared_ptr<C> &cls, const Functor &func) : func(func), ref(true), reference(cls) { }
+        FunctorCallImpl(const Functor &func) : func(func), ref(false) {}
+        ~FunctorCallImpl() {
+            FBLOG_TRACE("FunctorCall", "Destroying FunctorCall object (void)");
+        }
+        void call() {
+            func();
+        }
+
+    protected:
+        Functor func;
+        bool ref;
+        boost::shared_ptr<C> reference;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  AsyncCallResult
+    ///
+    /// @brief  Shared result handle returned by BrowserHost::CallOnMainThreadAsync
+    ///
+    /// The calling thread keeps a shared_ptr to this object and can poll ready(), block in get(),
+    /// or attach a continuation with then().  If the main-thread call threw a script_error the
+    /// error is stored and rethrown from get(); continuations only run on success.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    template<class RT>
+    class AsyncCallResult : boost::noncopyable
+    {
+    public:
+        typedef boost::function<void (const RT&)> ContinuationType;
+
+        AsyncCallResult() : m_done(false), m_failed(false) { }
+
+        /// Returns true once the call has completed (successfully or not); never blocks
+        bool ready() const
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            return m_done;
+        }
+
+        /// Blocks until the call completes and returns its result; rethrows as a
+        /// FB::script_error if the call failed
+        RT get()
+        {
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            while (!m_done) {
+                m_cond.wait(lock);
+            }
+            if (m_failed)
+                throw FB::script_error(m_error);
+            return m_result;
+        }
+
+        /// Attaches a continuation that is handed the result as soon as it is available.
+        /// If the call is still in flight the continuation runs on the main thread right
+        /// after the functor returns; if it has already completed it runs immediately on
+        /// the calling thread.  Only one continuation may be attached, and it is never
+        /// invoked if the call failed -- errors surface through get()
+        void then(const ContinuationType& continuation)
+        {
+            bool runNow(false);
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if (m_done)
+                    runNow = true;
+                else
+                    m_continuation = continuation;
+            }
+            // Once m_done is set the result is immutable, so reading it unlocked is safe
+            if (runNow && !m_failed)
+                continuation(m_result);
+        }
+
+        void setResult(const RT& result)
+        {
+            ContinuationType continuation;
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_result = result;
+                m_done = true;
+                continuation.swap(m_continuation);
+            }
+            m_cond.notify_all();
+            if (continuation)
+                continuation(m_result);
+        }
+
+        void setError(const std::string& error)
+        {
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_error = error;
+                m_failed = true;
+                m_done = true;
+                m_continuation.clear();
+            }
+            m_cond.notify_all();
+        }
+
+    protected:
+        mutable boost::mutex m_mutex;
+        boost::condition_variable m_cond;
+        bool m_done;
+        bool m_failed;
+        std::string m_error;
+        RT m_result;
+        ContinuationType m_continuation;
+    };
+
+    template<>
+    class AsyncCallResult<void> : boost::noncopyable
+    {
+    public:
+        typedef boost::function<void ()> ContinuationType;
+
+        AsyncCallResult() : m_done(false), m_failed(false) { }
+
+        bool ready() const
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            return m_done;
+        }
+
+        void get()
+        {
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            while (!m_done) {
+                m_cond.wait(lock);
+            }
+            if (m_failed)
+                throw FB::script_error(m_error);
+        }
+
+        void then(const ContinuationType& continuation)
+        {
+            bool runNow(false);
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if (m_done)
+                    runNow = true;
+                else
+                    m_continuation = continuation;
+            }
+            if (runNow && !m_failed)
+                continuation();
+        }
+
+        void setResult()
+        {
+            ContinuationType continuation;
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_done = true;
+                continuation.swap(m_continuation);
+            }
+            m_cond.notify_all();
+            if (continuation)
+                continuation();
+        }
+
+        void setError(const std::string& error)
+        {
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_error = error;
+                m_failed = true;
+                m_done = true;
+                m_continuation.clear();
+            }
+            m_cond.notify_all();
+        }
+
+    protected:
+        mutable boost::mutex m_mutex;
+        boost::condition_variable m_cond;
+        bool m_done;
+        bool m_failed;
+        std::string m_error;
+        ContinuationType m_continuation;
+    };
+
+    // Functor run on the main thread for a future-style call; feeds the outcome of the
+    // user's functor (result or error) into the shared AsyncCallResult
+    template<class Functor, class RT = typename Functor::result_type>
+    struct FutureCallRunner
+    {
+        typedef void result_type;
+        FutureCallRunner(const boost::shared_ptr<AsyncCallResult<RT> >& state, const Functor& func)
+            : state(state), func(func) { }
+        void operator()() {
+            try {
+                state->setResult(func());
+            } catch (const std::exception& e) {
+                state->setError(e.what());
+            }
+        }
+        boost::shared_ptr<AsyncCallResult<RT> > state;
+        Functor func;
+    };
+
+    template<class Functor>
+    struct FutureCallRunner<Functor, void>
+    {
+        typedef void result_type;
+        FutureCallRunner(const boost::shared_ptr<AsyncCallResult<void> >& state, const Functor& func)
+            : state(state), func(func) { }
+        void operator()() {
+            try {
+                func();
+                state->setResult();
+            } catch (const std::exception& e) {
+                state->setError(e.what());
+            }
+        }
+        boost::shared_ptr<AsyncCallResult<void> > state;
+        Functor func;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  CrossThreadCallStats
+    ///
+    /// @brief  Process-wide queue telemetry for cross-thread calls
+    ///
+    /// Every CrossThreadCall stamps itself when it is scheduled and reports how long it sat in the
+    /// queue (wait) and how long the functor ran (run) when the main thread gets to it.  Depth is
+    /// the number of calls scheduled but not yet started -- the queue a busy main thread builds up.
+    /// Percentiles are computed over a fixed rolling window of recent samples, so memory use stays
+    /// constant however long the plugin runs.  Scrape the numbers through
+    /// BrowserHost::getCrossThreadCallStats().
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class CrossThreadCallStats : boost::noncopyable
+    {
+    public:
+        static CrossThreadCallStats& getInstance();
+
+        /// A call was handed to ScheduleAsyncCall; bumps the depth
+        void recordScheduled();
+        /// ScheduleAsyncCall refused the call (host shutting down); undoes the depth bump
+        void recordAbandoned();
+        /// The main thread picked the call up after waitUs microseconds in the queue;
+        /// label identifies the functor (typeid name) and may be NULL
+        void recordStarted(long waitUs, const char* label = NULL);
+        /// The functor finished after running for runUs microseconds
+        void recordCompleted(long runUs);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool currentCall(std::string& label, long& runningUs) const
+        ///
+        /// @brief  Identity of the call the main thread is executing right now, if any
+        ///
+        /// Fills in the functor's typeid name and how long it has been running; returns false
+        /// when the main thread is not currently inside a cross-thread functor.  This is what
+        /// the watchdog captures when a heartbeat misses its deadline -- it distinguishes "our
+        /// functor is stuck" from "the main thread stalled somewhere else entirely".
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool currentCall(std::string& label, long& runningUs) const;
+
+        /// Number of calls scheduled but not yet started
+        size_t depth() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap snapshot() const
+        ///
+        /// @brief  Returns depth, scheduled/completed/abandoned totals and p50/p95/p99 of the
+        ///         recent wait and run times in microseconds
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap snapshot() const;
+
+    private:
+        CrossThreadCallStats()
+            : m_depth(0), m_scheduled(0), m_completed(0), m_abandoned(0),
+              m_waitPos(0), m_runPos(0), m_currentLabel(NULL) { }
+
+        // ~30s of samples at typical rates; small enough to sort on every snapshot
+        static const size_t SampleWindow = 512;
+
+        mutable boost::mutex m_mutex;
+        size_t m_depth;
+        boost::uint64_t m_scheduled;
+        boost::uint64_t m_completed;
+        boost::uint64_t m_abandoned;
+        // ring buffers of the most recent samples
+        std::vector<long> m_waitUs;
+        std::vector<long> m_runUs;
+        size_t m_waitPos;
+        size_t m_runPos;
+        // Functor the main thread is inside right now; typeid names have static
+        // storage so keeping the pointer is safe.  NULL between calls
+        const char* m_currentLabel;
+        boost::posix_time::ptime m_currentStarted;
+    };
+
+    class CrossThreadCall
+    {
+    public:
+        virtual ~CrossThreadCall() { }
+        template<class Functor>
+        static typename Functor::result_type syncCall(const FB::BrowserHostPtr &host, Functor func);
+
+        template<class Functor>
+        static typename Functor::result_type syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::true_type /* is void */);
+        template<class Functor>
+        static typename Functor::result_type syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::false_type /* is void */);
+
+        template<class C, class Functor>
+        static void asyncCall(const FB::BrowserHostPtr &host, boost::shared_ptr<C> obj, Functor func,
+            AsyncCallPriority priority = AsyncCallPriority_Bulk);
+        template<class C, class Functor>
+        static void asyncCall(const FB::BrowserHostPtr &host, boost::shared_ptr<C> obj, Functor func,
+            const AsyncCallTokenPtr& token, AsyncCallPriority priority = AsyncCallPriority_Bulk);
+
+        template<class Functor>
+        static boost::shared_ptr<AsyncCallResult<typename Functor::result_type> > futureCall(const FB::BrowserHostPtr &host, Functor func);
+
+        // Call records are identically sized and made thousands of times a second
+        // during playback, so they come off a fixed-size free list rather than
+        // hitting the general heap allocator every time
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn static void CrossThreadCall::setSyncSpinLimit(unsigned int iterations)
+        ///
+        /// @brief  Sets how many pause iterations a synchronous caller spins before blocking
+        ///         on the condition variable; 0 disables the spin phase entirely
+        ///
+        /// A call the main thread services in a few microseconds costs more in the blocking
+        /// sleep/wake cycle than in the call itself, so the waiter spins briefly first.  The
+        /// default budget covers a fast service and turns itself off on single-core machines,
+        /// where spinning only delays the thread being waited for.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        static void setSyncSpinLimit(unsigned int iterations);
+        /// Current spin budget; resolves the single-core default on first use
+        static unsigned int getSyncSpinLimit();
+
+    protected:
+        // Spin-then-block wait for m_returned; called with the lock held and
+        // returns with it held
+        void waitForReturn(boost::unique_lock<boost::mutex>& lock);
+
+        CrossThreadCall(boost::shared_ptr<FunctorCall> funct,
+                const AsyncCallTokenPtr& token = AsyncCallTokenPtr())
+            : funct(funct), m_token(token), m_returned(false),
+              m_enqueued(boost::posix_time::microsec_clock::universal_time())
+        {
+            CrossThreadCallStats::getInstance().recordScheduled();
+        }
+
+        static void asyncCallbackFunctor(void *userData);
+        static void syncCallbackFunctor(void *userData);
+
+        boost::shared_ptr<FunctorCall> funct;
+        // non-NULL when scheduled against a cancellation token; checked at drain
+        AsyncCallTokenPtr m_token;
+        variant m_result;
+        // volatile so the waiter's spin phase can watch it without the mutex;
+        // the main thread still sets it under the lock
+        volatile bool m_returned;
+        // stamped at scheduling time; the main-thread callbacks turn it into a queue-wait sample
+        boost::posix_time::ptime m_enqueued;
+
+        boost::condition_variable m_cond;
+        boost::mutex m_mutex;
+    };
+
+    template<class C, class Functor>
+    void CrossThreadCall::asyncCall(const FB::BrowserHostPtr &host, boost::shared_ptr<C> obj, Functor func,
+        AsyncCallPriority priority)
+    {
+        boost::shared_ptr<FunctorCall> funct =
+            boost::allocate_shared<FunctorCallImpl<Functor, C> >(
+                boost::fast_pool_allocator<FunctorCallImpl<Functor, C> >(), obj, func);
+        CrossThreadCall *call = new CrossThreadCall(funct);
+        if (!host->ScheduleAsyncCall(&CrossThreadCall::asyncCallbackFunctor, call, priority)) {
+            // Host is likely shut down; at any rate, this didn't work. Since it's asynchronous, fail silently
+            CrossThreadCallStats::getInstance().recordAbandoned();
+            delete call;
+            return;
+        }
+    }
+
+    template<class C, class Functor>
+    void CrossThreadCall::asyncCall(const FB::BrowserHostPtr &host, boost::shared_ptr<C> obj, Functor func,
+        const AsyncCallTokenPtr& token, AsyncCallPriority priority)
+    {
+        boost::shared_ptr<FunctorCall> funct =
+            boost::allocate_shared<FunctorCallImpl<Functor, C> >(
+                boost::fast_pool_allocator<FunctorCallImpl<Functor, C> >(), obj, func);
+        CrossThreadCall *call = new CrossThreadCall(funct, token);
+        if (!host->ScheduleAsyncCall(&CrossThreadCall::asyncCallbackFunctor, call, priority)) {
+            // Host is likely shut down; at any rate, this didn't work. Since it's asynchronous, fail silently
+            CrossThreadCallStats::getInstance().recordAbandoned();
+            delete call;
+            return;
+        }
+    }
+
+    template<class Functor>
+    boost::shared_ptr<AsyncCallResult<typename Functor::result_type> > CrossThreadCall::futureCall(const FB::BrowserHostPtr &host, Functor func)
+    {
+        typedef typename Functor::result_type RT;
+        boost::shared_ptr<AsyncCallResult<RT> > state(boost::make_shared<AsyncCallResult<RT> >());
+        FutureCallRunner<Functor> runner(state, func);
+        if (host->isMainThread()) {
+            runner();
+        } else {
+            // The state shared_ptr rides along as the keep-alive reference, so the handle
+            // stays valid however long the browser takes to deliver the call
+            boost::shared_ptr<FunctorCall> funct =
+                boost::allocate_shared<FunctorCallImpl<FutureCallRunner<Functor>, AsyncCallResult<RT> > >(
+                    boost::fast_pool_allocator<FunctorCallImpl<FutureCallRunner<Functor>, AsyncCallResult<RT> > >(),
+                    state, runner);
+            CrossThreadCall *call = new CrossThreadCall(funct);
+            if (!host->ScheduleAsyncCall(&CrossThreadCall::asyncCallbackFunctor, call)) {
+                // Browser probably shutting down; fail the handle rather than let get() hang
+                CrossThreadCallStats::getInstance().recordAbandoned();
+                delete call;
+                state->setError("Could not marshal to main thread");
+            }
+        }
+        return state;
+    }
+
+    template<class Functor>
+    typename Functor::result_type CrossThreadCall::syncCall(const FB::BrowserHostPtr &host, Functor func)
+    {
+        typedef boost::is_same<void, typename Functor::result_type> is_void;
+        return syncCallHelper(host, func, is_void());
+    }
+
+    template <class Functor>
+    typename Functor::result_type CrossThreadCall::syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::true_type /* return void */)
+    {
+        FB::variant varResult;
+
+        // We make this shared so that if this is something that needs to be passed into the other thread,
+        // it still goes away when everything is done with it
+        boost::shared_ptr<FunctorCallImpl<Functor, bool> > funct =
+            boost::allocate_shared<FunctorCallImpl<Functor, bool> >(
+                boost::fast_pool_allocator<FunctorCallImpl<Functor, bool> >(), func);
+        if (!host->isMainThread())
+        {
+            // Synchronous call means that we want call to go away when this scope ends
+            boost::scoped_ptr<CrossThreadCall> call(new CrossThreadCall(funct));
+            {
+                boost::unique_lock<boost::mutex> lock(call->m_mutex);
+                // A blocked caller is waiting on this, so it goes in the interactive lane
+                if (!host->ScheduleAsyncCall(&CrossThreadCall::syncCallbackFunctor, call.get(),
+                        AsyncCallPriority_Interactive)) {
+                    // Browser probably shutting down, but cross thread call failed.
+                    CrossThreadCallStats::getInstance().recordAbandoned();
+                    throw FB::script_error("Could not marshal to main thread");
+                }
+
+                call->waitForReturn(lock);
+                varResult = call->m_result;
+            }
+        } else {
+            funct->call();
+        }
+        
+        if (varResult.get_type() == typeid(FB::script_error*)) {
+            FB::script_error* tmp(varResult.cast<FB::script_error*>());
+            std::string msg = tmp->what();
+            delete tmp;
+            throw FB::script_error(varResult.cast<const FB::script_error>().what());
+        }
+    }
+
+    template <class Functor>
+    typename Functor::result_type CrossThreadCall::syncCallHelper(const FB::BrowserHostPtr &host, Functor func, boost::false_type /* return not void */)
+    {
+        typename Functor::result_type result;
+        FB::variant varResult;
+
+        // We make this shared so that if this is something that needs to be passed into the other thread,
+        // it still goes away when everything is done with it
+        boost::shared_ptr<FunctorCallImpl<Functor, bool> > funct =
+            boost::allocate_shared<FunctorCallImpl<Functor, bool> >(
+                boost::fast_pool_allocator<FunctorCallImpl<Functor, bool> >(), func);
+        if (!host->isMainThread())
+        {
+            boost::scoped_ptr<CrossThreadCall> call(new CrossThreadCall(funct));
+            {
+                boost::unique_lock<boost::mutex> lock(call->m_mutex);
+                // A blocked caller is waiting on this, so it goes in the interactive lane
+                if (!host->ScheduleAsyncCall(&CrossThreadCall::syncCallbackFunctor, call.get(),
+                        AsyncCallPriority_Interactive)) {
+                    // Browser probably shutting down, but cross thread call failed.
+                    CrossThreadCallStats::getInstance().recordAbandoned();
+                    throw FB::script_error("Could not marshal to main thread");
+                }
+
+                call->waitForReturn(lock);
+                result = funct->getResult();
+                varResult = call->m_result;
+            }
+        } else {
+            funct->call();
+            result = funct->getResult();
+        }
+        if (varResult.get_type() == typeid(FB::script_error*)) {
+            FB::script_error* tmp(varResult.cast<FB::script_error*>());
+            std::string msg = tmp->what();
+            delete tmp;
+            throw FB::script_error(msg);
+        }
+        return result;
+    }
+
+    
+    template <class Functor>
+    typename Functor::result_type BrowserHost::CallOnMainThread(Functor func)
+    {
+        boost::shared_lock<boost::shared_mutex> _l(m_xtmutex);
+        return CrossThreadCall::syncCall(shared_ptr(), func);
+    }
+    
+    template <class Functor>
+    boost::shared_ptr<AsyncCallResult<typename Functor::result_type> > BrowserHost::CallOnMainThreadAsync(Functor func)
+    {
+        boost::shared_lock<boost::shared_mutex> _l(m_xtmutex);
+        return CrossThreadCall::futureCall(shared_ptr(), func);
+    }
+
+    template <class C, class Functor>
+    void BrowserHost::ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func)
+    {
+        boost::shared_lock<boost::shared_mutex> _l(m_xtmutex);
+        CrossThreadCall::asyncCall(shared_ptr(), obj, func);
+    }
+
+    template <class C, class Functor>
+    void BrowserHost::ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func, AsyncCallPriority priority)
+    {
+        boost::shared_lock<boost::shared_mutex> _l(m_xtmutex);
+        CrossThreadCall::asyncCall(shared_ptr(), obj, func, priority);
+    }
+
+    template <class C, class Functor>
+    void BrowserHost::ScheduleOnMainThread(boost::shared_ptr<C> obj, Functor func, const AsyncCallTokenPtr& token,
+        AsyncCallPriority priority)
+    {
+        boost::shared_lock<boost::shared_mutex> _l(m_xtmutex);
+        CrossThreadCall::asyncCall(shared_ptr(), obj, func, token, priority);
+    }
+};
+
+#endif // H_FB_CROSSTHREADCALL
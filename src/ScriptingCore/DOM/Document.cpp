@@ -1,41 +1,58 @@
-/**********************************************************\ 
-Original Author: Richard Bateman (taxilian)
-
-Created:    Dec 9, 2009
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-
-Copyright 2009 PacketPass, Inc and the Firebreath development team
-\**********************************************************/
-
-#include "variant.h"
-#include "variant_list.h"
-#include "Window.h"
-
-#include "Document.h"
-
-using namespace FB::DOM;
-
-Document::Document(const FB::JSObjectPtr& element) : Node(element), Element(element)
-{
-}
-
-Document::~Document()
-{
-}
-
-WindowPtr Document::getWindow() const
-{
-    JSObjectPtr api = getProperty<FB::JSObjectPtr>("window");
-    return Window::create(api);
-}
-
-ElementPtr Document::getBody() const
-{
-    JSObjectPtr api = getProperty<FB::JSObjectPtr>("body");
-    return Element::create(api);
-}
+/**********************************************************\ 
+Original Author: Richard Bateman (taxilian)
+
+Created:    Dec 9, 2009
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include "variant.h"
+#include "variant_list.h"
+#include "Window.h"
+#include "BrowserHost.h"
+
+#include "Document.h"
+
+using namespace FB::DOM;
+
+Document::Document(const FB::JSObjectPtr& element) : Node(element), Element(element), m_idCacheGen(0)
+{
+}
+
+Document::~Document()
+{
+}
+
+WindowPtr Document::getWindow() const
+{
+    JSObjectPtr api = getChildObject("window");
+    return Window::create(api);
+}
+
+ElementPtr Document::getBody() const
+{
+    JSObjectPtr api = getChildObject("body");
+    return Element::create(api);
+}
+
+ElementPtr Document::getElementByIdCached(const std::string& elem_id) const
+{
+    const unsigned int gen = m_element->host ? m_element->host->getDOMCacheGeneration() : 0;
+    if (gen != m_idCacheGen) {
+        m_idCache.clear();
+        m_idCacheGen = gen;
+    }
+    std::map<std::string, ElementPtr>::const_iterator it = m_idCache.find(elem_id);
+    if (it != m_idCache.end() && it->second)
+        return it->second;
+    ElementPtr element = getElementById(elem_id);
+    if (element)
+        m_idCache[elem_id] = element;
+    return element;
+}
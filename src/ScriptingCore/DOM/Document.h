@@ -82,6 +82,33 @@ namespace FB { namespace DOM {
         /// @return The document's body.
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual ElementPtr getBody() const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual ElementPtr Document::getElementByIdCached(const std::string& elem_id) const
+        ///
+        /// @brief  Like getElementById, but reuses the handle for repeated lookups of the same id
+        ///
+        /// Resolving the same anchor element every frame through getElementById pays a browser
+        /// round trip each time.  This caches the element wrapper per id, validated against the
+        /// BrowserHost's DOM cache generation the same way Node::getChildObject is -- so handles
+        /// survive until shutdown or an explicit BrowserHost::invalidateDOMCaches() (call that on
+        /// navigation or when script replaces the elements being tracked).  An id that failed to
+        /// resolve is not cached; it is retried on the next call.
+        ///
+        /// @param  elem_id The id of the element to fetch
+        ///
+        /// @return the element, or an empty pointer if no element has that id
+        /// @see getElementById
+        /// @see FB::BrowserHost::invalidateDOMCaches
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual ElementPtr getElementByIdCached(const std::string& elem_id) const;
+
+    protected:
+        /// element handles resolved through getElementByIdCached, keyed by id
+        mutable std::map<std::string, ElementPtr> m_idCache;
+        /// BrowserHost DOM cache generation m_idCache was filled under
+        mutable unsigned int m_idCacheGen;
     };
 
 }; };
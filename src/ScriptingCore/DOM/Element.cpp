@@ -62,6 +62,18 @@ int Element::getScrollHeight() const
     return getProperty<int>("scrollHeight");
 }
 
+FB::VariantMap Element::getLayout() const
+{
+    std::vector<std::string> names;
+    names.push_back("offsetLeft");
+    names.push_back("offsetTop");
+    names.push_back("offsetWidth");
+    names.push_back("offsetHeight");
+    names.push_back("scrollWidth");
+    names.push_back("scrollHeight");
+    return getProperties(names);
+}
+
 int Element::getChildNodeCount() const
 {
     return getNode("childNodes")->getProperty<int>("length");
@@ -134,6 +134,25 @@ namespace FB { namespace DOM {
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual int getScrollHeight() const;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual FB::VariantMap Element::getLayout() const
+        ///
+        /// @brief  Gets the element's layout box in a single browser crossing
+        ///
+        /// Fetches offsetLeft, offsetTop, offsetWidth, offsetHeight, scrollWidth and
+        /// scrollHeight through the batched property API, so computing the box costs one
+        /// round trip instead of one per property.
+        ///
+        /// @code
+        ///     FB::VariantMap box = el->getLayout();
+        ///     int width = box["offsetWidth"].convert_cast<int>();
+        /// @endcode
+        ///
+        /// @return map of property name to value
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual FB::VariantMap getLayout() const;
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual int Element::getChildNodeCount() const
         ///
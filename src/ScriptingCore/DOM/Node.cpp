@@ -13,25 +13,46 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 \**********************************************************/
 
 #include "JSObject.h"
+#include "BrowserHost.h"
 
 #include "Node.h"
 
-FB::DOM::NodePtr FB::DOM::Node::getNode(const std::wstring& name) const 
+FB::DOM::NodePtr FB::DOM::Node::getNode(const std::wstring& name) const
 {
     return getNode(FB::wstring_to_utf8(name));
 }
 FB::DOM::NodePtr FB::DOM::Node::getNode(const std::string& name) const
 {
-    FB::JSObjectPtr api = getProperty<FB::JSObjectPtr>(name);
+    FB::JSObjectPtr api = getChildObject(name);
     return Node::create(api);
 }
 
+FB::JSObjectPtr FB::DOM::Node::getChildObject(const std::string& name) const
+{
+    const unsigned int gen = m_element->host ? m_element->host->getDOMCacheGeneration() : 0;
+    if (gen != m_childCacheGen) {
+        m_childCache.clear();
+        m_childCacheGen = gen;
+    }
+    std::map<std::string, FB::JSObjectPtr>::const_iterator it = m_childCache.find(name);
+    if (it != m_childCache.end() && it->second)
+        return it->second;
+    FB::JSObjectPtr obj = getProperty<FB::JSObjectPtr>(name);
+    m_childCache[name] = obj;
+    return obj;
+}
+
 FB::DOM::NodePtr FB::DOM::Node::getNode(const int idx) const
 {
     FB::JSObjectPtr api = getProperty<JSObjectPtr>(idx);
     return Node::create(api);
 }
 
+FB::VariantMap FB::DOM::Node::getProperties(const std::vector<std::string>& names) const
+{
+    return m_element->GetProperties(names);
+}
+
 void FB::DOM::Node::setProperty(const std::wstring& name, const FB::variant& val) const
 {
     setProperty(FB::wstring_to_utf8(name), val);
@@ -17,6 +17,7 @@ Copyright 2009 PacketPass, Inc and the Firebreath development team
 #define H_FB_DOM_NODE
 
 #include <string>
+#include <map>
 #include <boost/enable_shared_from_this.hpp>
 #include "JSObject.h"
 
@@ -39,7 +40,7 @@ namespace FB { namespace DOM {
     class Node : public boost::enable_shared_from_this<Node>
     {
     public:
-        Node(const JSObjectPtr& element) : m_element(element) { }
+        Node(const JSObjectPtr& element) : m_element(element), m_childCacheGen(0) { }
         virtual ~Node() { }
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -148,6 +149,30 @@ namespace FB { namespace DOM {
             return tmp.convert_cast<T>();
         }
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual FB::VariantMap getProperties(const std::vector<std::string>& names) const
+        ///
+        /// @brief  Gets several properties of the node in one batch
+        ///
+        /// The names are fetched through the JSAPI batched property API, so browser glue that can
+        /// answer the whole set with one crossing (thread marshal, DISPID resolution, etc) will do
+        /// so; reading style and geometry of a node this way costs one round trip instead of one
+        /// per property.
+        ///
+        /// @code
+        ///     std::vector<std::string> names;
+        ///     names.push_back("offsetWidth");
+        ///     names.push_back("offsetHeight");
+        ///     FB::VariantMap geom = docNode.getProperties(names);
+        /// @endcode
+        ///
+        /// @param  names the names of the properties to get
+        ///
+        /// @return map of property name to value
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual FB::VariantMap getProperties(const std::vector<std::string>& names) const;
+
         /// @overload
         virtual NodePtr getNode(const std::wstring& name) const;
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -189,8 +214,39 @@ namespace FB { namespace DOM {
         /// @overload
         virtual void setProperty(const int idx, const variant& val) const;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual JSObjectPtr getChildObject(const std::string& name) const
+        ///
+        /// @brief  Gets a child JSObject of this node, caching the handle for reuse
+        ///
+        /// Chained DOM walks (document.body.style every frame, say) otherwise re-resolve every
+        /// intermediate object through the browser each time.  Handles fetched through here are
+        /// kept until the BrowserHost's DOM cache generation moves on -- which happens on
+        /// shutdown and whenever BrowserHost::invalidateDOMCaches() is called (do that on
+        /// navigation or when script replaces the nodes being walked).  getNode() resolves
+        /// through this cache.
+        ///
+        /// @param  name the name of the child property to fetch
+        ///
+        /// @return the child JSObject
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual JSObjectPtr getChildObject(const std::string& name) const;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void invalidateChildCache() const
+        ///
+        /// @brief  Drops this node's cached child handles without touching the rest of the page
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void invalidateChildCache() const { m_childCache.clear(); }
+
     protected:
         JSObjectPtr m_element; // The JSObject that this object wraps
+        /// child handles resolved through getChildObject, keyed by property name
+        mutable std::map<std::string, JSObjectPtr> m_childCache;
+        /// BrowserHost DOM cache generation m_childCache was filled under
+        mutable unsigned int m_childCacheGen;
     };
 
 }; };
@@ -31,7 +31,7 @@ Window::~Window()
 
 DocumentPtr Window::getDocument() const
 {
-    JSObjectPtr api = getProperty<JSObjectPtr>("document");
+    JSObjectPtr api = getChildObject("document");
     return Document::create(api);
 }
 
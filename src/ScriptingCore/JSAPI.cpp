@@ -13,6 +13,9 @@ Copyright 2009 Richard Bateman, Firebreath development team
 \**********************************************************/
 
 #include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/tss.hpp>
 #include "BrowserHost.h"
 #include "JSObject.h"
 #include "utf8_tools.h"
@@ -22,15 +25,44 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 using namespace FB;
 
-JSAPI::JSAPI(void) : m_valid(true)
+namespace
+{
+    // Active zones live on a per-thread stack of (object, zone) pairs; zone
+    // scopes nest properly within a thread, so one stack per thread covers
+    // every JSAPI object and entry/exit never takes a lock.  Other threads
+    // are unaffected by a push and keep seeing the object's default zone
+    struct ThreadZoneEntry
+    {
+        const FB::JSAPI* api;
+        FB::SecurityZone zone;
+    };
+    typedef std::vector<ThreadZoneEntry> ThreadZoneStack;
+    boost::thread_specific_ptr<ThreadZoneStack> tl_zoneStack;
+
+    // Upper bound on free event-dispatch records kept per API object; more
+    // than this many fires in flight at once is not a steady state worth
+    // holding memory for
+    const size_t DispatchRecordPoolMax = 4;
+
+    ThreadZoneStack& getThreadZoneStack()
+    {
+        ThreadZoneStack* stack = tl_zoneStack.get();
+        if (!stack) {
+            stack = new ThreadZoneStack;
+            stack->reserve(8);
+            tl_zoneStack.reset(stack);
+        }
+        return *stack;
+    }
+}
+
+JSAPI::JSAPI(void) : m_defaultZone(SecurityScope_Public), m_valid(true)
 {
-    m_zoneStack.push_back(SecurityScope_Public);
     registerEvent("onload");
 }
 
-FB::JSAPI::JSAPI( const SecurityZone& securityLevel ) : m_valid(true)
+FB::JSAPI::JSAPI( const SecurityZone& securityLevel ) : m_defaultZone(securityLevel), m_valid(true)
 {
-    m_zoneStack.push_back(securityLevel);
     registerEvent("onload");
 }
 
@@ -46,39 +78,42 @@ void JSAPI::invalidate()
 // Security zone management
 void FB::JSAPI::setDefaultZone( const SecurityZone& securityLevel )
 {
-    assert(m_zoneStack.size() > 0);
-    m_zoneStack.pop_front();
-    m_zoneStack.push_front(securityLevel);
+    m_defaultZone = securityLevel;
 }
 FB::SecurityZone FB::JSAPI::getDefaultZone() const
 {
-    assert(m_zoneStack.size() > 0);
-    return m_zoneStack.front();
+    return m_defaultZone;
 }
 
 void FB::JSAPI::pushZone( const SecurityZone& securityLevel )
 {
-    m_zoneMutex.lock();
-    m_zoneStack.push_back(securityLevel);
+    ThreadZoneEntry entry = { this, securityLevel };
+    getThreadZoneStack().push_back(entry);
 }
 
 void FB::JSAPI::popZone( )
 {
-    m_zoneStack.pop_back();
-    m_zoneMutex.unlock();
+    ThreadZoneStack& stack(getThreadZoneStack());
+    assert(!stack.empty() && stack.back().api == this);
+    stack.pop_back();
 }
 
 FB::SecurityZone FB::JSAPI::getZone() const
 {
-    assert(m_zoneStack.size() > 0);
-    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
-    return m_zoneStack.back();
+    // Topmost zone this thread pushed on this object; the stack is tiny (zone
+    // scopes rarely nest more than a level or two) so the scan is cheap
+    const ThreadZoneStack& stack(getThreadZoneStack());
+    for (ThreadZoneStack::const_reverse_iterator it = stack.rbegin(); it != stack.rend(); ++it) {
+        if (it->api == this)
+            return it->zone;
+    }
+    return m_defaultZone;
 }
 
 
 void JSAPI::FireEvent(const std::wstring& eventName, const std::vector<variant>& args)
 {
-    FireEvent(wstring_to_utf8(eventName), args);
+    FireEvent(wstring_to_utf8_cached(eventName), args);
 }
 
 FB::VariantMap proxyProcessMap( const FB::VariantMap &args, const FB::JSAPIPtr& self, const FB::JSAPIPtr& proxy );
@@ -118,21 +153,102 @@ FB::VariantMap proxyProcessMap( const FB::VariantMap &args, const FB::JSAPIPtr&
     return newMap;
 }
 
+JSAPI::EventTablesPtr JSAPI::getEventTables() const
+{
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
+    if (!m_eventTables) {
+        // First reader on an object that never registered anything; publish
+        // an empty snapshot once so callers never have to check for NULL
+        m_eventTables = boost::make_shared<EventTables>();
+    }
+    return m_eventTables;
+}
+
+void JSAPI::publishEventTables()
+{
+    boost::shared_ptr<EventTables> snap(boost::make_shared<EventTables>());
+    snap->eventMap = m_eventMap;
+    snap->defEventMap = m_defEventMap;
+    snap->evtIfaces = m_evtIfaces;
+    m_eventTables = snap;
+}
+
+JSAPI::EventDispatchRecordPtr JSAPI::acquireEventDispatchRecord()
+{
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
+    if (!m_dispatchRecordPool.empty()) {
+        EventDispatchRecordPtr record(m_dispatchRecordPool.back());
+        m_dispatchRecordPool.pop_back();
+        return record;
+    }
+    return boost::make_shared<EventDispatchRecord>();
+}
+
+void JSAPI::releaseEventDispatchRecord(const EventDispatchRecordPtr& record)
+{
+    // clear() keeps the vectors' capacity; that reuse is the whole point --
+    // after the first few fires a steady-state event allocates nothing here
+    record->batch.clear();
+    record->args.clear();
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
+    if (m_dispatchRecordPool.size() < DispatchRecordPoolMax)
+        m_dispatchRecordPool.push_back(record);
+}
+
+void JSAPI::invokeEventRecord(const EventDispatchRecordPtr& record)
+{
+    invokeEventHandlers(record->batch, record->args);
+    releaseEventDispatchRecord(record);
+}
+
 void JSAPI::fireAsyncEvent( const std::string& eventName, const std::vector<variant>& args )
 {
-    std::pair<EventMultiMap::iterator, EventMultiMap::iterator> range = m_eventMap.equal_range(eventName);
+    // Collect the handlers from the current event-table snapshot into a pooled
+    // dispatch record, then hand the whole record to the main thread as a
+    // single scheduled call; one cross-thread round trip covers every handler,
+    // the record's storage is reused fire after fire, and since the snapshot
+    // is immutable no lock is held while walking it -- concurrent fires from
+    // worker threads run in parallel with each other and with member dispatch
+    EventDispatchRecordPtr record(acquireEventDispatchRecord());
+    EventBatch& batch = record->batch;
+    {
+        EventTablesPtr tables(getEventTables());
+        std::pair<EventMultiMap::const_iterator, EventMultiMap::const_iterator> range =
+            tables->eventMap.equal_range(eventName);
+
+        for (EventMultiMap::const_iterator eventIt = range.first; eventIt != range.second; eventIt++) {
+            batch.push_back(EventPair("", eventIt->second));
+        }
+        EventSingleMap::const_iterator fnd = tables->defEventMap.find(eventName);
+        if (fnd != tables->defEventMap.end() && fnd->second != NULL && fnd->second->getEventId() != NULL) {
+            batch.push_back(EventPair("", fnd->second));
+        }
 
-    for (EventMultiMap::const_iterator eventIt = range.first; eventIt != range.second; eventIt++) {
-        eventIt->second->InvokeAsync("", args);
+        // Some events are registered as a jsapi object with a method of the same name as the event
+        for (EventIFaceMap::const_iterator ifaceIt = tables->evtIfaces.begin(); ifaceIt != tables->evtIfaces.end(); ifaceIt++) {
+            batch.push_back(EventPair(eventName, ifaceIt->second));
+        }
     }
-    EventSingleMap::const_iterator fnd = m_defEventMap.find(eventName);
-    if (fnd != m_defEventMap.end() && fnd->second != NULL && fnd->second->getEventId() != NULL) {
-        fnd->second->InvokeAsync("", args);
+
+    BrowserHostPtr host(batch.empty() ? BrowserHostPtr() : batch.front().second->host);
+    if (batch.empty() || !host) {
+        releaseEventDispatchRecord(record);
+        return;
     }
+    record->args.assign(args.begin(), args.end());
+    host->ScheduleOnMainThread(shared_ptr(),
+        boost::bind(&JSAPI::invokeEventRecord, this, record));
+}
 
-    // Some events are registered as a jsapi object with a method of the same name as the event
-    for (EventIFaceMap::const_iterator ifaceIt = m_evtIfaces.begin(); ifaceIt != m_evtIfaces.end(); ifaceIt++) {
-        ifaceIt->second->InvokeAsync(eventName, args);
+void JSAPI::invokeEventHandlers( const EventBatch& handlers, const std::vector<variant>& args )
+{
+    // Runs on the main thread.  A handler that throws must not keep the rest of the
+    // batch from firing; that matches the isolation separate async calls provided
+    for (EventBatch::const_iterator it = handlers.begin(); it != handlers.end(); ++it) {
+        try {
+            it->second->Invoke(it->first, args);
+        } catch (const std::exception&) {
+        }
     }
 }
 
@@ -190,23 +306,16 @@ void FB::JSAPI::FireJSEvent( const std::string& eventName, const FB::VariantMap
         }
     }
     
-    FB::VariantList args;
-    args.push_back(FB::CreateEvent(shared_ptr(), eventName, members, arguments));
+    // Build the event in a pooled map so 60Hz event sources aren't
+    // reconstructing the same seven standard entries on every fire; the map
+    // goes back to the pool when evt falls off the stack
+    FB::EventMapPtr evt(FB::acquireEventMap());
+    FB::CreateEvent(shared_ptr(), eventName, members, arguments, *evt);
 
-    std::pair<EventMultiMap::iterator, EventMultiMap::iterator> range = m_eventMap.equal_range(eventName);
-    for (EventMultiMap::iterator eventIt = range.first; eventIt != range.second; eventIt++) {
-        eventIt->second->InvokeAsync("", args);
-    }
-
-    EventSingleMap::iterator fnd = m_defEventMap.find(eventName);
-    if (fnd != m_defEventMap.end() && fnd->second != NULL && fnd->second->getEventId() != NULL) {
-        fnd->second->InvokeAsync("", args);
-    }
+    FB::VariantList args;
+    args.push_back(*evt);
 
-    // Some events are registered as a jsapi object with a method of the same name as the event
-    for (EventIFaceMap::iterator ifaceIt = m_evtIfaces.begin(); ifaceIt != m_evtIfaces.end(); ifaceIt++) {
-        ifaceIt->second->InvokeAsync(eventName, args);
-    }
+    fireAsyncEvent(eventName, args);
 }
 
 void FB::JSAPI::FireJSEvent( const std::string& eventName, const FB::VariantMap &params )
@@ -222,13 +331,14 @@ void FB::JSAPI::FireJSEvent( const std::string& eventName, const FB::VariantList
 
 bool JSAPI::HasEvent(const std::wstring& eventName) const
 {
-    return HasEvent(wstring_to_utf8(eventName));
+    return HasEvent(wstring_to_utf8_cached(eventName));
 }
 
 bool JSAPI::HasEvent(const std::string& eventName) const
 {
-    EventSingleMap::const_iterator fnd = m_defEventMap.find(eventName);
-    if (fnd != m_defEventMap.end()) {
+    EventTablesPtr tables(getEventTables());
+    EventSingleMap::const_iterator fnd = tables->defEventMap.find(eventName);
+    if (fnd != tables->defEventMap.end()) {
         return true;
     } else {
         return false;
@@ -237,11 +347,12 @@ bool JSAPI::HasEvent(const std::string& eventName) const
 
 void JSAPI::registerEventMethod(const std::wstring& name, JSObjectPtr &event)
 {
-    registerEventMethod(wstring_to_utf8(name), event);
+    registerEventMethod(wstring_to_utf8_cached(name), event);
 }
 
 void JSAPI::registerEventMethod(const std::string& name, JSObjectPtr &event)
 {
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
     std::pair<EventMultiMap::iterator, EventMultiMap::iterator> range = m_eventMap.equal_range(name);
 
     for (EventMultiMap::iterator it = range.first; it != range.second; it++) {
@@ -250,20 +361,23 @@ void JSAPI::registerEventMethod(const std::string& name, JSObjectPtr &event)
         }
     }
     m_eventMap.insert(EventPair(name, event));
+    publishEventTables();
 }
 
 void JSAPI::unregisterEventMethod(const std::wstring& name, JSObjectPtr &event)
 {
-    unregisterEventMethod(wstring_to_utf8(name), event);
+    unregisterEventMethod(wstring_to_utf8_cached(name), event);
 }
 
 void JSAPI::unregisterEventMethod(const std::string& name, JSObjectPtr &event)
 {
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
     std::pair<EventMultiMap::iterator, EventMultiMap::iterator> range = m_eventMap.equal_range(name);
 
     for (EventMultiMap::iterator it = range.first; it != range.second; it++) {
         if (it->second->getEventId() == event->getEventId()) {
             m_eventMap.erase(it);
+            publishEventTables();
             return;
         }
     }
@@ -271,24 +385,29 @@ void JSAPI::unregisterEventMethod(const std::string& name, JSObjectPtr &event)
 
 void JSAPI::registerEventInterface(const JSObjectPtr& event)
 {
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
     m_evtIfaces[static_cast<void*>(event.get())] = event;
+    publishEventTables();
 }
 
 void JSAPI::unregisterEventInterface(const JSObjectPtr& event)
 {
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
     EventIFaceMap::iterator fnd = m_evtIfaces.find(static_cast<void*>(event.get()));
     m_evtIfaces.erase(fnd);
+    publishEventTables();
 }
 
 JSObjectPtr JSAPI::getDefaultEventMethod(const std::wstring& name) const
 {
-    return getDefaultEventMethod(wstring_to_utf8(name));
+    return getDefaultEventMethod(wstring_to_utf8_cached(name));
 }
 
 JSObjectPtr JSAPI::getDefaultEventMethod(const std::string& name) const
 {
-    EventSingleMap::const_iterator fnd = m_defEventMap.find(name);
-    if (fnd != m_defEventMap.end()) {
+    EventTablesPtr tables(getEventTables());
+    EventSingleMap::const_iterator fnd = tables->defEventMap.find(name);
+    if (fnd != tables->defEventMap.end()) {
         return fnd->second;
     }
     return JSObjectPtr();
@@ -296,26 +415,31 @@ JSObjectPtr JSAPI::getDefaultEventMethod(const std::string& name) const
 
 void JSAPI::setDefaultEventMethod(const std::wstring& name, FB::JSObjectPtr event)
 {
-    setDefaultEventMethod(wstring_to_utf8(name), event);
+    setDefaultEventMethod(wstring_to_utf8_cached(name), event);
 }
 
 void JSAPI::setDefaultEventMethod(const std::string& name, FB::JSObjectPtr event)
 {
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
     if(event == NULL)
         m_defEventMap.erase(name);
-    else 
+    else
         m_defEventMap[name] = event;
+    publishEventTables();
 }
 
 void JSAPI::registerEvent(const std::wstring &name)
 {
-    registerEvent(wstring_to_utf8(name));
+    registerEvent(wstring_to_utf8_cached(name));
 }
 
 void JSAPI::registerEvent(const std::string &name)
 {
-    if(m_defEventMap.find(name) == m_defEventMap.end())
+    boost::mutex::scoped_lock lock(m_eventTableMutex);
+    if(m_defEventMap.find(name) == m_defEventMap.end()) {
         m_defEventMap[name] = JSObjectPtr();
+        publishEventTables();
+    }
 }
 
 void JSAPI::getMemberNames(std::vector<std::wstring> &nameVector) const
@@ -325,39 +449,85 @@ void JSAPI::getMemberNames(std::vector<std::wstring> &nameVector) const
     getMemberNames(utf8Vector);
     for (std::vector<std::string>::const_iterator it = utf8Vector.begin();
             it != utf8Vector.end(); ++it) {
-        std::wstring wStrVal(utf8_to_wstring(*it));
+        std::wstring wStrVal(utf8_to_wstring_cached(*it));
         nameVector.push_back(wStrVal);
     }
 }
 
+FB::MemberNameListPtr JSAPI::getMemberNamesSnapshot() const
+{
+    // No memoization at this level; subclasses that know when their member set
+    // changes (JSAPIAuto) override this with a cached snapshot
+    boost::shared_ptr<std::vector<std::string> > names(boost::make_shared<std::vector<std::string> >());
+    getMemberNames(*names);
+    return names;
+}
+
 bool JSAPI::HasMethod(const std::wstring& methodName) const
 {
-    return HasMethod(wstring_to_utf8(methodName));
+    return HasMethod(wstring_to_utf8_cached(methodName));
 }
 
 bool FB::JSAPI::HasMethodObject( const std::wstring& methodObjName ) const
 {
-    return HasMethodObject(wstring_to_utf8(methodObjName));
+    return HasMethodObject(wstring_to_utf8_cached(methodObjName));
 }
 
 bool JSAPI::HasProperty(const std::wstring& propertyName) const
 {
-    return HasProperty(wstring_to_utf8(propertyName));
+    return HasProperty(wstring_to_utf8_cached(propertyName));
 }
 
 variant JSAPI::GetProperty(const std::wstring& propertyName)
 {
-    return GetProperty(wstring_to_utf8(propertyName));
+    return GetProperty(wstring_to_utf8_cached(propertyName));
 }
 
 void JSAPI::SetProperty(const std::wstring& propertyName, const variant& value)
 {
-    SetProperty(wstring_to_utf8(propertyName), value);
+    SetProperty(wstring_to_utf8_cached(propertyName), value);
 }
 
 variant JSAPI::Invoke(const std::wstring& methodName, const std::vector<variant>& args)
 {
-    return Invoke(wstring_to_utf8(methodName), args);
+    return Invoke(wstring_to_utf8_cached(methodName), args);
+}
+
+// Default batched accessors; subclasses holding a lock per member access may
+// override these to take it once for the whole batch
+FB::VariantMap JSAPI::GetProperties(const std::vector<std::string>& propertyNames)
+{
+    FB::VariantMap result;
+    for (std::vector<std::string>::const_iterator it = propertyNames.begin();
+            it != propertyNames.end(); ++it) {
+        result[*it] = GetProperty(*it);
+    }
+    return result;
+}
+
+void JSAPI::SetProperties(const FB::VariantMap& properties)
+{
+    for (FB::VariantMap::const_iterator it = properties.begin();
+            it != properties.end(); ++it) {
+        SetProperty(it->first, it->second);
+    }
+}
+
+// Default id-based dispatch; since the base getMemberId never resolves anything,
+// these only fire if a caller invents an id, which is a caller bug
+variant JSAPI::InvokeById(FB::MemberId id, const std::vector<variant>& args)
+{
+    throw invalid_member(boost::lexical_cast<std::string>(id));
+}
+
+variant JSAPI::GetPropertyById(FB::MemberId id)
+{
+    throw invalid_member(boost::lexical_cast<std::string>(id));
+}
+
+void JSAPI::SetPropertyById(FB::MemberId id, const variant& value)
+{
+    throw invalid_member(boost::lexical_cast<std::string>(id));
 }
 
 void FB::JSAPI::registerProxy( const JSAPIWeakPtr &ptr ) const
@@ -386,5 +556,5 @@ void FB::JSAPI::getMemberNames( std::vector<std::string> *nameVector ) const
 
 FB::JSAPIPtr FB::JSAPI::GetMethodObject( const std::wstring& methodObjName )
 {
-    return GetMethodObject(FB::wstring_to_utf8(methodObjName));
+    return GetMethodObject(FB::wstring_to_utf8_cached(methodObjName));
 }
@@ -95,6 +95,34 @@ namespace FB
 
     protected:
         void fireAsyncEvent( const std::string& eventName, const std::vector<variant>& args );
+        // Handler snapshot built by fireAsyncEvent; each entry is the method name to
+        // invoke (empty for plain handlers) and the handler object
+        typedef std::vector<EventPair> EventBatch;
+        void invokeEventHandlers( const EventBatch& handlers, const std::vector<variant>& args );
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @struct EventDispatchRecord
+        ///
+        /// @brief  Reusable per-fire dispatch state; pooled so the steady state allocates nothing
+        ///
+        /// Event firing is the highest-frequency operation in the framework, and building the
+        /// handler snapshot plus the argument copy fresh each time costs several allocations per
+        /// fire.  Records released back to the pool keep their vector capacity, so after the first
+        /// few fires the common case (small args, a handful of listeners) fills storage that
+        /// already exists.  The pool is per-API and bounded; overflow records are simply dropped.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        struct EventDispatchRecord {
+            EventBatch batch;
+            std::vector<variant> args;
+        };
+        typedef boost::shared_ptr<EventDispatchRecord> EventDispatchRecordPtr;
+        /// Returns a pooled record (or a fresh one if the pool is empty)
+        EventDispatchRecordPtr acquireEventDispatchRecord();
+        /// Clears the record -- capacity is kept -- and returns it to the pool
+        void releaseEventDispatchRecord(const EventDispatchRecordPtr& record);
+        /// Main-thread half of fireAsyncEvent; runs the record's handlers, then releases it
+        void invokeEventRecord(const EventDispatchRecordPtr& record);
 
     protected:
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -177,12 +205,13 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn public  void FB::JSAPI::pushZone(const SecurityZone& securityLevel)
         ///
-        /// @brief  Pushes a new security level and locks a mutex (for every Push there *must* be a Pop!)
+        /// @brief  Pushes a new security level for the calling thread (for every Push there *must* be a Pop!)
         ///
-        /// This should be used to temporarily set the security zone of the API object. Note that this
-        /// also locks a mutex to ensure that access to members under a non-default security level is
-        /// serialized. Do not *ever* leave an unmatched push (a push with no pop after it). For safety,
-        /// use the helper FB::scoped_zonelock:
+        /// This should be used to temporarily set the security zone of the API object. The active
+        /// zone lives on a thread-local stack, so pushing a zone is lock-free and only affects the
+        /// calling thread; other threads keep seeing the default zone. Do not *ever* leave an
+        /// unmatched push (a push with no pop after it). For safety, use the helper
+        /// FB::scoped_zonelock:
         /// @code
         ///      // In the constructor
         ///      // Register protected members
@@ -205,7 +234,7 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn public  void FB::JSAPI::popZone()
         ///
-        /// @brief  Pops off a security level and unlocks the mutex (for every Push there *must* be a Pop!)
+        /// @brief  Pops the calling thread's security level (for every Push there *must* be a Pop!)
         ///
         /// Seriously, it's far better to use FB::scoped_zonelock instead of using popZone and pushZone
         ///
@@ -370,6 +399,22 @@ namespace FB
         virtual void getMemberNames(std::vector<std::string> &nameVector) const = 0;
         virtual void getMemberNames(std::vector<std::string> *nameVector) const;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual MemberNameListPtr getMemberNamesSnapshot() const
+        ///
+        /// @brief  Returns an immutable, shared list of member names for enumeration
+        ///
+        /// Browsers enumerate plugin objects far more often than members change; implementations that
+        /// can (JSAPIAuto does) return the same shared list until a member is added or removed, so
+        /// repeat enumerations cost a shared_ptr copy instead of a walk over the member maps.  The
+        /// default implementation just builds a fresh list with getMemberNames.
+        ///
+        /// @return shared pointer to a list of member names; never modified after it is returned
+        /// @since 1.5
+        /// @see getMemberNames
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual MemberNameListPtr getMemberNamesSnapshot() const;
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual size_t getMemberCount() const = 0
         ///
@@ -558,42 +603,200 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual variant Invoke(const std::string& methodName, const std::vector<variant>& args) = 0;
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual FB::MemberId getMemberId(const std::string& name)
+        ///
+        /// @brief  Resolves a member name to a stable integer id for name-free dispatch
+        ///
+        /// Both browsers hand the plugin a stable identifier for each member (NPIdentifier, DISPID),
+        /// so the browser glue can resolve the FireBreath member once and then call InvokeById /
+        /// GetPropertyById / SetPropertyById without re-looking the name up on every call.  The id
+        /// stays valid for the life of the JSAPI object.  The default implementation returns
+        /// FB::InvalidMemberId, meaning the object does not support id dispatch and callers must
+        /// stay on the name-based path.
+        ///
+        /// @param  name    Name of the member to resolve
+        /// @return the member id, or FB::InvalidMemberId if the member is unknown
+        /// @since 1.5
+        /// @see InvokeById
+        /// @see GetPropertyById
+        /// @see SetPropertyById
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual FB::MemberId getMemberId(const std::string& name) { return FB::InvalidMemberId; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual FB::VariantMap GetProperties(const std::vector<std::string>& propertyNames)
+        ///
+        /// @brief  Gets several property values in one call
+        ///
+        /// Each property read from javascript is a separate browser-to-plugin transition; when a
+        /// page polls a dozen properties per frame the fixed cost of those crossings dominates.
+        /// This batches the reads so one crossing covers them all.  JSAPIAuto exposes it to
+        /// javascript as the "getProperties" method.
+        ///
+        /// @param  propertyNames   Names of the properties to read
+        /// @return map of property name to value
+        /// @since 1.5
+        /// @see SetProperties
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual FB::VariantMap GetProperties(const std::vector<std::string>& propertyNames);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual void SetProperties(const FB::VariantMap& properties)
+        ///
+        /// @brief  Sets several property values in one call; the batched counterpart of SetProperty.
+        ///         JSAPIAuto exposes it to javascript as the "setProperties" method.
+        ///
+        /// @param  properties  map of property name to new value
+        /// @since 1.5
+        /// @see GetProperties
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual void SetProperties(const FB::VariantMap& properties);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual variant InvokeById(FB::MemberId id, const std::vector<variant>& args)
+        ///
+        /// @brief  Invokes the method previously resolved with getMemberId
+        ///
+        /// @param  id      Member id returned by getMemberId
+        /// @param  args    The arguments
+        /// @return result of method call
+        /// @since 1.5
+        /// @see getMemberId
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual variant InvokeById(FB::MemberId id, const std::vector<variant>& args);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual variant GetPropertyById(FB::MemberId id)
+        ///
+        /// @brief  Gets the value of the property previously resolved with getMemberId
+        ///
+        /// @param  id  Member id returned by getMemberId
+        /// @return The property value
+        /// @since 1.5
+        /// @see getMemberId
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual variant GetPropertyById(FB::MemberId id);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual void SetPropertyById(FB::MemberId id, const variant& value)
+        ///
+        /// @brief  Sets the value of the property previously resolved with getMemberId
+        ///
+        /// @param  id      Member id returned by getMemberId
+        /// @param  value   The new property value
+        /// @since 1.5
+        /// @see getMemberId
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual void SetPropertyById(FB::MemberId id, const variant& value);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual bool isPropertyCacheable(const std::string& propertyName) const
+        ///
+        /// @brief  True if repeat reads of the property may be served from a browser-side cache
+        ///
+        /// Properties that are effectively constant per page (version, capabilities) can be
+        /// declared cacheable at registration; the browser glue then keeps the last value and
+        /// serves repeat reads without dispatching into the JSAPI object.  A cached value stays
+        /// valid until the property is written or getPropertyCacheGeneration changes.  The
+        /// default says nothing is cacheable.
+        ///
+        /// @param  propertyName    Name of the property
+        /// @return true if the glue may cache reads of this property
+        /// @since 1.5
+        /// @see getPropertyCacheGeneration
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual bool isPropertyCacheable(const std::string& propertyName) const { return false; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual unsigned int getPropertyCacheGeneration() const
+        ///
+        /// @brief  Generation stamp for cacheable property values; bumping it (see
+        ///         JSAPIAuto::invalidateCachedProperties) drops every cached value at once
+        ///
+        /// @return current generation
+        /// @since 1.5
+        /// @see isPropertyCacheable
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual unsigned int getPropertyCacheGeneration() const { return 0; }
+
     public:
         virtual void registerProxy(const JSAPIWeakPtr &ptr) const;
         virtual void unregisterProxy( const FB::JSAPIPtr& ptr ) const;
 
     protected:
-        typedef std::deque<SecurityZone> ZoneStack;
         // Stores event handlers
-        EventMultiMap m_eventMap;       
+        EventMultiMap m_eventMap;
         // Stores event-as-property event handlers
-        EventSingleMap m_defEventMap;   
+        EventSingleMap m_defEventMap;
         // Stores event interfaces
-        EventIFaceMap m_evtIfaces;      
+        EventIFaceMap m_evtIfaces;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @struct EventTables
+        ///
+        /// @brief  Immutable snapshot of the three event tables above
+        ///
+        /// Event registration is rare and event dispatch is hot, so the tables use copy-on-write:
+        /// writers mutate the master maps under m_eventTableMutex and publish a fresh snapshot;
+        /// readers (fireAsyncEvent batch building, HasEvent, getDefaultEventMethod) copy the
+        /// shared_ptr under that mutex -- held only for the pointer copy -- and then walk the
+        /// tables with no lock at all.  Concurrent fires from worker threads therefore proceed
+        /// in parallel and never contend with member dispatch on m_zoneMutex.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        struct EventTables {
+            EventMultiMap eventMap;
+            EventSingleMap defEventMap;
+            EventIFaceMap evtIfaces;
+        };
+        typedef boost::shared_ptr<const EventTables> EventTablesPtr;
+
+        /// Returns the current event-table snapshot (never NULL); lock-free to iterate
+        /// @since 1.5
+        EventTablesPtr getEventTables() const;
+        /// Rebuilds the snapshot from the master maps; call with m_eventTableMutex held
+        /// @since 1.5
+        void publishEventTables();
 
         typedef std::vector<JSAPIWeakPtr> ProxyList;
         mutable ProxyList m_proxies;
 
+        // Free dispatch records, reused across fires; guarded by m_eventTableMutex
+        std::vector<EventDispatchRecordPtr> m_dispatchRecordPool;
+
+        // Guards the master event maps, the published snapshot pointer, and the
+        // dispatch-record pool.  Never held while running user code, so a plain
+        // (non-recursive) mutex suffices and hold times are a few pointer ops
+        mutable boost::mutex m_eventTableMutex;
+        mutable EventTablesPtr m_eventTables;
+
+        // Guards the shared member state of subclasses (JSAPIAuto's member
+        // tables and the like).  The active zone itself is thread-local and no
+        // longer touches this mutex; the name is kept for the subclasses that
+        // already lock it
         mutable boost::recursive_mutex m_zoneMutex;
-        ZoneStack m_zoneStack;
-                
+        // The zone this object operates in when the calling thread has no
+        // pushed zone of its own
+        SecurityZone m_defaultZone;
+
         bool m_valid;                   // Tracks if this object has been invalidated
     };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class scoped_zonelock
-    ///
-    /// @brief  Provides a helper class for locking
+    /// @class scoped_zonelock
+    ///
+    /// @brief  Provides a helper class for locking
     ///
     /// This class will call pushZone on the provided JSAPI object when instantiated and popZone
     /// when it goes out of scope. 
     /// @code
     ///      // In the constructor
-    ///      // Register protected members
-    ///      {
+    ///      // Register protected members
+    ///      {
     ///          FB::scoped_zonelock _l(this, SecurityScope_Protected);
     ///          registerMethod("start", make_method(this, &MyPluginAPI::start));
-    ///      } // Zone automatically popped off
+    ///      } // Zone automatically popped off
     ///      // Register private members
     ///      {
     ///          FB::scoped_zonelock _l(this, SecurityScope_Protected);
@@ -603,11 +806,11 @@ namespace FB
     /// 
     /// @since 1.4a3
     /// @see FB::JSAPI::pushZone
-    /// @see FB::JSAPI::popZone
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @see FB::JSAPI::popZone
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
     class scoped_zonelock : boost::noncopyable
     {
-    public:
+    public:
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn public FB::scoped_zonelock::scoped_zonelock(const JSAPIPtr &api, const SecurityZone& zone)
         ///
@@ -618,10 +821,10 @@ namespace FB
         /// @param  zone    const SecurityZone& Zone to push
         /// @since 1.4a3
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        scoped_zonelock(const JSAPIPtr &api, const SecurityZone& zone)
-            : m_api(api.get()), ref(api) {
-            lock(zone);
-        }
+        scoped_zonelock(const JSAPIPtr &api, const SecurityZone& zone)
+            : m_api(api.get()), ref(api) {
+            lock(zone);
+        }
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn public   FB::scoped_zonelock::scoped_zonelock(JSAPI* api, const SecurityZone& zone)
         ///
@@ -631,26 +834,26 @@ namespace FB
         /// @param  zone    const SecurityZone& Zone to push
         /// @since 1.4a3
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        scoped_zonelock(JSAPI* api, const SecurityZone& zone) : m_api(api) {
-            lock(zone);
-        }
+        scoped_zonelock(JSAPI* api, const SecurityZone& zone) : m_api(api) {
+            lock(zone);
+        }
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn public   FB::scoped_zonelock::~scoped_zonelock()
         ///
         /// @brief   Unlocks/pops the zone
         /// @since 1.4a3
         ////////////////////////////////////////////////////////////////////////////////////////////////////
-        ~scoped_zonelock() {
-            if (m_api)
-                m_api->popZone();
-        }
-    private:
-        void lock(const SecurityZone& zone) const {
-            if (m_api)
-                m_api->pushZone(zone);
-        }
-        JSAPI* m_api;
-        const FB::JSAPIPtr ref;
+        ~scoped_zonelock() {
+            if (m_api)
+                m_api->popZone();
+        }
+    private:
+        void lock(const SecurityZone& zone) const {
+            if (m_api)
+                m_api->pushZone(zone);
+        }
+        JSAPI* m_api;
+        const FB::JSAPIPtr ref;
     };
 };
 
@@ -18,11 +18,58 @@ Copyright 2009 Georg Fritzsche, Firebreath development team
 #include "boost/make_shared.hpp"
 #include "JSFunction.h"
 #include <cassert>
+#ifndef FB_NO_JSAPI_PROFILER
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace
+{
+    // Rough marshaling weight of one value: payload size for strings, pointer/number
+    // size for everything else.  It only needs to be proportionate, not exact.
+    size_t variantBytes(const FB::variant& v)
+    {
+        if (v.get_type() == typeid(std::string))
+            return v.cast<std::string>().size();
+        else if (v.get_type() == typeid(std::wstring))
+            return v.cast<std::wstring>().size() * sizeof(wchar_t);
+        return sizeof(double);
+    }
+
+    // Times one dispatch and records it on destruction, so throwing members are
+    // accounted too.  Holds a reference to the owner's scoped_ptr rather than the
+    // raw profiler: if the member being invoked is enableMemberProfiling itself,
+    // the profiler can be destroyed mid-call and the dtor must notice.
+    struct ProfileScope
+    {
+        ProfileScope(const boost::scoped_ptr<FB::MemberProfiler>& prof,
+                     const std::string& member, size_t bytes)
+            : m_prof(prof), m_member(member), m_bytes(bytes)
+        {
+            if (m_prof)
+                m_start = boost::posix_time::microsec_clock::universal_time();
+        }
+        ~ProfileScope()
+        {
+            if (m_prof) {
+                boost::posix_time::time_duration d =
+                    boost::posix_time::microsec_clock::universal_time() - m_start;
+                m_prof->record(m_member, static_cast<long>(d.total_microseconds()), m_bytes);
+            }
+        }
+        const boost::scoped_ptr<FB::MemberProfiler>& m_prof;
+        const std::string& m_member;
+        size_t m_bytes;
+        boost::posix_time::ptime m_start;
+    };
+}
+#endif
 
 FB::JSAPIAuto::JSAPIAuto(const std::string& description)
   : FB::JSAPI(SecurityScope_Public),
+    m_staticMembers(NULL),
+    m_directoryGeneration(0),
+    m_propertyCacheGeneration(1),
     m_description(description),
-    m_allowDynamicAttributes(true), 
+    m_allowDynamicAttributes(true),
     m_allowMethodObjects(true)
 {
     init();
@@ -30,8 +77,11 @@ FB::JSAPIAuto::JSAPIAuto(const std::string& description)
 
 FB::JSAPIAuto::JSAPIAuto( const SecurityZone& securityLevel, const std::string& description /*= "<JSAPI-Auto Secure Javascript Object>"*/ )
   : FB::JSAPI(securityLevel),
+    m_staticMembers(NULL),
+    m_directoryGeneration(0),
+    m_propertyCacheGeneration(1),
     m_description(description),
-    m_allowDynamicAttributes(true), 
+    m_allowDynamicAttributes(true),
     m_allowMethodObjects(true)
 {
     init();
@@ -44,6 +94,12 @@ void FB::JSAPIAuto::init( )
         registerMethod("toString",  make_method(this, &JSAPIAuto::ToString));
         registerMethod("getAttribute",  make_method(this, &JSAPIAuto::getAttribute));
         registerMethod("setAttribute",  make_method(this, &JSAPIAuto::setAttribute));
+        registerMethod("getProperties", make_method(this, &JSAPIAuto::GetProperties));
+        registerMethod("setProperties", make_method(this, &JSAPIAuto::SetProperties));
+#ifndef FB_NO_JSAPI_PROFILER
+        registerMethod("enableMemberProfiling", make_method(this, &JSAPIAuto::enableMemberProfiling));
+        registerMethod("getMemberProfile", make_method(this, &JSAPIAuto::getMemberProfile));
+#endif
 
         registerProperty("value", make_property(this, &JSAPIAuto::ToString));
         registerProperty("valid", make_property(this, &JSAPIAuto::get_valid));
@@ -82,79 +138,207 @@ bool FB::JSAPIAuto::get_valid()
 
 void FB::JSAPIAuto::registerMethod(const std::wstring& name, const CallMethodFunctor& func)
 {
-    registerMethod(FB::wstring_to_utf8(name), func);
+    registerMethod(FB::wstring_to_utf8_cached(name), func);
+}
+
+FB::JSAPIAuto::MemberDirectoryPtr FB::JSAPIAuto::getMemberDirectory() const
+{
+    unsigned int gen;
+    {
+        boost::mutex::scoped_lock lock(m_directoryMutex);
+        if (m_memberDirectory)
+            return m_memberDirectory;
+        gen = m_directoryGeneration;
+    }
+
+    boost::shared_ptr<MemberDirectory> dir(boost::make_shared<MemberDirectory>());
+    {
+        boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+        for (MethodFunctorMap::const_iterator it = m_methodFunctorMap.begin();
+            it != m_methodFunctorMap.end(); ++it) {
+            MemberDirectory::Entry& entry = dir->members[it->first];
+            entry.isMethod = true;
+            entry.methodZone = it->second.zone;
+        }
+        for (PropertyFunctorsMap::const_iterator it = m_propertyFunctorsMap.begin();
+            it != m_propertyFunctorsMap.end(); ++it) {
+            MemberDirectory::Entry& entry = dir->members[it->first];
+            entry.isProperty = true;
+            entry.propertyZone = it->second.zone;
+        }
+        for (std::set<std::string>::const_iterator it = m_cacheableProperties.begin();
+            it != m_cacheableProperties.end(); ++it) {
+            dir->members[*it].cacheable = true;
+        }
+    }
+
+    boost::mutex::scoped_lock lock(m_directoryMutex);
+    // Only publish if no registration invalidated the directory while we were
+    // building; the copy we built is still a valid snapshot for this caller
+    if (gen == m_directoryGeneration)
+        m_memberDirectory = dir;
+    return dir;
+}
+
+void FB::JSAPIAuto::invalidateMemberDirectory()
+{
+    boost::mutex::scoped_lock lock(m_directoryMutex);
+    m_memberDirectory.reset();
+    ++m_directoryGeneration;
 }
 
 void FB::JSAPIAuto::registerMethod(const std::string& name, const CallMethodFunctor& func)
 {
     boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
-    m_methodFunctorMap[name] = func;
+    // the zone is stamped into the record so dispatch never needs a second map lookup
+    m_methodFunctorMap[name] = MethodFunctors(getZone(), func);
     m_zoneMap[name] = getZone();
+    m_memberNamesCache.clear();
+    invalidateMemberDirectory();
 }
 
 void FB::JSAPIAuto::registerProperty(const std::wstring& name, const PropertyFunctors& func)
 {
-    registerProperty(FB::wstring_to_utf8(name), func);
+    registerProperty(FB::wstring_to_utf8_cached(name), func);
 }
 
 void FB::JSAPIAuto::registerProperty(const std::string& name, const PropertyFunctors& propFuncs)
 {
     boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
-    m_propertyFunctorsMap[name] = propFuncs;
+    PropertyFunctors funcs(propFuncs);
+    funcs.zone = getZone();
+    m_propertyFunctorsMap[name] = funcs;
     m_zoneMap[name] = getZone();
+    m_memberNamesCache.clear();
+    invalidateMemberDirectory();
+}
+
+void FB::JSAPIAuto::registerProperty(const std::string& name, const PropertyFunctors& propFuncs, bool cacheable)
+{
+    registerProperty(name, propFuncs);
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if (cacheable)
+        m_cacheableProperties.insert(name);
+    else
+        m_cacheableProperties.erase(name);
+    invalidateMemberDirectory();
+}
+
+bool FB::JSAPIAuto::isPropertyCacheable(const std::string& propertyName) const
+{
+    MemberDirectoryPtr dir(getMemberDirectory());
+    MemberDirectory::Map::const_iterator fnd = dir->members.find(propertyName);
+    return fnd != dir->members.end() && fnd->second.cacheable;
 }
 
 void FB::JSAPIAuto::getMemberNames(std::vector<std::string> &nameVector) const
+{
+    FB::MemberNameListPtr snapshot(getMemberNamesSnapshot());
+    nameVector.assign(snapshot->begin(), snapshot->end());
+}
+
+FB::MemberNameListPtr FB::JSAPIAuto::getMemberNamesSnapshot() const
 {
     boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
-    nameVector.clear();
+    const SecurityZone zone(getZone());
+    MemberNamesCache::const_iterator fnd = m_memberNamesCache.find(zone);
+    if (fnd != m_memberNamesCache.end())
+        return fnd->second;
+
+    boost::shared_ptr<std::vector<std::string> > names(boost::make_shared<std::vector<std::string> >());
+    std::vector<std::string>& nameVector(*names);
     for (ZoneMap::const_iterator it = m_zoneMap.begin(); it != m_zoneMap.end(); ++it) {
-        if (getZone() >= it->second)
+        if (zone >= it->second)
             nameVector.push_back(it->first);
     }
+    if (m_staticMembers) {
+        // static members not shadowed by a per-instance registration
+        const StaticMemberTable::MethodMap& methods(m_staticMembers->methods());
+        for (StaticMemberTable::MethodMap::const_iterator it = methods.begin(); it != methods.end(); ++it) {
+            if (m_zoneMap.find(it->first) == m_zoneMap.end() && zone >= it->second.zone)
+                nameVector.push_back(it->first);
+        }
+        const StaticMemberTable::PropertyMap& props(m_staticMembers->properties());
+        for (StaticMemberTable::PropertyMap::const_iterator it = props.begin(); it != props.end(); ++it) {
+            if (m_zoneMap.find(it->first) == m_zoneMap.end() && !m_staticMembers->findMethod(it->first)
+                && zone >= it->second.zone)
+                nameVector.push_back(it->first);
+        }
+    }
+    m_memberNamesCache[zone] = names;
+    return names;
 }
 
 size_t FB::JSAPIAuto::getMemberCount() const
 {
     boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    const SecurityZone zone(getZone());
     size_t count = 0;
     for (ZoneMap::const_iterator it = m_zoneMap.begin(); it != m_zoneMap.end(); ++it) {
-        if (getZone() >= it->second)
+        if (zone >= it->second)
             ++count;
     }
+    if (m_staticMembers) {
+        const StaticMemberTable::MethodMap& methods(m_staticMembers->methods());
+        for (StaticMemberTable::MethodMap::const_iterator it = methods.begin(); it != methods.end(); ++it) {
+            if (m_zoneMap.find(it->first) == m_zoneMap.end() && zone >= it->second.zone)
+                ++count;
+        }
+        const StaticMemberTable::PropertyMap& props(m_staticMembers->properties());
+        for (StaticMemberTable::PropertyMap::const_iterator it = props.begin(); it != props.end(); ++it) {
+            if (m_zoneMap.find(it->first) == m_zoneMap.end() && !m_staticMembers->findMethod(it->first)
+                && zone >= it->second.zone)
+                ++count;
+        }
+    }
     return count;
 }
 
 bool FB::JSAPIAuto::HasMethod(const std::string& methodName) const
 {
-    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    // Lock-free: the directory snapshot is immutable, the static member table
+    // never changes after construction, and memberAccessible reads only the
+    // thread-local zone stack
     if(!m_valid)
         return false;
-    
-    return (m_methodFunctorMap.find(methodName) != m_methodFunctorMap.end()) && memberAccessible(m_zoneMap.find(methodName));
+
+    MemberDirectoryPtr dir(getMemberDirectory());
+    MemberDirectory::Map::const_iterator it = dir->members.find(methodName);
+    if (it != dir->members.end() && it->second.isMethod)
+        return memberAccessible(it->second.methodZone);
+    if (m_staticMembers) {
+        const StaticMemberTable::Method* method = m_staticMembers->findMethod(methodName);
+        return method && memberAccessible(method->zone);
+    }
+    return false;
 }
 
 bool FB::JSAPIAuto::HasMethodObject( const std::string& methodObjName ) const
 {
-    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
-    
     return m_allowMethodObjects && HasMethod(methodObjName);
 }
 
 bool FB::JSAPIAuto::HasProperty(const std::string& propertyName) const
 {
-    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
     if(!m_valid)
         return false;
 
     // To be able to set dynamic properties, we have to respond true always
-    if (m_allowDynamicAttributes && !HasMethod(propertyName) && !isReserved(propertyName))
+    const bool hasMethod = HasMethod(propertyName);
+    if (m_allowDynamicAttributes && !hasMethod && !isReserved(propertyName))
         return true;
-    else if (m_allowMethodObjects && HasMethod(propertyName) && memberAccessible(m_zoneMap.find(propertyName)))
+    else if (m_allowMethodObjects && hasMethod)
         return true;
 
-    return m_propertyFunctorsMap.find(propertyName) != m_propertyFunctorsMap.end()
-        || m_attributes.find(propertyName) != m_attributes.end();
+    MemberDirectoryPtr dir(getMemberDirectory());
+    MemberDirectory::Map::const_iterator it = dir->members.find(propertyName);
+    if ((it != dir->members.end() && it->second.isProperty)
+        || (m_staticMembers && m_staticMembers->findProperty(propertyName)))
+        return true;
+
+    // Attributes mutate at runtime, so this last resort still takes the lock
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    return m_attributes.find(propertyName) != m_attributes.end();
 }
 
 bool FB::JSAPIAuto::HasProperty(int idx) const
@@ -176,16 +360,21 @@ FB::variant FB::JSAPIAuto::GetProperty(const std::string& propertyName)
     if(!m_valid)
         throw object_invalidated();
 
-    ZoneMap::const_iterator zoneName = m_zoneMap.find(propertyName);
+#ifndef FB_NO_JSAPI_PROFILER
+    ProfileScope _prof(m_profiler, propertyName, 0);
+#endif
     PropertyFunctorsMap::const_iterator it = m_propertyFunctorsMap.find(propertyName);
-    if(it != m_propertyFunctorsMap.end() && memberAccessible(zoneName)) {
+    const StaticMemberTable::Property* staticProp =
+        (it == m_propertyFunctorsMap.end() && m_staticMembers) ? m_staticMembers->findProperty(propertyName) : NULL;
+    if(it != m_propertyFunctorsMap.end() && memberAccessible(it->second.zone)) {
         return it->second.get();
-    } else if (memberAccessible(zoneName)) {
-        if (HasMethodObject(propertyName))
-            return GetMethodObject(propertyName);
-
+    } else if (staticProp && memberAccessible(staticProp->zone)) {
+        return staticProp->get(this);
+    } else if (HasMethodObject(propertyName)) {
+        return GetMethodObject(propertyName);
+    } else {
         AttributeMap::iterator fnd = m_attributes.find(propertyName);
-        if (fnd != m_attributes.end())
+        if (fnd != m_attributes.end() && memberAccessible(fnd->second.zone))
             return fnd->second.value;
         else if (m_allowDynamicAttributes) {
             return FB::FBVoid(); // If we allow dynamic attributes then we need to
@@ -194,12 +383,6 @@ FB::variant FB::JSAPIAuto::GetProperty(const std::string& propertyName)
         } else {
             throw invalid_member(propertyName);
         }
-    } else {
-        if (m_allowDynamicAttributes) {
-            return FB::FBVoid();
-        } else {
-            throw invalid_member(propertyName);
-        }
     }
 }
 
@@ -209,11 +392,16 @@ void FB::JSAPIAuto::SetProperty(const std::string& propertyName, const variant&
     if(!m_valid)
         throw object_invalidated();
 
+#ifndef FB_NO_JSAPI_PROFILER
+    ProfileScope _prof(m_profiler, propertyName, m_profiler ? variantBytes(value) : 0);
+#endif
     PropertyFunctorsMap::iterator it = m_propertyFunctorsMap.find(propertyName);
+    const StaticMemberTable::Property* staticProp =
+        (it == m_propertyFunctorsMap.end() && m_staticMembers) ? m_staticMembers->findProperty(propertyName) : NULL;
     // Note that if an explicit property exists but is not accessible in the current security context,
     // we throw an exception.
     if(it != m_propertyFunctorsMap.end()) {
-        if (memberAccessible(m_zoneMap.find(propertyName))) {
+        if (memberAccessible(it->second.zone)) {
             try {
                 it->second.set(value);
             } catch (const FB::bad_variant_cast& ex) {
@@ -226,11 +414,29 @@ void FB::JSAPIAuto::SetProperty(const std::string& propertyName, const variant&
         } else {
             throw invalid_member(propertyName);
         }
+    } else if (staticProp) {
+        if (memberAccessible(staticProp->zone)) {
+            try {
+                staticProp->set(this, value);
+            } catch (const FB::bad_variant_cast& ex) {
+                std::string errorMsg("Could not convert from ");
+                errorMsg += ex.from;
+                errorMsg += " to ";
+                errorMsg += ex.to;
+                throw FB::invalid_arguments(errorMsg);
+            }
+        } else {
+            throw invalid_member(propertyName);
+        }
     } else if (m_allowDynamicAttributes || (m_attributes.find(propertyName) != m_attributes.end() && !m_attributes[propertyName].readonly)) {
         registerAttribute(propertyName, value);
     } else {
         throw invalid_member(propertyName);
     }
+    // a write through the scripting API is one of the two things allowed to
+    // change a cacheable property; drop any browser-side cached values
+    if (!m_cacheableProperties.empty() && m_cacheableProperties.count(propertyName))
+        ++m_propertyCacheGeneration;
 }
 
 FB::variant FB::JSAPIAuto::GetProperty(int idx)
@@ -241,7 +447,7 @@ FB::variant FB::JSAPIAuto::GetProperty(int idx)
 
     std::string id = boost::lexical_cast<std::string>(idx);
     AttributeMap::iterator fnd = m_attributes.find(id);
-    if (fnd != m_attributes.end() && memberAccessible(m_zoneMap.find(id)))
+    if (fnd != m_attributes.end() && memberAccessible(fnd->second.zone))
         return fnd->second.value;
     else if (m_allowDynamicAttributes) {
         return FB::FBVoid(); // If we allow dynamic attributes then we need to
@@ -277,12 +483,20 @@ FB::variant FB::JSAPIAuto::Invoke(const std::string& methodName, const std::vect
     if(!m_valid)
         throw object_invalidated();
 
-    if (memberAccessible(m_zoneMap.find(methodName))) {
+#ifndef FB_NO_JSAPI_PROFILER
+    size_t argBytes = 0;
+    if (m_profiler) {
+        for (std::vector<variant>::const_iterator ai = args.begin(); ai != args.end(); ++ai)
+            argBytes += variantBytes(*ai);
+    }
+    ProfileScope _prof(m_profiler, methodName, argBytes);
+#endif
+    // single hashed lookup; the zone stored in the record covers the accessibility check
+    MethodFunctorMap::iterator it = m_methodFunctorMap.find(methodName);
+    if(it != m_methodFunctorMap.end()) {
+        if (!memberAccessible(it->second.zone))
+            throw invalid_member(methodName);
         try {
-            MethodFunctorMap::iterator it = m_methodFunctorMap.find(methodName);
-            if(it == m_methodFunctorMap.end())
-                throw invalid_member(methodName);
-
             return it->second.call(args);
         } catch (const FB::bad_variant_cast& ex) {
             std::string errorMsg("Could not convert from ");
@@ -291,9 +505,155 @@ FB::variant FB::JSAPIAuto::Invoke(const std::string& methodName, const std::vect
             errorMsg += ex.to;
             throw FB::invalid_arguments(errorMsg);
         }
-    } else {
-        throw invalid_member(methodName);
     }
+    if (m_staticMembers) {
+        const StaticMemberTable::Method* method = m_staticMembers->findMethod(methodName);
+        if (method && memberAccessible(method->zone)) {
+            try {
+                return method->call(this, args);
+            } catch (const FB::bad_variant_cast& ex) {
+                std::string errorMsg("Could not convert from ");
+                errorMsg += ex.from;
+                errorMsg += " to ";
+                errorMsg += ex.to;
+                throw FB::invalid_arguments(errorMsg);
+            }
+        }
+    }
+    throw invalid_member(methodName);
+}
+
+FB::VariantMap FB::JSAPIAuto::GetProperties(const std::vector<std::string>& propertyNames)
+{
+    // take the lock once for the whole batch; the per-property calls just re-enter it
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if(!m_valid)
+        throw object_invalidated();
+
+    FB::VariantMap result;
+    for (std::vector<std::string>::const_iterator it = propertyNames.begin();
+            it != propertyNames.end(); ++it) {
+        result[*it] = GetProperty(*it);
+    }
+    return result;
+}
+
+void FB::JSAPIAuto::SetProperties(const FB::VariantMap& properties)
+{
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if(!m_valid)
+        throw object_invalidated();
+
+    for (FB::VariantMap::const_iterator it = properties.begin();
+            it != properties.end(); ++it) {
+        SetProperty(it->first, it->second);
+    }
+}
+
+FB::MemberId FB::JSAPIAuto::getMemberId(const std::string& name)
+{
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if(!m_valid)
+        return FB::InvalidMemberId;
+
+    MemberIdMap::const_iterator fnd = m_memberIds.find(name);
+    if (fnd != m_memberIds.end())
+        return fnd->second;
+
+    MethodFunctorMap::iterator method = m_methodFunctorMap.find(name);
+    PropertyFunctorsMap::iterator prop = m_propertyFunctorsMap.find(name);
+    const StaticMemberTable::Method* staticMethod =
+        m_staticMembers ? m_staticMembers->findMethod(name) : NULL;
+    const StaticMemberTable::Property* staticProp =
+        m_staticMembers ? m_staticMembers->findProperty(name) : NULL;
+    // Misses are not cached; the member may yet be registered, in which case a
+    // later getMemberId call should find it
+    if (method == m_methodFunctorMap.end() && prop == m_propertyFunctorsMap.end()
+        && !staticMethod && !staticProp)
+        return FB::InvalidMemberId;
+
+    MemberSlot slot;
+    slot.name = name;
+    slot.method = (method != m_methodFunctorMap.end()) ? &method->second : NULL;
+    slot.property = (prop != m_propertyFunctorsMap.end()) ? &prop->second : NULL;
+    slot.staticMethod = slot.method ? NULL : staticMethod;
+    slot.staticProperty = slot.property ? NULL : staticProp;
+    m_memberSlots.push_back(slot);
+    FB::MemberId id = m_memberSlots.size() - 1;
+    m_memberIds[name] = id;
+    return id;
+}
+
+FB::variant FB::JSAPIAuto::InvokeById(FB::MemberId id, const std::vector<variant>& args)
+{
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if(!m_valid)
+        throw object_invalidated();
+    if (id >= m_memberSlots.size())
+        throw invalid_member(boost::lexical_cast<std::string>(id));
+
+    const MemberSlot& slot = m_memberSlots[id];
+    try {
+        if (slot.method && memberAccessible(slot.method->zone))
+            return slot.method->call(args);
+        if (slot.staticMethod && memberAccessible(slot.staticMethod->zone))
+            return slot.staticMethod->call(this, args);
+    } catch (const FB::bad_variant_cast& ex) {
+        std::string errorMsg("Could not convert from ");
+        errorMsg += ex.from;
+        errorMsg += " to ";
+        errorMsg += ex.to;
+        throw FB::invalid_arguments(errorMsg);
+    }
+    // a method may have been registered for this name after the slot was built
+    return Invoke(slot.name, args);
+}
+
+FB::variant FB::JSAPIAuto::GetPropertyById(FB::MemberId id)
+{
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if(!m_valid)
+        throw object_invalidated();
+    if (id >= m_memberSlots.size())
+        throw invalid_member(boost::lexical_cast<std::string>(id));
+
+    const MemberSlot& slot = m_memberSlots[id];
+    if (slot.property && memberAccessible(slot.property->zone))
+        return slot.property->get();
+    if (slot.staticProperty && memberAccessible(slot.staticProperty->zone))
+        return slot.staticProperty->get(this);
+    // method objects, attributes and dynamic properties go through the name path
+    return GetProperty(slot.name);
+}
+
+void FB::JSAPIAuto::SetPropertyById(FB::MemberId id, const variant& value)
+{
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if(!m_valid)
+        throw object_invalidated();
+    if (id >= m_memberSlots.size())
+        throw invalid_member(boost::lexical_cast<std::string>(id));
+
+    const MemberSlot& slot = m_memberSlots[id];
+    if ((slot.property && memberAccessible(slot.property->zone)) ||
+        (slot.staticProperty && memberAccessible(slot.staticProperty->zone))) {
+        try {
+            if (slot.property)
+                slot.property->set(value);
+            else
+                slot.staticProperty->set(this, value);
+            if (!m_cacheableProperties.empty() && m_cacheableProperties.count(slot.name))
+                ++m_propertyCacheGeneration;
+            return;
+        } catch (const FB::bad_variant_cast& ex) {
+            std::string errorMsg("Could not convert from ");
+            errorMsg += ex.from;
+            errorMsg += " to ";
+            errorMsg += ex.to;
+            throw FB::invalid_arguments(errorMsg);
+        }
+    }
+    SetProperty(slot.name, value);
 }
 
 FB::JSAPIPtr FB::JSAPIAuto::GetMethodObject( const std::string& methodObjName )
@@ -302,7 +662,7 @@ FB::JSAPIPtr FB::JSAPIAuto::GetMethodObject( const std::string& methodObjName )
     if(!m_valid)
         throw object_invalidated();
 
-    if (memberAccessible(m_zoneMap.find(methodObjName)) && HasMethod(methodObjName)) {
+    if (HasMethod(methodObjName)) {
         MethodObjectMap::const_iterator fnd = m_methodObjectMap.find(boost::make_tuple(methodObjName, getZone()));
         if (fnd != m_methodObjectMap.end()) {
             return fnd->second;
@@ -319,9 +679,10 @@ FB::JSAPIPtr FB::JSAPIAuto::GetMethodObject( const std::string& methodObjName )
 void FB::JSAPIAuto::registerAttribute( const std::string &name, const FB::variant& value, bool readonly /*= false*/ )
 {
     boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
-    Attribute attr = {value, readonly};
+    Attribute attr = {value, readonly, getZone()};
     m_attributes[name] = attr;
-    m_zoneMap[name] = getZone();
+    m_zoneMap[name] = attr.zone;
+        m_memberNamesCache.clear();
 }
 
 void FB::JSAPIAuto::setReserved( const std::string &name )
@@ -346,9 +707,10 @@ void FB::JSAPIAuto::setAttribute( const std::string& name, const FB::variant& va
 {
     AttributeMap::iterator fnd = m_attributes.find(name);
     if (fnd != m_attributes.end() || !fnd->second.readonly) {
-        Attribute attr = {value, false};
+        Attribute attr = {value, false, getZone()};
         m_attributes[name] = attr;
-        m_zoneMap[name] = getZone();
+        m_zoneMap[name] = attr.zone;
+        m_memberNamesCache.clear();
     } else {
         throw FB::script_error("Cannot set read-only property " + name);
     }
@@ -358,3 +720,26 @@ bool FB::JSAPIAuto::memberAccessible( ZoneMap::const_iterator it ) const
 {
     return (it != m_zoneMap.end()) && getZone() >= it->second;
 }
+
+void FB::JSAPIAuto::enableMemberProfiling( bool enable )
+{
+#ifndef FB_NO_JSAPI_PROFILER
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if (enable) {
+        if (!m_profiler)
+            m_profiler.reset(new MemberProfiler());
+    } else {
+        m_profiler.reset();
+    }
+#endif
+}
+
+FB::VariantMap FB::JSAPIAuto::getMemberProfile()
+{
+#ifndef FB_NO_JSAPI_PROFILER
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    if (m_profiler)
+        return m_profiler->snapshot();
+#endif
+    return FB::VariantMap();
+}
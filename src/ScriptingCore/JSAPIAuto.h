@@ -19,8 +19,15 @@ Copyright 2009 Georg Fritzsche, Firebreath development team
 #include "JSAPI.h"
 #include "MethodConverter.h"
 #include "PropertyConverter.h"
+#include "StaticMemberTable.h"
+// Define FB_NO_JSAPI_PROFILER to compile the invocation profiler out entirely
+#ifndef FB_NO_JSAPI_PROFILER
+#include "MemberProfiler.h"
+#include <boost/scoped_ptr.hpp>
+#endif
 #include <deque>
 #include <vector>
+#include <set>
 #include <string>
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/tuple/tuple.hpp>
@@ -100,11 +107,26 @@ namespace FB {
             }
             FB::variant value;
             bool readonly;
+            // stamped at registration so access checks don't need a m_zoneMap lookup
+            FB::SecurityZone zone;
         };
         typedef std::map<boost::tuple<std::string, FB::SecurityZone>, FB::JSFunctionPtr> MethodObjectMap;
         typedef std::map<std::string, FB::SecurityZone> ZoneMap;
         typedef std::map<std::string, Attribute> AttributeMap;
 
+        // A member slot holds everything id-based dispatch needs for one member; the functor
+        // pointers borrow the node storage of the registration maps, which stays put for the
+        // life of the object (members are never erased, only overwritten in place)
+        struct MemberSlot {
+            std::string name;
+            MethodFunctors* method;
+            PropertyFunctors* property;
+            const StaticMemberTable::Method* staticMethod;
+            const StaticMemberTable::Property* staticProperty;
+        };
+        typedef std::vector<MemberSlot> MemberSlotList;
+        typedef boost::unordered_map<std::string, FB::MemberId> MemberIdMap;
+
     public:
         /// @brief Description is used by ToString().
         JSAPIAuto(const std::string& description = "<JSAPI-Auto Javascript Object>");
@@ -164,6 +186,8 @@ namespace FB {
         bool isReserved( const std::string& propertyName ) const;
 
         virtual void getMemberNames(std::vector<std::string> &nameVector) const;
+        // Memoized per zone; rebuilt only after a member is added or removed
+        virtual MemberNameListPtr getMemberNamesSnapshot() const;
         virtual size_t getMemberCount() const;
 
         virtual variant Invoke(const std::string& methodName, const std::vector<variant>& args);
@@ -228,12 +252,53 @@ namespace FB {
         /// @param  propFuncs   The property funcs. 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual void registerProperty(const std::string& name, const PropertyFunctors& propFuncs);
-        
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual void JSAPIAuto::registerProperty(const std::string& name,
+        /// const PropertyFunctors& propFuncs, bool cacheable)
+        ///
+        /// @brief  Register a property, optionally declaring it cacheable
+        ///
+        /// A cacheable property promises that its value only changes through SetProperty or an
+        /// explicit invalidateCachedProperties() call; the browser glue is then free to keep the
+        /// last converted value and serve repeat reads without dispatching into this object.
+        /// Use it for properties that are constant per page (version, capabilities, config) that
+        /// polling-heavy scripts read over and over.
+        ///
+        /// @param  name        The name
+        /// @param  propFuncs   The property funcs
+        /// @param  cacheable   true to let the glue cache reads of this property
+        /// @since 1.5
+        /// @see invalidateCachedProperties
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual void registerProperty(const std::string& name, const PropertyFunctors& propFuncs, bool cacheable);
+
+        virtual bool isPropertyCacheable(const std::string& propertyName) const;
+        virtual unsigned int getPropertyCacheGeneration() const { return m_propertyCacheGeneration; }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual void JSAPIAuto::invalidateCachedProperties()
+        ///
+        /// @brief  Drops every browser-side cached value of this object's cacheable properties;
+        ///         call it after something a cacheable getter depends on has changed
+        /// @since 1.5
+        /// @see registerProperty
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual void invalidateCachedProperties() { ++m_propertyCacheGeneration; }
+
         virtual variant GetProperty(const std::string& propertyName);
         virtual void SetProperty(const std::string& propertyName, const variant& value);
         virtual variant GetProperty(int idx);
         virtual void SetProperty(int idx, const variant& value);
 
+        virtual FB::VariantMap GetProperties(const std::vector<std::string>& propertyNames);
+        virtual void SetProperties(const FB::VariantMap& properties);
+
+        virtual FB::MemberId getMemberId(const std::string& name);
+        virtual variant InvokeById(FB::MemberId id, const std::vector<variant>& args);
+        virtual variant GetPropertyById(FB::MemberId id);
+        virtual void SetPropertyById(FB::MemberId id, const variant& value);
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual std::string JSAPIAuto::ToString()
         ///
@@ -283,10 +348,107 @@ namespace FB {
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual void setAttribute(const std::string& name, const FB::variant& value);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn public virtual void enableMemberProfiling(bool enable)
+        ///
+        /// @brief   Turns per-member invocation profiling on or off
+        ///
+        /// While enabled, every Invoke / GetProperty / SetProperty on this object is accounted in a
+        /// FB::MemberProfiler: call count, a log-bucketed latency histogram and an approximate
+        /// marshaled-bytes total per member.  The per-call cost while enabled is two clock reads and
+        /// one histogram increment; while disabled it is a single pointer test.  Disabling discards
+        /// the collected numbers.  Both this method and getMemberProfile are registered on every
+        /// JSAPIAuto, so telemetry JS can drive profiling without plugin-specific support.  Builds
+        /// that define FB_NO_JSAPI_PROFILER compile all of this out and the method becomes a no-op.
+        ///
+        /// @param  enable  true to start collecting, false to stop and discard
+        ///
+        /// @since 1.5
+        /// @see getMemberProfile
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual void enableMemberProfiling(bool enable);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn public virtual FB::VariantMap getMemberProfile()
+        ///
+        /// @brief   Returns the statistics collected since profiling was enabled
+        ///
+        /// One entry per member touched, each a map of calls, totalUs and bytes (as doubles) plus a
+        /// 20-element histogram list where slot i counts invocations that took [2^i, 2^(i+1))
+        /// microseconds.  Empty when profiling is disabled or compiled out.
+        ///
+        /// @returns FB::VariantMap
+        ///
+        /// @since 1.5
+        /// @see enableMemberProfiling
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual FB::VariantMap getMemberProfile();
+
     protected:
         inline bool memberAccessible( ZoneMap::const_iterator it ) const;
+        inline bool memberAccessible( const SecurityZone& zone ) const {
+            return getZone() >= zone;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn protected void setMemberTable(const StaticMemberTable& table)
+        ///
+        /// @brief  Attaches a per-class static member table to this instance
+        ///
+        /// Members declared in the table are exposed to javascript exactly like members added with
+        /// registerMethod/registerProperty, but the table is built once and shared by every instance
+        /// of the class, so attaching it costs a pointer assignment instead of rebuilding the member
+        /// maps.  Call this from the constructor; the table must outlive the object (a function-local
+        /// static is the usual way).  Per-instance registrations shadow table entries of the same name.
+        ///
+        /// @param  table   The table; only a reference is kept
+        /// @since 1.5
+        /// @see FB::StaticMemberTable
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setMemberTable(const StaticMemberTable& table) {
+            m_staticMembers = &table;
+            m_memberNamesCache.clear();
+        }
 
     protected:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @struct MemberDirectory
+        ///
+        /// @brief  Immutable name -> (kind, zone, cacheable) index over the registered members
+        ///
+        /// Pure existence queries (HasMethod, HasProperty, isPropertyCacheable) are hot and
+        /// read-only, while registration happens a handful of times at setup; the directory lets
+        /// those queries run without touching m_zoneMutex at all.  It is rebuilt lazily from the
+        /// master maps the first time it is needed after a registration invalidates it, following
+        /// the same pattern as m_memberNamesCache.  Attributes are deliberately not indexed --
+        /// with dynamic attributes enabled they mutate at runtime, so HasProperty falls back to
+        /// the locked path for them.
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        struct MemberDirectory {
+            struct Entry {
+                Entry() : methodZone(SecurityScope_Public), propertyZone(SecurityScope_Public),
+                    isMethod(false), isProperty(false), cacheable(false) {}
+                SecurityZone methodZone;
+                SecurityZone propertyZone;
+                bool isMethod;
+                bool isProperty;
+                bool cacheable;
+            };
+            typedef std::map<std::string, Entry> Map;
+            Map members;
+        };
+        typedef boost::shared_ptr<const MemberDirectory> MemberDirectoryPtr;
+
+        /// Returns the current directory (never NULL), rebuilding it if a registration
+        /// invalidated it; the returned snapshot is safe to search without any lock
+        /// @since 1.5
+        MemberDirectoryPtr getMemberDirectory() const;
+        /// Drops the directory so the next query rebuilds it; writers call this after
+        /// mutating the member maps
+        /// @since 1.5
+        void invalidateMemberDirectory();
+
         // Stores Method Objects -- JSAPI proxy objects for calling a method on this object
         MethodObjectMap m_methodObjectMap;
         // Stores the methods exposed to JS
@@ -295,6 +457,28 @@ namespace FB {
         PropertyFunctorsMap m_propertyFunctorsMap;
         // Keeps track of the security zone of each member
         ZoneMap m_zoneMap;
+        // Optional per-class member table shared by all instances; NULL if the class has none
+        const StaticMemberTable* m_staticMembers;
+        // Dense member slots for id-based dispatch, filled lazily by getMemberId
+        MemberSlotList m_memberSlots;
+        // Maps member names to their slot index
+        MemberIdMap m_memberIds;
+        // Memoized enumeration snapshots, one per zone that has enumerated;
+        // cleared whenever a member is added or removed.  Guarded by
+        // m_zoneMutex like the member maps it is derived from
+        typedef std::map<SecurityZone, MemberNameListPtr> MemberNamesCache;
+        mutable MemberNamesCache m_memberNamesCache;
+        // Names registered with the cacheable flag; guarded by m_zoneMutex
+        std::set<std::string> m_cacheableProperties;
+        // Published member directory and its invalidation generation; both
+        // guarded by m_directoryMutex, which is never held while taking
+        // m_zoneMutex (always zone -> directory order)
+        mutable boost::mutex m_directoryMutex;
+        mutable MemberDirectoryPtr m_memberDirectory;
+        mutable unsigned int m_directoryGeneration;
+        // Bumped by invalidateCachedProperties (and by writes to cacheable
+        // properties) so the glue can drop stale values with one compare
+        unsigned int m_propertyCacheGeneration;
         
         const std::string m_description;
 
@@ -302,6 +486,10 @@ namespace FB {
         FB::StringSet m_reservedMembers;
         bool m_allowDynamicAttributes;
         bool m_allowMethodObjects;
+#ifndef FB_NO_JSAPI_PROFILER
+        // NULL until enableMemberProfiling(true); guarded by m_zoneMutex like everything else here
+        boost::scoped_ptr<MemberProfiler> m_profiler;
+#endif
     };
 
 };
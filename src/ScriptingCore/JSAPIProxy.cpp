@@ -14,6 +14,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 #include <boost/make_shared.hpp>
 
+#include "utf8_tools.h"
 #include "JSAPIProxy.h"
 
 FB::JSAPIProxyPtr FB::JSAPIProxy::create( const FB::JSAPIPtr &inner )
@@ -95,6 +96,7 @@ void FB::JSAPIProxy::changeObject( const FB::JSAPIWeakPtr &inner )
     }
     this->m_api.reset();
     this->m_apiWeak = inner;
+    this->m_memberKinds.clear();
     FB::JSAPIPtr ptr = inner.lock();
     if (ptr)
         ptr->registerProxy(shared_ptr());
@@ -107,6 +109,7 @@ void FB::JSAPIProxy::changeObject( const FB::JSAPIPtr &inner )
     }
     this->m_api = inner;
     this->m_apiWeak = inner;
+    this->m_memberKinds.clear();
     inner->registerProxy(shared_ptr());
 }
 
@@ -115,7 +118,7 @@ void FB::JSAPIProxy::reset()
     if (FB::JSAPIPtr ptr = m_apiWeak.lock()) {
         ptr->unregisterProxy(shared_ptr());
     }
-    
+    m_memberKinds.clear();
 }
 
 void FB::JSAPIProxy::invalidate()
@@ -137,30 +140,48 @@ size_t FB::JSAPIProxy::getMemberCount() const
 
 bool FB::JSAPIProxy::HasMethod( const std::wstring& methodName ) const
 {
-    FB::scoped_zonelock _l(getAPI(), getZone());
-    return getAPI()->HasMethod(methodName);
+    return HasMethod(FB::wstring_to_utf8(methodName));
 }
 
 bool FB::JSAPIProxy::HasMethod( const std::string& methodName ) const
 {
+    const MemberKindCache::key_type key(methodName, getZone());
+    {
+        boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+        MemberKindCache::const_iterator fnd = m_memberKinds.find(key);
+        if (fnd != m_memberKinds.end() && (fnd->second & MemberKind_Method))
+            return true;
+    }
     FB::scoped_zonelock _l(getAPI(), getZone());
-    return getAPI()->HasMethod(methodName);
+    if (!getAPI()->HasMethod(methodName))
+        return false;
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    m_memberKinds[key] |= MemberKind_Method;
+    return true;
 }
 
 bool FB::JSAPIProxy::HasProperty( const std::wstring& propertyName ) const
 {
-    if (propertyName == L"expired")
-        return true;
-    FB::scoped_zonelock _l(getAPI(), getZone());
-    return getAPI()->HasProperty(propertyName);
+    return HasProperty(FB::wstring_to_utf8(propertyName));
 }
 
 bool FB::JSAPIProxy::HasProperty( const std::string& propertyName ) const
 {
     if (propertyName == "expired")
         return true;
+    const MemberKindCache::key_type key(propertyName, getZone());
+    {
+        boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+        MemberKindCache::const_iterator fnd = m_memberKinds.find(key);
+        if (fnd != m_memberKinds.end() && (fnd->second & MemberKind_Property))
+            return true;
+    }
     FB::scoped_zonelock _l(getAPI(), getZone());
-    return getAPI()->HasProperty(propertyName);
+    if (!getAPI()->HasProperty(propertyName))
+        return false;
+    boost::recursive_mutex::scoped_lock lock(m_zoneMutex);
+    m_memberKinds[key] |= MemberKind_Property;
+    return true;
 }
 
 bool FB::JSAPIProxy::HasProperty( int idx ) const
@@ -232,3 +253,39 @@ FB::variant FB::JSAPIProxy::Invoke( const std::string& methodName, const std::ve
     FB::scoped_zonelock _l(getAPI(), getZone());
     return getAPI()->Invoke(methodName, args);
 }
+
+FB::VariantMap FB::JSAPIProxy::GetProperties( const std::vector<std::string>& propertyNames )
+{
+    FB::scoped_zonelock _l(getAPI(), getZone());
+    return getAPI()->GetProperties(propertyNames);
+}
+
+void FB::JSAPIProxy::SetProperties( const FB::VariantMap& properties )
+{
+    FB::scoped_zonelock _l(getAPI(), getZone());
+    getAPI()->SetProperties(properties);
+}
+
+FB::MemberId FB::JSAPIProxy::getMemberId( const std::string& name )
+{
+    FB::scoped_zonelock _l(getAPI(), getZone());
+    return getAPI()->getMemberId(name);
+}
+
+FB::variant FB::JSAPIProxy::InvokeById( FB::MemberId id, const std::vector<variant>& args )
+{
+    FB::scoped_zonelock _l(getAPI(), getZone());
+    return getAPI()->InvokeById(id, args);
+}
+
+FB::variant FB::JSAPIProxy::GetPropertyById( FB::MemberId id )
+{
+    FB::scoped_zonelock _l(getAPI(), getZone());
+    return getAPI()->GetPropertyById(id);
+}
+
+void FB::JSAPIProxy::SetPropertyById( FB::MemberId id, const variant& value )
+{
+    FB::scoped_zonelock _l(getAPI(), getZone());
+    getAPI()->SetPropertyById(id, value);
+}
@@ -18,6 +18,7 @@ Copyright 2009 Richard Bateman, Firebreath development team
 
 #include "APITypes.h"
 #include "JSAPI.h"
+#include <boost/unordered_map.hpp>
 
 namespace FB
 {
@@ -129,6 +130,14 @@ namespace FB
         mutable FB::JSAPIPtr m_api;
         mutable FB::JSAPIWeakPtr m_apiWeak;
 
+        // Memoized positive member-existence answers from the wrapped object, keyed by
+        // name and the zone asking.  Members are never unregistered from a JSAPI object,
+        // so a positive answer stays good until changeObject() swaps the object out;
+        // negative answers are not cached because members can be registered at any time.
+        enum MemberKind { MemberKind_Method = 0x01, MemberKind_Property = 0x02 };
+        typedef boost::unordered_map<std::pair<std::string, SecurityZone>, unsigned char> MemberKindCache;
+        mutable MemberKindCache m_memberKinds;
+
     public:
 
         void invalidate();
@@ -154,6 +163,14 @@ namespace FB
         virtual void SetProperty(int idx, const variant& value);
         virtual variant Invoke(const std::wstring& methodName, const std::vector<variant>& args);
         virtual variant Invoke(const std::string& methodName, const std::vector<variant>& args);
+
+        virtual FB::VariantMap GetProperties(const std::vector<std::string>& propertyNames);
+        virtual void SetProperties(const FB::VariantMap& properties);
+
+        virtual FB::MemberId getMemberId(const std::string& name);
+        virtual variant InvokeById(FB::MemberId id, const std::vector<variant>& args);
+        virtual variant GetPropertyById(FB::MemberId id);
+        virtual void SetPropertyById(FB::MemberId id, const variant& value);
     };
 
 };
@@ -1,4 +1,4 @@
-/**********************************************************\ 
+/**********************************************************\
 Original Author: Georg Fritzsche
 
 Created:    December 13, 2009
@@ -14,18 +14,20 @@ Copyright 2009 Georg Fritzsche, Firebreath development team
 
 #include "JSArray.h"
 #include <iterator>
+#include <boost/lexical_cast.hpp>
 #include "BrowserHost.h"
 #include "DOM/Window.h"
 #include "variant_list.h"
 
 FB::JSArray::JSArray(const FB::JSObjectPtr& obj)
-  : m_obj(obj)
+  : m_obj(obj), m_blockSize(256), m_lengthValid(false), m_length(0)
 {
     if(!m_obj->HasProperty("length"))
         throw FB::script_error("object does not have property length");
 }
 
 FB::JSArray::JSArray(BrowserHostPtr host, const FB::VariantList& values)
+  : m_blockSize(256), m_lengthValid(false), m_length(0)
 {
     m_obj = host->getDOMWindow()->createArray();
     for (FB::VariantList::const_iterator it = values.begin(); it != values.end(); it++)
@@ -39,33 +41,93 @@ FB::JSArray::JSArray(BrowserHostPtr host, const FB::VariantList& values)
 void FB::JSArray::push(FB::variant value)
 {
     m_obj->Invoke("push", FB::variant_list_of(value));
+    if (m_lengthValid) {
+        // the new element lands in what may be a partially fetched block
+        m_blocks.erase(m_length / m_blockSize);
+        ++m_length;
+    }
 }
 
 size_t FB::JSArray::GetLength() const
 {
-    return m_obj->GetProperty("length").convert_cast<size_t>();
+    if (!m_lengthValid) {
+        m_length = m_obj->GetProperty("length").convert_cast<size_t>();
+        m_lengthValid = true;
+    }
+    return m_length;
+}
+
+void FB::JSArray::setBlockSize(size_t entries)
+{
+    if (!entries || entries == m_blockSize)
+        return;
+    m_blockSize = entries;
+    m_blocks.clear();
+}
+
+void FB::JSArray::refresh()
+{
+    m_lengthValid = false;
+    m_blocks.clear();
+}
+
+const FB::VariantList& FB::JSArray::fetchBlock(size_t block) const
+{
+    std::map<size_t, FB::VariantList>::const_iterator found = m_blocks.find(block);
+    if (found != m_blocks.end())
+        return found->second;
+
+    const size_t start = block * m_blockSize;
+    size_t end = start + m_blockSize;
+    if (end > GetLength())
+        end = GetLength();
+
+    // one batched crossing for the whole block; browser glue that implements
+    // GetProperties natively answers all the indices in a single round trip
+    std::vector<std::string> names;
+    names.reserve(end - start);
+    for (size_t i = start; i < end; ++i)
+        names.push_back(boost::lexical_cast<std::string>(i));
+    FB::VariantMap values = m_obj->GetProperties(names);
+
+    FB::VariantList& out = m_blocks[block];
+    out.reserve(end - start);
+    for (size_t i = start; i < end; ++i)
+        out.push_back(values[names[i - start]]);
+    return out;
 }
 
 FB::variant FB::JSArray::Get(size_t index)
 {
-    return m_obj->GetProperty(index);
+    if (index >= GetLength())
+        return m_obj->GetProperty(index);
+    const FB::VariantList& block = fetchBlock(index / m_blockSize);
+    return block[index % m_blockSize];
 }
 
 void FB::JSArray::Set(const size_t index, const FB::variant& value)
 {
     m_obj->SetProperty(index, value);
+    // keep any fetched copy coherent with the write
+    std::map<size_t, FB::VariantList>::iterator found = m_blocks.find(index / m_blockSize);
+    if (found != m_blocks.end() && index % m_blockSize < found->second.size())
+        found->second[index % m_blockSize] = value;
+    if (m_lengthValid && index >= m_length)
+        m_lengthValid = false;
 }
 
 FB::variant FB::JSArray::operator[](size_t index)
 {
-    return m_obj->GetProperty(index);
+    return Get(index);
 }
 
 FB::VariantList FB::JSArray::Values()
 {
     FB::VariantList output;
-    for (size_t i = 0; i < GetLength(); i++) {
-        output.push_back((*this)[i]);
+    const size_t len = GetLength();
+    output.reserve(len);
+    for (size_t i = 0; i < len; i++) {
+        output.push_back(Get(i));
     }
     return output;
 }
@@ -1,4 +1,4 @@
-/**********************************************************\ 
+/**********************************************************\
 Original Author: Georg Fritzsche
 
 Created:    December 13, 2009
@@ -16,6 +16,7 @@ Copyright 2009 Georg Fritzsche, Firebreath development team
 #ifndef H_JSARRAY
 #define H_JSARRAY
 
+#include <map>
 #include "JSObject.h"
 #include "JSAPIAuto.h"
 
@@ -27,6 +28,13 @@ namespace FB
     ///
     /// @brief  Wraps a Javascript Array from a FB::JSObject.  Use this if your array is very large
     ///         or if you need to pass it by reference and change it in your function.
+    ///
+    /// This is a lazy view: the length is cached once and elements are fetched on demand in
+    /// blocks (256 entries by default, one batched browser call per block), so wrapping a
+    /// 100k-element array and reading a handful of entries costs a handful of crossings.
+    /// Cached entries reflect the array as of when their block was fetched; if script mutates
+    /// the array behind your back, call refresh().  Values() is the explicit eager full copy.
+    ///
     /// @code
     ///      void handleArray(const FB::JSObjectPtr &in) {
     ///         FB::JSArray arr(in);
@@ -46,15 +54,44 @@ namespace FB
         FB::variant Get(size_t index);
         void Set(const size_t index, const variant& value);
         size_t GetLength() const;
-        
+
         FB::variant operator[](size_t index);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantList Values()
+        ///
+        /// @brief  Eagerly copies the whole array (block by block) into a VariantList
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
         FB::VariantList Values();
 
         void push(variant value);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void setBlockSize(size_t entries)
+        ///
+        /// @brief  Sets how many elements one batched fetch pulls in (default 256)
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setBlockSize(size_t entries);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void refresh()
+        ///
+        /// @brief  Drops the cached length and all fetched blocks; the next access re-reads
+        ///         the underlying array
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void refresh();
+
     protected:
+        const FB::VariantList& fetchBlock(size_t block) const;
+
         FB::JSObjectPtr m_obj;
+        size_t m_blockSize;
+        mutable bool m_lengthValid;
+        mutable size_t m_length;
+        /// block index -> fetched values (block * m_blockSize is the first element)
+        mutable std::map<size_t, FB::VariantList> m_blocks;
         void RegisterMethods();
     };
 }
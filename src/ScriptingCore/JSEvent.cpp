@@ -1,44 +1,114 @@
-/**********************************************************\ 
-Original Author: Richard Bateman (taxilian)
-
-Created:    Dec 17, 2010
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-            
-Copyright 2010 Richard Bateman, Firebreath development team
-\**********************************************************/
-
-#include "JSEvent.h"
-#include "variant.h"
-
-FB::VariantMap FB::CreateEvent( const FB::JSAPIPtr& api, const std::string& name, const FB::VariantMap &members, const FB::VariantList &arguments )
-{
-    FB::VariantMap event;
-    event["type"] = name;
-    event["target"] = api;
-    event["currentTarget"] = api;
-    event["eventPhase"] = 2; // we're always AT_TARGET
-    event["bubbles"] = false;
-    event["cancelable"] = false; // Events in firebreath are async; not cancelable
-    event["namespaceURI"] = name;
-    //event["timeStamp"] = FB::FBDateString();
-
-    // Add the custom members
-    event.insert(members.begin(), members.end());
-    event["arguments"] = arguments;
-    return event;
-}
-
-FB::VariantMap FB::CreateEvent( const FB::JSAPIPtr& api, const std::string& name, const FB::VariantMap &members )
-{
-    return FB::CreateEvent(api, name, members, FB::VariantList());
-}
-
-FB::VariantMap FB::CreateEvent( const FB::JSAPIPtr& api, const std::string& name, const VariantList &arguments )
-{
-    return FB::CreateEvent(api, name, FB::VariantMap(), arguments);
-}
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Dec 17, 2010
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#include "JSEvent.h"
+#include "variant.h"
+
+namespace
+{
+    // Recycler for event maps.  High-rate event sources (progress events and
+    // the like) fire the same DOM-style event shape over and over; handing the
+    // previous event's map back to the next CreateEvent call lets the map
+    // reuse its nodes instead of rebuilding them, so steady-state firing does
+    // no per-event node allocation.  Guarded by a mutex because events can be
+    // fired from any thread
+    boost::mutex event_pool_mutex;
+    std::vector<FB::VariantMap*> event_pool;
+    const size_t event_pool_max = 32;
+
+    // The keys CreateEvent always sets; their nodes are the ones worth keeping
+    // across reuse
+    bool isFixedEventKey(const std::string& key)
+    {
+        return key == "type" || key == "target" || key == "currentTarget"
+            || key == "eventPhase" || key == "bubbles" || key == "cancelable"
+            || key == "namespaceURI" || key == "arguments";
+    }
+
+    void recycleEventMap(FB::VariantMap* map)
+    {
+        // Drop custom members from the last event and release anything the
+        // fixed entries still reference (target holds the JSAPI alive), but
+        // keep the fixed-key nodes themselves for the next event
+        for (FB::VariantMap::iterator it = map->begin(); it != map->end();) {
+            if (isFixedEventKey(it->first)) {
+                it->second = FB::variant();
+                ++it;
+            } else {
+                it = map->erase(it);
+            }
+        }
+        {
+            boost::mutex::scoped_lock lock(event_pool_mutex);
+            if (event_pool.size() < event_pool_max) {
+                event_pool.push_back(map);
+                return;
+            }
+        }
+        delete map;
+    }
+}
+
+FB::EventMapPtr FB::acquireEventMap()
+{
+    FB::VariantMap* map = NULL;
+    {
+        boost::mutex::scoped_lock lock(event_pool_mutex);
+        if (!event_pool.empty()) {
+            map = event_pool.back();
+            event_pool.pop_back();
+        }
+    }
+    if (!map)
+        map = new FB::VariantMap;
+    return FB::EventMapPtr(map, &recycleEventMap);
+}
+
+void FB::CreateEvent( const FB::JSAPIPtr& api, const std::string& name, const FB::VariantMap &members, const FB::VariantList &arguments, FB::VariantMap& event )
+{
+    event["type"] = name;
+    event["target"] = api;
+    event["currentTarget"] = api;
+    event["eventPhase"] = 2; // we're always AT_TARGET
+    event["bubbles"] = false;
+    event["cancelable"] = false; // Events in firebreath are async; not cancelable
+    event["namespaceURI"] = name;
+    //event["timeStamp"] = FB::FBDateString();
+
+    // Add the custom members
+    for (FB::VariantMap::const_iterator it = members.begin(); it != members.end(); ++it) {
+        event[it->first] = it->second;
+    }
+    event["arguments"] = arguments;
+}
+
+FB::VariantMap FB::CreateEvent( const FB::JSAPIPtr& api, const std::string& name, const FB::VariantMap &members, const FB::VariantList &arguments )
+{
+    FB::VariantMap event;
+    FB::CreateEvent(api, name, members, arguments, event);
+    return event;
+}
+
+FB::VariantMap FB::CreateEvent( const FB::JSAPIPtr& api, const std::string& name, const FB::VariantMap &members )
+{
+    return FB::CreateEvent(api, name, members, FB::VariantList());
+}
+
+FB::VariantMap FB::CreateEvent( const FB::JSAPIPtr& api, const std::string& name, const VariantList &arguments )
+{
+    return FB::CreateEvent(api, name, FB::VariantMap(), arguments);
+}
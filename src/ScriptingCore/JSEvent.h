@@ -25,6 +25,18 @@ namespace FB {
     FB::VariantMap CreateEvent(const FB::JSAPIPtr& api, const std::string& name, const FB::VariantMap &members);
     FB::VariantMap CreateEvent(const FB::JSAPIPtr& api, const std::string& name, const FB::VariantList &arguments);
 
+    // In-place form: fills event instead of returning a fresh map.  When event
+    // came from acquireEventMap the standard keys are already present and the
+    // assignments reuse their nodes
+    void CreateEvent(const FB::JSAPIPtr& api, const std::string& name, const FB::VariantMap &members, const FB::VariantList &arguments, FB::VariantMap& event);
+
+    // A recycled event map; when the last reference goes away the map is
+    // scrubbed (custom members erased, held references dropped) and returned
+    // to a process-wide pool so steady-state event firing reuses maps instead
+    // of allocating them.  Safe from any thread
+    typedef boost::shared_ptr<FB::VariantMap> EventMapPtr;
+    EventMapPtr acquireEventMap();
+
 };
 
 #endif
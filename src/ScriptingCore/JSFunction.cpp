@@ -39,6 +39,13 @@ FB::variant FB::JSFunction::exec( const std::vector<variant>& args )
         throw new FB::script_error("Invalid JSAPI object");
     // Force calls to use the zone this function was created with
     FB::scoped_zonelock(api, getZone());
+    if (m_methodName.empty()) {
+        // Calling a raw function object; take the glue's default-invoke fast
+        // path instead of going through named-method dispatch with ""
+        FB::JSObjectPtr obj(FB::ptr_cast<FB::JSObject>(api));
+        if (obj)
+            return obj->InvokeDefault(args);
+    }
     return api->Invoke(m_methodName, args);
 }
 
@@ -0,0 +1,476 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include "variant.h"
+#include "variant_list.h"
+#include "variant_map.h"
+#include "ThreadPool.h"
+#include "JSONParser.h"
+
+using FB::variant;
+
+namespace {
+
+    // in-place access to a container already stored in a variant; cast() only
+    // exposes a const reference, but the storage itself is ours and mutable.
+    // Building subtrees directly inside their parent this way is what makes the
+    // parse single-pass -- nothing is ever copied into place afterwards
+    template <class C>
+    C& containerInside(variant& var)
+    {
+        return const_cast<C&>(var.cast<C>());
+    }
+
+    void appendUtf8(std::string& out, unsigned long cp)
+    {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // recursion bound for the descent; structured clone feeds this parser
+    // page-controlled input, so pathological nesting must fail cleanly
+    // instead of exhausting the stack
+    const int max_json_depth = 512;
+
+    struct Parser {
+        const char* p;
+        const char* end;
+        const char* origin;  // document start, for error offsets
+        int depth;           // current container nesting
+
+        Parser(const char* b, const char* e, const char* o)
+            : p(b), end(e), origin(o), depth(0) { }
+
+        void fail(const char* what) const
+        {
+            std::ostringstream msg;
+            msg << "JSON parse error at offset " << (p - origin) << ": " << what;
+            throw FB::json_parse_error(msg.str());
+        }
+
+        void skipWs()
+        {
+            while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+                ++p;
+        }
+
+        void expect(char c)
+        {
+            if (p == end || *p != c)
+                fail("unexpected character");
+            ++p;
+        }
+
+        void literal(const char* text, size_t len)
+        {
+            if (static_cast<size_t>(end - p) < len || std::memcmp(p, text, len) != 0)
+                fail("invalid literal");
+            p += len;
+        }
+
+        unsigned long hex4()
+        {
+            if (end - p < 4)
+                fail("truncated \\u escape");
+            unsigned long v = 0;
+            for (int i = 0; i < 4; ++i, ++p) {
+                const char c = *p;
+                v <<= 4;
+                if (c >= '0' && c <= '9') v |= c - '0';
+                else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+                else fail("bad hex digit in \\u escape");
+            }
+            return v;
+        }
+
+        void parseString(std::string& out)
+        {
+            expect('"');
+            // most strings have no escapes; find the plain prefix and take it whole
+            const char* run = p;
+            while (p != end && *p != '"' && *p != '\\')
+                ++p;
+            out.assign(run, p - run);
+            while (p != end && *p != '"') {
+                if (*p == '\\') {
+                    ++p;
+                    if (p == end)
+                        break;
+                    switch (*p++) {
+                        case '"': out += '"'; break;
+                        case '\\': out += '\\'; break;
+                        case '/': out += '/'; break;
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'n': out += '\n'; break;
+                        case 'r': out += '\r'; break;
+                        case 't': out += '\t'; break;
+                        case 'u': {
+                            unsigned long cp = hex4();
+                            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                                if (end - p >= 2 && p[0] == '\\' && p[1] == 'u') {
+                                    p += 2;
+                                    const unsigned long lo = hex4();
+                                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                                }
+                            }
+                            appendUtf8(out, cp);
+                            break;
+                        }
+                        default: fail("unknown escape");
+                    }
+                } else {
+                    run = p;
+                    while (p != end && *p != '"' && *p != '\\')
+                        ++p;
+                    out.append(run, p - run);
+                }
+            }
+            expect('"');
+        }
+
+        void parseNumber(variant& out)
+        {
+            char buf[64];
+            size_t n = 0;
+            bool isDouble = false;
+            while (p != end && n < sizeof(buf) - 1) {
+                const char c = *p;
+                if ((c >= '0' && c <= '9') || c == '-' || c == '+') {
+                    buf[n++] = c;
+                } else if (c == '.' || c == 'e' || c == 'E') {
+                    buf[n++] = c;
+                    isDouble = true;
+                } else {
+                    break;
+                }
+                ++p;
+            }
+            buf[n] = '\0';
+            if (!n)
+                fail("invalid number");
+            if (!isDouble) {
+                errno = 0;
+                const long v = std::strtol(buf, NULL, 10);
+                if (!errno && v >= INT_MIN && v <= INT_MAX) {
+                    out = static_cast<int>(v);
+                    return;
+                }
+            }
+            out = std::strtod(buf, NULL);
+        }
+
+        void parseArray(variant& out)
+        {
+            expect('[');
+            out = FB::VariantList();
+            FB::VariantList& list = containerInside<FB::VariantList>(out);
+            skipWs();
+            if (p != end && *p == ']') {
+                ++p;
+                return;
+            }
+            for (;;) {
+                list.push_back(variant());
+                parseValue(list.back());
+                skipWs();
+                if (p == end)
+                    fail("unterminated array");
+                if (*p == ',') {
+                    ++p;
+                    skipWs();
+                } else if (*p == ']') {
+                    ++p;
+                    return;
+                } else {
+                    fail("expected ',' or ']'");
+                }
+            }
+        }
+
+        void parseObject(variant& out)
+        {
+            expect('{');
+            out = FB::VariantMap();
+            FB::VariantMap& map = containerInside<FB::VariantMap>(out);
+            skipWs();
+            if (p != end && *p == '}') {
+                ++p;
+                return;
+            }
+            std::string key;
+            for (;;) {
+                key.clear();
+                parseString(key);
+                skipWs();
+                expect(':');
+                skipWs();
+                parseValue(map[key]);
+                skipWs();
+                if (p == end)
+                    fail("unterminated object");
+                if (*p == ',') {
+                    ++p;
+                    skipWs();
+                } else if (*p == '}') {
+                    ++p;
+                    return;
+                } else {
+                    fail("expected ',' or '}'");
+                }
+            }
+        }
+
+        void parseValue(variant& out)
+        {
+            if (p == end)
+                fail("unexpected end of input");
+            switch (*p) {
+                case '{':
+                    if (++depth > max_json_depth)
+                        fail("nesting too deep");
+                    parseObject(out);
+                    --depth;
+                    break;
+                case '[':
+                    if (++depth > max_json_depth)
+                        fail("nesting too deep");
+                    parseArray(out);
+                    --depth;
+                    break;
+                case '"': {
+                    std::string s;
+                    parseString(s);
+                    out = s;
+                    break;
+                }
+                case 't': literal("true", 4); out = true; break;
+                case 'f': literal("false", 5); out = false; break;
+                case 'n': literal("null", 4); out = FB::FBNull(); break;
+                default: parseNumber(out); break;
+            }
+        }
+    };
+
+    // Walks past one value without building anything; used to find element
+    // boundaries for the parallel split.  Returns NULL on malformed input so
+    // the caller can fall back to the serial parse for a proper error
+    const char* skipValue(const char* p, const char* end)
+    {
+        int depth = 0;
+        bool inString = false;
+        for (; p != end; ++p) {
+            if (inString) {
+                if (*p == '\\') {
+                    if (++p == end)
+                        return NULL;
+                } else if (*p == '"') {
+                    inString = false;
+                    if (!depth)
+                        return p + 1;   // bare string: done at the closing quote
+                }
+            } else if (*p == '"') {
+                inString = true;
+            } else if (*p == '[' || *p == '{') {
+                ++depth;
+            } else if (*p == ']' || *p == '}') {
+                if (!depth)
+                    return p;           // bare primitive ended by the enclosing close
+                if (!--depth)
+                    return p + 1;       // matching close of the value itself
+            } else if (!depth && (*p == ',' || *p == ' ' || *p == '\t'
+                                  || *p == '\n' || *p == '\r')) {
+                // a bare primitive ends at the first delimiter
+                return p;
+            }
+        }
+        return NULL;    // ran off the end inside the value
+    }
+
+    // work below this size parses faster than it forks
+    const size_t parallel_threshold = 256 * 1024;
+
+    struct ParseLatch {
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        size_t remaining;
+        std::string error;
+
+        explicit ParseLatch(size_t count) : remaining(count) { }
+
+        void done(const std::string& err)
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            if (!err.empty() && error.empty())
+                error = err;
+            if (!--remaining)
+                cond.notify_one();
+        }
+
+        void wait()
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            while (remaining)
+                cond.wait(lock);
+        }
+    };
+
+    // parses elements [first, last) of the boundary list into out
+    void parseChunk(const std::vector<std::pair<const char*, const char*> >* elems,
+                    size_t first, size_t last, const char* origin,
+                    FB::VariantList* out, ParseLatch* latch)
+    {
+        std::string err;
+        try {
+            out->reserve(last - first);
+            for (size_t i = first; i < last; ++i) {
+                Parser parser((*elems)[i].first, (*elems)[i].second, origin);
+                out->push_back(variant());
+                parser.skipWs();
+                parser.parseValue(out->back());
+            }
+        } catch (const std::exception& ex) {
+            err = ex.what();
+        }
+        latch->done(err);
+    }
+}
+
+FB::variant FB::jsonToVariant(const char* begin, const char* end)
+{
+    Parser parser(begin, end, begin);
+    variant out;
+    parser.skipWs();
+    parser.parseValue(out);
+    parser.skipWs();
+    if (parser.p != parser.end)
+        parser.fail("trailing characters after value");
+    return out;
+}
+
+FB::variant FB::jsonToVariant(const std::string& json)
+{
+    return jsonToVariant(json.data(), json.data() + json.size());
+}
+
+FB::variant FB::jsonToVariant(const std::string& json, const ThreadPoolPtr& pool)
+{
+    const char* begin = json.data();
+    const char* end = begin + json.size();
+    const char* p = begin;
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        ++p;
+    if (!pool || pool->getThreadCount() < 2 || json.size() < parallel_threshold
+        || p == end || *p != '[')
+        return jsonToVariant(begin, end);
+
+    // find the top-level element boundaries; any scan trouble means the input
+    // is malformed, and the serial parse reports that with a decent offset
+    std::vector<std::pair<const char*, const char*> > elems;
+    const char* cursor = p + 1;
+    for (;;) {
+        while (cursor != end && (*cursor == ' ' || *cursor == '\t'
+                                 || *cursor == '\n' || *cursor == '\r'))
+            ++cursor;
+        if (cursor == end)
+            return jsonToVariant(begin, end);
+        if (*cursor == ']')
+            break;
+        const char* stop = skipValue(cursor, end);
+        if (!stop)
+            return jsonToVariant(begin, end);
+        elems.push_back(std::make_pair(cursor, stop));
+        cursor = stop;
+        while (cursor != end && (*cursor == ' ' || *cursor == '\t'
+                                 || *cursor == '\n' || *cursor == '\r'))
+            ++cursor;
+        if (cursor == end)
+            return jsonToVariant(begin, end);
+        if (*cursor == ',')
+            ++cursor;
+        else if (*cursor != ']')
+            return jsonToVariant(begin, end);
+    }
+    for (const char* tail = cursor + 1; tail != end; ++tail) {
+        if (*tail != ' ' && *tail != '\t' && *tail != '\n' && *tail != '\r')
+            return jsonToVariant(begin, end);  // serial parse reports the offset
+    }
+
+    size_t chunks = pool->getThreadCount();
+    if (chunks > elems.size())
+        chunks = elems.size();
+    if (chunks < 2)
+        return jsonToVariant(begin, end);
+
+    std::vector<FB::VariantList> parts(chunks);
+    ParseLatch latch(chunks - 1);
+    const size_t per = (elems.size() + chunks - 1) / chunks;
+    for (size_t c = 1; c < chunks; ++c) {
+        const size_t first = c * per;
+        const size_t last = (first + per < elems.size()) ? first + per : elems.size();
+        ThreadPool::TaskType task(boost::bind(&parseChunk, &elems, first, last,
+                                              begin, &parts[c], &latch));
+        if (!pool->post(task))
+            task();  // pool shutting down; do the work here
+    }
+    // the calling thread takes the first chunk instead of idling in wait()
+    {
+        ParseLatch own(1);
+        parseChunk(&elems, 0, per < elems.size() ? per : elems.size(), begin,
+                   &parts[0], &own);
+        if (!own.error.empty()) {
+            latch.wait();
+            throw json_parse_error(own.error);
+        }
+    }
+    latch.wait();
+    if (!latch.error.empty())
+        throw json_parse_error(latch.error);
+
+    variant out = FB::VariantList();
+    FB::VariantList& list = containerInside<FB::VariantList>(out);
+    list.reserve(elems.size());
+    for (size_t c = 0; c < chunks; ++c) {
+        // splice by swapping each parsed element in; no subtree is deep-copied
+        for (size_t i = 0; i < parts[c].size(); ++i) {
+            list.push_back(variant());
+            list.back().swap(parts[c][i]);
+        }
+    }
+    return out;
+}
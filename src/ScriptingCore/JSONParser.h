@@ -0,0 +1,73 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_JSONPARSER
+#define H_FB_JSONPARSER
+
+#include <string>
+#include "APITypes.h"
+#include "JSExceptions.h"
+
+namespace FB {
+
+    FB_FORWARD_PTR(ThreadPool);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @exception json_parse_error
+    ///
+    /// @brief  Thrown by jsonToVariant when the input is not well-formed JSON; the message names
+    ///         the byte offset of the problem
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    struct json_parse_error : script_error
+    {
+        json_parse_error(const std::string& error) : script_error(error) { }
+        ~json_parse_error() throw() { }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn FB::variant jsonToVariant(const char* begin, const char* end)
+    ///
+    /// @brief  Parses JSON text straight into FB::variant structures in a single pass
+    ///
+    /// Unlike going through the bundled jsoncpp DOM and converting afterwards, this emits
+    /// VariantList/VariantMap/strings/numbers directly as it scans, so a payload is traversed
+    /// once and the intermediate Json::Value tree (and its per-node allocations) never exists.
+    /// Objects become VariantMap, arrays VariantList, null FBNull; numbers land as int when they
+    /// fit and double otherwise.  Throws json_parse_error on malformed input.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    FB::variant jsonToVariant(const char* begin, const char* end);
+
+    /// Convenience overload for a whole string
+    /// @since 1.5
+    FB::variant jsonToVariant(const std::string& json);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn FB::variant jsonToVariant(const std::string& json, const ThreadPoolPtr& pool)
+    ///
+    /// @brief  Like jsonToVariant, but large top-level arrays parse in parallel on the pool
+    ///
+    /// When the document is a big array (the shape of our catalog payloads), a cheap
+    /// string-aware scan finds the element boundaries and the elements are parsed in
+    /// per-worker chunks; results are spliced back in order with variant::swap, so nothing
+    /// is deep-copied.  Anything that isn't a large array falls through to the serial parse,
+    /// as does a missing or single-threaded pool.  Pass FactoryBase::getThreadPool().
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    FB::variant jsonToVariant(const std::string& json, const ThreadPoolPtr& pool);
+};
+
+#endif // H_FB_JSONPARSER
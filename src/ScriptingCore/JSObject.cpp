@@ -13,6 +13,8 @@ Copyright 2009 Richard Bateman, Firebreath development team
 \**********************************************************/
 
 #include "JSObject.h"
+#include "JSONParser.h"
+#include "DOM/Window.h"
 
 using namespace FB;
 
@@ -32,7 +34,36 @@ void JSObject::SetPropertyAsync(const std::string& propertyName, const variant&
 
 void JSObject::InvokeAsync(const std::string& methodName, const std::vector<variant>& args)
 {
-    host->ScheduleOnMainThread(shared_ptr(), boost::bind((FB::InvokeType)&JSAPI::Invoke, this, methodName, args));
+    InvokeAsync(methodName, args, std::string());
+}
+
+void JSObject::InvokeAsync(const std::string& methodName, const std::vector<variant>& args,
+    const std::string& coalesceKey)
+{
+    // Routed through the host's invoke queue: calls queued in one burst drain in
+    // one main-thread batch, the queue can be bounded against main-thread stalls
+    // (see setAsyncInvokeQueueLimit), and the key enables latest-wins coalescing
+    host->scheduleInvoke(FB::ptr_cast<JSObject>(shared_ptr()), methodName, args, coalesceKey);
+}
+
+FB::variant JSObject::DeepClone(const FB::JSObjectPtr& src)
+{
+    if (!src || !src->host)
+        throw FB::script_error("No browser host available for structured clone");
+    FB::DOM::WindowPtr window(src->host->getDOMWindow());
+    if (!window)
+        throw FB::script_error("No DOM window available for structured clone");
+    // window.JSON.stringify(src) is the whole object graph in one crossing;
+    // the parse back into variants is a single pass with no browser calls
+    FB::JSObjectPtr json(window->getProperty<FB::JSObjectPtr>("JSON"));
+    if (!json)
+        throw FB::script_error("JSON object not available for structured clone");
+    FB::VariantList args;
+    args.push_back(src);
+    FB::variant text(json->Invoke("stringify", args));
+    if (!text.is_of_type<std::string>())
+        throw FB::script_error("JSON.stringify did not return a string");
+    return FB::jsonToVariant(text.cast<std::string>());
 }
 
 //FB::JSObjectPtr FB::JSObject::Construct( const std::wstring& memberName, const std::vector<variant>& args )
@@ -76,6 +76,45 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         virtual void InvokeAsync(const std::string& methodName, const std::vector<variant>& args);
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @overload
+        ///
+        /// @brief  InvokeAsync with a coalesce key for the host's bounded invoke queue
+        ///
+        /// When the BrowserHost is configured with the coalesce-by-key overflow policy, a call
+        /// queued with the same key as one still waiting replaces it instead of queueing behind
+        /// it -- give every progress event for a stream the same key and a stalled main thread
+        /// only ever sees the latest one.
+        ///
+        /// @param  methodName  Name of the method
+        /// @param  args        The arguments
+        /// @param  coalesceKey Latest-wins coalescing key ("" = never coalesced)
+        /// @see FB::BrowserHost::setAsyncInvokeQueueLimit
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual void InvokeAsync(const std::string& methodName, const std::vector<variant>& args,
+            const std::string& coalesceKey);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn virtual variant InvokeDefault(const std::vector<variant>& args)
+        ///
+        /// @brief  Calls this object as a function
+        ///
+        /// Equivalent to Invoke("", args) -- the empty method name is the calling convention for
+        /// invoking a javascript function object -- but lets the browser glue skip the name
+        /// lookup and dispatch straight to the default-invoke entry point.  Prefer this for
+        /// high-frequency callbacks (progress handlers and the like); the base implementation
+        /// simply forwards to Invoke, so it is always safe to call.
+        ///
+        /// @param  args    The arguments
+        /// @return result of the call
+        /// @since 1.5
+        /// @see Invoke
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        virtual variant InvokeDefault(const std::vector<variant>& args) {
+            return Invoke("", args);
+        }
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn virtual void SetPropertyAsync(const std::string& propertyName, const variant& value)
         ///
@@ -116,7 +155,33 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         template<class Dict>
         static void GetObjectValues(const FB::JSObjectPtr& src, Dict& dst);
-    
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn static FB::variant DeepClone(const FB::JSObjectPtr& src)
+        ///
+        /// @brief  Clones a plain javascript object into variants in one browser crossing
+        ///
+        /// Serializes src browser-side with window.JSON.stringify and parses the text straight
+        /// into VariantMap/VariantList structures, so a 50-field options object costs one
+        /// stringify call instead of 50 GetProperty round trips.  The clone has JSON semantics:
+        /// functions and host objects are dropped, cycles throw.  Throws script_error when the
+        /// object has no host or JSON is unavailable.
+        /// @since 1.5
+        /// @see BrowserHost::setStructuredCloneEnabled
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        static FB::variant DeepClone(const FB::JSObjectPtr& src);
+
+        /// Structured-clone attempt behind the convert_cast glue: fills dst via DeepClone and
+        /// returns true, or returns false (dst untouched) so the caller can fall back to the
+        /// per-property walk.  Only tries when the host opted in
+        /// @since 1.5
+        template<class Dict>
+        static bool TryStructuredClone(const FB::JSObjectPtr& src, Dict& dst);
+        /// Array counterpart of TryStructuredClone
+        /// @since 1.5
+        template<class Cont>
+        static bool TryStructuredCloneArray(const FB::JSObjectPtr& src, Cont& dst);
+
     public:
         /// @brief Get associated FB::JSAPI.
         virtual JSAPIPtr getJSAPI() const = 0;
@@ -164,6 +229,57 @@ namespace FB
         }
     }
     
+    template<class Dict>
+    bool JSObject::TryStructuredClone(const FB::JSObjectPtr& src, Dict& dst)
+    {
+        typedef typename Dict::mapped_type MappedType;
+        if (!src || !src->host || !src->host->isStructuredCloneEnabled())
+            return false;
+        try {
+            FB::variant cloned(DeepClone(src));
+            if (!cloned.is_of_type<FB::VariantMap>())
+                return false;
+            const FB::VariantMap& map = cloned.cast<FB::VariantMap>();
+            // fill a scratch first so dst stays untouched if a value refuses to convert
+            Dict tmp;
+            std::insert_iterator<Dict> inserter(tmp, tmp.begin());
+            for (FB::VariantMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+                *inserter++ = std::make_pair(it->first, it->second.convert_cast<MappedType>());
+            }
+            dst.swap(tmp);
+            return true;
+        } catch (const FB::script_error&) {
+            return false;   // stringify unavailable or unhappy; walk instead
+        } catch (const FB::bad_variant_cast&) {
+            return false;
+        }
+    }
+
+    template<class Cont>
+    bool JSObject::TryStructuredCloneArray(const FB::JSObjectPtr& src, Cont& dst)
+    {
+        typedef typename Cont::value_type ValueType;
+        if (!src || !src->host || !src->host->isStructuredCloneEnabled())
+            return false;
+        try {
+            FB::variant cloned(DeepClone(src));
+            if (!cloned.is_of_type<FB::VariantList>())
+                return false;
+            const FB::VariantList& list = cloned.cast<FB::VariantList>();
+            Cont tmp;
+            std::back_insert_iterator<Cont> inserter(tmp);
+            for (FB::VariantList::const_iterator it = list.begin(); it != list.end(); ++it) {
+                *inserter++ = it->convert_cast<ValueType>();
+            }
+            dst.swap(tmp);
+            return true;
+        } catch (const FB::script_error&) {
+            return false;
+        } catch (const FB::bad_variant_cast&) {
+            return false;
+        }
+    }
+
     namespace variant_detail { namespace conversion {
         // Convert in
         template <class T>
@@ -258,7 +374,10 @@ namespace FB
             // if it is a JavaScript object try to treat it as an array
 
             Cont cont;
-            FB::JSObject::GetArrayValues(var.convert_cast<JsObject>(), cont);
+            FB::JSObjectPtr obj(var.convert_cast<JsObject>());
+            // one-crossing structured clone when the host opted in; element-wise walk otherwise
+            if (!FB::JSObject::TryStructuredCloneArray(obj, cont))
+                FB::JSObject::GetArrayValues(obj, cont);
             return cont;
         }
 
@@ -281,7 +400,10 @@ namespace FB
             // if it is a JavaScript object try to treat it as an array
 
             Dict dict;
-            FB::JSObject::GetObjectValues(var.convert_cast<JsObject>(), dict);
+            FB::JSObjectPtr obj(var.convert_cast<JsObject>());
+            // one-crossing structured clone when the host opted in; field-wise walk otherwise
+            if (!FB::JSObject::TryStructuredClone(obj, dict))
+                FB::JSObject::GetObjectValues(obj, dict);
             return dict;
         }
     } }
@@ -0,0 +1,185 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <boost/scoped_ptr.hpp>
+#include "BrowserHost.h"
+#include "CrossThreadCall.h"
+#include "variant_list.h"
+#include "variant_map.h"
+
+#include "MainThreadWatchdog.h"
+
+FB::MainThreadWatchdog::MainThreadWatchdog(const FB::BrowserHostWeakPtr& host,
+    unsigned int periodMs, unsigned int thresholdMs)
+    : m_host(host), m_periodMs(periodMs ? periodMs : 1000),
+      m_thresholdMs(thresholdMs ? thresholdMs : 250),
+      m_shutdown(false), m_pongReceived(true), m_beats(0), m_stalls(0),
+      m_lastLatencyUs(0), m_worstLatencyUs(0), m_stallPos(0)
+{
+}
+
+FB::MainThreadWatchdog::~MainThreadWatchdog()
+{
+    shutdown();
+}
+
+void FB::MainThreadWatchdog::start()
+{
+    m_thread = boost::thread(boost::bind(&FB::MainThreadWatchdog::run, this));
+}
+
+void FB::MainThreadWatchdog::shutdown()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        if (m_shutdown) {
+            return;
+        }
+        m_shutdown = true;
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void FB::MainThreadWatchdog::heartbeatCallback(void* userData)
+{
+    boost::scoped_ptr<MainThreadWatchdogWeakPtr> token(static_cast<MainThreadWatchdogWeakPtr*>(userData));
+    MainThreadWatchdogPtr watchdog(token->lock());
+    if (watchdog) {
+        watchdog->onHeartbeat();
+    }
+}
+
+void FB::MainThreadWatchdog::onHeartbeat()
+{
+    // Runs on the main thread; all the pong does is report how long it waited
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_pongReceived = true;
+        m_lastLatencyUs = static_cast<long>(
+            (boost::posix_time::microsec_clock::universal_time() - m_pingSent).total_microseconds());
+        if (m_lastLatencyUs > m_worstLatencyUs) {
+            m_worstLatencyUs = m_lastLatencyUs;
+        }
+    }
+    m_cond.notify_all();
+}
+
+void FB::MainThreadWatchdog::run()
+{
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while (!m_shutdown) {
+        // Send one ping; never more than one outstanding, so a stalled main
+        // thread is probed, not flooded
+        m_pingSent = boost::posix_time::microsec_clock::universal_time();
+        m_pongReceived = false;
+        ++m_beats;
+        const boost::system_time sentAt = boost::get_system_time();
+        lock.unlock();
+        bool scheduled = false;
+        {
+            BrowserHostPtr host(m_host.lock());
+            if (host) {
+                MainThreadWatchdogWeakPtr* token = new MainThreadWatchdogWeakPtr(shared_from_this());
+                scheduled = host->ScheduleAsyncCall(&MainThreadWatchdog::heartbeatCallback, token);
+                if (!scheduled) {
+                    delete token;
+                }
+            }
+        }
+        lock.lock();
+        if (!scheduled) {
+            // Host is gone or shutting down; nothing left to watch
+            m_shutdown = true;
+            break;
+        }
+
+        // Wait for the pong up to the stall threshold
+        const boost::system_time deadline = sentAt + boost::posix_time::milliseconds(m_thresholdMs);
+        while (!m_shutdown && !m_pongReceived && boost::get_system_time() < deadline) {
+            m_cond.timed_wait(lock, deadline);
+        }
+
+        if (!m_shutdown && !m_pongReceived) {
+            // Stall in progress: capture what the main thread is doing right
+            // now -- afterwards would only tell us what it did next
+            StallRecord record;
+            record.when = boost::posix_time::microsec_clock::universal_time();
+            CrossThreadCallStats& stats(CrossThreadCallStats::getInstance());
+            std::string label;
+            long runningUs(0);
+            if (stats.currentCall(label, runningUs)) {
+                record.currentCall = label;
+                record.runningUs = runningUs;
+            }
+            record.queueDepth = stats.depth();
+
+            // Keep waiting for the pong so the record carries the real stall
+            // duration, not just "longer than the threshold"
+            while (!m_shutdown && !m_pongReceived) {
+                m_cond.timed_wait(lock, boost::get_system_time() + boost::posix_time::milliseconds(m_periodMs));
+            }
+            record.stallUs = m_pongReceived ? m_lastLatencyUs
+                : static_cast<long>((boost::posix_time::microsec_clock::universal_time()
+                    - m_pingSent).total_microseconds());
+            ++m_stalls;
+            if (m_stallRing.size() < StallRingSize) {
+                m_stallRing.push_back(record);
+            } else {
+                m_stallRing[m_stallPos] = record;
+                m_stallPos = (m_stallPos + 1) % StallRingSize;
+            }
+        }
+
+        // Sleep out the rest of the period, measured from the ping
+        const boost::system_time next = sentAt + boost::posix_time::milliseconds(m_periodMs);
+        while (!m_shutdown && boost::get_system_time() < next) {
+            m_cond.timed_wait(lock, next);
+        }
+    }
+}
+
+FB::VariantMap FB::MainThreadWatchdog::report() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    FB::VariantMap out;
+    out["enabled"] = !m_shutdown;
+    out["periodMs"] = static_cast<int>(m_periodMs);
+    out["thresholdMs"] = static_cast<int>(m_thresholdMs);
+    // counters go out as doubles; that's what they become in JS anyway
+    out["beats"] = static_cast<double>(m_beats);
+    out["stalls"] = static_cast<double>(m_stalls);
+    out["lastLatencyUs"] = m_lastLatencyUs;
+    out["worstLatencyUs"] = m_worstLatencyUs;
+
+    const boost::posix_time::ptime now(boost::posix_time::microsec_clock::universal_time());
+    FB::VariantList records;
+    // oldest first: the ring starts at m_stallPos once it has wrapped
+    const size_t count = m_stallRing.size();
+    const size_t start = (count < StallRingSize) ? 0 : m_stallPos;
+    for (size_t i = 0; i < count; ++i) {
+        const StallRecord& rec = m_stallRing[(start + i) % count];
+        FB::VariantMap entry;
+        entry["msAgo"] = static_cast<double>((now - rec.when).total_milliseconds());
+        entry["stallUs"] = rec.stallUs;
+        entry["queueDepth"] = static_cast<int>(rec.queueDepth);
+        entry["currentCall"] = rec.currentCall;
+        entry["currentCallRunningUs"] = rec.runningUs;
+        records.push_back(entry);
+    }
+    out["stallRecords"] = records;
+    return out;
+}
@@ -0,0 +1,98 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_MAINTHREADWATCHDOG
+#define H_FB_MAINTHREADWATCHDOG
+
+#include <string>
+#include <vector>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include "APITypes.h"
+
+namespace FB {
+
+    FB_FORWARD_PTR(MainThreadWatchdog);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  MainThreadWatchdog
+    ///
+    /// @brief  Heartbeat monitor that turns main-thread stalls into diagnosable records
+    ///
+    /// A service thread schedules a trivial heartbeat onto the main thread every period and
+    /// measures how long the pong takes.  When a heartbeat misses the stall threshold, the
+    /// watchdog captures what the main thread was doing at that moment -- the cross-thread
+    /// functor currently executing (if any, via CrossThreadCallStats::currentCall) and the
+    /// queue depth -- into a fixed ring of stall records.  Reading the ring via
+    /// BrowserHost::getWatchdogReport from page JS or a support tool tells you whether a jank
+    /// report is our functor, a backed-up framework queue, or the page itself.  You will
+    /// normally not use this class directly; see BrowserHost::startMainThreadWatchdog.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class MainThreadWatchdog : public boost::enable_shared_from_this<MainThreadWatchdog>, boost::noncopyable
+    {
+    public:
+        MainThreadWatchdog(const BrowserHostWeakPtr& host, unsigned int periodMs, unsigned int thresholdMs);
+        ~MainThreadWatchdog();
+
+        /// Spawns the heartbeat thread; call once, after construction
+        void start();
+        /// Stops the heartbeat thread and joins it; further reports return the frozen state
+        void shutdown();
+        /// Configuration, counters, latest/worst latency and the stall ring as a VariantMap
+        FB::VariantMap report() const;
+
+    protected:
+        struct StallRecord {
+            StallRecord() : stallUs(0), runningUs(0), queueDepth(0) { }
+            boost::posix_time::ptime when;
+            long stallUs;
+            // typeid name of the functor the main thread was inside, or "" if it
+            // was stalled outside the framework (page JS, browser internals)
+            std::string currentCall;
+            long runningUs;
+            size_t queueDepth;
+        };
+
+        static void heartbeatCallback(void* userData);
+        void onHeartbeat();
+        void run();
+
+        // Stall records kept; old ones are overwritten, support cases rarely need more
+        static const size_t StallRingSize = 32;
+
+        BrowserHostWeakPtr m_host;
+        const unsigned int m_periodMs;
+        const unsigned int m_thresholdMs;
+
+        mutable boost::mutex m_mutex;
+        boost::condition_variable m_cond;
+        bool m_shutdown;
+        bool m_pongReceived;
+        boost::posix_time::ptime m_pingSent;
+        boost::uint64_t m_beats;
+        boost::uint64_t m_stalls;
+        long m_lastLatencyUs;
+        long m_worstLatencyUs;
+        std::vector<StallRecord> m_stallRing;
+        size_t m_stallPos;
+        // Must be constructed by start(), not the constructor; run() needs
+        // shared_from_this and the object must be owned by a shared_ptr first
+        boost::thread m_thread;
+    };
+}
+
+#endif // H_FB_MAINTHREADWATCHDOG
@@ -0,0 +1,54 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include "variant_list.h"
+
+#include "MemberProfiler.h"
+
+void FB::MemberProfiler::record(const std::string& member, long usec, size_t bytes)
+{
+    Record& r = m_records[member];
+    ++r.calls;
+    if (usec < 0)
+        usec = 0;
+    r.totalUs += usec;
+    r.bytes += bytes;
+    size_t bucket = 0;
+    unsigned long v = static_cast<unsigned long>(usec);
+    while (v >>= 1)
+        ++bucket;
+    if (bucket >= BucketCount)
+        bucket = BucketCount - 1;
+    ++r.buckets[bucket];
+}
+
+FB::VariantMap FB::MemberProfiler::snapshot() const
+{
+    // counters go out as doubles; that's what they become in JS anyway
+    FB::VariantMap out;
+    for (RecordMap::const_iterator it = m_records.begin(); it != m_records.end(); ++it) {
+        const Record& r = it->second;
+        FB::VariantMap entry;
+        entry["calls"] = static_cast<double>(r.calls);
+        entry["totalUs"] = static_cast<double>(r.totalUs);
+        entry["bytes"] = static_cast<double>(r.bytes);
+        FB::VariantList hist;
+        hist.reserve(BucketCount);
+        for (size_t i = 0; i < BucketCount; ++i)
+            hist.push_back(static_cast<int>(r.buckets[i]));
+        entry["histogram"] = hist;
+        out[it->first] = entry;
+    }
+    return out;
+}
@@ -0,0 +1,76 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_MEMBERPROFILER
+#define H_FB_MEMBERPROFILER
+
+#include <map>
+#include <string>
+#include <boost/cstdint.hpp>
+#include "APITypes.h"
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  MemberProfiler
+    ///
+    /// @brief  Per-member invocation statistics for a JSAPIAuto object
+    ///
+    /// Collects call counts, a log-bucketed latency histogram (fixed memory: 20 power-of-two
+    /// microsecond buckets per member) and an approximate marshaled-bytes counter.  JSAPIAuto
+    /// owns one of these when profiling is enabled and feeds it from Invoke / GetProperty /
+    /// SetProperty; telemetry JS scrapes the numbers through the reserved getMemberProfile()
+    /// member.  All access happens under the owning object's zone lock, so the profiler
+    /// itself carries no lock.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class MemberProfiler
+    {
+    public:
+        static const size_t BucketCount = 20;
+
+        struct Record {
+            Record() : calls(0), totalUs(0), bytes(0)
+            {
+                for (size_t i = 0; i < BucketCount; ++i)
+                    buckets[i] = 0;
+            }
+            boost::uint64_t calls;
+            boost::uint64_t totalUs;
+            boost::uint64_t bytes;
+            boost::uint32_t buckets[BucketCount];   // bucket i: latency in [2^i, 2^(i+1)) us
+        };
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void record(const std::string& member, long usec, size_t bytes)
+        ///
+        /// @brief  Accounts one invocation: a counter bump, one histogram increment, byte add
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void record(const std::string& member, long usec, size_t bytes);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::VariantMap snapshot() const
+        ///
+        /// @brief  Returns {member: {calls, totalUs, bytes, histogram: [..20 buckets..]}}
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::VariantMap snapshot() const;
+
+    private:
+        typedef std::map<std::string, Record> RecordMap;
+        RecordMap m_records;
+    };
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cstring>
+#include <boost/thread/mutex.hpp>
+
+#include "MemoryAccounting.h"
+
+namespace
+{
+    // One mutex for all categories: accounting is only compiled into diagnostic
+    // builds, where simplicity beats shaving the lock
+    boost::mutex g_mutex;
+    FB::Memory::CategoryStats g_stats[FB::Memory::CategoryCount];
+}
+
+const char* FB::Memory::categoryName(Category cat)
+{
+    switch (cat) {
+        case Category_VariantPayload: return "variantPayload";
+        case Category_RetainedJSAPI:  return "retainedJSAPI";
+        case Category_StreamBuffer:   return "streamBuffer";
+        default:                      return "unknown";
+    }
+}
+
+void FB::Memory::getStats(CategoryStats (&out)[CategoryCount])
+{
+    boost::mutex::scoped_lock lock(g_mutex);
+    std::memcpy(out, g_stats, sizeof(g_stats));
+}
+
+void FB::Memory::recordAlloc(Category cat, size_t bytes)
+{
+    boost::mutex::scoped_lock lock(g_mutex);
+    CategoryStats& s = g_stats[cat];
+    s.liveBytes += bytes;
+    ++s.liveCount;
+    ++s.totalAllocs;
+    if (s.liveBytes > s.peakBytes)
+        s.peakBytes = s.liveBytes;
+}
+
+void FB::Memory::recordFree(Category cat, size_t bytes)
+{
+    boost::mutex::scoped_lock lock(g_mutex);
+    CategoryStats& s = g_stats[cat];
+    s.liveBytes = (s.liveBytes >= bytes) ? s.liveBytes - bytes : 0;
+    if (s.liveCount)
+        --s.liveCount;
+}
@@ -0,0 +1,73 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_MEMORYACCOUNTING
+#define H_FB_MEMORYACCOUNTING
+
+#include <cstddef>
+
+namespace FB { namespace Memory {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief  Per-category allocation accounting for the framework's long-lived memory
+    ///
+    /// Builds that define FB_MEMORY_ACCOUNTING get live-bytes/peak-bytes/live-count counters for
+    /// the allocation classes a plugin cannot attribute from the outside: heap-boxed variant
+    /// payloads, entries in BrowserHost's retained-object list, and stream block-cache buffers.
+    /// Call sites use accountAlloc/accountFree, which compile to nothing when the flag is off, so
+    /// shipping builds pay zero.  Read the counters through BrowserHost::getMemoryStats() or dump
+    /// them to the page with BrowserHost::dumpMemoryStats().
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    enum Category {
+        /// variant payloads too big for the inline storage (big_box allocations)
+        Category_VariantPayload = 0,
+        /// entries in BrowserHost's retained-object list; the count is the useful
+        /// number here, the byte figure only covers the bookkeeping entry itself
+        Category_RetainedJSAPI,
+        /// stream block-cache buffers (see FB::StreamBlockCache)
+        Category_StreamBuffer,
+        CategoryCount
+    };
+
+    struct CategoryStats {
+        unsigned long long liveBytes;
+        unsigned long long peakBytes;
+        unsigned long long liveCount;
+        unsigned long long totalAllocs;
+    };
+
+    /// Short stable name for a category, used as the key in stat maps and log lines
+    const char* categoryName(Category cat);
+
+    // Always linked so telemetry code works in every build; the counters just stay
+    // zero when accounting is compiled out
+    void getStats(CategoryStats (&out)[CategoryCount]);
+
+    void recordAlloc(Category cat, size_t bytes);
+    void recordFree(Category cat, size_t bytes);
+
+#ifdef FB_MEMORY_ACCOUNTING
+    inline void accountAlloc(Category cat, size_t bytes) { recordAlloc(cat, bytes); }
+    inline void accountFree(Category cat, size_t bytes) { recordFree(cat, bytes); }
+#else
+    // accounting compiled out: the hooks vanish and hot paths pay nothing
+    inline void accountAlloc(Category, size_t) { }
+    inline void accountFree(Category, size_t) { }
+#endif
+
+}; };
+
+#endif
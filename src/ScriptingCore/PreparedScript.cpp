@@ -0,0 +1,41 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include "JSObject.h"
+#include "JSExceptions.h"
+
+#include "PreparedScript.h"
+
+FB::PreparedScript::PreparedScript(const FB::JSObjectPtr& func)
+    : m_func(func)
+{
+}
+
+FB::PreparedScript::~PreparedScript()
+{
+}
+
+bool FB::PreparedScript::isValid() const
+{
+    return m_func ? true : false;
+}
+
+FB::variant FB::PreparedScript::invoke(const FB::VariantList& args)
+{
+    if (!m_func)
+        throw FB::script_error("Prepared script handle is empty");
+    // Default-invoke the compiled function; JSObject handles cross-thread
+    // marshaling so this is safe from worker threads too
+    return m_func->Invoke("", args);
+}
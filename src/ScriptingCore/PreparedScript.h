@@ -0,0 +1,77 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_PREPAREDSCRIPT
+#define H_FB_PREPAREDSCRIPT
+
+#include "APITypes.h"
+
+namespace FB {
+
+    FB_FORWARD_PTR(PreparedScript);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  PreparedScript
+    ///
+    /// @brief  Handle to a javascript function compiled once and invoked many times
+    ///
+    /// Calling the same snippet thousands of times through evaluateJavaScript re-sends and re-parses
+    /// the source in the browser on every call.  A PreparedScript is created once from a function
+    /// expression (one evaluate to define it, see BrowserHost::prepareScript); after that each
+    /// invoke() goes through the regular object-call path against the browser-side compiled
+    /// function, which is the same fast path ordinary JSObject method calls use.
+    ///
+    /// invoke() may be called from any thread; cross-thread calls are marshaled to the main thread
+    /// the same way any JSObject call is.  The handle keeps the browser-side function alive for its
+    /// own lifetime; release the handle when you are done with the snippet.
+    /// @see BrowserHost::prepareScript
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class PreparedScript : boost::noncopyable
+    {
+    public:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn PreparedScript(const FB::JSObjectPtr& func)
+        ///
+        /// @brief  Wraps an already-compiled browser-side function; use BrowserHost::prepareScript
+        ///         rather than constructing this directly
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        PreparedScript(const FB::JSObjectPtr& func);
+        ~PreparedScript();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn FB::variant invoke(const FB::VariantList& args)
+        ///
+        /// @brief  Calls the prepared function with the given arguments and returns its result
+        ///
+        /// @param  args    Arguments to pass to the function
+        /// @return the function's return value
+        /// @throws FB::script_error if the call fails or the handle is no longer valid
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        FB::variant invoke(const FB::VariantList& args);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool isValid() const
+        ///
+        /// @brief  true if the handle still refers to a browser-side function
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool isValid() const;
+
+    protected:
+        FB::JSObjectPtr m_func;
+    };
+};
+
+#endif
@@ -0,0 +1,71 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_SMALLARGARRAY
+#define H_FB_SMALLARGARRAY
+
+#include <cstddef>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  SmallArgArray
+    ///
+    /// @brief  Fixed-capacity inline array with a heap fallback, sized at construction
+    ///
+    /// The invoke pipeline builds a temporary argument array (NPVariant, CComVariant) on every
+    /// scripted call, and nearly all calls carry four arguments or fewer; this keeps those in a
+    /// stack buffer and only allocates when the count exceeds the inline capacity.  Elements are
+    /// default-constructed exactly as a new[] array would be, so NPVariant stays uninitialized
+    /// POD and CComVariant is properly constructed either way.  The caller owns any per-element
+    /// cleanup (ReleaseVariantValue and the like), same as with the raw arrays this replaces.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    template <typename T, std::size_t N>
+    class SmallArgArray : boost::noncopyable
+    {
+    public:
+        explicit SmallArgArray(std::size_t count)
+            : m_data(m_inline), m_count(count)
+        {
+            if (count > N) {
+                m_heap.reset(new T[count]);
+                m_data = m_heap.get();
+            }
+        }
+
+        T* get() { return m_data; }
+        const T* get() const { return m_data; }
+        T& operator[](std::size_t idx) { return m_data[idx]; }
+        const T& operator[](std::size_t idx) const { return m_data[idx]; }
+        std::size_t size() const { return m_count; }
+        /// true while the elements live in the inline buffer (no allocation happened)
+        bool isInline() const { return m_data == m_inline; }
+
+    private:
+        T m_inline[N];
+        boost::scoped_array<T> m_heap;
+        T* m_data;
+        std::size_t m_count;
+    };
+
+    /// Inline capacity used by the invoke glue; covers the 0-4 argument calls that dominate
+    /// real traffic with room to spare
+    const std::size_t DefaultArgArraySize = 8;
+}
+
+#endif // H_FB_SMALLARGARRAY
@@ -0,0 +1,388 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2026 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STATICMEMBERTABLE
+#define H_FB_STATICMEMBERTABLE
+
+#include <string>
+#include <boost/function.hpp>
+#include <boost/unordered_map.hpp>
+#include "APITypes.h"
+#include "MethodConverter.h"
+#include "ConverterUtils.h"
+
+namespace FB
+{
+    class JSAPIAuto;
+
+    /// @brief  Method functor that has not been bound to an instance; the instance is
+    ///         supplied at call time, so one functor serves every object of the class
+    typedef boost::function<FB::variant (JSAPIAuto*, const std::vector<FB::variant>&)> UnboundMethodFunctor;
+    /// @brief  Unbound property getter; see FB::UnboundMethodFunctor
+    typedef boost::function<FB::variant (JSAPIAuto*)> UnboundGetPropFunctor;
+    /// @brief  Unbound property setter; see FB::UnboundMethodFunctor
+    typedef boost::function<void (JSAPIAuto*, const FB::variant&)> UnboundSetPropFunctor;
+
+    namespace detail { namespace members
+    {
+        // Adapts one of the instance-agnostic method_wrapperN functors (which expect the
+        // exact class type) to the JSAPIAuto* signature the static table stores
+        template<class C, class Wrapper>
+        struct unbound_method_shim
+        {
+            typedef FB::variant result_type;
+            Wrapper wrapped;
+            unbound_method_shim(const Wrapper& w) : wrapped(w) {}
+            FB::variant operator()(FB::JSAPIAuto* instance, const FB::VariantList& in)
+            {
+                return wrapped(static_cast<C*>(instance), in);
+            }
+        };
+
+        template<class C, class Wrapper>
+        inline unbound_method_shim<C, Wrapper> make_method_shim(const Wrapper& w)
+        {
+            return unbound_method_shim<C, Wrapper>(w);
+        }
+
+        template<class C, typename F>
+        struct unbound_getter
+        {
+            typedef FB::variant result_type;
+            F f;
+            unbound_getter(F f) : f(f) {}
+            FB::variant operator()(FB::JSAPIAuto* instance)
+            {
+                return (static_cast<C*>(instance)->*f)();
+            }
+        };
+
+        template<class C, typename T, typename F>
+        struct unbound_setter
+        {
+            typedef void result_type;
+            F f;
+            unbound_setter(F f) : f(f) {}
+            void operator()(FB::JSAPIAuto* instance, const FB::variant& v)
+            {
+                typedef typename FB::detail::plain_type<T>::type Ty;
+                typedef FB::detail::converter<Ty, FB::variant> converter;
+                (static_cast<C*>(instance)->*f)(converter::convert(v));
+            }
+        };
+
+        // read-only properties silently swallow assignments, matching the
+        // dummySetter used by make_property
+        inline void unboundDummySetter(FB::JSAPIAuto*, const FB::variant&)
+        {
+        }
+    } }
+
+    /// @brief  Bundles the unbound getter/setter pair produced by FB::make_unbound_property
+    struct UnboundPropertyFunctors {
+        UnboundGetPropFunctor get;
+        UnboundSetPropFunctor set;
+        UnboundPropertyFunctors(const UnboundGetPropFunctor& get, const UnboundSetPropFunctor& set)
+          : get(get), set(set) {}
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  StaticMemberTable
+    ///
+    /// @brief  Declarative, per-class member table for FB::JSAPIAuto
+    ///
+    /// registerMethod/registerProperty build the full member maps for every instance, which adds
+    /// up when many short-lived API objects expose the same members.  A StaticMemberTable is built
+    /// once (typically in a function-local static) and shared by every instance of the class;
+    /// JSAPIAuto consults it whenever a member is not found in the per-instance maps, so the
+    /// per-instance registration cost disappears for members declared here.  Per-instance
+    /// registrations still work and shadow table entries of the same name.
+    ///
+    /// @code
+    /// class MyAPI : public FB::JSAPIAuto {
+    /// public:
+    ///     MyAPI() { setMemberTable(getMemberTable()); }
+    ///     static const FB::StaticMemberTable& getMemberTable() {
+    ///         static FB::StaticMemberTable table = FB::StaticMemberTable()
+    ///             .method("add", FB::make_unbound_method(&MyAPI::add))
+    ///             .property("answer", FB::make_unbound_property(&MyAPI::get_answer,
+    ///                                                           &MyAPI::set_answer));
+    ///         return table;
+    ///     }
+    ///     long add(long a, long b);
+    ///     long get_answer();
+    ///     void set_answer(long a);
+    /// };
+    /// @endcode
+    ///
+    /// @since 1.5
+    /// @see FB::JSAPIAuto::setMemberTable
+    /// @see FB::make_unbound_method
+    /// @see FB::make_unbound_property
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class StaticMemberTable
+    {
+    public:
+        struct Method {
+            UnboundMethodFunctor call;
+            SecurityZone zone;
+        };
+        struct Property {
+            UnboundGetPropFunctor get;
+            UnboundSetPropFunctor set;
+            SecurityZone zone;
+        };
+        typedef boost::unordered_map<std::string, Method> MethodMap;
+        typedef boost::unordered_map<std::string, Property> PropertyMap;
+
+        /// @brief  Adds a method to the table; returns *this so declarations can be chained
+        StaticMemberTable& method(const std::string& name, const UnboundMethodFunctor& func,
+            const SecurityZone& zone = SecurityScope_Public)
+        {
+            Method m = { func, zone };
+            m_methods[name] = m;
+            return *this;
+        }
+
+        /// @brief  Adds a property to the table; returns *this so declarations can be chained
+        StaticMemberTable& property(const std::string& name, const UnboundPropertyFunctors& prop,
+            const SecurityZone& zone = SecurityScope_Public)
+        {
+            Property p = { prop.get, prop.set, zone };
+            m_properties[name] = p;
+            return *this;
+        }
+
+        const Method* findMethod(const std::string& name) const {
+            MethodMap::const_iterator fnd = m_methods.find(name);
+            return (fnd != m_methods.end()) ? &fnd->second : NULL;
+        }
+        const Property* findProperty(const std::string& name) const {
+            PropertyMap::const_iterator fnd = m_properties.find(name);
+            return (fnd != m_properties.end()) ? &fnd->second : NULL;
+        }
+
+        const MethodMap& methods() const { return m_methods; }
+        const PropertyMap& properties() const { return m_properties; }
+
+    private:
+        MethodMap m_methods;
+        PropertyMap m_properties;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn template<class C, class R> FB::UnboundMethodFunctor make_unbound_method(R (C::*function)())
+    ///
+    /// @brief  Like FB::make_method, but does not bind an instance; for use with
+    ///         FB::StaticMemberTable.  Overloads exist for methods taking up to 10 arguments.
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template<class C, class R>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)())
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper0<C, R, R (C::*)()>(function));
+    }
+    template<class C, class R>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)() const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper0<C, R, R (C::*)() const>(function));
+    }
+    template<class C, class R, class T0>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper1<C, R, T0, R (C::*)(T0)>(function));
+    }
+    template<class C, class R, class T0>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper1<C, R, T0, R (C::*)(T0) const>(function));
+    }
+    template<class C, class R, class T0, class T1>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper2<C, R, T0, T1, R (C::*)(T0, T1)>(function));
+    }
+    template<class C, class R, class T0, class T1>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper2<C, R, T0, T1, R (C::*)(T0, T1) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper3<C, R, T0, T1, T2, R (C::*)(T0, T1, T2)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper3<C, R, T0, T1, T2, R (C::*)(T0, T1, T2) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper4<C, R, T0, T1, T2, T3, R (C::*)(T0, T1, T2, T3)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper4<C, R, T0, T1, T2, T3, R (C::*)(T0, T1, T2, T3) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper5<C, R, T0, T1, T2, T3, T4, R (C::*)(T0, T1, T2, T3, T4)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper5<C, R, T0, T1, T2, T3, T4, R (C::*)(T0, T1, T2, T3, T4) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper6<C, R, T0, T1, T2, T3, T4, T5, R (C::*)(T0, T1, T2, T3, T4, T5)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper6<C, R, T0, T1, T2, T3, T4, T5, R (C::*)(T0, T1, T2, T3, T4, T5) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper7<C, R, T0, T1, T2, T3, T4, T5, T6, R (C::*)(T0, T1, T2, T3, T4, T5, T6)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper7<C, R, T0, T1, T2, T3, T4, T5, T6, R (C::*)(T0, T1, T2, T3, T4, T5, T6) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6, T7))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper8<C, R, T0, T1, T2, T3, T4, T5, T6, T7, R (C::*)(T0, T1, T2, T3, T4, T5, T6, T7)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6, T7) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper8<C, R, T0, T1, T2, T3, T4, T5, T6, T7, R (C::*)(T0, T1, T2, T3, T4, T5, T6, T7) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6, T7, T8))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper9<C, R, T0, T1, T2, T3, T4, T5, T6, T7, T8, R (C::*)(T0, T1, T2, T3, T4, T5, T6, T7, T8)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6, T7, T8) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper9<C, R, T0, T1, T2, T3, T4, T5, T6, T7, T8, R (C::*)(T0, T1, T2, T3, T4, T5, T6, T7, T8) const>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6, T7, T8, T9))
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper10<C, R, T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, R (C::*)(T0, T1, T2, T3, T4, T5, T6, T7, T8, T9)>(function));
+    }
+    template<class C, class R, class T0, class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9>
+    inline UnboundMethodFunctor
+    make_unbound_method(R (C::*function)(T0, T1, T2, T3, T4, T5, T6, T7, T8, T9) const)
+    {
+        return detail::members::make_method_shim<C>(
+            FB::detail::methods::method_wrapper10<C, R, T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, R (C::*)(T0, T1, T2, T3, T4, T5, T6, T7, T8, T9) const>(function));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn template<class C, typename R, typename T> FB::UnboundPropertyFunctors make_unbound_property(R (C::*getter)(), void (C::*setter)(T))
+    ///
+    /// @brief  Like FB::make_property, but does not bind an instance; for use with
+    ///         FB::StaticMemberTable.  Omit the setter for a read-only property.
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template<class C, typename R, typename T>
+    inline UnboundPropertyFunctors
+    make_unbound_property(R (C::*getter)(), void (C::*setter)(T))
+    {
+        return UnboundPropertyFunctors(
+            detail::members::unbound_getter<C, R (C::*)()>(getter),
+            detail::members::unbound_setter<C, T, void (C::*)(T)>(setter));
+    }
+    template<class C, typename R, typename T>
+    inline UnboundPropertyFunctors
+    make_unbound_property(R (C::*getter)() const, void (C::*setter)(T))
+    {
+        return UnboundPropertyFunctors(
+            detail::members::unbound_getter<C, R (C::*)() const>(getter),
+            detail::members::unbound_setter<C, T, void (C::*)(T)>(setter));
+    }
+    template<class C, typename R>
+    inline UnboundPropertyFunctors
+    make_unbound_property(R (C::*getter)())
+    {
+        return UnboundPropertyFunctors(
+            detail::members::unbound_getter<C, R (C::*)()>(getter),
+            &detail::members::unboundDummySetter);
+    }
+    template<class C, typename R>
+    inline UnboundPropertyFunctors
+    make_unbound_property(R (C::*getter)() const)
+    {
+        return UnboundPropertyFunctors(
+            detail::members::unbound_getter<C, R (C::*)() const>(getter),
+            &detail::members::unboundDummySetter);
+    }
+}
+
+#endif // H_FB_STATICMEMBERTABLE
@@ -0,0 +1,52 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <boost/unordered_set.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "StringIntern.h"
+
+namespace
+{
+    // unordered_set is node-based, so references to entries survive later
+    // inserts; combined with never erasing, that is what makes the returned
+    // references permanent
+    typedef boost::unordered_set<std::string> InternTable;
+
+    boost::shared_mutex& internLock()
+    {
+        static boost::shared_mutex lock;
+        return lock;
+    }
+    InternTable& internTable()
+    {
+        static InternTable table;
+        return table;
+    }
+}
+
+const std::string& FB::internString(const std::string& str)
+{
+    // Same double-checked pattern TypeIDMap uses: the common case is a hit
+    // under the shared lock, and only a brand-new string pays for exclusion
+    {
+        boost::shared_lock<boost::shared_mutex> readLock(internLock());
+        InternTable::const_iterator it = internTable().find(str);
+        if (it != internTable().end())
+            return *it;
+    }
+    boost::unique_lock<boost::shared_mutex> writeLock(internLock());
+    return *internTable().insert(str).first;
+}
@@ -0,0 +1,41 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STRINGINTERN
+#define H_FB_STRINGINTERN
+
+#include <string>
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn const std::string& internString(const std::string& str)
+    ///
+    /// @brief  Returns the canonical copy of a string from the process-wide intern table
+    ///
+    /// The table is append-only: entries are never removed, so the returned reference stays valid
+    /// for the life of the process and can be held by caches without copying.  Member names are the
+    /// intended use -- a page exposes a bounded set of them, and interning means each one is
+    /// converted and stored exactly once no matter how many layers handle it.  Lookups take a
+    /// shared (read) lock; only the first sight of a new string takes the write lock.
+    ///
+    /// @param  str The string to intern
+    /// @return reference to the canonical copy; valid forever
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    const std::string& internString(const std::string& str);
+};
+
+#endif
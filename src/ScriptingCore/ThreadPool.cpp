@@ -0,0 +1,88 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include "logging.h"
+
+#include "ThreadPool.h"
+
+FB::ThreadPool::ThreadPool(size_t numThreads)
+    : m_threadCount(numThreads), m_shutdown(false)
+{
+    if (!m_threadCount) {
+        m_threadCount = boost::thread::hardware_concurrency();
+    }
+    if (!m_threadCount) {
+        // hardware_concurrency can legitimately report 0; still give callers workers
+        m_threadCount = 2;
+    }
+    for (size_t i = 0; i < m_threadCount; ++i) {
+        m_threads.create_thread(boost::bind(&ThreadPool::run, this));
+    }
+}
+
+FB::ThreadPool::~ThreadPool()
+{
+    shutdown();
+}
+
+bool FB::ThreadPool::post(const TaskType& task)
+{
+    if (!task) {
+        return false;
+    }
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        if (m_shutdown) {
+            return false;
+        }
+    }
+    m_queue.push(task);
+    return true;
+}
+
+void FB::ThreadPool::shutdown()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        if (m_shutdown) {
+            return;
+        }
+        m_shutdown = true;
+    }
+    // One empty task per worker; they queue behind anything already submitted,
+    // so pending work still drains before the threads exit
+    for (size_t i = 0; i < m_threadCount; ++i) {
+        m_queue.push(TaskType());
+    }
+    m_threads.join_all();
+}
+
+void FB::ThreadPool::run()
+{
+    for (;;) {
+        TaskType task;
+        m_queue.wait_and_pop(task);
+        if (!task) {
+            // Shutdown sentinel
+            return;
+        }
+        try {
+            task();
+        } catch (const std::exception& e) {
+            FBLOG_ERROR("ThreadPool", "Task threw exception: " << e.what());
+        } catch (...) {
+            FBLOG_ERROR("ThreadPool", "Task threw non-standard exception");
+        }
+    }
+}
@@ -0,0 +1,106 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_THREADPOOL
+#define H_FB_THREADPOOL
+
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include "APITypes.h"
+#include "SafeQueue.h"
+#include "CrossThreadCall.h"
+
+namespace FB {
+
+    FB_FORWARD_PTR(ThreadPool);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  ThreadPool
+    ///
+    /// @brief  Fixed-size pool of worker threads for plugin background work
+    ///
+    /// Get the framework's shared pool from FactoryBase::getThreadPool() rather than constructing
+    /// your own; that way every plugin in the process shares one correctly-sized set of workers.
+    /// submit() returns the same AsyncCallResult handle that CallOnMainThreadAsync uses, so the
+    /// caller can poll ready(), block in get() (which rethrows any exception the task raised as a
+    /// script_error), or chain a continuation with then().  To hop a completion back to the main
+    /// thread, have the continuation schedule it on the BrowserHost:
+    /// @code
+    ///      void postDecoded(FB::BrowserHostPtr host, MyAPIPtr api, const ImagePtr& img) {
+    ///          host->ScheduleOnMainThread(api, boost::bind(&MyAPI::onDecoded, api, img));
+    ///      }
+    ///      pool->submit(boost::bind(&decodeImage, data))
+    ///          ->then(boost::bind(&postDecoded, m_host, api, _1));
+    /// @endcode
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ThreadPool : boost::noncopyable
+    {
+    public:
+        /// Task type for fire-and-forget work posted with post()
+        typedef boost::function<void ()> TaskType;
+
+        /// Creates the pool; numThreads of 0 sizes it to the machine's core count
+        explicit ThreadPool(size_t numThreads = 0);
+        /// Drains queued tasks and joins the workers
+        ~ThreadPool();
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn template<class Functor> boost::shared_ptr<AsyncCallResult<typename Functor::result_type> > submit(Functor func)
+        ///
+        /// @brief  Queues func to run on a worker thread and returns a result handle
+        ///
+        /// @param  func    The functor to execute, created with boost::bind
+        ///
+        /// @return shared_ptr to the AsyncCallResult handle for the task
+        /// @see BrowserHost::CallOnMainThreadAsync
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        template<class Functor>
+        boost::shared_ptr<AsyncCallResult<typename Functor::result_type> > submit(Functor func)
+        {
+            typedef typename Functor::result_type RT;
+            boost::shared_ptr<AsyncCallResult<RT> > state(boost::make_shared<AsyncCallResult<RT> >());
+            if (!post(FutureCallRunner<Functor>(state, func))) {
+                state->setError("Thread pool is shut down");
+            }
+            return state;
+        }
+
+        /// Queues a fire-and-forget task; returns false if the pool is shut down.
+        /// Exceptions the task throws are logged and swallowed
+        bool post(const TaskType& task);
+
+        /// Number of worker threads in the pool
+        size_t getThreadCount() const { return m_threadCount; }
+
+        /// Runs remaining queued tasks, then stops and joins the workers; called
+        /// automatically on destruction
+        void shutdown();
+
+    protected:
+        void run();
+
+        SafeQueue<TaskType> m_queue;
+        boost::thread_group m_threads;
+        size_t m_threadCount;
+        boost::mutex m_mutex;
+        bool m_shutdown;
+    };
+};
+
+#endif // H_FB_THREADPOOL
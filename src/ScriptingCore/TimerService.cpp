@@ -0,0 +1,164 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include <vector>
+#include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "BrowserHost.h"
+
+#include "TimerService.h"
+
+FB::TimerService::TimerService(const FB::BrowserHostWeakPtr& host)
+    : m_host(host), m_lastId(0), m_shutdown(false), m_firePending(false),
+      m_thread(boost::bind(&FB::TimerService::run, this))
+{
+}
+
+FB::TimerService::~TimerService()
+{
+    shutdown();
+}
+
+unsigned int FB::TimerService::addTimer(unsigned int intervalMs, bool recurring, const FB::TimerCallback& callback)
+{
+    TimerEntryPtr entry(boost::make_shared<TimerEntry>());
+    boost::mutex::scoped_lock lock(m_mutex);
+    if (m_shutdown) {
+        return 0;
+    }
+    entry->id = ++m_lastId;
+    entry->intervalMs = intervalMs;
+    entry->recurring = recurring;
+    entry->callback = callback;
+    m_entries[entry->id] = entry;
+    m_deadlines.insert(std::make_pair(
+        boost::get_system_time() + boost::posix_time::milliseconds(intervalMs), entry));
+    // The new deadline may be earlier than what the service thread is sleeping on
+    m_cond.notify_all();
+    return entry->id;
+}
+
+void FB::TimerService::cancelTimer(unsigned int timerId)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    EntryMap::iterator fnd = m_entries.find(timerId);
+    if (fnd != m_entries.end()) {
+        // Just flag it; the entry is swept out of the deadline map when it next
+        // comes due, which keeps cancel cheap and callback-safe
+        fnd->second->canceled = true;
+    }
+}
+
+void FB::TimerService::shutdown()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        if (m_shutdown) {
+            return;
+        }
+        m_shutdown = true;
+        for (EntryMap::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+            it->second->canceled = true;
+        }
+        m_deadlines.clear();
+        m_entries.clear();
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void FB::TimerService::fireCallback(void* userData)
+{
+    boost::scoped_ptr<TimerServiceWeakPtr> token(static_cast<TimerServiceWeakPtr*>(userData));
+    TimerServicePtr service(token->lock());
+    if (service) {
+        service->fire();
+    }
+}
+
+void FB::TimerService::fire()
+{
+    std::vector<TimerEntryPtr> due;
+    const boost::system_time now = boost::get_system_time();
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        while (!m_deadlines.empty() && m_deadlines.begin()->first <= now) {
+            TimerEntryPtr entry(m_deadlines.begin()->second);
+            m_deadlines.erase(m_deadlines.begin());
+            if (entry->canceled) {
+                m_entries.erase(entry->id);
+            } else {
+                due.push_back(entry);
+            }
+        }
+    }
+    // Callbacks run unlocked so they are free to start and stop timers
+    for (std::vector<TimerEntryPtr>::const_iterator it = due.begin(); it != due.end(); ++it) {
+        if (!(*it)->canceled) {
+            (*it)->callback();
+        }
+    }
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        for (std::vector<TimerEntryPtr>::const_iterator it = due.begin(); it != due.end(); ++it) {
+            if ((*it)->recurring && !(*it)->canceled && !m_shutdown) {
+                m_deadlines.insert(std::make_pair(
+                    now + boost::posix_time::milliseconds((*it)->intervalMs), *it));
+            } else {
+                m_entries.erase((*it)->id);
+            }
+        }
+        m_firePending = false;
+    }
+    m_cond.notify_all();
+}
+
+void FB::TimerService::run()
+{
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while (!m_shutdown) {
+        if (m_firePending || m_deadlines.empty()) {
+            // Nothing to time against until the main thread drains the due set
+            // (or a timer is added)
+            m_cond.wait(lock);
+            continue;
+        }
+        const boost::system_time next = m_deadlines.begin()->first;
+        if (boost::get_system_time() < next) {
+            m_cond.timed_wait(lock, next);
+            continue;
+        }
+        m_firePending = true;
+        lock.unlock();
+        bool scheduled = false;
+        {
+            BrowserHostPtr host(m_host.lock());
+            if (host) {
+                TimerServiceWeakPtr* token = new TimerServiceWeakPtr(shared_from_this());
+                scheduled = host->ScheduleAsyncCall(&TimerService::fireCallback, token);
+                if (!scheduled) {
+                    delete token;
+                }
+            }
+        }
+        lock.lock();
+        if (!scheduled) {
+            // Host is gone or shutting down; no further ticks can be delivered
+            m_firePending = false;
+            m_shutdown = true;
+        }
+    }
+}
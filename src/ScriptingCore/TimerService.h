@@ -0,0 +1,92 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_TIMERSERVICE
+#define H_FB_TIMERSERVICE
+
+#include <map>
+#include <boost/function.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include <boost/unordered_map.hpp>
+#include "APITypes.h"
+
+namespace FB {
+
+    FB_FORWARD_PTR(TimerService);
+
+    /// Callback invoked on the main thread when a timer fires
+    typedef boost::function<void ()> TimerCallback;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  TimerService
+    ///
+    /// @brief  Main-thread timer facility behind BrowserHost::startTimer / stopTimer
+    ///
+    /// All registered timers share one service thread that sleeps until the earliest deadline and
+    /// then crosses into the main thread with a single ScheduleAsyncCall, which runs every due
+    /// callback in one pass.  However many timers are registered, each tick costs one main-thread
+    /// wakeup rather than one per timer.  You will normally not use this class directly; see
+    /// BrowserHost::startTimer.
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class TimerService : public boost::enable_shared_from_this<TimerService>, boost::noncopyable
+    {
+    public:
+        TimerService(const BrowserHostWeakPtr& host);
+        ~TimerService();
+
+        /// Registers a timer due intervalMs from now; recurring timers re-arm after each
+        /// fire until stopped.  Returns the timer id (never 0), or 0 after shutdown
+        unsigned int addTimer(unsigned int intervalMs, bool recurring, const TimerCallback& callback);
+        /// Stops the given timer; safe to call from a timer callback, including its own
+        void cancelTimer(unsigned int timerId);
+        /// Stops all timers and joins the service thread
+        void shutdown();
+
+    protected:
+        struct TimerEntry {
+            TimerEntry() : id(0), intervalMs(0), recurring(false), canceled(false) { }
+            unsigned int id;
+            unsigned int intervalMs;
+            bool recurring;
+            bool canceled;
+            TimerCallback callback;
+        };
+        typedef boost::shared_ptr<TimerEntry> TimerEntryPtr;
+        // Ordered by deadline so the service thread only ever inspects begin()
+        typedef std::multimap<boost::system_time, TimerEntryPtr> DeadlineMap;
+        typedef boost::unordered_map<unsigned int, TimerEntryPtr> EntryMap;
+
+        static void fireCallback(void* userData);
+        void fire();
+        void run();
+
+        BrowserHostWeakPtr m_host;
+        boost::mutex m_mutex;
+        boost::condition_variable m_cond;
+        DeadlineMap m_deadlines;
+        EntryMap m_entries;
+        unsigned int m_lastId;
+        bool m_shutdown;
+        // True from scheduling a main-thread fire until it finishes draining the due set
+        bool m_firePending;
+        // Must be constructed last; run() touches the members above
+        boost::thread m_thread;
+    };
+};
+
+#endif // H_FB_TIMERSERVICE
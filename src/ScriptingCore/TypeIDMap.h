@@ -1,218 +1,274 @@
-/**********************************************************\
-Original Author: Richard Bateman (taxilian)
-
-Created:    Oct 15, 2009
-License:    Dual license model; choose one of two:
-            New BSD License
-            http://www.opensource.org/licenses/bsd-license.php
-            - or -
-            GNU Lesser General Public License, version 2.1
-            http://www.gnu.org/licenses/lgpl-2.1.html
-
-Copyright 2009 Richard Bateman, Firebreath development team
-\**********************************************************/
-
-#pragma once
-#ifndef H_FB_STRINGIDMAP
-#define H_FB_STRINGIDMAP
-
-#include <map>
-#include <vector>
-#include <string>
-
-#include "APITypes.h"
-
-namespace FB {
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// @class  TypeIDMap
-    ///
-    /// @brief  Bidirectional map between an identifier and a variant
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    template <class IDTYPE>
-    class TypeIDMap
-    {
-    protected:
-        class compare_variants { // simple comparison function
-           public:
-               bool operator()(const FB::variant &x, const FB::variant &y) const
-               {
-                   return x.lessthan(y);
-               }
-        };
-
-        class compare_numerics { // simple numeric comparison function
-            public:
-                bool operator()(const IDTYPE &x, const IDTYPE &y) const
-                {
-                    long long x2 = (long long)(x);
-                    long long y2 = (long long)(y);
-                    return x2 < y2;
-                }
-        };
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @typedef    std::map<IDTYPE, FB::variant, compare_numerics> IdVariantMap
-        ///
-        /// @brief  Defines an alias representing the map from the id type to a variant.
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        typedef std::map<IDTYPE, FB::variant, compare_numerics> IdVariantMap;
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @typedef    std::map<FB::variant, IDTYPE, compare_variants> VariantIdMap
-        ///
-        /// @brief  Defines an alias representing the map from a variant to the id
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        typedef std::map<FB::variant, IDTYPE, compare_variants> VariantIdMap;
-
-    public:
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn TypeIDMap::TypeIDMap(IDTYPE startValue)
-        ///
-        /// @brief  Constructor. 
-        ///
-        /// @param  startValue  The value for the first ID to auto-assign
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        TypeIDMap(IDTYPE startValue) : nextId((unsigned long)startValue) { }
-        virtual ~TypeIDMap() { }
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn void TypeIDMap::setIdForValue(IDTYPE idt, const variant& val)
-        ///
-        /// @brief  Sets an identifier for value. 
-        ///
-        /// @exception  std::runtime_error  Thrown if the identifier is already mapped to something 
-        ///
-        /// @param  idt The identifier 
-        /// @param  val The value
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        void setIdForValue(IDTYPE idt, const variant& val)
-        {
-            if (m_idVariant.find(idt) != m_idVariant.end()
-                || m_variantId.find(val) != m_variantId.end()) {
-                throw std::runtime_error("ID or value already defined");
-            }
-            m_variantId[val] = idt;
-            m_idVariant[idt] = val;
-        }
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn IDTYPE TypeIDMap::getIdForValue(const variant& val)
-        ///
-        /// @brief  Gets the identifier assigned to the given value; if none is yet assigned, assigns a
-        ///         sequential identifier to the provided value
-        ///
-        /// @param  val The value. 
-        ///
-        /// @return The identifier assigned to value. 
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        IDTYPE getIdForValue(const variant& val)
-        {
-            typename VariantIdMap::iterator it = m_variantId.find(val);
-
-            if (it != m_variantId.end()) {
-                return it->second;
-            } else {
-                IDTYPE newId = (IDTYPE)nextId++;
-                m_variantId[val] = newId;
-                m_idVariant[newId] = val;
-                return newId;
-            }
-        }
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn const std::type_info& TypeIDMap::idGetType(IDTYPE idt)
-        ///
-        /// @brief  Returns the type of the value the given identifier is assigned to.
-        ///
-        /// @param  idt The identifier
-        ///
-        /// @return the type for comparison with typeid
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        const std::type_info& idGetType(IDTYPE idt)
-        {
-            typename IdVariantMap::iterator it = m_idVariant.find(idt);
-
-            if (it != m_idVariant.end()) {
-                return it->second.get_type();
-            } else {
-                return typeid(void);
-            }
-        }
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn bool TypeIDMap::idExists(IDTYPE idt)
-        ///
-        /// @brief  Queries if a given identifier has been assigned to anything. 
-        ///
-        /// @param  idt The identifier to check. 
-        ///
-        /// @return true if yes, false if no. 
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        bool idExists(IDTYPE idt)
-        {
-            return m_idVariant.find(idt) != m_idVariant.end();
-        }
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn template <class T> bool TypeIDMap::idIsType(IDTYPE idt)
-        ///
-        /// @brief  Queries if the provided identifier is assigned to a value of the given type 
-        ///
-        /// Example:
-        /// @code
-        ///      bool isStr = idMap.idIsType<std::string>(47);
-        /// @endcode
-        /// 
-        /// @param  idt The identifier to check. 
-        ///
-        /// @return true if it is the given type, false if it is not. 
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        template <class T>
-        bool idIsType(IDTYPE idt)
-        {
-            typename IdVariantMap::iterator it = m_idVariant.find(idt);
-
-            if (it != m_idVariant.end()) {
-                return it->second.get_type() == typeid(T);
-            } else {
-                return false;
-            }
-        }
-
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        /// @fn template <class T> T TypeIDMap::getValueForId(IDTYPE idt)
-        ///
-        /// @brief  Gets the value assigned to the identifier. 
-        ///
-        /// @exception  FB::bad_variant_cast    Thrown if the provided type is not valid for the value or if
-        ///                                     the identifier is not assigned to anything.
-        ///
-        /// @param  idt The identifier to check. 
-        ///
-        /// @return The value of type T that the identifier is assigned to
-        ////////////////////////////////////////////////////////////////////////////////////////////////////
-        template <class T>
-        T getValueForId(IDTYPE idt)
-        {
-            typename IdVariantMap::iterator it = m_idVariant.find(idt);
-
-            if (it != m_idVariant.end()) {
-                T retVal = (*it).second.template convert_cast<T>();
-                return retVal;
-            } else {
-                throw FB::bad_variant_cast(typeid(void), typeid(T));
-            }
-        }
-
-    protected:
-        IdVariantMap m_idVariant;
-        VariantIdMap m_variantId;
-        unsigned long nextId;
-
-    };
-
-};
-
-#endif // H_FB_STRINGIDMAP
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Oct 15, 2009
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_STRINGIDMAP
+#define H_FB_STRINGIDMAP
+
+#include <map>
+#include <vector>
+#include <string>
+
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "APITypes.h"
+
+namespace FB {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  TypeIDMap
+    ///
+    /// @brief  Bidirectional map between an identifier and a variant
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    template <class IDTYPE>
+    class TypeIDMap
+    {
+    protected:
+        class hash_variant { // hashes the common key payloads without touching typeid
+           public:
+               size_t operator()(const FB::variant &v) const
+               {
+                   using namespace FB::variant_detail;
+                   size_t seed = static_cast<size_t>(v.get_tag());
+                   switch (v.get_tag()) {
+                   case tag_string:    boost::hash_combine(seed, v.cast<std::string>()); break;
+                   case tag_wstring:   boost::hash_combine(seed, v.cast<std::wstring>()); break;
+                   case tag_bool:      boost::hash_combine(seed, v.cast<bool>()); break;
+                   case tag_char:      boost::hash_combine(seed, v.cast<char>()); break;
+                   case tag_uchar:     boost::hash_combine(seed, v.cast<unsigned char>()); break;
+                   case tag_short:     boost::hash_combine(seed, v.cast<short>()); break;
+                   case tag_ushort:    boost::hash_combine(seed, v.cast<unsigned short>()); break;
+                   case tag_int:       boost::hash_combine(seed, v.cast<int>()); break;
+                   case tag_uint:      boost::hash_combine(seed, v.cast<unsigned int>()); break;
+                   case tag_long:      boost::hash_combine(seed, v.cast<long>()); break;
+                   case tag_ulong:     boost::hash_combine(seed, v.cast<unsigned long>()); break;
+                   case tag_longlong:  boost::hash_combine(seed, v.cast<long long>()); break;
+                   case tag_ulonglong: boost::hash_combine(seed, v.cast<unsigned long long>()); break;
+                   case tag_float:     boost::hash_combine(seed, v.cast<float>()); break;
+                   case tag_double:    boost::hash_combine(seed, v.cast<double>()); break;
+                   default:
+                       // uncommon key types hash by type name; equality still
+                       // discriminates via the full comparison
+                       boost::hash_combine(seed, std::string(v.get_type().name()));
+                       break;
+                   }
+                   return seed;
+               }
+        };
+
+        class equal_variants { // equality in terms of the existing ordering
+           public:
+               bool operator()(const FB::variant &x, const FB::variant &y) const
+               {
+                   return !x.lessthan(y) && !y.lessthan(x);
+               }
+        };
+
+        class hash_numerics { // hashes ids through the same cast compare_numerics used
+            public:
+                size_t operator()(const IDTYPE &x) const
+                {
+                    return static_cast<size_t>((long long)(x));
+                }
+        };
+
+        class equal_numerics {
+            public:
+                bool operator()(const IDTYPE &x, const IDTYPE &y) const
+                {
+                    return (long long)(x) == (long long)(y);
+                }
+        };
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @typedef    boost::unordered_map<IDTYPE, FB::variant, hash_numerics, equal_numerics> IdVariantMap
+        ///
+        /// @brief  Defines an alias representing the map from the id type to a variant.
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        typedef boost::unordered_map<IDTYPE, FB::variant, hash_numerics, equal_numerics> IdVariantMap;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @typedef    boost::unordered_map<FB::variant, IDTYPE, hash_variant, equal_variants> VariantIdMap
+        ///
+        /// @brief  Defines an alias representing the map from a variant to the id
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        typedef boost::unordered_map<FB::variant, IDTYPE, hash_variant, equal_variants> VariantIdMap;
+
+    public:
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn TypeIDMap::TypeIDMap(IDTYPE startValue)
+        ///
+        /// @brief  Constructor. 
+        ///
+        /// @param  startValue  The value for the first ID to auto-assign
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        TypeIDMap(IDTYPE startValue) : nextId((unsigned long)startValue) { }
+        virtual ~TypeIDMap() { }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn void TypeIDMap::setIdForValue(IDTYPE idt, const variant& val)
+        ///
+        /// @brief  Sets an identifier for value. 
+        ///
+        /// @exception  std::runtime_error  Thrown if the identifier is already mapped to something 
+        ///
+        /// @param  idt The identifier 
+        /// @param  val The value
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        void setIdForValue(IDTYPE idt, const variant& val)
+        {
+            boost::unique_lock<boost::shared_mutex> lock(m_lock);
+            if (m_idVariant.find(idt) != m_idVariant.end()
+                || m_variantId.find(val) != m_variantId.end()) {
+                throw std::runtime_error("ID or value already defined");
+            }
+            m_variantId[val] = idt;
+            m_idVariant[idt] = val;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn IDTYPE TypeIDMap::getIdForValue(const variant& val)
+        ///
+        /// @brief  Gets the identifier assigned to the given value; if none is yet assigned, assigns a
+        ///         sequential identifier to the provided value
+        ///
+        /// @param  val The value. 
+        ///
+        /// @return The identifier assigned to value. 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        IDTYPE getIdForValue(const variant& val)
+        {
+            {
+                boost::shared_lock<boost::shared_mutex> readLock(m_lock);
+                typename VariantIdMap::const_iterator it = m_variantId.find(val);
+                if (it != m_variantId.end()) {
+                    return it->second;
+                }
+            }
+            boost::unique_lock<boost::shared_mutex> writeLock(m_lock);
+            // somebody may have beaten us to the assignment between the locks
+            typename VariantIdMap::const_iterator it = m_variantId.find(val);
+            if (it != m_variantId.end()) {
+                return it->second;
+            }
+            IDTYPE newId = (IDTYPE)nextId++;
+            m_variantId[val] = newId;
+            m_idVariant[newId] = val;
+            return newId;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn const std::type_info& TypeIDMap::idGetType(IDTYPE idt)
+        ///
+        /// @brief  Returns the type of the value the given identifier is assigned to.
+        ///
+        /// @param  idt The identifier
+        ///
+        /// @return the type for comparison with typeid
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        const std::type_info& idGetType(IDTYPE idt)
+        {
+            boost::shared_lock<boost::shared_mutex> lock(m_lock);
+            typename IdVariantMap::const_iterator it = m_idVariant.find(idt);
+
+            if (it != m_idVariant.end()) {
+                return it->second.get_type();
+            } else {
+                return typeid(void);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool TypeIDMap::idExists(IDTYPE idt)
+        ///
+        /// @brief  Queries if a given identifier has been assigned to anything. 
+        ///
+        /// @param  idt The identifier to check. 
+        ///
+        /// @return true if yes, false if no. 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool idExists(IDTYPE idt)
+        {
+            boost::shared_lock<boost::shared_mutex> lock(m_lock);
+            return m_idVariant.find(idt) != m_idVariant.end();
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn template <class T> bool TypeIDMap::idIsType(IDTYPE idt)
+        ///
+        /// @brief  Queries if the provided identifier is assigned to a value of the given type 
+        ///
+        /// Example:
+        /// @code
+        ///      bool isStr = idMap.idIsType<std::string>(47);
+        /// @endcode
+        /// 
+        /// @param  idt The identifier to check. 
+        ///
+        /// @return true if it is the given type, false if it is not. 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <class T>
+        bool idIsType(IDTYPE idt)
+        {
+            boost::shared_lock<boost::shared_mutex> lock(m_lock);
+            typename IdVariantMap::const_iterator it = m_idVariant.find(idt);
+
+            if (it != m_idVariant.end()) {
+                return it->second.get_type() == typeid(T);
+            } else {
+                return false;
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn template <class T> T TypeIDMap::getValueForId(IDTYPE idt)
+        ///
+        /// @brief  Gets the value assigned to the identifier. 
+        ///
+        /// @exception  FB::bad_variant_cast    Thrown if the provided type is not valid for the value or if
+        ///                                     the identifier is not assigned to anything.
+        ///
+        /// @param  idt The identifier to check. 
+        ///
+        /// @return The value of type T that the identifier is assigned to
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <class T>
+        T getValueForId(IDTYPE idt)
+        {
+            boost::shared_lock<boost::shared_mutex> lock(m_lock);
+            typename IdVariantMap::const_iterator it = m_idVariant.find(idt);
+
+            if (it != m_idVariant.end()) {
+                T retVal = (*it).second.template convert_cast<T>();
+                return retVal;
+            } else {
+                throw FB::bad_variant_cast(typeid(void), typeid(T));
+            }
+        }
+
+    protected:
+        IdVariantMap m_idVariant;
+        VariantIdMap m_variantId;
+        unsigned long nextId;
+        boost::shared_mutex m_lock;
+
+    };
+
+};
+
+#endif // H_FB_STRINGIDMAP
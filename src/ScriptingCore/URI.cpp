@@ -33,33 +33,57 @@ using FB::URI;
 
 URI::StringStringMap URI::m_lhMap;
 
+namespace {
+    // 256-entry lookup tables so encode/decode never call into ctype or strtol.
+    // hex_value[c] is the numeric value of hex digit c, or -1 for non-hex characters;
+    // unreserved[c] is nonzero for characters url_encode passes through unescaped.
+    struct uri_char_tables {
+        signed char hex_value[256];
+        unsigned char unreserved[256];
+        uri_char_tables() {
+            for (int c = 0; c < 256; ++c) {
+                hex_value[c] = -1;
+                unreserved[c] = (isalnum(c) ||
+                    c == '$' || c == '-' || c == '_' || c == '.' || c == '!' ||
+                    c == '*' || c == '\''|| c == '(' || c == ')' || c == ',' || c == '/') ? 1 : 0;
+            }
+            for (int c = '0'; c <= '9'; ++c) hex_value[c] = (signed char)(c - '0');
+            for (int c = 'a'; c <= 'f'; ++c) hex_value[c] = (signed char)(c - 'a' + 10);
+            for (int c = 'A'; c <= 'F'; ++c) hex_value[c] = (signed char)(c - 'A' + 10);
+        }
+    };
+    const uri_char_tables uri_tables;
+    const char hex_digits[] = "0123456789abcdef";
+}
+
 std::string URI::url_encode(const std::string& in) {
-    std::stringstream res;
+    std::string res;
+    res.reserve(in.size());
     for (size_t i = 0; i < in.size(); ++i) {
-        char c = in[i];
-        if (isalnum(c) ||
-            c == '$' || c == '-' || c == '_' || c == '.' || c == '!' ||
-            c == '*' || c == '\''|| c == '(' || c == ')' || c == ',' || c == '/') res << c;
+        unsigned char c = (unsigned char)in[i];
+        if (uri_tables.unreserved[c]) res += (char)c;
         else {
-            char buf[4];
-            sprintf(buf, "%%%.2x", c & 0xff);
-            res << buf;
+            res += '%';
+            res += hex_digits[c >> 4];
+            res += hex_digits[c & 0x0f];
         }
     }
-    return res.str();
+    return res;
 }
 
 std::string URI::url_decode(const std::string& in) {
-    std::stringstream res;
+    std::string res;
+    res.reserve(in.size());
     for (size_t i = 0; i < in.size(); ++i) {
-        if (in[i] == '%' && (i + 2) < in.size() && isxdigit(in[i+1]) && isxdigit(in[i+2])) {
-            char buf[3];
-            ++i;
-            buf[0] = in[i++]; buf[1] = in[i]; buf[2] = '\0';
-            res << ((char)strtol(buf, NULL, 16));
-        } else res << in[i];
+        int hi, lo;
+        if (in[i] == '%' && (i + 2) < in.size() &&
+            (hi = uri_tables.hex_value[(unsigned char)in[i+1]]) >= 0 &&
+            (lo = uri_tables.hex_value[(unsigned char)in[i+2]]) >= 0) {
+            res += (char)((hi << 4) | lo);
+            i += 2;
+        } else res += in[i];
     }
-    return res.str();
+    return res;
 }
 
 std::string URI::toString(bool include_host_part) const {
@@ -189,8 +213,8 @@ void URI::registerValidLocalhost(std::string domain, std::string ip)
 
 bool URI::isLocalhost() const {
     // To avoid a security breach by DNS poisioning, we make sure that the allowed
-    // domain (either localhost or registered with registerValidLocalhost) actually
-    // is pointing at localhost / the correct IP.
+    // domain (either localhost or registered with registerValidLocalhost) actually
+    // is pointing at localhost / the correct IP.
     StringStringMap tmp;
     StringStringMap::const_iterator fnd(m_lhMap.find(domain));
     if (fnd != m_lhMap.end()) {
@@ -216,13 +240,19 @@ bool URI::isLocalhost() const {
 }
 
 void URI::parse_query_data(const std::string& in_str) {
-    std::vector<string> parts;
-    split(parts, in_str, is_any_of("&"));
-    for (std::vector<string>::iterator it = parts.begin(); it != parts.end(); ++it) {
-        std::vector<string> kvp;
-        split(kvp, *it, is_any_of("="));
-        if (kvp.empty()) continue;
-        else if (kvp.size() == 1) query_data[url_decode(kvp[0])] = string();
-        else query_data[url_decode(kvp[0])] = url_decode(kvp[1]);
+    // single pass over the raw string; no intermediate token vectors
+    size_t pos = 0;
+    while (pos <= in_str.size()) {
+        size_t amp = in_str.find('&', pos);
+        if (amp == std::string::npos) amp = in_str.size();
+        if (amp > pos) {
+            size_t eq = in_str.find('=', pos);
+            if (eq == std::string::npos || eq > amp)
+                query_data[url_decode(in_str.substr(pos, amp - pos))] = string();
+            else
+                query_data[url_decode(in_str.substr(pos, eq - pos))] =
+                    url_decode(in_str.substr(eq + 1, amp - eq - 1));
+        }
+        pos = amp + 1;
     }
 }
@@ -0,0 +1,95 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2026 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_FB_CALLARENA
+#define H_FB_CALLARENA
+
+#include <vector>
+#include <boost/thread/tss.hpp>
+#include "APITypes.h"
+
+namespace FB
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  ScopedVariantArgs
+    ///
+    /// @brief  Per-invocation scratch VariantList drawn from a small per-thread pool
+    ///
+    /// Every scripting call used to construct (and then free) a fresh std::vector<variant> for its
+    /// argument list.  ScopedVariantArgs instead borrows a recycled VariantList whose buffer keeps
+    /// its capacity between calls, so in steady state building an argument list allocates nothing;
+    /// the list is cleared wholesale when the scope exits.  Since variant keeps its common payloads
+    /// in inline storage, this removes the per-call allocator traffic from the invoke hot path.
+    ///
+    /// @code
+    ///      FB::ScopedVariantArgs args;
+    ///      args->reserve(argCount);
+    ///      for (uint32_t i = 0; i < argCount; i++)
+    ///          args->push_back(host->getVariant(&npargs[i]));
+    ///      api->Invoke(name, args.list());
+    /// @endcode
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ScopedVariantArgs
+    {
+    public:
+        ScopedVariantArgs() : m_list(borrowList()) { }
+        ~ScopedVariantArgs() { returnList(m_list); }
+
+        VariantList& list() { return *m_list; }
+        const VariantList& list() const { return *m_list; }
+        VariantList* operator->() { return m_list; }
+
+    private:
+        typedef std::vector<VariantList*> ListPool;
+
+        // arbitrary cap; deeper than any sane recursive invoke nesting
+        static const size_t MaxPooledLists = 8;
+
+        static ListPool& getPool() {
+            static boost::thread_specific_ptr<ListPool> pool;
+            if (!pool.get()) {
+                pool.reset(new ListPool);
+            }
+            return *pool;
+        }
+        static VariantList* borrowList() {
+            ListPool& pool(getPool());
+            if (!pool.empty()) {
+                VariantList* list = pool.back();
+                pool.pop_back();
+                return list;
+            }
+            return new VariantList;
+        }
+        static void returnList(VariantList* list) {
+            // clear() destroys the payloads but keeps the buffer capacity
+            list->clear();
+            ListPool& pool(getPool());
+            if (pool.size() < MaxPooledLists) {
+                pool.push_back(list);
+            } else {
+                delete list;
+            }
+        }
+
+        // non-copyable
+        ScopedVariantArgs(const ScopedVariantArgs&);
+        ScopedVariantArgs& operator=(const ScopedVariantArgs&);
+
+        VariantList* m_list;
+    };
+}
+
+#endif // H_FB_CALLARENA
@@ -162,8 +162,12 @@ namespace FB { namespace meta { namespace detail
         typedef typename T::mapped_type Mapped;
         typedef typename T::value_type Value;
         typedef std::pair<const Key, Mapped> Pair;
+        // flat maps expose value_type with a non-const key; they are still
+        // pair-associative containers for our purposes
+        typedef std::pair<Key, Mapped> FlatPair;
 
-        static const bool value = boost::is_same<Value, Pair>::value;
+        static const bool value = boost::is_same<Value, Pair>::value
+                               || boost::is_same<Value, FlatPair>::value;
     };
 
     template<class T>
@@ -19,6 +19,23 @@ Copyright 2010 Facebook, Inc
 #include <sstream>
 #include <list>
 
+// Numeric severities for the compile-time ceiling below (higher = more verbose)
+#define FB_LOG_LEVEL_NONE  0
+#define FB_LOG_LEVEL_FATAL 1
+#define FB_LOG_LEVEL_ERROR 2
+#define FB_LOG_LEVEL_WARN  3
+#define FB_LOG_LEVEL_INFO  4
+#define FB_LOG_LEVEL_DEBUG 5
+#define FB_LOG_LEVEL_TRACE 6
+
+// The most verbose level compiled into the binary.  FBLOG statements above
+// this level expand to nothing -- their stream arguments are never evaluated,
+// so release builds can set FB_MAX_LOG_LEVEL to FB_LOG_LEVEL_INFO and pay
+// literally zero for trace/debug statements in hot paths.
+#ifndef FB_MAX_LOG_LEVEL
+#  define FB_MAX_LOG_LEVEL FB_LOG_LEVEL_TRACE
+#endif
+
 #if !FB_NO_LOGGING_MACROS
 #  if defined(__GNUC__)
 #    define FBLOG_FUNCTION() __PRETTY_FUNCTION__
@@ -27,8 +44,11 @@ Copyright 2010 Facebook, Inc
 #  else
 #    define FBLOG_FUNCTION() __func__
 #  endif
-#  define FBLOG_LOG_BODY(type, src, msg) \
+// the runtime level check comes before the ostringstream, so statements for
+// disabled levels cost one predicate and never build the message
+#  define FBLOG_LOG_BODY(type, level, src, msg) \
     do { \
+        if (!FB::Log::isLogLevelEnabled(FB::Log:: level)) break; \
         std::ostringstream os; \
         os << msg; \
         FB::Log:: type (src, os.str(), __FILE__, __LINE__, FBLOG_FUNCTION()); \
@@ -36,14 +56,38 @@ Copyright 2010 Facebook, Inc
 #endif
 
 #if !FB_NO_LOGGING_MACROS
-#  define FBLOG_TRACE(src, msg) FBLOG_LOG_BODY(trace, src, msg)
-#  define FBLOG_DEBUG(src, msg) FBLOG_LOG_BODY(debug, src, msg)
-#  define FBLOG_INFO(src, msg) FBLOG_LOG_BODY(info, src, msg)
-#  define FBLOG_WARN(src, msg) FBLOG_LOG_BODY(warn, src, msg)
-#  define FBLOG_ERROR(src, msg) FBLOG_LOG_BODY(error, src, msg)
-#  define FBLOG_FATAL(src, msg) FBLOG_LOG_BODY(fatal, src, msg)
-#else 
-#  define FBLOG_TRACE(src, msg) 
+#  if FB_MAX_LOG_LEVEL >= FB_LOG_LEVEL_TRACE
+#    define FBLOG_TRACE(src, msg) FBLOG_LOG_BODY(trace, LogLevel_Trace, src, msg)
+#  else
+#    define FBLOG_TRACE(src, msg) do { } while(0)
+#  endif
+#  if FB_MAX_LOG_LEVEL >= FB_LOG_LEVEL_DEBUG
+#    define FBLOG_DEBUG(src, msg) FBLOG_LOG_BODY(debug, LogLevel_Debug, src, msg)
+#  else
+#    define FBLOG_DEBUG(src, msg) do { } while(0)
+#  endif
+#  if FB_MAX_LOG_LEVEL >= FB_LOG_LEVEL_INFO
+#    define FBLOG_INFO(src, msg) FBLOG_LOG_BODY(info, LogLevel_Info, src, msg)
+#  else
+#    define FBLOG_INFO(src, msg) do { } while(0)
+#  endif
+#  if FB_MAX_LOG_LEVEL >= FB_LOG_LEVEL_WARN
+#    define FBLOG_WARN(src, msg) FBLOG_LOG_BODY(warn, LogLevel_Warn, src, msg)
+#  else
+#    define FBLOG_WARN(src, msg) do { } while(0)
+#  endif
+#  if FB_MAX_LOG_LEVEL >= FB_LOG_LEVEL_ERROR
+#    define FBLOG_ERROR(src, msg) FBLOG_LOG_BODY(error, LogLevel_Error, src, msg)
+#  else
+#    define FBLOG_ERROR(src, msg) do { } while(0)
+#  endif
+#  if FB_MAX_LOG_LEVEL >= FB_LOG_LEVEL_FATAL
+#    define FBLOG_FATAL(src, msg) FBLOG_LOG_BODY(fatal, LogLevel_Error, src, msg)
+#  else
+#    define FBLOG_FATAL(src, msg) do { } while(0)
+#  endif
+#else
+#  define FBLOG_TRACE(src, msg)
 #  define FBLOG_DEBUG(src, msg)
 #  define FBLOG_INFO(src, msg)
 #  define FBLOG_WARN(src, msg)
@@ -53,6 +97,9 @@ Copyright 2010 Facebook, Inc
 
 namespace FB { namespace Log {
 
+    // Cheap to call during module load: backends defer appender
+    // configuration (which may touch the filesystem) until the first
+    // message is actually delivered, buffering anything logged before then
     void initLogging();
     void stopLogging();
 
@@ -79,6 +126,14 @@ namespace FB { namespace Log {
         LogLevel_Error  = 0x10
     };
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn bool isLogLevelEnabled(LogLevel level)
+    ///
+    /// @brief  Cheap runtime query used by the FBLOG macros before they build the message
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    bool isLogLevelEnabled(LogLevel level);
+
     //////////////////////////////////////////////////////////////////////////
     /// Used to specify which logging methods to use
     //////////////////////////////////////////////////////////////////////////
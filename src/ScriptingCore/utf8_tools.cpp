@@ -16,18 +16,62 @@ Copyright 2009 Dan Weatherford, Facebook inc
 #include <stdlib.h>
 #include <limits.h>
 #include <boost/scoped_array.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/unordered_map.hpp>
 #include <stdexcept>
 
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <utf8.h>
-#include <xlocale.h>
 #include <wctype.h>
 #endif
 
+#if defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(_M_X64)
+#define FB_UTF8_SSE2 1
+#include <emmintrin.h>
+#endif
+
 #include "utf8_tools.h"
 
+namespace {
+    // Length of the leading all-ASCII run of a UTF-8 buffer.  ASCII dominates the
+    // strings crossing the scripting boundary, so the converters copy this run with
+    // a tight (SIMD where available) loop and only hand the remainder to the
+    // general-purpose codec.
+    size_t ascii_prefix_len(const char* data, size_t len) {
+        size_t i = 0;
+#ifdef FB_UTF8_SSE2
+        for (; i + 16 <= len; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            if (_mm_movemask_epi8(chunk) != 0)
+                break;
+        }
+#endif
+        for (; i < len; ++i) {
+            if (static_cast<unsigned char>(data[i]) & 0x80)
+                break;
+        }
+        return i;
+    }
+
+    // Same for a wide buffer; done a machine word at a time since wchar_t width
+    // differs between platforms
+    size_t ascii_prefix_len(const wchar_t* data, size_t len) {
+        size_t i = 0;
+        for (; i + 4 <= len; i += 4) {
+            if ((static_cast<unsigned long>(data[i]) | static_cast<unsigned long>(data[i+1])
+                 | static_cast<unsigned long>(data[i+2]) | static_cast<unsigned long>(data[i+3])) >= 0x80)
+                break;
+        }
+        for (; i < len; ++i) {
+            if (static_cast<unsigned long>(data[i]) >= 0x80)
+                break;
+        }
+        return i;
+    }
+}
+
 namespace FB {
 
 #ifdef _WIN32
@@ -47,44 +91,114 @@ namespace FB {
     }
 #endif
 
-    std::string wstring_to_utf8(const std::wstring& src) {
+    void wstring_to_utf8(const std::wstring& src, std::string& dest) {
+        // clear() keeps the buffer's capacity, so a dest reused across calls
+        // stops touching the allocator once it has grown to the working size
+        dest.clear();
 #ifdef _WIN32
         int buffer_len = WideCharToMultiByte(CP_UTF8, 0, src.data(), src.size()+1, NULL, 0, NULL, NULL);
         if (buffer_len <= 0) throw_GetLastError("WideCharToMultiByte");
-        std::string out_str;
-        out_str.resize(buffer_len - 1);
-        WideCharToMultiByte(CP_UTF8, 0, src.data(), src.size()+1, const_cast<char*>(out_str.data()), (int)(out_str.size() + 1), NULL, NULL);
-        return out_str;
+        dest.resize(buffer_len - 1);
+        WideCharToMultiByte(CP_UTF8, 0, src.data(), src.size()+1, const_cast<char*>(dest.data()), (int)(dest.size() + 1), NULL, NULL);
 #else
-        const size_t work_size = (src.size() * MB_LEN_MAX) + 1;
+        // fast path: narrow the leading ASCII run directly
+        const size_t ascii = ascii_prefix_len(src.c_str(), src.size());
+        dest.reserve(src.size());
+        for (size_t i = 0; i < ascii; ++i)
+            dest += static_cast<char>(src[i]);
+        if (ascii == src.size())
+            return;
+
+        const size_t remain = src.size() - ascii;
+        const size_t work_size = (remain * MB_LEN_MAX) + 1;
         boost::scoped_array<char> work(new char[work_size]);
         //size_t res = wcstombs(work.get(), src.data(), work_size);
-        size_t res = wchar_to_utf8(src.data(), src.size() + 1, work.get(), work_size, UTF8_IGNORE_ERROR);
+        size_t res = wchar_to_utf8(src.c_str() + ascii, remain + 1, work.get(), work_size, UTF8_IGNORE_ERROR);
         if (res == 0) throw std::runtime_error("wstring_to_utf8: conversion error");
-        return std::string(work.get());
+        dest.append(work.get());
 #endif
     }
 
+    std::string wstring_to_utf8(const std::wstring& src) {
+        std::string out_str;
+        wstring_to_utf8(src, out_str);
+        return out_str;
+    }
 
-    std::wstring utf8_to_wstring(const std::string& src) {
+
+    void utf8_to_wstring(const std::string& src, std::wstring& dest) {
+        dest.clear();
+        if (src.empty()) return;
 #ifdef _WIN32
-        if (src.empty()) return std::wstring();
         int buffer_len = MultiByteToWideChar(CP_UTF8, 0, src.data(), src.size()+1, NULL, 0);
         if (buffer_len <= 0) throw_GetLastError("MultiByteToWideChar");
-        std::wstring res;
-        res.resize(buffer_len - 1);
-        MultiByteToWideChar(CP_UTF8, 0, src.data(), src.size()+1, const_cast<wchar_t*>(res.data()), (int)(res.size()+1));
-        return res;
+        dest.resize(buffer_len - 1);
+        MultiByteToWideChar(CP_UTF8, 0, src.data(), src.size()+1, const_cast<wchar_t*>(dest.data()), (int)(dest.size()+1));
 #else
-        const size_t work_size = src.size()+1;
+        // fast path: widen the leading ASCII run directly
+        const size_t ascii = ascii_prefix_len(src.c_str(), src.size());
+        dest.reserve(src.size());
+        for (size_t i = 0; i < ascii; ++i)
+            dest += static_cast<wchar_t>(static_cast<unsigned char>(src[i]));
+        if (ascii == src.size())
+            return;
+
+        const size_t remain = src.size() - ascii;
+        const size_t work_size = remain + 1;
         boost::scoped_array<wchar_t> work(new wchar_t[work_size]);
         //size_t res = mbstowcs(work.get(), src.data(), work_size);
-        size_t res = utf8_to_wchar(src.data(), src.size()+1, work.get(), work_size, UTF8_IGNORE_ERROR);
+        size_t res = utf8_to_wchar(src.c_str() + ascii, remain + 1, work.get(), work_size, UTF8_IGNORE_ERROR);
         if (res == ((size_t)-1)) throw std::runtime_error("utf8_to_wstring: conversion error");
-        return std::wstring(work.get());
+        dest.append(work.get());
 #endif
     }
 
+    std::wstring utf8_to_wstring(const std::string& src) {
+        std::wstring res_str;
+        utf8_to_wstring(src, res_str);
+        return res_str;
+    }
+
+    namespace {
+        // the memos are thread-local so the hot path takes no lock; names
+        // longer than this are payloads, not names, and aren't remembered
+        const size_t name_memo_max_len = 64;
+        const size_t name_memo_max_entries = 256;
+    }
+
+    std::string wstring_to_utf8_cached(const std::wstring& src) {
+        typedef boost::unordered_map<std::wstring, std::string> NameMemo;
+        static boost::thread_specific_ptr<NameMemo> memo;
+        if (src.size() > name_memo_max_len)
+            return wstring_to_utf8(src);
+        NameMemo* m = memo.get();
+        if (!m) memo.reset(m = new NameMemo);
+        NameMemo::const_iterator it = m->find(src);
+        if (it != m->end())
+            return it->second;
+        // crude bound; the handful of live names re-converts instantly
+        if (m->size() >= name_memo_max_entries) m->clear();
+        std::string& slot = (*m)[src];
+        wstring_to_utf8(src, slot);
+        return slot;
+    }
+
+    std::wstring utf8_to_wstring_cached(const std::string& src) {
+        typedef boost::unordered_map<std::string, std::wstring> NameMemo;
+        static boost::thread_specific_ptr<NameMemo> memo;
+        if (src.size() > name_memo_max_len)
+            return utf8_to_wstring(src);
+        NameMemo* m = memo.get();
+        if (!m) memo.reset(m = new NameMemo);
+        NameMemo::const_iterator it = m->find(src);
+        if (it != m->end())
+            return it->second;
+        if (m->size() >= name_memo_max_entries) m->clear();
+        std::wstring& slot = (*m)[src];
+        utf8_to_wstring(src, slot);
+        return slot;
+    }
+
 
     std::wstring wstring_tolower(const std::wstring& src) {
       if (src.empty()) return std::wstring();
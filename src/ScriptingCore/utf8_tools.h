@@ -37,6 +37,19 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     std::string wstring_to_utf8(const std::wstring& src);
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn void wstring_to_utf8(const std::wstring& src, std::string& dest)
+    ///
+    /// @brief  Converts into a caller-provided buffer; dest is cleared but keeps its capacity,
+    ///         so a buffer reused across calls stops allocating once it has grown to the
+    ///         working size
+    ///
+    /// @param  src  Source string
+    /// @param  dest Receives the UTF8-encoded result
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    void wstring_to_utf8(const std::wstring& src, std::string& dest);
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @fn std::wstring utf8_to_wstring(const std::string& src)
     ///
@@ -48,6 +61,47 @@ namespace FB {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     std::wstring utf8_to_wstring(const std::string& src);
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn void utf8_to_wstring(const std::string& src, std::wstring& dest)
+    ///
+    /// @brief  Converts into a caller-provided buffer; dest is cleared but keeps its capacity
+    ///
+    /// @param  src  Source string
+    /// @param  dest Receives the std::wstring result
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    void utf8_to_wstring(const std::string& src, std::wstring& dest);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn std::string wstring_to_utf8_cached(const std::wstring& src)
+    ///
+    /// @brief  wstring_to_utf8 with a per-thread memo, for hot repeated names
+    ///
+    /// Member and event names cross the wide JSAPI entry points on every call but are drawn
+    /// from a tiny, stable set; each thread keeps a bounded map of past conversions, so the
+    /// steady state is one hash lookup and no transcoding.  Meant for name-like strings --
+    /// long strings are converted but not remembered.
+    ///
+    /// @param  src Source string
+    ///
+    /// @return UTF8-encoded std::string
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    std::string wstring_to_utf8_cached(const std::wstring& src);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn std::wstring utf8_to_wstring_cached(const std::string& src)
+    ///
+    /// @brief  utf8_to_wstring with a per-thread memo; the widening twin of
+    ///         wstring_to_utf8_cached
+    ///
+    /// @param  src Source string
+    ///
+    /// @return std::wstring representation
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    std::wstring utf8_to_wstring_cached(const std::string& src);
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @fn std::wstring wstring_tolower(const std::wstring& src)
     ///
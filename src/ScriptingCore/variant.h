@@ -23,6 +23,7 @@
 #include <typeinfo>
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <string>
 
@@ -40,14 +41,24 @@
 #include <boost/variant/apply_visitor.hpp>
 #include <boost/variant/static_visitor.hpp>
 #include <boost/tuple/tuple.hpp>
+#include <boost/detail/atomic_count.hpp>
 #include <boost/preprocessor/tuple/to_seq.hpp>
 
 #include "APITypes.h"
 #include "Util/meta_util.h"
 #include "utf8_tools.h"
+#include "MemoryAccounting.h"
 #include "variant_conversions.h"
 //#include "JSObject.h"
 
+// Detect rvalue reference support so that variant can provide a real move path on
+// compilers that have one; on a plain C++03 compiler everything quietly degrades
+// to the old copying behaviour.
+#if (defined(_MSC_VER) && _MSC_VER >= 1600) || (__cplusplus >= 201103L) || defined(__GXX_EXPERIMENTAL_CXX0X__)
+#define FB_VARIANT_RVALUE_SUPPORT 1
+#include <utility>
+#endif
+
 
 
 #ifdef _WIN32
@@ -114,6 +125,7 @@
 namespace FB
 {
     class JSObject;
+    class variant;
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @exception bad_variant_cast
@@ -134,13 +146,70 @@ namespace FB
 
     namespace variant_detail
     {
+        // Inline storage for the variant payload.  Anything that fits here -- including
+        // the std::string/std::wstring payloads that dominate scripting traffic -- is
+        // constructed directly inside the variant, skipping the heap box that larger
+        // types require.  With the standard library's own short-string optimization on
+        // top of this, short strings involve no heap allocation at all.
+        union variant_storage {
+            void* ptr;
+            double align_;
+            char buf[sizeof(std::string) > 4 * sizeof(void*) ? sizeof(std::string) : 4 * sizeof(void*)];
+        };
+
+        struct null;
+        struct empty;
+
+        // Compact type tags for the payload types involved in the common scripting
+        // coercions; convert_cast switches on these directly instead of walking a
+        // chain of type_info comparisons.  Anything else is tag_generic and takes
+        // the normal conversion path.
+        enum variant_tag {
+            tag_generic = 0,
+            tag_empty, tag_null,
+            tag_bool,
+            tag_char, tag_uchar,
+            tag_short, tag_ushort,
+            tag_int, tag_uint,
+            tag_long, tag_ulong,
+            tag_longlong, tag_ulonglong,
+            tag_float, tag_double,
+            tag_string, tag_wstring
+        };
+
+        template <typename T>
+        struct tag_of { static const variant_tag value = tag_generic; };
+#define FB_VARIANT_TAG(_type_, _tag_) \
+        template <> struct tag_of<_type_> { static const variant_tag value = _tag_; }
+        FB_VARIANT_TAG(empty, tag_empty);
+        FB_VARIANT_TAG(null, tag_null);
+        FB_VARIANT_TAG(bool, tag_bool);
+        FB_VARIANT_TAG(char, tag_char);
+        FB_VARIANT_TAG(unsigned char, tag_uchar);
+        FB_VARIANT_TAG(short, tag_short);
+        FB_VARIANT_TAG(unsigned short, tag_ushort);
+        FB_VARIANT_TAG(int, tag_int);
+        FB_VARIANT_TAG(unsigned int, tag_uint);
+        FB_VARIANT_TAG(long, tag_long);
+        FB_VARIANT_TAG(unsigned long, tag_ulong);
+        FB_VARIANT_TAG(long long, tag_longlong);
+        FB_VARIANT_TAG(unsigned long long, tag_ulonglong);
+        FB_VARIANT_TAG(float, tag_float);
+        FB_VARIANT_TAG(double, tag_double);
+        FB_VARIANT_TAG(std::string, tag_string);
+        FB_VARIANT_TAG(std::wstring, tag_wstring);
+#undef FB_VARIANT_TAG
+
         // function pointer table
         struct fxn_ptr_table {
             const std::type_info& (*get_type)();
             void (*static_delete)(void**);
             void (*clone)(void* const*, void**);
             void (*move)(void* const*,void**);
+            void (*rvalue_assign)(void**, void**);
+            void (*relocate)(void**, void**);
             bool (*less)(void* const*, void* const*);
+            variant_tag tag;
         };
 
         // static functions for small value-types 
@@ -158,40 +227,108 @@ namespace FB
                 static void clone(void* const* src, void** dest) { 
                     new(dest) T(*reinterpret_cast<T const*>(src)); 
                 }
-                static void move(void* const* src, void** dest) { 
-                    reinterpret_cast<T*>(dest)->~T(); 
-                    *reinterpret_cast<T*>(dest) = *reinterpret_cast<T const*>(src); 
+                static void move(void* const* src, void** dest) {
+                    // destroy the old payload and clone into the same storage; small types
+                    // are no longer guaranteed to be POD now that strings live inline
+                    reinterpret_cast<T*>(dest)->~T();
+                    new(dest) T(*reinterpret_cast<T const*>(src));
+                }
+                // like move(), but the source is expiring so its payload may be stolen
+                static void rvalue_assign(void** src, void** dest) {
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+                    *reinterpret_cast<T*>(dest) = std::move(*reinterpret_cast<T*>(src));
+#else
+                    *reinterpret_cast<T*>(dest) = *reinterpret_cast<T const*>(src);
+#endif
+                }
+                // transplant the payload into uninitialized storage, destroying the
+                // source; the storage cannot simply be byte-copied because inline
+                // payloads (e.g. std::string) may contain pointers into themselves
+                static void relocate(void** src, void** dest) {
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+                    new(dest) T(std::move(*reinterpret_cast<T*>(src)));
+#else
+                    new(dest) T(*reinterpret_cast<T const*>(src));
+#endif
+                    reinterpret_cast<T*>(src)->~T();
                 }
                 static bool lessthan(void* const* left, void* const* right) {
-                    T l(*reinterpret_cast<T const*>(left));
-                    T r(*reinterpret_cast<T const*>(right));
-
-                    return l < r;
+                    return *reinterpret_cast<T const*>(left) < *reinterpret_cast<T const*>(right);
                 }
             };
         };
 
-        // static functions for big value-types (bigger than a void*)
+        // Heap payloads live in a shared, refcounted box so that cloning a variant --
+        // and therefore copying a VariantList across a thread boundary -- just bumps
+        // a count instead of deep-copying the payload.  The payload is only mutated
+        // through the same-type assign paths, which replace the box first if anyone
+        // else is holding it (copy-on-write).
+        template <typename T>
+        struct big_box {
+            explicit big_box(const T& val) : refs(1), value(val) {
+                FB::Memory::accountAlloc(FB::Memory::Category_VariantPayload, sizeof(big_box));
+            }
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+            explicit big_box(T&& val) : refs(1), value(std::move(val)) {
+                FB::Memory::accountAlloc(FB::Memory::Category_VariantPayload, sizeof(big_box));
+            }
+#endif
+            ~big_box() {
+                FB::Memory::accountFree(FB::Memory::Category_VariantPayload, sizeof(big_box));
+            }
+            boost::detail::atomic_count refs;
+            T value;
+        };
+
+        // Types that are cheap to hold but expensive to copy are forced onto the
+        // shared heap path even when they would fit in the inline storage
+        template <typename T>
+        struct force_shared { static const bool value = false; };
+        template <>
+        struct force_shared<std::vector<variant> > { static const bool value = true; };
+        template <>
+        struct force_shared<FB::VariantMap> { static const bool value = true; };
+
+        // static functions for big value-types (bigger than the inline storage, or
+        // explicitly shared)
         template<>
         struct fxns<false>
         {
             template<typename T>
             struct type {
-                static const std::type_info& get_type() { 
-                    return typeid(T); 
+                static big_box<T>* unbox(void* const* x) {
+                    return *reinterpret_cast<big_box<T>* const*>(x);
                 }
-                static void static_delete(void** x) { 
-                    delete(*reinterpret_cast<T**>(x)); 
+                static const std::type_info& get_type() {
+                    return typeid(T);
                 }
-                static void clone(void* const* src, void** dest) { 
-                    *dest = new T(**reinterpret_cast<T* const*>(src)); 
+                static void static_delete(void** x) {
+                    big_box<T>* box = unbox(x);
+                    if (--box->refs == 0)
+                        delete box;
+                }
+                static void clone(void* const* src, void** dest) {
+                    ++unbox(src)->refs;
+                    *dest = *src;
+                }
+                static void move(void* const* src, void** dest) {
+                    big_box<T>* old = unbox(dest);
+                    ++unbox(src)->refs;
+                    *dest = *src;
+                    if (--old->refs == 0)
+                        delete old;
+                }
+                // the source is expiring, so just trade boxes; our old payload is
+                // released when the source is destroyed
+                static void rvalue_assign(void** src, void** dest) {
+                    std::swap(*src, *dest);
                 }
-                static void move(void* const* src, void** dest) { 
-                    (*reinterpret_cast<T**>(dest))->~T(); 
-                    **reinterpret_cast<T**>(dest) = **reinterpret_cast<T* const*>(src); 
+                // boxed payloads relocate by moving the pointer
+                static void relocate(void** src, void** dest) {
+                    *dest = *src;
                 }
                 static bool lessthan(void* const* left, void* const* right) {
-                    return **reinterpret_cast<T* const*>(left) < **reinterpret_cast<T* const*>(right);
+                    return unbox(left)->value < unbox(right)->value;
                 }
             };
         };
@@ -199,7 +336,8 @@ namespace FB
         template<typename T>
         struct get_table 
         {
-            static const bool is_small = sizeof(T) <= sizeof(void*);
+            static const bool is_small = sizeof(T) <= sizeof(variant_storage)
+                && !force_shared<T>::value;
 
             static fxn_ptr_table* get()
             {
@@ -208,7 +346,10 @@ namespace FB
                     , fxns<is_small>::template type<T>::static_delete
                     , fxns<is_small>::template type<T>::clone
                     , fxns<is_small>::template type<T>::move
+                    , fxns<is_small>::template type<T>::rvalue_assign
+                    , fxns<is_small>::template type<T>::relocate
                     , fxns<is_small>::template type<T>::lessthan
+                    , tag_of<T>::value
                 };
                 return &static_table;
             }
@@ -286,14 +427,14 @@ namespace FB
         template <typename T>
         variant(const T& x, bool) {
             table = variant_detail::get_table<variant_detail::empty>::get();
-            object = NULL;
+            object.ptr = NULL;
             assign(x, true);
         }
 
         template <typename T>
         variant(const T& x) {
             table = variant_detail::get_table<variant_detail::empty>::get();
-            object = NULL;
+            object.ptr = NULL;
             assign(x);
         }
 
@@ -304,7 +445,7 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         variant() {
             table = variant_detail::get_table<variant_detail::empty>::get();
-            object = NULL;
+            object.ptr = NULL;
         }
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -318,13 +459,50 @@ namespace FB
             *this = x;
         }
 
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn variant::variant(variant&& x)
+        ///
+        /// @brief  Move constructor; steals the payload of the expiring variant instead of cloning it,
+        ///         leaving the source empty
+        ///
+        /// @param  x   The variant to move from
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        variant(variant&& x) {
+            table = variant_detail::get_table<variant_detail::empty>::get();
+            object.ptr = NULL;
+            swap(x);
+        }
+
+        variant(std::string&& x) {
+            table = variant_detail::get_table<variant_detail::empty>::get();
+            object.ptr = NULL;
+            assign(std::move(x));
+        }
+        variant(std::wstring&& x) {
+            table = variant_detail::get_table<variant_detail::empty>::get();
+            object.ptr = NULL;
+            assign(std::move(x));
+        }
+        variant(std::vector<variant>&& x) {
+            table = variant_detail::get_table<variant_detail::empty>::get();
+            object.ptr = NULL;
+            assign(std::move(x));
+        }
+        variant(FB::VariantMap&& x) {
+            table = variant_detail::get_table<variant_detail::empty>::get();
+            object.ptr = NULL;
+            assign(std::move(x));
+        }
+#endif
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn variant::~variant()
         ///
         /// @brief  Finaliser. Deletes the value from memory as part of cleanup
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         ~variant() {
-            table->static_delete(&object);
+            table->static_delete(&object.ptr);
         }
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -340,11 +518,11 @@ namespace FB
             // are we copying between the same type?
             if (table == x.table) {
                 // if so, we can avoid reallocation
-                table->move(&x.object, &object);
+                table->move(&x.object.ptr, &object.ptr);
             }
             else {
                 reset();
-                x.table->clone(&x.object, &object);                          
+                x.table->clone(&x.object.ptr, &object.ptr);                          
                 table = x.table;
             }
             return *this;
@@ -385,33 +563,105 @@ namespace FB
             // are we copying between the same type?
             variant_detail::fxn_ptr_table* x_table = variant_detail::get_table<T>::get();
             if (table == x_table) {
-                // if so, we can avoid deallocating and resuse memory 
-                if (sizeof(T) <= sizeof(void*)) {
-                    // create copy on-top of object pointer itself
-                    new(&object) T(x);
+                // if so, we can avoid deallocating and reuse memory
+                if (variant_detail::get_table<T>::is_small) {
+                    // destroy the old payload and rebuild in the inline storage
+                    reinterpret_cast<T*>(&object.ptr)->~T();
+                    new(&object.ptr) T(x);
                 }
                 else {
-                    // create copy on-top of old version
-                    new(object) T(x);
+                    // assign on top of the old version if nobody else shares it,
+                    // reusing its allocation; otherwise box up a fresh copy
+                    variant_detail::big_box<T>* box = reinterpret_cast<variant_detail::big_box<T>*>(object.ptr);
+                    if (box->refs == 1) {
+                        box->value = x;
+                    } else {
+                        object.ptr = new variant_detail::big_box<T>(x);
+                        if (--box->refs == 0)
+                            delete box;
+                    }
                 }
             }
-            else {        
+            else {
                 reset();
-                if (sizeof(T) <= sizeof(void*)) {
-                    // create copy on-top of object pointer itself
-                    new(&object) T(x);
-                    // update table pointer 
+                if (variant_detail::get_table<T>::is_small) {
+                    // create copy inside the inline storage
+                    new(&object.ptr) T(x);
+                    // update table pointer
                     table = x_table;
                 }
                 else {
-                    object = new T(x);          
+                    object.ptr = new variant_detail::big_box<T>(x);
                     table = x_table;
                 }
             }
             return *this;
         }
 
-        // assignment operator 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn variant& variant::assign(const char* str, size_t len)
+        ///
+        /// @brief  Assigns a utf8 string payload directly from a character range
+        ///
+        /// The std::string is built (or reused, if this variant already holds a string) in place, so
+        /// the text is copied exactly once.  Used on the browser glue hot paths where the source is
+        /// a browser-owned buffer that must not be referenced past the call.
+        ///
+        /// @since 1.5
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        variant& assign(const char* str, size_t len)
+        {
+            variant_detail::fxn_ptr_table* x_table = variant_detail::get_table<std::string>::get();
+            if (table == x_table) {
+                // same type; reuse the string's existing capacity
+                reinterpret_cast<std::string*>(&object.ptr)->assign(str, len);
+            } else {
+                reset();
+                new(&object.ptr) std::string(str, len);
+                table = x_table;
+            }
+            return *this;
+        }
+
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn variant& variant::assign(variant&& x)
+        ///
+        /// @brief  Assigns a new value from an expiring variant; no payload is copied.  If both
+        ///         variants hold the same type the existing allocation is reused and the payload
+        ///         is move-assigned, otherwise the storage is simply stolen.
+        ///
+        /// @param  x   The variant to move from
+        ///
+        /// @return *this
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        variant& assign(variant&& x) {
+            if (this == &x) {
+                return *this;
+            }
+            // are we moving between the same type?
+            if (table == x.table) {
+                // if so, we can reuse our allocation and steal the payload
+                table->rvalue_assign(&x.object.ptr, &object.ptr);
+            }
+            else {
+                reset();
+                swap(x);
+            }
+            return *this;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief  Emplace-style assignment for the heavyweight payload types (strings, VariantList,
+        ///         VariantMap); the value is moved into the variant rather than copied
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        variant& assign(std::string&& x) { return moveAssignValue(x); }
+        variant& assign(std::wstring&& x) { return moveAssignValue(x); }
+        variant& assign(std::vector<variant>&& x) { return moveAssignValue(x); }
+        variant& assign(FB::VariantMap&& x) { return moveAssignValue(x); }
+#endif
+
+        // assignment operator
         template<typename T>
         variant& operator=(T const& x) {
             return assign(x);
@@ -423,10 +673,26 @@ namespace FB
             return assign(rh);
         }
 
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+        // assignment move operator
+        variant& operator=(variant&& rh) {
+            return assign(std::move(rh));
+        }
+#endif
+
         // utility functions
         variant& swap(variant& x) {
-            std::swap(table, x.table);
-            std::swap(object, x.object);
+            if (this == &x)
+                return *this;
+            // the storage has to be relocated type-aware rather than byte-swapped,
+            // since inline payloads may contain pointers into themselves
+            variant_detail::variant_storage tmp;
+            variant_detail::fxn_ptr_table* tmp_table = table;
+            table->relocate(&object.ptr, &tmp.ptr);
+            x.table->relocate(&x.object.ptr, &object.ptr);
+            table = x.table;
+            tmp_table->relocate(&tmp.ptr, &x.object.ptr);
+            x.table = tmp_table;
             return *this;
         }
 
@@ -436,15 +702,25 @@ namespace FB
             return lessthan(rh);
         }
 
-        // comparison function
+        // comparison function; compares the compact type tag before falling back on
+        // typeid names, so ordering the common key types never touches RTTI.  The
+        // order is lexicographic on (tag, type name): every tagged type holds a
+        // distinct tag, and untagged types all share tag_generic, so this stays a
+        // strict weak ordering
         bool lessthan(const variant& rh) const {
-            if (get_type() == rh.get_type()) {
-                return table->less(&object, &rh.object);
-            } else {
-                std::string left = get_type().name();
-                std::string right = rh.get_type().name();
-                return left < right;
+            const variant_detail::variant_tag lt = table->tag;
+            const variant_detail::variant_tag rt = rh.table->tag;
+            if (lt != rt)
+                return lt < rt;
+            if (lt == variant_detail::tag_string) {
+                // strings dominate map keys; compare the payloads directly
+                // (char_traits::compare, i.e. memcmp) without the vtable hop
+                return reinterpret_cast<const std::string&>(object) <
+                       reinterpret_cast<const std::string&>(rh.object);
             }
+            if (lt != variant_detail::tag_generic || get_type() == rh.get_type())
+                return table->less(&object.ptr, &rh.object.ptr);
+            return std::strcmp(get_type().name(), rh.get_type().name()) < 0;
         }
 
         ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -458,6 +734,16 @@ namespace FB
             return table->get_type();
         }
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn variant_detail::variant_tag variant::get_tag() const
+        ///
+        /// @brief  Gets the compact type tag of the stored value; tag_generic for any type that is not
+        ///         part of the numeric/bool/string fast path
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        variant_detail::variant_tag get_tag() const {
+            return table->tag;
+        }
+
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         /// @fn template<typename T> bool variant::is_of_type() const
         ///
@@ -518,14 +804,18 @@ namespace FB
         ////////////////////////////////////////////////////////////////////////////////////////////////////
         template<typename T>
         const T& cast() const {
-            if (get_type() != typeid(T)) {
+            // tagged types can be checked with an integer compare; only generic
+            // types still need the type_info comparison
+            if (variant_detail::tag_of<T>::value != variant_detail::tag_generic
+                ? get_tag() != variant_detail::tag_of<T>::value
+                : get_type() != typeid(T)) {
                 throw bad_variant_cast(get_type(), typeid(T));
             }
-            if (sizeof(T) <= sizeof(void*)) {
-                return *reinterpret_cast<T const*>(&object);
+            if (variant_detail::get_table<T>::is_small) {
+                return *reinterpret_cast<T const*>(&object.ptr);
             }
             else {
-                return *reinterpret_cast<T const*>(object);
+                return reinterpret_cast<variant_detail::big_box<T> const*>(object.ptr)->value;
             }
         }
 
@@ -575,9 +865,9 @@ namespace FB
         void reset()
         {
             if (empty()) return; 
-            table->static_delete(&object);
+            table->static_delete(&object.ptr);
             table = variant_detail::get_table<variant_detail::empty>::get();
-            object = NULL;
+            object.ptr = NULL;
         }
         
     private:
@@ -586,13 +876,56 @@ namespace FB
             return cast<T>();
         }
 
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+        // shared implementation of the emplace-style assign overloads
+        template<typename T>
+        variant& moveAssignValue(T& x)
+        {
+            variant_detail::fxn_ptr_table* x_table = variant_detail::get_table<T>::get();
+            if (table == x_table) {
+                // the old payload is still alive, so move-assign to reuse its capacity
+                if (variant_detail::get_table<T>::is_small) {
+                    *reinterpret_cast<T*>(&object.ptr) = std::move(x);
+                } else {
+                    variant_detail::big_box<T>* box = reinterpret_cast<variant_detail::big_box<T>*>(object.ptr);
+                    if (box->refs == 1) {
+                        box->value = std::move(x);
+                    } else {
+                        object.ptr = new variant_detail::big_box<T>(std::move(x));
+                        if (--box->refs == 0)
+                            delete box;
+                    }
+                }
+            }
+            else {
+                reset();
+                if (variant_detail::get_table<T>::is_small) {
+                    new(&object.ptr) T(std::move(x));
+                } else {
+                    object.ptr = new variant_detail::big_box<T>(std::move(x));
+                }
+                table = x_table;
+            }
+            return *this;
+        }
+#endif
+
         // fields
-        variant_detail::fxn_ptr_table* table;      
-        void* object;
+        variant_detail::fxn_ptr_table* table;
+        variant_detail::variant_storage object;
     };
 
     template <>
     inline const std::string variant::convert_cast<std::string>() const {
+        // fast path on the compact tag for the common string cases
+        switch (get_tag()) {
+        case variant_detail::tag_string:
+            return cast<std::string>();
+        case variant_detail::tag_wstring:
+            return wstring_to_utf8(cast<std::wstring>());
+        default:
+            break;
+        }
         variant var = *this;
         FB_BEGIN_CONVERT_MAP(std::string);
         FB_CONVERT_ENTRY_TO_STRING(double);
@@ -618,6 +951,15 @@ namespace FB
 
     template<>
     inline const std::wstring variant::convert_cast<std::wstring>() const {
+        // fast path on the compact tag for the common string cases
+        switch (get_tag()) {
+        case variant_detail::tag_wstring:
+            return cast<std::wstring>();
+        case variant_detail::tag_string:
+            return utf8_to_wstring(cast<std::string>());
+        default:
+            break;
+        }
         variant var = *this;
         FB_BEGIN_CONVERT_MAP(std::wstring);
         FB_CONVERT_ENTRY_TO_WSTRING(double);
@@ -641,6 +983,17 @@ namespace FB
     
     template<>
     inline const bool variant::convert_cast<bool>() const {
+        // fast path on the compact tag; anything tagged and non-string is numeric
+        switch (get_tag()) {
+        case variant_detail::tag_bool:
+            return cast<bool>();
+        case variant_detail::tag_string:
+        case variant_detail::tag_wstring:
+        case variant_detail::tag_generic:
+            break;
+        default:
+            return convert_cast<long>() != 0;
+        }
         variant var = *this;
         FB_BEGIN_CONVERT_MAP(bool);
         FB_CONVERT_ENTRY_COMPLEX_BEGIN(std::string, str);
@@ -672,7 +1025,7 @@ namespace FB
                     boost::mpl::or_<
                         boost::mpl::or_<
                             boost::is_same<std::vector<variant>, T>,
-                            boost::is_same<std::map<std::string, variant>, T>
+                            boost::is_same<FB::VariantMap, T>
                         >,
                         boost::mpl::or_<
                             boost::is_same<std::wstring, T>,
@@ -789,9 +1142,38 @@ namespace FB
                 return var.convert_cast<T>();
             }
 
+            // numeric_cast with the conversion failure mapped onto bad_variant_cast,
+            // shared by the tag switch below
+            template <typename To, typename From>
+            inline To tag_numeric_convert(const variant& var) {
+                try {
+                    return boost::numeric_cast<To>(var.cast<From>());
+                } catch (const boost::numeric::bad_numeric_cast&) {
+                    throw bad_variant_cast(var.get_type(), typeid(To));
+                }
+            }
+
             template<typename T>
             typename FB::meta::enable_for_numbers<T, T>::type
             convert_variant(const variant& var, const type_spec<T>&) {
+                // fast path: switch on the compact tag so the common numeric/bool
+                // coercions never touch typeid or the conversion chain below
+                switch (var.get_tag()) {
+                case tag_bool:      return static_cast<T>(var.cast<bool>() ? 1 : 0);
+                case tag_char:      return tag_numeric_convert<T, char>(var);
+                case tag_uchar:     return tag_numeric_convert<T, unsigned char>(var);
+                case tag_short:     return tag_numeric_convert<T, short>(var);
+                case tag_ushort:    return tag_numeric_convert<T, unsigned short>(var);
+                case tag_int:       return tag_numeric_convert<T, int>(var);
+                case tag_uint:      return tag_numeric_convert<T, unsigned int>(var);
+                case tag_long:      return tag_numeric_convert<T, long>(var);
+                case tag_ulong:     return tag_numeric_convert<T, unsigned long>(var);
+                case tag_longlong:  return tag_numeric_convert<T, long long>(var);
+                case tag_ulonglong: return tag_numeric_convert<T, unsigned long long>(var);
+                case tag_float:     return tag_numeric_convert<T, float>(var);
+                case tag_double:    return tag_numeric_convert<T, double>(var);
+                default:            break;
+                }
                 FB_BEGIN_CONVERT_MAP(T)
                 FB_CONVERT_ENTRY_NUMERIC(T, char)
                 FB_CONVERT_ENTRY_NUMERIC(T, unsigned char)
@@ -823,11 +1205,35 @@ namespace FB
     template <class T>
     variant make_variant(T t)
     {
-        // If you got an error on this line, you are trying to assign an unsupported type to 
+        // If you got an error on this line, you are trying to assign an unsupported type to
         // FB::variant! If you're certain you want to do this then you should use the constructor
         // or assign method that takes a bool.  e.g.: variant tmp(myWeirdType, true);
         return variant_detail::conversion::make_variant(t);
     }
+
+    // The numeric convert_cast instantiations are heavy (the tag switch in
+    // convert_variant plus the typeid conversion chain it falls back to) and
+    // identical in every translation unit of every plugin.  They are compiled
+    // once in variant_instantiations.cpp; these declarations keep other
+    // translation units from emitting their own copies, which shrinks the
+    // shipped binary and speeds up both linking and cold-start page-in.
+    // string, wstring and bool are explicit inline specializations above and
+    // need no instantiation.  Compilers without the extern template extension
+    // simply keep the old per-TU behavior.
+#if defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1400)
+#define FB_EXTERN_CONVERT_CAST(T) extern template const T variant::convert_cast<T>() const;
+    FB_EXTERN_CONVERT_CAST(short)
+    FB_EXTERN_CONVERT_CAST(unsigned short)
+    FB_EXTERN_CONVERT_CAST(int)
+    FB_EXTERN_CONVERT_CAST(unsigned int)
+    FB_EXTERN_CONVERT_CAST(long)
+    FB_EXTERN_CONVERT_CAST(unsigned long)
+    FB_EXTERN_CONVERT_CAST(long long)
+    FB_EXTERN_CONVERT_CAST(unsigned long long)
+    FB_EXTERN_CONVERT_CAST(float)
+    FB_EXTERN_CONVERT_CAST(double)
+#undef FB_EXTERN_CONVERT_CAST
+#endif
 }
 
 #ifdef _WIN32
@@ -0,0 +1,36 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+// The one place the common numeric variant::convert_cast instantiations are
+// actually compiled; every other translation unit sees the extern template
+// declarations at the bottom of variant.h and just references these.
+
+#include "variant.h"
+
+namespace FB {
+
+#define FB_INSTANTIATE_CONVERT_CAST(T) template const T variant::convert_cast<T>() const;
+    FB_INSTANTIATE_CONVERT_CAST(short)
+    FB_INSTANTIATE_CONVERT_CAST(unsigned short)
+    FB_INSTANTIATE_CONVERT_CAST(int)
+    FB_INSTANTIATE_CONVERT_CAST(unsigned int)
+    FB_INSTANTIATE_CONVERT_CAST(long)
+    FB_INSTANTIATE_CONVERT_CAST(unsigned long)
+    FB_INSTANTIATE_CONVERT_CAST(long long)
+    FB_INSTANTIATE_CONVERT_CAST(unsigned long long)
+    FB_INSTANTIATE_CONVERT_CAST(float)
+    FB_INSTANTIATE_CONVERT_CAST(double)
+#undef FB_INSTANTIATE_CONVERT_CAST
+
+}
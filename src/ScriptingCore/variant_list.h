@@ -73,6 +73,19 @@ namespace FB
                               FB::VariantList::const_iterator end,
                               OutputIterator result);
 
+    /// @brief Convert a FB::VariantList into a caller-provided buffer in one pass.
+    /// @param from The input list.
+    /// @param out A buffer with room for at least from.size() elements.
+    ///
+    /// Checks the homogeneous-type case once (via the compact variant tags) and then runs a
+    /// tight per-type loop, so bulk numeric lists skip the generic conversion machinery;
+    /// mixed or unusual lists fall back to per-element convert_cast.
+    template<typename To>
+    inline void convert_variant_list_to_buffer(const FB::VariantList& from, To* out);
+    /// @brief Convenience overload that sizes a std::vector and converts into it.
+    template<typename To>
+    inline void convert_variant_list_to_buffer(const FB::VariantList& from, std::vector<To>& to);
+
     /// @brief Allows convenient creation of an FB::VariantList.
     /// @return A helper type that overloads operator() for insertion and is convertible to FB::VariantList.
     ///
@@ -85,6 +98,58 @@ namespace FB
     /// @brief Convenience overload to create an empty FB::VariantList.
     /// @return An empty FB::VariantList.
     inline FB::VariantList variant_list_of();
+    /// @brief Fixed-arity overloads that size the list exactly once; preferred over the
+    ///        chaining form for the common small argument lists.
+    inline FB::VariantList variant_list_of(FB::variant v1, FB::variant v2);
+    inline FB::VariantList variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3);
+    inline FB::VariantList variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4);
+    inline FB::VariantList variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5);
+    inline FB::VariantList variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5, FB::variant v6);
+    inline FB::VariantList variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5, FB::variant v6, FB::variant v7);
+    inline FB::VariantList variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5, FB::variant v6, FB::variant v7, FB::variant v8);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  VariantListBuilder
+    ///
+    /// @brief  Incremental VariantList builder that sizes the vector once up front and (where the
+    ///         compiler supports it) moves values into place, so building an argument list for
+    ///         FireEvent does a single allocation instead of reallocating on every push_back.
+    ///
+    /// Example:
+    /// @code
+    ///      FB::VariantListBuilder b(3);
+    ///      b.add(1).add("two").add(3.0);
+    ///      FB::VariantList args;
+    ///      b.take(args);
+    ///      FireEvent("onthing", args);
+    /// @endcode
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class VariantListBuilder
+    {
+    public:
+        explicit VariantListBuilder(size_t expected = 0) { m_l.reserve(expected); }
+
+        VariantListBuilder& add(const FB::variant& v) {
+            m_l.push_back(v);
+            return *this;
+        }
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+        VariantListBuilder& add(FB::variant&& v) {
+            m_l.push_back(std::move(v));
+            return *this;
+        }
+#endif
+        /// @brief Hands the built list to the caller, leaving the builder empty
+        FB::VariantList& take(FB::VariantList& out) {
+            out.swap(m_l);
+            m_l.clear();
+            return out;
+        }
+        const FB::VariantList& list() const { return m_l; }
+
+    private:
+        FB::VariantList m_l;
+    };
 
     ///////////////////////////////////
     // detail definitions
@@ -96,7 +161,13 @@ namespace FB
         {
         public:
             VariantListInserter() : m_l() {}
-            VariantListInserter(FB::variant v) : m_l(1, v) {}
+            VariantListInserter(FB::variant v) : m_l()
+            {
+                // typical FireEvent argument lists are small; one up-front
+                // reservation avoids reallocating on every chained insert
+                m_l.reserve(8);
+                m_l.push_back(v);
+            }
             VariantListInserter& operator()(FB::variant v)
             {
                 m_l.insert(m_l.end(), v);
@@ -126,6 +197,77 @@ namespace FB
         return FB::VariantList();
     }
 
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+#define FB_VLO_PUSH(_v_) result.push_back(std::move(_v_))
+#else
+#define FB_VLO_PUSH(_v_) result.push_back(_v_)
+#endif
+
+    inline FB::VariantList
+    variant_list_of(FB::variant v1, FB::variant v2)
+    {
+        FB::VariantList result;
+        result.reserve(2);
+        FB_VLO_PUSH(v1); FB_VLO_PUSH(v2);
+        return result;
+    }
+
+    inline FB::VariantList
+    variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3)
+    {
+        FB::VariantList result;
+        result.reserve(3);
+        FB_VLO_PUSH(v1); FB_VLO_PUSH(v2); FB_VLO_PUSH(v3);
+        return result;
+    }
+
+    inline FB::VariantList
+    variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4)
+    {
+        FB::VariantList result;
+        result.reserve(4);
+        FB_VLO_PUSH(v1); FB_VLO_PUSH(v2); FB_VLO_PUSH(v3); FB_VLO_PUSH(v4);
+        return result;
+    }
+
+    inline FB::VariantList
+    variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5)
+    {
+        FB::VariantList result;
+        result.reserve(5);
+        FB_VLO_PUSH(v1); FB_VLO_PUSH(v2); FB_VLO_PUSH(v3); FB_VLO_PUSH(v4); FB_VLO_PUSH(v5);
+        return result;
+    }
+
+    inline FB::VariantList
+    variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5, FB::variant v6)
+    {
+        FB::VariantList result;
+        result.reserve(6);
+        FB_VLO_PUSH(v1); FB_VLO_PUSH(v2); FB_VLO_PUSH(v3); FB_VLO_PUSH(v4); FB_VLO_PUSH(v5); FB_VLO_PUSH(v6);
+        return result;
+    }
+
+    inline FB::VariantList
+    variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5, FB::variant v6, FB::variant v7)
+    {
+        FB::VariantList result;
+        result.reserve(7);
+        FB_VLO_PUSH(v1); FB_VLO_PUSH(v2); FB_VLO_PUSH(v3); FB_VLO_PUSH(v4); FB_VLO_PUSH(v5); FB_VLO_PUSH(v6); FB_VLO_PUSH(v7);
+        return result;
+    }
+
+    inline FB::VariantList
+    variant_list_of(FB::variant v1, FB::variant v2, FB::variant v3, FB::variant v4, FB::variant v5, FB::variant v6, FB::variant v7, FB::variant v8)
+    {
+        FB::VariantList result;
+        result.reserve(8);
+        FB_VLO_PUSH(v1); FB_VLO_PUSH(v2); FB_VLO_PUSH(v3); FB_VLO_PUSH(v4); FB_VLO_PUSH(v5); FB_VLO_PUSH(v6); FB_VLO_PUSH(v7); FB_VLO_PUSH(v8);
+        return result;
+    }
+
+#undef FB_VLO_PUSH
+
     template<class InputIterator>
     inline void make_variant_list(InputIterator begin, 
                            InputIterator end, 
@@ -183,6 +325,55 @@ namespace FB
     {
         convert_variant_list<typename Cont::value_type>(from.begin(), from.end(), std::back_inserter(to));
     }
+
+    namespace detail
+    {
+        // tight conversion loop for a list assumed to hold From throughout; bails out
+        // (possibly after partial writes) as soon as a different tag shows up
+        template<typename To, typename From>
+        inline bool convert_homogeneous_run(const FB::VariantList& from, To* out)
+        {
+            const FB::variant_detail::variant_tag expected = FB::variant_detail::tag_of<From>::value;
+            const size_t n = from.size();
+            for (size_t i = 0; i < n; ++i) {
+                if (from[i].get_tag() != expected)
+                    return false;
+                out[i] = FB::variant_detail::conversion::tag_numeric_convert<To, From>(from[i]);
+            }
+            return true;
+        }
+    }
+
+    template<typename To>
+    inline void convert_variant_list_to_buffer(const FB::VariantList& from, To* out)
+    {
+        using namespace FB::variant_detail;
+        if (from.empty())
+            return;
+        // homogeneous fast paths for the common bulk numeric types
+        switch (from[0].get_tag()) {
+        case tag_double: if (detail::convert_homogeneous_run<To, double>(from, out)) return; break;
+        case tag_float:  if (detail::convert_homogeneous_run<To, float>(from, out)) return; break;
+        case tag_int:    if (detail::convert_homogeneous_run<To, int>(from, out)) return; break;
+        case tag_uint:   if (detail::convert_homogeneous_run<To, unsigned int>(from, out)) return; break;
+        case tag_long:   if (detail::convert_homogeneous_run<To, long>(from, out)) return; break;
+        case tag_ulong:  if (detail::convert_homogeneous_run<To, unsigned long>(from, out)) return; break;
+        case tag_short:  if (detail::convert_homogeneous_run<To, short>(from, out)) return; break;
+        default: break;
+        }
+        // mixed or unusual lists: generic per-element conversion
+        const size_t n = from.size();
+        for (size_t i = 0; i < n; ++i)
+            out[i] = from[i].convert_cast<To>();
+    }
+
+    template<typename To>
+    inline void convert_variant_list_to_buffer(const FB::VariantList& from, std::vector<To>& to)
+    {
+        to.resize(from.size());
+        if (!to.empty())
+            convert_variant_list_to_buffer(from, &to[0]);
+    }
 }
 
 #endif
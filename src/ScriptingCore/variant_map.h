@@ -75,6 +75,13 @@ namespace FB
             {
                 return m_m;
             }
+            // FB::VariantMap is flat; build it from the already-sorted tree in
+            // one pass
+            operator boost::container::flat_map<T,FB::variant> ()
+            {
+                return boost::container::flat_map<T,FB::variant>(
+                    boost::container::ordered_unique_range, m_m.begin(), m_m.end());
+            }
         private:
             std::map<T,FB::variant> m_m;
         };
@@ -0,0 +1,87 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#ifdef _WIN32
+#include "win_targetver.h"
+#endif
+
+#include <curl/curl.h>
+
+#include "CurlHandlePool.h"
+
+using namespace HTTP;
+
+namespace {
+    const std::time_t max_idle_sec = 120;   // a poller at 1/sec stays warm; abandoned hosts age out
+    const size_t max_idle_per_key = 4;
+}
+
+/*static*/ CurlHandlePool& CurlHandlePool::getInstance() {
+  static CurlHandlePool instance;
+  return instance;
+}
+
+CurlHandlePool::CurlHandlePool() {
+}
+
+CurlHandlePool::~CurlHandlePool() {
+  for (PoolMap::iterator it = pool.begin(); it != pool.end(); ++it) {
+    for (std::list<IdleHandle>::iterator h = it->second.begin(); h != it->second.end(); ++h)
+      curl_easy_cleanup(h->handle);
+  }
+}
+
+CURL* CurlHandlePool::acquire(const std::string& key) {
+  evictStale(std::time(NULL));
+
+  PoolMap::iterator it = pool.find(key);
+  if (it != pool.end() && ! it->second.empty()) {
+    CURL* handle = it->second.front().handle;
+    it->second.pop_front();
+    if (it->second.empty())
+      pool.erase(it);
+    // back to pristine options; the handle keeps its session caches
+    curl_easy_reset(handle);
+    return handle;
+  }
+  return curl_easy_init();
+}
+
+void CurlHandlePool::release(const std::string& key, CURL* handle) {
+  const std::time_t now = std::time(NULL);
+  evictStale(now);
+
+  std::list<IdleHandle>& idle = pool[key];
+  if (idle.size() >= max_idle_per_key) {
+    curl_easy_cleanup(handle);
+    return;
+  }
+  IdleHandle entry = { handle, now };
+  idle.push_back(entry);
+}
+
+void CurlHandlePool::evictStale(std::time_t now) {
+  for (PoolMap::iterator it = pool.begin(); it != pool.end(); ) {
+    std::list<IdleHandle>& idle = it->second;
+    // lists are in release order, so stale entries sit at the front
+    while (! idle.empty() && now - idle.front().released > max_idle_sec) {
+      curl_easy_cleanup(idle.front().handle);
+      idle.pop_front();
+    }
+    if (idle.empty())
+      pool.erase(it++);
+    else
+      ++it;
+  }
+}
@@ -0,0 +1,62 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTP_CURLHANDLEPOOL
+#define H_HTTP_CURLHANDLEPOOL
+
+#include <list>
+#include <map>
+#include <string>
+#include <ctime>
+#include <boost/noncopyable.hpp>
+
+// same compatible-typedef trick as CurlMultiReactor.h
+typedef void CURL;
+
+namespace HTTP {
+    // Pool of idle curl easy handles keyed by scheme://host:port.  A reused
+    // handle keeps its TLS session cache and DNS entries, and the shared
+    // multi stack keeps its TCP connection alive between transfers, so a
+    // 1/sec poll against the same host skips the handshake entirely.
+    //
+    // Not locked: acquire and release both happen on the CurlMultiReactor
+    // thread (request setup and completion run there).
+    class CurlHandlePool : boost::noncopyable {
+    public:
+        static CurlHandlePool& getInstance();
+
+        // returns a reset pooled handle for the key, or a fresh one
+        CURL* acquire(const std::string& key);
+        // returns a handle to the pool after its transfer finishes; the
+        // pool may destroy it instead if the key's idle list is full
+        void release(const std::string& key, CURL* handle);
+
+    protected:
+        CurlHandlePool();
+        ~CurlHandlePool();
+
+        // drops handles that have sat idle longer than max_idle_sec
+        void evictStale(std::time_t now);
+
+        struct IdleHandle {
+            CURL* handle;
+            std::time_t released;
+        };
+        typedef std::map<std::string, std::list<IdleHandle> > PoolMap;
+        PoolMap pool;
+    };
+};
+
+#endif // H_HTTP_CURLHANDLEPOOL
@@ -0,0 +1,115 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#ifdef _WIN32
+#include "win_targetver.h"
+#endif
+
+#include <curl/curl.h>
+#include <boost/bind.hpp>
+
+#include "CurlMultiReactor.h"
+
+using namespace HTTP;
+
+/*static*/ CurlMultiReactor& CurlMultiReactor::getInstance() {
+  static CurlMultiReactor instance;
+  return instance;
+}
+
+CurlMultiReactor::CurlMultiReactor()
+  : multi(curl_multi_init()), m_shutdown(false),
+    m_thread(boost::bind(&CurlMultiReactor::run, this)) {
+}
+
+CurlMultiReactor::~CurlMultiReactor() {
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_thread.join();
+  curl_multi_cleanup(multi);
+}
+
+void CurlMultiReactor::post(const TaskType& task) {
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  tasks.push_back(task);
+}
+
+void CurlMultiReactor::addHandle(CURL* handle, const CompletionCallback& callback) {
+  // reactor thread only, so `active` needs no lock here
+  active[handle] = callback;
+  curl_multi_add_handle(multi, handle);
+}
+
+void CurlMultiReactor::run() {
+  for (;;) {
+    std::list<TaskType> pending;
+    bool stopping;
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      pending.swap(tasks);
+      stopping = m_shutdown;
+    }
+    if (stopping) {
+      // abort whatever is still in flight; each callback cleans up its handle
+      for (std::map<CURL*, CompletionCallback>::iterator it = active.begin(); it != active.end(); ++it) {
+        curl_multi_remove_handle(multi, it->first);
+        it->second(CURLE_ABORTED_BY_CALLBACK);
+      }
+      active.clear();
+      break;
+    }
+    for (std::list<TaskType>::iterator it = pending.begin(); it != pending.end(); ++it)
+      (*it)();
+
+    int running = 0;
+    while (curl_multi_perform(multi, &running) == CURLM_CALL_MULTI_PERFORM) { }
+
+    int msgs_left = 0;
+    CURLMsg* msg;
+    while ((msg = curl_multi_info_read(multi, &msgs_left)) != NULL) {
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+      CURL* handle = msg->easy_handle;
+      const CURLcode result = msg->data.result;
+      curl_multi_remove_handle(multi, handle);
+      std::map<CURL*, CompletionCallback>::iterator it = active.find(handle);
+      if (it != active.end()) {
+        CompletionCallback cb = it->second;
+        active.erase(it);
+        cb(result);
+      }
+    }
+
+    // wait for socket activity, capped so freshly posted tasks are seen soon
+    long timeout_ms = -1;
+    curl_multi_timeout(multi, &timeout_ms);
+    if (timeout_ms < 0 || timeout_ms > 50)
+      timeout_ms = 50;
+
+    fd_set fdread, fdwrite, fdexcep;
+    FD_ZERO(&fdread); FD_ZERO(&fdwrite); FD_ZERO(&fdexcep);
+    int maxfd = -1;
+    curl_multi_fdset(multi, &fdread, &fdwrite, &fdexcep, &maxfd);
+    if (maxfd == -1) {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(timeout_ms));
+    } else {
+      struct timeval tv;
+      tv.tv_sec = timeout_ms / 1000;
+      tv.tv_usec = (timeout_ms % 1000) * 1000;
+      select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &tv);
+    }
+  }
+}
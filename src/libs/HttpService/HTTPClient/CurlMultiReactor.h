@@ -0,0 +1,69 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTP_CURLMULTIREACTOR
+#define H_HTTP_CURLMULTIREACTOR
+
+#include <list>
+#include <map>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+
+// mirror HTTPRequest.h's trick of not dragging curl.h into the header;
+// curl.h itself typedefs these to void, so the definitions are compatible
+typedef void CURL;
+typedef void CURLM;
+
+namespace HTTP {
+    // Shared curl_multi event loop.  One thread drives every transfer in
+    // the process, so concurrency is bounded by sockets rather than by
+    // per-request threads and their stacks.  Requests are configured on
+    // this thread too (posted as tasks) and completions are delivered from
+    // it; anything long-running belongs on a worker, not in a callback.
+    class CurlMultiReactor : boost::noncopyable {
+    public:
+        // receives the transfer's CURLcode (passed as int to keep curl
+        // types out of this header)
+        typedef boost::function<void (int)> CompletionCallback;
+        typedef boost::function<void ()> TaskType;
+
+        static CurlMultiReactor& getInstance();
+
+        // queues a task to run on the reactor thread; the loop picks it up
+        // within ~50ms even when all transfers are idle
+        void post(const TaskType& task);
+
+        // registers a fully-configured easy handle with the multi stack.
+        // Must be called from the reactor thread (i.e. from a posted task);
+        // the callback fires on the reactor thread when the transfer ends
+        // and is responsible for cleaning up the handle
+        void addHandle(CURL* handle, const CompletionCallback& callback);
+
+    protected:
+        CurlMultiReactor();
+        ~CurlMultiReactor();
+        void run();
+
+        CURLM* multi;
+        std::map<CURL*, CompletionCallback> active;
+        std::list<TaskType> tasks;
+        boost::mutex m_mutex;
+        bool m_shutdown;
+        boost::thread m_thread;     // must be last; runs as soon as it's constructed
+    };
+};
+
+#endif // H_HTTP_CURLMULTIREACTOR
@@ -0,0 +1,56 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#ifdef _WIN32
+#include "win_targetver.h"
+#endif
+
+#include <curl/curl.h>
+#include <boost/thread/mutex.hpp>
+
+#include "CurlShareCache.h"
+
+using namespace HTTP;
+
+namespace {
+    // one mutex per curl lock-data slot; curl names the slot in the callback
+    boost::mutex share_locks[CURL_LOCK_DATA_LAST];
+
+    void share_lock(CURL*, curl_lock_data data, curl_lock_access, void*) {
+        share_locks[data].lock();
+    }
+
+    void share_unlock(CURL*, curl_lock_data data, void*) {
+        share_locks[data].unlock();
+    }
+}
+
+/*static*/ CurlShareCache& CurlShareCache::getInstance() {
+  static CurlShareCache* instance = new CurlShareCache;
+  return *instance;
+}
+
+CurlShareCache::CurlShareCache() {
+  CURLSH* sh = curl_share_init();
+  curl_share_setopt(sh, CURLSHOPT_LOCKFUNC, share_lock);
+  curl_share_setopt(sh, CURLSHOPT_UNLOCKFUNC, share_unlock);
+  curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(sh, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  share = sh;
+}
+
+CurlShareCache::~CurlShareCache() {
+  // see the header: intentionally unreached (heap singleton, never deleted)
+  curl_share_cleanup(share);
+}
@@ -0,0 +1,52 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTP_CURLSHARECACHE
+#define H_HTTP_CURLSHARECACHE
+
+#include <boost/noncopyable.hpp>
+
+// same compatible-typedef trick as CurlMultiReactor.h
+typedef void CURLSH;
+
+namespace HTTP {
+    // Process-wide curl share object holding the DNS resolver cache and the
+    // TLS session-ticket cache.  Every easy handle attaches to it at setup,
+    // so even a request that cannot reuse a pooled connection skips the
+    // resolve (curl honors its cache TTL) and resumes the TLS session
+    // instead of paying a full handshake.  The handle pool covers repeat
+    // requests to one host; this covers first requests on fresh handles too.
+    //
+    // The share is guarded by curl's lock callbacks (one mutex per data
+    // slot), so handles on any thread may attach safely.
+    class CurlShareCache : boost::noncopyable {
+    public:
+        static CurlShareCache& getInstance();
+
+        // the CURLSH* to pass to CURLOPT_SHARE; never NULL
+        CURLSH* getShare() const { return share; }
+
+    protected:
+        CurlShareCache();
+        // Never destroyed: pooled easy handles in other translation units are
+        // cleaned up during static destruction too, and curl requires the
+        // share to outlive every handle that ever attached to it
+        ~CurlShareCache();
+
+        CURLSH* share;
+    };
+};
+
+#endif // H_HTTP_CURLSHARECACHE
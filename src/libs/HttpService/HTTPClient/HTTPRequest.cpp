@@ -19,6 +19,7 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
+#include <boost/static_assert.hpp>
 #include <boost/lexical_cast.hpp>
 #include <cassert>
 #include <openssl/ssl.h>
@@ -29,6 +30,10 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 #include "../HTTPCommon/Utils.h"
 
 #include "HTTPRequest.h"
+#include "CurlMultiReactor.h"
+#include "CurlHandlePool.h"
+#include "CurlShareCache.h"
+#include "HTTPResponseCache.h"
 using namespace boost::algorithm;
 using namespace boost::asio;
 using namespace boost::asio::ip;
@@ -182,16 +187,17 @@ void HTTPRequest::threadSafeDestroy() {
   boost::thread t(boost::bind(&HTTPRequest::_internal_threadSafeDestroy, this));
 }
 
-HTTPRequest::HTTPRequest() : req(NULL), cancellation_requested(false), status_callback(onStatusChanged_do_nothing) {
-
+HTTPRequest::HTTPRequest() : req(NULL), cancellation_requested(false), status_callback(onStatusChanged_do_nothing),
+    formpost(NULL), headerlist(NULL), request_submitted(false), request_finished(false) {
+  BOOST_STATIC_ASSERT(sizeof(errorbuffer) >= CURL_ERROR_SIZE);
 }
 
 HTTPRequest::~HTTPRequest() {
-  if (worker_thread) {
+  if (request_submitted) {
     if (! cancellation_requested) {
       if (!(last_status.state == Status::IDLE || last_status.state == Status::COMPLETE || last_status.state == Status::HTTP_ERROR)) {
 #ifndef NDEBUG
-        printf("HTTPRequest: destroyed with active worker thread, probably bad.\n");
+        printf("HTTPRequest: destroyed with active transfer, probably bad.\n");
 #endif
       }
       cancel();
@@ -205,7 +211,9 @@ void HTTPRequest::cancel() {
 }
 
 void HTTPRequest::awaitCompletion() {
-  worker_thread->join();
+  boost::unique_lock<boost::mutex> lock(m_mutex);
+  while (! request_finished)
+    m_cond.wait(lock);
 }
 
 HTTP::Status HTTPRequest::getStatus() const {
@@ -227,9 +235,38 @@ boost::shared_ptr<HTTPResponseData> HTTPRequest::getResponse() {
 void HTTPRequest::startRequest(boost::shared_ptr<HTTPRequestData> _request_data) {
     request_data = _request_data;
   proxy_config = static_proxy_config;
-  
-  // We build the HTTP request in another thread to avoid blocking the caller if the request is large or resolving the size of the attached content takes a while.
-    worker_thread = boost::shared_ptr<thread>(new thread(boost::bind(&HTTPRequest::startRequest_thread, this)));
+  request_submitted = true;
+
+  // Plain GETs go through the response cache: a fresh hit is served right
+  // here on the caller's thread, and a stale entry with validators turns
+  // into a conditional request that transfer_complete resolves on a 304.
+  HTTPResponseCache& cache = HTTPResponseCache::getInstance();
+  const bool cacheable = cache.enabled()
+      && (request_data->method.empty() || request_data->method == "GET")
+      && request_data->files.empty() && request_data->uri.query_data.empty();
+  if (cacheable) {
+    cache_url = request_data->uri.toString();
+    if (cache.getFresh(cache_url, response_data)) {
+      last_status.state = Status::COMPLETE;
+      {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        request_finished = true;
+        m_cond.notify_all();
+      }
+      status_callback(last_status);
+      return;
+    }
+    std::string etag, last_modified;
+    if (cache.getValidators(cache_url, etag, last_modified)) {
+      if (!etag.empty())
+        request_data->headers.insert(std::make_pair("If-None-Match", etag));
+      if (!last_modified.empty())
+        request_data->headers.insert(std::make_pair("If-Modified-Since", last_modified));
+    }
+  }
+
+  // We build the HTTP request on the reactor thread to avoid blocking the caller if the request is large or resolving the size of the attached content takes a while.
+  CurlMultiReactor::getInstance().post(boost::bind(&HTTPRequest::setup_and_submit, this));
 }
 
 static size_t httprequest_writefn(void* ptr, size_t size, size_t nmemb, HTTPResponseData* resp) {
@@ -249,19 +286,31 @@ static size_t httprequest_header(void *ptr, size_t size, size_t nmemb, void *cli
   return size * nmemb;
 }
 
-void HTTPRequest::startRequest_thread() {
-  struct curl_httppost* formpost = NULL;
+void HTTPRequest::setup_and_submit() {
   struct curl_httppost* lastptr = NULL;
-  struct curl_slist* headerlist = NULL;
-  
-  char errorbuffer[CURL_ERROR_SIZE];
+
+  errorbuffer[0] = '\0';
 
   try {
     response_data = boost::shared_ptr<HTTPResponseData>(new HTTPResponseData);
 
-    req = curl_easy_init();
-    
+    if (cancellation_requested) { // cancelled while queued behind other setups
+      transfer_complete(CURLE_ABORTED_BY_CALLBACK);
+      return;
+    }
+
+    pool_key = request_data->uri.protocol + "://" + request_data->uri.domain
+             + ":" + lexical_cast<string>(request_data->uri.port);
+    req = CurlHandlePool::getInstance().acquire(pool_key);
+
     curl_easy_setopt(req, CURLOPT_NOSIGNAL, 1); // disable signals for multithreaded use
+
+    // Every handle -- pooled or fresh -- attaches to the process-wide share so
+    // DNS results and TLS session tickets carry across handles; curl_easy_reset
+    // in the pool detaches it, so this is re-set on every transfer
+    curl_easy_setopt(req, CURLOPT_SHARE, CurlShareCache::getInstance().getShare());
+    curl_easy_setopt(req, CURLOPT_DNS_CACHE_TIMEOUT, 60L);  // curl's TTL on the shared resolver cache
+
     curl_easy_setopt(req, CURLOPT_ERRORBUFFER, errorbuffer);
     curl_easy_setopt(req, CURLOPT_FAILONERROR, 1);
 
@@ -278,8 +327,7 @@ void HTTPRequest::startRequest_thread() {
     std::map<std::string, std::string> post_data = request_data->uri.query_data;    
 
     
-    std::string uri_string; // curl doesn't copy this, so we have to hold onto it
-    
+    // uri_string is a member: curl doesn't copy it, so it has to outlive the transfer
     { // We need a copy of the URI without the query data for curl
       FB::URI bare_uri = request_data->uri;
       bare_uri.query_data.clear();
@@ -315,7 +363,7 @@ void HTTPRequest::startRequest_thread() {
       curl_easy_setopt(req, CURLOPT_HTTPPOST, formpost);
     }
     
-    std::string cookie_string = build_cookie_header(request_data->cookies);
+    cookie_string = build_cookie_header(request_data->cookies);
     curl_easy_setopt(req, CURLOPT_COOKIE, cookie_string.c_str());
     
     for (std::multimap<std::string, std::string>::iterator it = request_data->headers.begin(); it != request_data->headers.end(); ++it) {
@@ -356,31 +404,59 @@ void HTTPRequest::startRequest_thread() {
     last_status.state = Status::CONNECTING;
     status_callback(last_status);
 
-    if (curl_easy_perform(req) != 0) {
-      if (cancellation_requested) {
-        last_status.state = Status::CANCELLED;
-        status_callback(last_status);
+    // hand the configured handle to the shared multi loop; transfer_complete
+    // fires on this same thread when the transfer finishes
+    CurlMultiReactor::getInstance().addHandle(req, boost::bind(&HTTPRequest::transfer_complete, this, _1));
+  } catch (const std::exception& e) {
+    // route the failure through transfer_complete so cleanup happens in one place
+    snprintf(errorbuffer, sizeof(errorbuffer), "%s", e.what());
+    transfer_complete(CURLE_FAILED_INIT);
+  }
+}
+
+void HTTPRequest::transfer_complete(int curl_result) {
+  if (curl_result != CURLE_OK) {
+    if (cancellation_requested) {
+      last_status.state = Status::CANCELLED;
+    } else {
+      last_status.state = Status::HTTP_ERROR;
+      last_status.last_error = errorbuffer;
+    }
+  } else {
+    last_status.state = Status::COMPLETE;
+  }
+  status_callback(last_status);
+
+  if (req) {
+    long code;
+    curl_easy_getinfo(req, CURLINFO_RESPONSE_CODE, &code);
+    response_data->code = code;
+
+    if (!cache_url.empty() && curl_result == CURLE_OK) {
+      HTTPResponseCache& cache = HTTPResponseCache::getInstance();
+      if (code == 304) {
+        // validators matched: the stored body stands in for the response
+        boost::shared_ptr<HTTPResponseData> cached;
+        if (cache.serveRevalidated(cache_url, *response_data, cached))
+          response_data = cached;
       } else {
-        throw std::runtime_error(errorbuffer);
+        cache.store(cache_url, response_data.get());
       }
-    } else {
-      last_status.state = Status::COMPLETE;
-      status_callback(last_status);
     }
-  } catch (const std::exception& e) {
-    last_status.state = Status::HTTP_ERROR;
-    last_status.last_error = e.what();
-    status_callback(last_status);
+    // back to the pool so the next request to this host reuses the warm
+    // connection and TLS session instead of handshaking again
+    CurlHandlePool::getInstance().release(pool_key, req);
+    req = NULL;
   }
-  
-  long code;
-  curl_easy_getinfo(req, CURLINFO_RESPONSE_CODE, &code);
-  response_data->code = code;
-  
+
   curl_slist_free_all(headerlist);
+  headerlist = NULL;
   curl_formfree(formpost);
-  curl_easy_cleanup(req);
-  req = NULL;
+  formpost = NULL;
+
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  request_finished = true;
+  m_cond.notify_all();
 }
 
 void HTTPRequest::curl_header(const char* data, size_t size) {
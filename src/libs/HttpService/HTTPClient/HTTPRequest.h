@@ -26,6 +26,8 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 #undef Status // unix!
 
 typedef void CURL;
+struct curl_httppost;
+struct curl_slist;
 
 namespace HTTP {
     class HTTPRequest : public boost::noncopyable {
@@ -33,12 +35,12 @@ namespace HTTP {
             static HTTPRequest* create();
             static void setProxyConfig(const HTTPProxyConfig& cfg);
 
-            // Fire off a request in a new thread and ignore the results with this.
+            // Fire off a request on the shared transfer thread and ignore the results with this.
             static void asyncStartRequest(boost::shared_ptr<HTTPRequestData> data);
 
             // If you need to kill an HTTP request from a thread whose callstack might go through that
             // request's IO service, then call this; it'll transfer ownership to a new thread which will
-            // stop the service and join the worker thread before deleting the object.
+            // cancel the transfer and wait for it to finish before deleting the object.
             void threadSafeDestroy();
 
             ~HTTPRequest();
@@ -60,8 +62,9 @@ namespace HTTP {
         protected:
 
             HTTPRequest();
-            void startRequest_thread();
-            void killThread();
+            // both run on the shared CurlMultiReactor thread
+            void setup_and_submit();
+            void transfer_complete(int curl_result);
             void _internal_threadSafeDestroy();
 
             CURL* req;
@@ -70,7 +73,21 @@ namespace HTTP {
             Status last_status;
             callback_fn_t status_callback;
 
-            boost::shared_ptr<boost::thread> worker_thread;
+            // the transfer is asynchronous, so everything curl references
+            // has to live on the object until transfer_complete
+            struct curl_httppost* formpost;
+            struct curl_slist* headerlist;
+            std::string uri_string;
+            std::string cookie_string;
+            std::string pool_key;       // scheme://host:port; which idle list the handle returns to
+            std::string cache_url;      // non-empty when this GET goes through the response cache
+            char errorbuffer[256];      // >= CURL_ERROR_SIZE (checked in the .cpp)
+
+            bool request_submitted;
+            bool request_finished;
+            boost::mutex m_mutex;
+            boost::condition_variable m_cond;
+
             boost::shared_ptr<HTTPRequestData> request_data;
             boost::shared_ptr<HTTPResponseData> response_data;
             HTTPProxyConfig proxy_config;
@@ -0,0 +1,261 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "../HTTPCommon/Tiger.h"
+#include "HTTPResponseCache.h"
+
+using namespace HTTP;
+namespace fs = boost::filesystem;
+
+namespace {
+    const char* cache_magic = "HTTPCACHE1";
+
+    // max-age from a Cache-Control value, or 0 if absent/unparseable
+    std::time_t parseMaxAge(const std::string& cache_control) {
+        boost::iterator_range<std::string::const_iterator> r =
+            boost::algorithm::ifind_first(cache_control, "max-age=");
+        if (!r) return 0;
+        const size_t pos = r.end() - cache_control.begin();
+        return static_cast<std::time_t>(std::atol(cache_control.c_str() + pos));
+    }
+
+    // first value of a header in the multimap, case-insensitively
+    std::string findHeader(const std::multimap<std::string, std::string>& headers, const char* name) {
+        for (std::multimap<std::string, std::string>::const_iterator it = headers.begin(); it != headers.end(); ++it) {
+            if (boost::algorithm::iequals(it->first, name))
+                return it->second;
+        }
+        return std::string();
+    }
+
+    std::time_t freshnessFrom(const std::multimap<std::string, std::string>& headers) {
+        const std::string cc = findHeader(headers, "Cache-Control");
+        if (boost::algorithm::icontains(cc, "no-store") || boost::algorithm::icontains(cc, "no-cache"))
+            return 0;
+        const std::time_t max_age = parseMaxAge(cc);
+        return max_age ? std::time(NULL) + max_age : 0;
+    }
+}
+
+/*static*/ HTTPResponseCache& HTTPResponseCache::getInstance() {
+    static HTTPResponseCache instance;
+    return instance;
+}
+
+HTTPResponseCache::HTTPResponseCache()
+  : is_enabled(false), max_bytes(0), total_bytes(0) {
+}
+
+/*static*/ std::string HTTPResponseCache::keyFor(const std::string& url) {
+    return Tiger(url.data(), url.size()).toString();
+}
+
+fs::path HTTPResponseCache::pathFor(const std::string& key) const {
+    return cache_dir / (key + ".hce");
+}
+
+void HTTPResponseCache::configure(const fs::path& dir, uint64_t maxBytes) {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    cache_dir = dir;
+    max_bytes = maxBytes;
+    total_bytes = 0;
+    index.clear();
+
+    try {
+        fs::create_directories(cache_dir);
+        for (fs::directory_iterator it(cache_dir), end; it != end; ++it) {
+            const fs::path p = it->path();
+            if (p.extension() != ".hce") continue;
+
+            std::ifstream in(p.string().c_str(), std::ios::binary);
+            std::string magic, url, line;
+            std::getline(in, magic);
+            if (magic != cache_magic) continue;
+            std::getline(in, url);
+
+            Entry e;
+            std::getline(in, line);     // status code, unused here
+            std::getline(in, line);
+            e.expiry = static_cast<std::time_t>(std::atol(line.c_str()));
+            e.last_used = 0;
+            e.size = static_cast<uint64_t>(fs::file_size(p));
+            while (std::getline(in, line) && !line.empty()) {
+                if (boost::algorithm::istarts_with(line, "ETag:"))
+                    e.etag = boost::algorithm::trim_copy(line.substr(5));
+                else if (boost::algorithm::istarts_with(line, "Last-Modified:"))
+                    e.last_modified = boost::algorithm::trim_copy(line.substr(14));
+            }
+            index[keyFor(url)] = e;
+            total_bytes += e.size;
+        }
+    } catch (const std::exception&) {
+        // unreadable cache dir: run without one rather than failing requests
+        index.clear();
+        total_bytes = 0;
+        is_enabled = false;
+        return;
+    }
+    is_enabled = true;
+}
+
+bool HTTPResponseCache::loadEntry(const std::string& key, HTTPResponseData& out) const {
+    std::ifstream in(pathFor(key).string().c_str(), std::ios::binary);
+    if (!in) return false;
+
+    std::string line;
+    std::getline(in, line);
+    if (line != cache_magic) return false;
+    std::getline(in, line);     // url
+    std::getline(in, line);
+    out.code = static_cast<unsigned int>(std::atol(line.c_str()));
+    std::getline(in, line);     // expiry; tracked by the index
+
+    while (std::getline(in, line) && !line.empty()) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        out.headers.insert(std::make_pair(line.substr(0, colon),
+            boost::algorithm::trim_copy(line.substr(colon + 1))));
+    }
+
+    std::ostringstream body;
+    body << in.rdbuf();
+    out.addDatablock(new HTTPStringDatablock(body.str()));
+    return true;
+}
+
+bool HTTPResponseCache::getFresh(const std::string& url, boost::shared_ptr<HTTPResponseData>& resp) {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (!is_enabled) return false;
+
+    const std::string key = keyFor(url);
+    std::map<std::string, Entry>::iterator it = index.find(key);
+    if (it == index.end() || it->second.expiry <= std::time(NULL))
+        return false;
+
+    boost::shared_ptr<HTTPResponseData> loaded(new HTTPResponseData);
+    if (!loadEntry(key, *loaded)) {
+        removeEntry(key);
+        return false;
+    }
+    it->second.last_used = std::time(NULL);
+    resp = loaded;
+    return true;
+}
+
+bool HTTPResponseCache::getValidators(const std::string& url, std::string& etag, std::string& last_modified) {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (!is_enabled) return false;
+
+    std::map<std::string, Entry>::const_iterator it = index.find(keyFor(url));
+    if (it == index.end()) return false;
+    if (it->second.etag.empty() && it->second.last_modified.empty()) return false;
+    etag = it->second.etag;
+    last_modified = it->second.last_modified;
+    return true;
+}
+
+bool HTTPResponseCache::serveRevalidated(const std::string& url, const HTTPResponseData& validation_resp,
+    boost::shared_ptr<HTTPResponseData>& out) {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (!is_enabled) return false;
+
+    const std::string key = keyFor(url);
+    std::map<std::string, Entry>::iterator it = index.find(key);
+    if (it == index.end()) return false;
+
+    boost::shared_ptr<HTTPResponseData> loaded(new HTTPResponseData);
+    if (!loadEntry(key, *loaded)) {
+        removeEntry(key);
+        return false;
+    }
+    // freshness restarts from the 304's Cache-Control (in memory only; the
+    // worst case after a restart is one extra revalidation)
+    it->second.expiry = freshnessFrom(validation_resp.headers);
+    it->second.last_used = std::time(NULL);
+    out = loaded;
+    return true;
+}
+
+void HTTPResponseCache::store(const std::string& url, HTTPResponseData* resp) {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (!is_enabled || resp->code != 200) return;
+
+    const std::string etag = findHeader(resp->headers, "ETag");
+    const std::string last_modified = findHeader(resp->headers, "Last-Modified");
+    const std::time_t expiry = freshnessFrom(resp->headers);
+    if (etag.empty() && last_modified.empty() && !expiry)
+        return;     // nothing to be fresh on and nothing to revalidate with
+
+    HTTPDatablock* body = resp->coalesceBlocks();
+    const uint64_t body_size = body ? body->size() : 0;
+    if (body_size > max_bytes) return;
+
+    std::ostringstream meta;
+    meta << cache_magic << "\n" << url << "\n" << resp->code << "\n" << expiry << "\n";
+    for (std::multimap<std::string, std::string>::const_iterator it = resp->headers.begin();
+        it != resp->headers.end(); ++it) {
+        if (boost::algorithm::iequals(it->first, "Transfer-Encoding")
+            || boost::algorithm::iequals(it->first, "Connection"))
+            continue;   // hop-by-hop; meaningless on replay
+        meta << it->first << ": " << it->second << "\n";
+    }
+    meta << "\n";
+
+    const std::string key = keyFor(url);
+    removeEntry(key);
+    evictUntilFits(meta.str().size() + body_size);
+
+    std::ofstream outf(pathFor(key).string().c_str(), std::ios::binary | std::ios::trunc);
+    if (!outf) return;
+    outf << meta.str();
+    if (body) outf.write(body->data(), body->size());
+    outf.close();
+
+    Entry e;
+    e.size = meta.str().size() + body_size;
+    e.expiry = expiry;
+    e.last_used = std::time(NULL);
+    e.etag = etag;
+    e.last_modified = last_modified;
+    index[key] = e;
+    total_bytes += e.size;
+}
+
+void HTTPResponseCache::removeEntry(const std::string& key) {
+    std::map<std::string, Entry>::iterator it = index.find(key);
+    if (it == index.end()) return;
+    total_bytes -= it->second.size;
+    index.erase(it);
+    try {
+        fs::remove(pathFor(key));
+    } catch (const std::exception&) { } // already gone is fine
+}
+
+void HTTPResponseCache::evictUntilFits(uint64_t incoming) {
+    while (!index.empty() && total_bytes + incoming > max_bytes) {
+        std::map<std::string, Entry>::iterator victim = index.begin();
+        for (std::map<std::string, Entry>::iterator it = index.begin(); it != index.end(); ++it) {
+            if (it->second.last_used < victim->second.last_used)
+                victim = it;
+        }
+        removeEntry(victim->first);
+    }
+}
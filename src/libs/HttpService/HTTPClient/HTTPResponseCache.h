@@ -0,0 +1,87 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTP_HTTPRESPONSECACHE
+#define H_HTTP_HTTPRESPONSECACHE
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "../HTTPCommon/HTTPResponseData.h"
+
+namespace HTTP {
+    // Disk-backed cache for GET responses, honoring max-age freshness and
+    // ETag / Last-Modified revalidation.  Disabled until configure() points
+    // it at a directory; HTTPRequest then serves fresh hits synchronously on
+    // the caller's thread (no reactor round trip), sends conditional headers
+    // for stale entries, and swaps the stored body back in on a 304.
+    //
+    // One file per entry, named by the Tiger hash of the URL: a small meta
+    // header (url, status code, expiry, response headers), a blank line,
+    // then the body.  An in-memory index built at configure() drives
+    // lookups; eviction is least-recently-used once total size passes the
+    // configured cap.
+    class HTTPResponseCache : boost::noncopyable {
+    public:
+        static HTTPResponseCache& getInstance();
+
+        // enables the cache, scanning dir (created if missing) to rebuild
+        // the index; maxBytes caps the total body bytes kept on disk
+        void configure(const boost::filesystem::path& dir, uint64_t maxBytes);
+        bool enabled() const { return is_enabled; }
+
+        // fresh hit: fills resp entirely from disk and returns true
+        bool getFresh(const std::string& url, boost::shared_ptr<HTTPResponseData>& resp);
+        // stale entry: hands out its validators for a conditional request
+        bool getValidators(const std::string& url, std::string& etag, std::string& last_modified);
+        // after a 304, serves the stored body and refreshes freshness from
+        // the validation response's Cache-Control
+        bool serveRevalidated(const std::string& url, const HTTPResponseData& validation_resp,
+            boost::shared_ptr<HTTPResponseData>& out);
+        // stores a 200 GET response if it carries freshness or validators
+        void store(const std::string& url, HTTPResponseData* resp);
+
+    protected:
+        HTTPResponseCache();
+
+        struct Entry {
+            uint64_t size;              // whole file, meta included
+            std::time_t expiry;         // 0 = stale, revalidate every time
+            std::time_t last_used;
+            std::string etag;
+            std::string last_modified;
+        };
+
+        static std::string keyFor(const std::string& url);
+        boost::filesystem::path pathFor(const std::string& key) const;
+        bool loadEntry(const std::string& key, HTTPResponseData& out) const;
+        void evictUntilFits(uint64_t incoming);
+        void removeEntry(const std::string& key);
+
+        bool is_enabled;
+        boost::filesystem::path cache_dir;
+        uint64_t max_bytes;
+        uint64_t total_bytes;
+        std::map<std::string, Entry> index;
+        mutable boost::mutex m_mutex;   // caller threads and the reactor both come through here
+    };
+};
+
+#endif // H_HTTP_HTTPRESPONSECACHE
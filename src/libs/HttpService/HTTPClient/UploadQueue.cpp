@@ -16,6 +16,7 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 #include "HTTPRequest.h"
 #include "JSAPI.h"
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include "../HTTPCommon/Status.h"
 #include "../HTTPCommon/Utils.h"
 #include "logging.h"
@@ -25,8 +26,9 @@ using namespace boost::algorithm;
 
 UploadQueue::UploadQueue( const std::string& _name )
     : name(_name), status(UPLOAD_IDLE), current_queue_bytes(0), current_batch_bytes(0), total_queue_bytes(0),
-    total_queue_files(0), files_waiting(0), current_upload_request(NULL), current_batch_retry(0),
-    batch_size(8), max_retries(3)
+    total_queue_files(0), files_waiting(0),
+    batch_size(8), max_retries(3), max_concurrent_requests(2), chunk_size(0),
+    dedup_enabled(false), next_batch_id(1), next_multipart_id(1)
 {
 
 }
@@ -72,14 +74,22 @@ FB::VariantMap UploadQueue::getStatusDict(bool include_filenames) {
 
     double current_batch_pct_complete = 0.0;
 
-    if (current_upload_request) {
-        HTTP::Status st = current_upload_request->getStatus();
-        FB::VariantMap status(st.asDict());
-        d.insert(status.begin(), status.end());
-        if (st.send_total) {
-            current_batch_pct_complete = static_cast<double>(st.bytes_sent)
-                / static_cast<double>(st.send_total);
+    // aggregate over every in-flight request; the state fields of the first
+    // one stand in for the batch as a whole
+    uint64_t bytes_sent = 0, send_total = 0;
+    for (std::map<unsigned int, ActiveBatch>::const_iterator it = active_batches.begin();
+        it != active_batches.end(); ++it) {
+        HTTP::Status st = it->second.request->getStatus();
+        if (it == active_batches.begin()) {
+            FB::VariantMap status(st.asDict());
+            d.insert(status.begin(), status.end());
         }
+        bytes_sent += st.bytes_sent;
+        send_total += st.send_total;
+    }
+    if (send_total) {
+        current_batch_pct_complete = static_cast<double>(bytes_sent)
+            / static_cast<double>(send_total);
     }
 
     d["current_batch_pct_complete"] = current_batch_pct_complete;
@@ -108,15 +118,66 @@ void UploadQueue::dispatch() {
 }
 
 void UploadQueue::start_next_upload() {
+    while (active_batches.size() < max_concurrent_requests && start_one_request()) { }
+
+    if (active_batches.empty() && status == UPLOAD_IN_PROGRESS)
+        finish_queue();
+}
+
+void UploadQueue::launch_batch(unsigned int batch_id, boost::shared_ptr<HTTPRequestData> data) {
+    ActiveBatch& batch = active_batches[batch_id];
+    batch.request = HTTPRequest::create();
+    batch.request->onStatusChanged(
+        bind(&UploadQueue::upload_request_status_changed, this, batch_id, _1)
+        );
+    batch.request->startRequest(data);
+}
+
+bool UploadQueue::start_one_request() {
+    // ranged parts staged by a previous call go out first
+    if (! pending_parts.empty()) {
+        PendingPart part = pending_parts.front();
+        pending_parts.pop_front();
+
+        boost::shared_ptr<HTTPRequestData> data(new HTTPRequestData);
+        data->method = "POST";
+        data->cookies = cookies;
+        data->uri = part.target;
+        data->uri.query_data["multipart_id"] = part.multipart_id;
+        data->uri.query_data["part_index"] = boost::lexical_cast<std::string>(part.index);
+        data->uri.query_data["part_count"] = boost::lexical_cast<std::string>(part.count);
+        data->uri.query_data["part_offset"] = boost::lexical_cast<std::string>(part.offset);
+        data->uri.query_data["total_size"] = boost::lexical_cast<std::string>(part.total);
+        if (! part.digest.empty())
+            data->uri.query_data["chunk_digest"] = part.digest;
+
+        HTTPRangeDatablock* block = new HTTPRangeDatablock(part.parent,
+            static_cast<size_t>(part.offset), static_cast<size_t>(part.len));
+        data->addFile("file0", FB::wstring_to_utf8(part.filename), "application/octet-stream", block);
+
+        const unsigned int batch_id = next_batch_id++;
+        ActiveBatch& batch = active_batches[batch_id];
+        batch.retries = 0;
+        batch.bytes = part.len;
+        batch.is_part = true;
+        batch.is_negotiation = false;
+        batch.parent_path = part.source_path;
+        batch.part_block = block;
+
+        current_upload_files.insert(part.source_path);
+        current_batch_bytes += part.len;
+        launch_batch(batch_id, data);
+        return true;
+    }
+
     unsigned int files_started = 0;
 
     boost::shared_ptr<HTTPRequestData> data(new HTTPRequestData);
     data->method = "POST";
     data->cookies = cookies;
 
-    current_upload_files.clear();
-    current_batch_bytes = 0;
-    current_batch_retry = 0;
+    std::set<std::wstring> batch_files;
+    uint64_t batch_bytes = 0;
 
     for (std::list<UploadQueueEntry>::iterator it = queue.begin(); it != queue.end(); ++it) {
         if (it->status != UploadQueueEntry::ENTRY_WAITING) continue;
@@ -135,6 +196,94 @@ void UploadQueue::start_next_upload() {
                 qe.target.query_data[pvit->first] = pvit->second;
             }
 
+            const uint64_t actual_size = qe.datablock->size();
+            if (chunk_size && actual_size > chunk_size && files_started == 0) {
+                // Too big for one request: stage ranged parts of it and let
+                // the concurrency loop run them in parallel
+                const std::string multipart_id =
+                    name + "-" + boost::lexical_cast<std::string>(next_multipart_id++);
+
+                if (dedup_enabled && ! dedup_negotiate_uri.domain.empty()) {
+                    // Dedup: split at content-defined boundaries and ask the
+                    // endpoint which chunks it is missing before sending any.
+                    const unsigned int batch_id = next_batch_id++;
+                    Negotiation& neg = negotiations[batch_id];
+                    neg.source_path = qe.source_path;
+                    neg.filename = qe.filename;
+                    neg.target = qe.target;
+                    neg.parent = qe.datablock;
+                    neg.total = actual_size;
+                    neg.multipart_id = multipart_id;
+                    neg.chunks = chunkData(qe.datablock->data(),
+                        static_cast<size_t>(actual_size));
+
+                    // manifest: one "index offset length digest" line per chunk
+                    std::string manifest;
+                    for (size_t i = 0; i < neg.chunks.size(); ++i) {
+                        manifest += boost::lexical_cast<std::string>(i);
+                        manifest += ' ';
+                        manifest += boost::lexical_cast<std::string>(neg.chunks[i].offset);
+                        manifest += ' ';
+                        manifest += boost::lexical_cast<std::string>(neg.chunks[i].length);
+                        manifest += ' ';
+                        manifest += neg.chunks[i].digest;
+                        manifest += '\n';
+                    }
+
+                    boost::shared_ptr<HTTPRequestData> negdata(new HTTPRequestData);
+                    negdata->method = "POST";
+                    negdata->cookies = cookies;
+                    negdata->uri = dedup_negotiate_uri;
+                    negdata->uri.query_data["multipart_id"] = multipart_id;
+                    negdata->uri.query_data["total_size"] =
+                        boost::lexical_cast<std::string>(actual_size);
+                    negdata->uri.query_data["chunk_count"] =
+                        boost::lexical_cast<std::string>(neg.chunks.size());
+                    HTTPStringDatablock* manifest_block = new HTTPStringDatablock(manifest);
+                    negdata->addFile("manifest", "manifest.txt", "text/plain", manifest_block);
+
+                    ActiveBatch& batch = active_batches[batch_id];
+                    batch.retries = 0;
+                    batch.bytes = 0; // negotiation carries no payload bytes worth counting
+                    batch.is_part = false;
+                    batch.is_negotiation = true;
+                    batch.parent_path = qe.source_path;
+                    batch.part_block = manifest_block;
+
+                    it->setStatus(UploadQueueEntry::ENTRY_IN_PROGRESS);
+                    --files_waiting;
+                    current_queue_bytes -= qe.filesize;
+
+                    current_upload_files.insert(qe.source_path);
+                    launch_batch(batch_id, negdata);
+                    return true;
+                }
+
+                const unsigned int part_count =
+                    static_cast<unsigned int>((actual_size + chunk_size - 1) / chunk_size);
+
+                for (unsigned int i = 0; i < part_count; ++i) {
+                    PendingPart part;
+                    part.source_path = qe.source_path;
+                    part.filename = qe.filename;
+                    part.target = qe.target;
+                    part.parent = qe.datablock;
+                    part.offset = static_cast<uint64_t>(i) * chunk_size;
+                    part.len = (std::min)(chunk_size, actual_size - part.offset);
+                    part.total = actual_size;
+                    part.index = i;
+                    part.count = part_count;
+                    part.multipart_id = multipart_id;
+                    pending_parts.push_back(part);
+                }
+                parts_remaining[qe.source_path] = part_count;
+                it->setStatus(UploadQueueEntry::ENTRY_IN_PROGRESS);
+                --files_waiting;
+                current_queue_bytes -= qe.filesize;
+                // staged only; report progress so the caller retries us
+                return true;
+            }
+
             if (files_started == 0) {
                 // First match sets the target uri
                 data->uri = qe.target;
@@ -151,8 +300,8 @@ void UploadQueue::start_next_upload() {
             qe.post_field = s;
             data->addFile(s, FB::wstring_to_utf8(qe.filename), "application/octet-stream", qe.datablock);
 
-            current_upload_files.insert(qe.source_path);
-            current_batch_bytes += qe.filesize;
+            batch_files.insert(qe.source_path);
+            batch_bytes += qe.filesize;
             ++files_started;
             if (files_started >= batch_size) break;
 
@@ -162,94 +311,171 @@ void UploadQueue::start_next_upload() {
         }
     }
 
-    if (files_started) {
-        // We had enough images left in the queue for another request, so kick that off now.
-        current_upload_request = HTTPRequest::create();
-        current_upload_request->onStatusChanged(
-            bind(&UploadQueue::upload_request_status_changed, this, _1)
-            );
-        current_upload_request->startRequest(data);
-
-        // As long as we're doing uploads, we want to keep the HTTP server
-        // up to provide progress to the chat bar widget -- so enable deferred shutdown.
-        // TODOTODO
-        //try {
-        //    boost::shared_ptr<HTTPService> h = http_srv_inst_weak.lock();
-        //    if (h) h->setDeferShutdown(true);
-        //} catch (...) {}
+    if (! files_started)
+        return false;
+
+    // We had enough images left in the queue for another request, so kick that off now.
+    const unsigned int batch_id = next_batch_id++;
+    ActiveBatch& batch = active_batches[batch_id];
+    batch.retries = 0;
+    batch.bytes = batch_bytes;
+    batch.files = batch_files;
+    batch.is_part = false;
+    batch.is_negotiation = false;
+    batch.part_block = NULL;
+
+    current_upload_files.insert(batch_files.begin(), batch_files.end());
+    current_batch_bytes += batch_bytes;
+    launch_batch(batch_id, data);
+
+    // As long as we're doing uploads, we want to keep the HTTP server
+    // up to provide progress to the chat bar widget -- so enable deferred shutdown.
+    // TODOTODO
+    //try {
+    //    boost::shared_ptr<HTTPService> h = http_srv_inst_weak.lock();
+    //    if (h) h->setDeferShutdown(true);
+    //} catch (...) {}
 
-    } else {
+    return true;
+}
+
+void UploadQueue::finish_queue() {
 #ifndef NDEBUG
-        FBLOG_DEBUG("UploadQueue",
-            "start_next_upload() found no waiting files, running completion handlers\n");
+    FBLOG_DEBUG("UploadQueue",
+        "start_next_upload() found no waiting files, running completion handlers\n");
 #endif
-        // All done, post upload finished callback to all instances
-        FB::VariantMap d = getEmptyProgressDict();
-        FB::VariantMap failures;
+    // All done, post upload finished callback to all instances
+    FB::VariantMap d = getEmptyProgressDict();
+    FB::VariantMap failures;
 
-        for (std::list<UploadQueueEntry>::iterator it = queue.begin(); it != queue.end(); ++it) {
-            if (it->status == UploadQueueEntry::ENTRY_ERROR) {
-                failures[FB::wstring_to_utf8(it->source_path)] = it->result;
+    for (std::list<UploadQueueEntry>::iterator it = queue.begin(); it != queue.end(); ++it) {
+        if (it->status == UploadQueueEntry::ENTRY_ERROR) {
+            failures[FB::wstring_to_utf8(it->source_path)] = it->result;
 #ifndef NDEBUG
-                FBLOG_WARN("UploadQueue", "Reporting file \"" << it->source_path.c_str()
-                    << "\" as failed: " << it->result.c_str() << std::endl);
-#endif        
-            }
+            FBLOG_WARN("UploadQueue", "Reporting file \"" << it->source_path.c_str()
+                << "\" as failed: " << it->result.c_str() << std::endl);
+#endif
         }
-        queue.clear();
+    }
+    queue.clear();
 
-        if (! failures.empty()) d["failed_files"] = failures;
+    if (! failures.empty()) d["failed_files"] = failures;
 
-        status = UploadQueue::UPLOAD_COMPLETE;
-        // fire completion handlers, if available
-        for (std::list<FB::URI>::iterator it = completion_handlers.begin();
-            it != completion_handlers.end(); ++it) {
-            boost::shared_ptr<HTTPRequestData> reqdata(new HTTPRequestData(*it));
-            reqdata->cookies = cookies;
-            HTTPRequest::asyncStartRequest(reqdata);
-        }
+    status = UploadQueue::UPLOAD_COMPLETE;
+    // fire completion handlers, if available
+    for (std::list<FB::URI>::iterator it = completion_handlers.begin();
+        it != completion_handlers.end(); ++it) {
+        boost::shared_ptr<HTTPRequestData> reqdata(new HTTPRequestData(*it));
+        reqdata->cookies = cookies;
+        HTTPRequest::asyncStartRequest(reqdata);
+    }
+
+    if (queue_finished_callback)
+        queue_finished_callback(shared_ptr());
+
+    StatusUpdateEvent evt(d);
+    SendEvent(&evt);
+}
 
-        if (queue_finished_callback)
-            queue_finished_callback(shared_ptr());
-        
-        StatusUpdateEvent evt(d);
-        SendEvent(&evt);
+std::list<UploadQueueEntry>::iterator UploadQueue::find_entry(const std::wstring& source_path) {
+    std::list<UploadQueueEntry>::iterator it = queue.begin();
+    for (; it != queue.end(); ++it) {
+        if (it->source_path == source_path) break;
     }
+    return it;
 }
 
-void UploadQueue::upload_request_status_changed(const HTTP::Status &status) {
+void UploadQueue::upload_request_status_changed(unsigned int batch_id, const HTTP::Status &status) {
     // Deliver status dict to interested observers
     sendUpdateEvent();
 
-    uint64_t this_batch_size = 0;
+    std::map<unsigned int, ActiveBatch>::iterator bit = active_batches.find(batch_id);
+    if (bit == active_batches.end()) return; // stale callback from a cancelled batch
+    ActiveBatch& batch = bit->second;
+
     if (status.state == HTTP::Status::HTTP_ERROR) {
-        if ((++current_batch_retry) < max_retries) {
+        if ((++batch.retries) < max_retries) {
             // Retry on networking error.
 #ifndef NDEBUG
-            FBLOG_WARN("UploadQueue", "Retrying current batch on networking error ("
+            FBLOG_WARN("UploadQueue", "Retrying batch " << batch_id << " on networking error ("
                 << status.last_error.c_str() << ")" << std::endl);
 #endif
             // Retake ownership of the request data, dispose this request, and start a new one.
             // The request data doesn't get mangled by the HTTPRequest object, it should be safe
             // to reuse.
-            boost::shared_ptr<HTTPRequestData> req_data = current_upload_request->getRequest();
-            current_upload_request->threadSafeDestroy();
-
-            current_upload_request = HTTPRequest::create();
-            current_upload_request->onStatusChanged(
-                bind(&UploadQueue::upload_request_status_changed, this, _1)
-                );
-            current_upload_request->startRequest(req_data);
+            boost::shared_ptr<HTTPRequestData> req_data = batch.request->getRequest();
+            batch.request->threadSafeDestroy();
+            launch_batch(batch_id, req_data);
             return;
         }
-        for (std::list<UploadQueueEntry>::iterator it = queue.begin(); it != queue.end(); ++it) {
-            if (it->status == UploadQueueEntry::ENTRY_IN_PROGRESS) {
-                this_batch_size += it->filesize;
+        if (batch.is_negotiation) {
+            // negotiation failed; dedup is best-effort, so fall back to
+            // uploading every chunk as if the server had none of them
+            std::map<unsigned int, Negotiation>::iterator nit = negotiations.find(batch_id);
+            if (nit != negotiations.end()) {
+                std::set<unsigned int> needed;
+                for (unsigned int i = 0; i < nit->second.chunks.size(); ++i)
+                    needed.insert(i);
+                stage_parts(nit->second, needed);
+                negotiations.erase(nit);
+            }
+        } else if (batch.is_part) {
+            // one dead part fails the whole chunked entry; sibling parts
+            // discover that through the entry status when they finish
+            std::list<UploadQueueEntry>::iterator it = find_entry(batch.parent_path);
+            if (it != queue.end() && it->status == UploadQueueEntry::ENTRY_IN_PROGRESS)
                 it->onFailure(status.last_error);
+            parts_remaining.erase(batch.parent_path);
+        } else {
+            for (std::list<UploadQueueEntry>::iterator it = queue.begin(); it != queue.end(); ++it) {
+                if (it->status == UploadQueueEntry::ENTRY_IN_PROGRESS && batch.files.count(it->source_path)) {
+                    it->onFailure(status.last_error);
+                }
             }
         }
     } else if (status.state == HTTP::Status::COMPLETE) {
-        HTTPDatablock* db = current_upload_request->getResponse()->coalesceBlocks();
+        if (batch.is_negotiation) {
+            std::map<unsigned int, Negotiation>::iterator nit = negotiations.find(batch_id);
+            if (nit != negotiations.end()) {
+                // the response body is a whitespace-separated list of chunk
+                // indexes the server is missing; empty means it has them all
+                std::set<unsigned int> needed;
+                bool parse_ok = true;
+                try {
+                    HTTPDatablock* db = batch.request->getResponse()->coalesceBlocks();
+                    std::istringstream data_stream(std::string(db->data(), db->size()));
+                    std::string tok;
+                    while (data_stream >> tok) {
+                        unsigned int idx = boost::lexical_cast<unsigned int>(tok);
+                        if (idx >= nit->second.chunks.size())
+                            throw std::runtime_error("chunk index out of range");
+                        needed.insert(idx);
+                    }
+                } catch (const std::exception& e) {
+#ifndef NDEBUG
+                    FBLOG_WARN("UploadQueue", "Unparseable dedup negotiation response ("
+                        << e.what() << "), uploading all chunks" << std::endl);
+#endif
+                    parse_ok = false;
+                }
+                if (! parse_ok) {
+                    needed.clear();
+                    for (unsigned int i = 0; i < nit->second.chunks.size(); ++i)
+                        needed.insert(i);
+                }
+                stage_parts(nit->second, needed);
+                negotiations.erase(nit);
+            }
+        } else if (batch.is_part) {
+            std::map<std::wstring, unsigned int>::iterator pit = parts_remaining.find(batch.parent_path);
+            if (pit != parts_remaining.end() && --pit->second == 0) {
+                parts_remaining.erase(pit);
+                std::list<UploadQueueEntry>::iterator it = find_entry(batch.parent_path);
+                if (it != queue.end() && it->status == UploadQueueEntry::ENTRY_IN_PROGRESS)
+                    it->setStatus(UploadQueueEntry::ENTRY_COMPLETE);
+            }
+        } else {
+        HTTPDatablock* db = batch.request->getResponse()->coalesceBlocks();
 
         std::multimap<std::string, std::string> file_statuses;
 
@@ -274,9 +500,7 @@ void UploadQueue::upload_request_status_changed(const HTTP::Status &status) {
         }
 
         for (std::list<UploadQueueEntry>::iterator it = queue.begin(); it != queue.end(); ++it) {
-            if (it->status == UploadQueueEntry::ENTRY_IN_PROGRESS) {
-                this_batch_size += it->filesize;
-
+            if (it->status == UploadQueueEntry::ENTRY_IN_PROGRESS && batch.files.count(it->source_path)) {
                 bool had_error = false;
 
                 // See if we got an error condition back from the endpoint
@@ -302,9 +526,10 @@ void UploadQueue::upload_request_status_changed(const HTTP::Status &status) {
                 if (!had_error) it->setStatus(UploadQueueEntry::ENTRY_COMPLETE);
             }
         }
+        }
     } else return;
 
-    boost::shared_ptr<HTTPResponseData> response = current_upload_request->getResponse();
+    boost::shared_ptr<HTTPResponseData> response = batch.request->getResponse();
     if (response) {
         for (std::map<std::string, std::string>::iterator it = response->cookies.begin();
             it != response->cookies.end(); ++it) {
@@ -312,22 +537,66 @@ void UploadQueue::upload_request_status_changed(const HTTP::Status &status) {
         }
     }
 
-
     // using threadSafeDestroy since our caller is probably the i/o service of that request...
-    current_upload_request->threadSafeDestroy();
-    current_upload_request = NULL;
+    batch.request->threadSafeDestroy();
+    delete batch.part_block;
+    current_batch_bytes -= batch.bytes;
+    active_batches.erase(bit);
+
+    // rebuild the displayed file set from what's still in flight
+    current_upload_files.clear();
+    for (std::map<unsigned int, ActiveBatch>::const_iterator it = active_batches.begin();
+        it != active_batches.end(); ++it) {
+        if (it->second.is_part)
+            current_upload_files.insert(it->second.parent_path);
+        else
+            current_upload_files.insert(it->second.files.begin(), it->second.files.end());
+    }
 
-    // Since this is done (error or not), find another queue entry that's WAITING and start that.
+    // Since this is done (error or not), refill the request slots.
     start_next_upload();
 }
 
+void UploadQueue::stage_parts(const Negotiation& neg, const std::set<unsigned int>& needed) {
+    for (std::set<unsigned int>::const_iterator it = needed.begin(); it != needed.end(); ++it) {
+        const ContentChunk& chunk = neg.chunks[*it];
+        PendingPart part;
+        part.source_path = neg.source_path;
+        part.filename = neg.filename;
+        part.target = neg.target;
+        part.parent = neg.parent;
+        part.offset = chunk.offset;
+        part.len = chunk.length;
+        part.total = neg.total;
+        part.index = *it;
+        part.count = static_cast<unsigned int>(neg.chunks.size());
+        part.multipart_id = neg.multipart_id;
+        part.digest = chunk.digest;
+        pending_parts.push_back(part);
+    }
+    if (! needed.empty()) {
+        parts_remaining[neg.source_path] = static_cast<unsigned int>(needed.size());
+    } else {
+        // the server already had every chunk; nothing to upload
+        std::list<UploadQueueEntry>::iterator it = find_entry(neg.source_path);
+        if (it != queue.end() && it->status == UploadQueueEntry::ENTRY_IN_PROGRESS)
+            it->setStatus(UploadQueueEntry::ENTRY_COMPLETE);
+    }
+}
+
 void UploadQueue::cancel() {
-    if (current_upload_request) {
-        HTTPRequest* r = current_upload_request;
-        current_upload_request = NULL;
+    std::map<unsigned int, ActiveBatch> cancelled;
+    cancelled.swap(active_batches); // stale status callbacks now no-op
+    pending_parts.clear();
+    negotiations.clear();
+    parts_remaining.clear();
+    current_upload_files.clear();
+    current_batch_bytes = 0;
 
-        r->cancel();
-        delete r;
+    for (std::map<unsigned int, ActiveBatch>::iterator it = cancelled.begin(); it != cancelled.end(); ++it) {
+        it->second.request->cancel();
+        delete it->second.request;
+        delete it->second.part_block;
     }
 
     queue.clear();
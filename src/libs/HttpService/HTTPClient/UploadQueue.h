@@ -16,21 +16,26 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 #ifndef UploadQueue_h__
 #define UploadQueue_h__
 
+#include <deque>
 #include <list>
+#include <map>
 #include "URI.h"
 #include "UploadQueueEntry.h"
+#include "../HTTPCommon/ContentChunker.h"
 #include "PluginEventSource.h"
 #include "PluginEvent.h"
 
 namespace HTTP {
     class UploadQueue;
     class HTTPRequest;
+    class HTTPRequestData;
     struct Status;
     typedef boost::shared_ptr<UploadQueue> UploadQueuePtr;
 
     class UploadQueue : public FB::PluginEventSource {
     public:
         class StatusUpdateEvent : public FB::PluginEvent {
+            FB_PLUGIN_EVENT_TYPE(StatusUpdateEvent, FB::PluginEvent)
         public:
             StatusUpdateEvent(const FB::VariantMap& status) : status(status) { }
             virtual ~StatusUpdateEvent() {}
@@ -80,17 +85,92 @@ namespace HTTP {
         uint64_t files_waiting; 
     
         std::set<std::wstring> current_upload_files;
-        HTTPRequest* current_upload_request;
-        unsigned int current_batch_retry; // incremented every time we retry a batch due to networking failure, zeroed on a new batch.
-    
+
         boost::function<void(UploadQueuePtr)> queue_finished_callback;
         std::list<FB::URI> completion_handlers;
         unsigned int batch_size;
         unsigned int max_retries;
+        // how many upload requests (small-file batches or ranged parts) run at once
+        unsigned int max_concurrent_requests;
+        // When non-zero, files larger than this are split into ranged parts
+        // uploaded as separate (and concurrent) requests.  Each part is a
+        // normal POST carrying the extra GET params multipart_id, part_index,
+        // part_count, part_offset and total_size; the endpoint is expected
+        // to reassemble parts sharing a multipart_id once part_count of them
+        // have arrived.  Leave at 0 unless the endpoint implements that
+        // contract.
+        uint64_t chunk_size;
+        // When true (and chunk_size is set), a chunked file is first split at
+        // content-defined boundaries (see ContentChunker) and its chunk
+        // manifest is POSTed to dedup_negotiate_uri; the endpoint answers
+        // with the indexes of the chunks it does not already have, and only
+        // those are uploaded (as normal ranged parts, each also carrying
+        // chunk_digest).  An empty response means the server has everything
+        // and the file completes without uploading a byte.  If negotiation
+        // fails, every chunk is uploaded -- dedup is an optimization, never
+        // a correctness dependency.
+        bool dedup_enabled;
+        FB::URI dedup_negotiate_uri;
     protected:
+        // one in-flight HTTP request: either a multipart batch of small
+        // files or a single ranged part of a chunked file
+        struct ActiveBatch {
+            HTTPRequest* request;
+            unsigned int retries;
+            uint64_t bytes;
+            std::set<std::wstring> files;   // source paths (empty for parts)
+            bool is_part;
+            bool is_negotiation;            // have/need exchange for a chunked entry
+            std::wstring parent_path;       // chunked entry a part belongs to
+            HTTPDatablock* part_block;      // range view / manifest owned by this batch
+        };
+        // a ranged part waiting for a free request slot
+        struct PendingPart {
+            std::wstring source_path;
+            std::wstring filename;
+            FB::URI target;
+            const HTTPDatablock* parent;
+            uint64_t offset;
+            uint64_t len;
+            uint64_t total;
+            unsigned int index;
+            unsigned int count;
+            std::string multipart_id;
+            std::string digest;             // chunk digest; empty for fixed-size parts
+        };
+        // a chunked entry waiting on its have/need exchange, keyed by the
+        // batch id of the negotiation request
+        struct Negotiation {
+            std::wstring source_path;
+            std::wstring filename;
+            FB::URI target;
+            const HTTPDatablock* parent;
+            uint64_t total;
+            std::string multipart_id;
+            std::vector<ContentChunk> chunks;
+        };
+
         void sendUpdateEvent();
+        // keeps starting requests until the concurrency limit is reached;
+        // runs the completion handlers once nothing is running or waiting
         void start_next_upload();
-        void upload_request_status_changed(const HTTP::Status& status);
+        // starts (or stages) one request; false when nothing is left to start
+        bool start_one_request();
+        void launch_batch(unsigned int batch_id, boost::shared_ptr<HTTPRequestData> data);
+        void finish_queue();
+        std::list<UploadQueueEntry>::iterator find_entry(const std::wstring& source_path);
+        void upload_request_status_changed(unsigned int batch_id, const HTTP::Status& status);
+        // stages ranged parts for the chunks in needed (by index); an empty
+        // set completes the entry without uploading anything
+        void stage_parts(const Negotiation& neg, const std::set<unsigned int>& needed);
+
+        std::map<unsigned int, ActiveBatch> active_batches;
+        std::map<unsigned int, Negotiation> negotiations;
+        std::deque<PendingPart> pending_parts;
+        // chunked entries' outstanding part counts, keyed by source path
+        std::map<std::wstring, unsigned int> parts_remaining;
+        unsigned int next_batch_id;
+        unsigned int next_multipart_id;
     };
 };
 #endif // UploadQueue_h__
\ No newline at end of file
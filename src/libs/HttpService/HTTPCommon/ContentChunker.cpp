@@ -0,0 +1,73 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <algorithm>
+#include "Tiger.h"
+
+#include "ContentChunker.h"
+
+using namespace HTTP;
+
+namespace {
+    // Gear table: 256 pseudo-random words, fixed across builds so client and
+    // server (and yesterday's upload) always agree on where boundaries fall.
+    // Filled once from a splitmix-style generator with a fixed seed.
+    struct GearTable {
+        boost::uint32_t entry[256];
+        GearTable() {
+            boost::uint64_t state = 0x853c49e6748fea9bULL;
+            for (int i = 0; i < 256; ++i) {
+                state += 0x9e3779b97f4a7c15ULL;
+                boost::uint64_t z = state;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                entry[i] = static_cast<boost::uint32_t>(z ^ (z >> 31));
+            }
+        }
+    };
+    const GearTable gear;
+}
+
+std::vector<ContentChunk> HTTP::chunkData(const char* data, size_t len,
+    size_t min_size, size_t avg_size, size_t max_size)
+{
+    std::vector<ContentChunk> chunks;
+    if (! len) return chunks;
+    chunks.reserve(len / avg_size + 1);
+
+    const boost::uint32_t mask = static_cast<boost::uint32_t>(avg_size - 1);
+    size_t start = 0;
+    while (start < len) {
+        const size_t hard_end = (std::min)(len, start + max_size);
+        size_t pos = (std::min)(len, start + min_size);
+        size_t cut = hard_end;
+        // gear hash: shift-and-add over the trailing bytes; the implicit
+        // window is the top bits' reach (~32 bytes), plenty for stable cuts
+        boost::uint32_t h = 0;
+        for (; pos < hard_end; ++pos) {
+            h = (h << 1) + gear.entry[static_cast<unsigned char>(data[pos])];
+            if ((h & mask) == 0) {
+                cut = pos + 1;
+                break;
+            }
+        }
+        ContentChunk chunk;
+        chunk.offset = start;
+        chunk.length = cut - start;
+        chunk.digest = Tiger(data + start, cut - start).toString();
+        chunks.push_back(chunk);
+        start = cut;
+    }
+    return chunks;
+}
@@ -0,0 +1,47 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTP_CONTENTCHUNKER
+#define H_HTTP_CONTENTCHUNKER
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace HTTP {
+
+    // One content-defined chunk of a larger buffer
+    struct ContentChunk {
+        boost::uint64_t offset;
+        boost::uint64_t length;
+        std::string digest;     // Tiger hex digest of the chunk's bytes
+    };
+
+    // Splits a buffer into content-defined chunks with a gear rolling hash:
+    // a boundary lands wherever the hash of the trailing bytes matches the
+    // average-size mask, so inserting or deleting bytes early in a file only
+    // moves the boundaries near the edit -- the chunks after it keep their
+    // offsets relative to content and therefore keep their digests.  That is
+    // what makes re-uploading a marginally changed file cheap: unchanged
+    // chunks hash identically and the server already has them.
+    //
+    // avg_size must be a power of two; min_size caps how small a chunk can
+    // get and max_size forces a boundary through pathological data (long
+    // runs that never hit the mask).  Each chunk carries its Tiger digest.
+    std::vector<ContentChunk> chunkData(const char* data, size_t len,
+        size_t min_size = 16 * 1024, size_t avg_size = 64 * 1024, size_t max_size = 256 * 1024);
+};
+
+#endif // H_HTTP_CONTENTCHUNKER
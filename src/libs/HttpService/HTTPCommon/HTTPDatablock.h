@@ -15,7 +15,9 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 #pragma once
 #ifndef H_HTTP_HTTPDATABLOCK
 #define H_HTTP_HTTPDATABLOCK
+#include <ctime>
 #include <string>
+#include <boost/shared_ptr.hpp>
 
 namespace HTTP {
     class HTTPDatablock {
@@ -24,6 +26,73 @@ namespace HTTP {
         virtual size_t size() const = 0;
         virtual const char* data() const = 0;
         virtual void resolve() const {}
+
+        // POSIX file descriptor backing this block, or -1 if it only exists in
+        // memory.  File-backed blocks expose it so the session write chain can
+        // push the bytes kernel-to-kernel with sendfile instead of copying
+        // them through userland; callers must not close or seek it.
+        virtual int nativeFileDescriptor() const { return -1; }
+
+        // Modification time of the backing entity (seconds since the epoch),
+        // or 0 when there isn't one.  File-backed blocks expose it so the
+        // service can emit validators (ETag / Last-Modified) and answer a
+        // revalidation with a 304 instead of re-sending the bytes.
+        virtual std::time_t lastModified() const { return 0; }
+    };
+
+    // Pull source for streaming responses.  Instead of materializing every
+    // datablock up front, a handler can hand HTTPResponseData one of these;
+    // the session then writes the response with chunked transfer-encoding,
+    // asking for the next block only after the previous one has gone out on
+    // the socket -- natural backpressure, and per-request memory stays at one
+    // block no matter how large the payload.  Return NULL when the stream is
+    // done; returned blocks are owned and deleted by the session.
+    class HTTPDatablockSource {
+    public:
+        virtual ~HTTPDatablockSource() {}
+        virtual HTTPDatablock* nextBlock() = 0;
+    };
+
+    // Non-owning view of a byte range of another datablock.  Lets a large
+    // file be uploaded as ranged parts without copying any of it; the
+    // parent block must outlive every view onto it.
+    class HTTPRangeDatablock : public HTTPDatablock {
+    public:
+        HTTPRangeDatablock(const HTTPDatablock* _parent, size_t _offset, size_t _len)
+          : parent(_parent), offset(_offset), len(_len) {}
+        virtual ~HTTPRangeDatablock() {}
+        virtual size_t size() const { return len; }
+        virtual const char* data() const { return parent->data() + offset; }
+        virtual void resolve() const { parent->resolve(); }
+    protected:
+        const HTTPDatablock* parent;
+        size_t offset;
+        size_t len;
+    };
+
+    // Refcounted handle to a block shared between responses.  A response owns
+    // and deletes the datablocks it carries, which would force a cached
+    // fragment (a JSON template, a memory-mapped file) to be copied into a
+    // fresh block for every response using it.  Wrapping the shared block in
+    // one of these puts only the cheap wrapper in the response's chain:
+    // deleting the wrapper drops a reference, and the underlying block --
+    // any HTTPDatablock type, including file-backed ones, which keep their
+    // sendfile eligibility through the wrapper -- lives until the last
+    // response referencing it has been written.  Compose zero-copy responses
+    // by interleaving shared template fragments with small per-request
+    // HTTPStringDatablocks; the session writes the whole chain gathered.
+    class HTTPSharedDatablock : public HTTPDatablock {
+    public:
+        HTTPSharedDatablock(const boost::shared_ptr<const HTTPDatablock>& _block)
+          : block(_block) {}
+        virtual ~HTTPSharedDatablock() {}
+        virtual size_t size() const { return block->size(); }
+        virtual const char* data() const { return block->data(); }
+        virtual void resolve() const { block->resolve(); }
+        virtual int nativeFileDescriptor() const { return block->nativeFileDescriptor(); }
+        virtual std::time_t lastModified() const { return block->lastModified(); }
+    protected:
+        boost::shared_ptr<const HTTPDatablock> block;
     };
 
     class HTTPStringDatablock : public HTTPDatablock {
@@ -0,0 +1,123 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cctype>
+
+#include "HTTPException.h"
+#include "HTTPHeaderView.h"
+
+using namespace HTTP;
+
+namespace {
+    inline bool is_lws(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    // case-insensitive span-vs-cstring compare without materializing anything
+    bool span_iequals(const char* span, size_t len, const char* str) {
+        size_t i = 0;
+        for (; i < len; ++i) {
+            if (!str[i] || std::tolower((unsigned char)span[i]) != std::tolower((unsigned char)str[i]))
+                return false;
+        }
+        return str[i] == '\0';
+    }
+}
+
+HTTPHeaderView::HTTPHeaderView() {
+}
+
+void HTTPHeaderView::clear() {
+    raw.clear();
+    spans.clear();
+}
+
+void HTTPHeaderView::assign(std::string& raw_block) {
+    clear();
+    raw.swap(raw_block);
+
+    size_t pos = 0;
+    while (pos < raw.size()) {
+        size_t eol = raw.find('\n', pos);
+        if (eol == std::string::npos) eol = raw.size();
+
+        // trim the line, then split on the first colon
+        size_t start = pos, end = eol;
+        while (start < end && is_lws(raw[start])) ++start;
+        while (end > start && is_lws(raw[end - 1])) --end;
+        pos = eol + 1;
+        if (start == end) continue;
+
+        size_t colon = raw.find(':', start);
+        if (colon == std::string::npos || colon >= end)
+            throw HTTPException(400, "Malformed header");
+
+        Span s;
+        s.name_off = start;
+        size_t name_end = colon;
+        while (name_end > start && is_lws(raw[name_end - 1])) --name_end;
+        s.name_len = name_end - s.name_off;
+
+        size_t value_start = colon + 1;
+        while (value_start < end && is_lws(raw[value_start])) ++value_start;
+        s.value_off = value_start;
+        s.value_len = end - value_start;
+        spans.push_back(s);
+    }
+}
+
+bool HTTPHeaderView::nameIs(size_t i, const char* name) const {
+    const Span& s = spans[i];
+    return span_iequals(raw.data() + s.name_off, s.name_len, name);
+}
+
+std::string HTTPHeaderView::getName(size_t i) const {
+    const Span& s = spans[i];
+    return raw.substr(s.name_off, s.name_len);
+}
+
+std::string HTTPHeaderView::getValue(size_t i) const {
+    const Span& s = spans[i];
+    return raw.substr(s.value_off, s.value_len);
+}
+
+bool HTTPHeaderView::tryGetValue(const char* name, std::string& out) const {
+    for (size_t i = 0; i < spans.size(); ++i) {
+        if (nameIs(i, name)) {
+            out = getValue(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HTTPHeaderView::valueContains(const char* name, const char* token) const {
+    const size_t token_len = std::char_traits<char>::length(token);
+    for (size_t i = 0; i < spans.size(); ++i) {
+        if (!nameIs(i, name)) continue;
+        const Span& s = spans[i];
+        if (s.value_len < token_len) continue;
+        const char* v = raw.data() + s.value_off;
+        for (size_t off = 0; off + token_len <= s.value_len; ++off) {
+            if (span_iequals(v + off, token_len, token))
+                return true;
+        }
+    }
+    return false;
+}
+
+std::multimap<std::string, std::string> HTTPHeaderView::materialize() const {
+    std::multimap<std::string, std::string> res;
+    for (size_t i = 0; i < spans.size(); ++i)
+        res.insert(std::make_pair(getName(i), getValue(i)));
+    return res;
+}
@@ -0,0 +1,68 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTPHEADERVIEW
+#define H_HTTPHEADERVIEW
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace HTTP {
+
+    // Zero-copy view of a raw HTTP header block.  Instead of splitting every
+    // header into its own name and value strings up front, the block is kept
+    // whole and a single pass records trimmed (offset, length) spans; a value
+    // only becomes a std::string when somebody actually asks for it, which
+    // for most headers is never.  Lookups compare spans case-insensitively
+    // in place, so the steady-state parse cost is one allocation (the block
+    // itself) plus the span vector.
+    class HTTPHeaderView {
+    public:
+        HTTPHeaderView();
+
+        // Swaps the raw block (header lines only, no request line) into the
+        // view and indexes it.  Lines may end in \r\n or \n; a line without
+        // a colon raises HTTPException(400) like parse_http_headers does
+        void assign(std::string& raw_block);
+        void clear();
+
+        size_t size() const { return spans.size(); }
+        // ASCII case-insensitive compare of entry i's name
+        bool nameIs(size_t i, const char* name) const;
+        std::string getName(size_t i) const;
+        std::string getValue(size_t i) const;
+
+        // first matching value, materialized on demand; false if absent
+        bool tryGetValue(const char* name, std::string& out) const;
+        // case-insensitive substring test across every value of `name`,
+        // for token checks like Accept-Encoding: gzip
+        bool valueContains(const char* name, const char* token) const;
+
+        // full copy for callers that want the legacy multimap form
+        std::multimap<std::string, std::string> materialize() const;
+
+    private:
+        struct Span {
+            size_t name_off, name_len;
+            size_t value_off, value_len;
+        };
+
+        std::string raw;
+        std::vector<Span> spans;
+    };
+};
+
+#endif // H_HTTPHEADERVIEW
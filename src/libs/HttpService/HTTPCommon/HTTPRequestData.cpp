@@ -16,7 +16,7 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 
 using namespace HTTP;
 
-HTTPRequestData::HTTPRequestData(const FB::URI& in_uri, const std::string& in_method) : uri(in_uri), method(in_method) {
+HTTPRequestData::HTTPRequestData(const FB::URI& in_uri, const std::string& in_method) : uri(in_uri), method(in_method), arena(NULL) {
   if (method.empty()) method = uri.query_data.size() ? "POST" : "GET";
 }
 
@@ -22,21 +22,31 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 #include "URI.h"
 #include "HTTPDatablock.h"
 #include "HTTPFileEntry.h"
+#include "HTTPHeaderView.h"
+#include "RequestArena.h"
 
 namespace HTTP {
 
     class HTTPRequestData {
     public:
         friend class HTTPRequest;
-        HTTPRequestData() {}
+        HTTPRequestData() : arena(NULL) {}
         HTTPRequestData(const FB::URI& in_uri, const std::string& in_method = std::string());
         ~HTTPRequestData();
 
         FB::URI uri;
         std::string method;
+        // headers to send on an *outgoing* request (client side); the server
+        // session leaves this empty and fills header_view instead
         std::multimap<std::string, std::string> headers;
+        // zero-copy index over an *incoming* request's raw header block;
+        // call header_view.materialize() if you really need a multimap
+        HTTPHeaderView header_view;
         std::map<std::string, std::string> cookies;
         std::map<std::string, HTTPFileEntry> files;
+        // request-lifetime scratch allocator, set by the serving session
+        // (NULL on client-side requests); see RequestArena
+        RequestArena* arena;
 
         void addFile(const std::string& fieldname, const std::string& filename, const std::string& content_type, HTTPDatablock* contents);
     };
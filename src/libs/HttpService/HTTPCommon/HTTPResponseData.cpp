@@ -12,10 +12,39 @@ License:    Dual license model; choose one of two:
 Copyright 2010 Dan Weatherford and Facebook, Inc
 \**********************************************************/
 
+#include <new>
+#include <boost/pool/singleton_pool.hpp>
+
 #include "HTTPResponseData.h"
 
 using namespace HTTP;
 
+namespace {
+    typedef boost::singleton_pool<HTTPResponseData, sizeof(HTTPResponseData)> HTTPResponseDataPool;
+}
+
+void* HTTPResponseData::operator new(std::size_t size) {
+    if (size != sizeof(HTTPResponseData)) {
+        return ::operator new(size);
+    }
+    void* ptr = HTTPResponseDataPool::malloc();
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void HTTPResponseData::operator delete(void* ptr, std::size_t size) {
+    if (!ptr) {
+        return;
+    }
+    if (size != sizeof(HTTPResponseData)) {
+        ::operator delete(ptr);
+        return;
+    }
+    HTTPResponseDataPool::free(ptr);
+}
+
 HTTPDatablock* HTTPResponseData::coalesceBlocks() {
   if (data.empty()) {
     data.push_back(new HTTPStringDatablock());
@@ -35,6 +64,7 @@ HTTPResponseData::~HTTPResponseData() {
     for (std::list<HTTPDatablock*>::iterator it = data.begin(); it != data.end(); ++it) {
         delete *it;
     }
+    delete source;
 }
 
 void HTTPResponseData::setNoncacheable() {
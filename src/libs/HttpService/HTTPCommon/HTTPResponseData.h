@@ -26,20 +26,33 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 namespace HTTP {
     class HTTPResponseData {
     public:
-        HTTPResponseData() : code(200) {}
-        HTTPResponseData(HTTPDatablock* b) { data.push_back(b); }
+        HTTPResponseData() : code(200), source(NULL) {}
+        HTTPResponseData(HTTPDatablock* b) : code(200), source(NULL) { data.push_back(b); }
         ~HTTPResponseData();
 
         void addDatablock(HTTPDatablock* b) { data.push_back(b); }
+        // Appends a reference to a shared block (cached fragment, mapped
+        // file) without copying it; see HTTPSharedDatablock
+        void addDatablock(const boost::shared_ptr<const HTTPDatablock>& b) { data.push_back(new HTTPSharedDatablock(b)); }
+        // Streams the response body from the source with chunked
+        // transfer-encoding; the body comes exclusively from the source and
+        // any blocks in the data list are discarded.  Takes ownership.
+        void setDatablockSource(HTTPDatablockSource* s) { source = s; }
         HTTPDatablock* coalesceBlocks();
 
         void setNoncacheable(); // Add all of the usual cache-control headers to prevent the browser from caching the response.
 
+        // One response object is made and freed per request; they come off a
+        // fixed-size free list instead of the general heap
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         unsigned int code;
         std::string code_detail; // The full first response line. "HTTP/1.1 200 OK", etc
         std::multimap<std::string, std::string> headers;
         std::map<std::string, std::string> cookies;
         std::list<HTTPDatablock*> data;
+        HTTPDatablockSource* source;    // non-NULL for streaming (chunked) responses
     };
 };
 
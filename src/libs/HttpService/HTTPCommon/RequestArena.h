@@ -0,0 +1,102 @@
+/**********************************************************\
+Original Author: Dan Weatherford
+
+Imported into FireBreath:    Oct 4, 2010
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 Dan Weatherford and Facebook, Inc
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTP_REQUESTARENA
+#define H_HTTP_REQUESTARENA
+
+#include <cstddef>
+#include <vector>
+
+namespace HTTP {
+
+    // Bump allocator for request-scoped scratch memory.  A session resets its
+    // arena between requests on a kept-alive connection, so per-request
+    // scratch (handler work buffers, temporary encodings) comes from memory
+    // that is already hot and is reclaimed with a pointer rewind instead of
+    // per-object frees.  Allocations are never individually released and must
+    // not outlive the request; anything that goes into the response itself
+    // belongs in a datablock, not here.
+    class RequestArena {
+    public:
+        RequestArena() : current(0), used(0) {}
+        ~RequestArena() {
+            for (size_t i = 0; i < chunks.size(); ++i)
+                delete[] chunks[i];
+        }
+
+        // Returns request-lifetime storage, suitably aligned for any scalar
+        void* alloc(size_t bytes) {
+            bytes = (bytes + (align_to - 1)) & ~(align_to - 1);
+            if (bytes > chunk_size)
+                return allocOversize(bytes);
+            if (chunks.empty() || used + bytes > chunk_size) {
+                if (current + 1 < chunks.size()) {
+                    ++current;              // reuse a chunk kept from an earlier request
+                } else {
+                    chunks.push_back(new char[chunk_size]);
+                    current = chunks.size() - 1;
+                }
+                used = 0;
+            }
+            char* p = chunks[current] + used;
+            used += bytes;
+            return p;
+        }
+
+        // Copies a byte range into the arena (handy for scratch strings)
+        char* allocCopy(const char* data, size_t len) {
+            char* p = static_cast<char*>(alloc(len + 1));
+            for (size_t i = 0; i < len; ++i) p[i] = data[i];
+            p[len] = '\0';
+            return p;
+        }
+
+        // Rewinds to empty, keeping up to keep_chunks chunks of capacity for
+        // the next request and freeing the rest (and all oversize blocks)
+        void reset() {
+            while (chunks.size() > keep_chunks) {
+                delete[] chunks.back();
+                chunks.pop_back();
+            }
+            for (size_t i = 0; i < oversize.size(); ++i)
+                delete[] oversize[i];
+            oversize.clear();
+            current = 0;
+            used = 0;
+        }
+
+    private:
+        static const size_t chunk_size = 4096;
+        static const size_t align_to = sizeof(double) > sizeof(void*) ? sizeof(double) : sizeof(void*);
+        static const size_t keep_chunks = 2;
+
+        void* allocOversize(size_t bytes) {
+            char* p = new char[bytes];
+            oversize.push_back(p);
+            return p;
+        }
+
+        std::vector<char*> chunks;
+        std::vector<char*> oversize;    // rare blocks bigger than a chunk
+        size_t current;                 // chunk being bumped
+        size_t used;                    // bytes used in the current chunk
+
+        // non-copyable
+        RequestArena(const RequestArena&);
+        RequestArena& operator=(const RequestArena&);
+    };
+};
+
+#endif // H_HTTP_REQUESTARENA
@@ -0,0 +1,120 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <boost/bind.hpp>
+
+#include "TigerStreamHasher.h"
+
+using namespace HTTP;
+
+TigerStreamHasher::TigerStreamHasher(size_t queueByteBudget)
+  : m_byteBudget(queueByteBudget)
+  , m_done(false)
+  , m_valid(true)
+  , m_completed(false)
+  , m_expectedPos(0)
+  , m_queuedBytes(0)
+  , m_queuedHighWater(0)
+  , m_thread(boost::bind(&TigerStreamHasher::run, this))
+{
+}
+
+TigerStreamHasher::~TigerStreamHasher()
+{
+    // an empty chunk stops the worker; harmless if it already finalized
+    m_queue.push(ChunkPtr());
+    m_thread.join();
+}
+
+bool TigerStreamHasher::onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *stream)
+{
+    if (!evt->getLength())
+        return false;
+
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        if (!m_valid)
+            return false;
+        if (evt->getDataPosition() != m_expectedPos) {
+            // out-of-order chunk (range read); a running digest can't recover
+            m_valid = false;
+            return false;
+        }
+        m_expectedPos += evt->getLength();
+        m_queuedBytes += evt->getLength();
+        if (m_queuedBytes > m_queuedHighWater)
+            m_queuedHighWater = m_queuedBytes;
+    }
+
+    m_queue.push(evt->copyData());
+    return false;
+}
+
+bool TigerStreamHasher::onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *stream)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_completed = evt->success;
+    }
+    m_queue.push(ChunkPtr());
+    return false;
+}
+
+void TigerStreamHasher::run()
+{
+    for (;;) {
+        ChunkPtr chunk;
+        m_queue.wait_and_pop(chunk);
+        if (!chunk)
+            break;
+        m_digest.process_bytes(&(*chunk)[0], chunk->size());
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_queuedBytes -= chunk->size();
+    }
+
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_valid = m_valid && m_completed;
+    if (m_valid)
+        m_digest.finalize();
+    m_done = true;
+    m_cond.notify_all();
+}
+
+bool TigerStreamHasher::waitForDigest(Tiger& digest)
+{
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while (!m_done)
+        m_cond.wait(lock);
+    if (m_valid)
+        digest = m_digest;
+    return m_valid;
+}
+
+bool TigerStreamHasher::ready() const
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    return m_done;
+}
+
+uint64_t TigerStreamHasher::getBytesHashed() const
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    return const_cast<Tiger&>(m_digest).processed_size();
+}
+
+size_t TigerStreamHasher::getQueuedHighWater() const
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    return m_queuedHighWater;
+}
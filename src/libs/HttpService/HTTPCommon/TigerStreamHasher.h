@@ -0,0 +1,112 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_TIGERSTREAMHASHER
+#define H_TIGERSTREAMHASHER
+
+#include <boost/thread.hpp>
+#include "DefaultBrowserStreamHandler.h"
+#include "SafeQueue.h"
+#include "Tiger.h"
+
+namespace HTTP {
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @class  TigerStreamHasher
+    ///
+    /// @brief  Hashes a BrowserStream's content on a worker thread while it downloads
+    ///
+    /// Attach one of these to a (sequential) BrowserStream like any other stream handler and the
+    /// Tiger digest is computed chunk by chunk as the data arrives, so it is ready the moment the
+    /// stream completes instead of costing a full extra pass over the file afterwards.  Chunks
+    /// are copied once (via the event's shared copy) onto a queue drained by the worker; the
+    /// enqueue never blocks, so the network path is never gated on hashing -- the byte budget
+    /// only flags a worker that can't keep up (see getQueuedHighWater), which Tiger at memory
+    /// bandwidth never is against a network link.
+    ///
+    /// Out-of-order delivery (range reads on a seekable stream) would corrupt a running digest,
+    /// so the hasher invalidates itself if a chunk arrives anywhere but the current end of the
+    /// hashed prefix.
+    ///
+    /// @code
+    ///      boost::shared_ptr<HTTP::TigerStreamHasher> hasher(new HTTP::TigerStreamHasher());
+    ///      stream->AttachObserver(hasher);
+    ///      ...                                 // after StreamCompletedEvent:
+    ///      Tiger digest;
+    ///      if (hasher->waitForDigest(digest))
+    ///          verify(digest.toString());
+    /// @endcode
+    /// @since 1.5
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    class TigerStreamHasher : public FB::DefaultBrowserStreamHandler
+    {
+    public:
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn TigerStreamHasher::TigerStreamHasher(size_t queueByteBudget = 8 * 1024 * 1024)
+        ///
+        /// @brief  Starts the hashing worker; queueByteBudget is the advisory bound on bytes
+        ///         queued ahead of the worker, tracked by getQueuedHighWater
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        TigerStreamHasher(size_t queueByteBudget = 8 * 1024 * 1024);
+        virtual ~TigerStreamHasher();
+
+        virtual bool onStreamDataArrived(FB::StreamDataArrivedEvent *evt, FB::BrowserStream *stream);
+        virtual bool onStreamCompleted(FB::StreamCompletedEvent *evt, FB::BrowserStream *stream);
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        /// @fn bool TigerStreamHasher::waitForDigest(Tiger& digest)
+        ///
+        /// @brief  Blocks until the digest is finalized (normally instantaneous once the stream
+        ///         has completed)
+        ///
+        /// @return false if no valid digest exists: the stream failed, delivered data out of
+        ///         order, or hasn't completed and never will
+        ////////////////////////////////////////////////////////////////////////////////////////////////////
+        bool waitForDigest(Tiger& digest);
+
+        /// true once the digest is finalized and waitForDigest won't block
+        bool ready() const;
+
+        /// Bytes hashed so far
+        uint64_t getBytesHashed() const;
+        /// Most bytes ever queued ahead of the worker; if this tops the byte budget the worker
+        /// can't keep up with the link
+        size_t getQueuedHighWater() const;
+
+    private:
+        // queue item: data chunk, or an empty ptr as the finalize/stop marker
+        typedef FB::StreamDataArrivedEvent::DataCopyPtr ChunkPtr;
+
+        void run();
+        void invalidate();
+
+        FB::SafeQueue<ChunkPtr> m_queue;
+        size_t                  m_byteBudget;
+
+        mutable boost::mutex    m_mutex;
+        boost::condition_variable m_cond;
+        bool                    m_done;         // worker finalized (or was stopped)
+        bool                    m_valid;        // digest meaningful when done
+        bool                    m_completed;    // stream finished successfully
+        Tiger                   m_digest;
+        uint64_t                m_expectedPos;  // next stream offset the digest can extend to
+        size_t                  m_queuedBytes;
+        size_t                  m_queuedHighWater;
+
+        boost::thread           m_thread;       // must be last: starts in the ctor
+    };
+};
+
+#endif
@@ -0,0 +1,101 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "TigerTree.h"
+
+using namespace HTTP;
+
+namespace {
+    // shared completion state for one parallel hash; leaves decrement the
+    // counter as they finish and the caller blocks until it hits zero
+    struct LeafLatch {
+        boost::mutex mtx;
+        boost::condition_variable cond;
+        size_t remaining;
+
+        LeafLatch(size_t count) : remaining(count) { }
+
+        void done() {
+            boost::lock_guard<boost::mutex> lock(mtx);
+            if (--remaining == 0)
+                cond.notify_all();
+        }
+        void wait() {
+            boost::unique_lock<boost::mutex> lock(mtx);
+            while (remaining)
+                cond.wait(lock);
+        }
+    };
+
+    void hashLeaf(const char* data, size_t len, Tiger* out, LeafLatch* latch) {
+        *out = Tiger(data, len);
+        latch->done();
+    }
+
+    Tiger combineLeaves(const std::vector<Tiger>& leaves) {
+        // 0x01 marker keeps an inner-node digest from colliding with a leaf
+        // hashed over the same 24*n bytes of payload
+        Tiger root;
+        const char marker = 0x01;
+        root.process_bytes(&marker, 1);
+        for (size_t i = 0; i < leaves.size(); ++i)
+            root.process_bytes(leaves[i].hash_data(), leaves[i].hash_size());
+        root.finalize();
+        return root;
+    }
+}
+
+Tiger TigerTree::hash(const void* data, size_t len, size_t leafSize)
+{
+    if (!leafSize)
+        leafSize = DefaultLeafSize;
+    if (len <= leafSize)
+        return Tiger(data, len);
+
+    const char* base = static_cast<const char*>(data);
+    std::vector<Tiger> leaves((len + leafSize - 1) / leafSize);
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        const size_t start = i * leafSize;
+        leaves[i] = Tiger(base + start, (std::min)(leafSize, len - start));
+    }
+    return combineLeaves(leaves);
+}
+
+Tiger TigerTree::hash(const void* data, size_t len, FB::ThreadPool& pool, size_t leafSize)
+{
+    if (!leafSize)
+        leafSize = DefaultLeafSize;
+    if (len <= leafSize || pool.getThreadCount() < 2)
+        return hash(data, len, leafSize);
+
+    const char* base = static_cast<const char*>(data);
+    std::vector<Tiger> leaves((len + leafSize - 1) / leafSize);
+    LeafLatch latch(leaves.size());
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        const size_t start = i * leafSize;
+        const size_t n = (std::min)(leafSize, len - start);
+        if (!pool.post(boost::bind(&hashLeaf, base + start, n, &leaves[i], &latch))) {
+            // pool shut down mid-submission; hash the rest on this thread
+            hashLeaf(base + start, n, &leaves[i], &latch);
+        }
+    }
+    latch.wait();
+    return combineLeaves(leaves);
+}
+
@@ -0,0 +1,50 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_TIGERTREE
+#define H_TIGERTREE
+
+#include "Tiger.h"
+#include "ThreadPool.h"
+
+namespace HTTP {
+
+    // Tree-hash mode for Tiger.  The input is split into fixed-size leaves,
+    // each leaf is hashed independently -- which is what makes the work
+    // parallelizable across the factory thread pool -- and the root digest is
+    // Tiger over a 0x01 marker followed by the concatenated leaf digests.
+    //
+    // Tiger's compression function is a 64-bit table-lookup chain with a
+    // serial dependency between blocks, so there is nothing profitable to
+    // vectorize inside one stream; the throughput win comes entirely from
+    // hashing leaves on all cores.  The tree digest is NOT the same value as
+    // flat Tiger over the same bytes (any tree scheme changes the digest);
+    // both ends of a verification must agree on the mode and leaf size.
+    class TigerTree {
+    public:
+        static const size_t DefaultLeafSize = 1024 * 1024;
+
+        // single-threaded reference implementation; same result as the
+        // parallel overload
+        static Tiger hash(const void* data, size_t len, size_t leafSize = DefaultLeafSize);
+
+        // hashes leaves in parallel on the given pool, blocking until the
+        // root digest is ready; the data must stay valid for the duration.
+        // Falls back to the serial path for inputs of one leaf or less
+        static Tiger hash(const void* data, size_t len, FB::ThreadPool& pool, size_t leafSize = DefaultLeafSize);
+    };
+};
+
+#endif
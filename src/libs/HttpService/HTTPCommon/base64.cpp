@@ -9,67 +9,109 @@
 
 static const char* base64_charset = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
 
-std::string base64_encode(const std::string& indata) {
-  std::string outdata;
-  outdata.reserve(((indata.size() * 8) / 6) + 2);
-  std::string::size_type remaining = indata.size();
-  const char* dp = indata.data();
-
-  while (remaining >= 3) {
-    outdata.push_back(base64_charset[(dp[0] & 0xfc) >> 2]);
-    outdata.push_back(base64_charset[((dp[0] & 0x03) << 4) | ((dp[1] & 0xf0) >> 4)]); 
-    outdata.push_back(base64_charset[((dp[1] & 0x0f) << 2) | ((dp[2] & 0xc0) >> 6)]);
-    outdata.push_back(base64_charset[(dp[2] & 0x3f)]);
-    remaining -= 3; dp += 3;
-  }
-  
-  if (remaining == 2) {
-    outdata.push_back(base64_charset[(dp[0] & 0xfc) >> 2]);
-    outdata.push_back(base64_charset[((dp[0] & 0x03) << 4) | ((dp[1] & 0xf0) >> 4)]); 
-    outdata.push_back(base64_charset[((dp[1] & 0x0f) << 2)]);
-    outdata.push_back(base64_charset[64]);
-  } else if (remaining == 1) {
-    outdata.push_back(base64_charset[(dp[0] & 0xfc) >> 2]);
-    outdata.push_back(base64_charset[((dp[0] & 0x03) << 4)]); 
-    outdata.push_back(base64_charset[64]);
-    outdata.push_back(base64_charset[64]);
+// 4096-entry table mapping each 12-bit input group straight to its two
+// output characters, so the hot loop does two 2-byte stores per 3 input
+// bytes instead of four masked single-character lookups
+static const char* encode_pair_table() {
+  static char* tbl = NULL;
+  if (! tbl) {
+    tbl = new char[4096 * 2];
+    for (unsigned v = 0; v < 4096; ++v) {
+      tbl[v * 2]     = base64_charset[v >> 6];
+      tbl[v * 2 + 1] = base64_charset[v & 0x3f];
+    }
   }
-
-  return outdata;
+  return tbl;
 }
 
-std::string base64_decode(const std::string& indata) {
-  std::string outdata;
-  outdata.reserve((indata.size() * 6) / 8);
+static const char* decode_table() {
   static char* xtbl = NULL;
-  if (! xtbl) { 
+  if (! xtbl) {
     // Build translation table from base64_charset string (once)
     xtbl = new char[256];
     memset(xtbl, 0, 256);
     for (char s = 0; s < 64; ++s) {
-      xtbl[base64_charset[s]] = s; 
+      xtbl[(unsigned char)base64_charset[s]] = s;
     }
-    xtbl[base64_charset[64]] = 0; // padding character
+    xtbl[(unsigned char)base64_charset[64]] = 0; // padding character
   }
+  return xtbl;
+}
 
+std::string base64_encode(const std::string& indata) {
+  const char* pairs = encode_pair_table();
+  // size the output up front and write through a raw pointer; push_back's
+  // per-character capacity checks dominated the old loop
+  std::string outdata(((indata.size() + 2) / 3) * 4, '\0');
   std::string::size_type remaining = indata.size();
-  const char* p = indata.data();
+  const unsigned char* dp = reinterpret_cast<const unsigned char*>(indata.data());
+  char* op = outdata.empty() ? NULL : &outdata[0];
+
+  while (remaining >= 3) {
+    const unsigned group = (dp[0] << 16) | (dp[1] << 8) | dp[2];
+    memcpy(op,     pairs + ((group >> 12) * 2), 2);
+    memcpy(op + 2, pairs + ((group & 0xfff) * 2), 2);
+    remaining -= 3; dp += 3; op += 4;
+  }
+
+  if (remaining == 2) {
+    op[0] = base64_charset[(dp[0] & 0xfc) >> 2];
+    op[1] = base64_charset[((dp[0] & 0x03) << 4) | ((dp[1] & 0xf0) >> 4)];
+    op[2] = base64_charset[((dp[1] & 0x0f) << 2)];
+    op[3] = base64_charset[64];
+  } else if (remaining == 1) {
+    op[0] = base64_charset[(dp[0] & 0xfc) >> 2];
+    op[1] = base64_charset[((dp[0] & 0x03) << 4)];
+    op[2] = base64_charset[64];
+    op[3] = base64_charset[64];
+  }
+
+  return outdata;
+}
+
+// Shared worker: decodes in[0..insize) into out (which may alias in, since
+// the write position never catches the read position) and returns the
+// decoded length
+static size_t base64_decode_buffer(const char* p, size_t remaining, char* out) {
+  const char* xtbl = decode_table();
+  char* op = out;
   while (remaining >= 4) {
     char xp[4];
-    for (size_t s = 0; s < 4; ++s) xp[s] = xtbl[p[s]]; 
-    outdata.push_back((xp[0] << 2) | ((xp[1] & 0x30) >> 4));
-    outdata.push_back(((xp[1] & 0x0f) << 4) | ((xp[2] & 0x3c) >> 2));
-    outdata.push_back(((xp[2] & 0x03) << 6) | xp[3]);
+    for (size_t s = 0; s < 4; ++s) xp[s] = xtbl[(unsigned char)p[s]];
+    // check padding before the stores below; when decoding in place the
+    // stores can overwrite these input positions
+    const bool pad3 = (p[3] == base64_charset[64]);
+    const bool pad2 = (p[2] == base64_charset[64]);
+    op[0] = (xp[0] << 2) | ((xp[1] & 0x30) >> 4);
+    op[1] = ((xp[1] & 0x0f) << 4) | ((xp[2] & 0x3c) >> 2);
+    op[2] = ((xp[2] & 0x03) << 6) | xp[3];
+    op += 3;
     remaining -= 4;
     if (remaining == 0) {
-      if (p[3] == base64_charset[64]) outdata.resize(outdata.size() - 1);
-      if (p[2] == base64_charset[64]) outdata.resize(outdata.size() - 1);
+      if (pad3) --op;
+      if (pad2) --op;
       break;
     }
     p += 4;
   }
   if (remaining) { // compatibility for old, broken padding
-    while (*(p++) == base64_charset[64]) outdata.resize(outdata.size() - 1); // pop_back
+    while (*(p++) == base64_charset[64]) --op; // pop_back
   }
+  return op - out;
+}
+
+std::string base64_decode(const std::string& indata) {
+  std::string outdata(((indata.size() + 3) / 4) * 3, '\0');
+  if (indata.empty())
+    return outdata;
+  outdata.resize(base64_decode_buffer(indata.data(), indata.size(), &outdata[0]));
   return outdata;
 }
+
+void base64_decode_inplace(std::string& data) {
+  if (data.empty())
+    return;
+  // decoded output is always shorter than the input, so decode over the top
+  // of it and shrink -- no second multi-MB allocation
+  data.resize(base64_decode_buffer(data.data(), data.size(), &data[0]));
+}
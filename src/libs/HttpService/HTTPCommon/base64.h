@@ -17,4 +17,7 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 
 std::string base64_encode(const std::string& indata);
 std::string base64_decode(const std::string& indata);
+// Decodes data over the top of itself and shrinks it; avoids the output
+// allocation for multi-MB payloads
+void base64_decode_inplace(std::string& data);
 
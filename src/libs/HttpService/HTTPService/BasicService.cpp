@@ -51,15 +51,60 @@ using namespace HTTP;
 
 void BasicService::registerHandler(boost::shared_ptr<HTTPHandler> hnd) {
     handlers.push_back(hnd);
+    rebuildRoutes();
 }
 
 void BasicService::deregisterHandler(boost::shared_ptr<HTTPHandler> hnd) {
     handlers.remove(hnd);
+    rebuildRoutes();
+}
+
+namespace {
+    // "/api/v1/thing" -> "api"; "" or "/" -> ""
+    std::string firstPathSegment(const std::string& path) {
+        size_t begin = 0;
+        while (begin < path.size() && path[begin] == '/') ++begin;
+        size_t end = path.find('/', begin);
+        return path.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    }
+}
+
+void BasicService::rebuildRoutes() {
+    handler_routes.clear();
+    wildcard_handlers.clear();
+    for (HandlerList::const_iterator it = handlers.begin(); it != handlers.end(); ++it) {
+        const std::string prefix = firstPathSegment((*it)->getPathPrefix());
+        if (prefix.empty())
+            wildcard_handlers.push_back(*it);
+        else
+            handler_routes[prefix].push_back(*it);
+    }
+}
+
+HTTPResponseData* BasicService::dispatchRequest(const HTTPRequestData& req, bool verified) {
+    HTTPResponseData* resp = NULL;
+    // one map lookup routes straight to the handlers claiming this segment,
+    // so dispatch cost doesn't grow with the number of registered handlers
+    std::map<std::string, HandlerList>::const_iterator routed = handler_routes.find(firstPathSegment(req.uri.path));
+    if (routed != handler_routes.end()) {
+        for (HandlerList::const_iterator it = routed->second.begin(); it != routed->second.end(); ++it) {
+            if ((!verified) && ((*it)->requiresVerifiedURI())) continue;
+            if ((resp = (*it)->handleRequest(req))) return resp;
+        }
+    }
+    // handlers that registered no prefix are consulted for everything, in
+    // registration order, exactly as the old full scan did
+    for (HandlerList::const_iterator it = wildcard_handlers.begin(); it != wildcard_handlers.end(); ++it) {
+        if ((!verified) && ((*it)->requiresVerifiedURI())) continue;
+        if ((resp = (*it)->handleRequest(req))) return resp;
+    }
+    return NULL;
 }
 
 BasicService::BasicService(const std::string &ipaddr, const int port, const std::string &hostname)
     : signing_key(NULL),
       signing_key_length(0),
+      next_shard(0),
       srv_acceptor(service),
       srv_endpoint(ip::tcp::endpoint(ip::address_v4::from_string(ipaddr.c_str()), port)),
       m_hostname(hostname) { }
@@ -71,29 +116,65 @@ void BasicService::init() {
     signing_key_length = 2048;
     signing_key = Platform::getRandomBytes(signing_key_length);
 
+    // The HMAC pads over the key are constant and a multiple of Tiger's
+    // 64-byte block, so hash them once here; per-request signing clones
+    // these states and only has to hash the (short) message
+    {
+        const char opad = 0x5c, ipad = 0x36;
+        boost::scoped_array<char> pad(new char[signing_key_length]);
+        for (size_t i = 0; i < signing_key_length; ++i) pad[i] = signing_key[i] ^ ipad;
+        inner_key_state.reset();
+        inner_key_state.process_bytes(pad.get(), signing_key_length);
+        for (size_t i = 0; i < signing_key_length; ++i) pad[i] = signing_key[i] ^ opad;
+        outer_key_state.reset();
+        outer_key_state.process_bytes(pad.get(), signing_key_length);
+    }
+
+    // One io_service per worker; the work guard keeps a shard's run() alive
+    // while it has no sessions yet
+    for (std::size_t i = 0; i < threadpool_size; ++i) {
+        shared_ptr<Shard> shard(new Shard);
+        shard->work.reset(new io_service::work(shard->service));
+        shards.push_back(shard);
+    }
+
     // Bind and open acceptor socket
     srv_acceptor.open(srv_endpoint.protocol());
     srv_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
     srv_acceptor.bind(srv_endpoint);
     srv_acceptor.listen();
+    // non-blocking so handle_accept can drain a burst of queued connections
+    // synchronously; the async_accept path is unaffected
+    {
+        boost::system::error_code nb_ec;
+        srv_acceptor.non_blocking(true, nb_ec);
+    }
     srv_endpoint = srv_acceptor.local_endpoint();
     FBLOG_INFO("HTTP:Service", "Started server on " << srv_endpoint.port());
     do_async_accept();
 
-    // Start worker threadpool.
-    for (std::size_t i = 0; i < threadpool_size; ++i) {
-        shared_ptr<boost::thread> thread(new boost::thread(boost::bind(&BasicService::_worker_thread_entry, this)));
-        threadpool.push_back(thread);
+    // Start the shard workers plus the accept loop.
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        shards[i]->thread.reset(new boost::thread(
+            boost::bind(&BasicService::_worker_thread_entry, this, &shards[i]->service)));
     }
+    accept_thread.reset(new boost::thread(
+        boost::bind(&BasicService::_worker_thread_entry, this, &service)));
 }
 
 void BasicService::terminate() {
     service.stop();
     srv_acceptor.close();
-    for (size_t i = 0; i < threadpool.size(); ++i) {
-        threadpool[i]->interrupt();
+    if (accept_thread) {
+        accept_thread->interrupt();
+        accept_thread.reset();
+    }
+    for (size_t i = 0; i < shards.size(); ++i) {
+        shards[i]->work.reset();
+        shards[i]->service.stop();
+        if (shards[i]->thread) shards[i]->thread->interrupt();
     }
-    threadpool.clear();
+    shards.clear();
     deferred_shutdown_ref.reset();
 }
 
@@ -102,9 +183,9 @@ BasicService::~BasicService() {
     delete[] signing_key;
 }
 
-void BasicService::_worker_thread_entry() {
+void BasicService::_worker_thread_entry(io_service* svc) {
     try {
-        service.run();
+        svc->run();
     } catch (...) {
         // Don't let exceptions escape from the io_service, that'd result
         // in terminate() getting called. All bad.
@@ -130,39 +211,48 @@ FB::URI BasicService::getBaseUri() const {
 }
 
 std::string BasicService::tiger_hmac(const std::string& sign_str) const {
-    const char opad = 0x5c, ipad = 0x36;
-
-    size_t inner_size = signing_key_length + sign_str.size();
-    boost::scoped_array<char> inner(new char[inner_size]);
-    for (size_t i = 0; i < signing_key_length; ++i) {
-        inner[i] = signing_key[i] ^ ipad;
-    }
-    memcpy(inner.get() + signing_key_length, sign_str.c_str(), sign_str.size());
-    Tiger inner_hash(inner.get(), inner_size);
+    // Resume from the precomputed keyed states (flat copies); the resulting
+    // byte stream -- key-xor-pad followed by the message -- is identical to
+    // what the old from-scratch version hashed, so signatures are unchanged.
+    Tiger inner_hash(inner_key_state);
+    inner_hash.process_bytes(sign_str.c_str(), sign_str.size());
+    inner_hash.finalize();
 
-    size_t outer_size = signing_key_length + inner_hash.hash_size();
-    boost::scoped_array<char> outer(new char[outer_size]);
-    for (size_t i = 0; i < signing_key_length; ++i) {
-        outer[i] = signing_key[i] ^ opad;
-    }
-    memcpy(outer.get() + signing_key_length, inner_hash.hash_data(), inner_hash.hash_size());
-    Tiger outer_hash(outer.get(), outer_size);
+    Tiger outer_hash(outer_key_state);
+    outer_hash.process_bytes(inner_hash.hash_data(), inner_hash.hash_size());
+    outer_hash.finalize();
     return std::string(outer_hash.hash_data(), outer_hash.hash_size());
 }
 
+std::string BasicService::hmac_for_path(const std::string& path) const {
+    boost::mutex::scoped_lock lock(sig_cache_mutex);
+    std::map<std::string, std::string>::const_iterator it = sig_cache.find(path);
+    if (it != sig_cache.end()) return it->second;
+    // crude bound; the handful of live paths re-sign instantly after a clear
+    if (sig_cache.size() >= 256) sig_cache.clear();
+    const std::string sig = tiger_hmac(path);
+    sig_cache[path] = sig;
+    return sig;
+}
+
 void BasicService::sign_uri(FB::URI& in_uri) const {
-    in_uri.query_data["_s"] = base64_encode(tiger_hmac(in_uri.path));
+    in_uri.query_data["_s"] = base64_encode(hmac_for_path(in_uri.path));
 }
 
 bool BasicService::check_uri_signature(const FB::URI& in_uri) {
     std::map<std::string, std::string>::const_iterator it = in_uri.query_data.find("_s");
     if (it == in_uri.query_data.end()) return false; // no sig
 
-    return (base64_decode(it->second) == tiger_hmac(in_uri.path));
+    return (base64_decode(it->second) == hmac_for_path(in_uri.path));
 }
 
 void BasicService::do_async_accept() {
-    Session::ptr sp = new Session(service);
+    // round-robin the new session onto the next shard; every async op it
+    // runs from here on stays on that shard's thread
+    Shard& shard = *shards[next_shard];
+    next_shard = (next_shard + 1) % shards.size();
+
+    Session::ptr sp = new Session(shard.service);
     srv_acceptor.async_accept(sp->socket(), boost::bind(&BasicService::handle_accept, this, _1, sp));
 }
 
@@ -170,6 +260,21 @@ void BasicService::handle_accept(const boost::system::error_code& ec, BasicServi
     if (!ec) {
         boost::shared_ptr<BasicService> service(boost::dynamic_pointer_cast<BasicService>(shared_from_this()));
         acc_sess->start(service);
+
+        // Burst connects (a multi-tab session opening several connections at
+        // once) usually leave more completions already queued on the listen
+        // socket; drain them here with non-blocking accepts instead of taking
+        // one connection per event-loop pass
+        for (;;) {
+            Shard& shard = *shards[next_shard];
+            Session::ptr sp = new Session(shard.service);
+            boost::system::error_code acc_ec;
+            srv_acceptor.accept(sp->socket(), acc_ec);
+            if (acc_ec)
+                break;      // would-block (queue drained) or a real error: re-arm async
+            next_shard = (next_shard + 1) % shards.size();
+            sp->start(service);
+        }
         // TODO should we log accept errors?
     }
 
@@ -18,6 +18,7 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 
 #include "win_targetver.h"
 #include <boost/asio.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 #include <boost/thread.hpp>
@@ -33,6 +34,7 @@ Copyright 2010 Dan Weatherford and Facebook, Inc
 #include "HTTPHandler.h"
 #include "../HTTPCommon/HTTPRequestData.h"
 #include "../HTTPCommon/HTTPResponseData.h"
+#include "HTTPCompression.h"
 
 namespace HTTP {
     class BasicService : public HTTPService {
@@ -59,12 +61,13 @@ namespace HTTP {
         void sign_uri(FB::URI& in_uri) const;
 
     protected:
-        static const size_t threadpool_size = 2;
+        // number of worker shards (one io_service + one thread each)
+        static const size_t threadpool_size = 4;
 
     protected:
         void init();
 
-        void _worker_thread_entry();
+        void _worker_thread_entry(boost::asio::io_service* svc);
         void do_async_accept();
         bool check_uri_signature(const FB::URI& in_url);
 
@@ -81,26 +84,90 @@ namespace HTTP {
         protected:
             void wait_for_header();
             void handle_request(boost::system::error_code ec);
+            void handle_idle_timeout(const boost::system::error_code& ec);
             void handle_response_datablock_complete(boost::system::error_code ec, HTTPResponseData* resp);
+            // starts sending from the front of the datablock list: sendfile
+            // for file-backed blocks on POSIX; everything else is gathered
+            // into one writev-style async_write (headers + body in a single
+            // syscall and packet) up to the next file-backed block
+            void write_next_datablock(HTTPResponseData* resp);
+            void handle_sendfile_ready(boost::system::error_code ec, HTTPResponseData* resp);
+            // chunked streaming: pull one block from the response's datablock
+            // source, frame it, write it, repeat on completion
+            void write_next_chunk(HTTPResponseData* resp);
+            void handle_chunk_complete(boost::system::error_code ec, HTTPResponseData* resp);
+            void handle_last_chunk_complete(boost::system::error_code ec, HTTPResponseData* resp);
+            void finish_response(HTTPResponseData* resp);
 
             boost::asio::ip::tcp::socket sock;
-            boost::asio::streambuf data;
+            // held by pointer so an idle session that ballooned its buffer on
+            // a large request can swap in a fresh one and give the memory back
+            boost::scoped_ptr<boost::asio::streambuf> data;
+            size_t buffer_high_water;   // largest buffered size this connection has seen
+            boost::asio::deadline_timer idle_timer;
             boost::shared_ptr<BasicService> parent_svc;
+            size_t sendfile_offset;     // bytes of the front datablock already sent via sendfile
+            size_t gather_count;        // datablocks covered by the in-flight gathered write
+            RequestArena arena;         // request-scoped scratch; reset between requests
+            bool keep_alive;            // persist the connection after the current response
+            std::string chunk_header;   // framing for the chunk currently being written
+            HTTPDatablock* chunk_block; // body of the chunk currently being written
+#ifdef HTTPSERVICE_HAS_ZLIB
+            ZlibWorkspace zlib_ws;      // deflate state reused across this session's responses
+#endif
         };
         friend class HTTP::BasicService::Session;
 
         void handle_accept(const boost::system::error_code& ec, Session::ptr socket);
         std::string tiger_hmac(const std::string& sign_str) const;
+        // raw HMAC for a path, memoized; sign_uri and check_uri_signature
+        // both go through here so a path is ever signed at most once
+        std::string hmac_for_path(const std::string& path) const;
+        // Runs the request through the routing table: handlers claiming the
+        // request's first path segment are tried first, then the handlers
+        // registered without a prefix, in registration order.  Returns NULL
+        // if nobody produced a response.
+        HTTPResponseData* dispatchRequest(const HTTPRequestData& req, bool verified);
+        // Rebuilds the routing table from the handler list; called on
+        // register/deregister so dispatch does no per-request list scans
+        void rebuildRoutes();
         // -- data
         char* signing_key;
         size_t signing_key_length;
+        // Tiger state precomputed over the constant (and block-aligned)
+        // ipad/opad keyed prefixes; tiger_hmac clones these and hashes only
+        // the message instead of re-hashing the 2048-byte key every time
+        Tiger inner_key_state;
+        Tiger outer_key_state;
+        // memoized raw signatures keyed by path: a session's requests hit
+        // the same handful of signed paths over and over
+        mutable boost::mutex sig_cache_mutex;
+        mutable std::map<std::string, std::string> sig_cache;
         boost::weak_ptr<BasicService> _weak_ref;
-        std::list<boost::shared_ptr<HTTPHandler> > handlers;
+        typedef std::list<boost::shared_ptr<HTTPHandler> > HandlerList;
+        HandlerList handlers;
+        // routing table built at registration: first path segment -> handlers
+        // claiming it; handlers with no prefix stay on the wildcard list
+        std::map<std::string, HandlerList> handler_routes;
+        HandlerList wildcard_handlers;
 
         boost::shared_ptr<BasicService> deferred_shutdown_ref;
 
-        std::vector<boost::shared_ptr<boost::thread> > threadpool;
+        // One io_service per worker thread, with sessions pinned to the
+        // shard whose acceptor handed them out (round-robin).  Each shard's
+        // queue is touched by exactly one thread, so bursts of small
+        // requests don't serialize on a shared io_service lock.
+        struct Shard {
+            boost::asio::io_service service;
+            boost::scoped_ptr<boost::asio::io_service::work> work;
+            boost::shared_ptr<boost::thread> thread;
+        };
+        std::vector<boost::shared_ptr<Shard> > shards;
+        size_t next_shard;
+
+        // `service` only runs the acceptor; accepted sockets belong to a shard
         boost::asio::io_service service;
+        boost::shared_ptr<boost::thread> accept_thread;
 
         boost::asio::ip::tcp::acceptor srv_acceptor;
         boost::asio::ip::tcp::endpoint srv_endpoint;
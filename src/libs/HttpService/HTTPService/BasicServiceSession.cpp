@@ -12,8 +12,25 @@ License:    Dual license model; choose one of two:
 Copyright 2010 Dan Weatherford and Facebook, Inc
 \**********************************************************/
 
+// system sendfile headers must come first: Tiger.h (via BasicService.h)
+// #defines ssize_t, which would mangle their prototypes
+#ifndef _WIN32
+#include <cerrno>
+#ifdef __APPLE__
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#else
+#include <sys/sendfile.h>
+#endif
+#endif
+
 #include "BasicService.h"
+#include <ctime>
+#include <sstream>
+#include <boost/array.hpp>
 #include <boost/algorithm/string.hpp>
+
 #include "../HTTPCommon/HTTPException.h"
 #include "../HTTPCommon/Utils.h"
 #include "logging.h"
@@ -32,42 +49,218 @@ using std::vector;
 
 using namespace HTTP;
 
-BasicService::Session::Session(boost::asio::io_service& svc) : sock(svc) {
+namespace {
+    // generous for localhost; a reused connection answers in microseconds, so
+    // anything idle this long is a client that went away
+    const long session_idle_timeout_sec = 30;
+    // a read buffer grown past this on some earlier request is replaced while
+    // the connection idles, so mostly-idle keep-alive sessions stay small
+    const size_t buffer_shrink_threshold = 64 * 1024;
+
+    // RFC 1123 date for Last-Modified.  If-Modified-Since is compared against
+    // this exact string (the RFC blesses the exact-match shortcut, and any
+    // reasonable client echoes our date back verbatim), so no parsing needed.
+    std::string http_date(std::time_t t) {
+        char buf[40];
+        struct tm g;
+#ifdef _WIN32
+        gmtime_s(&g, &t);
+#else
+        gmtime_r(&t, &g);
+#endif
+        std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &g);
+        return std::string(buf);
+    }
+
+    const char* reason_phrase(unsigned int code) {
+        switch (code) {
+            case 206: return "Partial Content";
+            case 304: return "Not Modified";
+            case 404: return "Not Found";
+            case 416: return "Requested Range Not Satisfiable";
+            default:  return "OK";
+        }
+    }
+
+    // Byte-range view that owns the block it slices.  The fd is deliberately
+    // not forwarded: the sendfile path always starts at file offset zero, so
+    // a range has to go out through the mapped data() path instead.
+    class OwningRangeDatablock : public HTTPRangeDatablock {
+    public:
+        OwningRangeDatablock(HTTPDatablock* _parent, size_t off, size_t len)
+            : HTTPRangeDatablock(_parent, off, len), owned(_parent) {}
+        virtual ~OwningRangeDatablock() { delete owned; }
+    private:
+        HTTPDatablock* owned;
+    };
+
+    // Conditional (ETag / If-Modified-Since -> 304) and single byte-range
+    // (Range / If-Range -> 206) handling.  Only responses whose body is one
+    // datablock with a known mtime qualify -- in practice, file-backed
+    // responses; handler-generated bodies pass through untouched.
+    void apply_conditional_and_range(const HTTPRequestData& req, HTTPResponseData* resp) {
+        if (resp->code != 200 || resp->source || resp->data.size() != 1) return;
+        HTTPDatablock* block = resp->data.front();
+        const std::time_t mtime = block->lastModified();
+        if (! mtime) return;
+        const size_t total = block->size();
+
+        std::ostringstream etag_os;
+        etag_os << "\"" << std::hex << total << "-" << mtime << "\"";
+        const std::string etag = etag_os.str();
+        const std::string lastmod = http_date(mtime);
+
+        resp->headers.insert(std::make_pair("ETag", etag));
+        resp->headers.insert(std::make_pair("Last-Modified", lastmod));
+        resp->headers.insert(std::make_pair("Accept-Ranges", "bytes"));
 
+        std::string cond;
+        bool not_modified = false;
+        if (req.header_view.tryGetValue("If-None-Match", cond)) {
+            not_modified = (cond.find(etag) != std::string::npos) || trim_copy(cond) == "*";
+        } else if (req.header_view.tryGetValue("If-Modified-Since", cond)) {
+            not_modified = (trim_copy(cond) == lastmod);
+        }
+        if (not_modified) {
+            resp->code = 304;
+            delete block;
+            resp->data.clear();
+            return;
+        }
+
+        std::string range;
+        if (! req.header_view.tryGetValue("Range", range)) return;
+        // If-Range: serve the range only while the entity is unchanged,
+        // otherwise the client needs the full body anyway
+        if (req.header_view.tryGetValue("If-Range", cond)) {
+            trim(cond);
+            if (cond != etag && cond != lastmod) return;
+        }
+        trim(range);
+        if (! istarts_with(range, "bytes=")) return;
+        range.erase(0, 6);
+        // single range only: multipart/byteranges isn't worth its weight for
+        // a localhost service, and a multi-range client falls back cleanly
+        // to the 200 with the whole file
+        if (range.find(',') != std::string::npos) return;
+        const size_t dash = range.find('-');
+        if (dash == std::string::npos) return;
+        const std::string first = trim_copy(range.substr(0, dash));
+        const std::string last = trim_copy(range.substr(dash + 1));
+        size_t start, end;
+        try {
+            if (first.empty()) {
+                // suffix form: the last N bytes
+                if (last.empty()) return;
+                const size_t n = lexical_cast<size_t>(last);
+                // a zero-length suffix is unsatisfiable; fall through to 416
+                start = n ? ((n >= total) ? 0 : total - n) : total;
+                end = total ? total - 1 : 0;
+            } else {
+                start = lexical_cast<size_t>(first);
+                end = last.empty() ? (total ? total - 1 : 0) : lexical_cast<size_t>(last);
+            }
+        } catch (const boost::bad_lexical_cast&) {
+            return;     // malformed Range is just ignored, per the RFC
+        }
+        if (end >= total) end = total ? total - 1 : 0;
+        if (start >= total || start > end) {
+            resp->code = 416;
+            delete block;
+            resp->data.clear();
+            resp->headers.insert(std::make_pair("Content-Range",
+                "bytes */" + lexical_cast<string>(total)));
+            return;
+        }
+
+        resp->data.front() = new OwningRangeDatablock(block, start, end - start + 1);
+        resp->code = 206;
+        std::ostringstream cr;
+        cr << "bytes " << start << "-" << end << "/" << total;
+        resp->headers.insert(std::make_pair("Content-Range", cr.str()));
+    }
 }
 
-BasicService::Session::~Session() {
+BasicService::Session::Session(boost::asio::io_service& svc) : sock(svc), data(new boost::asio::streambuf), buffer_high_water(0), idle_timer(svc), sendfile_offset(0), gather_count(0), keep_alive(false), chunk_block(NULL) {
 
 }
 
+BasicService::Session::~Session() {
+    delete chunk_block;
+}
+
 void BasicService::Session::start(const boost::shared_ptr<BasicService>& _parent_svc) {
     parent_svc = _parent_svc;
     wait_for_header();
 }
 
 void BasicService::Session::wait_for_header() {
-    async_read_until(sock, data, "\r\n\r\n", boost::bind(&Session::handle_request, BasicService::Session::ptr(this), _1));  
+    // previous request is done; its scratch is reclaimed with one rewind and
+    // the kept chunks stay hot for the next request on this connection
+    arena.reset();
+    // a buffer that ballooned for one large request would otherwise pin that
+    // memory for the life of the keep-alive connection; swap in a fresh one
+    // (carrying over any pipelined bytes) while the connection is idle
+    if (buffer_high_water > buffer_shrink_threshold) {
+        boost::scoped_ptr<boost::asio::streambuf> fresh(new boost::asio::streambuf);
+        if (data->size()) {
+            std::ostream os(fresh.get());
+            os.write(boost::asio::buffer_cast<const char*>(data->data()), data->size());
+        }
+        data.swap(fresh);
+        buffer_high_water = 0;
+    }
+    // pipelined requests already sitting in the streambuf satisfy this read
+    // immediately, so back-to-back requests are answered strictly in order
+    // without another network round trip
+    idle_timer.expires_from_now(boost::posix_time::seconds(session_idle_timeout_sec));
+    idle_timer.async_wait(boost::bind(&Session::handle_idle_timeout, BasicService::Session::ptr(this), _1));
+    async_read_until(sock, *data, "\r\n\r\n", boost::bind(&Session::handle_request, BasicService::Session::ptr(this), _1));
 }
 
+void BasicService::Session::handle_idle_timeout(const boost::system::error_code& ec) {
+    if (ec == boost::asio::error::operation_aborted)
+        return;     // a request arrived and rearmed the timer
+    boost::system::error_code ignored;
+    sock.close(ignored);
+}
 
 void BasicService::Session::handle_request(boost::system::error_code ec) {
+    idle_timer.cancel();
     if (ec) {
         FBLOG_WARN("Http:BasicService", "handle_request error message: " << ec.message());
         return;
     }
 
-    std::vector<string> header_lines;
-    std::istream data_stream(&data);
-    while (!data_stream.eof()) {
-        string tmp;
-        std::getline(data_stream, tmp);
-        trim(tmp);
-        if (tmp.size() && tmp.at(tmp.size() - 1) == '\r') tmp.resize(tmp.size() - 1);
-        if (tmp.empty()) break;
-        header_lines.push_back(tmp);
+    // Pull the header block out of the streambuf in one piece: the request
+    // line is split off and the rest stays unsplit for the header view to
+    // index in place.  Bytes past the blank line (pipelined requests) are
+    // left in the streambuf.
+    std::string request_line;
+    std::string header_block;
+    {
+        if (data->size() > buffer_high_water)
+            buffer_high_water = data->size();
+        const char* raw = boost::asio::buffer_cast<const char*>(data->data());
+        const size_t avail = data->size();
+        size_t block_end = avail;   // async_read_until guarantees the delimiter, but be defensive
+        for (size_t i = 0; i + 3 < avail; ++i) {
+            if (raw[i] == '\r' && raw[i+1] == '\n' && raw[i+2] == '\r' && raw[i+3] == '\n') {
+                block_end = i + 4;
+                break;
+            }
+        }
+        size_t first_eol = 0;
+        while (first_eol < block_end && raw[first_eol] != '\n') ++first_eol;
+        request_line.assign(raw, first_eol);
+        trim(request_line);
+        if (first_eol < block_end)
+            header_block.assign(raw + first_eol + 1, block_end - first_eol - 1);
+        data->consume(block_end);
     }
 
     HTTPRequestData req_data;
+    req_data.arena = &arena;
     HTTPResponseData* resp = NULL;
 
     // First line is like: GET /honk/test?asdf=1234 HTTP/1.1
@@ -76,13 +269,23 @@ void BasicService::Session::handle_request(boost::system::error_code ec) {
     // The path is entity-encoded; "%20" = character 0x20 (which is a space), for example
     try {
         std::vector<string> req_parts;
-        split(req_parts, header_lines[0], is_any_of(" "));
+        split(req_parts, request_line, is_any_of(" "));
         if (req_parts.size() != 3) throw HTTPException(400, "Malformed Request-Line");
         req_data.method = req_parts[0];
         req_data.uri = FB::URI::fromString(req_parts[1]);
 
-        // Split the rest of the header lines into the request data
-        req_data.headers = parse_http_headers(++header_lines.begin(), header_lines.end());
+        // Index the rest of the header block in place; names and values stay
+        // as spans of the block until somebody reads them
+        req_data.header_view.assign(header_block);
+
+        // HTTP/1.1 defaults to persistent connections; either side can opt out
+        keep_alive = (req_parts[2] == "HTTP/1.1");
+        for (size_t i = 0; i < req_data.header_view.size(); ++i) {
+            if (!req_data.header_view.nameIs(i, "Connection")) continue;
+            const std::string v = req_data.header_view.getValue(i);
+            if (iequals(v, "close")) keep_alive = false;
+            else if (iequals(v, "keep-alive")) keep_alive = true;
+        }
 
         if (req_data.uri.path == "/shutdown") {
             FBLOG_INFO("Http:BasicServiceSession", "Received shutdown request");
@@ -102,37 +305,60 @@ void BasicService::Session::handle_request(boost::system::error_code ec) {
                 response_str += it->first + string(": ") + it->second + string("\r\n");
             }
             response_str += string("\r\nHeaders:\r\n\r\n");
-            for (std::multimap<std::string, std::string>::const_iterator it = req_data.headers.begin(); it != req_data.headers.end(); ++it) {
-                response_str += it->first + string(": ") + it->second + string("\r\n");
+            for (size_t i = 0; i < req_data.header_view.size(); ++i) {
+                response_str += req_data.header_view.getName(i) + string(": ")
+                    + req_data.header_view.getValue(i) + string("\r\n");
             }
             resp->addDatablock(new HTTPStringDatablock(response_str));
         } else {
             bool verified = parent_svc->check_uri_signature(req_data.uri);
-            for (std::list<boost::shared_ptr<HTTPHandler> >::const_iterator it = parent_svc->handlers.begin(); it != parent_svc->handlers.end(); ++it) {
-                if ((!verified) && ((*it)->requiresVerifiedURI())) continue;
-                if ((resp = (*it)->handleRequest(req_data))) break;
-            }
+            resp = parent_svc->dispatchRequest(req_data, verified);
             if ((!resp) && (!verified)) throw HTTPException(500, "No registered handlers responded to this request, possibly because of a missing or invalid signature.");
         }
 
         if (!resp) throw HTTPException(500, "No registered handlers responded to this request.");
 
+        // file-backed responses: revalidation (304) and byte ranges (206),
+        // so a media seek pulls one range instead of the whole file
+        apply_conditional_and_range(req_data, resp);
+
+#ifdef HTTPSERVICE_HAS_ZLIB
+        // negotiated compression stage: gzip compressible MIME types for
+        // clients that accept it, reusing this session's deflate workspace.
+        // Ranges are slices of the identity entity, so only full responses
+        // are eligible.
+        if (resp->code == 200)
+            compressResponse(zlib_ws, req_data, resp);
+#endif
+
         // Response obtained. Stringify headers and add them to the head of the block list
         {
-            // Compute content-length first
-            size_t content_length = 0;
-            for (std::list<HTTPDatablock*>::const_iterator it = resp->data.begin(); it != resp->data.end(); ++it) {
-                content_length += (*it)->size();
-            }
+            if (resp->source) {
+                // streaming response: the body comes from the source with
+                // chunked framing; discard any materialized blocks
+                for (std::list<HTTPDatablock*>::const_iterator it = resp->data.begin(); it != resp->data.end(); ++it) {
+                    delete *it;
+                }
+                resp->data.clear();
+                resp->headers.erase("Content-Length");
+                resp->headers.erase("Transfer-Encoding");
+                resp->headers.insert(std::make_pair("Transfer-Encoding", "chunked"));
+            } else {
+                // Compute content-length first
+                size_t content_length = 0;
+                for (std::list<HTTPDatablock*>::const_iterator it = resp->data.begin(); it != resp->data.end(); ++it) {
+                    content_length += (*it)->size();
+                }
 
-            resp->headers.erase("Content-Length");
-            resp->headers.insert(std::make_pair("Content-Length", lexical_cast<string>(content_length)));
+                resp->headers.erase("Content-Length");
+                resp->headers.insert(std::make_pair("Content-Length", lexical_cast<string>(content_length)));
+            }
 
             resp->headers.erase("Connection");
-            resp->headers.insert(std::make_pair("Connection", "close"));
+            resp->headers.insert(std::make_pair("Connection", keep_alive ? "keep-alive" : "close"));
 
             std::ostringstream header_os;
-            header_os << "HTTP/1.1 " << resp->code << " OK\r\n";
+            header_os << "HTTP/1.1 " << resp->code << " " << reason_phrase(resp->code) << "\r\n";
             for (std::multimap<std::string, std::string>::const_iterator it = resp->headers.begin(); it != resp->headers.end(); ++it) {
                 header_os << it->first << ": " << it->second << "\r\n";
             }
@@ -145,28 +371,172 @@ void BasicService::Session::handle_request(boost::system::error_code ec) {
     } catch (const HTTPException& e) {
         if (resp) delete resp;
         FBLOG_INFO("Http:BasicServiceSession", "HTTP exception: " << e.what());
+        // error responses carry no Content-Length, so the connection can't persist
+        keep_alive = false;
         resp = new HTTPResponseData(new HTTPStringDatablock(e.getResponseHeader() + string("\r\nContent-Type: text/plain\r\n\r\n") + e.what()));
     } catch (const std::exception& e) {
         if (resp) delete resp;
         FBLOG_INFO("Http:BasicServiceSession", "std::exception: " << e.what());
+        keep_alive = false;
         resp = new HTTPResponseData(new HTTPStringDatablock(string("HTTP/1.1 500 Internal Server Error\r\nContent-Type: text/plain\r\n\r\n") + e.what()));
     }
     // And write the response datablock list.
-    async_write(sock, buffer((*resp->data.begin())->data(), (*resp->data.begin())->size()), boost::bind(&Session::handle_response_datablock_complete, BasicService::Session::ptr(this), _1, resp));
+    write_next_datablock(resp);
 }
 
-void BasicService::Session::handle_response_datablock_complete(boost::system::error_code ec, HTTPResponseData* resp) {
+void BasicService::Session::write_next_datablock(HTTPResponseData* resp) {
+    HTTPDatablock* block = *resp->data.begin();
+    gather_count = 1;
+#ifndef _WIN32
+    // File-backed blocks go kernel-to-kernel with sendfile instead of being
+    // copied through userland; if TLS or response transforms are ever added
+    // to this server, this branch must be skipped when they are active.
+    // (Windows/TransmitFile needs overlapped plumbing asio doesn't expose
+    // here; the mapped data() path below is already single-copy.)
+    if (block->nativeFileDescriptor() >= 0) {
+        sendfile_offset = 0;
+        sock.async_write_some(null_buffers(), boost::bind(&Session::handle_sendfile_ready, BasicService::Session::ptr(this), _1, resp));
+        return;
+    }
+#endif
+    // Gather every contiguous memory-backed block (headers + body for the
+    // typical API reply) into one writev-style async_write: one syscall, and
+    // no header-only small packet on the wire.  The blocks stay on the list
+    // until the completion handler pops them, so the buffers remain valid.
+    std::vector<const_buffer> bufs;
+    for (std::list<HTTPDatablock*>::const_iterator it = resp->data.begin(); it != resp->data.end(); ++it) {
+#ifndef _WIN32
+        if ((*it)->nativeFileDescriptor() >= 0)
+            break;      // the rest starts with a sendfile-eligible block
+#endif
+        bufs.push_back(buffer((*it)->data(), (*it)->size()));
+    }
+    gather_count = bufs.size();
+    async_write(sock, bufs, boost::bind(&Session::handle_response_datablock_complete, BasicService::Session::ptr(this), _1, resp));
+}
+
+void BasicService::Session::handle_sendfile_ready(boost::system::error_code ec, HTTPResponseData* resp) {
     if (ec) {
         delete resp;
         sock.close();
         return;
     }
-    delete resp->data.front();
-    resp->data.pop_front();
-    if (resp->data.empty()) {
+#ifndef _WIN32
+    HTTPDatablock* block = *resp->data.begin();
+    const int fd = block->nativeFileDescriptor();
+    for (;;) {
+        if (sendfile_offset >= block->size()) {
+            handle_response_datablock_complete(boost::system::error_code(), resp);
+            return;
+        }
+#ifdef __APPLE__
+        off_t len = block->size() - sendfile_offset;
+        int result = ::sendfile(fd, sock.native_handle(), sendfile_offset, &len, NULL, 0);
+        sendfile_offset += len;
+        if (result == 0) continue;
+        const int err = errno;
+#else
+        off_t off = sendfile_offset;
+        // long, not ssize_t: Tiger.h #defines ssize_t away on this include path
+        long sent = ::sendfile(sock.native_handle(), fd, &off, block->size() - sendfile_offset);
+        if (sent >= 0) {
+            sendfile_offset = off;
+            continue;
+        }
+        const int err = errno;
+#endif
+        if (err == EINTR) continue;
+        if (err == EAGAIN || err == EWOULDBLOCK) {
+            // socket buffer full; come back when it drains
+            sock.async_write_some(null_buffers(), boost::bind(&Session::handle_sendfile_ready, BasicService::Session::ptr(this), _1, resp));
+            return;
+        }
+        // e.g. a filesystem sendfile can't serve from: finish this block
+        // through the buffered path off the mapping
+        FBLOG_INFO("Http:BasicServiceSession", "sendfile failed (errno " << err << "); falling back to buffered write");
+        async_write(sock, buffer(block->data() + sendfile_offset, block->size() - sendfile_offset), boost::bind(&Session::handle_response_datablock_complete, BasicService::Session::ptr(this), _1, resp));
+        return;
+    }
+#endif
+}
+
+void BasicService::Session::write_next_chunk(HTTPResponseData* resp) {
+    // pulling only after the previous chunk completed its write is the
+    // backpressure: the source is never more than one block ahead of the wire
+    HTTPDatablock* block = resp->source->nextBlock();
+    if (block && !block->size()) {
+        delete block;
+        block = NULL;
+    }
+    if (!block) {
+        // end of stream: terminating zero-length chunk
+        chunk_header = "0\r\n\r\n";
+        async_write(sock, buffer(chunk_header), boost::bind(&Session::handle_last_chunk_complete, BasicService::Session::ptr(this), _1, resp));
+        return;
+    }
+
+    chunk_block = block;
+    std::ostringstream os;
+    os << std::hex << block->size() << "\r\n";
+    chunk_header = os.str();
+    boost::array<const_buffer, 3> bufs = {{
+        buffer(chunk_header),
+        buffer(block->data(), block->size()),
+        buffer("\r\n", 2)
+    }};
+    async_write(sock, bufs, boost::bind(&Session::handle_chunk_complete, BasicService::Session::ptr(this), _1, resp));
+}
+
+void BasicService::Session::handle_chunk_complete(boost::system::error_code ec, HTTPResponseData* resp) {
+    delete chunk_block;
+    chunk_block = NULL;
+    if (ec) {
         delete resp;
         sock.close();
         return;
     }
-    async_write(sock, buffer((*resp->data.begin())->data(), (*resp->data.begin())->size()), boost::bind(&Session::handle_response_datablock_complete, BasicService::Session::ptr(this), _1, resp));
+    write_next_chunk(resp);
+}
+
+void BasicService::Session::handle_last_chunk_complete(boost::system::error_code ec, HTTPResponseData* resp) {
+    if (ec) {
+        delete resp;
+        sock.close();
+        return;
+    }
+    finish_response(resp);
+}
+
+void BasicService::Session::finish_response(HTTPResponseData* resp) {
+    delete resp;
+    if (keep_alive && sock.is_open()) {
+        // response done; loop for the next request on the same connection
+        wait_for_header();
+    } else {
+        sock.close();
+    }
+}
+
+void BasicService::Session::handle_response_datablock_complete(boost::system::error_code ec, HTTPResponseData* resp) {
+    if (ec) {
+        delete resp;
+        sock.close();
+        return;
+    }
+    // pop every block the completed (possibly gathered) write covered
+    for (size_t n = gather_count ? gather_count : 1; n; --n) {
+        delete resp->data.front();
+        resp->data.pop_front();
+    }
+    gather_count = 0;
+    if (resp->data.empty()) {
+        if (resp->source) {
+            // header block written; stream the body from the source
+            write_next_chunk(resp);
+            return;
+        }
+        finish_response(resp);
+        return;
+    }
+    write_next_datablock(resp);
 }
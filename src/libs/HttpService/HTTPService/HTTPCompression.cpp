@@ -0,0 +1,149 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#ifdef HTTPSERVICE_HAS_ZLIB
+
+#include <cstring>
+#include <list>
+#include <boost/algorithm/string.hpp>
+
+#include "HTTPCompression.h"
+
+using namespace HTTP;
+
+namespace {
+    // bodies smaller than this lose more to gzip framing than they gain
+    const size_t min_compress_size = 256;
+
+    bool clientAcceptsGzip(const HTTPRequestData& req) {
+        return req.header_view.valueContains("Accept-Encoding", "gzip");
+    }
+
+    bool mimeTypeCompressible(const std::string& contentType) {
+        // the highly compressible families this service actually serves;
+        // everything else (images, media, octet-stream) goes out raw
+        return boost::algorithm::istarts_with(contentType, "text/")
+            || boost::algorithm::icontains(contentType, "json")
+            || boost::algorithm::icontains(contentType, "javascript")
+            || boost::algorithm::icontains(contentType, "xml");
+    }
+}
+
+ZlibWorkspace::ZlibWorkspace() : initialized(false) {
+    std::memset(&strm, 0, sizeof(strm));
+}
+
+ZlibWorkspace::~ZlibWorkspace() {
+    if (initialized)
+        deflateEnd(&strm);
+}
+
+bool ZlibWorkspace::beginGzip() {
+    if (initialized)
+        return deflateReset(&strm) == Z_OK;
+    // windowBits 15+16 selects the gzip wrapper
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+    initialized = true;
+    return true;
+}
+
+bool ZlibWorkspace::deflateChunk(const char* in, size_t len, int flush, std::string& out) {
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+    strm.avail_in = static_cast<uInt>(len);
+    do {
+        strm.next_out = reinterpret_cast<Bytef*>(buf);
+        strm.avail_out = sizeof(buf);
+        int ret = deflate(&strm, flush);
+        if (ret == Z_STREAM_ERROR)
+            return false;
+        out.append(buf, sizeof(buf) - strm.avail_out);
+        if (ret == Z_STREAM_END)
+            break;
+    } while (strm.avail_in || !strm.avail_out);
+    return true;
+}
+
+CompressingDatablockSource::CompressingDatablockSource(ZlibWorkspace* ws, HTTPDatablockSource* inner)
+  : workspace(ws), source(inner), finished(false) {
+}
+
+CompressingDatablockSource::~CompressingDatablockSource() {
+    delete source;
+}
+
+HTTPDatablock* CompressingDatablockSource::nextBlock() {
+    if (finished)
+        return NULL;
+
+    std::string out;
+    while (out.empty()) {
+        HTTPDatablock* block = source->nextBlock();
+        if (!block) {
+            finished = true;
+            workspace->deflateChunk(NULL, 0, Z_FINISH, out);
+            break;
+        }
+        workspace->deflateChunk(block->data(), block->size(), Z_SYNC_FLUSH, out);
+        delete block;
+    }
+    if (out.empty())
+        return NULL;
+    return new HTTPStringDatablock(out);
+}
+
+bool HTTP::compressResponse(ZlibWorkspace& ws, const HTTPRequestData& req, HTTPResponseData* resp) {
+    if (!clientAcceptsGzip(req))
+        return false;
+    if (resp->headers.find("Content-Encoding") != resp->headers.end())
+        return false;
+
+    std::multimap<std::string, std::string>::const_iterator ct = resp->headers.find("Content-Type");
+    if (ct == resp->headers.end() || !mimeTypeCompressible(ct->second))
+        return false;
+
+    if (resp->source) {
+        if (!ws.beginGzip())
+            return false;
+        resp->source = new CompressingDatablockSource(&ws, resp->source);
+        resp->headers.insert(std::make_pair("Content-Encoding", "gzip"));
+        return true;
+    }
+
+    size_t body_size = 0;
+    for (std::list<HTTPDatablock*>::const_iterator it = resp->data.begin(); it != resp->data.end(); ++it)
+        body_size += (*it)->size();
+    if (body_size < min_compress_size)
+        return false;
+
+    if (!ws.beginGzip())
+        return false;
+
+    std::string out;
+    out.reserve(body_size / 4);
+    for (std::list<HTTPDatablock*>::const_iterator it = resp->data.begin(); it != resp->data.end(); ++it) {
+        std::list<HTTPDatablock*>::const_iterator next = it;
+        const int flush = (++next == resp->data.end()) ? Z_FINISH : Z_NO_FLUSH;
+        if (!ws.deflateChunk((*it)->data(), (*it)->size(), flush, out))
+            return false;   // original blocks untouched; response goes out raw
+    }
+    for (std::list<HTTPDatablock*>::iterator it = resp->data.begin(); it != resp->data.end(); ++it)
+        delete *it;
+    resp->data.clear();
+    resp->data.push_back(new HTTPStringDatablock(out));
+    resp->headers.insert(std::make_pair("Content-Encoding", "gzip"));
+    return true;
+}
+
+#endif // HTTPSERVICE_HAS_ZLIB
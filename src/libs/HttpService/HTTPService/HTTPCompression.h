@@ -0,0 +1,76 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#pragma once
+#ifndef H_HTTPCOMPRESSION
+#define H_HTTPCOMPRESSION
+
+#ifdef HTTPSERVICE_HAS_ZLIB
+
+#include <string>
+#include <zlib.h>
+#include "../HTTPCommon/HTTPDatablock.h"
+#include "../HTTPCommon/HTTPRequestData.h"
+#include "../HTTPCommon/HTTPResponseData.h"
+
+namespace HTTP {
+
+    // Per-session deflate state.  The z_stream and its ~256KB of internal
+    // workspace are allocated once and reused (deflateReset) across every
+    // response the session compresses, so the compression stage costs no
+    // per-request allocation.
+    class ZlibWorkspace {
+    public:
+        ZlibWorkspace();
+        ~ZlibWorkspace();
+
+        // (re)initializes the stream for a new gzip-framed response
+        bool beginGzip();
+        // deflates [in, in+len) appending output to out; flush is one of
+        // Z_NO_FLUSH / Z_SYNC_FLUSH / Z_FINISH
+        bool deflateChunk(const char* in, size_t len, int flush, std::string& out);
+
+    private:
+        z_stream strm;
+        bool initialized;
+        char buf[16384];    // reused output staging
+    };
+
+    // Wraps a streaming response source, gzip-compressing each pulled block.
+    // Z_SYNC_FLUSH after every block keeps each chunk independently sendable
+    // so streaming latency is preserved.
+    class CompressingDatablockSource : public HTTPDatablockSource {
+    public:
+        // takes ownership of inner; ws must outlive this source (it belongs
+        // to the session, which it does)
+        CompressingDatablockSource(ZlibWorkspace* ws, HTTPDatablockSource* inner);
+        virtual ~CompressingDatablockSource();
+        virtual HTTPDatablock* nextBlock();
+
+    private:
+        ZlibWorkspace* workspace;
+        HTTPDatablockSource* source;
+        bool finished;
+    };
+
+    // Applies the negotiated compression stage to a response: if the client
+    // accepts gzip and the Content-Type is on the compressible list (JSON,
+    // text, javascript, xml), the body -- materialized blocks or a streaming
+    // source -- is replaced with its gzip equivalent and Content-Encoding is
+    // set.  Returns true if the response was compressed.
+    bool compressResponse(ZlibWorkspace& ws, const HTTPRequestData& req, HTTPResponseData* resp);
+};
+
+#endif // HTTPSERVICE_HAS_ZLIB
+#endif // H_HTTPCOMPRESSION
@@ -15,21 +15,55 @@
 #include <boost/interprocess/file_mapping.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace HTTP {
     class HTTPFileDatablock : public HTTPDatablock {
     public:
-        HTTPFileDatablock(const std::string& fp) : mmfile(fp.c_str(), boost::interprocess::read_only), region(mmfile, boost::interprocess::read_only) {}
-        virtual ~HTTPFileDatablock() {}
-        
+        HTTPFileDatablock(const std::string& fp) : mtime(0), mmfile(fp.c_str(), boost::interprocess::read_only), region(mmfile, boost::interprocess::read_only) {
+#ifdef _WIN32
+            struct _stat st;
+            if (::_stat(fp.c_str(), &st) == 0) mtime = st.st_mtime;
+#else
+            // kept alongside the mapping so the session can serve this block
+            // with sendfile; the mapping stays as the fallback data() path
+            fd = ::open(fp.c_str(), O_RDONLY);
+            struct stat st;
+            if (fd >= 0 && ::fstat(fd, &st) == 0) mtime = st.st_mtime;
+#endif
+        }
+        virtual ~HTTPFileDatablock() {
+#ifndef _WIN32
+            if (fd >= 0) ::close(fd);
+#endif
+        }
+
         virtual size_t size() const {
             return region.get_size();
         }
         virtual const char* data() const {
             return reinterpret_cast<const char*>(region.get_address());
         }
+#ifndef _WIN32
+        virtual int nativeFileDescriptor() const {
+            return fd;
+        }
+#endif
+        virtual std::time_t lastModified() const {
+            return mtime;
+        }
     protected:
+        std::time_t mtime;
         boost::interprocess::file_mapping mmfile;
         boost::interprocess::mapped_region region;
+#ifndef _WIN32
+        int fd;
+#endif
     };
 };
 
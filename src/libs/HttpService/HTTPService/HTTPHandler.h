@@ -29,6 +29,11 @@ namespace HTTP {
         // If this is true, request URIs without a verifiable signature will
         // not be passed to handleRequest.
         virtual bool requiresVerifiedURI() const { return true; }
+        // First path segment this handler answers for (e.g. "api" to claim
+        // /api/...), letting the service route a request straight to it
+        // instead of polling every registered handler.  Leave the default
+        // (empty) to be consulted for every request, as before.
+        virtual std::string getPathPrefix() const { return std::string(); }
         // If the handler can't respond to this request, it returns NULL; otherwise, a new HTTPResponseData.
         // Actual errors throw HTTPException.
         virtual HTTPResponseData* handleRequest(const HTTPRequestData& req) = 0;
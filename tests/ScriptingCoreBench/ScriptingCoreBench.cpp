@@ -0,0 +1,260 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+// Micro-benchmarks for the ScriptingCore hot paths.  Correctness lives in
+// UnitTest_ScriptingCore; this target only measures.  Every result goes out as
+// a single machine-readable BENCH line (see benchmark.h) so the numbers can be
+// trended across builds.
+
+#include <cstdio>
+#include <string>
+#include <numeric>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+
+#include "variant.h"
+#include "variant_list.h"
+#include "JSObject.h"
+#include "BrowserHost.h"
+#include "SafeQueue.h"
+#include "TestJSAPIAuto.h"
+#include "benchmark.h"
+
+volatile size_t FB::Bench::sink = 0;
+
+namespace {
+
+    // Synchronous stand-in for a real browser: scheduled calls run inline on the
+    // calling thread, so main-thread dispatch machinery is measurable without a
+    // browser process around the benchmark
+    class StubBrowserHost : public FB::BrowserHost
+    {
+    public:
+        void* getContextID() const { return const_cast<StubBrowserHost*>(this); }
+        FB::BrowserStreamPtr createStream(const std::string&, const FB::PluginEventSinkPtr&,
+                                          bool, bool, size_t) const { return FB::BrowserStreamPtr(); }
+        FB::DOM::DocumentPtr getDOMDocument() { return FB::DOM::DocumentPtr(); }
+        FB::DOM::WindowPtr getDOMWindow() { return FB::DOM::WindowPtr(); }
+        FB::DOM::ElementPtr getDOMElement() { return FB::DOM::ElementPtr(); }
+        void evaluateJavaScript(const std::string&) { }
+    protected:
+        bool _scheduleAsyncCall(void (*func)(void *), void *userData) const
+        {
+            func(userData);
+            return true;
+        }
+    };
+
+    // Event handler that just counts its invocations
+    class CountingHandler : public FB::JSObject
+    {
+    public:
+        CountingHandler(const FB::BrowserHostPtr& host)
+            : FB::JSObject(host), m_count(0) { }
+
+        FB::JSAPIPtr getJSAPI() const { return FB::JSAPIPtr(); }
+        // each handler needs a distinct event id or registerEventMethod dedups them
+        void* getEventId() const { return const_cast<CountingHandler*>(this); }
+
+        bool HasMethod(const std::string&) const { return true; }
+        bool HasProperty(const std::string&) const { return false; }
+        bool HasProperty(int) const { return false; }
+        FB::variant GetProperty(const std::string&) { return FB::variant(); }
+        FB::variant GetProperty(int) { return FB::variant(); }
+        void SetProperty(const std::string&, const FB::variant&) { }
+        void SetProperty(int, const FB::variant&) { }
+        void getMemberNames(std::vector<std::string>&) const { }
+        size_t getMemberCount() const { return 0; }
+        FB::JSObjectPtr Construct(const std::string&, const FB::VariantList&) { return FB::JSObjectPtr(); }
+
+        FB::variant Invoke(const std::string&, const FB::VariantList&)
+        {
+            ++m_count;
+            return FB::variant();
+        }
+
+        size_t m_count;
+    };
+
+    // ------------------------------------------------------------------ variant
+
+    void benchVariantAssignInt(size_t n)
+    {
+        FB::variant v;
+        for (size_t i = 0; i < n; ++i)
+            v = static_cast<int>(i);
+        FB::Bench::sink += v.convert_cast<size_t>();
+    }
+
+    void benchVariantAssignString(size_t n)
+    {
+        const std::string s("a reasonably typical string value");
+        FB::variant v;
+        for (size_t i = 0; i < n; ++i)
+            v = s;
+        FB::Bench::sink += v.convert_cast<std::string>().size();
+    }
+
+    void benchVariantConvertIntToString(size_t n)
+    {
+        const FB::variant v(1234567);
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i)
+            acc += v.convert_cast<std::string>().size();
+        FB::Bench::sink += acc;
+    }
+
+    void benchVariantConvertStringToDouble(size_t n)
+    {
+        const FB::variant v(std::string("3.14159"));
+        double acc = 0;
+        for (size_t i = 0; i < n; ++i)
+            acc += v.convert_cast<double>();
+        FB::Bench::sink += static_cast<size_t>(acc);
+    }
+
+    void benchVariantConvertIntToDouble(size_t n)
+    {
+        const FB::variant v(42);
+        double acc = 0;
+        for (size_t i = 0; i < n; ++i)
+            acc += v.convert_cast<double>();
+        FB::Bench::sink += static_cast<size_t>(acc);
+    }
+
+    void benchVariantListConstruct(size_t n)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            FB::VariantList list(FB::variant_list_of(1)("two")(3.5));
+            FB::Bench::sink += list.size();
+        }
+    }
+
+    // ------------------------------------------------------- JSAPIAuto dispatch
+
+    void benchInvoke(const FB::JSAPIPtr& api, const FB::VariantList& args, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            api->Invoke("sumOf", args);
+    }
+
+    void benchGetProperty(const FB::JSAPIPtr& api, size_t n)
+    {
+        size_t acc = 0;
+        for (size_t i = 0; i < n; ++i)
+            acc += api->GetProperty("message").convert_cast<std::string>().size();
+        FB::Bench::sink += acc;
+    }
+
+    // --------------------------------------------------------- FireEvent fanout
+
+    // FireEvent is protected (plugins fire their own events); re-export it for timing
+    class BenchEventSource : public TestObjectJSAPIAuto
+    {
+    public:
+        void fire(const std::string& name, const FB::VariantList& args)
+        {
+            FireEvent(name, args);
+        }
+    };
+
+    void benchFireEvent(const boost::shared_ptr<BenchEventSource>& api, const FB::VariantList& args, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            api->fire("onbench", args);
+    }
+
+    void runFireEventBench(size_t handlerCount)
+    {
+        FB::BrowserHostPtr host(boost::make_shared<StubBrowserHost>());
+        boost::shared_ptr<BenchEventSource> api(boost::make_shared<BenchEventSource>());
+        std::vector<boost::shared_ptr<CountingHandler> > handlers;
+        for (size_t i = 0; i < handlerCount; ++i) {
+            boost::shared_ptr<CountingHandler> handler(boost::make_shared<CountingHandler>(host));
+            FB::JSObjectPtr obj(handler);
+            api->registerEventMethod("onbench", obj);
+            handlers.push_back(handler);
+        }
+        char name[64];
+        std::sprintf(name, "fireevent_fanout_%lu", static_cast<unsigned long>(handlerCount));
+        FB::VariantList args(FB::variant_list_of(1)(2.0));
+        FB::Bench::run(name, boost::bind(&benchFireEvent, api, args, _1));
+        for (size_t i = 0; i < handlerCount; ++i)
+            FB::Bench::sink += handlers[i]->m_count;
+    }
+
+    // ------------------------------------------------------ SafeQueue throughput
+
+    void queueProducer(FB::SafeQueue<int>* queue, size_t items)
+    {
+        for (size_t i = 0; i < items; ++i)
+            queue->push(static_cast<int>(i));
+    }
+
+    void runSafeQueueBench(size_t producers)
+    {
+        using boost::posix_time::ptime;
+        using boost::posix_time::microsec_clock;
+
+        const size_t total = 400000;
+        const size_t perProducer = total / producers;
+        FB::SafeQueue<int> queue;
+
+        ptime start(microsec_clock::universal_time());
+        boost::thread_group group;
+        for (size_t i = 0; i < producers; ++i)
+            group.create_thread(boost::bind(&queueProducer, &queue, perProducer));
+        int value;
+        for (size_t i = 0; i < perProducer * producers; ++i)
+            queue.wait_and_pop(value);
+        group.join_all();
+        double nsPerOp = FB::Bench::elapsedUs(start) * 1000.0 / static_cast<double>(perProducer * producers);
+
+        std::printf("BENCH name=safequeue_producers_%lu iters=%lu reps=1 ns_op_median=%.2f ns_op_best=%.2f ops_s=%.0f\n",
+                    static_cast<unsigned long>(producers),
+                    static_cast<unsigned long>(perProducer * producers),
+                    nsPerOp, nsPerOp, 1e9 / nsPerOp);
+        std::fflush(stdout);
+    }
+}
+
+int main()
+{
+    std::printf("# ScriptingCore micro-benchmarks; grep '^BENCH' for machine-readable records\n");
+
+    FB::Bench::run("variant_assign_int", &benchVariantAssignInt);
+    FB::Bench::run("variant_assign_string", &benchVariantAssignString);
+    FB::Bench::run("variant_convert_int_to_string", &benchVariantConvertIntToString);
+    FB::Bench::run("variant_convert_string_to_double", &benchVariantConvertStringToDouble);
+    FB::Bench::run("variant_convert_int_to_double", &benchVariantConvertIntToDouble);
+    FB::Bench::run("variant_list_construct", &benchVariantListConstruct);
+
+    {
+        FB::JSAPIPtr api(boost::make_shared<TestObjectJSAPIAuto>());
+        FB::VariantList args(FB::variant_list_of(1)(2));
+        FB::Bench::run("jsapiauto_invoke_sumOf", boost::bind(&benchInvoke, api, args, _1));
+        FB::Bench::run("jsapiauto_getproperty", boost::bind(&benchGetProperty, api, _1));
+    }
+
+    runFireEventBench(1);
+    runFireEventBench(4);
+    runFireEventBench(16);
+
+    runSafeQueueBench(1);
+    runSafeQueueBench(2);
+    runSafeQueueBench(4);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#ifndef H_FB_BENCH_HARNESS
+#define H_FB_BENCH_HARNESS
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/function.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace FB { namespace Bench {
+
+    // A benchmark body runs its workload the requested number of times
+    typedef boost::function<void (size_t)> BenchBody;
+
+    inline double elapsedUs(const boost::posix_time::ptime& since)
+    {
+        return static_cast<double>(
+            (boost::posix_time::microsec_clock::universal_time() - since).total_microseconds());
+    }
+
+    // Dumping ground that keeps the optimizer from deleting a measured loop
+    extern volatile size_t sink;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @fn inline void run(const std::string& name, const BenchBody& body)
+    ///
+    /// @brief  Stable-iteration timing harness
+    ///
+    /// Calibrates the iteration count until one repetition takes roughly 50ms (long enough to
+    /// flatten scheduler noise, short enough to keep the suite quick), then times several
+    /// repetitions and reports the median (stable number to trend) and the best (cleanest run).
+    /// Output is one record per line in key=value form so a script can grep BENCH lines and
+    /// chart them over builds.
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    inline void run(const std::string& name, const BenchBody& body)
+    {
+        using boost::posix_time::ptime;
+        using boost::posix_time::microsec_clock;
+
+        size_t iters = 1;
+        for (;;) {
+            ptime start(microsec_clock::universal_time());
+            body(iters);
+            double us = elapsedUs(start);
+            if (us >= 50000.0 || iters >= (size_t(1) << 30))
+                break;
+            // grow fast while the run is too short to measure, then scale to target
+            iters = (us < 1000.0) ? iters * 10
+                                  : static_cast<size_t>(iters * (55000.0 / us)) + 1;
+        }
+
+        const size_t reps = 5;
+        std::vector<double> nsPerOp;
+        for (size_t i = 0; i < reps; ++i) {
+            ptime start(microsec_clock::universal_time());
+            body(iters);
+            nsPerOp.push_back(elapsedUs(start) * 1000.0 / static_cast<double>(iters));
+        }
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+        const double median = nsPerOp[reps / 2];
+        const double best = nsPerOp.front();
+        std::printf("BENCH name=%s iters=%lu reps=%lu ns_op_median=%.2f ns_op_best=%.2f ops_s=%.0f\n",
+                    name.c_str(), static_cast<unsigned long>(iters),
+                    static_cast<unsigned long>(reps), median, best, 1e9 / median);
+        std::fflush(stdout);
+    }
+
+}; };
+
+#endif
@@ -25,9 +25,15 @@ Copyright 2009 Richard Bateman, Firebreath development team
 // fixing as JSAPISimple is deprecated anyway
 //#include "jsapi_test.h" 
 #include "jsapiauto_test.h"
+#include "jsapi_dispatch_test.h"
 #include "jsarray_test.h"
 #include "TypeIDMap_test.h"
 #include "jscallback_test.h"
+#include "safequeue_test.h"
+#include "threadpool_test.h"
+#include "json_parser_test.h"
+#include "small_arg_array_test.h"
+#include "json_writer_test.h"
 
 int main()
 {
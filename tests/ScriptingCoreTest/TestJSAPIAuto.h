@@ -128,4 +128,43 @@ private:
     const std::string m_readOnlyMessage;
 };
 
+// Exposes its members through a shared per-class table instead of
+// per-instance registerMethod/registerProperty calls
+class TestObjectStaticMembers : public FB::JSAPIAuto
+{
+public:
+    TestObjectStaticMembers()
+      : m_answer(42)
+    {
+        setMemberTable(getMemberTable());
+    }
+    virtual ~TestObjectStaticMembers() {}
+
+    static const FB::StaticMemberTable& getMemberTable()
+    {
+        static FB::StaticMemberTable table = FB::StaticMemberTable()
+            .method("add", FB::make_unbound_method(&TestObjectStaticMembers::add))
+            .property("answer", FB::make_unbound_property(&TestObjectStaticMembers::get_answer,
+                                                          &TestObjectStaticMembers::set_answer))
+            .property("readOnlyAnswer", FB::make_unbound_property(&TestObjectStaticMembers::get_answer));
+        return table;
+    }
+
+    long add(long a, long b)
+    {
+        return a + b;
+    }
+    long get_answer() const
+    {
+        return m_answer;
+    }
+    void set_answer(long answer)
+    {
+        m_answer = answer;
+    }
+
+private:
+    long m_answer;
+};
+
 #endif
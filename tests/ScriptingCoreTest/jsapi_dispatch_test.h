@@ -0,0 +1,91 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2010 PacketPass, Inc and the Firebreath development team
+\**********************************************************/
+
+#include <cstdlib>
+#include <new>
+#include <boost/shared_ptr.hpp>
+#include "variant_list.h"
+#include "JSAPI.h"
+#include "TestJSAPI.h"
+
+// Counting replacements for the global allocation operators; replacing them in
+// one translation unit covers the whole test binary.  Tests measure deltas
+// across their own code only, so the counter needs no isolation
+std::size_t g_globalAllocCount = 0;
+
+void* operator new(std::size_t size)
+{
+    ++g_globalAllocCount;
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    ++g_globalAllocCount;
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    std::free(ptr);
+}
+
+namespace {
+
+    // Exposes the protected dispatch-record pool so the test can drive the
+    // same acquire/fill/release cycle fireAsyncEvent performs
+    class DispatchRecordTestObject : public TestObjectJSAPI
+    {
+    public:
+        size_t fireCycle(size_t handlerCount, size_t argCount)
+        {
+            EventDispatchRecordPtr record(acquireEventDispatchRecord());
+            for (size_t i = 0; i < handlerCount; ++i)
+                record->batch.push_back(FB::EventPair("onprogress", FB::JSObjectPtr()));
+            for (size_t i = 0; i < argCount; ++i)
+                record->args.push_back(FB::variant(static_cast<int>(i)));
+            const size_t built = record->batch.size();
+            releaseEventDispatchRecord(record);
+            return built;
+        }
+    };
+}
+
+TEST(JSAPI_EventDispatchZeroAllocSteadyState)
+{
+    PRINT_TESTNAME;
+
+    boost::shared_ptr<DispatchRecordTestObject> obj(new DispatchRecordTestObject());
+
+    // Warm-up: the first cycle sizes the pooled record's vectors
+    CHECK_EQUAL(4u, obj->fireCycle(4, 4));
+
+    // Steady state: every subsequent fire of the same shape must reuse the
+    // pooled record's storage -- no global allocations at all
+    const std::size_t before = g_globalAllocCount;
+    for (int i = 0; i < 100; ++i)
+        obj->fireCycle(4, 4);
+    CHECK_EQUAL(before, g_globalAllocCount);
+}
@@ -198,3 +198,136 @@ TEST(JSAPIAuto_Methods)
         CHECK_EQUAL(description, tmp);
     }
 }
+
+TEST(JSAPIAuto_BatchedProperties)
+{
+    PRINT_TESTNAME;
+
+    using boost::assign::list_of;
+    using namespace FB;
+
+    FB::JSAPIPtr test(new TestObjectJSAPIAuto());
+
+    // one SetProperties call covers several members
+    FB::VariantMap values;
+    values["message"] = std::string("batched");
+    values["custom"] = 42;
+    test->SetProperties(values);
+    CHECK(test->GetProperty("message").cast<std::string>() == "batched");
+    CHECK(test->GetProperty("custom").convert_cast<long>() == 42);
+
+    // and one GetProperties call reads them all back
+    std::vector<std::string> names = list_of("message")("custom");
+    FB::VariantMap ret = test->GetProperties(names);
+    CHECK(ret.size() == names.size());
+    CHECK(ret["message"].cast<std::string>() == "batched");
+    CHECK(ret["custom"].convert_cast<long>() == 42);
+
+    // the pair is also scriptable, so javascript gets the batch in one crossing
+    CHECK(test->HasMethod("getProperties"));
+    CHECK(test->HasMethod("setProperties"));
+    boost::shared_ptr<FakeJsArray> jsarr(new FakeJsArray(make_variant_list(names)));
+    FB::variant var = test->Invoke("getProperties", variant_list_of(ptr_cast<JSObject>(jsarr)));
+    FB::VariantMap invoked = var.cast<FB::VariantMap>();
+    CHECK(invoked["message"].cast<std::string>() == "batched");
+}
+
+TEST(JSAPIAuto_MemberIdDispatch)
+{
+    PRINT_TESTNAME;
+
+    using boost::assign::list_of;
+    using namespace FB;
+
+    FB::JSAPIPtr test(new TestObjectJSAPIAuto());
+
+    // methods resolve to a stable id and dispatch by id
+    FB::MemberId method = test->getMemberId("returnString");
+    CHECK(method != FB::InvalidMemberId);
+    CHECK(test->getMemberId("returnString") == method);
+    FB::variant ret = test->InvokeById(method, variant_list_of("foo"));
+    CHECK(ret.cast<std::string>() == "foo");
+
+    // properties work through the same id space
+    FB::MemberId prop = test->getMemberId("message");
+    CHECK(prop != FB::InvalidMemberId);
+    test->SetPropertyById(prop, "hello there");
+    CHECK(test->GetPropertyById(prop).cast<std::string>() == "hello there");
+    CHECK(test->GetProperty("message").cast<std::string>() == "hello there");
+
+    // unknown names don't resolve
+    CHECK(test->getMemberId("noSuchMember") == FB::InvalidMemberId);
+}
+
+TEST(JSAPIAuto_StaticMemberTable)
+{
+    PRINT_TESTNAME;
+    using namespace FB;
+
+    FB::JSAPIPtr test(new TestObjectStaticMembers());
+
+    // table members dispatch like registered ones
+    CHECK(test->HasMethod("add"));
+    FB::variant ret = test->Invoke("add", variant_list_of(2)(40));
+    CHECK(ret.cast<long>() == 42);
+
+    CHECK(test->HasProperty("answer"));
+    CHECK(test->GetProperty("answer").cast<long>() == 42);
+    test->SetProperty("answer", 7);
+    CHECK(test->GetProperty("answer").cast<long>() == 7);
+
+    // read-only table properties swallow assignments like make_property does
+    test->SetProperty("readOnlyAnswer", 99);
+    CHECK(test->GetProperty("readOnlyAnswer").cast<long>() == 7);
+
+    // each instance sees the shared table but keeps its own state
+    FB::JSAPIPtr other(new TestObjectStaticMembers());
+    CHECK(other->GetProperty("answer").cast<long>() == 42);
+
+    // id-based dispatch covers table members too
+    FB::MemberId method = test->getMemberId("add");
+    CHECK(method != FB::InvalidMemberId);
+    CHECK(test->InvokeById(method, variant_list_of(3)(4)).cast<long>() == 7);
+    FB::MemberId prop = test->getMemberId("answer");
+    test->SetPropertyById(prop, 123);
+    CHECK(test->GetPropertyById(prop).cast<long>() == 123);
+
+    // table members show up in enumeration
+    std::vector<std::string> names;
+    test->getMemberNames(names);
+    CHECK(std::find(names.begin(), names.end(), "add") != names.end());
+    CHECK(std::find(names.begin(), names.end(), "answer") != names.end());
+    CHECK(test->getMemberCount() == names.size());
+}
+
+namespace jsapiauto_perf
+{
+    inline void invokeSumOf(const FB::JSAPIPtr& test, size_t n)
+    {
+        const FB::VariantList args(FB::variant_list_of(3)(4));
+        int sink = 0;
+        for (size_t i = 0; i < n; ++i)
+            sink += test->Invoke("sumOf", args).cast<int>();
+        (void)sink;
+    }
+
+    inline void getProperty(const FB::JSAPIPtr& test, size_t n)
+    {
+        size_t sink = 0;
+        for (size_t i = 0; i < n; ++i)
+            sink += test->GetProperty("message").convert_cast<std::string>().size();
+        (void)sink;
+    }
+}
+
+TEST(JSAPIAuto_TimeBudget)
+{
+    PRINT_TESTNAME;
+
+    FB::JSAPIPtr test(new TestObjectJSAPIAuto());
+
+    // coarse regression gates on the scripting dispatch path; see
+    // variant_test.h for the budget philosophy
+    CHECK_TIME_UNDER(jsapiauto_perf::invokeSumOf(test, 5000), 300);
+    CHECK_TIME_UNDER(jsapiauto_perf::getProperty(test, 10000), 300);
+}
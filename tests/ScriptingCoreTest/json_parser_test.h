@@ -0,0 +1,87 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include <sstream>
+#include <boost/make_shared.hpp>
+#include "JSONParser.h"
+#include "ThreadPool.h"
+#include "variant_list.h"
+#include "variant_map.h"
+
+TEST(JSONParserTest)
+{
+    PRINT_TESTNAME;
+
+    // one pass straight into variants: objects are maps, arrays lists,
+    // numbers int or double depending on what they hold
+    FB::variant doc = FB::jsonToVariant(
+        "{\"name\": \"r\\u00e9sum\\u00e9\", \"count\": 42, \"ratio\": 0.5,"
+        " \"ok\": true, \"missing\": null, \"tags\": [1, 2, 3]}");
+    FB::VariantMap map = doc.cast<FB::VariantMap>();
+    CHECK(map["name"].cast<std::string>() == "r\xc3\xa9sum\xc3\xa9");
+    CHECK(map["count"].cast<int>() == 42);
+    CHECK(map["ratio"].cast<double>() == 0.5);
+    CHECK(map["ok"].cast<bool>());
+    CHECK(map["missing"].is_of_type<FB::FBNull>());
+    FB::VariantList tags = map["tags"].cast<FB::VariantList>();
+    CHECK(tags.size() == 3);
+    CHECK(tags[2].cast<int>() == 3);
+
+    // numbers too big for int come back as double instead of overflowing
+    CHECK(FB::jsonToVariant("10000000000").cast<double>() == 10000000000.0);
+
+    // malformed input raises json_parse_error (a script_error)
+    CHECK_THROW(FB::jsonToVariant("{\"a\": }"), FB::json_parse_error);
+    CHECK_THROW(FB::jsonToVariant("[1, 2"), FB::json_parse_error);
+    CHECK_THROW(FB::jsonToVariant("[] []"), FB::json_parse_error);
+
+    // the parallel overload splits a large top-level array across the pool;
+    // results must come back in document order, identical to the serial parse
+    std::ostringstream big;
+    big << "[";
+    for (int i = 0; i < 20000; ++i)
+        big << (i ? "," : "") << "{\"i\": " << i << ", \"s\": \"item " << i << "\"}";
+    big << "]";
+    FB::ThreadPoolPtr pool(boost::make_shared<FB::ThreadPool>(4));
+    FB::VariantList items = FB::jsonToVariant(big.str(), pool).cast<FB::VariantList>();
+    CHECK(items.size() == 20000);
+    bool ordered = true;
+    for (int i = 0; i < 20000 && ordered; ++i) {
+        FB::VariantMap item = items[i].cast<FB::VariantMap>();
+        ordered = item["i"].cast<int>() == i;
+    }
+    CHECK(ordered);
+
+    // a top-level array of bare primitives must split correctly too -- the
+    // boundary scan has to step over whole numbers, not single characters
+    std::ostringstream nums;
+    nums << "[";
+    for (int i = 0; i < 200000; ++i)
+        nums << (i ? "," : "") << i;
+    nums << "]";
+    FB::VariantList par = FB::jsonToVariant(nums.str(), pool).cast<FB::VariantList>();
+    FB::VariantList ser = FB::jsonToVariant(nums.str()).cast<FB::VariantList>();
+    CHECK(par.size() == 200000);
+    bool same = par.size() == ser.size();
+    for (size_t i = 0; i < par.size() && same; ++i)
+        same = par[i].cast<int>() == ser[i].cast<int>();
+    CHECK(same);
+
+    // pathological nesting fails cleanly instead of exhausting the stack
+    CHECK_THROW(FB::jsonToVariant(std::string(100000, '[')), FB::json_parse_error);
+
+    // small or non-array documents just take the serial path
+    FB::VariantMap one = FB::jsonToVariant("{\"a\": 1}", pool).cast<FB::VariantMap>();
+    CHECK(one["a"].cast<int>() == 1);
+}
@@ -0,0 +1,60 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include "JSONWriter.h"
+#include "JSONParser.h"
+#include "variant_list.h"
+#include "variant_map.h"
+
+TEST(JSONWriterTest)
+{
+    PRINT_TESTNAME;
+
+    // scalars
+    CHECK(FB::variantToJson(FB::variant(42)) == "42");
+    CHECK(FB::variantToJson(FB::variant(true)) == "true");
+    CHECK(FB::variantToJson(FB::variant(std::string("hi"))) == "\"hi\"");
+    CHECK(FB::variantToJson(FB::FBNull()) == "null");
+    CHECK(FB::variantToJson(FB::variant()) == "null");
+
+    // string escaping: quotes, backslashes and control characters
+    CHECK(FB::variantToJson(FB::variant(std::string("a\"b\\c\n\t"))) == "\"a\\\"b\\\\c\\n\\t\"");
+
+    // containers nest and keep their order
+    FB::VariantMap map;
+    map["name"] = std::string("stream");
+    map["count"] = 3;
+    FB::VariantList items;
+    items.push_back(1);
+    items.push_back(2.5);
+    items.push_back(std::string("x"));
+    map["items"] = items;
+    const std::string json(FB::variantToJson(map));
+
+    // flat_map keys come out sorted, so the exact text is stable
+    CHECK(json == "{\"count\":3,\"items\":[1,2.5,\"x\"],\"name\":\"stream\"}");
+
+    // round trip through the parser preserves the tree
+    FB::variant parsed(FB::jsonToVariant(json));
+    FB::VariantMap back(parsed.cast<FB::VariantMap>());
+    CHECK(back["name"].cast<std::string>() == "stream");
+    CHECK(back["count"].convert_cast<int>() == 3);
+    CHECK(back["items"].cast<FB::VariantList>().size() == 3);
+
+    // NaN has no JSON spelling and must not produce invalid output
+    CHECK(FB::variantToJson(FB::variant(std::numeric_limits<double>::quiet_NaN())) == "null");
+
+    // wstrings serialize as utf-8
+    CHECK(FB::variantToJson(FB::variant(std::wstring(L"wide"))) == "\"wide\"");
+}
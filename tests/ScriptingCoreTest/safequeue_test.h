@@ -0,0 +1,59 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include "SafeQueue.h"
+
+TEST(SafeQueueDrainTest)
+{
+    PRINT_TESTNAME;
+
+    FB::SafeQueue<int> q;
+    std::queue<int> drained;
+
+    // draining an empty queue returns false and leaves the output alone
+    CHECK(!q.try_pop_all(drained));
+    CHECK(drained.empty());
+
+    q.push(1);
+    q.push(2);
+    q.push(3);
+
+    // everything comes out in push order in one call
+    CHECK(q.try_pop_all(drained));
+    CHECK(drained.size() == 3);
+    CHECK(drained.front() == 1);
+    drained.pop();
+    CHECK(drained.front() == 2);
+    drained.pop();
+    CHECK(drained.front() == 3);
+    drained.pop();
+    CHECK(q.empty());
+
+    // values pushed after a drain are picked up by the next one, appended
+    // after anything the caller left in the output queue
+    q.push(4);
+    drained.push(0);
+    CHECK(q.try_pop_all(drained));
+    CHECK(drained.size() == 2);
+    CHECK(drained.front() == 0);
+    drained.pop();
+    CHECK(drained.front() == 4);
+
+    // try_pop still works alongside the bulk form
+    int val(0);
+    q.push(5);
+    CHECK(q.try_pop(val));
+    CHECK(val == 5);
+    CHECK(!q.try_pop(val));
+}
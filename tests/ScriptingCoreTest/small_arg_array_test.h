@@ -0,0 +1,54 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 31, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include "SmallArgArray.h"
+
+TEST(SmallArgArrayTest)
+{
+    PRINT_TESTNAME;
+
+    // counts at or below the inline capacity never touch the heap
+    {
+        FB::SmallArgArray<int, 4> args(3);
+        CHECK(args.size() == 3);
+        CHECK(args.isInline());
+        args[0] = 10; args[1] = 20; args[2] = 30;
+        CHECK(args.get()[1] == 20);
+    }
+
+    // zero-argument calls are common and must work too
+    {
+        FB::SmallArgArray<int, 4> args(0);
+        CHECK(args.size() == 0);
+        CHECK(args.isInline());
+    }
+
+    // the boundary count still fits inline; one past it falls back to the heap
+    {
+        FB::SmallArgArray<int, 4> atCap(4);
+        CHECK(atCap.isInline());
+
+        FB::SmallArgArray<int, 4> overCap(5);
+        CHECK(!overCap.isInline());
+        for (size_t i = 0; i < overCap.size(); ++i)
+            overCap[i] = static_cast<int>(i * i);
+        CHECK(overCap[4] == 16);
+    }
+
+    // the glue's default capacity covers the dominant 0-4 argument calls
+    {
+        FB::SmallArgArray<int, FB::DefaultArgArraySize> args(4);
+        CHECK(args.isInline());
+    }
+}
@@ -0,0 +1,63 @@
+/**********************************************************\
+Original Author: Richard Bateman (taxilian)
+
+Created:    Aug 30, 2026
+License:    Dual license model; choose one of two:
+            New BSD License
+            http://www.opensource.org/licenses/bsd-license.php
+            - or -
+            GNU Lesser General Public License, version 2.1
+            http://www.gnu.org/licenses/lgpl-2.1.html
+
+Copyright 2009 Richard Bateman, Firebreath development team
+\**********************************************************/
+
+#include <boost/bind.hpp>
+#include "ThreadPool.h"
+
+namespace {
+    int addNumbers(int a, int b) { return a + b; }
+    void throwError() { throw FB::script_error("whoops"); }
+    void bumpCounter(int* counter) { ++*counter; }
+}
+
+TEST(ThreadPoolTest)
+{
+    PRINT_TESTNAME;
+
+    FB::ThreadPool pool(2);
+    CHECK(pool.getThreadCount() == 2);
+
+    // submit returns a handle whose get() blocks for and returns the result
+    boost::shared_ptr<FB::AsyncCallResult<int> > res =
+        pool.submit(boost::bind(&addNumbers, 2, 3));
+    CHECK(res->get() == 5);
+    CHECK(res->ready());
+
+    // exceptions thrown by the task come back out of get() as a script_error
+    boost::shared_ptr<FB::AsyncCallResult<void> > err =
+        pool.submit(boost::bind(&throwError));
+    try {
+        err->get();
+        CHECK(false);
+    } catch (const FB::script_error& e) {
+        CHECK(std::string("whoops") == e.what());
+    }
+
+    // queued fire-and-forget tasks drain before shutdown completes; a single
+    // worker keeps the plain int counter race-free
+    FB::ThreadPool serialPool(1);
+    int counter(0);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(serialPool.post(boost::bind(&bumpCounter, &counter)));
+    }
+    serialPool.shutdown();
+    CHECK(counter == 10);
+
+    // a shut-down pool refuses new work and fails new handles instead of hanging
+    CHECK(!serialPool.post(boost::bind(&bumpCounter, &counter)));
+    boost::shared_ptr<FB::AsyncCallResult<int> > late =
+        serialPool.submit(boost::bind(&addNumbers, 1, 1));
+    CHECK(late->ready());
+    CHECK_THROW(late->get(), FB::script_error);
+}
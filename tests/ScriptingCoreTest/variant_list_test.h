@@ -17,6 +17,34 @@ Copyright 2009 Georg Fritzsche, Firebreath development team
 #include "APITypes.h"
 #include "variant_list.h"
 
+TEST(VariantListBatchConversionTest)
+{
+    PRINT_TESTNAME;
+
+    using FB::convert_variant_list_to_buffer;
+
+    // homogeneous numeric list takes the tight loop
+    FB::VariantList numbers;
+    for (int i = 0; i < 100; ++i)
+        numbers.push_back(static_cast<double>(i));
+
+    std::vector<double> doubles;
+    convert_variant_list_to_buffer(numbers, doubles);
+    CHECK(doubles.size() == numbers.size());
+    CHECK(doubles[99] == 99.0);
+
+    std::vector<int> ints;
+    convert_variant_list_to_buffer(numbers, ints);
+    CHECK(ints[42] == 42);
+
+    // a mixed list falls back to the generic conversion path
+    numbers.push_back("123");
+    std::vector<double> mixed;
+    convert_variant_list_to_buffer(numbers, mixed);
+    CHECK(mixed.size() == numbers.size());
+    CHECK(mixed[100] == 123.0);
+}
+
 TEST(VariantListTest)
 {
     PRINT_TESTNAME;
@@ -72,6 +72,78 @@ TEST(VariantBasicTest)
     a = 0;
     CHECK(a.get_type() == typeid(int));
 }
+TEST(VariantAssignRangeTest)
+{
+    PRINT_TESTNAME;
+    using namespace FB;
+
+    const char buf[] = "browser-owned text";
+    variant a;
+    a.assign(buf, 7);
+    CHECK(a.get_type() == typeid(std::string));
+    CHECK(a.cast<std::string>() == "browser");
+
+    // reassigning over an existing string reuses the payload
+    a.assign(buf, sizeof(buf) - 1);
+    CHECK(a.cast<std::string>() == "browser-owned text");
+
+    // embedded nulls survive, since the length is explicit
+    const char raw[] = { 'a', '\0', 'b' };
+    a.assign(raw, 3);
+    CHECK(a.cast<std::string>().size() == 3);
+
+    // assigning over a non-string payload switches type
+    variant b = 42;
+    b.assign(buf, 7);
+    CHECK(b.cast<std::string>() == "browser");
+}
+
+#ifdef FB_VARIANT_RVALUE_SUPPORT
+TEST(VariantMoveTest)
+{
+    PRINT_TESTNAME;
+    using namespace FB;
+
+    variant a = std::string(1000, 'x');
+    variant b(std::move(a));
+    CHECK(b.cast<std::string>().size() == 1000);
+    CHECK(a.empty());
+
+    variant c;
+    c = std::move(b);
+    CHECK(c.cast<std::string>().size() == 1000);
+
+    // emplace-style assign; the string buffer is stolen, not copied
+    std::string src(500, 'y');
+    c.assign(std::move(src));
+    CHECK(c.cast<std::string>().size() == 500);
+
+    // moving between variants of different types steals the storage outright
+    variant d = 42;
+    d = std::move(c);
+    CHECK(d.cast<std::string>().size() == 500);
+}
+#endif
+
+TEST(VariantSharedPayloadTest)
+{
+    PRINT_TESTNAME;
+    using namespace FB;
+
+    // copying a variant that holds a VariantList shares the payload...
+    VariantList list(1000, variant(1));
+    variant a = list;
+    variant b = a;
+    CHECK(&a.cast<VariantList>() == &b.cast<VariantList>());
+
+    // ...until one of the copies is written to (copy-on-write)
+    VariantList other(3, variant(2));
+    b.assign(other, true);
+    CHECK(a.cast<VariantList>().size() == 1000);
+    CHECK(b.cast<VariantList>().size() == 3);
+    CHECK(&a.cast<VariantList>() != &b.cast<VariantList>());
+}
+
 TEST(VariantArrayConversionTest)
 {
     PRINT_TESTNAME;
@@ -103,7 +175,9 @@ TEST(VariantScriptMapConversionTest)
         typedef std::map<std::string, std::string> StringStringMap;
 
         VariantMap values = variant_map_of<std::string>("a","a")("b","b")("c","c");
-        boost::shared_ptr<FakeJsMap> jsmap(new FakeJsMap(values));
+        // FakeJsMap takes FB::VariantMap, which is flat; this local VariantMap
+        // stays std::map to prove conversion works for tree maps too
+        boost::shared_ptr<FakeJsMap> jsmap(new FakeJsMap(FB::VariantMap(values.begin(), values.end())));
         variant varJsMap = ptr_cast<JSObject>(jsmap);
         VariantMap result = varJsMap.convert_cast<VariantMap>();
 
@@ -187,97 +261,135 @@ TEST(VariantIsOfTypeTest)
         CHECK(( charArrVar.is_of_type<std::string>() ));
     }
 }
-TEST(VariantOptionalTest)
-{
-    PRINT_TESTNAME;
-    using namespace FB;
-
-    // is_of_type<>()
-    {
-        boost::optional<int> iVal;
-        boost::optional<std::string> strVal;
-        boost::optional<double> dblVal;
-
-        variant a = 15;
-        variant b = "A string";
-        variant c = 23.55f;
-        iVal = a.convert_cast<boost::optional<int> >();
-        CHECK(iVal && *iVal == a.convert_cast<int>());
-        
-        strVal = b.convert_cast<boost::optional<std::string> >();
-        CHECK(strVal && *strVal == b.convert_cast<std::string>());
-        
-        dblVal = c.convert_cast<boost::optional<double> >();
-        CHECK(dblVal && *dblVal == c.convert_cast<double>());
-
-        iVal = variant().convert_cast<boost::optional<int> >();
-        CHECK(!iVal);
-        strVal = variant().convert_cast<boost::optional<std::string> >();
-        CHECK(!strVal);
-        dblVal = variant().convert_cast<boost::optional<double> >();
-        CHECK(!dblVal);
-    }
-}
-TEST(VariantToBoostVariantConversionTest)
-{
-    PRINT_TESTNAME;
-    using namespace FB;
-
-    typedef boost::variant<long, int, double, std::string, FB::JSAPIPtr, FB::JSObjectPtr, FB::FBNull, FB::FBVoid> VtComplete;
-    typedef boost::variant<long> VtLong;
-    typedef boost::variant<short, int, long, boost::uint64_t> VtInts;
-    typedef boost::variant<float, double, int, long> VtNum;
-    typedef boost::variant<std::string, std::wstring> VtStr;
-    typedef boost::variant<std::wstring, std::string> VtWstr;
-
-    {
-        VtComplete a = 23;
-        variant av(a);
-        CHECK(av.convert_cast<int>() == 23);
-        a = 23.0f;
-        av = a;
-        CHECK(av.convert_cast<double>() == 23.0f);
-        a = FB::JSAPIPtr();
-        av = a;
-        CHECK(!av.convert_cast<FB::JSAPIPtr>());
-        CHECK(av.is_null());
-        a = FB::FBVoid();
-        av = a;
-        CHECK(av.empty());
-    }
-}
-TEST(BoostVariantToVariantConversionTest)
-{
-    PRINT_TESTNAME;
-    using namespace FB;
-
-    typedef FB::boost_variant::generic VtComplete;
-
-    {
-        variant a = 23;
-        VtComplete av(a.convert_cast<VtComplete>());
-        CHECK(boost::get<int>(av) == 23);
-        a = 23.5;
-        av = a.convert_cast<VtComplete>();
-        CHECK(boost::get<double>(av) == 23.5f);
-        a = FB::JSAPIPtr();
-        av = a.convert_cast<VtComplete>();
-        try {
-            boost::get<FB::JSAPIPtr>(av);
-        } catch (...) {
-            CHECK(true);
-        }
-        try {
-            boost::get<FB::FBNull>(av);
-        } catch (...) {
-            CHECK(false);
-        }
-        a = FB::FBVoid();
-        av = a.convert_cast<VtComplete>();
-        try {
-            boost::get<FB::FBVoid>(av);
-        } catch (...) {
-            CHECK(false);
-        }
-    }
-}
\ No newline at end of file
+TEST(VariantOptionalTest)
+{
+    PRINT_TESTNAME;
+    using namespace FB;
+
+    // is_of_type<>()
+    {
+        boost::optional<int> iVal;
+        boost::optional<std::string> strVal;
+        boost::optional<double> dblVal;
+
+        variant a = 15;
+        variant b = "A string";
+        variant c = 23.55f;
+        iVal = a.convert_cast<boost::optional<int> >();
+        CHECK(iVal && *iVal == a.convert_cast<int>());
+        
+        strVal = b.convert_cast<boost::optional<std::string> >();
+        CHECK(strVal && *strVal == b.convert_cast<std::string>());
+        
+        dblVal = c.convert_cast<boost::optional<double> >();
+        CHECK(dblVal && *dblVal == c.convert_cast<double>());
+
+        iVal = variant().convert_cast<boost::optional<int> >();
+        CHECK(!iVal);
+        strVal = variant().convert_cast<boost::optional<std::string> >();
+        CHECK(!strVal);
+        dblVal = variant().convert_cast<boost::optional<double> >();
+        CHECK(!dblVal);
+    }
+}
+TEST(VariantToBoostVariantConversionTest)
+{
+    PRINT_TESTNAME;
+    using namespace FB;
+
+    typedef boost::variant<long, int, double, std::string, FB::JSAPIPtr, FB::JSObjectPtr, FB::FBNull, FB::FBVoid> VtComplete;
+    typedef boost::variant<long> VtLong;
+    typedef boost::variant<short, int, long, boost::uint64_t> VtInts;
+    typedef boost::variant<float, double, int, long> VtNum;
+    typedef boost::variant<std::string, std::wstring> VtStr;
+    typedef boost::variant<std::wstring, std::string> VtWstr;
+
+    {
+        VtComplete a = 23;
+        variant av(a);
+        CHECK(av.convert_cast<int>() == 23);
+        a = 23.0f;
+        av = a;
+        CHECK(av.convert_cast<double>() == 23.0f);
+        a = FB::JSAPIPtr();
+        av = a;
+        CHECK(!av.convert_cast<FB::JSAPIPtr>());
+        CHECK(av.is_null());
+        a = FB::FBVoid();
+        av = a;
+        CHECK(av.empty());
+    }
+}
+TEST(BoostVariantToVariantConversionTest)
+{
+    PRINT_TESTNAME;
+    using namespace FB;
+
+    typedef FB::boost_variant::generic VtComplete;
+
+    {
+        variant a = 23;
+        VtComplete av(a.convert_cast<VtComplete>());
+        CHECK(boost::get<int>(av) == 23);
+        a = 23.5;
+        av = a.convert_cast<VtComplete>();
+        CHECK(boost::get<double>(av) == 23.5f);
+        a = FB::JSAPIPtr();
+        av = a.convert_cast<VtComplete>();
+        try {
+            boost::get<FB::JSAPIPtr>(av);
+        } catch (...) {
+            CHECK(true);
+        }
+        try {
+            boost::get<FB::FBNull>(av);
+        } catch (...) {
+            CHECK(false);
+        }
+        a = FB::FBVoid();
+        av = a.convert_cast<VtComplete>();
+        try {
+            boost::get<FB::FBVoid>(av);
+        } catch (...) {
+            CHECK(false);
+        }
+    }
+}
+namespace variant_perf
+{
+    // bodies for the time-budget checks below; kept out of line so the
+    // measured expression reads as one call
+    inline void assignAndConvertInts(size_t n)
+    {
+        FB::variant v;
+        int sink = 0;
+        for (size_t i = 0; i < n; ++i) {
+            v = static_cast<int>(i);
+            sink += v.convert_cast<int>();
+        }
+        (void)sink;
+    }
+
+    inline void convertStringsBothWays(size_t n)
+    {
+        FB::variant v;
+        size_t sink = 0;
+        for (size_t i = 0; i < n; ++i) {
+            v = static_cast<int>(i);
+            sink += v.convert_cast<std::string>().size();
+            v = "37.23";
+            sink += static_cast<size_t>(v.convert_cast<double>());
+        }
+        (void)sink;
+    }
+}
+
+TEST(VariantTimeBudget)
+{
+    PRINT_TESTNAME;
+
+    // coarse 2x-regression gates: budgets sit well above what any supported
+    // build shows today, so only a real dispatch/conversion slowdown trips them
+    CHECK_TIME_UNDER(variant_perf::assignAndConvertInts(100000), 250);
+    CHECK_TIME_UNDER(variant_perf::convertStringsBothWays(20000), 400);
+}
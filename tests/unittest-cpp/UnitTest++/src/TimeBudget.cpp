@@ -0,0 +1,62 @@
+#include "TimeBudget.h"
+#include "TestResults.h"
+#include "MemoryOutStream.h"
+
+#include <algorithm>
+
+namespace UnitTest {
+
+
+TimeBudgetSampler::TimeBudgetSampler(int warmupRuns, int sampleRuns)
+    : m_warmupLeft(warmupRuns)
+    , m_sampleRuns(sampleRuns > 0 ? sampleRuns : 1)
+{
+}
+
+bool TimeBudgetSampler::BeginRun()
+{
+    if (m_warmupLeft <= 0 && static_cast<int>(m_samples.size()) >= m_sampleRuns)
+        return false;
+    m_timer.Start();
+    return true;
+}
+
+void TimeBudgetSampler::EndRun()
+{
+    double const ms = m_timer.GetTimeInMs();
+    if (m_warmupLeft > 0)
+        --m_warmupLeft;
+    else
+        m_samples.push_back(ms);
+}
+
+double TimeBudgetSampler::MedianMs() const
+{
+    if (m_samples.empty())
+        return 0.0;
+    std::vector<double> sorted(m_samples);
+    std::sort(sorted.begin(), sorted.end());
+    size_t const mid = sorted.size() / 2;
+    if (sorted.size() % 2 == 0)
+        return (sorted[mid - 1] + sorted[mid]) / 2.0;
+    return sorted[mid];
+}
+
+void CheckTimeUnder(TestResults& results, TimeBudgetSampler const& sampler,
+                    double maxMs, double tolerancePercent,
+                    TestDetails const& details, char const* expression)
+{
+    double const allowedMs = maxMs * (1.0 + tolerancePercent / 100.0);
+    double const medianMs = sampler.MedianMs();
+    if (medianMs > allowedMs)
+    {
+        MemoryOutStream stream;
+        stream << "Time budget exceeded. Expected to run " << expression << " under "
+               << maxMs << "ms (+" << tolerancePercent << "% tolerance) but median was "
+               << medianMs << "ms.";
+
+        results.OnTestFailure(details, stream.GetText());
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+#ifndef UNITTEST_TIMEBUDGET_H
+#define UNITTEST_TIMEBUDGET_H
+
+#include <vector>
+#include "TimeHelpers.h"
+#include "TestDetails.h"
+#include "CurrentTest.h"
+
+#ifdef CHECK_TIME_UNDER
+    #error UnitTest++ redefines CHECK_TIME_UNDER
+#endif
+
+namespace UnitTest {
+
+class TestResults;
+
+// Drives the CHECK_TIME_UNDER macros.  The measured expression is executed
+// warmupRuns times untimed (caches, lazy initialization), then sampleRuns
+// timed runs; the median is compared against the budget so a single
+// scheduler hiccup cannot fail a build.
+class TimeBudgetSampler
+{
+public:
+    TimeBudgetSampler(int warmupRuns, int sampleRuns);
+
+    bool BeginRun();        // starts the timer; false once all runs are done
+    void EndRun();          // records the elapsed time (warmup runs discarded)
+
+    double MedianMs() const;
+
+private:
+    void operator=(TimeBudgetSampler const&);
+    TimeBudgetSampler(TimeBudgetSampler const&);
+
+    Timer m_timer;
+    int m_warmupLeft;
+    int const m_sampleRuns;
+    std::vector<double> m_samples;
+};
+
+void CheckTimeUnder(TestResults& results, TimeBudgetSampler const& sampler,
+                    double maxMs, double tolerancePercent,
+                    TestDetails const& details, char const* expression);
+
+}
+
+#define CHECK_TIME_UNDER_EX(expression, maxMs, warmupRuns, sampleRuns, tolerancePercent) \
+    do \
+    { \
+        try { \
+            UnitTest::TimeBudgetSampler unitTest__sampler__(warmupRuns, sampleRuns); \
+            while (unitTest__sampler__.BeginRun()) { \
+                expression; \
+                unitTest__sampler__.EndRun(); \
+            } \
+            UnitTest::CheckTimeUnder(*UnitTest::CurrentTest::Results(), unitTest__sampler__, maxMs, tolerancePercent, \
+                    UnitTest::TestDetails(*UnitTest::CurrentTest::Details(), __LINE__), #expression); \
+        } \
+        catch (...) { \
+            UnitTest::CurrentTest::Results()->OnTestFailure(UnitTest::TestDetails(*UnitTest::CurrentTest::Details(), __LINE__), \
+                    "Unhandled exception in CHECK_TIME_UNDER(" #expression ")"); \
+        } \
+    } while (0)
+
+#define CHECK_TIME_UNDER(expression, maxMs) \
+    CHECK_TIME_UNDER_EX(expression, maxMs, 1, 5, 25)
+
+#endif
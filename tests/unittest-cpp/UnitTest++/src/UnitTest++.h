@@ -14,5 +14,6 @@
 #include "CheckMacros.h"
 #include "TestRunner.h"
 #include "TimeConstraint.h"
+#include "TimeBudget.h"
 
 #endif